@@ -33,6 +33,11 @@
 #define A2M_DEFAULT_LAYOUT_SPLIT_MEMORY_MISC 0.55f
 #define A2M_DEFAULT_HISTORY_MEMORY_MB 256
 #define A2M_DEFAULT_FRAME_RING_MEMORY_MB 128
+#define A2M_DEFAULT_REWIND_MEMORY_MB 0
+#define A2M_DEFAULT_REWIND_INTERVAL_FRAMES 6
+/* Matches CONTROL_DEFERRED_DEFAULT_LIMIT / CONTROL_DEFERRED_CAPACITY. */
+#define A2M_DEFAULT_CONTROL_PIPELINE 8
+#define A2M_MAX_CONTROL_PIPELINE 16
 #define A2M_SYSTEM_ROM_SIZE 16384
 #define A2M_BASIC_ROM_SIZE 8192
 #define A2M_KERNAL_ROM_SIZE 8192
@@ -1921,6 +1926,48 @@ static void apply_config(app_options *options, config *cfg)
             options->frame_ring_memory_mb = (int)parsed;
         }
     }
+    value = config_get(cfg, "debug", "frame_ring_mode");
+    if (value != NULL) {
+        if (strcasecmp(value, "video") == 0) {
+            options->frame_ring_mode = 1;
+        } else if (strcasecmp(value, "pixels") == 0) {
+            options->frame_ring_mode = 0;
+        } else {
+            fprintf(stderr, "invalid [debug] frame_ring_mode `%s`; using pixels\n", value);
+            options->frame_ring_mode = 0;
+        }
+    }
+    value = config_get(cfg, "debug", "rewind_memory_mb");
+    if (value != NULL) {
+        char *end = NULL;
+        unsigned long parsed = strtoul(value, &end, 0);
+        if (end == value || *end != '\0' ||
+            (parsed != 0u && (parsed < 4u || parsed > 4096u))) {
+            fprintf(
+                stderr,
+                "invalid [debug] rewind_memory_mb `%s`; using %d\n",
+                value,
+                A2M_DEFAULT_REWIND_MEMORY_MB);
+            options->rewind_memory_mb = A2M_DEFAULT_REWIND_MEMORY_MB;
+        } else {
+            options->rewind_memory_mb = (int)parsed;
+        }
+    }
+    value = config_get(cfg, "debug", "rewind_interval_frames");
+    if (value != NULL) {
+        char *end = NULL;
+        unsigned long parsed = strtoul(value, &end, 0);
+        if (end == value || *end != '\0' || parsed < 1u || parsed > 600u) {
+            fprintf(
+                stderr,
+                "invalid [debug] rewind_interval_frames `%s`; using %d\n",
+                value,
+                A2M_DEFAULT_REWIND_INTERVAL_FRAMES);
+            options->rewind_interval_frames = A2M_DEFAULT_REWIND_INTERVAL_FRAMES;
+        } else {
+            options->rewind_interval_frames = (int)parsed;
+        }
+    }
 
     value = config_get(cfg, "assembler", "file");
     if (value != NULL) {
@@ -2032,12 +2079,17 @@ static bool parse_command_line_overrides(app_options *options, int argc, char **
     int save_ini = 0;
     int audio_smoke = 0;
     int control_port = 0;
+    int control_pipeline = 0;
+    int control_shm = 0;
     int headless = 0;
     int mb_slot = -1;
     int kbdjoy_port = -1;
     const char *breakpoint = NULL;
     const char *ini_path = NULL;
     const char *sna_path = NULL;
+    const char *boot_cache_dir = NULL;
+    const char *boot_cache_text = NULL;
+    const char *boot_cache_pc = NULL;
     const char *audio_record_path = NULL;
     const char *turbo = NULL;
     const char *model_s = NULL;
@@ -2066,7 +2118,12 @@ static bool parse_command_line_overrides(app_options *options, int argc, char **
         OPT_FLOAT('\0', "audio-record-duration", &audio_record_duration, "recording duration in seconds", NULL, 0, 0),
         OPT_STRING('b', "break", &breakpoint, "install execute breakpoint at hex address", NULL, 0, 0),
         OPT_INTEGER('\0', "control-port", &control_port,
-                    "listen on localhost TCP for A2M/11 remote control (0=off)", NULL, 0, 0),
+                    "listen on localhost TCP for A2M/23 remote control (0=off)", NULL, 0, 0),
+        OPT_INTEGER('\0', "control-pipeline", &control_pipeline,
+                    "control requests a client may keep in flight (1..16, default 8)", NULL, 0, 0),
+        OPT_BOOLEAN('\0', "control-shm", &control_shm,
+                    "publish frames and RAM in shared memory for local control clients",
+                    NULL, 0, OPT_NONEG),
         OPT_BOOLEAN('\0', "headless", &headless,
                     "no window; short smoke exit unless --control-port is set (long-lived)",
                     NULL, 0, OPT_NONEG),
@@ -2084,6 +2141,12 @@ static bool parse_command_line_overrides(app_options *options, int argc, char **
         OPT_BOOLEAN('n', "noini", &noini, "do not use an ini file", NULL, 0, OPT_NONEG),
         OPT_BOOLEAN('!', "nosaveini", &no_save_ini, "do not save the ini no matter what", NULL, 0, OPT_NONEG),
         OPT_STRING('\0', "sna", &sna_path, "load machine snapshot at startup", NULL, 0, 0),
+        OPT_STRING('\0', "boot-cache", &boot_cache_dir,
+                   "start from a cached post-boot snapshot in this folder", NULL, 0, 0),
+        OPT_STRING('\0', "boot-cache-text", &boot_cache_text,
+                   "boot is done once this text is on screen", NULL, 0, 0),
+        OPT_STRING('\0', "boot-cache-pc", &boot_cache_pc,
+                   "boot is done when the CPU reaches this hex address", NULL, 0, 0),
         OPT_STRING('m', "model", &model_s, "machine model: enh (//e Enhanced) or plus (][+)", NULL, 0, 0),
         OPT_INTEGER('\0', "mb-slot", &mb_slot, "Mockingboard slot 1..7 (default 4; 0=disable)", NULL, 0, 0),
         OPT_STRING('\0', "symbols", &symbols_s, "load simple symbol file (NAME hex per line)", NULL, 0, 0),
@@ -2146,6 +2209,28 @@ static bool parse_command_line_overrides(app_options *options, int argc, char **
     if (sna_path != NULL) {
         replace_string(&options->sna_path, sna_path);
     }
+    if (boot_cache_dir != NULL) {
+        replace_string(&options->boot_cache_dir, boot_cache_dir);
+    }
+    if (boot_cache_text != NULL) {
+        replace_string(&options->boot_cache_text, boot_cache_text);
+    }
+    if (boot_cache_pc != NULL) {
+        const char *digits = boot_cache_pc[0] == '$' ? boot_cache_pc + 1 : boot_cache_pc;
+        char *end = NULL;
+        unsigned long pc = strtoul(digits, &end, 16);
+        if (end == digits || *end != '\0' || pc > 0xFFFFu) {
+            fprintf(stderr, "a2m: --boot-cache-pc must be a hex address\n");
+            return false;
+        }
+        options->boot_cache_pc = (int)pc;
+    }
+    if (options->boot_cache_dir != NULL && options->boot_cache_dir[0] != '\0' &&
+        (options->boot_cache_text == NULL || options->boot_cache_text[0] == '\0') &&
+        options->boot_cache_pc < 0) {
+        fprintf(stderr, "a2m: --boot-cache needs --boot-cache-text or --boot-cache-pc\n");
+        return false;
+    }
     if (turbo != NULL) {
         replace_string(&options->turbo_multipliers, turbo);
     }
@@ -2219,6 +2304,20 @@ static bool parse_command_line_overrides(app_options *options, int argc, char **
     if (control_port > 0) {
         options->control_port = control_port;
     }
+    if (control_pipeline < 0 || control_pipeline > A2M_MAX_CONTROL_PIPELINE) {
+        fprintf(
+            stderr,
+            "invalid control pipeline `%d`; expected 1..%d\n",
+            control_pipeline,
+            A2M_MAX_CONTROL_PIPELINE);
+        return false;
+    }
+    if (control_pipeline > 0) {
+        options->control_pipeline = control_pipeline;
+    }
+    if (control_shm) {
+        options->control_shm = true;
+    }
     if (headless) {
         options->headless = true;
     }
@@ -2286,11 +2385,17 @@ void app_options_init(app_options *options)
     options->assembler_rearm_oneshots = false;
     options->assembler_auto_adjust_segments = false;
     options->control_port = 0;
+    options->control_pipeline = A2M_DEFAULT_CONTROL_PIPELINE;
+    options->control_shm = false;
     options->headless = false;
     options->show_disk_leds = true;
     options->history_memory_mb = A2M_DEFAULT_HISTORY_MEMORY_MB;
     options->history_off_on_max = true; /* max free-run boost by default */
     options->frame_ring_memory_mb = A2M_DEFAULT_FRAME_RING_MEMORY_MB;
+    options->frame_ring_mode = 0;
+    options->rewind_memory_mb = A2M_DEFAULT_REWIND_MEMORY_MB;
+    options->rewind_interval_frames = A2M_DEFAULT_REWIND_INTERVAL_FRAMES;
+    options->boot_cache_pc = -1;
     options->apple_model = 0; /* //e Enhanced */
     options->mb_slot = 4;
     options->slot_cards[4] = APP_SLOT_CARD_MOCKINGBOARD;
@@ -2374,11 +2479,17 @@ bool app_options_copy(app_options *dest, const app_options *src)
         src->assembler_auto_adjust_segments;
     dest->show_version = src->show_version;
     dest->control_port = src->control_port;
+    dest->control_pipeline = src->control_pipeline;
+    dest->control_shm = src->control_shm;
     dest->headless = src->headless;
     dest->keyboard_joystick_port = src->keyboard_joystick_port;
     dest->keyboard_joystick_swap_buttons = src->keyboard_joystick_swap_buttons;
     dest->history_memory_mb = src->history_memory_mb;
     dest->frame_ring_memory_mb = src->frame_ring_memory_mb;
+    dest->frame_ring_mode = src->frame_ring_mode;
+    dest->rewind_memory_mb = src->rewind_memory_mb;
+    dest->rewind_interval_frames = src->rewind_interval_frames;
+    dest->boot_cache_pc = src->boot_cache_pc;
     dest->apple_model = src->apple_model;
     dest->mb_slot = src->mb_slot;
     memcpy(dest->slot_cards, src->slot_cards, sizeof(dest->slot_cards));
@@ -2391,6 +2502,8 @@ bool app_options_copy(app_options *dest, const app_options *src)
         !replace_string(&dest->video_standard, src->video_standard) ||
         !replace_string(&dest->basic_path, src->basic_path) ||
         !replace_string(&dest->sna_path, src->sna_path) ||
+        !replace_string(&dest->boot_cache_dir, src->boot_cache_dir) ||
+        !replace_string(&dest->boot_cache_text, src->boot_cache_text) ||
         !replace_string(&dest->audio_record_path, src->audio_record_path) ||
         !replace_string(&dest->assembler_file, src->assembler_file) ||
         !replace_string(&dest->assembler_address, src->assembler_address) ||
@@ -2570,6 +2683,9 @@ bool app_options_save_shutdown(const app_options *options)
     config_set_int(cfg, "debug", "history_memory_mb", options->history_memory_mb);
     config_set_bool(cfg, "config", "history_off_on_max", options->history_off_on_max);
     config_set_int(cfg, "debug", "frame_ring_memory_mb", options->frame_ring_memory_mb);
+    config_set(cfg, "debug", "frame_ring_mode", options->frame_ring_mode == 1 ? "video" : "pixels");
+    config_set_int(cfg, "debug", "rewind_memory_mb", options->rewind_memory_mb);
+    config_set_int(cfg, "debug", "rewind_interval_frames", options->rewind_interval_frames);
     /* Drop legacy C64 VIC-II line-ring budget if present in older INIs. */
     config_remove_prefix(cfg, "debug", "vic_ring_memory_mb");
     /* The snapshot folder is now [browse] snapshot; drop the legacy key. */
@@ -2734,6 +2850,8 @@ void app_options_destroy(app_options *options)
     free(options->keyboard_joystick_layout);
     free(options->basic_path);
     free(options->sna_path);
+    free(options->boot_cache_dir);
+    free(options->boot_cache_text);
     free(options->audio_record_path);
     free(options->assembler_file);
     free(options->assembler_address);
@@ -80,6 +80,11 @@ typedef struct app_options {
     char *basic_path; /* Applesoft text path convenience */
     /* Startup machine snapshot (.a2state). Loaded after mount/setup when set. */
     char *sna_path;
+    /* Post-boot snapshot cache directory (CLI only; NULL = off) and the
+       condition that ends a boot: text on screen and/or a PC (-1 = none). */
+    char *boot_cache_dir;
+    char *boot_cache_text;
+    int boot_cache_pc;
     /* Remembered file-browser folders, indexed by frontend_browse_slot. */
     char *browse_dirs[APP_BROWSE_DIR_COUNT];
     /* When true, runtime emits a 440 Hz square wave via the audio path to
@@ -105,6 +110,10 @@ typedef struct app_options {
     bool assembler_rearm_oneshots;
     bool assembler_auto_adjust_segments;
     int control_port;
+    /* Deferred control requests a client may keep in flight (1..16). */
+    int control_pipeline;
+    /* Publish frames and RAM in shared memory for local control clients. */
+    bool control_shm;
     bool headless;
     /* Always-on CPU flight-recorder startup budget in MiB: 0 or 16..4096. */
     int history_memory_mb;
@@ -114,6 +123,13 @@ typedef struct app_options {
      */
     bool history_off_on_max;
     int frame_ring_memory_mb;
+    /* Frame ring contents: 0 = painted pixels, 1 = video-memory captures
+       re-rendered on lookup ([debug] frame_ring_mode = pixels|video). */
+    int frame_ring_mode;
+    /* Rewind buffer budget in MiB (0 = off) and frames between checkpoints
+       ([debug] rewind_memory_mb / rewind_interval_frames). */
+    int rewind_memory_mb;
+    int rewind_interval_frames;
     /* Host-keyboard joystick: layout name ("numpad" or "wasd") and the Apple
        gameport stick it drives (0 = disabled, 1 or 2 = active).
        swap_buttons: when stick is on, Space↔Option (FIRE2↔FIRE) for ergonomics. */
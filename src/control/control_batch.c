@@ -0,0 +1,296 @@
+#include "control_batch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Line buffer for one framed sub-reply header (text and metadata are each
+   up to CONTROL_RESPONSE_TEXT_MAX). */
+enum { CONTROL_BATCH_REPLY_LINE_MAX = CONTROL_RESPONSE_TEXT_MAX * 2 + 96 };
+
+static bool control_batch_type_allowed(control_command_type type)
+{
+    switch (type) {
+    case CONTROL_COMMAND_HELLO:
+    case CONTROL_COMMAND_VERSION:
+    case CONTROL_COMMAND_CAPABILITIES:
+    case CONTROL_COMMAND_PING:
+    case CONTROL_COMMAND_SHM_INFO:
+    case CONTROL_COMMAND_QUIT_CLIENT:
+    case CONTROL_COMMAND_WAIT_PAUSED:
+    case CONTROL_COMMAND_WAIT_RUNNING:
+    case CONTROL_COMMAND_WAIT_FRAME:
+    case CONTROL_COMMAND_WAIT_EVENT:
+    case CONTROL_COMMAND_WAIT_TEXT:
+    case CONTROL_COMMAND_BATCH:
+        return false;
+    default:
+        return true;
+    }
+}
+
+/* Handlers that can park the reply in the deferred table: a worker
+   round-trip, or a mirror read that may fall back to one. */
+static bool control_batch_type_may_defer(control_command_type type)
+{
+    switch (type) {
+    case CONTROL_COMMAND_GET_CPU:
+    case CONTROL_COMMAND_GET_SOFTSWITCHES:
+    case CONTROL_COMMAND_GET_MEMORY:
+    case CONTROL_COMMAND_GET_MEMORY_MULTI:
+    case CONTROL_COMMAND_GET_FRAME:
+    case CONTROL_COMMAND_GET_TEXT:
+    case CONTROL_COMMAND_BREAK_EXEC:
+    case CONTROL_COMMAND_BREAK_CLEAR:
+    case CONTROL_COMMAND_BREAK_CLEAR_ALL:
+    case CONTROL_COMMAND_BREAK_ENABLE:
+    case CONTROL_COMMAND_BREAK_CREATE:
+    case CONTROL_COMMAND_BREAK_UPDATE:
+    case CONTROL_COMMAND_REARM_ONESHOTS:
+    case CONTROL_COMMAND_BREAK_LIST:
+    case CONTROL_COMMAND_SAVE_STATE:
+    case CONTROL_COMMAND_LOAD_STATE:
+    case CONTROL_COMMAND_REWIND:
+    case CONTROL_COMMAND_STEP_BACK:
+    case CONTROL_COMMAND_REVERSE_CONTINUE:
+    case CONTROL_COMMAND_RUN_TO_CYCLE:
+    case CONTROL_COMMAND_ASSEMBLE:
+    case CONTROL_COMMAND_MOUNT_DISK:
+    case CONTROL_COMMAND_MOUNT:
+    case CONTROL_COMMAND_UNMOUNT:
+    case CONTROL_COMMAND_SELECT_DISK:
+    case CONTROL_COMMAND_SET_DISK_WRITABLE:
+    case CONTROL_COMMAND_HISTORY_INFO:
+    case CONTROL_COMMAND_HISTORY_RECORD:
+    case CONTROL_COMMAND_HISTORY_CLEAR:
+    case CONTROL_COMMAND_HISTORY_FIND:
+    case CONTROL_COMMAND_HISTORY_NEXT:
+    case CONTROL_COMMAND_HISTORY_READ:
+    case CONTROL_COMMAND_HISTORY_CLOSE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+size_t control_batch_deferrable_count(const control_request *subs, size_t count)
+{
+    size_t deferrable = 0;
+    size_t i;
+
+    for (i = 0; subs != NULL && i < count; i++) {
+        deferrable += control_batch_type_may_defer(subs[i].type);
+    }
+    return deferrable;
+}
+
+static void control_batch_release_requests(control_request *requests, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        control_request_release(&requests[i]);
+    }
+}
+
+static void control_batch_format_error(
+    control_response *out_error,
+    uint32_t id,
+    size_t index,
+    const char *message)
+{
+    char text[CONTROL_RESPONSE_TEXT_MAX];
+
+    if (out_error == NULL) {
+        return;
+    }
+    snprintf(text, sizeof(text), "sub %zu %s", index + 1u, message);
+    control_protocol_format_error(out_error, id, "bad-batch", text, false);
+}
+
+bool control_batch_parse(
+    const control_request *batch,
+    control_request *out,
+    size_t max,
+    size_t *out_count,
+    control_response *out_error)
+{
+    const uint8_t *payload;
+    size_t size;
+    size_t pos = 0;
+    size_t count;
+    size_t k;
+
+    if (batch == NULL || out == NULL || out_count == NULL ||
+        batch->type != CONTROL_COMMAND_BATCH || batch->payload == NULL) {
+        return false;
+    }
+    payload = batch->payload;
+    size = batch->payload_size;
+    count = batch->args.batch_count;
+    if (count == 0u || count > max) {
+        control_batch_format_error(out_error, batch->id, 0u, "count");
+        return false;
+    }
+
+    for (k = 0; k < count; k++) {
+        char line[CONTROL_LINE_MAX];
+        const uint8_t *newline;
+        size_t length;
+        size_t j;
+        control_response sub_error;
+        control_request *sub = &out[k];
+
+        newline = pos < size ? (const uint8_t *)memchr(payload + pos, '\n', size - pos) : NULL;
+        if (newline == NULL) {
+            control_batch_format_error(out_error, batch->id, k, "missing line");
+            control_batch_release_requests(out, k);
+            return false;
+        }
+        length = (size_t)(newline - (payload + pos));
+        if (length >= sizeof(line)) {
+            control_batch_format_error(out_error, batch->id, k, "line too long");
+            control_batch_release_requests(out, k);
+            return false;
+        }
+        memcpy(line, payload + pos, length);
+        line[length] = '\0';
+        pos += length + 1u;
+
+        memset(&sub_error, 0, sizeof(sub_error));
+        if (!control_protocol_parse_request(line, sub, &sub_error)) {
+            control_batch_format_error(out_error, batch->id, k, sub_error.text);
+            control_batch_release_requests(out, k);
+            return false;
+        }
+        if (!control_batch_type_allowed(sub->type)) {
+            control_batch_format_error(out_error, batch->id, k, "not batchable");
+            control_batch_release_requests(out, k + 1u);
+            return false;
+        }
+        for (j = 0; j < k; j++) {
+            if (out[j].id == sub->id) {
+                control_batch_format_error(out_error, batch->id, k, "duplicate id");
+                control_batch_release_requests(out, k + 1u);
+                return false;
+            }
+        }
+        if (sub->payload_size > 0u) {
+            if (size - pos < sub->payload_size + 1u || payload[pos + sub->payload_size] != '\n') {
+                control_batch_format_error(out_error, batch->id, k, "payload framing");
+                control_batch_release_requests(out, k + 1u);
+                return false;
+            }
+            sub->payload = (uint8_t *)malloc(sub->payload_size);
+            if (sub->payload == NULL) {
+                control_batch_format_error(out_error, batch->id, k, "out of memory");
+                control_batch_release_requests(out, k + 1u);
+                return false;
+            }
+            memcpy(sub->payload, payload + pos, sub->payload_size);
+            pos += sub->payload_size + 1u;
+        }
+    }
+    if (pos != size) {
+        control_batch_format_error(out_error, batch->id, count - 1u, "trailing bytes");
+        control_batch_release_requests(out, count);
+        return false;
+    }
+    *out_count = count;
+    return true;
+}
+
+control_batch *control_batch_create(uint32_t request_id, uint64_t connection_epoch, size_t count)
+{
+    control_batch *batch;
+
+    if (count == 0u || count > CONTROL_BATCH_MAX) {
+        return NULL;
+    }
+    batch = (control_batch *)calloc(1, sizeof(*batch));
+    if (batch == NULL) {
+        return NULL;
+    }
+    batch->request_id = request_id;
+    batch->connection_epoch = connection_epoch;
+    batch->count = count;
+    batch->pending = count;
+    return batch;
+}
+
+void control_batch_destroy(control_batch *batch)
+{
+    size_t i;
+
+    if (batch == NULL) {
+        return;
+    }
+    for (i = 0; i < batch->count; i++) {
+        control_response_release(&batch->replies[i]);
+    }
+    free(batch);
+}
+
+bool control_batch_store(control_batch *batch, size_t index, control_response *reply)
+{
+    if (batch == NULL || reply == NULL) {
+        return false;
+    }
+    if (index >= batch->count || batch->filled[index]) {
+        control_response_release(reply);
+        return batch->pending == 0u;
+    }
+    batch->replies[index] = *reply;
+    batch->filled[index] = true;
+    batch->pending--;
+    reply->payload = NULL;
+    reply->payload_size = 0;
+    return batch->pending == 0u;
+}
+
+bool control_batch_finish(control_batch *batch, control_response *out)
+{
+    char line[CONTROL_BATCH_REPLY_LINE_MAX];
+    uint8_t *payload;
+    size_t total = 0;
+    size_t used = 0;
+    size_t i;
+    char meta[32];
+
+    if (batch == NULL || out == NULL || batch->pending != 0u) {
+        return false;
+    }
+    for (i = 0; i < batch->count; i++) {
+        const control_response *reply = &batch->replies[i];
+        if (!control_protocol_write_response_line(line, sizeof(line), reply)) {
+            return false;
+        }
+        total += strlen(line);
+        if (reply->type == CONTROL_RESPONSE_DATA) {
+            total += reply->payload_size + 1u;
+        }
+    }
+    payload = (uint8_t *)malloc(total);
+    if (payload == NULL) {
+        return false;
+    }
+    for (i = 0; i < batch->count; i++) {
+        const control_response *reply = &batch->replies[i];
+        size_t length;
+
+        (void)control_protocol_write_response_line(line, sizeof(line), reply);
+        length = strlen(line);
+        memcpy(payload + used, line, length);
+        used += length;
+        if (reply->type == CONTROL_RESPONSE_DATA) {
+            if (reply->payload_size > 0u) {
+                memcpy(payload + used, reply->payload, reply->payload_size);
+                used += reply->payload_size;
+            }
+            payload[used++] = '\n';
+        }
+    }
+    snprintf(meta, sizeof(meta), "count=%zu", batch->count);
+    control_protocol_format_data(out, batch->request_id, "batch", meta, payload, total);
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "control_protocol.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* `batch <count> <bytes>` carries sub-requests framed exactly as on the
+   socket: one "<id> <cmd> args" line each, followed by its payload and a
+   newline when the command takes one (set-memory). The dispatcher runs them
+   back-to-back inside one worker hold and answers with a single
+   `data batch` reply whose payload is every sub-reply in request order,
+   again framed as on the socket. */
+
+typedef struct control_batch {
+    uint32_t request_id;
+    uint64_t connection_epoch;
+    size_t count;
+    size_t pending;
+    bool filled[CONTROL_BATCH_MAX];
+    control_response replies[CONTROL_BATCH_MAX];
+} control_batch;
+
+/* Split a parsed batch request into out[0..count). Fails (bad-batch) without
+   keeping anything when a sub-request does not parse, repeats an id, cannot
+   be batched (waits, identity, quit-client, nested batch) or the framing
+   does not match the declared count and byte size. */
+bool control_batch_parse(
+    const control_request *batch,
+    control_request *out,
+    size_t max,
+    size_t *out_count,
+    control_response *out_error);
+
+/* Sub-requests that may wait in the deferred table (worker round-trips,
+   mirror reads that can fall back to one). A batch holding more than
+   CONTROL_DEFERRED_CAPACITY of them cannot be served. */
+size_t control_batch_deferrable_count(const control_request *subs, size_t count);
+
+control_batch *control_batch_create(uint32_t request_id, uint64_t connection_epoch, size_t count);
+void control_batch_destroy(control_batch *batch);
+
+/* Take the reply for sub-request `index` (payload ownership moves to the
+   batch). Returns true once every sub-request has its reply. */
+bool control_batch_store(control_batch *batch, size_t index, control_response *reply);
+
+/* Build the combined `data batch` reply. Caller posts it and destroys the batch. */
+bool control_batch_finish(control_batch *batch, control_response *out);
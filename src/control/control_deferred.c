@@ -10,30 +10,138 @@ void control_deferred_clear(deferred_control_response *d)
     memset(d, 0, sizeof(*d));
 }
 
+static uint32_t control_deferred_limit(const deferred_control_table *table)
+{
+    return table->limit != 0u ? table->limit : CONTROL_DEFERRED_DEFAULT_LIMIT;
+}
+
+void control_deferred_set_limit(deferred_control_table *table, uint32_t limit)
+{
+    if (table == NULL) {
+        return;
+    }
+    if (limit > CONTROL_DEFERRED_CAPACITY) {
+        limit = CONTROL_DEFERRED_CAPACITY;
+    }
+    table->limit = limit;
+}
+
 deferred_control_response *control_deferred_reserve(
     deferred_control_table *table,
+    uint32_t client,
     const char **out_busy_msg)
 {
+    size_t i;
+
     if (table == NULL) {
         if (out_busy_msg != NULL) {
             *out_busy_msg = "no-table";
         }
         return NULL;
     }
-    if (table->entries[0].active) {
+    if (control_deferred_client_count(table, client) >= control_deferred_limit(table)) {
         if (out_busy_msg != NULL) {
-            *out_busy_msg = "deferred-response-active";
+            *out_busy_msg = "deferred-table-full";
         }
         return NULL;
     }
-    control_deferred_clear(&table->entries[0]);
-    return &table->entries[0];
+    for (i = 0; i < CONTROL_DEFERRED_TABLE_SIZE; i++) {
+        if (!table->entries[i].active) {
+            control_deferred_clear(&table->entries[i]);
+            table->entries[i].sequence = ++table->next_sequence;
+            table->entries[i].client = client;
+            return &table->entries[i];
+        }
+    }
+    if (out_busy_msg != NULL) {
+        *out_busy_msg = "deferred-table-full";
+    }
+    return NULL;
 }
 
 deferred_control_response *control_deferred_active(deferred_control_table *table)
 {
-    if (table == NULL || !table->entries[0].active) {
+    deferred_control_response *oldest = NULL;
+
+    if (control_deferred_collect(table, &oldest, 1u) == 0u) {
         return NULL;
     }
-    return &table->entries[0];
+    return oldest;
+}
+
+size_t control_deferred_count(const deferred_control_table *table)
+{
+    size_t i;
+    size_t count = 0;
+
+    if (table == NULL) {
+        return 0;
+    }
+    for (i = 0; i < CONTROL_DEFERRED_TABLE_SIZE; i++) {
+        if (table->entries[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t control_deferred_client_count(const deferred_control_table *table, uint32_t client)
+{
+    size_t i;
+    size_t count = 0;
+
+    if (table == NULL) {
+        return 0;
+    }
+    for (i = 0; i < CONTROL_DEFERRED_TABLE_SIZE; i++) {
+        if (table->entries[i].active && table->entries[i].client == client) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t control_deferred_collect(
+    deferred_control_table *table,
+    deferred_control_response **out,
+    size_t max)
+{
+    deferred_control_response *sorted[CONTROL_DEFERRED_TABLE_SIZE];
+    size_t count = 0;
+    size_t i;
+
+    if (table == NULL || out == NULL) {
+        return 0;
+    }
+    /* Insertion sort by sequence: the table is tiny. */
+    for (i = 0; i < CONTROL_DEFERRED_TABLE_SIZE; i++) {
+        deferred_control_response *d = &table->entries[i];
+        size_t at = count;
+
+        if (!d->active) {
+            continue;
+        }
+        while (at > 0 && sorted[at - 1]->sequence > d->sequence) {
+            sorted[at] = sorted[at - 1];
+            at--;
+        }
+        sorted[at] = d;
+        count++;
+    }
+    if (count > max) {
+        count = max;
+    }
+    for (i = 0; i < count; i++) {
+        out[i] = sorted[i];
+    }
+    return count;
+}
+
+bool control_deferred_kind_is_wait(control_deferred_kind kind)
+{
+    return kind == CONTROL_DEFERRED_WAIT_PAUSED ||
+        kind == CONTROL_DEFERRED_WAIT_RUNNING ||
+        kind == CONTROL_DEFERRED_WAIT_FRAME ||
+        kind == CONTROL_DEFERRED_WAIT_EVENT ||
+        kind == CONTROL_DEFERRED_WAIT_TEXT;
 }
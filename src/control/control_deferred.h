@@ -3,10 +3,18 @@
 #include "control_protocol.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-/* C0: single exclusive deferred slot (c64m multi-table comes with history bulk). */
-enum { CONTROL_DEFERRED_CAPACITY = 1 };
+/* Requests a client may keep in flight. Replies carry the request id and may
+   arrive out of order; the per-client limit (--control-pipeline) is
+   1..capacity. One table serves every client, so runtime responses still
+   complete requests in the order they were sent. */
+enum {
+    CONTROL_DEFERRED_CAPACITY = 16,
+    CONTROL_DEFERRED_DEFAULT_LIMIT = 8,
+    CONTROL_DEFERRED_TABLE_SIZE = CONTROL_DEFERRED_CAPACITY * CONTROL_CLIENTS_MAX
+};
 
 typedef enum control_deferred_kind {
     CONTROL_DEFERRED_NONE = 0,
@@ -25,12 +33,24 @@ typedef enum control_deferred_kind {
     CONTROL_DEFERRED_HISTORY_DATA,
     /* Wait for MACHINE_STATE slot map, then run media op. */
     CONTROL_DEFERRED_MEDIA_OP,
-    CONTROL_DEFERRED_ASSEMBLE
+    CONTROL_DEFERRED_ASSEMBLE,
+    CONTROL_DEFERRED_GET_MEMORY_MULTI,
+    /* Mirror behind a queued write: decode after the machine-state reply. */
+    CONTROL_DEFERRED_GET_TEXT,
+    CONTROL_DEFERRED_WAIT_TEXT,
+    CONTROL_DEFERRED_REWIND,
+    /* step-back / reverse-continue / run-to-cycle: SEEK_COMPLETE by token. */
+    CONTROL_DEFERRED_SEEK
 } control_deferred_kind;
 
 typedef struct deferred_control_response {
     bool active;
+    uint64_t sequence; /* reservation order */
+    uint32_t client; /* control_request.client */
     uint32_t request_id;
+    /* Sub-request of the open batch: the reply fills batch slot batch_index. */
+    bool in_batch;
+    uint32_t batch_index;
     control_deferred_kind kind;
     uint64_t deadline_ms;
     uint64_t request_token;
@@ -38,9 +58,16 @@ typedef struct deferred_control_response {
     uint16_t memory_address;
     uint32_t memory_length;
     uint8_t memory_mode;
+    uint32_t memory_span_count; /* CONTROL_DEFERRED_GET_MEMORY_MULTI */
+    uint8_t frame_format; /* CONTROL_DEFERRED_GET_FRAME: control_frame_format */
+    uint8_t frame_encoding; /* control_frame_encoding */
+    uint64_t frame_delta_base;
     uint32_t wait_frame_delta;
     uint64_t wait_frame_start;
     char event_name[48];
+    /* CONTROL_DEFERRED_WAIT_TEXT: regex and the mirror publish last compared. */
+    char text_pattern[CONTROL_TEXT_PATTERN_MAX];
+    uint64_t text_generation;
     /* CONTROL_DEFERRED_MEDIA_OP payload (slot 0 = resolve). */
     control_command_type media_op;
     uint8_t media_kind; /* control_media_kind */
@@ -52,14 +79,35 @@ typedef struct deferred_control_response {
 } deferred_control_response;
 
 typedef struct deferred_control_table {
-    deferred_control_response entries[CONTROL_DEFERRED_CAPACITY];
+    deferred_control_response entries[CONTROL_DEFERRED_TABLE_SIZE];
+    uint32_t limit; /* per client; 0 = CONTROL_DEFERRED_DEFAULT_LIMIT */
+    uint64_t next_sequence;
 } deferred_control_table;
 
 void control_deferred_clear(deferred_control_response *d);
 
-/* Reserve the single slot. NULL if busy. */
+/* Clamp to 1..CONTROL_DEFERRED_CAPACITY; 0 restores the default. */
+void control_deferred_set_limit(deferred_control_table *table, uint32_t limit);
+
+/* Reserve a free slot for client. NULL if client already holds `limit`
+   requests. */
 deferred_control_response *control_deferred_reserve(
     deferred_control_table *table,
+    uint32_t client,
     const char **out_busy_msg);
 
+/* Oldest in-flight entry, or NULL when the table is empty. */
 deferred_control_response *control_deferred_active(deferred_control_table *table);
+
+size_t control_deferred_count(const deferred_control_table *table);
+size_t control_deferred_client_count(const deferred_control_table *table, uint32_t client);
+
+/* Active entries oldest first; returns how many were written (<= max). */
+size_t control_deferred_collect(
+    deferred_control_table *table,
+    deferred_control_response **out,
+    size_t max);
+
+/* Waits (wait-paused, wait-frame, ...) complete on broadcast events, so one
+   event may satisfy several of them; other kinds answer one request each. */
+bool control_deferred_kind_is_wait(control_deferred_kind kind);
@@ -1,8 +1,10 @@
 #include "control_dispatch.h"
 
 #include "apple2.h"
+#include "control_batch.h"
 #include "control_breakpoint.h"
 #include "display_frame.h"
+#include "re.h"
 #include "runtime.h"
 #include "runtime_event.h"
 #include "runtime_history.h"
@@ -15,7 +17,14 @@
 #include <stdlib.h>
 #include <string.h>
 
-static void control_dispatch_release_session(control_dispatch_t *disp);
+enum {
+    /* How long a paused-time change keeps memory subscriptions comparing new
+       mirror publishes, and the host's poll interval meanwhile. */
+    CONTROL_SUBSCRIPTION_RECHECK_MS = 20u,
+    CONTROL_SUBSCRIPTION_POLL_MS = 2u
+};
+
+static void control_dispatch_drop_client(control_dispatch_t *disp, uint32_t slot);
 
 void control_dispatch_init(
     control_dispatch_t *disp,
@@ -28,31 +37,29 @@ void control_dispatch_init(
     memset(disp, 0, sizeof(*disp));
     disp->server = server;
     disp->client = client;
-    disp->seen_paused = true;
     disp->machine_running = false;
     disp->turbo_mode = 1000u; /* 1 MHz */
-    disp->latch_paused = true;
     strncpy(disp->stop_reason, "none", sizeof(disp->stop_reason) - 1);
 }
 
 void control_dispatch_shutdown(control_dispatch_t *disp)
 {
-    deferred_control_response *d;
+    uint32_t slot;
 
     if (disp == NULL) {
         return;
     }
-    d = control_deferred_active(&disp->deferred);
-    if (d != NULL) {
-        if (d->request_token != 0u && disp->client != NULL) {
-            (void)runtime_client_cancel_rpc(disp->client, d->request_token);
-        }
-        control_deferred_clear(d);
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        control_dispatch_drop_client(disp, slot);
     }
-    control_dispatch_release_session(disp);
     memset(disp, 0, sizeof(*disp));
 }
 
+static control_dispatch_client *reply_client(control_dispatch_t *disp)
+{
+    return &disp->clients[disp->reply.client];
+}
+
 bool control_dispatch_copy_symbols(
     const control_dispatch_t *disp,
     runtime_symbol_snapshot *out)
@@ -110,11 +117,91 @@ static void set_stop_reason(control_dispatch_t *disp, const char *reason)
     disp->stop_reason[sizeof(disp->stop_reason) - 1u] = '\0';
 }
 
+/* Address a response to the client in slot (its current connection). */
+static bool post_to_client(control_dispatch_t *disp, uint32_t slot, control_response *response)
+{
+    response->client = slot;
+    response->connection = disp->clients[slot].connection;
+    return control_server_post_response(disp->server, response);
+}
+
+static bool push_to_client(control_dispatch_t *disp, uint32_t slot, control_response *response)
+{
+    response->client = slot;
+    response->connection = disp->clients[slot].connection;
+    return control_server_post_push(disp->server, response);
+}
+
+static void finish_batch(control_dispatch_t *disp, uint32_t slot)
+{
+    control_response response;
+    control_batch *batch = disp->clients[slot].batch;
+
+    disp->clients[slot].batch = NULL;
+    if (control_batch_finish(batch, &response)) {
+        if (!post_to_client(disp, slot, &response)) {
+            control_response_release(&response);
+        }
+    } else {
+        control_protocol_format_error(
+            &response, batch->request_id, "internal", "batch reply", false);
+        (void)post_to_client(disp, slot, &response);
+    }
+    control_batch_destroy(batch);
+}
+
+/* Every reply goes through here: batch sub-replies are held back and sent
+   together once the last one arrives. */
+static bool dispatch_post(control_dispatch_t *disp, control_response *response)
+{
+    control_dispatch_client *c = reply_client(disp);
+
+    if (disp->reply.in_batch) {
+        if (c->batch == NULL) {
+            control_response_release(response); /* batch dropped on disconnect */
+        } else if (control_batch_store(c->batch, disp->reply.batch_index, response)) {
+            finish_batch(disp, disp->reply.client);
+        }
+        return true;
+    }
+    return post_to_client(disp, disp->reply.client, response);
+}
+
+/* Replies posted while completing d go wherever d's request came from.
+   Returns the scope to restore with leave_reply_scope. */
+static control_reply_scope enter_reply_scope(
+    control_dispatch_t *disp,
+    const deferred_control_response *d)
+{
+    control_reply_scope saved = disp->reply;
+
+    disp->reply.client = d->client;
+    disp->reply.in_batch = d->in_batch;
+    disp->reply.batch_index = d->batch_index;
+    return saved;
+}
+
+/* Serve one client's requests, pushes and timeouts outside a batch. */
+static control_reply_scope enter_client_scope(control_dispatch_t *disp, uint32_t slot)
+{
+    control_reply_scope saved = disp->reply;
+
+    disp->reply.client = slot;
+    disp->reply.in_batch = false;
+    disp->reply.batch_index = 0u;
+    return saved;
+}
+
+static void leave_reply_scope(control_dispatch_t *disp, control_reply_scope saved)
+{
+    disp->reply = saved;
+}
+
 static void post_ok(control_dispatch_t *disp, uint32_t id, const char *text)
 {
     control_response response;
     control_protocol_format_ok(&response, id, text);
-    (void)control_server_post_response(disp->server, &response);
+    (void)dispatch_post(disp, &response);
 }
 
 static void post_error(
@@ -125,7 +212,7 @@ static void post_error(
 {
     control_response response;
     control_protocol_format_error(&response, id, code, message, false);
-    (void)control_server_post_response(disp->server, &response);
+    (void)dispatch_post(disp, &response);
 }
 
 static const char *state_changed_reason_name(runtime_state_changed_reason reason)
@@ -153,32 +240,70 @@ static const char *state_changed_reason_name(runtime_state_changed_reason reason
     }
 }
 
-/* Close the bound control session without waiting (fire-and-forget). */
-static void control_dispatch_release_session(control_dispatch_t *disp)
+/* Close the client's control session without waiting (fire-and-forget). */
+static void control_dispatch_release_session(control_dispatch_t *disp, control_dispatch_client *c)
 {
     uint64_t token;
 
-    if (disp == NULL || disp->client == NULL || disp->session_id == 0u) {
+    if (disp == NULL || disp->client == NULL || c->session_id == 0u) {
         return;
     }
     token = runtime_client_alloc_request_token(disp->client);
-    (void)runtime_client_session_close(disp->client, disp->session_id, token);
-    disp->session_id = 0u;
-    disp->session_epoch = 0u;
-    runtime_client_set_command_session(disp->client, 0u);
+    (void)runtime_client_session_close(disp->client, c->session_id, token);
+    if (runtime_client_get_command_session(disp->client) == c->session_id) {
+        runtime_client_set_command_session(disp->client, 0u);
+    }
+    c->session_id = 0u;
+}
+
+/* Forget everything the client in slot left behind: deferred requests,
+   batch, subscriptions and its runtime session. */
+static void control_dispatch_drop_client(control_dispatch_t *disp, uint32_t slot)
+{
+    control_dispatch_client *c = &disp->clients[slot];
+    size_t i;
+
+    for (i = 0; i < CONTROL_DEFERRED_TABLE_SIZE; i++) {
+        deferred_control_response *d = &disp->deferred.entries[i];
+        if (d->active && d->client == slot) {
+            if (d->request_token != 0u && disp->client != NULL) {
+                (void)runtime_client_cancel_rpc(disp->client, d->request_token);
+            }
+            control_deferred_clear(d);
+        }
+    }
+    control_batch_destroy(c->batch);
+    control_frame_cache_destroy(c->frame_cache);
+    control_subscription_clear(&c->subscriptions);
+    control_dispatch_release_session(disp, c);
+    memset(c, 0, sizeof(*c));
+}
+
+/* Start serving a new connection in slot. A new client sees the machine as
+   it is now: a paused machine satisfies its first wait-paused. */
+static void control_dispatch_bind_client(control_dispatch_t *disp, uint32_t slot, uint64_t connection)
+{
+    control_dispatch_client *c = &disp->clients[slot];
+
+    control_dispatch_drop_client(disp, slot);
+    c->connection = connection;
+    c->seen_paused = !disp->machine_running;
+    c->latch_paused = !disp->machine_running;
+    c->subscriptions.connection_epoch = connection;
 }
 
 static void control_dispatch_post_state_changed(
     control_dispatch_t *disp,
     const runtime_event *event)
 {
-    control_response response;
     char text[CONTROL_RESPONSE_TEXT_MAX];
+    uint32_t slot;
 
     if (disp == NULL || event == NULL || disp->server == NULL) {
         return;
     }
-    /* Always push: awareness only. Clients ignore or log; Ctl skips in cmd(). */
+    /* Always push, to every client: awareness only. Clients ignore or log;
+       Ctl skips in cmd(). */
     snprintf(
         text,
         sizeof(text),
@@ -188,16 +313,24 @@ static void control_dispatch_post_state_changed(
         (unsigned long long)event->data.state_changed.cycles,
         (unsigned long long)event->data.state_changed.frame,
         (unsigned long long)event->data.state_changed.history_epoch);
-    control_protocol_format_event(&response, 0u, text);
-    (void)control_server_post_response(disp->server, &response);
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        control_response response;
+
+        if (disp->clients[slot].connection == 0u) {
+            continue;
+        }
+        control_protocol_format_event(&response, 0u, text);
+        (void)post_to_client(disp, slot, &response);
+    }
 }
 
 /*
- * Ensure TCP client is bound to a kind=control runtime session for the current
- * connection epoch. Opens synchronously by pumping runtime events briefly.
+ * Ensure the client in slot is bound to a kind=control runtime session for
+ * its connection. Opens synchronously by pumping runtime events briefly.
  */
-static bool control_dispatch_ensure_session(control_dispatch_t *disp)
+static bool control_dispatch_ensure_session(control_dispatch_t *disp, uint32_t slot)
 {
+    control_dispatch_client *c;
     uint64_t epoch;
     uint64_t token;
     uint32_t start_ms;
@@ -206,19 +339,15 @@ static bool control_dispatch_ensure_session(control_dispatch_t *disp)
     if (disp == NULL || disp->server == NULL || disp->client == NULL) {
         return false;
     }
-    if (!control_server_has_client(disp->server)) {
+    c = &disp->clients[slot];
+    epoch = c->connection;
+    if (epoch == 0u) {
         return false;
     }
-
-    epoch = control_server_connection_epoch(disp->server);
-    if (disp->session_id != 0u && disp->session_epoch == epoch) {
+    if (c->session_id != 0u) {
         return true;
     }
 
-    if (disp->session_id != 0u) {
-        control_dispatch_release_session(disp);
-    }
-
     token = runtime_client_alloc_request_token(disp->client);
     if (!runtime_client_session_open(
             disp->client, RUNTIME_SESSION_KIND_CONTROL, epoch, token)) {
@@ -227,23 +356,22 @@ static bool control_dispatch_ensure_session(control_dispatch_t *disp)
 
     start_ms = SDL_GetTicks();
     while ((SDL_GetTicks() - start_ms) < 2000u) {
-        while (runtime_client_poll_event(disp->client, &event)) {
-            if (event.type == RUNTIME_EVENT_SESSION_RESPONSE &&
-                event.request_token == token) {
-                if (event.data.session.status == RUNTIME_SESSION_OK &&
-                    event.data.session.session_id != 0u) {
-                    disp->session_id = event.data.session.session_id;
-                    disp->session_epoch = epoch;
-                    runtime_client_set_command_session(
-                        disp->client, disp->session_id);
-                    return true;
-                }
-                return false;
+        /* Block on the event queue instead of sleeping between polls. */
+        if (!runtime_client_wait_event(disp->client, &event, 10u)) {
+            continue;
+        }
+        if (event.type == RUNTIME_EVENT_SESSION_RESPONSE &&
+            event.request_token == token) {
+            if (event.data.session.status == RUNTIME_SESSION_OK &&
+                event.data.session.session_id != 0u) {
+                c->session_id = event.data.session.session_id;
+                runtime_client_set_command_session(disp->client, c->session_id);
+                return true;
             }
-            /* Keep sticky latches / deferred completions coherent. */
-            control_dispatch_on_runtime_event(disp, &event);
+            return false;
         }
-        SDL_Delay(1);
+        /* Keep sticky latches / deferred completions coherent. */
+        control_dispatch_on_runtime_event(disp, &event);
     }
     return false;
 }
@@ -253,10 +381,10 @@ static uint32_t control_dispatch_history_session_id(control_dispatch_t *disp)
     if (disp == NULL) {
         return 0u;
     }
-    if (!control_dispatch_ensure_session(disp)) {
+    if (!control_dispatch_ensure_session(disp, disp->reply.client)) {
         return 0u; /* fall back to default session */
     }
-    return disp->session_id;
+    return reply_client(disp)->session_id;
 }
 
 static deferred_control_response *begin_deferred(
@@ -267,16 +395,33 @@ static deferred_control_response *begin_deferred(
     uint64_t token)
 {
     const char *busy = NULL;
-    deferred_control_response *d = control_deferred_reserve(&disp->deferred, &busy);
+    deferred_control_response *d;
+    size_t i;
+
+    /* Replies are matched by id, so an id may only be in flight once per
+       client (batch sub-ids only clash with each other, which parsing
+       already rejects). */
+    for (i = 0; i < CONTROL_DEFERRED_TABLE_SIZE; i++) {
+        if (disp->deferred.entries[i].active &&
+            disp->deferred.entries[i].client == disp->reply.client &&
+            !disp->deferred.entries[i].in_batch && !disp->reply.in_batch &&
+            disp->deferred.entries[i].request_id == id) {
+            post_error(disp, id, "bad-id", "request id already in flight");
+            return NULL;
+        }
+    }
+    d = control_deferred_reserve(&disp->deferred, disp->reply.client, &busy);
     if (d == NULL) {
         post_error(disp, id, "busy", busy != NULL ? busy : "deferred");
         return NULL;
     }
     d->active = true;
     d->request_id = id;
+    d->in_batch = disp->reply.in_batch;
+    d->batch_index = disp->reply.batch_index;
     d->kind = kind;
     d->request_token = token;
-    d->connection_epoch = control_server_connection_epoch(disp->server);
+    d->connection_epoch = reply_client(disp)->connection;
     d->deadline_ms = (uint64_t)SDL_GetTicks() + (uint64_t)timeout_ms;
     return d;
 }
@@ -647,13 +792,27 @@ static runtime_memory_mode to_runtime_memory_mode(uint8_t mode)
     }
 }
 
+static void to_runtime_memory_spans(const control_args *args, runtime_memory_span *out)
+{
+    uint32_t k;
+
+    for (k = 0; k < args->span_count; k++) {
+        out[k].address = args->spans[k].address;
+        out[k].mode = (uint8_t)to_runtime_memory_mode(args->spans[k].mode);
+        out[k].length = args->spans[k].length;
+    }
+}
+
+/* Only the requester's: other clients keep the edges they have not seen. */
 static void clear_execution_latches(control_dispatch_t *disp)
 {
-    disp->latch_paused = false;
-    disp->latch_running = false;
-    disp->latch_step_complete = false;
-    disp->latch_run_complete = false;
-    disp->latch_breakpoints = false;
+    control_dispatch_client *c = reply_client(disp);
+
+    c->latch_paused = false;
+    c->latch_running = false;
+    c->latch_step_complete = false;
+    c->latch_run_complete = false;
+    c->latch_breakpoints = false;
 }
 
 /* Instantaneous softswitch / beam dump (Apple analogue of c64m get-vic).
@@ -707,58 +866,614 @@ static void format_softswitches_text(
         (unsigned long long)ms->frame_number);
 }
 
-static bool try_post_frame(control_dispatch_t *disp, uint32_t request_id)
+/* Wire payload for one indexed frame: ARGB8888 (palette expanded here, on the
+   host thread) or INDEXED8 (palette entries LE, then the index bytes). */
+static uint8_t *build_frame_payload(
+    uint8_t format,
+    const uint8_t *indices,
+    const uint32_t *palette,
+    size_t pixel_count,
+    size_t *out_size)
 {
-    control_response response;
-    uint32_t width = 0;
-    uint32_t height = 0;
-    uint64_t frame_number = 0;
-    size_t pixel_count = (size_t)DISPLAY_FRAME_WIDTH * (size_t)DISPLAY_FRAME_HEIGHT;
-    uint32_t *pixels = (uint32_t *)malloc(pixel_count * sizeof(uint32_t));
-    char meta[CONTROL_RESPONSE_TEXT_MAX];
+    uint8_t *payload;
+    size_t i;
 
-    if (pixels == NULL) {
-        post_error(disp, request_id, "memory", "allocation-failed");
+    if (format == CONTROL_FRAME_FORMAT_INDEXED8) {
+        *out_size = (size_t)DISPLAY_FRAME_PALETTE_SIZE * 4u + pixel_count;
+        payload = (uint8_t *)malloc(*out_size);
+        if (payload == NULL) {
+            return NULL;
+        }
+        for (i = 0; i < (size_t)DISPLAY_FRAME_PALETTE_SIZE; i++) {
+            payload[i * 4u + 0u] = (uint8_t)(palette[i] & 0xFFu);
+            payload[i * 4u + 1u] = (uint8_t)((palette[i] >> 8) & 0xFFu);
+            payload[i * 4u + 2u] = (uint8_t)((palette[i] >> 16) & 0xFFu);
+            payload[i * 4u + 3u] = (uint8_t)((palette[i] >> 24) & 0xFFu);
+        }
+        memcpy(payload + (size_t)DISPLAY_FRAME_PALETTE_SIZE * 4u, indices, pixel_count);
+        return payload;
+    }
+    *out_size = pixel_count * 4u;
+    payload = (uint8_t *)malloc(*out_size);
+    if (payload == NULL) {
+        return NULL;
+    }
+    display_frame_expand_indexed8((uint32_t *)payload, indices, pixel_count, palette);
+    return payload;
+}
+
+/* "stride=… format=…" (+ palette=16 for indexed) for frame data metadata. */
+static void format_frame_layout(char *out, size_t out_size, uint8_t format, uint32_t width)
+{
+    if (format == CONTROL_FRAME_FORMAT_INDEXED8) {
+        snprintf(
+            out,
+            out_size,
+            "stride=%u format=indexed8 palette=%u",
+            width,
+            (unsigned)DISPLAY_FRAME_PALETTE_SIZE);
+    } else {
+        snprintf(out, out_size, "stride=%u format=argb8888", width * 4u);
+    }
+}
+
+/* Find the indices + palette of an earlier frame for encoding=delta: frames
+   recently sent first, then the frame ring. *out_ring is set when the ring
+   copy was used; the caller frees it. */
+static bool find_delta_base(
+    control_dispatch_t *disp,
+    uint64_t base_frame,
+    size_t pixel_count,
+    const uint8_t **out_indices,
+    const uint32_t **out_palette,
+    runtime_ring_frame **out_ring)
+{
+    runtime_ring_frame *ring;
+
+    *out_ring = NULL;
+    if (control_frame_cache_find(
+            reply_client(disp)->frame_cache, base_frame, pixel_count, out_indices, out_palette)) {
         return true;
     }
+    ring = (runtime_ring_frame *)malloc(sizeof(*ring));
+    if (ring == NULL) {
+        return false;
+    }
+    if (!runtime_client_copy_frame_at(disp->client, base_frame, false, ring) ||
+        ring->frame_number != base_frame ||
+        (size_t)ring->width * (size_t)ring->height != pixel_count) {
+        free(ring);
+        return false;
+    }
+    *out_indices = ring->pixels;
+    *out_palette = ring->palette;
+    *out_ring = ring;
+    return true;
+}
+
+/* Frame reply payload in format, sent with encoding (control_frame_codec.h),
+   plus the layout / encoding metadata for it. A delta whose base is no longer
+   held goes out as rle, and the metadata says so. Every frame sent is
+   remembered as a possible later base. */
+static uint8_t *build_encoded_frame(
+    control_dispatch_t *disp,
+    uint8_t format,
+    uint8_t encoding,
+    uint64_t base_frame,
+    uint64_t frame_number,
+    const uint8_t *indices,
+    const uint32_t *palette,
+    uint32_t width,
+    size_t pixel_count,
+    size_t *out_size,
+    char *layout,
+    size_t layout_size)
+{
+    uint8_t *raw;
+    uint8_t *payload = NULL;
+    size_t raw_size = 0;
+    size_t unit = format == CONTROL_FRAME_FORMAT_INDEXED8 ? 1u : 4u;
+    control_dispatch_client *c = reply_client(disp);
+
+    if (c->frame_cache == NULL) {
+        c->frame_cache = control_frame_cache_create();
+    }
+    if (encoding == CONTROL_FRAME_ENCODING_PNG) {
+        if (!control_frame_png_encode(
+                indices,
+                width,
+                (uint32_t)(pixel_count / width),
+                palette,
+                DISPLAY_FRAME_PALETTE_SIZE,
+                &payload,
+                out_size)) {
+            return NULL;
+        }
+        snprintf(layout, layout_size, "encoding=png");
+        control_frame_cache_store(c->frame_cache, frame_number, indices, palette, pixel_count);
+        return payload;
+    }
+
+    raw = build_frame_payload(format, indices, palette, pixel_count, &raw_size);
+    if (raw == NULL) {
+        return NULL;
+    }
+    format_frame_layout(layout, layout_size, format, width);
+    if (encoding == CONTROL_FRAME_ENCODING_RAW) {
+        control_frame_cache_store(c->frame_cache, frame_number, indices, palette, pixel_count);
+        *out_size = raw_size;
+        return raw;
+    }
+
+    {
+        const uint8_t *base_indices = NULL;
+        const uint32_t *base_palette = NULL;
+        runtime_ring_frame *ring = NULL;
+        uint8_t *base = NULL;
+        size_t base_size = 0;
+        size_t cap = control_frame_rle_bound(raw_size, unit);
+        size_t used = strlen(layout);
+
+        if (encoding == CONTROL_FRAME_ENCODING_DELTA &&
+            find_delta_base(
+                disp, base_frame, pixel_count, &base_indices, &base_palette, &ring)) {
+            base = build_frame_payload(format, base_indices, base_palette, pixel_count, &base_size);
+        }
+        free(ring);
+        if (encoding == CONTROL_FRAME_ENCODING_DELTA && base == NULL) {
+            encoding = CONTROL_FRAME_ENCODING_RLE;
+        }
+        payload = (uint8_t *)malloc(cap);
+        if (payload != NULL) {
+            *out_size = control_frame_rle_encode(raw, base, raw_size, unit, payload, cap);
+        }
+        free(base);
+        free(raw);
+        if (payload == NULL || *out_size == 0u) {
+            free(payload);
+            return NULL;
+        }
+        if (encoding == CONTROL_FRAME_ENCODING_DELTA) {
+            snprintf(
+                layout + used,
+                layout_size - used,
+                " encoding=delta base=%llu raw_size=%zu",
+                (unsigned long long)base_frame,
+                raw_size);
+        } else {
+            snprintf(layout + used, layout_size - used, " encoding=rle raw_size=%zu", raw_size);
+        }
+    }
+    control_frame_cache_store(c->frame_cache, frame_number, indices, palette, pixel_count);
+    return payload;
+}
+
+static bool try_post_frame(
+    control_dispatch_t *disp,
+    uint32_t request_id,
+    uint8_t format,
+    uint8_t encoding,
+    uint64_t base_frame)
+{
+    control_response response;
+    uint32_t width;
+    uint32_t height;
+    uint64_t frame_number;
+    const runtime_frame_buffer *frame;
+    uint8_t *payload;
+    size_t payload_size = 0;
+    char layout[128];
+    char meta[CONTROL_RESPONSE_TEXT_MAX];
 
-    if (!runtime_client_poll_argb_frame(
-            disp->client,
-            pixels,
-            (uint32_t)pixel_count,
-            &width,
-            &height,
-            &frame_number)) {
-        free(pixels);
+    /* Encode straight from the handoff's front buffer: no staging copy. */
+    frame = runtime_client_acquire_frame_since(disp->client, &reply_client(disp)->frame_seen);
+    if (frame == NULL) {
         return false;
     }
 
+    width = frame->width;
+    height = frame->height;
+    frame_number = frame->frame_number;
     if (width == 0u || height == 0u) {
         width = DISPLAY_FRAME_WIDTH;
         height = DISPLAY_FRAME_HEIGHT;
     }
     disp->frame_number = frame_number;
+    payload = build_encoded_frame(
+        disp,
+        format,
+        encoding,
+        base_frame,
+        frame_number,
+        frame->pixels,
+        frame->palette,
+        width,
+        (size_t)width * (size_t)height,
+        &payload_size,
+        layout,
+        sizeof(layout));
+    if (payload == NULL) {
+        post_error(disp, request_id, "memory", "allocation-failed");
+        return true;
+    }
     snprintf(
         meta,
         sizeof(meta),
-        "width=%u height=%u stride=%u format=argb8888 frame=%llu",
+        "width=%u height=%u %s frame=%llu",
         width,
         height,
-        width * 4u,
+        layout,
         (unsigned long long)frame_number);
     control_protocol_format_data(
         &response,
         request_id,
         "frame",
         meta,
-        (uint8_t *)pixels,
-        (size_t)width * (size_t)height * 4u);
-    if (!control_server_post_response(disp->server, &response)) {
-        free(pixels);
+        payload,
+        payload_size);
+    if (!dispatch_post(disp, &response)) {
+        free(payload);
+    }
+    return true;
+}
+
+/* One frame-subscription push. A refused push (backlog full) is dropped:
+   the next due frame goes out instead. */
+static void push_subscription_frame(
+    control_dispatch_t *disp,
+    control_subscription *sub,
+    const runtime_frame_buffer *frame)
+{
+    control_response response;
+    uint32_t width = frame->width;
+    uint32_t height = frame->height;
+    uint8_t encoding = sub->encoding;
+    uint8_t *payload;
+    size_t payload_size = 0;
+    char layout[128];
+    char meta[CONTROL_RESPONSE_TEXT_MAX];
+
+    if (width == 0u || height == 0u) {
+        width = DISPLAY_FRAME_WIDTH;
+        height = DISPLAY_FRAME_HEIGHT;
+    }
+    if (encoding == CONTROL_FRAME_ENCODING_DELTA && !sub->has_last_frame) {
+        encoding = CONTROL_FRAME_ENCODING_RLE;
+    }
+    payload = build_encoded_frame(
+        disp,
+        sub->format,
+        encoding,
+        sub->last_frame,
+        frame->frame_number,
+        frame->pixels,
+        frame->palette,
+        width,
+        (size_t)width * (size_t)height,
+        &payload_size,
+        layout,
+        sizeof(layout));
+    if (payload == NULL) {
+        return;
+    }
+    snprintf(
+        meta,
+        sizeof(meta),
+        "sub=%u width=%u height=%u %s frame=%llu",
+        sub->id,
+        width,
+        height,
+        layout,
+        (unsigned long long)frame->frame_number);
+    control_protocol_format_event_data(&response, "frame", meta, payload, payload_size);
+    if (push_to_client(disp, disp->reply.client, &response)) {
+        control_subscription_frame_sent(sub, frame->frame_number);
+    } else {
+        free(payload);
+    }
+}
+
+static void push_subscription_frames(control_dispatch_t *disp)
+{
+    control_dispatch_client *c = reply_client(disp);
+    const runtime_frame_buffer *frame = NULL;
+    size_t i;
+
+    for (i = 0; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+        control_subscription *sub = &c->subscriptions.subs[i];
+        if (sub->id == 0u || sub->kind != CONTROL_SUBSCRIPTION_FRAMES) {
+            continue;
+        }
+        if (frame == NULL) {
+            frame = runtime_client_acquire_frame_since(
+                disp->client, &c->subscription_frame_seen);
+            if (frame == NULL) {
+                return;
+            }
+        }
+        if (control_subscription_frame_due(sub, frame->frame_number)) {
+            push_subscription_frame(disp, sub, frame);
+        }
+    }
+}
+
+/* Compare a memory subscription with the newest RAM-mirror publish and push
+   the ranges that changed. A publish already compared is skipped. False
+   when this has to be tried again: the mirror is behind a queued write or
+   the push backlog is full. */
+static bool check_memory_subscription(control_dispatch_t *disp, control_subscription *sub)
+{
+    runtime_memory_span spans[CONTROL_MEMORY_SPANS_MAX];
+    runtime_ram_mirror_info info;
+    control_response response;
+    uint8_t *current;
+    uint8_t *payload = NULL;
+    size_t payload_size = 0;
+    uint64_t mask = 0;
+    char meta[CONTROL_RESPONSE_TEXT_MAX];
+    uint32_t k;
+
+    for (k = 0; k < sub->span_count; k++) {
+        spans[k].address = sub->spans[k].address;
+        spans[k].mode = (uint8_t)to_runtime_memory_mode(sub->spans[k].mode);
+        spans[k].length = sub->spans[k].length;
+    }
+    current = (uint8_t *)malloc(sub->total);
+    if (current == NULL ||
+        !runtime_client_read_memory_mirror_spans_info(
+            disp->client, spans, sub->span_count, current, &info)) {
+        free(current);
+        return false;
+    }
+    if (info.generation == sub->checked_generation) {
+        free(current);
+        return true;
+    }
+    if (control_subscription_memory_diff(sub, current, &mask, &payload, &payload_size)) {
+        snprintf(
+            meta,
+            sizeof(meta),
+            "sub=%u mask=%llx frame=%llu cycle=%llu",
+            sub->id,
+            (unsigned long long)mask,
+            (unsigned long long)info.frame_number,
+            (unsigned long long)info.cycle);
+        control_protocol_format_event_data(&response, "memory", meta, payload, payload_size);
+        if (!push_to_client(disp, disp->reply.client, &response)) {
+            free(payload);
+            free(current);
+            return false;
+        }
+        control_subscription_memory_sent(sub, current);
+    }
+    sub->checked_generation = info.generation;
+    free(current);
+    return true;
+}
+
+/* A frame was published (the mirror already holds it): every memory
+   subscription compares. Otherwise something changed while paused (step,
+   poke, reset, state load): on=change subscriptions compare each mirror
+   publish for a short while, since the event can precede the change. */
+static void trigger_memory_subscriptions(control_dispatch_t *disp, bool frame)
+{
+    control_dispatch_client *c = reply_client(disp);
+    uint64_t now = (uint64_t)SDL_GetTicks();
+    size_t i;
+
+    for (i = 0; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+        control_subscription *sub = &c->subscriptions.subs[i];
+        if (sub->id == 0u || sub->kind != CONTROL_SUBSCRIPTION_MEMORY) {
+            continue;
+        }
+        if (frame) {
+            if (!check_memory_subscription(disp, sub)) {
+                sub->recheck = true;
+                sub->recheck_due_ms = now + CONTROL_SUBSCRIPTION_RECHECK_MS;
+            }
+        } else if (!sub->on_frame) {
+            sub->recheck = true;
+            sub->recheck_due_ms = now + CONTROL_SUBSCRIPTION_RECHECK_MS;
+        }
+    }
+}
+
+/* Decode the text screen of the newest RAM-mirror publish, unless that
+   publish is the one already decoded. False while the mirror is behind a
+   queued write. */
+static bool refresh_text_screen(control_dispatch_t *disp)
+{
+    static const runtime_memory_span spans[2] = {
+        { 0x0400u, (uint8_t)RUNTIME_MEMORY_MODE_MAIN, 0x0800u },
+        { 0x0400u, (uint8_t)RUNTIME_MEMORY_MODE_AUX, 0x0400u }
+    };
+    uint8_t ram[APPLE2_VIDEO_TEXT_RAM_BYTES];
+    runtime_machine_snapshot state;
+    runtime_ram_mirror_info info;
+
+    if (!runtime_client_read_memory_mirror_spans_machine(
+            disp->client, spans, 2u, ram, &state, &info)) {
+        return false;
+    }
+    if (!disp->has_text || info.generation != disp->text_generation) {
+        apple2_video_decode_text(
+            state.apple_state_flags, state.apple_model == 1u, ram, &disp->text);
+        disp->has_text = true;
+        disp->text_generation = info.generation;
+        disp->text_frame = info.frame_number;
+        disp->text_cycle = info.cycle;
     }
     return true;
 }
 
+/* get-text reply from the decoded screen: one line per row. */
+static void post_text_screen(control_dispatch_t *disp, uint32_t id)
+{
+    control_response response;
+    char meta[CONTROL_RESPONSE_TEXT_MAX];
+    char *payload;
+    size_t size = 0;
+    uint32_t row;
+
+    payload = (char *)malloc(sizeof(disp->text.rows));
+    if (payload == NULL) {
+        post_error(disp, id, "internal", "out of memory");
+        return;
+    }
+    for (row = 0; row < APPLE2_VIDEO_TEXT_ROWS; row++) {
+        size_t length = strlen(disp->text.rows[row]);
+        memcpy(payload + size, disp->text.rows[row], length);
+        size += length;
+        payload[size++] = '\n';
+    }
+    snprintf(
+        meta,
+        sizeof(meta),
+        "columns=%u first-row=%u frame=%llu cycle=%llu",
+        (unsigned)disp->text.columns,
+        (unsigned)disp->text.first_row,
+        (unsigned long long)disp->text_frame,
+        (unsigned long long)disp->text_cycle);
+    control_protocol_format_data(&response, id, "text", meta, (uint8_t *)payload, size);
+    if (!dispatch_post(disp, &response)) {
+        free(payload);
+    }
+}
+
+/* Answer wait-text id when re matches a text row of the decoded screen
+   (rows top to bottom, first match in the row). re_compile hands back one
+   static buffer (the help view uses it on this thread too), so callers
+   compile right before matching. */
+static bool post_text_match(control_dispatch_t *disp, uint32_t id, re_t re)
+{
+    uint32_t row;
+
+    for (row = disp->text.first_row; row < APPLE2_VIDEO_TEXT_ROWS; row++) {
+        int length = 0;
+        int column = re_matchp(re, disp->text.rows[row], &length);
+
+        if (column >= 0) {
+            char text[CONTROL_RESPONSE_TEXT_MAX];
+            snprintf(
+                text,
+                sizeof(text),
+                "row=%u column=%d length=%d frame=%llu",
+                row,
+                column,
+                length,
+                (unsigned long long)disp->text_frame);
+            post_ok(disp, id, text);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Serve get-text requests that found the mirror behind a write, and compare
+   each wait-text pattern with the newest publish once. */
+static void check_text_requests(control_dispatch_t *disp)
+{
+    deferred_control_response *pending[CONTROL_DEFERRED_TABLE_SIZE];
+    bool wanted = false;
+    size_t count;
+    size_t i;
+
+    count = control_deferred_collect(&disp->deferred, pending, CONTROL_DEFERRED_TABLE_SIZE);
+    for (i = 0; i < count && !wanted; i++) {
+        wanted = pending[i]->kind == CONTROL_DEFERRED_GET_TEXT ||
+            pending[i]->kind == CONTROL_DEFERRED_WAIT_TEXT;
+    }
+    if (!wanted || !refresh_text_screen(disp)) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        deferred_control_response *d = pending[i];
+        control_reply_scope saved;
+
+        if (d->kind == CONTROL_DEFERRED_GET_TEXT) {
+            saved = enter_reply_scope(disp, d);
+            post_text_screen(disp, d->request_id);
+            control_deferred_clear(d);
+            leave_reply_scope(disp, saved);
+        } else if (d->kind == CONTROL_DEFERRED_WAIT_TEXT &&
+                   d->text_generation != disp->text_generation) {
+            d->text_generation = disp->text_generation;
+            saved = enter_reply_scope(disp, d);
+            if (post_text_match(disp, d->request_id, re_compile(d->text_pattern))) {
+                control_deferred_clear(d);
+            }
+            leave_reply_scope(disp, saved);
+        }
+    }
+}
+
+static void recheck_memory_subscriptions(control_dispatch_t *disp)
+{
+    control_dispatch_client *c = reply_client(disp);
+    uint64_t now = (uint64_t)SDL_GetTicks();
+    size_t i;
+
+    for (i = 0; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+        control_subscription *sub = &c->subscriptions.subs[i];
+        if (sub->id == 0u || !sub->recheck) {
+            continue;
+        }
+        if (!check_memory_subscription(disp, sub)) {
+            if (now >= sub->recheck_due_ms) {
+                sub->recheck_due_ms = now + CONTROL_SUBSCRIPTION_RECHECK_MS;
+            }
+        } else if (now >= sub->recheck_due_ms) {
+            sub->recheck = false;
+        }
+    }
+}
+
+static void handle_subscribe(control_dispatch_t *disp, const control_request *req)
+{
+    control_dispatch_client *c = reply_client(disp);
+    control_subscription *sub;
+    char text[CONTROL_RESPONSE_TEXT_MAX];
+
+    sub = control_subscription_add(&c->subscriptions, &req->args);
+    if (sub == NULL) {
+        post_error(disp, req->id, "busy", "subscriptions-full");
+        return;
+    }
+    if (sub->kind == CONTROL_SUBSCRIPTION_FRAMES) {
+        snprintf(
+            text,
+            sizeof(text),
+            "sub=%u kind=frames every=%u format=%s encoding=%s",
+            sub->id,
+            sub->every,
+            control_protocol_frame_format_name(sub->format),
+            control_protocol_frame_encoding_name(sub->encoding));
+        post_ok(disp, req->id, text);
+        /* Start from the frame on screen; then every Nth new one. */
+        {
+            uint64_t seen = 0;
+            const runtime_frame_buffer *frame =
+                runtime_client_acquire_frame_since(disp->client, &seen);
+            if (frame != NULL) {
+                push_subscription_frame(disp, sub, frame);
+            }
+        }
+        return;
+    }
+    snprintf(
+        text,
+        sizeof(text),
+        "sub=%u kind=memory ranges=%u bytes=%u on=%s",
+        sub->id,
+        sub->span_count,
+        sub->total,
+        sub->on_frame ? "frame" : "change");
+    post_ok(disp, req->id, text);
+    /* First push: every range, from the next poll. */
+    sub->recheck = true;
+    sub->recheck_due_ms = (uint64_t)SDL_GetTicks();
+}
+
 static const char *event_name_for_type(runtime_event_type type)
 {
     switch (type) {
@@ -785,161 +1500,75 @@ static const char *event_name_for_type(runtime_event_type type)
     }
 }
 
-static bool latch_matches_event(const control_dispatch_t *disp, const char *name)
+static bool latch_matches_event(const control_dispatch_client *c, const char *name)
 {
     if (name == NULL) {
         return false;
     }
     if (strcmp(name, "paused") == 0) {
-        return disp->latch_paused;
+        return c->latch_paused;
     }
     if (strcmp(name, "running") == 0) {
-        return disp->latch_running;
+        return c->latch_running;
     }
     if (strcmp(name, "step-complete") == 0) {
-        return disp->latch_step_complete;
+        return c->latch_step_complete;
     }
     if (strcmp(name, "run-complete") == 0) {
-        return disp->latch_run_complete;
+        return c->latch_run_complete;
     }
     if (strcmp(name, "reset-complete") == 0) {
-        return disp->latch_reset_complete;
+        return c->latch_reset_complete;
     }
     if (strcmp(name, "breakpoints") == 0) {
-        return disp->latch_breakpoints;
+        return c->latch_breakpoints;
     }
     if (strcmp(name, "frame") == 0) {
-        return disp->latch_frame;
+        return c->latch_frame;
     }
     if (strcmp(name, "assemble-complete") == 0) {
-        return disp->latch_assemble_complete;
+        return c->latch_assemble_complete;
     }
     if (strcmp(name, "assemble-error") == 0) {
-        return disp->latch_assemble_error;
+        return c->latch_assemble_error;
     }
     return false;
 }
 
-static void consume_latch(control_dispatch_t *disp, const char *name)
+static void consume_latch(control_dispatch_client *c, const char *name)
 {
     if (name == NULL) {
         return;
     }
     if (strcmp(name, "paused") == 0) {
-        disp->latch_paused = false;
+        c->latch_paused = false;
     } else if (strcmp(name, "running") == 0) {
-        disp->latch_running = false;
+        c->latch_running = false;
     } else if (strcmp(name, "step-complete") == 0) {
-        disp->latch_step_complete = false;
+        c->latch_step_complete = false;
     } else if (strcmp(name, "run-complete") == 0) {
-        disp->latch_run_complete = false;
+        c->latch_run_complete = false;
     } else if (strcmp(name, "reset-complete") == 0) {
-        disp->latch_reset_complete = false;
+        c->latch_reset_complete = false;
     } else if (strcmp(name, "breakpoints") == 0) {
-        disp->latch_breakpoints = false;
+        c->latch_breakpoints = false;
     } else if (strcmp(name, "frame") == 0) {
-        disp->latch_frame = false;
+        c->latch_frame = false;
     } else if (strcmp(name, "assemble-complete") == 0) {
-        disp->latch_assemble_complete = false;
+        c->latch_assemble_complete = false;
     } else if (strcmp(name, "assemble-error") == 0) {
-        disp->latch_assemble_error = false;
+        c->latch_assemble_error = false;
     }
 }
 
-void control_dispatch_on_runtime_event(
+/* Complete or advance one deferred entry from a runtime event. */
+static void deferred_on_runtime_event(
     control_dispatch_t *disp,
+    deferred_control_response *d,
     const runtime_event *event)
 {
-    deferred_control_response *d;
     const char *ename;
 
-    if (disp == NULL || event == NULL) {
-        return;
-    }
-
-    if (event->type == RUNTIME_EVENT_RUNNING) {
-        disp->machine_running = true;
-        disp->seen_paused = false;
-        disp->latch_running = true;
-        set_stop_reason(disp, "none");
-    } else if (event->type == RUNTIME_EVENT_MACHINE_STATE_RESPONSE) {
-        /* Authoritative stop reason (breakpoint vs pause command vs step). */
-        set_stop_reason(
-            disp, stop_reason_name(event->data.machine_state.stop_reason));
-        disp->cycle = event->data.machine_state.cpu_cycles;
-        disp->frame_number = event->data.machine_state.frame_number;
-        disp->has_cpu = true;
-        disp->last_pc = event->data.machine_state.pc;
-        disp->last_a = event->data.machine_state.a;
-        disp->last_x = event->data.machine_state.x;
-        disp->last_y = event->data.machine_state.y;
-        disp->last_sp = event->data.machine_state.sp;
-        disp->last_p = event->data.machine_state.p;
-        disp->turbo_mode = event->data.machine_state.active_turbo_multiplier;
-        cache_slot_map_from_machine_state(disp, &event->data.machine_state);
-        if (event->data.machine_state.running == 0u) {
-            disp->machine_running = false;
-            disp->seen_paused = true;
-        }
-    } else if (event->type == RUNTIME_EVENT_PAUSED) {
-        disp->machine_running = false;
-        disp->seen_paused = true;
-        disp->latch_paused = true;
-        /* Do not overwrite MACHINE_STATE stop_reason (e.g. breakpoint). */
-        if (strcmp(disp->stop_reason, "none") == 0 ||
-            disp->stop_reason[0] == '\0') {
-            set_stop_reason(disp, "pause");
-        }
-    } else if (event->type == RUNTIME_EVENT_STEP_COMPLETE) {
-        disp->machine_running = false;
-        disp->seen_paused = true;
-        disp->latch_paused = true;
-        disp->latch_step_complete = true;
-        set_stop_reason(
-            disp, stop_reason_name(event->data.step_complete.reason));
-        if (strcmp(disp->stop_reason, "none") == 0) {
-            set_stop_reason(disp, "step");
-        }
-    } else if (event->type == RUNTIME_EVENT_RUN_COMPLETE) {
-        disp->machine_running = false;
-        disp->seen_paused = true;
-        disp->latch_paused = true;
-        disp->latch_run_complete = true;
-        set_stop_reason(disp, "run-complete");
-    } else if (event->type == RUNTIME_EVENT_RESET_COMPLETE) {
-        disp->latch_reset_complete = true;
-    } else if (event->type == RUNTIME_EVENT_BREAKPOINTS_RESPONSE) {
-        disp->latch_breakpoints = true;
-    } else if (event->type == RUNTIME_EVENT_FRAME_READY) {
-        disp->latch_frame = true;
-        disp->frame_number += 1u;
-    } else if (event->type == RUNTIME_EVENT_ASSEMBLE_COMPLETE) {
-        disp->latch_assemble_complete = true;
-        /* Single-consumer symbol slot: cache here so find-symbol and the UI
-           (via control_dispatch_copy_symbols) share one poll. */
-        cache_symbols_from_client(disp);
-    } else if (event->type == RUNTIME_EVENT_ASSEMBLE_ERROR) {
-        disp->latch_assemble_error = true;
-    } else if (event->type == RUNTIME_EVENT_STATE_CHANGED) {
-        control_dispatch_post_state_changed(disp, event);
-    }
-
-    if (event->type == RUNTIME_EVENT_CPU_STATE_RESPONSE) {
-        disp->has_cpu = true;
-        disp->last_pc = event->data.cpu_state.pc;
-        disp->last_a = event->data.cpu_state.a;
-        disp->last_x = event->data.cpu_state.x;
-        disp->last_y = event->data.cpu_state.y;
-        disp->last_sp = event->data.cpu_state.sp;
-        disp->last_p = event->data.cpu_state.p;
-        disp->cycle = event->data.cpu_state.cycles;
-    }
-
-    d = control_deferred_active(&disp->deferred);
-    if (d == NULL) {
-        return;
-    }
-
     if (d->kind == CONTROL_DEFERRED_MEDIA_OP &&
         event->type == RUNTIME_EVENT_MACHINE_STATE_RESPONSE) {
         /* Slot map already cached above; resolve and run the pending op. */
@@ -970,8 +1599,8 @@ void control_dispatch_on_runtime_event(
                 disp->stop_reason);
             post_ok(disp, d->request_id, text);
             /* Consume edge after delivery (same as sticky immediate path). */
-            disp->seen_paused = false;
-            disp->latch_paused = false;
+            reply_client(disp)->seen_paused = false;
+            reply_client(disp)->latch_paused = false;
             control_deferred_clear(d);
         }
         return;
@@ -1009,7 +1638,7 @@ void control_dispatch_on_runtime_event(
             char text[CONTROL_RESPONSE_TEXT_MAX];
             snprintf(text, sizeof(text), "event=%s", ename);
             post_ok(disp, d->request_id, text);
-            consume_latch(disp, ename);
+            consume_latch(reply_client(disp), ename);
             control_deferred_clear(d);
         }
         return;
@@ -1017,7 +1646,8 @@ void control_dispatch_on_runtime_event(
 
     if (d->kind == CONTROL_DEFERRED_GET_FRAME &&
         event->type == RUNTIME_EVENT_FRAME_READY) {
-        if (try_post_frame(disp, d->request_id)) {
+        if (try_post_frame(
+                disp, d->request_id, d->frame_format, d->frame_encoding, d->frame_delta_base)) {
             control_deferred_clear(d);
         }
         return;
@@ -1052,7 +1682,8 @@ void control_dispatch_on_runtime_event(
         return;
     }
 
-    if (d->kind == CONTROL_DEFERRED_GET_MEMORY &&
+    if ((d->kind == CONTROL_DEFERRED_GET_MEMORY ||
+         d->kind == CONTROL_DEFERRED_GET_MEMORY_MULTI) &&
         event->type == RUNTIME_EVENT_MEMORY_RPC_COMPLETE &&
         event->request_token == d->request_token) {
         control_response response;
@@ -1080,16 +1711,25 @@ void control_dispatch_on_runtime_event(
             return;
         }
 
-        snprintf(
-            meta,
-            sizeof(meta),
-            "addr=%04X length=%u mode=%s",
-            address,
-            length,
-            control_protocol_memory_mode_name(d->memory_mode));
+        if (d->kind == CONTROL_DEFERRED_GET_MEMORY_MULTI) {
+            snprintf(meta, sizeof(meta), "spans=%u length=%u", d->memory_span_count, length);
+        } else {
+            snprintf(
+                meta,
+                sizeof(meta),
+                "addr=%04X length=%u mode=%s",
+                address,
+                length,
+                control_protocol_memory_mode_name(d->memory_mode));
+        }
         control_protocol_format_data(
-            &response, d->request_id, "memory", meta, bytes, length);
-        if (!control_server_post_response(disp->server, &response)) {
+            &response,
+            d->request_id,
+            d->kind == CONTROL_DEFERRED_GET_MEMORY_MULTI ? "memory-multi" : "memory",
+            meta,
+            bytes,
+            length);
+        if (!dispatch_post(disp, &response)) {
             free(bytes);
         }
         control_deferred_clear(d);
@@ -1116,7 +1756,7 @@ void control_dispatch_on_runtime_event(
         }
         control_protocol_format_data(
             &response, d->request_id, "breakpoints", meta, payload, payload_size);
-        if (!control_server_post_response(disp->server, &response)) {
+        if (!dispatch_post(disp, &response)) {
             free(payload);
         }
         control_deferred_clear(d);
@@ -1138,6 +1778,52 @@ void control_dispatch_on_runtime_event(
         return;
     }
 
+    if (d->kind == CONTROL_DEFERRED_REWIND &&
+        event->type == RUNTIME_EVENT_REWIND_COMPLETE &&
+        event->request_token == d->request_token) {
+        if (event->data.rewind.ok != 0u) {
+            char text[CONTROL_RESPONSE_TEXT_MAX];
+            snprintf(
+                text,
+                sizeof(text),
+                "frame=%llu cycles=%llu frames=%u checkpoints=%u",
+                (unsigned long long)event->data.rewind.frame_number,
+                (unsigned long long)event->data.rewind.cycles,
+                (unsigned)event->data.rewind.frames,
+                (unsigned)event->data.rewind.checkpoints);
+            post_ok(disp, d->request_id, text);
+        } else {
+            post_error(disp, d->request_id, "not-found", "rewind buffer off or empty");
+        }
+        control_deferred_clear(d);
+        return;
+    }
+
+    if (d->kind == CONTROL_DEFERRED_SEEK &&
+        event->type == RUNTIME_EVENT_SEEK_COMPLETE &&
+        event->request_token == d->request_token) {
+        if (event->data.seek.result == RUNTIME_SEEK_OK) {
+            char text[CONTROL_RESPONSE_TEXT_MAX];
+            snprintf(
+                text,
+                sizeof(text),
+                "pc=%04X cycles=%llu frame=%llu stop=%s",
+                (unsigned)event->data.seek.pc,
+                (unsigned long long)event->data.seek.cycles,
+                (unsigned long long)event->data.seek.frame_number,
+                stop_reason_name((runtime_stop_reason)event->data.seek.stop));
+            post_ok(disp, d->request_id, text);
+        } else if (event->data.seek.result == RUNTIME_SEEK_NO_BREAKPOINT) {
+            post_error(disp, d->request_id, "not-found", "no earlier breakpoint hit");
+        } else if (event->data.seek.result == RUNTIME_SEEK_INPUT) {
+            post_error(disp, d->request_id, "not-found", "host input in the way");
+        } else {
+            post_error(disp, d->request_id, "not-found", "rewind buffer off or too short");
+        }
+        control_deferred_clear(d);
+        return;
+    }
+
     if (d->kind == CONTROL_DEFERRED_ASSEMBLE &&
         (event->type == RUNTIME_EVENT_ASSEMBLE_COMPLETE ||
          event->type == RUNTIME_EVENT_ASSEMBLE_ERROR)) {
@@ -1243,43 +1929,210 @@ void control_dispatch_on_runtime_event(
             control_deferred_clear(d);
             return;
         }
-        if (meta->byte_length == 0u) {
-            /* status-only success (history-close) */
-            post_ok(disp, d->request_id, "");
-            control_deferred_clear(d);
-            return;
+        if (meta->byte_length == 0u) {
+            /* status-only success (history-close) */
+            post_ok(disp, d->request_id, "");
+            control_deferred_clear(d);
+            return;
+        }
+        {
+            control_response response;
+            uint8_t *bytes = NULL;
+            uint32_t length = 0;
+            runtime_history_rpc_meta claimed;
+            char mtext[CONTROL_RESPONSE_TEXT_MAX];
+
+            if (!runtime_client_claim_history_rpc(
+                    disp->client, d->request_token, &bytes, &length, &claimed)) {
+                post_error(disp, d->request_id, "rpc", "claim-failed");
+                control_deferred_clear(d);
+                return;
+            }
+            snprintf(
+                mtext,
+                sizeof(mtext),
+                "epoch=%llu count=%u cursor=%llu more=%u oldest=%llu newest=%llu",
+                (unsigned long long)claimed.epoch,
+                claimed.count,
+                (unsigned long long)claimed.cursor,
+                claimed.more ? 1u : 0u,
+                (unsigned long long)claimed.oldest,
+                (unsigned long long)claimed.newest);
+            control_protocol_format_data(
+                &response, d->request_id, "history", mtext, bytes, length);
+            if (!dispatch_post(disp, &response)) {
+                free(bytes);
+            }
+            control_deferred_clear(d);
+        }
+        return;
+    }
+}
+
+/* Every client sees each edge: latch it for each of them. */
+static void latch_client_event(control_dispatch_client *c, const runtime_event *event)
+{
+    switch (event->type) {
+    case RUNTIME_EVENT_RUNNING:
+        c->seen_paused = false;
+        c->latch_running = true;
+        break;
+    case RUNTIME_EVENT_MACHINE_STATE_RESPONSE:
+        if (event->data.machine_state.running == 0u) {
+            c->seen_paused = true;
+        }
+        break;
+    case RUNTIME_EVENT_PAUSED:
+        c->seen_paused = true;
+        c->latch_paused = true;
+        break;
+    case RUNTIME_EVENT_STEP_COMPLETE:
+        c->seen_paused = true;
+        c->latch_paused = true;
+        c->latch_step_complete = true;
+        break;
+    case RUNTIME_EVENT_RUN_COMPLETE:
+        c->seen_paused = true;
+        c->latch_paused = true;
+        c->latch_run_complete = true;
+        break;
+    case RUNTIME_EVENT_RESET_COMPLETE:
+        c->latch_reset_complete = true;
+        break;
+    case RUNTIME_EVENT_BREAKPOINTS_RESPONSE:
+        c->latch_breakpoints = true;
+        break;
+    case RUNTIME_EVENT_FRAME_READY:
+        c->latch_frame = true;
+        break;
+    case RUNTIME_EVENT_ASSEMBLE_COMPLETE:
+        c->latch_assemble_complete = true;
+        break;
+    case RUNTIME_EVENT_ASSEMBLE_ERROR:
+        c->latch_assemble_error = true;
+        break;
+    default:
+        break;
+    }
+}
+
+void control_dispatch_on_runtime_event(
+    control_dispatch_t *disp,
+    const runtime_event *event)
+{
+    deferred_control_response *pending[CONTROL_DEFERRED_TABLE_SIZE];
+    size_t count;
+    size_t i;
+    uint32_t slot;
+
+    if (disp == NULL || event == NULL) {
+        return;
+    }
+
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        if (disp->clients[slot].connection != 0u) {
+            latch_client_event(&disp->clients[slot], event);
+        }
+    }
+    if (event->type == RUNTIME_EVENT_RUNNING) {
+        disp->machine_running = true;
+        set_stop_reason(disp, "none");
+    } else if (event->type == RUNTIME_EVENT_MACHINE_STATE_RESPONSE) {
+        /* Authoritative stop reason (breakpoint vs pause command vs step). */
+        set_stop_reason(
+            disp, stop_reason_name(event->data.machine_state.stop_reason));
+        disp->cycle = event->data.machine_state.cpu_cycles;
+        disp->frame_number = event->data.machine_state.frame_number;
+        disp->has_cpu = true;
+        disp->last_pc = event->data.machine_state.pc;
+        disp->last_a = event->data.machine_state.a;
+        disp->last_x = event->data.machine_state.x;
+        disp->last_y = event->data.machine_state.y;
+        disp->last_sp = event->data.machine_state.sp;
+        disp->last_p = event->data.machine_state.p;
+        disp->turbo_mode = event->data.machine_state.active_turbo_multiplier;
+        cache_slot_map_from_machine_state(disp, &event->data.machine_state);
+        if (event->data.machine_state.running == 0u) {
+            disp->machine_running = false;
+        }
+    } else if (event->type == RUNTIME_EVENT_PAUSED) {
+        disp->machine_running = false;
+        /* Do not overwrite MACHINE_STATE stop_reason (e.g. breakpoint). */
+        if (strcmp(disp->stop_reason, "none") == 0 ||
+            disp->stop_reason[0] == '\0') {
+            set_stop_reason(disp, "pause");
+        }
+    } else if (event->type == RUNTIME_EVENT_STEP_COMPLETE) {
+        disp->machine_running = false;
+        set_stop_reason(
+            disp, stop_reason_name(event->data.step_complete.reason));
+        if (strcmp(disp->stop_reason, "none") == 0) {
+            set_stop_reason(disp, "step");
+        }
+    } else if (event->type == RUNTIME_EVENT_RUN_COMPLETE) {
+        disp->machine_running = false;
+        set_stop_reason(disp, "run-complete");
+    } else if (event->type == RUNTIME_EVENT_FRAME_READY) {
+        disp->frame_number += 1u;
+    } else if (event->type == RUNTIME_EVENT_ASSEMBLE_COMPLETE) {
+        /* Single-consumer symbol slot: cache here so find-symbol and the UI
+           (via control_dispatch_copy_symbols) share one poll. */
+        cache_symbols_from_client(disp);
+    } else if (event->type == RUNTIME_EVENT_STATE_CHANGED) {
+        control_dispatch_post_state_changed(disp, event);
+    }
+
+    if (event->type == RUNTIME_EVENT_STATE_CHANGED ||
+        event->type == RUNTIME_EVENT_PAUSED ||
+        event->type == RUNTIME_EVENT_STEP_COMPLETE ||
+        event->type == RUNTIME_EVENT_RUN_COMPLETE ||
+        event->type == RUNTIME_EVENT_RESET_COMPLETE) {
+        /* Paused-time changes publish no frame; see check_text_requests. */
+        disp->text_recheck_ms = (uint64_t)SDL_GetTicks() + CONTROL_SUBSCRIPTION_RECHECK_MS;
+    }
+
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        control_reply_scope saved;
+
+        if (!control_subscription_any(&disp->clients[slot].subscriptions)) {
+            continue;
+        }
+        saved = enter_client_scope(disp, slot);
+        if (event->type == RUNTIME_EVENT_FRAME_READY) {
+            push_subscription_frames(disp);
+            trigger_memory_subscriptions(disp, true);
+        } else if (event->type == RUNTIME_EVENT_STATE_CHANGED ||
+                   event->type == RUNTIME_EVENT_PAUSED ||
+                   event->type == RUNTIME_EVENT_STEP_COMPLETE ||
+                   event->type == RUNTIME_EVENT_RUN_COMPLETE ||
+                   event->type == RUNTIME_EVENT_RESET_COMPLETE) {
+            trigger_memory_subscriptions(disp, false);
         }
-        {
-            control_response response;
-            uint8_t *bytes = NULL;
-            uint32_t length = 0;
-            runtime_history_rpc_meta claimed;
-            char mtext[CONTROL_RESPONSE_TEXT_MAX];
+        leave_reply_scope(disp, saved);
+    }
 
-            if (!runtime_client_claim_history_rpc(
-                    disp->client, d->request_token, &bytes, &length, &claimed)) {
-                post_error(disp, d->request_id, "rpc", "claim-failed");
-                control_deferred_clear(d);
-                return;
-            }
-            snprintf(
-                mtext,
-                sizeof(mtext),
-                "epoch=%llu count=%u cursor=%llu more=%u oldest=%llu newest=%llu",
-                (unsigned long long)claimed.epoch,
-                claimed.count,
-                (unsigned long long)claimed.cursor,
-                claimed.more ? 1u : 0u,
-                (unsigned long long)claimed.oldest,
-                (unsigned long long)claimed.newest);
-            control_protocol_format_data(
-                &response, d->request_id, "history", mtext, bytes, length);
-            if (!control_server_post_response(disp->server, &response)) {
-                free(bytes);
-            }
-            control_deferred_clear(d);
+    if (event->type == RUNTIME_EVENT_CPU_STATE_RESPONSE) {
+        disp->has_cpu = true;
+        disp->last_pc = event->data.cpu_state.pc;
+        disp->last_a = event->data.cpu_state.a;
+        disp->last_x = event->data.cpu_state.x;
+        disp->last_y = event->data.cpu_state.y;
+        disp->last_sp = event->data.cpu_state.sp;
+        disp->last_p = event->data.cpu_state.p;
+        disp->cycle = event->data.cpu_state.cycles;
+    }
+
+    /* Oldest first. Waits all see the event; a response completes only the
+       oldest matching request, since the worker answers commands in order. */
+    count = control_deferred_collect(&disp->deferred, pending, CONTROL_DEFERRED_TABLE_SIZE);
+    for (i = 0; i < count; i++) {
+        control_deferred_kind kind = pending[i]->kind;
+        control_reply_scope saved = enter_reply_scope(disp, pending[i]);
+        deferred_on_runtime_event(disp, pending[i], event);
+        leave_reply_scope(disp, saved);
+        if (!pending[i]->active && !control_deferred_kind_is_wait(kind)) {
+            break;
         }
-        return;
     }
 }
 
@@ -1461,6 +2314,8 @@ static bool parse_history_find_options(
     return true;
 }
 
+static void handle_batch(control_dispatch_t *disp, control_request *req);
+
 static void handle_request(control_dispatch_t *disp, control_request *req)
 {
     runtime_client *client = disp->client;
@@ -1475,7 +2330,7 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
         clear_execution_latches(disp);
         (void)runtime_client_run(client);
         disp->machine_running = true;
-        disp->seen_paused = false;
+        reply_client(disp)->seen_paused = false;
         post_ok(disp, req->id, "accepted=1");
         break;
     case CONTROL_COMMAND_PAUSE:
@@ -1549,8 +2404,15 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
 
     case CONTROL_COMMAND_GET_SOFTSWITCHES: {
         /* Snapshot via machine state (state_flags + beam). Not $C0xx memory. */
-        deferred_control_response *d = begin_deferred(
-            disp, req->id, CONTROL_DEFERRED_GET_SOFTSWITCHES, 2000u, 0u);
+        deferred_control_response *d;
+        runtime_machine_snapshot mirrored;
+        if (runtime_client_read_machine_mirror(client, &mirrored)) {
+            char text[CONTROL_RESPONSE_TEXT_MAX];
+            format_softswitches_text(text, sizeof(text), &mirrored);
+            post_ok(disp, req->id, text);
+            break;
+        }
+        d = begin_deferred(disp, req->id, CONTROL_DEFERRED_GET_SOFTSWITCHES, 2000u, 0u);
         if (d == NULL) {
             break;
         }
@@ -1562,10 +2424,33 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
     }
 
     case CONTROL_COMMAND_GET_MEMORY: {
-        uint64_t token = runtime_client_alloc_request_token(client);
+        uint64_t token;
         runtime_memory_mode mode = to_runtime_memory_mode(req->args.memory_mode);
-        deferred_control_response *d =
-            begin_deferred(disp, req->id, CONTROL_DEFERRED_GET_MEMORY, 2000u, token);
+        deferred_control_response *d;
+        uint8_t *mirrored = (uint8_t *)malloc(req->args.length);
+        /* Worker RAM mirror first: no queue round-trip while it is current. */
+        if (mirrored != NULL &&
+            runtime_client_read_memory_mirror(
+                client, req->args.address, req->args.length, mode, mirrored)) {
+            control_response response;
+            char meta[CONTROL_RESPONSE_TEXT_MAX];
+            snprintf(
+                meta,
+                sizeof(meta),
+                "addr=%04X length=%u mode=%s",
+                req->args.address,
+                req->args.length,
+                control_protocol_memory_mode_name(req->args.memory_mode));
+            control_protocol_format_data(
+                &response, req->id, "memory", meta, mirrored, req->args.length);
+            if (!dispatch_post(disp, &response)) {
+                free(mirrored);
+            }
+            break;
+        }
+        free(mirrored);
+        token = runtime_client_alloc_request_token(client);
+        d = begin_deferred(disp, req->id, CONTROL_DEFERRED_GET_MEMORY, 2000u, token);
         if (d == NULL) {
             break;
         }
@@ -1617,8 +2502,73 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
         break;
     }
 
+    case CONTROL_COMMAND_GET_MEMORY_MULTI: {
+        runtime_memory_span spans[CONTROL_MEMORY_SPANS_MAX];
+        uint64_t token;
+        deferred_control_response *d;
+        uint8_t *mirrored;
+
+        to_runtime_memory_spans(&req->args, spans);
+        /* One consistent mirror publish for every span when it is current. */
+        mirrored = (uint8_t *)malloc(req->args.length);
+        if (mirrored != NULL &&
+            runtime_client_read_memory_mirror_spans(
+                client, spans, req->args.span_count, mirrored)) {
+            control_response response;
+            char meta[CONTROL_RESPONSE_TEXT_MAX];
+            snprintf(
+                meta, sizeof(meta), "spans=%u length=%u", req->args.span_count, req->args.length);
+            control_protocol_format_data(
+                &response, req->id, "memory-multi", meta, mirrored, req->args.length);
+            if (!dispatch_post(disp, &response)) {
+                free(mirrored);
+            }
+            break;
+        }
+        free(mirrored);
+        token = runtime_client_alloc_request_token(client);
+        d = begin_deferred(disp, req->id, CONTROL_DEFERRED_GET_MEMORY_MULTI, 2000u, token);
+        if (d == NULL) {
+            break;
+        }
+        d->memory_span_count = req->args.span_count;
+        if (!runtime_client_request_memory_spans(client, spans, req->args.span_count, token)) {
+            post_error(disp, req->id, "busy", "queue");
+            control_deferred_clear(d);
+        }
+        break;
+    }
+
+    case CONTROL_COMMAND_SET_MEMORY_MULTI: {
+        runtime_memory_span spans[CONTROL_MEMORY_SPANS_MAX];
+        char text[CONTROL_RESPONSE_TEXT_MAX];
+        uint8_t *bytes = req->payload;
+
+        if (bytes == NULL || req->payload_size != req->args.length) {
+            post_error(disp, req->id, "bad-payload", "length");
+            break;
+        }
+        to_runtime_memory_spans(&req->args, spans);
+        /* The runtime takes the payload buffer as is. */
+        req->payload = NULL;
+        req->payload_size = 0;
+        if (!runtime_client_write_memory_spans(
+                client, spans, req->args.span_count, bytes, req->args.length)) {
+            post_error(disp, req->id, "busy", "queue");
+            break;
+        }
+        snprintf(text, sizeof(text), "spans=%u length=%u", req->args.span_count, req->args.length);
+        post_ok(disp, req->id, text);
+        break;
+    }
+
     case CONTROL_COMMAND_GET_FRAME: {
-        if (try_post_frame(disp, req->id)) {
+        if (try_post_frame(
+                disp,
+                req->id,
+                req->args.frame_format,
+                req->args.frame_encoding,
+                req->args.frame_delta_base)) {
             break;
         }
         {
@@ -1627,6 +2577,9 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
             if (d == NULL) {
                 break;
             }
+            d->frame_format = req->args.frame_format;
+            d->frame_encoding = req->args.frame_encoding;
+            d->frame_delta_base = req->args.frame_delta_base;
             (void)runtime_client_request_frame(client);
         }
         break;
@@ -1639,13 +2592,18 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
         snprintf(
             text,
             sizeof(text),
-            "capacity=%u count=%u dropped=%llu recording=%d bytes=%llu "
+            "capacity=%u count=%u dropped=%llu recording=%d mode=%s bytes=%llu "
+            "used_bytes=%llu keyframes=%llu repeats=%llu "
             "oldest_frame=%llu newest_frame=%llu oldest_cycle=%llu newest_cycle=%llu",
             info.capacity,
             info.count,
             (unsigned long long)info.dropped,
             info.recording ? 1 : 0,
+            runtime_frame_ring_mode_name(info.mode),
             (unsigned long long)info.bytes,
+            (unsigned long long)info.used_bytes,
+            (unsigned long long)info.keyframes,
+            (unsigned long long)info.repeats,
             (unsigned long long)info.oldest_frame,
             (unsigned long long)info.newest_frame,
             (unsigned long long)info.oldest_cycle,
@@ -1672,7 +2630,8 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
         runtime_ring_frame frame;
         control_response response;
         uint8_t *payload;
-        size_t nbytes;
+        size_t nbytes = 0;
+        char layout[128];
         char meta[CONTROL_RESPONSE_TEXT_MAX];
 
         if (!runtime_client_copy_frame_at(
@@ -1683,28 +2642,134 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
             post_error(disp, req->id, "not-found", "frame-not-retained");
             break;
         }
-        nbytes = (size_t)frame.width * (size_t)frame.height * 4u;
-        payload = (uint8_t *)malloc(nbytes);
+        payload = build_encoded_frame(
+            disp,
+            req->args.frame_format,
+            req->args.frame_encoding,
+            req->args.frame_delta_base,
+            frame.frame_number,
+            frame.pixels,
+            frame.palette,
+            frame.width,
+            (size_t)frame.width * (size_t)frame.height,
+            &nbytes,
+            layout,
+            sizeof(layout));
         if (payload == NULL) {
             post_error(disp, req->id, "memory", "allocation-failed");
             break;
         }
-        memcpy(payload, frame.pixels, nbytes);
         snprintf(
             meta,
             sizeof(meta),
-            "width=%u height=%u stride=%u format=argb8888 frame=%llu cycle=%llu "
+            "width=%u height=%u %s frame=%llu cycle=%llu "
             "target=%llu target_kind=%s",
             frame.width,
             frame.height,
-            frame.stride_bytes,
+            layout,
             (unsigned long long)frame.frame_number,
             (unsigned long long)frame.machine_cycle,
             (unsigned long long)req->args.frame_ring_target,
             req->args.frame_ring_by_cycle ? "cycle" : "frame");
         control_protocol_format_data(
             &response, req->id, "frame", meta, payload, nbytes);
-        if (!control_server_post_response(disp->server, &response)) {
+        if (!dispatch_post(disp, &response)) {
+            free(payload);
+        }
+        break;
+    }
+
+    case CONTROL_COMMAND_GET_FRAME_STRIP: {
+        /* Records back to back: u64 frame, u64 cycle, then the thumbnail in
+           the requested format (as a get-frame payload). */
+        runtime_ring_thumbnail *thumbs;
+        control_response response;
+        uint32_t count = 0;
+        uint32_t width;
+        uint32_t height;
+        size_t pixel_count;
+        size_t image_bytes;
+        size_t record_bytes;
+        uint8_t *payload;
+        uint32_t i;
+        char layout[64];
+        char meta[CONTROL_RESPONSE_TEXT_MAX];
+
+        thumbs = (runtime_ring_thumbnail *)malloc(
+            (size_t)req->args.frame_strip_count * sizeof(*thumbs));
+        if (thumbs == NULL) {
+            post_error(disp, req->id, "memory", "allocation-failed");
+            break;
+        }
+        if (!runtime_client_copy_frame_strip(
+                client,
+                req->args.frame_ring_target,
+                req->args.frame_ring_target_end,
+                req->args.frame_ring_by_cycle,
+                req->args.frame_strip_scale,
+                req->args.frame_strip_count,
+                thumbs,
+                &count)) {
+            free(thumbs);
+            post_error(disp, req->id, "not-found", "frame-not-retained");
+            break;
+        }
+        width = thumbs[0].width;
+        height = thumbs[0].height;
+        pixel_count = (size_t)width * (size_t)height;
+        image_bytes = req->args.frame_format == CONTROL_FRAME_FORMAT_INDEXED8 ?
+            (size_t)DISPLAY_FRAME_PALETTE_SIZE * 4u + pixel_count : pixel_count * 4u;
+        record_bytes = 16u + image_bytes;
+        payload = (uint8_t *)malloc(record_bytes * count);
+        if (payload == NULL) {
+            free(thumbs);
+            post_error(disp, req->id, "memory", "allocation-failed");
+            break;
+        }
+        for (i = 0; i < count; i++) {
+            uint8_t *record = payload + record_bytes * i;
+            size_t image_size = 0;
+            uint8_t *image = build_frame_payload(
+                req->args.frame_format,
+                thumbs[i].pixels,
+                thumbs[i].palette,
+                pixel_count,
+                &image_size);
+            int b;
+            if (image == NULL) {
+                break;
+            }
+            for (b = 0; b < 8; b++) {
+                record[b] = (uint8_t)(thumbs[i].frame_number >> (8 * b));
+                record[8 + b] = (uint8_t)(thumbs[i].machine_cycle >> (8 * b));
+            }
+            memcpy(record + 16, image, image_size);
+            free(image);
+        }
+        free(thumbs);
+        if (i < count) {
+            free(payload);
+            post_error(disp, req->id, "memory", "allocation-failed");
+            break;
+        }
+        format_frame_layout(layout, sizeof(layout), req->args.frame_format, width);
+        snprintf(
+            meta,
+            sizeof(meta),
+            "count=%u width=%u height=%u scale=%u %s record=%u "
+            "first=%llu last=%llu target_kind=%s",
+            count,
+            width,
+            height,
+            req->args.frame_strip_scale,
+            layout,
+            (unsigned)record_bytes,
+            (unsigned long long)req->args.frame_ring_target,
+            (unsigned long long)req->args.frame_ring_target_end,
+            req->args.frame_ring_by_cycle ? "cycle" : "frame");
+        control_protocol_format_data(
+            &response, req->id, "frame-strip", meta, payload, record_bytes * count);
+        if (!dispatch_post(disp, &response)) {
             free(payload);
         }
         break;
@@ -1871,7 +2936,7 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
     }
 
     case CONTROL_COMMAND_WAIT_PAUSED: {
-        if (disp->seen_paused && !disp->machine_running) {
+        if (reply_client(disp)->seen_paused && !disp->machine_running) {
             char text[CONTROL_RESPONSE_TEXT_MAX];
             snprintf(
                 text,
@@ -1881,9 +2946,9 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
                 disp->stop_reason);
             post_ok(disp, req->id, text);
             /* Consume sticky latch so a second wait-paused waits for a new edge
-               (run → pause / BP). First attach still sees startup paused once. */
-            disp->seen_paused = false;
-            disp->latch_paused = false;
+               (run → pause / BP). A new client still sees a paused machine once. */
+            reply_client(disp)->seen_paused = false;
+            reply_client(disp)->latch_paused = false;
             break;
         }
         (void)begin_deferred(
@@ -1912,12 +2977,49 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
         break;
     }
 
+    case CONTROL_COMMAND_GET_TEXT: {
+        /* Decoded from the RAM mirror; behind a queued write, check_text_requests
+           answers once the worker has published it. */
+        if (refresh_text_screen(disp)) {
+            post_text_screen(disp, req->id);
+            break;
+        }
+        (void)begin_deferred(disp, req->id, CONTROL_DEFERRED_GET_TEXT, 2000u, 0u);
+        break;
+    }
+
+    case CONTROL_COMMAND_WAIT_TEXT: {
+        deferred_control_response *d;
+        re_t re;
+        bool have_text;
+
+        /* tiny-regex-c compiles anything; refuse what it would misread
+           rather than wait out the timeout on it. */
+        if (!control_protocol_text_pattern_valid(req->args.text_pattern)) {
+            post_error(disp, req->id, "bad-args", "pattern");
+            break;
+        }
+        re = re_compile(req->args.text_pattern);
+        have_text = refresh_text_screen(disp);
+        if (have_text && post_text_match(disp, req->id, re)) {
+            break;
+        }
+        d = begin_deferred(disp, req->id, CONTROL_DEFERRED_WAIT_TEXT, req->args.timeout_ms, 0u);
+        if (d == NULL) {
+            break;
+        }
+        strcpy(d->text_pattern, req->args.text_pattern);
+        /* Generations start at 1: 0 compares the first publish seen. */
+        d->text_generation = have_text ? disp->text_generation : 0u;
+        break;
+    }
+
     case CONTROL_COMMAND_WAIT_EVENT: {
-        if (latch_matches_event(disp, req->args.event_name)) {
+        if (latch_matches_event(reply_client(disp), req->args.event_name)) {
             char text[CONTROL_RESPONSE_TEXT_MAX];
             snprintf(text, sizeof(text), "event=%s", req->args.event_name);
             post_ok(disp, req->id, text);
-            consume_latch(disp, req->args.event_name);
+            consume_latch(reply_client(disp), req->args.event_name);
             break;
         }
         {
@@ -1957,6 +3059,50 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
         break;
     }
 
+    case CONTROL_COMMAND_REWIND: {
+        uint64_t token = runtime_client_alloc_request_token(client);
+        deferred_control_response *d =
+            begin_deferred(disp, req->id, CONTROL_DEFERRED_REWIND, 5000u, token);
+        if (d == NULL) {
+            break;
+        }
+        if (!runtime_client_rewind(client, req->args.rewind_frames, token)) {
+            post_error(disp, req->id, "busy", "queue");
+            control_deferred_clear(d);
+        }
+        break;
+    }
+
+    case CONTROL_COMMAND_STEP_BACK:
+    case CONTROL_COMMAND_REVERSE_CONTINUE:
+    case CONTROL_COMMAND_RUN_TO_CYCLE: {
+        /* reverse-continue may replay the whole rewind buffer. */
+        uint64_t token = runtime_client_alloc_request_token(client);
+        deferred_control_response *d = begin_deferred(
+            disp,
+            req->id,
+            CONTROL_DEFERRED_SEEK,
+            req->type == CONTROL_COMMAND_REVERSE_CONTINUE ? 30000u : 5000u,
+            token);
+        bool queued;
+        if (d == NULL) {
+            break;
+        }
+        clear_execution_latches(disp);
+        if (req->type == CONTROL_COMMAND_STEP_BACK) {
+            queued = runtime_client_step_back(client, token);
+        } else if (req->type == CONTROL_COMMAND_REVERSE_CONTINUE) {
+            queued = runtime_client_reverse_continue(client, token);
+        } else {
+            queued = runtime_client_run_to_cycle(client, req->args.seek_cycle, token);
+        }
+        if (!queued) {
+            post_error(disp, req->id, "busy", "queue");
+            control_deferred_clear(d);
+        }
+        break;
+    }
+
     case CONTROL_COMMAND_ASSEMBLE: {
         deferred_control_response *d;
         if (req->args.path[0] == '\0') {
@@ -2241,6 +3387,23 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
         break;
     }
 
+    case CONTROL_COMMAND_SUBSCRIBE:
+        handle_subscribe(disp, req);
+        break;
+
+    case CONTROL_COMMAND_UNSUBSCRIBE:
+        if (control_subscription_remove(
+                &reply_client(disp)->subscriptions, req->args.subscription_id)) {
+            post_ok(disp, req->id, "");
+        } else {
+            post_error(disp, req->id, "bad-args", "no such subscription");
+        }
+        break;
+
+    case CONTROL_COMMAND_BATCH:
+        handle_batch(disp, req);
+        break;
+
     default:
         post_error(disp, req->id, "unknown-command", "command");
         break;
@@ -2249,65 +3412,222 @@ static void handle_request(control_dispatch_t *disp, control_request *req)
     control_request_release(req);
 }
 
+/* Run every sub-request between BATCH_BEGIN and BATCH_END so the worker
+   applies them back-to-back. Sub-replies (immediate or deferred) collect in
+   the client's batch; the last one to arrive sends the combined reply. Deferred
+   sub-requests may use the client's whole table share, not just the pipeline
+   limit; a batch that could outgrow it is refused before anything runs, so no
+   sub-request ever gets a late busy. */
+static void handle_batch(control_dispatch_t *disp, control_request *req)
+{
+    control_dispatch_client *c = reply_client(disp);
+    control_request *subs;
+    control_response error;
+    size_t count = 0;
+    size_t deferrable;
+    size_t i;
+    uint32_t saved_limit;
+
+    if (c->batch != NULL) {
+        post_error(disp, req->id, "busy", "batch-in-flight");
+        return;
+    }
+    subs = (control_request *)calloc(CONTROL_BATCH_MAX, sizeof(*subs));
+    if (subs == NULL) {
+        post_error(disp, req->id, "internal", "out of memory");
+        return;
+    }
+    if (!control_batch_parse(req, subs, CONTROL_BATCH_MAX, &count, &error)) {
+        (void)dispatch_post(disp, &error);
+        free(subs);
+        return;
+    }
+    deferrable = control_batch_deferrable_count(subs, count);
+    if (deferrable + control_deferred_client_count(&disp->deferred, disp->reply.client) >
+        CONTROL_DEFERRED_CAPACITY) {
+        for (i = 0; i < count; i++) {
+            control_request_release(&subs[i]);
+        }
+        free(subs);
+        if (deferrable > CONTROL_DEFERRED_CAPACITY) {
+            post_error(disp, req->id, "bad-args", "batch-deferred-limit");
+        } else {
+            post_error(disp, req->id, "busy", "deferred-table-full");
+        }
+        return;
+    }
+    c->batch = control_batch_create(req->id, c->connection, count);
+    if (c->batch == NULL || !runtime_client_batch_begin(disp->client)) {
+        control_batch_destroy(c->batch);
+        c->batch = NULL;
+        for (i = 0; i < count; i++) {
+            control_request_release(&subs[i]);
+        }
+        free(subs);
+        post_error(disp, req->id, "busy", "runtime-queue-full");
+        return;
+    }
+
+    saved_limit = disp->deferred.limit;
+    control_deferred_set_limit(&disp->deferred, CONTROL_DEFERRED_CAPACITY);
+    for (i = 0; i < count; i++) {
+        disp->reply.in_batch = true;
+        disp->reply.batch_index = (uint32_t)i;
+        handle_request(disp, &subs[i]);
+    }
+    disp->reply.in_batch = false;
+    disp->reply.batch_index = 0u;
+    disp->deferred.limit = saved_limit;
+    (void)runtime_client_batch_end(disp->client);
+    free(subs);
+}
+
 void control_dispatch_poll(control_dispatch_t *disp)
 {
     control_request request;
+    uint32_t slot;
 
     if (disp == NULL || disp->server == NULL || disp->client == NULL) {
         return;
     }
 
-    if (!control_server_poll_request(disp->server, &request)) {
-        return;
+    /* Drain: pipelined clients may have several requests queued. */
+    while (control_server_poll_request(disp->server, &request)) {
+        control_dispatch_client *c;
+        control_reply_scope saved;
+
+        if (request.client >= CONTROL_CLIENTS_MAX) {
+            control_request_release(&request);
+            continue;
+        }
+        c = &disp->clients[request.client];
+        if (c->connection != request.connection) {
+            if (control_server_client_epoch(disp->server, request.client) !=
+                request.connection) {
+                control_request_release(&request); /* sender already gone */
+                continue;
+            }
+            /* Connected since the last check_session. */
+            control_dispatch_bind_client(disp, request.client, request.connection);
+        }
+        saved = enter_client_scope(disp, request.client);
+        /* Mutations name the client's session in state-changed. */
+        runtime_client_set_command_session(disp->client, c->session_id);
+        handle_request(disp, &request);
+        leave_reply_scope(disp, saved);
+    }
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        control_reply_scope saved;
+
+        if (disp->clients[slot].connection == 0u) {
+            continue;
+        }
+        saved = enter_client_scope(disp, slot);
+        recheck_memory_subscriptions(disp);
+        leave_reply_scope(disp, saved);
+    }
+    check_text_requests(disp);
+}
+
+void control_dispatch_set_pipeline_limit(control_dispatch_t *disp, uint32_t limit)
+{
+    if (disp != NULL) {
+        control_deferred_set_limit(&disp->deferred, limit);
     }
-    handle_request(disp, &request);
 }
 
 void control_dispatch_check_session(control_dispatch_t *disp)
 {
-    deferred_control_response *d;
+    deferred_control_response *pending[CONTROL_DEFERRED_TABLE_SIZE];
+    size_t count;
+    size_t i;
     uint64_t now;
-    uint64_t epoch;
-    bool has_client;
+    uint32_t slot;
 
     if (disp == NULL) {
         return;
     }
 
-    has_client = control_server_has_client(disp->server);
-    epoch = control_server_connection_epoch(disp->server);
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        uint64_t epoch = control_server_client_epoch(disp->server, slot);
+        control_dispatch_client *c = &disp->clients[slot];
 
-    /* Disconnect / epoch bump: free the control session slot. */
-    if (disp->session_id != 0u &&
-        (!has_client || disp->session_epoch != epoch)) {
-        control_dispatch_release_session(disp);
+        /* Disconnect / new connection in the slot: free what the last
+           client held (its session slot included). */
+        if (c->connection != epoch) {
+            if (epoch != 0u) {
+                control_dispatch_bind_client(disp, slot, epoch);
+            } else {
+                control_dispatch_drop_client(disp, slot);
+            }
+        }
+        /* New TCP client: bind a control session early (before history cmds). */
+        if (epoch != 0u && c->session_id == 0u) {
+            (void)control_dispatch_ensure_session(disp, slot);
+        }
     }
 
-    /* New TCP client: bind a control session early (before history cmds). */
-    if (has_client &&
-        (disp->session_id == 0u || disp->session_epoch != epoch)) {
-        (void)control_dispatch_ensure_session(disp);
-    }
+    count = control_deferred_collect(&disp->deferred, pending, CONTROL_DEFERRED_TABLE_SIZE);
+    now = (uint64_t)SDL_GetTicks();
+    for (i = 0; i < count; i++) {
+        deferred_control_response *d = pending[i];
 
-    d = control_deferred_active(&disp->deferred);
-    if (d == NULL) {
-        return;
+        if (d->connection_epoch != disp->clients[d->client].connection) {
+            if (d->request_token != 0u) {
+                (void)runtime_client_cancel_rpc(disp->client, d->request_token);
+            }
+            control_deferred_clear(d);
+            continue;
+        }
+        if (now >= d->deadline_ms) {
+            control_reply_scope saved = enter_reply_scope(disp, d);
+            post_error(disp, d->request_id, "timeout", "deferred response timed out");
+            leave_reply_scope(disp, saved);
+            if (d->request_token != 0u) {
+                (void)runtime_client_cancel_rpc(disp->client, d->request_token);
+            }
+            control_deferred_clear(d);
+        }
     }
+}
+
+uint32_t control_dispatch_wait_timeout_ms(control_dispatch_t *disp, uint32_t idle_ms)
+{
+    deferred_control_response *pending[CONTROL_DEFERRED_TABLE_SIZE];
+    size_t count;
+    size_t i;
+    uint64_t now;
+    uint32_t timeout = idle_ms;
+    uint32_t slot;
 
-    if (!has_client || d->connection_epoch != epoch) {
-        if (d->request_token != 0u) {
-            (void)runtime_client_cancel_rpc(disp->client, d->request_token);
+    if (disp == NULL) {
+        return idle_ms;
+    }
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        const control_subscription_table *subs = &disp->clients[slot].subscriptions;
+        for (i = 0; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+            if (subs->subs[i].id != 0u && subs->subs[i].recheck &&
+                timeout > CONTROL_SUBSCRIPTION_POLL_MS) {
+                timeout = CONTROL_SUBSCRIPTION_POLL_MS;
+            }
         }
-        control_deferred_clear(d);
-        return;
     }
-
+    count = control_deferred_collect(&disp->deferred, pending, CONTROL_DEFERRED_TABLE_SIZE);
     now = (uint64_t)SDL_GetTicks();
-    if (now >= d->deadline_ms) {
-        post_error(disp, d->request_id, "timeout", "deferred response timed out");
-        if (d->request_token != 0u) {
-            (void)runtime_client_cancel_rpc(disp->client, d->request_token);
+    for (i = 0; i < count; i++) {
+        if (now >= pending[i]->deadline_ms) {
+            return 0u;
+        }
+        /* get-text waits for the mirror to catch up; wait-text compares
+           paused-time publishes for a short while. */
+        if ((pending[i]->kind == CONTROL_DEFERRED_GET_TEXT ||
+             (pending[i]->kind == CONTROL_DEFERRED_WAIT_TEXT && now < disp->text_recheck_ms)) &&
+            timeout > CONTROL_SUBSCRIPTION_POLL_MS) {
+            timeout = CONTROL_SUBSCRIPTION_POLL_MS;
+        }
+        if (pending[i]->deadline_ms - now < (uint64_t)timeout) {
+            timeout = (uint32_t)(pending[i]->deadline_ms - now);
         }
-        control_deferred_clear(d);
     }
+    return timeout;
 }
@@ -1,23 +1,66 @@
 #pragma once
 
+#include "control_batch.h"
 #include "control_deferred.h"
+#include "control_frame_codec.h"
 #include "control_protocol.h"
 #include "control_server.h"
+#include "control_subscription.h"
 #include "runtime_client.h"
 #include "runtime_event.h"
+#include "video.h"
 
 #include <stdbool.h>
 #include <stdint.h>
 
+/* One control client (control_request.client slot). */
+typedef struct control_dispatch_client {
+    /* Connection epoch this state belongs to (0 = slot free). */
+    uint64_t connection;
+    /* Runtime session bound to the client (0 = unbound). */
+    uint32_t session_id;
+    /* Sticky paused edge for wait-paused. */
+    bool seen_paused;
+    /* Sticky event latches (name tokens, cleared on consume / exec control). */
+    bool latch_paused;
+    bool latch_running;
+    bool latch_step_complete;
+    bool latch_run_complete;
+    bool latch_reset_complete;
+    bool latch_breakpoints;
+    bool latch_frame;
+    bool latch_assemble_complete;
+    bool latch_assemble_error;
+    /* Open batch (at most one). */
+    control_batch *batch;
+    /* Frames recently sent, for encoding=delta bases (created on first use). */
+    control_frame_cache *frame_cache;
+    /* Frame-handoff marks (runtime_client_acquire_frame_since) for get-frame
+       and for frame subscriptions, so neither takes frames from the UI or
+       from another client. */
+    uint64_t frame_seen;
+    uint64_t subscription_frame_seen;
+    /* subscribe / unsubscribe. */
+    control_subscription_table subscriptions;
+} control_dispatch_client;
+
+/* Where replies go: the client being served and, while in_batch is set,
+   the slot of that client's batch the reply fills instead of the socket. */
+typedef struct control_reply_scope {
+    uint32_t client;
+    bool in_batch;
+    uint32_t batch_index;
+} control_reply_scope;
+
 typedef struct control_dispatch {
     control_server_t *server;
     runtime_client *client;
+    /* Deferred requests of every client, so runtime responses still
+       complete them in the order they were sent. */
     deferred_control_table deferred;
-    /* Runtime session bound to the current TCP client (0 = unbound). */
-    uint32_t session_id;
-    uint64_t session_epoch;
+    control_dispatch_client clients[CONTROL_CLIENTS_MAX];
+    control_reply_scope reply;
     /* Sticky execution-state for waits / get-state. */
-    bool seen_paused;
     bool machine_running;
     uint64_t frame_number;
     uint64_t cycle;
@@ -30,22 +73,21 @@ typedef struct control_dispatch {
     bool has_cpu;
     uint32_t turbo_mode;
     char stop_reason[32];
-    /* Sticky event latches (name tokens, cleared on consume / exec control). */
-    bool latch_paused;
-    bool latch_running;
-    bool latch_step_complete;
-    bool latch_run_complete;
-    bool latch_reset_complete;
-    bool latch_breakpoints;
-    bool latch_frame;
-    bool latch_assemble_complete;
-    bool latch_assemble_error;
     /* Live peripheral map from MACHINE_STATE (index 0 unused). */
     bool has_slot_map;
     runtime_slot_card_type slot_cards[RUNTIME_APPLE_SLOT_COUNT];
     /* Cached assembler/symbol-file snapshot for find-symbol (single-consumer poll). */
     bool has_symbols;
     runtime_symbol_snapshot symbols;
+    /* Text screen decoded from the RAM mirror publish text_generation, shared
+       by get-text and every wait-text; text_recheck_ms keeps waits comparing
+       new publishes after a paused-time change. */
+    bool has_text;
+    uint64_t text_generation;
+    uint64_t text_frame;
+    uint64_t text_cycle;
+    apple2_video_text text;
+    uint64_t text_recheck_ms;
 } control_dispatch_t;
 
 void control_dispatch_init(
@@ -60,12 +102,21 @@ void control_dispatch_on_runtime_event(
     control_dispatch_t *disp,
     const runtime_event *event);
 
-/* Poll one control request and handle or defer. */
+/* Handle or defer every queued control request. */
 void control_dispatch_poll(control_dispatch_t *disp);
 
-/* Cancel deferred on disconnect / epoch change / timeout. */
+/* Cap on deferred requests each client has in flight at once
+   (1..CONTROL_DEFERRED_CAPACITY). */
+void control_dispatch_set_pipeline_limit(control_dispatch_t *disp, uint32_t limit);
+
+/* Bind a session to each new client; cancel deferred on disconnect /
+   epoch change / timeout. */
 void control_dispatch_check_session(control_dispatch_t *disp);
 
+/* How long the host may block before check_session has work: idle_ms, or
+   less when a deferred response is due to time out sooner. */
+uint32_t control_dispatch_wait_timeout_ms(control_dispatch_t *disp, uint32_t idle_ms);
+
 /* Copy the latest cached symbol snapshot (after assemble / symbol publish). */
 bool control_dispatch_copy_symbols(
     const control_dispatch_t *disp,
@@ -0,0 +1,634 @@
+#include "control_frame_codec.h"
+
+#include "display_frame.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    FRAME_RLE_RUN_MIN = 4,
+    /* Deflate: 32 KiB window, greedy matches found through hash chains. */
+    DEFLATE_WINDOW = 32768,
+    DEFLATE_HASH_BITS = 14,
+    DEFLATE_HASH_SIZE = 1 << DEFLATE_HASH_BITS,
+    DEFLATE_CHAIN_MAX = 8,
+    DEFLATE_MATCH_NICE = 64, /* stop searching once a match is this long */
+    DEFLATE_MATCH_MIN = 3,
+    DEFLATE_MATCH_MAX = 258
+};
+
+/* ---------------------------------------------------------------- rle */
+
+size_t control_frame_rle_bound(size_t size, size_t unit)
+{
+    size_t units = unit != 0u ? size / unit : 0u;
+
+    /* Generous: every token carries at least one unit, and a header costs at
+       most five bytes. */
+    return size + (units + 1u) * 5u;
+}
+
+static size_t frame_rle_put_varint(uint8_t *out, size_t pos, size_t cap, uint32_t v)
+{
+    do {
+        uint8_t b = (uint8_t)(v & 0x7Fu);
+        v >>= 7;
+        if (v != 0u) {
+            b |= 0x80u;
+        }
+        if (pos >= cap) {
+            return 0;
+        }
+        out[pos++] = b;
+    } while (v != 0u);
+    return pos;
+}
+
+/* Unit i (1..4 bytes) as one integer, XOR base when non-NULL. */
+static uint32_t frame_rle_unit(const uint8_t *src, const uint8_t *base, size_t unit, size_t i)
+{
+    uint32_t v = 0;
+    size_t k;
+
+    src += i * unit;
+    if (unit == 1u) {
+        return base != NULL ? (uint32_t)(src[0] ^ base[i]) : src[0];
+    }
+    if (unit == 4u) {
+        uint32_t b = 0;
+        memcpy(&v, src, 4u);
+        if (base != NULL) {
+            memcpy(&b, base + i * 4u, 4u);
+        }
+        return v ^ b;
+    }
+    for (k = 0; k < unit; k++) {
+        v |= (uint32_t)src[k] << (8u * k);
+    }
+    if (base != NULL) {
+        base += i * unit;
+        for (k = 0; k < unit; k++) {
+            v ^= (uint32_t)base[k] << (8u * k);
+        }
+    }
+    return v;
+}
+
+static size_t frame_rle_put_units(
+    const uint8_t *src,
+    const uint8_t *base,
+    size_t unit,
+    size_t start,
+    size_t count,
+    uint8_t *out,
+    size_t pos,
+    size_t cap)
+{
+    size_t bytes = count * unit;
+    size_t k;
+
+    if (pos + bytes > cap) {
+        return 0;
+    }
+    if (base == NULL) {
+        memcpy(out + pos, src + start * unit, bytes);
+    } else {
+        for (k = 0; k < bytes; k++) {
+            out[pos + k] = (uint8_t)(src[start * unit + k] ^ base[start * unit + k]);
+        }
+    }
+    return pos + bytes;
+}
+
+size_t control_frame_rle_encode(
+    const uint8_t *src,
+    const uint8_t *base,
+    size_t size,
+    size_t unit,
+    uint8_t *out,
+    size_t cap)
+{
+    size_t n;
+    size_t pos = 0;
+    size_t literal = 0;
+    size_t i = 0;
+
+    if (src == NULL || out == NULL || unit == 0u || unit > 4u || size % unit != 0u) {
+        return 0;
+    }
+    n = size / unit;
+    while (i < n) {
+        uint32_t v = frame_rle_unit(src, base, unit, i);
+        size_t j = i + 1u;
+
+        while (j < n && frame_rle_unit(src, base, unit, j) == v) {
+            j++;
+        }
+        if (j - i >= FRAME_RLE_RUN_MIN) {
+            if (literal < i) {
+                pos = frame_rle_put_varint(out, pos, cap, (uint32_t)(i - literal - 1u) << 1);
+                pos = pos == 0u ? 0u :
+                    frame_rle_put_units(src, base, unit, literal, i - literal, out, pos, cap);
+                if (pos == 0u) {
+                    return 0;
+                }
+            }
+            pos = frame_rle_put_varint(out, pos, cap, ((uint32_t)(j - i - 1u) << 1) | 1u);
+            pos = pos == 0u ? 0u : frame_rle_put_units(src, base, unit, i, 1u, out, pos, cap);
+            if (pos == 0u) {
+                return 0;
+            }
+            literal = j;
+        }
+        i = j;
+    }
+    if (literal < n) {
+        pos = frame_rle_put_varint(out, pos, cap, (uint32_t)(n - literal - 1u) << 1);
+        pos = pos == 0u ? 0u :
+            frame_rle_put_units(src, base, unit, literal, n - literal, out, pos, cap);
+    }
+    return pos;
+}
+
+bool control_frame_rle_decode(
+    const uint8_t *in,
+    size_t in_size,
+    size_t unit,
+    uint8_t *dst,
+    size_t size,
+    bool xor)
+{
+    size_t pos = 0;
+    size_t o = 0;
+
+    if (in == NULL || dst == NULL || unit == 0u || size % unit != 0u) {
+        return false;
+    }
+    while (pos < in_size) {
+        uint32_t h = 0;
+        unsigned shift = 0;
+        size_t bytes;
+        size_t k;
+
+        for (;;) {
+            uint8_t b;
+            if (pos >= in_size || shift > 28u) {
+                return false;
+            }
+            b = in[pos++];
+            h |= (uint32_t)(b & 0x7Fu) << shift;
+            if ((b & 0x80u) == 0u) {
+                break;
+            }
+            shift += 7u;
+        }
+        bytes = ((size_t)(h >> 1) + 1u) * unit;
+        if (o + bytes > size) {
+            return false;
+        }
+        if ((h & 1u) != 0u) {
+            if (pos + unit > in_size) {
+                return false;
+            }
+            for (k = 0; k < bytes; k++) {
+                uint8_t v = in[pos + k % unit];
+                dst[o + k] = xor ? (uint8_t)(dst[o + k] ^ v) : v;
+            }
+            pos += unit;
+        } else {
+            if (pos + bytes > in_size) {
+                return false;
+            }
+            for (k = 0; k < bytes; k++) {
+                dst[o + k] = xor ? (uint8_t)(dst[o + k] ^ in[pos + k]) : in[pos + k];
+            }
+            pos += bytes;
+        }
+        o += bytes;
+    }
+    return o == size;
+}
+
+/* ---------------------------------------------------------------- png */
+
+typedef struct png_buffer {
+    uint8_t *data;
+    size_t size;
+    size_t cap;
+    bool failed;
+    uint32_t bits;
+    unsigned bit_count;
+} png_buffer;
+
+static void png_reserve(png_buffer *b, size_t extra)
+{
+    uint8_t *grown;
+    size_t cap;
+
+    if (b->failed || b->size + extra <= b->cap) {
+        return;
+    }
+    cap = b->cap != 0u ? b->cap : 4096u;
+    while (cap < b->size + extra) {
+        cap *= 2u;
+    }
+    grown = (uint8_t *)realloc(b->data, cap);
+    if (grown == NULL) {
+        b->failed = true;
+        return;
+    }
+    b->data = grown;
+    b->cap = cap;
+}
+
+static void png_put(png_buffer *b, const void *bytes, size_t n)
+{
+    png_reserve(b, n);
+    if (!b->failed) {
+        memcpy(b->data + b->size, bytes, n);
+        b->size += n;
+    }
+}
+
+static void png_put_u8(png_buffer *b, uint8_t v)
+{
+    png_put(b, &v, 1u);
+}
+
+static void png_put_be32(png_buffer *b, uint32_t v)
+{
+    uint8_t bytes[4];
+
+    bytes[0] = (uint8_t)(v >> 24);
+    bytes[1] = (uint8_t)(v >> 16);
+    bytes[2] = (uint8_t)(v >> 8);
+    bytes[3] = (uint8_t)v;
+    png_put(b, bytes, 4u);
+}
+
+/* Deflate emits bits LSB first; Huffman codes go in reversed. */
+static void png_put_bits(png_buffer *b, uint32_t value, unsigned count)
+{
+    b->bits |= value << b->bit_count;
+    b->bit_count += count;
+    while (b->bit_count >= 8u) {
+        png_put_u8(b, (uint8_t)b->bits);
+        b->bits >>= 8;
+        b->bit_count -= 8u;
+    }
+}
+
+static void png_put_code(png_buffer *b, uint32_t code, unsigned length)
+{
+    uint32_t reversed = 0;
+    unsigned k;
+
+    for (k = 0; k < length; k++) {
+        reversed = (reversed << 1) | ((code >> k) & 1u);
+    }
+    png_put_bits(b, reversed, length);
+}
+
+/* Fixed Huffman literal/length alphabet (RFC 1951 3.2.6). */
+static void png_put_symbol(png_buffer *b, uint32_t symbol)
+{
+    if (symbol < 144u) {
+        png_put_code(b, 0x30u + symbol, 8u);
+    } else if (symbol < 256u) {
+        png_put_code(b, 0x190u + symbol - 144u, 9u);
+    } else if (symbol < 280u) {
+        png_put_code(b, symbol - 256u, 7u);
+    } else {
+        png_put_code(b, 0xC0u + symbol - 280u, 8u);
+    }
+}
+
+static const uint16_t deflate_length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t deflate_length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t deflate_distance_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t deflate_distance_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static void png_put_match(png_buffer *b, uint32_t length, uint32_t distance)
+{
+    unsigned code = 0;
+
+    while (code + 1u < 29u && deflate_length_base[code + 1u] <= length) {
+        code++;
+    }
+    png_put_symbol(b, 257u + code);
+    png_put_bits(b, length - deflate_length_base[code], deflate_length_extra[code]);
+    code = 0;
+    while (code + 1u < 30u && deflate_distance_base[code + 1u] <= distance) {
+        code++;
+    }
+    png_put_code(b, code, 5u);
+    png_put_bits(b, distance - deflate_distance_base[code], deflate_distance_extra[code]);
+}
+
+static uint32_t deflate_hash(const uint8_t *p)
+{
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (v * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+/* zlib stream of one fixed-Huffman block. Image rows are highly repetitive,
+   so greedy LZ77 without dynamic tables already shrinks a frame well. */
+static bool png_deflate(const uint8_t *in, size_t size, png_buffer *b)
+{
+    int32_t *head;
+    int32_t *prev;
+    uint32_t adler_a = 1;
+    uint32_t adler_b = 0;
+    size_t i = 0;
+    size_t k;
+
+    head = (int32_t *)malloc(sizeof(*head) * DEFLATE_HASH_SIZE);
+    prev = (int32_t *)malloc(sizeof(*prev) * DEFLATE_WINDOW);
+    if (head == NULL || prev == NULL) {
+        free(head);
+        free(prev);
+        return false;
+    }
+    for (k = 0; k < (size_t)DEFLATE_HASH_SIZE; k++) {
+        head[k] = -1;
+    }
+
+    png_put_u8(b, 0x78u); /* CM 8, 32 KiB window */
+    png_put_u8(b, 0x01u); /* no dictionary, fastest; header % 31 == 0 */
+    png_put_bits(b, 1u, 1u); /* BFINAL */
+    png_put_bits(b, 1u, 2u); /* BTYPE fixed Huffman */
+    while (i < size) {
+        size_t best_length = 0;
+        size_t best_distance = 0;
+
+        if (i + DEFLATE_MATCH_MIN <= size) {
+            uint32_t h = deflate_hash(in + i);
+            int32_t candidate = head[h];
+            size_t limit = size - i < DEFLATE_MATCH_MAX ? size - i : DEFLATE_MATCH_MAX;
+            int chain = 0;
+
+            while (candidate >= 0 && i - (size_t)candidate <= DEFLATE_WINDOW &&
+                   chain++ < DEFLATE_CHAIN_MAX) {
+                const uint8_t *a = in + candidate;
+                size_t length = 0;
+                while (length < limit && a[length] == in[i + length]) {
+                    length++;
+                }
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = i - (size_t)candidate;
+                    if (length == limit || length >= DEFLATE_MATCH_NICE) {
+                        break;
+                    }
+                }
+                candidate = prev[(size_t)candidate % DEFLATE_WINDOW];
+            }
+            prev[i % DEFLATE_WINDOW] = head[h];
+            head[h] = (int32_t)i;
+        }
+        if (best_length >= DEFLATE_MATCH_MIN) {
+            png_put_match(b, (uint32_t)best_length, (uint32_t)best_distance);
+            for (k = 1; k < best_length; k++) {
+                if (i + k + DEFLATE_MATCH_MIN <= size) {
+                    uint32_t h = deflate_hash(in + i + k);
+                    prev[(i + k) % DEFLATE_WINDOW] = head[h];
+                    head[h] = (int32_t)(i + k);
+                }
+            }
+            i += best_length;
+        } else {
+            png_put_symbol(b, in[i]);
+            i++;
+        }
+    }
+    png_put_symbol(b, 256u);
+    if (b->bit_count > 0u) {
+        png_put_bits(b, 0u, 8u - b->bit_count);
+    }
+    free(head);
+    free(prev);
+
+    for (k = 0; k < size; k++) {
+        adler_a = (adler_a + in[k]) % 65521u;
+        adler_b = (adler_b + adler_a) % 65521u;
+    }
+    png_put_be32(b, (adler_b << 16) | adler_a);
+    return !b->failed;
+}
+
+static uint32_t png_crc32(const uint8_t *data, size_t size)
+{
+    static uint32_t table[256];
+    static bool ready;
+    uint32_t crc = 0xFFFFFFFFu;
+    size_t i;
+
+    if (!ready) {
+        uint32_t n;
+        for (n = 0; n < 256u; n++) {
+            uint32_t c = n;
+            int k;
+            for (k = 0; k < 8; k++) {
+                c = (c & 1u) != 0u ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        ready = true;
+    }
+    for (i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/* Length, type and data are written by the caller starting at start; this
+   appends the CRC over type + data. */
+static void png_end_chunk(png_buffer *b, size_t start)
+{
+    if (!b->failed) {
+        png_put_be32(b, png_crc32(b->data + start + 4u, b->size - start - 4u));
+    }
+}
+
+static void png_begin_chunk(png_buffer *b, const char *type, uint32_t length)
+{
+    png_put_be32(b, length);
+    png_put(b, type, 4u);
+}
+
+bool control_frame_png_encode(
+    const uint8_t *indices,
+    uint32_t width,
+    uint32_t height,
+    const uint32_t *palette,
+    uint32_t palette_count,
+    uint8_t **out,
+    size_t *out_size)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    png_buffer b;
+    png_buffer z;
+    uint8_t *rows;
+    size_t row_bytes;
+    size_t start;
+    uint32_t depth;
+    uint32_t x;
+    uint32_t y;
+
+    if (indices == NULL || palette == NULL || out == NULL || out_size == NULL ||
+        width == 0u || height == 0u || palette_count == 0u || palette_count > 256u) {
+        return false;
+    }
+    depth = palette_count <= 16u ? 4u : 8u;
+    row_bytes = 1u + (depth == 4u ? ((size_t)width + 1u) / 2u : (size_t)width);
+    rows = (uint8_t *)calloc(row_bytes, height);
+    if (rows == NULL) {
+        return false;
+    }
+    for (y = 0; y < height; y++) {
+        uint8_t *row = rows + row_bytes * y; /* row[0] = filter None */
+        const uint8_t *src = indices + (size_t)width * y;
+        for (x = 0; x < width; x++) {
+            if (depth == 8u) {
+                row[1u + x] = src[x];
+            } else {
+                row[1u + x / 2u] |= (uint8_t)((src[x] & 0x0Fu) << ((x & 1u) != 0u ? 0 : 4));
+            }
+        }
+    }
+    memset(&z, 0, sizeof(z));
+    if (!png_deflate(rows, row_bytes * height, &z)) {
+        free(rows);
+        free(z.data);
+        return false;
+    }
+    free(rows);
+
+    memset(&b, 0, sizeof(b));
+    png_put(&b, signature, sizeof(signature));
+    start = b.size;
+    png_begin_chunk(&b, "IHDR", 13u);
+    png_put_be32(&b, width);
+    png_put_be32(&b, height);
+    png_put_u8(&b, (uint8_t)depth);
+    png_put_u8(&b, 3u); /* colour type: palette */
+    png_put_u8(&b, 0u);
+    png_put_u8(&b, 0u);
+    png_put_u8(&b, 0u);
+    png_end_chunk(&b, start);
+    start = b.size;
+    png_begin_chunk(&b, "PLTE", palette_count * 3u);
+    for (x = 0; x < palette_count; x++) {
+        png_put_u8(&b, (uint8_t)(palette[x] >> 16));
+        png_put_u8(&b, (uint8_t)(palette[x] >> 8));
+        png_put_u8(&b, (uint8_t)palette[x]);
+    }
+    png_end_chunk(&b, start);
+    start = b.size;
+    png_begin_chunk(&b, "IDAT", (uint32_t)z.size);
+    png_put(&b, z.data, z.size);
+    png_end_chunk(&b, start);
+    free(z.data);
+    start = b.size;
+    png_begin_chunk(&b, "IEND", 0u);
+    png_end_chunk(&b, start);
+    if (b.failed) {
+        free(b.data);
+        return false;
+    }
+    *out = b.data;
+    *out_size = b.size;
+    return true;
+}
+
+/* -------------------------------------------------------------- cache */
+
+typedef struct control_frame_cache_entry {
+    bool valid;
+    uint64_t frame_number;
+    size_t pixel_count;
+    uint32_t palette[DISPLAY_FRAME_PALETTE_SIZE];
+    uint8_t indices[DISPLAY_FRAME_WIDTH * DISPLAY_FRAME_HEIGHT];
+} control_frame_cache_entry;
+
+struct control_frame_cache {
+    uint32_t next;
+    control_frame_cache_entry entries[CONTROL_FRAME_CACHE_ENTRIES];
+};
+
+control_frame_cache *control_frame_cache_create(void)
+{
+    return (control_frame_cache *)calloc(1, sizeof(control_frame_cache));
+}
+
+void control_frame_cache_destroy(control_frame_cache *cache)
+{
+    free(cache);
+}
+
+void control_frame_cache_store(
+    control_frame_cache *cache,
+    uint64_t frame_number,
+    const uint8_t *indices,
+    const uint32_t *palette,
+    size_t pixel_count)
+{
+    control_frame_cache_entry *entry = NULL;
+    uint32_t i;
+
+    if (cache == NULL || indices == NULL || palette == NULL ||
+        pixel_count > sizeof(entry->indices)) {
+        return;
+    }
+    for (i = 0; i < CONTROL_FRAME_CACHE_ENTRIES; i++) {
+        if (cache->entries[i].valid && cache->entries[i].frame_number == frame_number) {
+            entry = &cache->entries[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        entry = &cache->entries[cache->next];
+        cache->next = (cache->next + 1u) % CONTROL_FRAME_CACHE_ENTRIES;
+    }
+    entry->valid = true;
+    entry->frame_number = frame_number;
+    entry->pixel_count = pixel_count;
+    memcpy(entry->palette, palette, sizeof(entry->palette));
+    memcpy(entry->indices, indices, pixel_count);
+}
+
+bool control_frame_cache_find(
+    const control_frame_cache *cache,
+    uint64_t frame_number,
+    size_t pixel_count,
+    const uint8_t **out_indices,
+    const uint32_t **out_palette)
+{
+    uint32_t i;
+
+    if (cache == NULL || out_indices == NULL || out_palette == NULL) {
+        return false;
+    }
+    for (i = 0; i < CONTROL_FRAME_CACHE_ENTRIES; i++) {
+        const control_frame_cache_entry *entry = &cache->entries[i];
+        if (entry->valid && entry->frame_number == frame_number &&
+            entry->pixel_count == pixel_count) {
+            *out_indices = entry->indices;
+            *out_palette = entry->palette;
+            return true;
+        }
+    }
+    return false;
+}
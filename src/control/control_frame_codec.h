@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Frame payload encodings for get-frame / get-frame-at (encoding=). All of
+   them run on the host thread, after the frame has left the worker.
+
+   rle   — the format payload (ARGB8888 or INDEXED8) as the frame ring's token
+           stream: each token is a LEB128 header h with count = (h >> 1) + 1
+           units; odd h repeats the next unit count times, even h copies count
+           literal units. A unit is one pixel: 4 bytes for ARGB8888, 1 byte
+           for INDEXED8 (whose palette prefix is 64 such units).
+   delta — the same stream over the payload XOR the payload of an earlier
+           frame in the same format, so unchanged pixels become zero runs.
+   png   — a paletted PNG (4-bit when the palette fits, fixed-Huffman
+           deflate). Decodes to the same image in either format. */
+
+/* Worst-case rle output for size bytes of unit-sized pixels. */
+size_t control_frame_rle_bound(size_t size, size_t unit);
+
+/* Encode size bytes of src (XOR base when non-NULL; unit 1..4 bytes, size a
+   multiple of it). Returns bytes written, 0 when cap is too small. */
+size_t control_frame_rle_encode(
+    const uint8_t *src,
+    const uint8_t *base,
+    size_t size,
+    size_t unit,
+    uint8_t *out,
+    size_t cap);
+
+/* Decode into dst (size bytes). With xor the tokens are applied on top of
+   dst (which holds the base frame) instead of replacing it. */
+bool control_frame_rle_decode(
+    const uint8_t *in,
+    size_t in_size,
+    size_t unit,
+    uint8_t *dst,
+    size_t size,
+    bool xor);
+
+/* Paletted PNG of width × height indices. *out is malloc'd; caller frees. */
+bool control_frame_png_encode(
+    const uint8_t *indices,
+    uint32_t width,
+    uint32_t height,
+    const uint32_t *palette,
+    uint32_t palette_count,
+    uint8_t **out,
+    size_t *out_size);
+
+/* Frames recently sent to clients, kept as indices + palette so a later
+   encoding=delta can name one as its base. Oldest entry is replaced first. */
+enum { CONTROL_FRAME_CACHE_ENTRIES = 4 };
+
+typedef struct control_frame_cache control_frame_cache;
+
+control_frame_cache *control_frame_cache_create(void);
+void control_frame_cache_destroy(control_frame_cache *cache);
+
+/* Remember frame_number (replaces an entry with the same number). */
+void control_frame_cache_store(
+    control_frame_cache *cache,
+    uint64_t frame_number,
+    const uint8_t *indices,
+    const uint32_t *palette,
+    size_t pixel_count);
+
+/* Borrow a remembered frame; valid until the next store. */
+bool control_frame_cache_find(
+    const control_frame_cache *cache,
+    uint64_t frame_number,
+    size_t pixel_count,
+    const uint8_t **out_indices,
+    const uint32_t **out_palette);
@@ -1,6 +1,7 @@
 #include "control_protocol.h"
 
 #include "runtime.h"
+#include "runtime_frame_ring.h"
 
 #include <ctype.h>
 #include <stdio.h>
@@ -106,6 +107,26 @@ void control_protocol_format_data(
     response->payload_size = payload_size;
 }
 
+void control_protocol_format_event_data(
+    control_response *response,
+    const char *event_type,
+    const char *metadata,
+    uint8_t *payload,
+    size_t payload_size)
+{
+    control_protocol_format_data(response, 0u, event_type, metadata, payload, payload_size);
+    if (response != NULL) {
+        response->type = CONTROL_RESPONSE_EVENT;
+    }
+}
+
+bool control_response_has_payload(const control_response *response)
+{
+    return response != NULL &&
+        (response->type == CONTROL_RESPONSE_DATA ||
+         (response->type == CONTROL_RESPONSE_EVENT && response->data_type[0] != '\0'));
+}
+
 bool control_protocol_write_response_line(
     char *out,
     size_t out_size,
@@ -131,6 +152,28 @@ bool control_protocol_write_response_line(
         return n > 0 && (size_t)n < out_size;
     }
 
+    if (response->type == CONTROL_RESPONSE_EVENT && response->data_type[0] != '\0') {
+        if (response->metadata[0] != '\0') {
+            n = snprintf(
+                out,
+                out_size,
+                "%u event %s %zu %s\n",
+                response->id,
+                response->data_type,
+                response->payload_size,
+                response->metadata);
+        } else {
+            n = snprintf(
+                out,
+                out_size,
+                "%u event %s %zu\n",
+                response->id,
+                response->data_type,
+                response->payload_size);
+        }
+        return n > 0 && (size_t)n < out_size;
+    }
+
     if (response->type == CONTROL_RESPONSE_EVENT) {
         if (response->text[0] != '\0') {
             n = snprintf(out, out_size, "%u event %s\n", response->id, response->text);
@@ -499,65 +542,119 @@ const char *control_protocol_memory_mode_name(uint8_t mode)
     return memory_mode_name(mode);
 }
 
+const char *control_protocol_frame_format_name(uint8_t format)
+{
+    return format == CONTROL_FRAME_FORMAT_INDEXED8 ? "indexed8" : "argb8888";
+}
+
+static const char *const frame_encoding_names[] = { "raw", "rle", "delta", "png" };
+static const char frame_options_usage[] =
+    "format=argb8888|indexed8 encoding=raw|rle|delta|png base=<frame>";
+
+const char *control_protocol_frame_encoding_name(uint8_t encoding)
+{
+    return encoding <= CONTROL_FRAME_ENCODING_PNG ? frame_encoding_names[encoding] : "raw";
+}
+
+/* Verb table. Binary framing names a command by its control_command_type
+   value; an alias follows the canonical name so reverse lookup finds that. */
+static const struct {
+    const char *name;
+    control_command_type type;
+} command_names[] = {
+    { "hello", CONTROL_COMMAND_HELLO },
+    { "version", CONTROL_COMMAND_VERSION },
+    { "capabilities", CONTROL_COMMAND_CAPABILITIES },
+    { "ping", CONTROL_COMMAND_PING },
+    { "quit-client", CONTROL_COMMAND_QUIT_CLIENT },
+    { "reset", CONTROL_COMMAND_RESET },
+    { "run", CONTROL_COMMAND_RUN },
+    { "pause", CONTROL_COMMAND_PAUSE },
+    { "step-cycle", CONTROL_COMMAND_STEP_CYCLE },
+    { "step-instruction", CONTROL_COMMAND_STEP_INSTRUCTION },
+    { "step-over", CONTROL_COMMAND_STEP_OVER },
+    { "step-out", CONTROL_COMMAND_STEP_OUT },
+    { "get-state", CONTROL_COMMAND_GET_STATE },
+    { "get-cpu", CONTROL_COMMAND_GET_CPU },
+    { "get-softswitches", CONTROL_COMMAND_GET_SOFTSWITCHES },
+    { "get-memory", CONTROL_COMMAND_GET_MEMORY },
+    { "set-memory", CONTROL_COMMAND_SET_MEMORY },
+    { "get-frame", CONTROL_COMMAND_GET_FRAME },
+    { "frame-ring-info", CONTROL_COMMAND_FRAME_RING_INFO },
+    { "frame-ring-record", CONTROL_COMMAND_FRAME_RING_RECORD },
+    { "frame-ring-clear", CONTROL_COMMAND_FRAME_RING_CLEAR },
+    { "get-frame-at", CONTROL_COMMAND_GET_FRAME_AT },
+    { "get-frame-strip", CONTROL_COMMAND_GET_FRAME_STRIP },
+    { "set-reg", CONTROL_COMMAND_SET_REG },
+    { "set-turbo", CONTROL_COMMAND_SET_TURBO },
+    { "break-exec", CONTROL_COMMAND_BREAK_EXEC },
+    { "break-clear", CONTROL_COMMAND_BREAK_CLEAR },
+    { "break-clear-all", CONTROL_COMMAND_BREAK_CLEAR_ALL },
+    { "break-enable", CONTROL_COMMAND_BREAK_ENABLE },
+    { "break-list", CONTROL_COMMAND_BREAK_LIST },
+    { "get-breakpoints", CONTROL_COMMAND_BREAK_LIST },
+    { "break-create", CONTROL_COMMAND_BREAK_CREATE },
+    { "break-update", CONTROL_COMMAND_BREAK_UPDATE },
+    { "rearm-oneshots", CONTROL_COMMAND_REARM_ONESHOTS },
+    { "wait-paused", CONTROL_COMMAND_WAIT_PAUSED },
+    { "wait-running", CONTROL_COMMAND_WAIT_RUNNING },
+    { "wait-frame", CONTROL_COMMAND_WAIT_FRAME },
+    { "wait-event", CONTROL_COMMAND_WAIT_EVENT },
+    { "save-state", CONTROL_COMMAND_SAVE_STATE },
+    { "load-state", CONTROL_COMMAND_LOAD_STATE },
+    { "key", CONTROL_COMMAND_KEY },
+    { "mount-disk", CONTROL_COMMAND_MOUNT_DISK },
+    { "mount", CONTROL_COMMAND_MOUNT },
+    { "unmount", CONTROL_COMMAND_UNMOUNT },
+    { "select-disk", CONTROL_COMMAND_SELECT_DISK },
+    { "set-disk-writable", CONTROL_COMMAND_SET_DISK_WRITABLE },
+    { "history-info", CONTROL_COMMAND_HISTORY_INFO },
+    { "history-record", CONTROL_COMMAND_HISTORY_RECORD },
+    { "history-clear", CONTROL_COMMAND_HISTORY_CLEAR },
+    { "history-find", CONTROL_COMMAND_HISTORY_FIND },
+    { "history-next", CONTROL_COMMAND_HISTORY_NEXT },
+    { "history-read", CONTROL_COMMAND_HISTORY_READ },
+    { "history-close", CONTROL_COMMAND_HISTORY_CLOSE },
+    { "assemble", CONTROL_COMMAND_ASSEMBLE },
+    { "find-symbol", CONTROL_COMMAND_FIND_SYMBOL },
+    { "batch", CONTROL_COMMAND_BATCH },
+    { "get-memory-multi", CONTROL_COMMAND_GET_MEMORY_MULTI },
+    { "set-memory-multi", CONTROL_COMMAND_SET_MEMORY_MULTI },
+    { "subscribe", CONTROL_COMMAND_SUBSCRIBE },
+    { "unsubscribe", CONTROL_COMMAND_UNSUBSCRIBE },
+    { "shm-info", CONTROL_COMMAND_SHM_INFO },
+    { "get-text", CONTROL_COMMAND_GET_TEXT },
+    { "wait-text", CONTROL_COMMAND_WAIT_TEXT },
+    { "rewind", CONTROL_COMMAND_REWIND },
+    { "step-back", CONTROL_COMMAND_STEP_BACK },
+    { "reverse-continue", CONTROL_COMMAND_REVERSE_CONTINUE },
+    { "run-to-cycle", CONTROL_COMMAND_RUN_TO_CYCLE },
+};
+
 static control_command_type lookup_command(const char *name)
 {
-    if (strcmp(name, "hello") == 0) return CONTROL_COMMAND_HELLO;
-    if (strcmp(name, "version") == 0) return CONTROL_COMMAND_VERSION;
-    if (strcmp(name, "capabilities") == 0) return CONTROL_COMMAND_CAPABILITIES;
-    if (strcmp(name, "ping") == 0) return CONTROL_COMMAND_PING;
-    if (strcmp(name, "quit-client") == 0) return CONTROL_COMMAND_QUIT_CLIENT;
-    if (strcmp(name, "reset") == 0) return CONTROL_COMMAND_RESET;
-    if (strcmp(name, "run") == 0) return CONTROL_COMMAND_RUN;
-    if (strcmp(name, "pause") == 0) return CONTROL_COMMAND_PAUSE;
-    if (strcmp(name, "step-cycle") == 0) return CONTROL_COMMAND_STEP_CYCLE;
-    if (strcmp(name, "step-instruction") == 0) return CONTROL_COMMAND_STEP_INSTRUCTION;
-    if (strcmp(name, "step-over") == 0) return CONTROL_COMMAND_STEP_OVER;
-    if (strcmp(name, "step-out") == 0) return CONTROL_COMMAND_STEP_OUT;
-    if (strcmp(name, "get-state") == 0) return CONTROL_COMMAND_GET_STATE;
-    if (strcmp(name, "get-cpu") == 0) return CONTROL_COMMAND_GET_CPU;
-    if (strcmp(name, "get-softswitches") == 0) return CONTROL_COMMAND_GET_SOFTSWITCHES;
-    if (strcmp(name, "get-memory") == 0) return CONTROL_COMMAND_GET_MEMORY;
-    if (strcmp(name, "set-memory") == 0) return CONTROL_COMMAND_SET_MEMORY;
-    if (strcmp(name, "get-frame") == 0) return CONTROL_COMMAND_GET_FRAME;
-    if (strcmp(name, "frame-ring-info") == 0) return CONTROL_COMMAND_FRAME_RING_INFO;
-    if (strcmp(name, "frame-ring-record") == 0) return CONTROL_COMMAND_FRAME_RING_RECORD;
-    if (strcmp(name, "frame-ring-clear") == 0) return CONTROL_COMMAND_FRAME_RING_CLEAR;
-    if (strcmp(name, "get-frame-at") == 0) return CONTROL_COMMAND_GET_FRAME_AT;
-    if (strcmp(name, "set-reg") == 0) return CONTROL_COMMAND_SET_REG;
-    if (strcmp(name, "set-turbo") == 0) return CONTROL_COMMAND_SET_TURBO;
-    if (strcmp(name, "break-exec") == 0) return CONTROL_COMMAND_BREAK_EXEC;
-    if (strcmp(name, "break-clear") == 0) return CONTROL_COMMAND_BREAK_CLEAR;
-    if (strcmp(name, "break-clear-all") == 0) return CONTROL_COMMAND_BREAK_CLEAR_ALL;
-    if (strcmp(name, "break-enable") == 0) return CONTROL_COMMAND_BREAK_ENABLE;
-    if (strcmp(name, "break-list") == 0) return CONTROL_COMMAND_BREAK_LIST;
-    if (strcmp(name, "get-breakpoints") == 0) return CONTROL_COMMAND_BREAK_LIST;
-    if (strcmp(name, "break-create") == 0) return CONTROL_COMMAND_BREAK_CREATE;
-    if (strcmp(name, "break-update") == 0) return CONTROL_COMMAND_BREAK_UPDATE;
-    if (strcmp(name, "rearm-oneshots") == 0) return CONTROL_COMMAND_REARM_ONESHOTS;
-    if (strcmp(name, "wait-paused") == 0) return CONTROL_COMMAND_WAIT_PAUSED;
-    if (strcmp(name, "wait-running") == 0) return CONTROL_COMMAND_WAIT_RUNNING;
-    if (strcmp(name, "wait-frame") == 0) return CONTROL_COMMAND_WAIT_FRAME;
-    if (strcmp(name, "wait-event") == 0) return CONTROL_COMMAND_WAIT_EVENT;
-    if (strcmp(name, "save-state") == 0) return CONTROL_COMMAND_SAVE_STATE;
-    if (strcmp(name, "load-state") == 0) return CONTROL_COMMAND_LOAD_STATE;
-    if (strcmp(name, "key") == 0) return CONTROL_COMMAND_KEY;
-    if (strcmp(name, "mount-disk") == 0) return CONTROL_COMMAND_MOUNT_DISK;
-    if (strcmp(name, "mount") == 0) return CONTROL_COMMAND_MOUNT;
-    if (strcmp(name, "unmount") == 0) return CONTROL_COMMAND_UNMOUNT;
-    if (strcmp(name, "select-disk") == 0) return CONTROL_COMMAND_SELECT_DISK;
-    if (strcmp(name, "set-disk-writable") == 0) return CONTROL_COMMAND_SET_DISK_WRITABLE;
-    if (strcmp(name, "history-info") == 0) return CONTROL_COMMAND_HISTORY_INFO;
-    if (strcmp(name, "history-record") == 0) return CONTROL_COMMAND_HISTORY_RECORD;
-    if (strcmp(name, "history-clear") == 0) return CONTROL_COMMAND_HISTORY_CLEAR;
-    if (strcmp(name, "history-find") == 0) return CONTROL_COMMAND_HISTORY_FIND;
-    if (strcmp(name, "history-next") == 0) return CONTROL_COMMAND_HISTORY_NEXT;
-    if (strcmp(name, "history-read") == 0) return CONTROL_COMMAND_HISTORY_READ;
-    if (strcmp(name, "history-close") == 0) return CONTROL_COMMAND_HISTORY_CLOSE;
-    if (strcmp(name, "assemble") == 0) return CONTROL_COMMAND_ASSEMBLE;
-    if (strcmp(name, "find-symbol") == 0) return CONTROL_COMMAND_FIND_SYMBOL;
+    size_t i;
+
+    for (i = 0; i < sizeof(command_names) / sizeof(command_names[0]); i++) {
+        if (strcmp(name, command_names[i].name) == 0) {
+            return command_names[i].type;
+        }
+    }
     return CONTROL_COMMAND_NONE;
 }
 
+const char *control_protocol_command_name(control_command_type type)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(command_names) / sizeof(command_names[0]); i++) {
+        if (command_names[i].type == type) {
+            return command_names[i].name;
+        }
+    }
+    return NULL;
+}
+
 /* Parse one leading "key=value" assembler option token. Returns:
      1  a recognized option was consumed (cursor advanced past the token),
      0  the token is not a recognized option (cursor unchanged; path begins here),
@@ -630,6 +727,392 @@ static int parse_assemble_option(char **cursor, control_args *args)
     return 1;
 }
 
+/* Parse one leading "format=argb8888|indexed8" token. Same 1 / 0 / -1 contract
+   as parse_assemble_option. */
+static int parse_frame_format_option(char **cursor, control_args *args)
+{
+    char *start;
+    char *end;
+    size_t length;
+
+    if (cursor == NULL || *cursor == NULL || args == NULL) {
+        return 0;
+    }
+    start = (char *)skip_ws(*cursor);
+    end = start;
+    while (*end != '\0' && !isspace((unsigned char)*end)) {
+        end++;
+    }
+    length = (size_t)(end - start);
+    if (length < 7 || strncmp(start, "format=", 7) != 0) {
+        return 0;
+    }
+    if (length == 15 && strncmp(start + 7, "argb8888", 8) == 0) {
+        args->frame_format = CONTROL_FRAME_FORMAT_ARGB8888;
+    } else if (length == 15 && strncmp(start + 7, "indexed8", 8) == 0) {
+        args->frame_format = CONTROL_FRAME_FORMAT_INDEXED8;
+    } else {
+        return -1;
+    }
+    *cursor = end;
+    return 1;
+}
+
+/* Parse one leading "encoding=raw|rle|delta|png" or "base=<frame>" token.
+   Same 1 / 0 / -1 contract as parse_frame_format_option. */
+static int parse_frame_encoding_option(char **cursor, control_args *args, bool *have_base)
+{
+    char *start;
+    char *end;
+    size_t length;
+    size_t i;
+
+    if (cursor == NULL || *cursor == NULL || args == NULL) {
+        return 0;
+    }
+    start = (char *)skip_ws(*cursor);
+    end = start;
+    while (*end != '\0' && !isspace((unsigned char)*end)) {
+        end++;
+    }
+    length = (size_t)(end - start);
+    if (length > 5 && strncmp(start, "base=", 5) == 0) {
+        unsigned long v = 0;
+        char *number_end = NULL;
+        if (!parse_number(start + 5, &number_end, &v) || number_end != end) {
+            return -1;
+        }
+        args->frame_delta_base = (uint64_t)v;
+        *have_base = true;
+        *cursor = end;
+        return 1;
+    }
+    if (length < 9 || strncmp(start, "encoding=", 9) != 0) {
+        return 0;
+    }
+    for (i = 0; i < sizeof(frame_encoding_names) / sizeof(frame_encoding_names[0]); i++) {
+        if (strlen(frame_encoding_names[i]) == length - 9 &&
+            strncmp(start + 9, frame_encoding_names[i], length - 9) == 0) {
+            args->frame_encoding = (uint8_t)i;
+            *cursor = end;
+            return 1;
+        }
+    }
+    return -1;
+}
+
+/* Any frame option for get-frame / get-frame-at; 1 / 0 / -1 as above. */
+static int parse_frame_option(char **cursor, control_args *args, bool *have_base)
+{
+    int opt = parse_frame_format_option(cursor, args);
+    if (opt == 0) {
+        opt = parse_frame_encoding_option(cursor, args, have_base);
+    }
+    return opt;
+}
+
+/* encoding=delta and base=<frame> only make sense together. */
+static bool frame_encoding_args_valid(const control_args *args, bool have_base)
+{
+    return (args->frame_encoding == CONTROL_FRAME_ENCODING_DELTA) == have_base;
+}
+
+static void control_request_init(control_request *out_request)
+{
+    memset(out_request, 0, sizeof(*out_request));
+    out_request->args.timeout_ms = 2000u;
+    out_request->args.slot = 6;
+    out_request->args.drive = 0;
+    out_request->args.memory_mode = CONTROL_MEMORY_MODE_MAP;
+    out_request->args.wait_frame_delta = 1u;
+    out_request->args.rewind_frames = 60u; /* one second */
+    out_request->args.turbo_mode = 1000u; /* 1 MHz default */
+    out_request->args.history_limit = 64u;
+    out_request->args.history_before = 32u;
+    out_request->args.history_after = 8u;
+}
+
+static bool parse_request_args(
+    char *cursor,
+    control_request *out_request,
+    control_response *out_error);
+
+/* Check the parsed spans, total them into args.length and, for a write,
+   payload_size. */
+static bool finish_memory_spans(control_request *out_request, control_response *out_error)
+{
+    uint32_t total = 0;
+    uint32_t k;
+
+    for (k = 0; k < out_request->args.span_count; k++) {
+        const control_memory_span *span = &out_request->args.spans[k];
+        if (span->length == 0u || span->length > 65536u) {
+            if (out_error != NULL) {
+                control_protocol_format_error(
+                    out_error, out_request->id, "bad-args", "span length", false);
+            }
+            return false;
+        }
+        if (span->mode > CONTROL_MEMORY_MODE_ROM) {
+            if (out_error != NULL) {
+                control_protocol_format_error(
+                    out_error, out_request->id, "bad-args", "span mode", false);
+            }
+            return false;
+        }
+        total += span->length;
+    }
+    if (out_request->args.span_count == 0u || total > CONTROL_MEMORY_MULTI_MAX) {
+        if (out_error != NULL) {
+            control_protocol_format_error(
+                out_error,
+                out_request->id,
+                "bad-args",
+                out_request->args.span_count == 0u ? "spans" : "total length",
+                false);
+        }
+        return false;
+    }
+    out_request->args.length = total;
+    if (out_request->type == CONTROL_COMMAND_SET_MEMORY_MULTI) {
+        out_request->payload_size = total;
+    }
+    return true;
+}
+
+/* "<addr>:<length>[:<mode>] ..." */
+static bool parse_memory_spans(
+    char *cursor,
+    control_request *out_request,
+    control_response *out_error)
+{
+    char *end = NULL;
+
+    out_request->args.span_count = 0;
+    cursor = (char *)skip_ws(cursor);
+    while (*cursor != '\0') {
+        control_memory_span *span;
+
+        if (out_request->args.span_count >= CONTROL_MEMORY_SPANS_MAX) {
+            if (out_error != NULL) {
+                control_protocol_format_error(
+                    out_error, out_request->id, "bad-args", "too many spans", false);
+            }
+            return false;
+        }
+        span = &out_request->args.spans[out_request->args.span_count];
+        span->mode = out_request->args.memory_mode;
+        if (!parse_u16_addr(cursor, &end, &span->address) || *end != ':' ||
+            !parse_u32(end + 1, &end, &span->length)) {
+            if (out_error != NULL) {
+                control_protocol_format_error(
+                    out_error, out_request->id, "bad-args", "span addr:length[:mode]", false);
+            }
+            return false;
+        }
+        if (*end == ':') {
+            char mode_tok[16];
+            size_t mi = 0;
+            end++;
+            while (end[mi] != '\0' && !isspace((unsigned char)end[mi]) &&
+                   mi + 1 < sizeof(mode_tok)) {
+                mode_tok[mi] = (char)tolower((unsigned char)end[mi]);
+                mi++;
+            }
+            mode_tok[mi] = '\0';
+            if (!parse_memory_mode(mode_tok, &span->mode)) {
+                if (out_error != NULL) {
+                    control_protocol_format_error(
+                        out_error, out_request->id, "bad-args", "span mode", false);
+                }
+                return false;
+            }
+            end += mi;
+        }
+        if (*end != '\0' && !isspace((unsigned char)*end)) {
+            if (out_error != NULL) {
+                control_protocol_format_error(
+                    out_error, out_request->id, "bad-args", "span addr:length[:mode]", false);
+            }
+            return false;
+        }
+        out_request->args.span_count++;
+        cursor = (char *)skip_ws(end);
+    }
+    return finish_memory_spans(out_request, out_error);
+}
+
+static bool subscribe_error(
+    const control_request *out_request,
+    control_response *out_error,
+    const char *message)
+{
+    if (out_error != NULL) {
+        control_protocol_format_error(out_error, out_request->id, "bad-args", message, false);
+    }
+    return false;
+}
+
+/* "frames [every=N] [format=…] [encoding=raw|rle|delta|png]" or
+   "memory ranges=<addr>:<len>[:<mode>][,…] [mode=<mode>] [on=change|frame]".
+   A frame subscription's delta base is always the frame it sent last. */
+static bool parse_subscribe_args(
+    char *cursor,
+    control_request *out_request,
+    control_response *out_error)
+{
+    control_args *args = &out_request->args;
+    char ranges[CONTROL_LINE_MAX];
+    bool have_base = false;
+    size_t i;
+
+    ranges[0] = '\0';
+    args->subscription_every = 1u;
+    if (strncmp(cursor, "frames", 6) == 0 && (cursor[6] == '\0' || isspace((unsigned char)cursor[6]))) {
+        args->subscription_kind = CONTROL_SUBSCRIPTION_FRAMES;
+    } else if (strncmp(cursor, "memory", 6) == 0 &&
+               (cursor[6] == '\0' || isspace((unsigned char)cursor[6]))) {
+        args->subscription_kind = CONTROL_SUBSCRIPTION_MEMORY;
+    } else {
+        return subscribe_error(out_request, out_error, "frames|memory");
+    }
+    cursor = (char *)skip_ws(cursor + 6);
+    while (cursor[0] != '\0') {
+        char *end = cursor;
+        size_t length;
+
+        if (args->subscription_kind == CONTROL_SUBSCRIPTION_FRAMES) {
+            int opt = parse_frame_option(&cursor, args, &have_base);
+            if (opt < 0 || have_base) {
+                return subscribe_error(out_request, out_error, frame_options_usage);
+            }
+            if (opt > 0) {
+                cursor = (char *)skip_ws(cursor);
+                continue;
+            }
+        }
+        while (*end != '\0' && !isspace((unsigned char)*end)) {
+            end++;
+        }
+        length = (size_t)(end - cursor);
+        if (args->subscription_kind == CONTROL_SUBSCRIPTION_FRAMES && length > 6 &&
+            strncmp(cursor, "every=", 6) == 0) {
+            char *number_end = NULL;
+            if (!parse_u32(cursor + 6, &number_end, &args->subscription_every) ||
+                number_end != end || args->subscription_every == 0u) {
+                return subscribe_error(out_request, out_error, "every=<frames>");
+            }
+        } else if (args->subscription_kind == CONTROL_SUBSCRIPTION_MEMORY && length > 7 &&
+                   strncmp(cursor, "ranges=", 7) == 0 && length - 7 < sizeof(ranges)) {
+            memcpy(ranges, cursor + 7, length - 7);
+            ranges[length - 7] = '\0';
+        } else if (args->subscription_kind == CONTROL_SUBSCRIPTION_MEMORY && length > 5 &&
+                   strncmp(cursor, "mode=", 5) == 0) {
+            char mode_tok[16];
+            if (length - 5 >= sizeof(mode_tok)) {
+                return subscribe_error(out_request, out_error, "mode");
+            }
+            for (i = 0; i < length - 5; i++) {
+                mode_tok[i] = (char)tolower((unsigned char)cursor[5 + i]);
+            }
+            mode_tok[i] = '\0';
+            if (!parse_memory_mode(mode_tok, &args->memory_mode)) {
+                return subscribe_error(out_request, out_error, "mode");
+            }
+        } else if (args->subscription_kind == CONTROL_SUBSCRIPTION_MEMORY &&
+                   ((length == 9 && strncmp(cursor, "on=change", 9) == 0) ||
+                    (length == 8 && strncmp(cursor, "on=frame", 8) == 0))) {
+            args->subscription_on_frame = length == 8;
+        } else {
+            return subscribe_error(
+                out_request,
+                out_error,
+                args->subscription_kind == CONTROL_SUBSCRIPTION_FRAMES
+                    ? "every=<frames> format=argb8888|indexed8 encoding=raw|rle|delta|png"
+                    : "ranges=<addr>:<len>[:<mode>][,...] mode=<mode> on=change|frame");
+        }
+        cursor = (char *)skip_ws(end);
+    }
+    if (args->subscription_kind == CONTROL_SUBSCRIPTION_FRAMES) {
+        return true;
+    }
+    if (ranges[0] == '\0') {
+        return subscribe_error(out_request, out_error, "ranges=<addr>:<len>[:<mode>][,...]");
+    }
+    for (i = 0; ranges[i] != '\0'; i++) {
+        if (ranges[i] == ',') {
+            ranges[i] = ' ';
+        }
+    }
+    return parse_memory_spans(ranges, out_request, out_error);
+}
+
+/* Limits of external/tiny-regex-c/re.c (RE_MAX_OBJECTS, RE_MAX_CLASS_LEN):
+   atoms after the last one fit, and class bytes (escapes take two, each
+   class a terminator) shared by every class. */
+enum {
+    TEXT_PATTERN_ATOMS_MAX = 63,
+    TEXT_PATTERN_CLASS_BYTES_MAX = 62
+};
+
+bool control_protocol_text_pattern_valid(const char *pattern)
+{
+    size_t atoms = 0;
+    size_t class_bytes = 0;
+    bool after_atom = false;
+    size_t i = 0;
+
+    if (pattern == NULL) {
+        return false;
+    }
+    while (pattern[i] != '\0') {
+        char c = pattern[i];
+
+        if (c == '*' || c == '+' || c == '?') {
+            /* A modifier needs an atom to modify. */
+            if (!after_atom) {
+                return false;
+            }
+            after_atom = false;
+            i++;
+        } else if (c == '\\') {
+            if (pattern[i + 1] == '\0') {
+                return false;
+            }
+            after_atom = true;
+            i += 2;
+        } else if (c == '[') {
+            i++;
+            if (pattern[i] == '^') {
+                i++;
+            }
+            while (pattern[i] != '\0' && pattern[i] != ']') {
+                if (pattern[i] == '\\' && pattern[i + 1] != '\0') {
+                    class_bytes++;
+                    i++;
+                }
+                class_bytes++;
+                i++;
+            }
+            class_bytes++;
+            if (pattern[i] != ']' || class_bytes > TEXT_PATTERN_CLASS_BYTES_MAX) {
+                return false;
+            }
+            after_atom = true;
+            i++;
+        } else {
+            /* ^ anchors; $ and . are atoms the engine lets a modifier follow. */
+            after_atom = c != '^';
+            i++;
+        }
+        atoms++;
+        if (atoms > TEXT_PATTERN_ATOMS_MAX) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool control_protocol_parse_request(
     const char *line,
     control_request *out_request,
@@ -646,16 +1129,7 @@ bool control_protocol_parse_request(
         return false;
     }
 
-    memset(out_request, 0, sizeof(*out_request));
-    out_request->args.timeout_ms = 2000u;
-    out_request->args.slot = 6;
-    out_request->args.drive = 0;
-    out_request->args.memory_mode = CONTROL_MEMORY_MODE_MAP;
-    out_request->args.wait_frame_delta = 1u;
-    out_request->args.turbo_mode = 1000u; /* 1 MHz default */
-    out_request->args.history_limit = 64u;
-    out_request->args.history_before = 32u;
-    out_request->args.history_after = 8u;
+    control_request_init(out_request);
 
     strncpy(buf, line, sizeof(buf) - 1);
     for (i = 0; buf[i] != '\0'; i++) {
@@ -703,8 +1177,35 @@ bool control_protocol_parse_request(
         }
         return false;
     }
+    return parse_request_args(cursor, out_request, out_error);
+}
+
+/* Arguments after the verb; out_request->id and type are already set. */
+static bool parse_request_args(
+    char *cursor,
+    control_request *out_request,
+    control_response *out_error)
+{
+    char *end = NULL;
+    uint32_t id = out_request->id;
+    size_t i;
 
     switch (out_request->type) {
+    case CONTROL_COMMAND_HELLO: {
+        if (cursor[0] == '\0') {
+            break;
+        }
+        if (strcmp(cursor, "binary=1") == 0 || strcmp(cursor, "binary=0") == 0) {
+            out_request->args.framing_set = true;
+            out_request->args.framing_binary = cursor[7] == '1';
+            break;
+        }
+        if (out_error != NULL) {
+            control_protocol_format_error(out_error, id, "bad-args", "binary=0|1", false);
+        }
+        return false;
+    }
+
     case CONTROL_COMMAND_GET_MEMORY:
     case CONTROL_COMMAND_SET_MEMORY: {
         if (!parse_u16_addr(cursor, &end, &out_request->args.address)) {
@@ -1093,41 +1594,149 @@ bool control_protocol_parse_request(
         break;
     }
 
-    case CONTROL_COMMAND_GET_FRAME_AT: {
-        /* Require frame=<n> or cycle=<n> (named, never bare number). */
-        char key[16];
-        size_t ki = 0;
-        char *eq;
-        unsigned long v = 0;
-        if (cursor[0] == '\0') {
+    case CONTROL_COMMAND_GET_FRAME: {
+        bool have_base = false;
+        while (cursor[0] != '\0') {
+            if (parse_frame_option(&cursor, &out_request->args, &have_base) != 1) {
+                if (out_error != NULL) {
+                    control_protocol_format_error(
+                        out_error, id, "bad-args", frame_options_usage, false);
+                }
+                return false;
+            }
+            cursor = (char *)skip_ws(cursor);
+        }
+        if (!frame_encoding_args_valid(&out_request->args, have_base)) {
             if (out_error != NULL) {
                 control_protocol_format_error(
-                    out_error, id, "bad-args", "frame=<n>|cycle=<n>", false);
+                    out_error, id, "bad-args", "encoding=delta needs base=<frame>", false);
             }
             return false;
         }
-        while (cursor[ki] != '\0' && cursor[ki] != '=' && ki + 1 < sizeof(key)) {
-            key[ki] = cursor[ki];
-            ki++;
+        break;
+    }
+
+    case CONTROL_COMMAND_GET_FRAME_AT: {
+        /* Require frame=<n> or cycle=<n> (named, never bare number); optional
+           format= / encoding= / base= in any position. */
+        bool have_target = false;
+        bool have_base = false;
+        while (cursor[0] != '\0') {
+            char key[16];
+            size_t ki = 0;
+            unsigned long v = 0;
+            int opt = parse_frame_option(&cursor, &out_request->args, &have_base);
+
+            if (opt < 0) {
+                if (out_error != NULL) {
+                    control_protocol_format_error(
+                        out_error, id, "bad-args", frame_options_usage, false);
+                }
+                return false;
+            }
+            if (opt == 0) {
+                while (cursor[ki] != '\0' && cursor[ki] != '=' &&
+                       !isspace((unsigned char)cursor[ki]) && ki + 1 < sizeof(key)) {
+                    key[ki] = cursor[ki];
+                    ki++;
+                }
+                key[ki] = '\0';
+                if (have_target || cursor[ki] != '=' ||
+                    (strcmp(key, "frame") != 0 && strcmp(key, "cycle") != 0) ||
+                    !parse_number(cursor + ki + 1, &end, &v) ||
+                    (*end != '\0' && !isspace((unsigned char)*end))) {
+                    if (out_error != NULL) {
+                        control_protocol_format_error(
+                            out_error, id, "bad-args", "frame=<n>|cycle=<n>", false);
+                    }
+                    return false;
+                }
+                out_request->args.frame_ring_target = (uint64_t)v;
+                out_request->args.frame_ring_by_cycle = strcmp(key, "cycle") == 0;
+                have_target = true;
+                cursor = end;
+            }
+            cursor = (char *)skip_ws(cursor);
         }
-        key[ki] = '\0';
-        eq = strchr(cursor, '=');
-        if (eq == NULL || !parse_number(eq + 1, &end, &v)) {
+        if (!have_target) {
             if (out_error != NULL) {
                 control_protocol_format_error(
                     out_error, id, "bad-args", "frame=<n>|cycle=<n>", false);
             }
             return false;
         }
-        out_request->args.frame_ring_target = (uint64_t)v;
-        if (strcmp(key, "frame") == 0) {
-            out_request->args.frame_ring_by_cycle = false;
-        } else if (strcmp(key, "cycle") == 0) {
-            out_request->args.frame_ring_by_cycle = true;
-        } else {
+        if (!frame_encoding_args_valid(&out_request->args, have_base)) {
             if (out_error != NULL) {
                 control_protocol_format_error(
-                    out_error, id, "bad-args", "frame=<n>|cycle=<n>", false);
+                    out_error, id, "bad-args", "encoding=delta needs base=<frame>", false);
+            }
+            return false;
+        }
+        break;
+    }
+
+    case CONTROL_COMMAND_GET_FRAME_STRIP: {
+        /* frame=<first>|cycle=<first> to=<last> count=<n> [scale=4|16]
+           [format=F], any order. */
+        static const char usage[] =
+            "frame=<n>|cycle=<n> to=<n> count=1..64 [scale=4|16]";
+        bool have_target = false;
+        bool have_end = false;
+        out_request->args.frame_strip_count = 0;
+        out_request->args.frame_strip_scale = RUNTIME_FRAME_RING_THUMB_SCALE_SMALL;
+        while (cursor[0] != '\0') {
+            char key[16];
+            size_t ki = 0;
+            unsigned long v = 0;
+            int opt = parse_frame_format_option(&cursor, &out_request->args);
+            bool ok;
+
+            if (opt < 0) {
+                if (out_error != NULL) {
+                    control_protocol_format_error(
+                        out_error, id, "bad-args", "format=argb8888|indexed8", false);
+                }
+                return false;
+            }
+            if (opt > 0) {
+                cursor = (char *)skip_ws(cursor);
+                continue;
+            }
+            while (cursor[ki] != '\0' && cursor[ki] != '=' &&
+                   !isspace((unsigned char)cursor[ki]) && ki + 1 < sizeof(key)) {
+                key[ki] = cursor[ki];
+                ki++;
+            }
+            key[ki] = '\0';
+            ok = cursor[ki] == '=' && parse_number(cursor + ki + 1, &end, &v) &&
+                 (*end == '\0' || isspace((unsigned char)*end));
+            if (ok && (strcmp(key, "frame") == 0 || strcmp(key, "cycle") == 0) &&
+                !have_target) {
+                out_request->args.frame_ring_target = (uint64_t)v;
+                out_request->args.frame_ring_by_cycle = strcmp(key, "cycle") == 0;
+                have_target = true;
+            } else if (ok && strcmp(key, "to") == 0) {
+                out_request->args.frame_ring_target_end = (uint64_t)v;
+                have_end = true;
+            } else if (ok && strcmp(key, "count") == 0 && v >= 1u &&
+                       v <= (unsigned long)RUNTIME_FRAME_RING_STRIP_MAX) {
+                out_request->args.frame_strip_count = (uint32_t)v;
+            } else if (ok && strcmp(key, "scale") == 0 &&
+                       (v == (unsigned long)RUNTIME_FRAME_RING_THUMB_SCALE_SMALL ||
+                        v == (unsigned long)RUNTIME_FRAME_RING_THUMB_SCALE_TINY)) {
+                out_request->args.frame_strip_scale = (uint32_t)v;
+            } else {
+                if (out_error != NULL) {
+                    control_protocol_format_error(out_error, id, "bad-args", usage, false);
+                }
+                return false;
+            }
+            cursor = (char *)skip_ws(end);
+        }
+        if (!have_target || !have_end || out_request->args.frame_strip_count == 0u ||
+            out_request->args.frame_ring_target_end < out_request->args.frame_ring_target) {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", usage, false);
             }
             return false;
         }
@@ -1227,6 +1836,103 @@ bool control_protocol_parse_request(
         break;
     }
 
+    case CONTROL_COMMAND_GET_MEMORY_MULTI:
+    case CONTROL_COMMAND_SET_MEMORY_MULTI:
+        if (!parse_memory_spans(cursor, out_request, out_error)) {
+            return false;
+        }
+        break;
+
+    case CONTROL_COMMAND_SUBSCRIBE:
+        if (!parse_subscribe_args(cursor, out_request, out_error)) {
+            return false;
+        }
+        break;
+
+    case CONTROL_COMMAND_UNSUBSCRIBE:
+        if (strcmp(cursor, "all") == 0) {
+            out_request->args.subscription_id = 0u;
+        } else if (!parse_u32(cursor, &end, &out_request->args.subscription_id) ||
+                   out_request->args.subscription_id == 0u || *skip_ws(end) != '\0') {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", "<id>|all", false);
+            }
+            return false;
+        }
+        break;
+
+    case CONTROL_COMMAND_WAIT_TEXT:
+        /* [timeout=<ms>] pattern=<regex>; the pattern runs to the end of the
+           line, spaces included. */
+        if (strncmp(cursor, "timeout=", 8) == 0) {
+            uint32_t t = 0;
+            if (!parse_u32(cursor + 8, &end, &t) || t < 1u || t > 600000u) {
+                if (out_error != NULL) {
+                    control_protocol_format_error(out_error, id, "bad-args", "timeout", false);
+                }
+                return false;
+            }
+            out_request->args.timeout_ms = t;
+            cursor = (char *)skip_ws(end);
+        }
+        if (strncmp(cursor, "pattern=", 8) != 0 || cursor[8] == '\0' ||
+            strlen(cursor + 8) >= sizeof(out_request->args.text_pattern)) {
+            if (out_error != NULL) {
+                control_protocol_format_error(
+                    out_error, id, "bad-args", "[timeout=<ms>] pattern=<regex>", false);
+            }
+            return false;
+        }
+        strcpy(out_request->args.text_pattern, cursor + 8);
+        break;
+
+    case CONTROL_COMMAND_REWIND:
+        if (cursor[0] != '\0' &&
+            (strncmp(cursor, "frames=", 7) != 0 ||
+             !parse_u32(cursor + 7, &end, &out_request->args.rewind_frames) ||
+             out_request->args.rewind_frames == 0u || *skip_ws(end) != '\0')) {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", "frames=<n>", false);
+            }
+            return false;
+        }
+        break;
+
+    case CONTROL_COMMAND_RUN_TO_CYCLE: {
+        unsigned long v = 0;
+        if (strncmp(cursor, "cycle=", 6) != 0 || !parse_number(cursor + 6, &end, &v) ||
+            *skip_ws(end) != '\0') {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", "cycle=<n>", false);
+            }
+            return false;
+        }
+        out_request->args.seek_cycle = (uint64_t)v;
+        break;
+    }
+
+    case CONTROL_COMMAND_BATCH: {
+        uint32_t count = 0;
+        uint32_t bytes = 0;
+        if (!parse_u32(cursor, &end, &count) || count == 0u || count > CONTROL_BATCH_MAX) {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", "count", false);
+            }
+            return false;
+        }
+        cursor = (char *)skip_ws(end);
+        if (!parse_u32(cursor, &end, &bytes) || bytes == 0u ||
+            bytes > CONTROL_BATCH_PAYLOAD_MAX) {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", "bytes", false);
+            }
+            return false;
+        }
+        out_request->args.batch_count = count;
+        out_request->payload_size = bytes;
+        break;
+    }
+
     case CONTROL_COMMAND_KEY: {
         uint32_t k = 0;
         if (!parse_u32(cursor, &end, &k)) {
@@ -1411,3 +2117,244 @@ bool control_protocol_parse_request(
 
     return true;
 }
+
+static uint16_t binary_read_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t binary_read_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+        ((uint32_t)p[3] << 24);
+}
+
+static void binary_write_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void binary_write_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+void control_protocol_decode_binary_header(
+    const uint8_t bytes[CONTROL_BINARY_REQUEST_HEADER_SIZE],
+    control_binary_header *out)
+{
+    if (bytes == NULL || out == NULL) {
+        return;
+    }
+    out->id = binary_read_u32(bytes);
+    out->opcode = binary_read_u16(bytes + 4);
+    out->flags = binary_read_u16(bytes + 6);
+    out->args_size = binary_read_u32(bytes + 8);
+    out->payload_size = binary_read_u32(bytes + 12);
+}
+
+/* Fixed-layout args for the hot polling verbs: no text to scan. */
+static bool parse_binary_fixed_args(
+    const control_binary_header *header,
+    const uint8_t *args,
+    control_request *out_request,
+    control_response *out_error)
+{
+    uint32_t id = header->id;
+
+    if (out_request->type == CONTROL_COMMAND_GET_MEMORY_MULTI ||
+        out_request->type == CONTROL_COMMAND_SET_MEMORY_MULTI) {
+        uint32_t k;
+
+        if (header->args_size == 0u ||
+            header->args_size % CONTROL_BINARY_MEMORY_ARGS_SIZE != 0u ||
+            header->args_size > CONTROL_BINARY_ARGS_MAX) {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", "span args", false);
+            }
+            return false;
+        }
+        out_request->args.span_count = header->args_size / CONTROL_BINARY_MEMORY_ARGS_SIZE;
+        for (k = 0; k < out_request->args.span_count; k++) {
+            const uint8_t *record = args + k * CONTROL_BINARY_MEMORY_ARGS_SIZE;
+            out_request->args.spans[k].address = binary_read_u16(record);
+            out_request->args.spans[k].mode = record[2];
+            out_request->args.spans[k].length = binary_read_u32(record + 4);
+        }
+        return finish_memory_spans(out_request, out_error);
+    }
+
+    if (out_request->type == CONTROL_COMMAND_GET_FRAME) {
+        if (header->args_size == 1u || header->args_size == 2u || header->args_size == 10u) {
+            bool have_base = header->args_size == 10u;
+            if (args[0] > CONTROL_FRAME_FORMAT_INDEXED8 ||
+                (header->args_size > 1u && args[1] > CONTROL_FRAME_ENCODING_PNG)) {
+                if (out_error != NULL) {
+                    control_protocol_format_error(out_error, id, "bad-args", "format", false);
+                }
+                return false;
+            }
+            out_request->args.frame_format = args[0];
+            if (header->args_size > 1u) {
+                out_request->args.frame_encoding = args[1];
+            }
+            if (have_base) {
+                out_request->args.frame_delta_base = (uint64_t)binary_read_u32(args + 2) |
+                    ((uint64_t)binary_read_u32(args + 6) << 32);
+            }
+            if (!frame_encoding_args_valid(&out_request->args, have_base)) {
+                if (out_error != NULL) {
+                    control_protocol_format_error(out_error, id, "bad-args", "base", false);
+                }
+                return false;
+            }
+        } else if (header->args_size != 0u) {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, id, "bad-args", "frame args", false);
+            }
+            return false;
+        }
+        return true;
+    }
+
+    if (header->args_size != CONTROL_BINARY_MEMORY_ARGS_SIZE) {
+        if (out_error != NULL) {
+            control_protocol_format_error(out_error, id, "bad-args", "memory args", false);
+        }
+        return false;
+    }
+    out_request->args.address = binary_read_u16(args);
+    out_request->args.memory_mode = args[2];
+    out_request->args.length = binary_read_u32(args + 4);
+    if (out_request->args.memory_mode > CONTROL_MEMORY_MODE_ROM) {
+        if (out_error != NULL) {
+            control_protocol_format_error(out_error, id, "bad-args", "mode", false);
+        }
+        return false;
+    }
+    if (out_request->args.length == 0u || out_request->args.length > 65536u ||
+        (out_request->type == CONTROL_COMMAND_SET_MEMORY && out_request->args.length > 1024u)) {
+        if (out_error != NULL) {
+            control_protocol_format_error(out_error, id, "bad-args", "length", false);
+        }
+        return false;
+    }
+    if (out_request->type == CONTROL_COMMAND_SET_MEMORY) {
+        out_request->payload_size = out_request->args.length;
+    }
+    return true;
+}
+
+bool control_protocol_parse_binary_request(
+    const control_binary_header *header,
+    const uint8_t *args,
+    control_request *out_request,
+    control_response *out_error)
+{
+    bool fixed;
+    bool ok;
+
+    if (header == NULL || out_request == NULL || (header->args_size > 0u && args == NULL)) {
+        return false;
+    }
+    control_request_init(out_request);
+    out_request->id = header->id;
+    out_request->type = (control_command_type)header->opcode;
+    if (control_protocol_command_name(out_request->type) == NULL) {
+        if (out_error != NULL) {
+            char text[32];
+            snprintf(text, sizeof(text), "opcode %u", (unsigned)header->opcode);
+            control_protocol_format_error(out_error, header->id, "unknown-command", text, false);
+        }
+        return false;
+    }
+
+    fixed = (header->flags & CONTROL_BINARY_FLAG_TEXT_ARGS) == 0u &&
+        (out_request->type == CONTROL_COMMAND_GET_MEMORY ||
+         out_request->type == CONTROL_COMMAND_SET_MEMORY ||
+         out_request->type == CONTROL_COMMAND_GET_MEMORY_MULTI ||
+         out_request->type == CONTROL_COMMAND_SET_MEMORY_MULTI ||
+         out_request->type == CONTROL_COMMAND_GET_FRAME);
+    if (fixed) {
+        ok = parse_binary_fixed_args(header, args, out_request, out_error);
+    } else {
+        char buf[CONTROL_LINE_MAX];
+        size_t i;
+
+        if (header->args_size >= sizeof(buf)) {
+            if (out_error != NULL) {
+                control_protocol_format_error(out_error, header->id, "bad-args", "too long", false);
+            }
+            return false;
+        }
+        for (i = 0; i < header->args_size; i++) {
+            if (args[i] == '\0' || args[i] == '\n' || args[i] == '\r') {
+                if (out_error != NULL) {
+                    control_protocol_format_error(
+                        out_error, header->id, "bad-args", "control byte in args", false);
+                }
+                return false;
+            }
+        }
+        if (header->args_size > 0u) {
+            memcpy(buf, args, header->args_size);
+        }
+        buf[header->args_size] = '\0';
+        ok = parse_request_args((char *)skip_ws(buf), out_request, out_error);
+    }
+    if (!ok) {
+        return false;
+    }
+    if (out_request->payload_size != header->payload_size) {
+        if (out_error != NULL) {
+            control_protocol_format_error(out_error, header->id, "bad-payload", "size", false);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool control_protocol_write_binary_response(
+    uint8_t *out,
+    size_t out_size,
+    const control_response *response,
+    size_t *out_used)
+{
+    char *text;
+    size_t text_cap;
+    int n;
+
+    if (out == NULL || response == NULL || out_used == NULL ||
+        out_size <= CONTROL_BINARY_REPLY_HEADER_SIZE) {
+        return false;
+    }
+    text = (char *)out + CONTROL_BINARY_REPLY_HEADER_SIZE;
+    text_cap = out_size - CONTROL_BINARY_REPLY_HEADER_SIZE;
+    if (control_response_has_payload(response)) {
+        n = response->metadata[0] != '\0'
+            ? snprintf(text, text_cap, "%s %s", response->data_type, response->metadata)
+            : snprintf(text, text_cap, "%s", response->data_type);
+    } else if (response->type == CONTROL_RESPONSE_OK ||
+               response->type == CONTROL_RESPONSE_ERROR ||
+               response->type == CONTROL_RESPONSE_EVENT) {
+        n = snprintf(text, text_cap, "%s", response->text);
+    } else {
+        return false;
+    }
+    if (n < 0 || (size_t)n >= text_cap || n > 0xFFFF) {
+        return false;
+    }
+    binary_write_u32(out, response->id);
+    out[4] = (uint8_t)response->type;
+    out[5] = response->close_client ? CONTROL_BINARY_FLAG_CLOSE : 0u;
+    binary_write_u16(out + 6, (uint16_t)n);
+    binary_write_u32(
+        out + 8,
+        control_response_has_payload(response) ? (uint32_t)response->payload_size : 0u);
+    *out_used = CONTROL_BINARY_REPLY_HEADER_SIZE + (size_t)n;
+    return true;
+}
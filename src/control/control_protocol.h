@@ -7,13 +7,28 @@
 enum {
     CONTROL_LINE_MAX = 512,
     CONTROL_RESPONSE_TEXT_MAX = 512,
-    CONTROL_PROTOCOL_NAME_MAX = 32
+    CONTROL_PROTOCOL_NAME_MAX = 32,
+    /* batch: sub-commands per request and framed payload bytes. */
+    CONTROL_BATCH_MAX = 64,
+    CONTROL_BATCH_PAYLOAD_MAX = 65536,
+    /* get-memory-multi / set-memory-multi: spans per request and total
+       bytes (every memory view in full). */
+    CONTROL_MEMORY_SPANS_MAX = 64,
+    CONTROL_MEMORY_MULTI_MAX = 6 * 65536,
+    /* Largest request payload on either framing. */
+    CONTROL_PAYLOAD_MAX = CONTROL_MEMORY_MULTI_MAX,
+    /* Clients served at once, each bound to its own runtime session (the
+       runtime holds four and the UI keeps one). */
+    CONTROL_CLIENTS_MAX = 3,
+    /* wait-text regex, NUL included (tiny-regex-c keeps 64 tokens). */
+    CONTROL_TEXT_PATTERN_MAX = 128
 };
 
 /* Product wire identity. Bump when scripts must learn new behaviour. */
-#define CONTROL_PROTOCOL_VERSION "A2M/11"
+#define CONTROL_PROTOCOL_VERSION "A2M/23"
 #define CONTROL_PROTOCOL_APP_NAME "a2m"
 
+/* Values are binary-framing opcodes: append only, never renumber. */
 typedef enum control_command_type {
     CONTROL_COMMAND_NONE = 0,
     CONTROL_COMMAND_HELLO,
@@ -38,6 +53,7 @@ typedef enum control_command_type {
     CONTROL_COMMAND_FRAME_RING_RECORD,
     CONTROL_COMMAND_FRAME_RING_CLEAR,
     CONTROL_COMMAND_GET_FRAME_AT,
+    CONTROL_COMMAND_GET_FRAME_STRIP,
     CONTROL_COMMAND_SET_REG,
     CONTROL_COMMAND_SET_TURBO,
     CONTROL_COMMAND_BREAK_EXEC,
@@ -68,7 +84,19 @@ typedef enum control_command_type {
     CONTROL_COMMAND_HISTORY_READ,
     CONTROL_COMMAND_HISTORY_CLOSE,
     CONTROL_COMMAND_ASSEMBLE,
-    CONTROL_COMMAND_FIND_SYMBOL
+    CONTROL_COMMAND_FIND_SYMBOL,
+    CONTROL_COMMAND_BATCH,
+    CONTROL_COMMAND_GET_MEMORY_MULTI,
+    CONTROL_COMMAND_SET_MEMORY_MULTI,
+    CONTROL_COMMAND_SUBSCRIBE,
+    CONTROL_COMMAND_UNSUBSCRIBE,
+    CONTROL_COMMAND_SHM_INFO,
+    CONTROL_COMMAND_GET_TEXT,
+    CONTROL_COMMAND_WAIT_TEXT,
+    CONTROL_COMMAND_REWIND,
+    CONTROL_COMMAND_STEP_BACK,
+    CONTROL_COMMAND_REVERSE_CONTINUE,
+    CONTROL_COMMAND_RUN_TO_CYCLE
 } control_command_type;
 
 typedef enum control_memory_mode {
@@ -80,6 +108,35 @@ typedef enum control_memory_mode {
     CONTROL_MEMORY_MODE_ROM = 5
 } control_memory_mode;
 
+/* One get-memory-multi / set-memory-multi span; wraps at $FFFF. */
+typedef struct control_memory_span {
+    uint16_t address;
+    uint8_t mode; /* control_memory_mode */
+    uint32_t length;
+} control_memory_span;
+
+/* get-frame / get-frame-at payload encoding (format=). */
+typedef enum control_frame_format {
+    CONTROL_FRAME_FORMAT_ARGB8888 = 0,
+    /* 16 × uint32 LE ARGB palette, then one index byte per pixel. */
+    CONTROL_FRAME_FORMAT_INDEXED8 = 1
+} control_frame_format;
+
+/* get-frame / get-frame-at transfer encoding (encoding=); see
+   control_frame_codec.h. delta needs base=<frame>. */
+typedef enum control_frame_encoding {
+    CONTROL_FRAME_ENCODING_RAW = 0,
+    CONTROL_FRAME_ENCODING_RLE = 1,
+    CONTROL_FRAME_ENCODING_DELTA = 2,
+    CONTROL_FRAME_ENCODING_PNG = 3
+} control_frame_encoding;
+
+/* subscribe frames|memory. */
+typedef enum control_subscription_kind {
+    CONTROL_SUBSCRIPTION_FRAMES = 0,
+    CONTROL_SUBSCRIPTION_MEMORY = 1
+} control_subscription_kind;
+
 /* mount/unmount card selection (0 = infer / resolve uniquely). */
 typedef enum control_media_kind {
     CONTROL_MEDIA_KIND_UNSPECIFIED = 0,
@@ -113,6 +170,15 @@ typedef struct control_args {
     uint64_t frame_ring_target;
     bool frame_ring_by_cycle;
     bool frame_ring_record_enabled;
+    /* get-frame-strip: frame=|cycle= is the first target, to= the last. */
+    uint64_t frame_ring_target_end;
+    uint32_t frame_strip_count;
+    uint32_t frame_strip_scale;
+    /* get-frame / get-frame-at format=argb8888|indexed8 (control_frame_format). */
+    uint8_t frame_format;
+    /* get-frame / get-frame-at encoding=raw|rle|delta|png base=<frame>. */
+    uint8_t frame_encoding;
+    uint64_t frame_delta_base;
     /* History control (A2M/5). */
     bool history_record_enabled;
     uint64_t history_cursor;
@@ -130,6 +196,27 @@ typedef struct control_args {
     bool mli_launch;
     bool reset_first;
     bool auto_adjust_segments;
+    /* batch: sub-command count; the sub-request lines are the payload. */
+    uint32_t batch_count;
+    /* get-memory-multi / set-memory-multi; length is the byte total. */
+    uint32_t span_count;
+    control_memory_span spans[CONTROL_MEMORY_SPANS_MAX];
+    /* subscribe frames every=N (frame_format / frame_encoding) or memory
+       ranges=… (spans, memory_mode the default) on=change|frame;
+       unsubscribe <id>|all (id 0 = all). */
+    uint8_t subscription_kind; /* control_subscription_kind */
+    uint32_t subscription_every;
+    bool subscription_on_frame;
+    uint32_t subscription_id;
+    /* hello binary=0|1: switch framing after the reply. */
+    bool framing_set;
+    bool framing_binary;
+    /* wait-text pattern=<regex> (rest of the line). */
+    char text_pattern[CONTROL_TEXT_PATTERN_MAX];
+    /* rewind [frames=<n>]. */
+    uint32_t rewind_frames;
+    /* run-to-cycle cycle=<n>. */
+    uint64_t seek_cycle;
 } control_args;
 
 typedef enum control_response_type {
@@ -137,7 +224,9 @@ typedef enum control_response_type {
     CONTROL_RESPONSE_ERROR,
     CONTROL_RESPONSE_DATA,
     /* Unsolicited out-of-band line: "<id> event <name> [fields...]".
-       Request id 0 is the reserved event channel. */
+       Request id 0 is the reserved event channel. A subscription push also
+       carries a payload: "0 event <type> <bytes> <metadata>", then the
+       bytes and a newline, framed like data. */
     CONTROL_RESPONSE_EVENT
 } control_response_type;
 
@@ -147,6 +236,10 @@ typedef struct control_request {
     control_args args;
     uint8_t *payload;
     size_t payload_size;
+    /* Sender, stamped by the server: client slot (0..CONTROL_CLIENTS_MAX-1)
+       and that connection's epoch. */
+    uint32_t client;
+    uint64_t connection;
 } control_request;
 
 typedef struct control_response {
@@ -158,6 +251,10 @@ typedef struct control_response {
     uint8_t *payload;
     size_t payload_size;
     bool close_client;
+    /* Recipient, from the request. The server drops a response whose
+       connection no longer holds that slot. */
+    uint32_t client;
+    uint64_t connection;
 } control_response;
 
 bool control_protocol_parse_request(
@@ -165,6 +262,11 @@ bool control_protocol_parse_request(
     control_request *out_request,
     control_response *out_error);
 
+/* False for a wait-text pattern tiny-regex-c would misread: an unclosed or
+   over-long [class], a trailing backslash, a modifier with no atom before
+   it, or more atoms than the engine holds. Pure, so any thread may call it. */
+bool control_protocol_text_pattern_valid(const char *pattern);
+
 void control_protocol_format_ok(
     control_response *response,
     uint32_t id,
@@ -190,6 +292,17 @@ void control_protocol_format_data(
     uint8_t *payload,
     size_t payload_size);
 
+/* Event with a payload (id 0); takes ownership of payload like data. */
+void control_protocol_format_event_data(
+    control_response *response,
+    const char *event_type,
+    const char *metadata,
+    uint8_t *payload,
+    size_t payload_size);
+
+/* True when a payload follows the response line on the wire. */
+bool control_response_has_payload(const control_response *response);
+
 void control_request_release(control_request *request);
 void control_response_release(control_response *response);
 
@@ -199,4 +312,67 @@ bool control_protocol_write_response_line(
     size_t out_size,
     const control_response *response);
 
+/* Binary framing, negotiated per connection with `hello binary=1` (the hello
+   reply is still a text line; everything after it is binary until
+   `hello binary=0`, whose reply is the last binary frame). Integers are
+   little-endian.
+
+   Request: u32 id, u16 opcode (control_command_type), u16 flags,
+            u32 args_size, u32 payload_size; then args, then payload.
+   Reply:   u32 id, u8 kind (control_response_type), u8 flags,
+            u16 text_size, u32 payload_size; then text, then payload.
+
+   Args are the text that follows the verb on the text wire, except for
+   get-memory / set-memory (u16 address, u8 mode, u8 0, u32 length),
+   get-memory-multi / set-memory-multi (one such 8-byte record per span) and
+   get-frame (empty; u8 format; u8 format, u8 encoding; or those and a u64
+   delta base frame), which have fixed layouts unless the
+   request sets CONTROL_BINARY_FLAG_TEXT_ARGS. Reply text is what follows
+   the kind word on the text wire ("<type> <metadata>" for data and for
+   events with a payload). There is no trailing newline after a payload. */
+enum {
+    CONTROL_BINARY_REQUEST_HEADER_SIZE = 16,
+    CONTROL_BINARY_REPLY_HEADER_SIZE = 12,
+    CONTROL_BINARY_MEMORY_ARGS_SIZE = 8,
+    CONTROL_BINARY_ARGS_MAX = CONTROL_MEMORY_SPANS_MAX * CONTROL_BINARY_MEMORY_ARGS_SIZE,
+    CONTROL_BINARY_FLAG_TEXT_ARGS = 1, /* request */
+    CONTROL_BINARY_FLAG_CLOSE = 1,     /* reply: server closes after it */
+    CONTROL_BINARY_REPLY_MAX =
+        CONTROL_BINARY_REPLY_HEADER_SIZE + CONTROL_RESPONSE_TEXT_MAX * 2 + 64
+};
+
+typedef struct control_binary_header {
+    uint32_t id;
+    uint16_t opcode;
+    uint16_t flags;
+    uint32_t args_size;
+    uint32_t payload_size;
+} control_binary_header;
+
+void control_protocol_decode_binary_header(
+    const uint8_t bytes[CONTROL_BINARY_REQUEST_HEADER_SIZE],
+    control_binary_header *out);
+
+/* Build a request from a decoded header and its args bytes. The caller reads
+   header->payload_size bytes into out_request->payload afterwards; a request
+   whose parsed payload size disagrees with the header is rejected here. */
+bool control_protocol_parse_binary_request(
+    const control_binary_header *header,
+    const uint8_t *args,
+    control_request *out_request,
+    control_response *out_error);
+
+/* Reply header and text into out; *out_used is the byte count. The payload
+   (response->payload_size bytes) follows on the wire. */
+bool control_protocol_write_binary_response(
+    uint8_t *out,
+    size_t out_size,
+    const control_response *response,
+    size_t *out_used);
+
+/* Canonical verb for a command type, or NULL. */
+const char *control_protocol_command_name(control_command_type type);
+
 const char *control_protocol_memory_mode_name(uint8_t mode);
+const char *control_protocol_frame_format_name(uint8_t format);
+const char *control_protocol_frame_encoding_name(uint8_t encoding);
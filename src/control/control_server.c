@@ -3,6 +3,7 @@
 #include "message_queue.h"
 #include "mutex.h"
 #include "platform_socket.h"
+#include "runtime_shm.h"
 #include "thread.h"
 
 #include <SDL.h>
@@ -11,15 +12,78 @@
 #include <string.h>
 
 enum {
-    CONTROL_QUEUE_CAPACITY = 32,
+    /* Shared by every client: requests in, replies and pushes out. */
+    CONTROL_QUEUE_CAPACITY = 32 * CONTROL_CLIENTS_MAX,
+    /* Pushes per client queued or still unsent at most. */
+    CONTROL_PUSH_BACKLOG = 8,
     CONTROL_RESPONSE_LINE_MAX = 512,
-    /* Poll cadence while waiting for a deferred reply: short enough to notice
-       peer close quickly, long enough to avoid a hot spin. */
+    /* Longest idle wait in poll(): bounds how late stop() is noticed where
+       there is no wake descriptor. */
     CONTROL_RESPONSE_WAIT_SLICE_MS = 50u,
-    /* After peer disconnect, briefly drain late posts before accepting again. */
-    CONTROL_DISCONNECT_DRAIN_MS = 250u
+    /* Bytes pulled from a client per read. */
+    CONTROL_INPUT_CHUNK = 4096,
+    /* Unsent bytes past which a client that stopped reading is dropped. */
+    CONTROL_OUTPUT_MAX = 64 * 1024 * 1024,
+    /* How long a client being closed gets to take its last replies. */
+    CONTROL_CLOSE_LINGER_MS = 2000u
 };
 
+/* Fixed capability words; " shm" follows when a region is advertised. */
+#define CONTROL_SERVER_CAPABILITIES \
+    "connection introspection execution state softswitches step " \
+    "turbo frame frame-ring memory breakpoints wait key disk " \
+    "snapshot history assemble symbols sessions state-changed indexed-frames " \
+    "frame-strip pipelining batch binary memory-multi frame-encoding " \
+    "subscriptions multi-client text rewind reverse"
+
+/* Where a client's request parser is; binary framing reads the fixed
+   header, then args, then payload. */
+typedef enum control_read_state {
+    CONTROL_READ_LINE = 0,
+    CONTROL_READ_HEADER,
+    CONTROL_READ_ARGS,
+    CONTROL_READ_PAYLOAD
+} control_read_state;
+
+/* Socket-thread state for one connected client. Reads and writes never
+   block: partial requests stay in the parser and unsent replies in out, so
+   a slow client only delays itself. */
+typedef struct control_client_io {
+    platform_socket_connection *connection; /* NULL = free slot */
+    uint32_t slot;
+    uint64_t epoch;
+    uint32_t in_flight;
+    bool binary; /* `hello binary=1` */
+    /* Replying to quit-client or a framing error: no more reads, close once
+       out drains (or the linger passes). */
+    bool closing;
+    uint32_t closing_ms;
+    uint8_t in[CONTROL_INPUT_CHUNK];
+    size_t in_start;
+    size_t in_end;
+    control_read_state state;
+    char line[CONTROL_LINE_MAX];
+    uint8_t header[CONTROL_BINARY_REQUEST_HEADER_SIZE];
+    uint8_t args[CONTROL_BINARY_ARGS_MAX];
+    size_t used; /* of line, header, args or payload */
+    control_binary_header frame;
+    /* Request waiting for its payload; parsed=false holds a binary request
+       whose parse failed (error) until its bytes are consumed. */
+    control_request request;
+    bool parsed;
+    control_response error;
+    uint8_t *out;
+    size_t out_capacity;
+    size_t out_head;
+    size_t out_tail;
+    /* Stream positions of bytes queued and sent, and where each unsent push
+       ends, for the push backlog. */
+    uint64_t out_queued;
+    uint64_t out_sent;
+    uint64_t push_end[CONTROL_PUSH_BACKLOG];
+    uint32_t push_count;
+} control_client_io;
+
 struct control_server {
     uint16_t port;
     bool enabled;
@@ -28,15 +92,26 @@ struct control_server {
     bool owns_self; /* true if create() allocated */
     mutex *lock;
     platform_socket_listener *listener;
-    /* Active client socket; only touch under lock. stop() closes it to wake
-       blocked I/O; the worker still owns destroy after handle_connection. */
-    platform_socket_connection *connection;
     message_queue *requests;
     message_queue *responses;
+    /* Signaled on every posted response and by stop(), so the socket thread
+       can sleep in poll() on the sockets and this together. */
+    wake_event *response_wake;
     thread *worker;
-    uint64_t connection_epoch;
-    bool has_client;
+    /* Socket thread only. */
+    control_client_io clients[CONTROL_CLIENTS_MAX];
+    uint64_t next_epoch;
+    /* Under lock: each slot's connection (0 = free) and its queued or
+       unsent pushes. */
+    uint64_t client_epoch[CONTROL_CLIENTS_MAX];
+    uint32_t pushes_queued[CONTROL_CLIENTS_MAX];
     control_server_wake_fn wake_hook;
+    /* Signaled on every queued request, connect and disconnect (may be NULL). */
+    wake_event *wake;
+    /* Shared-memory region for local clients; empty name = none. Fixed
+       before start(), read by the socket thread. */
+    char shm_name[64];
+    uint64_t shm_size;
 };
 
 static bool control_server_is_stopping(control_server_t *server)
@@ -51,420 +126,577 @@ static bool control_server_is_stopping(control_server_t *server)
     return stopping;
 }
 
-static void control_server_set_has_client(control_server_t *server, bool has)
+static void control_server_free_response(control_response *response)
 {
-    if (server == NULL || server->lock == NULL) {
-        return;
-    }
-    mutex_lock(server->lock);
-    server->has_client = has;
-    mutex_unlock(server->lock);
+    free(response->payload);
+    response->payload = NULL;
 }
 
-/* Peer gone: free the single client slot and bump epoch so dispatch cancels
-   deferred work (wait-paused etc.) immediately via check_session. */
-static void control_server_note_disconnect(control_server_t *server)
+/* Append bytes to the client's unsent output. False when the client has
+   let CONTROL_OUTPUT_MAX pile up or memory runs out. */
+static bool control_client_append(control_client_io *io, const void *data, size_t size)
 {
-    if (server == NULL || server->lock == NULL) {
-        return;
+    size_t pending = io->out_tail - io->out_head;
+
+    if (size == 0) {
+        return true;
     }
-    mutex_lock(server->lock);
-    server->has_client = false;
-    server->connection_epoch += 1u;
-    if (server->connection_epoch == 0u) {
-        server->connection_epoch = 1u;
+    if (pending + size > CONTROL_OUTPUT_MAX) {
+        return false;
     }
-    mutex_unlock(server->lock);
+    if (io->out_tail + size > io->out_capacity) {
+        if (io->out_head > 0) {
+            memmove(io->out, io->out + io->out_head, pending);
+            io->out_head = 0;
+            io->out_tail = pending;
+        }
+        if (pending + size > io->out_capacity) {
+            size_t capacity = io->out_capacity != 0 ? io->out_capacity : CONTROL_INPUT_CHUNK;
+            uint8_t *grown;
+
+            while (capacity < pending + size) {
+                capacity *= 2u;
+            }
+            grown = (uint8_t *)realloc(io->out, capacity);
+            if (grown == NULL) {
+                return false;
+            }
+            io->out = grown;
+            io->out_capacity = capacity;
+        }
+    }
+    memcpy(io->out + io->out_tail, data, size);
+    io->out_tail += size;
+    io->out_queued += size;
+    return true;
 }
 
-static void control_server_discard_pending_responses(control_server_t *server)
+/* Serialize a reply or event in the client's framing. */
+static bool control_server_queue_response(
+    control_client_io *io,
+    const control_response *response)
 {
-    control_response response;
+    if (io->binary) {
+        uint8_t header[CONTROL_BINARY_REPLY_MAX];
+        size_t used = 0;
 
-    if (server == NULL || server->responses == NULL) {
-        return;
+        if (!control_protocol_write_binary_response(header, sizeof(header), response, &used) ||
+            !control_client_append(io, header, used)) {
+            return false;
+        }
+    } else {
+        char line[CONTROL_RESPONSE_LINE_MAX];
+
+        if (!control_protocol_write_response_line(line, sizeof(line), response) ||
+            !control_client_append(io, line, strlen(line))) {
+            return false;
+        }
     }
-    while (message_queue_try_pop(server->responses, &response)) {
-        if (response.payload != NULL) {
-            free(response.payload);
-            response.payload = NULL;
+    if (control_response_has_payload(response)) {
+        /* Counted payload may be empty (e.g. break-list count=0); text framing
+           still sends the trailing newline so clients stay in sync. */
+        if (response->payload_size > 0) {
+            if (response->payload == NULL ||
+                !control_client_append(io, response->payload, response->payload_size)) {
+                return false;
+            }
+        }
+        if (!io->binary && !control_client_append(io, "\n", 1)) {
+            return false;
         }
     }
+    if (response->close_client && !io->closing) {
+        io->closing = true;
+        io->closing_ms = (uint32_t)SDL_GetTicks();
+    }
+    return true;
 }
 
-/* True if the peer closed or the socket is in error. Does not consume
-   application data unless EOF is detected (recv returns 0). */
-static bool control_server_peer_gone(platform_socket_connection *connection)
+static void control_server_disconnect(control_server_t *server, control_client_io *io)
 {
-    int ready;
-    char ch;
-    int n;
+    uint32_t slot = io->slot;
 
-    if (connection == NULL) {
-        return true;
-    }
-    ready = platform_socket_wait_readable(connection, 0u);
-    if (ready < 0) {
-        return true; /* error / HUP */
+    platform_socket_connection_destroy(io->connection);
+    control_request_release(&io->request);
+    free(io->out);
+    memset(io, 0, sizeof(*io));
+    io->slot = slot;
+    mutex_lock(server->lock);
+    server->client_epoch[slot] = 0u;
+    server->pushes_queued[slot] = 0u;
+    mutex_unlock(server->lock);
+    /* Dispatch cancels the client's deferred work and frees its session. */
+    wake_event_signal(server->wake);
+}
+
+/* Write what the socket takes. False when the peer is gone. */
+static bool control_server_flush_client(control_server_t *server, control_client_io *io)
+{
+    uint32_t sent_pushes = 0;
+
+    while (io->out_head < io->out_tail) {
+        int n = platform_socket_write_some(
+            io->connection, io->out + io->out_head, io->out_tail - io->out_head);
+        if (n == -2) {
+            break;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        io->out_head += (size_t)n;
+        io->out_sent += (uint64_t)n;
     }
-    if (ready == 0) {
-        return false;
+    if (io->out_head == io->out_tail) {
+        io->out_head = 0;
+        io->out_tail = 0;
     }
-    /* Readable: FIN/RST → 0/-1; unexpected payload while waiting is a protocol
-       violation for sequential A2M (treat as drop to free the port). */
-    n = platform_socket_read(connection, &ch, 1);
-    if (n == -2) {
-        return false; /* would-block after poll race */
+    while (sent_pushes < io->push_count && io->push_end[sent_pushes] <= io->out_sent) {
+        sent_pushes++;
     }
-    if (n <= 0) {
-        return true; /* EOF or hard error */
+    if (sent_pushes > 0u) {
+        io->push_count -= sent_pushes;
+        memmove(io->push_end, io->push_end + sent_pushes, sizeof(io->push_end[0]) * io->push_count);
+        mutex_lock(server->lock);
+        server->pushes_queued[io->slot] = server->pushes_queued[io->slot] > sent_pushes
+            ? server->pushes_queued[io->slot] - sent_pushes
+            : 0u;
+        mutex_unlock(server->lock);
     }
-    /* Unexpected byte mid-response-wait: desync risk → drop session. */
     return true;
 }
 
-static bool control_server_send_response(
-    platform_socket_connection *connection,
-    const control_response *response);
-
-static bool control_server_flush_unsolicited(
-    control_server_t *server,
-    platform_socket_connection *connection)
+/* Move every posted response into its client's output. Responses for a
+   connection that has since gone are dropped. */
+static void control_server_route_responses(control_server_t *server)
 {
     control_response response;
 
-    if (server == NULL || connection == NULL || server->responses == NULL) {
-        return true;
-    }
     while (message_queue_try_pop(server->responses, &response)) {
-        if (!control_server_send_response(connection, &response)) {
-            if (response.payload != NULL) {
-                free(response.payload);
-            }
-            return false;
+        control_client_io *io;
+        bool push;
+        bool reply;
+
+        if (response.client >= CONTROL_CLIENTS_MAX) {
+            control_server_free_response(&response);
+            continue;
+        }
+        io = &server->clients[response.client];
+        if (io->connection == NULL || io->epoch != response.connection) {
+            control_server_free_response(&response);
+            continue;
+        }
+        push = response.type == CONTROL_RESPONSE_EVENT && control_response_has_payload(&response);
+        reply = response.type != CONTROL_RESPONSE_EVENT && response.id != 0u;
+        if (io->closing) {
+            /* Past quit-client or a framing error: nothing else goes out. */
+            control_server_free_response(&response);
+            continue;
+        }
+        if (!control_server_queue_response(io, &response)) {
+            control_server_free_response(&response);
+            control_server_disconnect(server, io);
+            continue;
+        }
+        control_server_free_response(&response);
+        if (reply && io->in_flight > 0u) {
+            io->in_flight--;
         }
-        if (response.payload != NULL) {
-            free(response.payload);
-            response.payload = NULL;
+        if (push && io->push_count < CONTROL_PUSH_BACKLOG) {
+            io->push_end[io->push_count++] = io->out_queued;
         }
     }
-    return true;
 }
 
-static bool control_server_read_line(
+/* Answer identity commands here, queue the rest for the dispatcher. Replies
+   to queued requests are routed back whenever they are posted, so several
+   may be in flight. Takes ownership of the request. False when the client's
+   output overflowed. */
+static bool control_server_handle_request(
     control_server_t *server,
-    platform_socket_connection *connection,
-    char *out,
-    size_t out_size)
+    control_client_io *io,
+    control_request *request)
 {
-    size_t used = 0;
+    control_response response;
+    bool switch_framing = false;
 
-    if (connection == NULL || out == NULL || out_size == 0) {
-        return false;
+    memset(&response, 0, sizeof(response));
+
+    if (request->type == CONTROL_COMMAND_QUIT_CLIENT) {
+        control_protocol_format_ok(&response, request->id, "bye");
+        response.close_client = true;
+        control_request_release(request);
+        return control_server_queue_response(io, &response);
     }
 
-    while (used + 1 < out_size) {
-        char ch;
-        int n = platform_socket_read(connection, &ch, 1);
-        if (n == -2) {
-            /* Would block: flush events, then wait for peer data or close. */
-            if (!control_server_flush_unsolicited(server, connection)) {
-                return false;
-            }
-            if (platform_socket_wait_readable(connection, 50u) < 0) {
-                return false;
+    /* Immediate identity commands handled on socket thread. */
+    if (request->type == CONTROL_COMMAND_HELLO) {
+        if (request->args.framing_set && request->args.framing_binary != io->binary) {
+            if (io->in_flight > 0u) {
+                /* Replies still owed would arrive in the other framing. */
+                control_protocol_format_error(
+                    &response, request->id, "busy", "requests-in-flight", false);
+                control_request_release(request);
+                return control_server_queue_response(io, &response);
             }
-            continue;
-        }
-        if (n <= 0) {
-            return false; /* EOF or error */
+            switch_framing = true;
+        }
+        control_protocol_format_ok(
+            &response,
+            request->id,
+            request->args.framing_set
+                ? (request->args.framing_binary
+                    ? "name=" CONTROL_PROTOCOL_APP_NAME " protocol=" CONTROL_PROTOCOL_VERSION
+                      " binary=1"
+                    : "name=" CONTROL_PROTOCOL_APP_NAME " protocol=" CONTROL_PROTOCOL_VERSION
+                      " binary=0")
+                : "name=" CONTROL_PROTOCOL_APP_NAME " protocol=" CONTROL_PROTOCOL_VERSION);
+    } else if (request->type == CONTROL_COMMAND_VERSION) {
+        control_protocol_format_ok(
+            &response,
+            request->id,
+            "protocol=" CONTROL_PROTOCOL_VERSION " app=" CONTROL_PROTOCOL_APP_NAME);
+    } else if (request->type == CONTROL_COMMAND_CAPABILITIES) {
+        control_protocol_format_ok(
+            &response,
+            request->id,
+            server->shm_name[0] != '\0'
+                ? CONTROL_SERVER_CAPABILITIES " shm"
+                : CONTROL_SERVER_CAPABILITIES);
+    } else if (request->type == CONTROL_COMMAND_SHM_INFO) {
+        if (server->shm_name[0] == '\0') {
+            control_protocol_format_error(
+                &response, request->id, "not-found", "shm-off", false);
+        } else {
+            char text[CONTROL_RESPONSE_TEXT_MAX];
+            (void)snprintf(
+                text, sizeof(text), "name=%s size=%llu layout=%s version=%d",
+                server->shm_name, (unsigned long long)server->shm_size,
+                RUNTIME_SHM_MAGIC, RUNTIME_SHM_VERSION);
+            control_protocol_format_ok(&response, request->id, text);
+        }
+    } else if (request->type == CONTROL_COMMAND_PING) {
+        control_protocol_format_ok(&response, request->id, "");
+    } else {
+        request->client = io->slot;
+        request->connection = io->epoch;
+        if (!message_queue_push(server->requests, request)) {
+            control_protocol_format_error(
+                &response, request->id, "busy", "request-queue-full", false);
+            control_request_release(request);
+            return control_server_queue_response(io, &response);
         }
-        out[used++] = ch;
-        if (ch == '\n') {
-            out[used] = '\0';
-            return true;
+        memset(request, 0, sizeof(*request)); /* the queue owns the payload */
+        io->in_flight++;
+        if (server->wake_hook != NULL) {
+            server->wake_hook();
         }
+        return true;
     }
-    return false;
+    control_request_release(request);
+    if (!control_server_queue_response(io, &response)) {
+        return false;
+    }
+    if (switch_framing) {
+        /* The reply went out in the old framing; the next request uses the new. */
+        io->binary = !io->binary;
+        io->state = io->binary ? CONTROL_READ_HEADER : CONTROL_READ_LINE;
+        io->used = 0;
+    }
+    return true;
 }
 
-static bool control_server_read_exact(
-    platform_socket_connection *connection,
-    uint8_t *out,
-    size_t size)
+/* Reply with a framing error and stop reading: the stream is out of step. */
+static bool control_server_framing_error(control_client_io *io, uint32_t id)
 {
-    size_t used = 0;
-    while (used < size) {
-        int n = platform_socket_read(connection, out + used, size - used);
-        if (n == -2) {
-            if (platform_socket_wait_readable(connection, 2000u) <= 0) {
-                return false;
-            }
-            continue;
-        }
-        if (n <= 0) {
-            return false;
-        }
-        used += (size_t)n;
-    }
-    return true;
+    control_response error;
+
+    control_request_release(&io->request);
+    io->parsed = false;
+    control_protocol_format_error(&error, id, "bad-payload", "framing", true);
+    return control_server_queue_response(io, &error);
 }
 
-static bool control_server_send_response(
-    platform_socket_connection *connection,
-    const control_response *response)
+/* Copy up to want - io->used buffered input bytes into dest. True once
+   dest holds want bytes. */
+static bool control_client_take(control_client_io *io, uint8_t *dest, size_t want)
 {
-    char line[CONTROL_RESPONSE_LINE_MAX];
+    size_t n = want - io->used;
 
-    if (!control_protocol_write_response_line(line, sizeof(line), response)) {
-        return false;
+    if (n > io->in_end - io->in_start) {
+        n = io->in_end - io->in_start;
     }
-    if (!platform_socket_write_all(connection, line, strlen(line))) {
+    memcpy(dest + io->used, io->in + io->in_start, n);
+    io->in_start += n;
+    io->used += n;
+    if (io->used < want) {
         return false;
     }
-    if (response->type == CONTROL_RESPONSE_DATA) {
-        /* Counted payload may be empty (e.g. break-list count=0); still send
-           the trailing newline so clients stay in sync. */
-        if (response->payload_size > 0) {
-            if (response->payload == NULL) {
-                return false;
-            }
-            if (!platform_socket_write_all(
-                    connection, response->payload, response->payload_size)) {
-                return false;
-            }
-        }
-        if (!platform_socket_write_all(connection, "\n", 1)) {
-            return false;
-        }
-    }
+    io->used = 0;
     return true;
 }
 
-static void control_server_handle_connection(
-    control_server_t *server,
-    platform_socket_connection *connection)
+/* The request (and its payload) is complete: answer or queue it. */
+static bool control_server_finish_request(control_server_t *server, control_client_io *io)
 {
-    char line[CONTROL_LINE_MAX];
-    bool peer_disconnected = false;
+    control_request request = io->request;
+    bool parsed = io->parsed;
 
-    /* Drop any orphaned replies from a previous session before serving. */
-    control_server_discard_pending_responses(server);
-    control_server_set_has_client(server, true);
-
-    /* Nonblocking so peer-close checks never stall on recv. */
-    (void)platform_socket_set_nonblocking(connection, true);
-
-    while (!control_server_is_stopping(server)) {
-        control_request request;
-        control_response error;
-        control_response response;
-        bool got_response = false;
-
-        memset(&request, 0, sizeof(request));
-        memset(&error, 0, sizeof(error));
-        memset(&response, 0, sizeof(response));
+    memset(&io->request, 0, sizeof(io->request));
+    io->parsed = false;
+    io->state = io->binary ? CONTROL_READ_HEADER : CONTROL_READ_LINE;
+    if (!parsed) {
+        control_request_release(&request);
+        return control_server_queue_response(io, &io->error);
+    }
+    return control_server_handle_request(server, io, &request);
+}
 
-        if (!control_server_read_line(server, connection, line, sizeof(line))) {
-            peer_disconnected = true;
-            break;
-        }
+/* Feed buffered input through the request parser. Text framing: a request
+   line, then its payload and a newline. Binary framing: header, args,
+   payload; a request that fails to parse still has its bytes consumed so the
+   stream stays in step, and sizes past the protocol limits close the client.
+   False when the client has to be dropped. */
+static bool control_server_consume_input(control_server_t *server, control_client_io *io)
+{
+    while (io->in_start < io->in_end && !io->closing) {
+        switch (io->state) {
+        case CONTROL_READ_LINE: {
+            char ch = (char)io->in[io->in_start++];
 
-        if (!control_protocol_parse_request(line, &request, &error)) {
-            (void)control_server_send_response(connection, &error);
-            if (error.close_client) {
+            if (io->used + 1 >= sizeof(io->line)) {
+                return false; /* overlong line */
+            }
+            io->line[io->used++] = ch;
+            if (ch != '\n') {
                 break;
             }
-            continue;
-        }
-
-        if (request.payload_size > 0) {
-            char newline;
-            request.payload = (uint8_t *)malloc(request.payload_size);
-            if (request.payload == NULL ||
-                !control_server_read_exact(
-                    connection, request.payload, request.payload_size) ||
-                !control_server_read_exact(connection, (uint8_t *)&newline, 1) ||
-                newline != '\n') {
-                control_request_release(&request);
-                control_protocol_format_error(
-                    &error, request.id, "bad-payload", "framing", true);
-                (void)control_server_send_response(connection, &error);
+            io->line[io->used] = '\0';
+            io->used = 0;
+            memset(&io->request, 0, sizeof(io->request));
+            if (!control_protocol_parse_request(io->line, &io->request, &io->error)) {
+                if (!control_server_queue_response(io, &io->error)) {
+                    return false;
+                }
                 break;
             }
-        }
-
-        if (request.type == CONTROL_COMMAND_QUIT_CLIENT) {
-            control_protocol_format_ok(&response, request.id, "bye");
-            response.close_client = true;
-            (void)control_server_send_response(connection, &response);
-            control_request_release(&request);
+            io->parsed = true;
+            if (io->request.payload_size > 0) {
+                io->request.payload = (uint8_t *)malloc(io->request.payload_size + 1u);
+                if (io->request.payload == NULL) {
+                    return control_server_framing_error(io, io->request.id);
+                }
+                io->state = CONTROL_READ_PAYLOAD;
+                break;
+            }
+            if (!control_server_finish_request(server, io)) {
+                return false;
+            }
             break;
         }
-
-        /* Immediate identity commands handled on socket thread. */
-        if (request.type == CONTROL_COMMAND_HELLO) {
-            control_protocol_format_ok(
-                &response,
-                request.id,
-                "name=" CONTROL_PROTOCOL_APP_NAME " protocol=" CONTROL_PROTOCOL_VERSION);
-            (void)control_server_send_response(connection, &response);
-            control_request_release(&request);
-            continue;
-        }
-        if (request.type == CONTROL_COMMAND_VERSION) {
-            control_protocol_format_ok(
-                &response,
-                request.id,
-                "protocol=" CONTROL_PROTOCOL_VERSION " app=" CONTROL_PROTOCOL_APP_NAME);
-            (void)control_server_send_response(connection, &response);
-            control_request_release(&request);
-            continue;
-        }
-        if (request.type == CONTROL_COMMAND_CAPABILITIES) {
-            control_protocol_format_ok(
-                &response,
-                request.id,
-                "connection introspection execution state softswitches step "
-                "turbo frame frame-ring memory breakpoints wait key disk "
-                "snapshot history assemble symbols sessions state-changed");
-            (void)control_server_send_response(connection, &response);
-            control_request_release(&request);
-            continue;
-        }
-        if (request.type == CONTROL_COMMAND_PING) {
-            control_protocol_format_ok(&response, request.id, "");
-            (void)control_server_send_response(connection, &response);
-            control_request_release(&request);
-            continue;
-        }
-
-        if (!message_queue_push(server->requests, &request)) {
-            control_request_release(&request);
-            control_protocol_format_error(
-                &error, request.id, "busy", "request-queue-full", false);
-            (void)control_server_send_response(connection, &error);
-            continue;
-        }
-        if (server->wake_hook != NULL) {
-            server->wake_hook();
-        }
-
-        /* Wait for deferred reply OR peer close — never spin only on the
-           response queue (that wedges the single client slot until timeout).
-           Unsolicited EVENT lines (id 0) may arrive first; flush them and keep
-           waiting for the matching request reply. */
-        while (!control_server_is_stopping(server)) {
-            if (message_queue_wait_pop_timeout(
-                    server->responses,
-                    &response,
-                    CONTROL_RESPONSE_WAIT_SLICE_MS)) {
-                if (response.type == CONTROL_RESPONSE_EVENT || response.id == 0u) {
-                    if (!control_server_send_response(connection, &response)) {
-                        if (response.payload != NULL) {
-                            free(response.payload);
-                            response.payload = NULL;
-                        }
-                        peer_disconnected = true;
-                        break;
-                    }
-                    if (response.payload != NULL) {
-                        free(response.payload);
-                        response.payload = NULL;
-                    }
-                    continue;
-                }
-                got_response = true;
+        case CONTROL_READ_HEADER:
+            if (!control_client_take(io, io->header, sizeof(io->header))) {
                 break;
             }
-            if (control_server_peer_gone(connection)) {
-                peer_disconnected = true;
+            control_protocol_decode_binary_header(io->header, &io->frame);
+            if (io->frame.args_size > sizeof(io->args) ||
+                io->frame.payload_size > CONTROL_PAYLOAD_MAX) {
+                return control_server_framing_error(io, io->frame.id);
+            }
+            /* Args may be empty. */
+            io->state = CONTROL_READ_ARGS;
+            /* fall through */
+        case CONTROL_READ_ARGS:
+            if (io->frame.args_size > 0u &&
+                !control_client_take(io, io->args, io->frame.args_size)) {
                 break;
             }
-        }
-
-        if (peer_disconnected) {
+            memset(&io->request, 0, sizeof(io->request));
+            io->parsed = control_protocol_parse_binary_request(
+                &io->frame, io->args, &io->request, &io->error);
+            if (io->frame.payload_size > 0u) {
+                io->request.payload = (uint8_t *)malloc(io->frame.payload_size);
+                io->request.payload_size = io->frame.payload_size;
+                if (io->request.payload == NULL) {
+                    return control_server_framing_error(io, io->frame.id);
+                }
+                io->state = CONTROL_READ_PAYLOAD;
+                break;
+            }
+            if (!control_server_finish_request(server, io)) {
+                return false;
+            }
             break;
-        }
-        if (!got_response) {
-            break; /* stopping */
-        }
+        case CONTROL_READ_PAYLOAD: {
+            /* Text framing reads the payload's newline into the spare byte. */
+            size_t want = io->request.payload_size + (io->binary ? 0u : 1u);
 
-        if (!control_server_send_response(connection, &response)) {
-            if (response.payload != NULL) {
-                free(response.payload);
-                response.payload = NULL;
+            if (!control_client_take(io, io->request.payload, want)) {
+                break;
+            }
+            if (!io->binary && io->request.payload[io->request.payload_size] != '\n') {
+                return control_server_framing_error(io, io->request.id);
+            }
+            if (!control_server_finish_request(server, io)) {
+                return false;
             }
-            peer_disconnected = true;
             break;
         }
-        if (response.payload != NULL) {
-            free(response.payload);
-            response.payload = NULL;
-        }
-        if (response.close_client) {
-            break;
         }
     }
+    return true;
+}
+
+/* Read once and parse what arrived. False when the peer is gone. */
+static bool control_server_read_client(control_server_t *server, control_client_io *io)
+{
+    int n;
+
+    if (io->closing) {
+        return true;
+    }
+    n = platform_socket_read(io->connection, io->in, sizeof(io->in));
+    if (n == -2) {
+        return true;
+    }
+    if (n <= 0) {
+        return false;
+    }
+    io->in_start = 0;
+    io->in_end = (size_t)n;
+    return control_server_consume_input(server, io);
+}
 
-    if (peer_disconnected) {
-        control_server_note_disconnect(server);
-        /* Brief drain so a near-simultaneous deferred completion is not left
-           for the next client; main check_session cancels epoch-mismatched work. */
-        {
-            uint32_t start = (uint32_t)SDL_GetTicks();
-            while ((uint32_t)SDL_GetTicks() - start < CONTROL_DISCONNECT_DRAIN_MS) {
-                control_server_discard_pending_responses(server);
-                if (control_server_is_stopping(server)) {
-                    break;
-                }
-                SDL_Delay(5u);
+static void control_server_accept_clients(control_server_t *server)
+{
+    platform_socket_connection *connection;
+
+    while ((connection = platform_socket_accept(server->listener)) != NULL) {
+        control_client_io *io = NULL;
+        uint32_t slot;
+
+        for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+            if (server->clients[slot].connection == NULL) {
+                io = &server->clients[slot];
+                break;
             }
         }
-        control_server_discard_pending_responses(server);
-    } else {
-        control_server_set_has_client(server, false);
-        control_server_discard_pending_responses(server);
-    }
+        if (io == NULL) {
+            control_response error;
+            char line[CONTROL_RESPONSE_LINE_MAX];
 
-    /* Close only: worker destroys under the lock so stop() cannot free the
-       same pointer concurrently (see control_server_worker / stop). */
-    platform_socket_connection_close(connection);
+            control_protocol_format_error(&error, 0u, "busy", "clients-full", true);
+            if (control_protocol_write_response_line(line, sizeof(line), &error)) {
+                (void)platform_socket_write_all(connection, line, strlen(line));
+            }
+            platform_socket_connection_destroy(connection);
+            continue;
+        }
+        (void)platform_socket_set_nonblocking(connection, true);
+        memset(io, 0, sizeof(*io));
+        io->slot = slot;
+        io->connection = connection;
+        io->state = CONTROL_READ_LINE;
+        io->epoch = ++server->next_epoch;
+        if (io->epoch == 0u) {
+            io->epoch = ++server->next_epoch;
+        }
+        mutex_lock(server->lock);
+        server->client_epoch[slot] = io->epoch;
+        server->pushes_queued[slot] = 0u;
+        mutex_unlock(server->lock);
+        /* Let dispatch bind the client's runtime session right away. */
+        wake_event_signal(server->wake);
+    }
 }
 
 static int control_server_worker(void *userdata)
 {
     control_server_t *server = (control_server_t *)userdata;
+    int wake_fd;
+    uint32_t slot;
 
     if (server == NULL) {
         return 1;
     }
+    wake_fd = wake_event_fd(server->response_wake);
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        server->clients[slot].slot = slot;
+    }
 
     while (!control_server_is_stopping(server)) {
-        platform_socket_connection *conn = platform_socket_accept(server->listener);
-        if (conn == NULL) {
-            /* Listener closed by stop(), or accept error — exit the loop. */
-            break;
+        platform_socket_poll_entry entries[1 + CONTROL_CLIENTS_MAX];
+        control_client_io *polled[1 + CONTROL_CLIENTS_MAX];
+        size_t count = 0;
+        bool waiting = false;
+        size_t i;
+        int ready;
+
+        /* Clear before routing: a response posted after this re-arms poll(). */
+        (void)wake_event_wait(server->response_wake, 0u);
+        control_server_route_responses(server);
+
+        memset(entries, 0, sizeof(entries));
+        entries[count].listener = server->listener;
+        entries[count].want_read = true;
+        polled[count++] = NULL;
+        for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+            control_client_io *io = &server->clients[slot];
+
+            if (io->connection == NULL) {
+                continue;
+            }
+            if (!control_server_flush_client(server, io)) {
+                control_server_disconnect(server, io);
+                continue;
+            }
+            if (io->closing &&
+                (io->out_head == io->out_tail ||
+                 (uint32_t)SDL_GetTicks() - io->closing_ms >= CONTROL_CLOSE_LINGER_MS)) {
+                control_server_disconnect(server, io);
+                continue;
+            }
+            entries[count].connection = io->connection;
+            entries[count].want_read = !io->closing;
+            entries[count].want_write = io->out_head < io->out_tail;
+            polled[count++] = io;
+            waiting = waiting || io->in_flight > 0u || io->closing;
+        }
+
+        /* Block until a socket is ready or a response is posted. Without a
+           wake descriptor, poll responses at 1 ms while requests are out. */
+        ready = platform_socket_poll(
+            entries,
+            count,
+            wake_fd,
+            wake_fd < 0 && waiting ? 1u : CONTROL_RESPONSE_WAIT_SLICE_MS);
+        if (ready <= 0) {
+            continue;
         }
-
-        mutex_lock(server->lock);
-        server->connection_epoch += 1u;
-        if (server->connection_epoch == 0u) {
-            server->connection_epoch = 1u;
+        if (entries[0].failed) {
+            break; /* listener gone */
         }
-        server->connection = conn;
-        mutex_unlock(server->lock);
-
-        control_server_handle_connection(server, conn);
+        if (entries[0].readable) {
+            control_server_accept_clients(server);
+        }
+        for (i = 1; i < count; i++) {
+            control_client_io *io = polled[i];
 
-        /* Clear and free under the lock so this destroy cannot race stop()
-           closing the same pointer from the main thread. */
-        mutex_lock(server->lock);
-        server->connection = NULL;
-        platform_socket_connection_destroy(conn);
-        mutex_unlock(server->lock);
+            if (io->connection == NULL) {
+                continue;
+            }
+            if ((entries[i].readable && !control_server_read_client(server, io)) ||
+                (entries[i].failed && !entries[i].readable) ||
+                (entries[i].writable && !control_server_flush_client(server, io))) {
+                control_server_disconnect(server, io);
+            }
+        }
     }
 
+    for (slot = 0; slot < CONTROL_CLIENTS_MAX; slot++) {
+        if (server->clients[slot].connection != NULL) {
+            control_server_disconnect(server, &server->clients[slot]);
+        }
+    }
     return 0;
 }
 
@@ -534,6 +766,10 @@ bool control_server_start(control_server_t *server)
     server->lock = mutex_create();
     server->requests = message_queue_create(sizeof(control_request), CONTROL_QUEUE_CAPACITY);
     server->responses = message_queue_create(sizeof(control_response), CONTROL_QUEUE_CAPACITY);
+    /* Optional: without it the socket thread polls replies on a timer. */
+    server->response_wake = wake_event_create();
+    message_queue_set_wake_event(server->requests, server->wake);
+    message_queue_set_wake_event(server->responses, server->response_wake);
     if (server->lock == NULL || server->requests == NULL || server->responses == NULL) {
         control_server_stop(server);
         platform_socket_shutdown();
@@ -541,7 +777,6 @@ bool control_server_start(control_server_t *server)
     }
 
     server->stopping = false;
-    server->connection = NULL;
     /* Listener is created on the starter thread and destroyed only in stop()
        after join — never by the worker (avoids UAF with concurrent close). */
     server->listener = platform_socket_listen_localhost(server->port);
@@ -550,6 +785,8 @@ bool control_server_start(control_server_t *server)
         platform_socket_shutdown();
         return false;
     }
+    /* Accepted only when poll() says a client is waiting; never block. */
+    (void)platform_socket_listener_set_nonblocking(server->listener, true);
 
     server->worker = thread_create("a2m-control", control_server_worker, server);
     if (server->worker == NULL) {
@@ -578,21 +815,14 @@ void control_server_stop(control_server_t *server)
     if (server->lock != NULL) {
         mutex_lock(server->lock);
         server->stopping = true;
-        /* Close the active client under the lock so we cannot close a pointer
-           the worker is concurrently destroying. Close is idempotent and only
-           shuts the socket to wake blocked poll/recv; worker still owns free. */
-        if (server->connection != NULL) {
-            platform_socket_connection_close(server->connection);
-        }
         mutex_unlock(server->lock);
     } else {
         server->stopping = true;
     }
 
-    /* Wake a blocking accept() without freeing the listener object yet. */
-    if (server->listener != NULL) {
-        platform_socket_listener_close(server->listener);
-    }
+    /* The worker never blocks on a socket: waking its poll() is enough, and
+       it closes the clients itself on the way out. */
+    wake_event_signal(server->response_wake);
     if (server->requests != NULL) {
         message_queue_wake_all(server->requests);
     }
@@ -627,14 +857,16 @@ void control_server_stop(control_server_t *server)
         message_queue_destroy(server->responses);
         server->responses = NULL;
     }
+    wake_event_destroy(server->response_wake);
+    server->response_wake = NULL;
     if (server->lock != NULL) {
         mutex_destroy(server->lock);
         server->lock = NULL;
     }
 
-    server->connection = NULL;
     server->started = false;
-    server->has_client = false;
+    memset(server->client_epoch, 0, sizeof(server->client_epoch));
+    memset(server->pushes_queued, 0, sizeof(server->pushes_queued));
 }
 
 bool control_server_poll_request(control_server_t *server, control_request *out_request)
@@ -655,28 +887,46 @@ bool control_server_post_response(
     return message_queue_push(server->responses, response);
 }
 
-uint64_t control_server_connection_epoch(control_server_t *server)
+bool control_server_post_push(control_server_t *server, const control_response *response)
 {
-    uint64_t epoch = 0;
-    if (server == NULL || server->lock == NULL) {
-        return 0;
+    uint32_t slot;
+    bool posted;
+
+    if (server == NULL || response == NULL || server->responses == NULL ||
+        server->lock == NULL || response->client >= CONTROL_CLIENTS_MAX) {
+        return false;
     }
+    slot = response->client;
     mutex_lock(server->lock);
-    epoch = server->connection_epoch;
+    if (server->client_epoch[slot] != response->connection ||
+        server->pushes_queued[slot] >= CONTROL_PUSH_BACKLOG) {
+        mutex_unlock(server->lock);
+        return false;
+    }
+    server->pushes_queued[slot]++;
     mutex_unlock(server->lock);
-    return epoch;
+    posted = message_queue_push(server->responses, response);
+    if (!posted) {
+        mutex_lock(server->lock);
+        if (server->client_epoch[slot] == response->connection &&
+            server->pushes_queued[slot] > 0u) {
+            server->pushes_queued[slot]--;
+        }
+        mutex_unlock(server->lock);
+    }
+    return posted;
 }
 
-bool control_server_has_client(control_server_t *server)
+uint64_t control_server_client_epoch(control_server_t *server, uint32_t client)
 {
-    bool has = false;
-    if (server == NULL || server->lock == NULL) {
-        return false;
+    uint64_t epoch = 0;
+    if (server == NULL || server->lock == NULL || client >= CONTROL_CLIENTS_MAX) {
+        return 0;
     }
     mutex_lock(server->lock);
-    has = server->has_client;
+    epoch = server->client_epoch[client];
     mutex_unlock(server->lock);
-    return has;
+    return epoch;
 }
 
 bool control_server_enabled(const control_server_t *server)
@@ -695,3 +945,24 @@ void control_server_set_wake_hook(control_server_t *server, control_server_wake_
         server->wake_hook = fn;
     }
 }
+
+void control_server_set_wake_event(control_server_t *server, wake_event *wake)
+{
+    if (server != NULL) {
+        server->wake = wake;
+        message_queue_set_wake_event(server->requests, wake);
+    }
+}
+
+void control_server_set_shm(control_server_t *server, const char *name, uint64_t size)
+{
+    if (server == NULL) {
+        return;
+    }
+    server->shm_name[0] = '\0';
+    server->shm_size = 0;
+    if (name != NULL && strlen(name) < sizeof(server->shm_name)) {
+        memcpy(server->shm_name, name, strlen(name) + 1u);
+        server->shm_size = size;
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "control_protocol.h"
+#include "wake_event.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -18,13 +19,29 @@ void control_server_destroy(control_server_t *server);
 bool control_server_start(control_server_t *server);
 void control_server_stop(control_server_t *server);
 
+/* Requests from every client, stamped with the sender (client slot and
+   connection epoch). Responses go to response->client / connection. */
 bool control_server_poll_request(control_server_t *server, control_request *out_request);
 bool control_server_post_response(control_server_t *server, const control_response *response);
-
-uint64_t control_server_connection_epoch(control_server_t *server);
-bool control_server_has_client(control_server_t *server);
+/* Subscription event with a payload. Refused once CONTROL_PUSH_BACKLOG of
+   them are still waiting for that client's socket, so pushes to a slow
+   reader are dropped instead of filling the queue replies need. */
+bool control_server_post_push(control_server_t *server, const control_response *response);
+
+/* Connection epoch in client slot 0..CONTROL_CLIENTS_MAX-1; 0 = free. A new
+   connection in a slot always gets a new epoch. */
+uint64_t control_server_client_epoch(control_server_t *server, uint32_t client);
 bool control_server_enabled(const control_server_t *server);
 uint16_t control_server_port(const control_server_t *server);
 
 typedef void (*control_server_wake_fn)(void);
 void control_server_set_wake_hook(control_server_t *server, control_server_wake_fn fn);
+
+/* Signal wake when a request is queued or a client connects or disconnects,
+   so the dispatching thread can block instead of polling. Set before
+   start() or while no client is connected. */
+void control_server_set_wake_event(control_server_t *server, wake_event *wake);
+
+/* Advertise a shared-memory region (runtime_shm layout) in capabilities and
+   shm-info. Set before start(); name NULL = none. */
+void control_server_set_shm(control_server_t *server, const char *name, uint64_t size);
@@ -0,0 +1,174 @@
+#include "control_subscription.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+control_subscription *control_subscription_add(
+    control_subscription_table *table,
+    const control_args *args)
+{
+    control_subscription *sub = NULL;
+    size_t i;
+
+    if (table == NULL || args == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+        if (table->subs[i].id == 0u) {
+            sub = &table->subs[i];
+            break;
+        }
+    }
+    if (sub == NULL) {
+        return NULL;
+    }
+    memset(sub, 0, sizeof(*sub));
+    sub->kind = args->subscription_kind;
+    if (sub->kind == CONTROL_SUBSCRIPTION_FRAMES) {
+        sub->every = args->subscription_every != 0u ? args->subscription_every : 1u;
+        sub->format = args->frame_format;
+        sub->encoding = args->frame_encoding;
+    } else {
+        uint32_t k;
+
+        sub->on_frame = args->subscription_on_frame;
+        sub->span_count = args->span_count;
+        memcpy(sub->spans, args->spans, sizeof(sub->spans[0]) * args->span_count);
+        for (k = 0; k < sub->span_count; k++) {
+            sub->total += sub->spans[k].length;
+        }
+        if (sub->span_count == 0u || sub->total == 0u) {
+            return NULL;
+        }
+    }
+    if (++table->next_id == 0u) {
+        table->next_id = 1u;
+    }
+    sub->id = table->next_id;
+    return sub;
+}
+
+static void control_subscription_free(control_subscription *sub)
+{
+    free(sub->sent);
+    memset(sub, 0, sizeof(*sub));
+}
+
+bool control_subscription_remove(control_subscription_table *table, uint32_t id)
+{
+    bool found = false;
+    size_t i;
+
+    if (table == NULL) {
+        return false;
+    }
+    for (i = 0; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+        if (table->subs[i].id != 0u && (id == 0u || table->subs[i].id == id)) {
+            control_subscription_free(&table->subs[i]);
+            found = true;
+        }
+    }
+    return found || id == 0u;
+}
+
+void control_subscription_clear(control_subscription_table *table)
+{
+    (void)control_subscription_remove(table, 0u);
+}
+
+bool control_subscription_any(const control_subscription_table *table)
+{
+    size_t i;
+
+    if (table == NULL) {
+        return false;
+    }
+    for (i = 0; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+        if (table->subs[i].id != 0u) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool control_subscription_frame_due(const control_subscription *sub, uint64_t frame_number)
+{
+    if (sub == NULL || sub->id == 0u || sub->kind != CONTROL_SUBSCRIPTION_FRAMES) {
+        return false;
+    }
+    /* A frame number that went backwards (reset, state load) restarts the count. */
+    return !sub->has_last_frame || frame_number < sub->last_frame ||
+        frame_number - sub->last_frame >= sub->every;
+}
+
+void control_subscription_frame_sent(control_subscription *sub, uint64_t frame_number)
+{
+    if (sub != NULL) {
+        sub->has_last_frame = true;
+        sub->last_frame = frame_number;
+    }
+}
+
+bool control_subscription_memory_diff(
+    const control_subscription *sub,
+    const uint8_t *current,
+    uint64_t *out_mask,
+    uint8_t **out_payload,
+    size_t *out_size)
+{
+    uint64_t mask = 0;
+    size_t size = 0;
+    size_t offset = 0;
+    uint8_t *payload;
+    uint32_t k;
+
+    if (sub == NULL || current == NULL || out_mask == NULL || out_payload == NULL ||
+        out_size == NULL || sub->kind != CONTROL_SUBSCRIPTION_MEMORY) {
+        return false;
+    }
+    *out_payload = NULL;
+    *out_size = 0;
+    for (k = 0; k < sub->span_count; k++) {
+        uint32_t length = sub->spans[k].length;
+        if (sub->sent == NULL || memcmp(sub->sent + offset, current + offset, length) != 0) {
+            mask |= (uint64_t)1u << k;
+            size += length;
+        }
+        offset += length;
+    }
+    if (mask == 0u) {
+        return false;
+    }
+    payload = (uint8_t *)malloc(size);
+    if (payload == NULL) {
+        return false;
+    }
+    size = 0;
+    offset = 0;
+    for (k = 0; k < sub->span_count; k++) {
+        uint32_t length = sub->spans[k].length;
+        if ((mask & ((uint64_t)1u << k)) != 0u) {
+            memcpy(payload + size, current + offset, length);
+            size += length;
+        }
+        offset += length;
+    }
+    *out_mask = mask;
+    *out_payload = payload;
+    *out_size = size;
+    return true;
+}
+
+void control_subscription_memory_sent(control_subscription *sub, const uint8_t *current)
+{
+    if (sub == NULL || current == NULL || sub->kind != CONTROL_SUBSCRIPTION_MEMORY) {
+        return;
+    }
+    if (sub->sent == NULL) {
+        sub->sent = (uint8_t *)malloc(sub->total);
+        if (sub->sent == NULL) {
+            return; /* next check resends every range */
+        }
+    }
+    memcpy(sub->sent, current, sub->total);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "control_protocol.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Push subscriptions of the connected client (subscribe / unsubscribe).
+
+   frames — every Nth published frame, in the subscription's format and
+            encoding; a delta is against the frame this subscription sent
+            last (the first push of a delta subscription goes out as rle).
+   memory — the watched ranges that differ from the copy this subscription
+            sent last (every range on the first push), checked on each frame
+            (on=frame) or on each frame and each paused-time change such as
+            a step, poke, reset or state load (on=change).
+
+   The table only keeps state and computes diffs; the dispatcher decides
+   when to check and posts the events. Host thread only. */
+enum { CONTROL_SUBSCRIPTIONS_MAX = 8 };
+
+typedef struct control_subscription {
+    uint32_t id; /* 0 = free slot */
+    uint8_t kind; /* control_subscription_kind */
+    /* frames */
+    uint32_t every;
+    uint8_t format;
+    uint8_t encoding;
+    bool has_last_frame;
+    uint64_t last_frame;
+    /* memory */
+    bool on_frame;
+    uint32_t span_count;
+    control_memory_span spans[CONTROL_MEMORY_SPANS_MAX];
+    uint32_t total; /* bytes over every span */
+    uint8_t *sent;  /* last copy sent, spans back to back; NULL until then */
+    /* Dispatcher: memory-mirror publish last compared, and whether to keep
+       comparing each new publish until recheck_due_ms. */
+    uint64_t checked_generation;
+    bool recheck;
+    uint64_t recheck_due_ms;
+} control_subscription;
+
+typedef struct control_subscription_table {
+    control_subscription subs[CONTROL_SUBSCRIPTIONS_MAX];
+    uint32_t next_id;
+    uint64_t connection_epoch; /* client the subscriptions belong to */
+} control_subscription_table;
+
+/* New subscription from parsed subscribe args; NULL when the table is full
+   or memory ran out. */
+control_subscription *control_subscription_add(
+    control_subscription_table *table,
+    const control_args *args);
+
+/* Drop one subscription (id 0 = all). False when the id is unknown. */
+bool control_subscription_remove(control_subscription_table *table, uint32_t id);
+void control_subscription_clear(control_subscription_table *table);
+bool control_subscription_any(const control_subscription_table *table);
+
+/* Frame subscriptions: due for frame_number, and the bookkeeping once sent. */
+bool control_subscription_frame_due(const control_subscription *sub, uint64_t frame_number);
+void control_subscription_frame_sent(control_subscription *sub, uint64_t frame_number);
+
+/* Memory subscriptions: current holds the spans back to back. Builds the
+   payload of the ranges that changed (in span order) and a mask of them
+   (bit k = span k). False when nothing changed or memory ran out. The
+   payload is malloc'd; the caller frees it. */
+bool control_subscription_memory_diff(
+    const control_subscription *sub,
+    const uint8_t *current,
+    uint64_t *out_mask,
+    uint8_t **out_payload,
+    size_t *out_size);
+
+/* Remember current as sent, after the push was queued. */
+void control_subscription_memory_sent(control_subscription *sub, const uint8_t *current);
@@ -269,6 +269,8 @@ static void apple2_bus_write(void *user, uint16_t address, uint8_t value)
     }
 
     m->pages.write_pages[page][offset] = value;
+    m->page_write_gen[page]++;
+    apple2_note_ram_store(m, &m->pages.write_pages[page][offset]);
     apple2_report_memory_access(m, APPLE2_MEMORY_ACCESS_WRITE, address, value);
 }
 
@@ -623,6 +625,7 @@ void apple2_shutdown(apple2_t *machine)
 static void apple2_reset_common(apple2_t *machine, bool cold)
 {
     int slot;
+    uint32_t page;
 
     if (machine == NULL || !machine->ready) {
         return;
@@ -640,9 +643,14 @@ static void apple2_reset_common(apple2_t *machine, bool cold)
         memset(machine->ram_main + 0x10000 + 0xC001, 0xA0, 0x0FFE);
         machine->state_flags |= A2S_OPEN_APPLE;
         machine->state_flags &= ~A2S_CLOSED_APPLE;
+        apple2_note_memory_replaced(machine);
     } else {
         /* Warm CTRL+RESET: clear text page; leave most RAM intact. */
         memset(machine->ram_main + 0x0400, 0xA0, 0x400);
+        for (page = 0x04u; page < 0x08u; page++) {
+            machine->page_write_gen[page]++;
+            apple2_note_ram_store(machine, machine->ram_main + page * APPLE2_PAGE_SIZE);
+        }
         machine->state_flags &= ~(A2S_OPEN_APPLE | A2S_CLOSED_APPLE);
     }
 
@@ -686,6 +694,7 @@ void apple2_set_model(apple2_t *machine, apple2_model model)
     }
     machine->model = model;
     apple2_install_roms_for_model(machine);
+    apple2_note_memory_replaced(machine);
     /* SmartPort's slot ROM advertises the host model in byte 7. Preserve
        mounted volumes while refreshing that byte for a live model change. */
     for (slot = 1; slot <= 7; ++slot) {
@@ -714,6 +723,8 @@ void apple2_debug_write(apple2_t *machine, uint16_t address, uint8_t value)
 
     assert(machine != NULL);
     machine->pages.write_pages[page][offset] = value;
+    machine->page_write_gen[page]++;
+    apple2_note_ram_store(machine, &machine->pages.write_pages[page][offset]);
 }
 
 uint8_t apple2_debug_call_stack(
@@ -835,10 +846,12 @@ void apple2_write_in_view(apple2_t *m, view_flags_t vf, uint16_t address, uint8_
     ram = vf_get_ram(vf);
     page = (uint16_t)(address / APPLE2_PAGE_SIZE);
     offset = (uint16_t)(address % APPLE2_PAGE_SIZE);
+    m->page_write_gen[page]++;
 
     if (address >= 0xC000 && address <= 0xC0FF) {
         if (address == 0xC000) {
             m->ram_main[address] = value;
+            apple2_note_ram_store(m, &m->ram_main[address]);
         }
         return;
     }
@@ -848,17 +861,20 @@ void apple2_write_in_view(apple2_t *m, view_flags_t vf, uint16_t address, uint8_
             return;
         }
         m->pages.write_pages[page][offset] = value;
+        apple2_note_ram_store(m, &m->pages.write_pages[page][offset]);
         return;
     }
 
     if (address >= 0xD000) {
         if (ram == A2SEL48K_MAPPED && vf_get_d000(vf) == A2SELD000_MAPPED) {
             m->pages.write_pages[page][offset] = value;
+            apple2_note_ram_store(m, &m->pages.write_pages[page][offset]);
             return;
         }
         switch (vf_get_d000(vf)) {
         case A2SELD000_MAPPED:
             m->pages.write_pages[page][offset] = value;
+            apple2_note_ram_store(m, &m->pages.write_pages[page][offset]);
             return;
         case A2SELD000_ROM:
             return;
@@ -866,28 +882,239 @@ void apple2_write_in_view(apple2_t *m, view_flags_t vf, uint16_t address, uint8_
         case A2SELD000_LC_B2: {
             uint32_t bank_base = (vf_get_d000(vf) == A2SELD000_LC_B2) ? 0x1000u : 0u;
             uint32_t lc_base = (ram == A2SEL48K_AUX) ? 0x4000u : 0u;
-            if (address < 0xE000) {
-                m->ram_lc[lc_base + bank_base + (uint32_t)(address - 0xD000u)] = value;
-                return;
-            }
-            m->ram_lc[lc_base + 0x2000u + (uint32_t)(address - 0xE000u)] = value;
+            uint8_t *dst = address < 0xE000 ?
+                &m->ram_lc[lc_base + bank_base + (uint32_t)(address - 0xD000u)] :
+                &m->ram_lc[lc_base + 0x2000u + (uint32_t)(address - 0xE000u)];
+            *dst = value;
+            apple2_note_ram_store(m, dst);
             return;
         }
         default:
             m->pages.write_pages[page][offset] = value;
+            apple2_note_ram_store(m, &m->pages.write_pages[page][offset]);
             return;
         }
     }
 
     if (ram == A2SEL48K_MAPPED) {
         m->pages.write_pages[page][offset] = value;
+        apple2_note_ram_store(m, &m->pages.write_pages[page][offset]);
         return;
     }
     if (ram == A2SEL48K_MAIN) {
         m->ram_main[address] = value;
+        apple2_note_ram_store(m, &m->ram_main[address]);
         return;
     }
     m->ram_main[(uint32_t)address + 0x10000u] = value;
+    apple2_note_ram_store(m, &m->ram_main[(uint32_t)address + 0x10000u]);
+}
+
+/* Source of one page as seen through vf, or NULL when the page must be read
+   byte by byte (short or missing ROM image keeps the 0xFF fallback exact).
+   Same resolution order as apple2_read_in_view: every address within a page
+   shares one source, so the page resolves to a single span. */
+static const uint8_t *apple2_view_page_source(const apple2_t *m, view_flags_t vf, uint8_t page)
+{
+    uint16_t address = (uint16_t)((uint16_t)page * APPLE2_PAGE_SIZE);
+    a2sel_48k ram = vf_get_ram(vf);
+
+    if (address == 0xC000u) {
+        return m->ram_main + 0xC000u;
+    }
+    if (address >= 0xC100u && address < 0xD000u) {
+        if (vf_get_c100(vf) != A2SELC100_ROM) {
+            return m->pages.read_pages[page];
+        }
+        if (m->rom_c000 != NULL &&
+            m->rom_c000_size >= (size_t)(address - 0xC000u) + APPLE2_PAGE_SIZE) {
+            return m->rom_c000 + (address - 0xC000u);
+        }
+        return NULL;
+    }
+    if (address >= 0xD000u) {
+        a2sel_d000 d000 = vf_get_d000(vf);
+        if (d000 == A2SELD000_ROM) {
+            if (m->rom_d000 != NULL &&
+                m->rom_d000_size >= (size_t)(address - 0xD000u) + APPLE2_PAGE_SIZE) {
+                return m->rom_d000 + (address - 0xD000u);
+            }
+            return NULL;
+        }
+        if (d000 == A2SELD000_LC_B1 || d000 == A2SELD000_LC_B2) {
+            uint32_t bank_base = (d000 == A2SELD000_LC_B2) ? 0x1000u : 0u;
+            uint32_t lc_base = (ram == A2SEL48K_AUX) ? 0x4000u : 0u;
+            return address < 0xE000u ?
+                m->ram_lc + lc_base + bank_base + (uint32_t)(address - 0xD000u) :
+                m->ram_lc + lc_base + 0x2000u + (uint32_t)(address - 0xE000u);
+        }
+        return m->pages.read_pages[page];
+    }
+    if (ram == A2SEL48K_MAPPED) {
+        return m->pages.read_pages[page];
+    }
+    if (ram == A2SEL48K_MAIN) {
+        return m->ram_main + address;
+    }
+    return m->ram_main + (uint32_t)address + 0x10000u;
+}
+
+/* Destination of one page for apple2_write_in_view, or NULL when the page is
+   I/O or write-discarding ROM and must go byte by byte. */
+static uint8_t *apple2_view_page_target(apple2_t *m, view_flags_t vf, uint8_t page)
+{
+    uint16_t address = (uint16_t)((uint16_t)page * APPLE2_PAGE_SIZE);
+    a2sel_48k ram = vf_get_ram(vf);
+
+    if (address == 0xC000u) {
+        return NULL;
+    }
+    if (address >= 0xC100u && address < 0xD000u) {
+        return vf_get_c100(vf) == A2SELC100_ROM ? NULL : m->pages.write_pages[page];
+    }
+    if (address >= 0xD000u) {
+        a2sel_d000 d000 = vf_get_d000(vf);
+        if (ram == A2SEL48K_MAPPED && d000 == A2SELD000_MAPPED) {
+            return m->pages.write_pages[page];
+        }
+        if (d000 == A2SELD000_ROM) {
+            return NULL;
+        }
+        if (d000 == A2SELD000_LC_B1 || d000 == A2SELD000_LC_B2) {
+            uint32_t bank_base = (d000 == A2SELD000_LC_B2) ? 0x1000u : 0u;
+            uint32_t lc_base = (ram == A2SEL48K_AUX) ? 0x4000u : 0u;
+            return address < 0xE000u ?
+                m->ram_lc + lc_base + bank_base + (uint32_t)(address - 0xD000u) :
+                m->ram_lc + lc_base + 0x2000u + (uint32_t)(address - 0xE000u);
+        }
+        return m->pages.write_pages[page];
+    }
+    if (ram == A2SEL48K_MAPPED) {
+        return m->pages.write_pages[page];
+    }
+    if (ram == A2SEL48K_MAIN) {
+        return m->ram_main + address;
+    }
+    return m->ram_main + (uint32_t)address + 0x10000u;
+}
+
+void apple2_copy_page_in_view(
+    const apple2_t *m,
+    view_flags_t vf,
+    uint8_t page,
+    uint8_t out[APPLE2_PAGE_SIZE])
+{
+    const uint8_t *src;
+
+    assert(m != NULL);
+    assert(out != NULL);
+    src = apple2_view_page_source(m, vf, page);
+    if (src != NULL) {
+        memcpy(out, src, APPLE2_PAGE_SIZE);
+        return;
+    }
+    {
+        uint16_t address = (uint16_t)((uint16_t)page * APPLE2_PAGE_SIZE);
+        uint32_t i;
+        for (i = 0; i < APPLE2_PAGE_SIZE; i++) {
+            out[i] = apple2_read_in_view(m, vf, (uint16_t)(address + i));
+        }
+    }
+}
+
+void apple2_copy_in_view(
+    const apple2_t *m,
+    view_flags_t vf,
+    uint16_t address,
+    uint8_t *out,
+    uint32_t length)
+{
+    uint32_t done = 0;
+
+    assert(m != NULL);
+    assert(out != NULL || length == 0u);
+    assert(length <= 0x10000u);
+    while (done < length) {
+        uint16_t at = (uint16_t)(address + done);
+        uint8_t page = (uint8_t)(at / APPLE2_PAGE_SIZE);
+        uint32_t offset = at % APPLE2_PAGE_SIZE;
+        uint32_t chunk = APPLE2_PAGE_SIZE - offset;
+        const uint8_t *src = apple2_view_page_source(m, vf, page);
+
+        if (chunk > length - done) {
+            chunk = length - done;
+        }
+        if (src != NULL) {
+            memcpy(out + done, src + offset, chunk);
+        } else {
+            uint32_t i;
+            for (i = 0; i < chunk; i++) {
+                out[done + i] = apple2_read_in_view(m, vf, (uint16_t)(at + i));
+            }
+        }
+        done += chunk;
+    }
+}
+
+void apple2_store_in_view(
+    apple2_t *m,
+    view_flags_t vf,
+    uint16_t address,
+    const uint8_t *bytes,
+    uint32_t length)
+{
+    uint32_t done = 0;
+
+    assert(m != NULL);
+    assert(bytes != NULL || length == 0u);
+    assert(length <= 0x10000u);
+    while (done < length) {
+        uint16_t at = (uint16_t)(address + done);
+        uint8_t page = (uint8_t)(at / APPLE2_PAGE_SIZE);
+        uint32_t offset = at % APPLE2_PAGE_SIZE;
+        uint32_t chunk = APPLE2_PAGE_SIZE - offset;
+        uint8_t *dst = apple2_view_page_target(m, vf, page);
+
+        if (chunk > length - done) {
+            chunk = length - done;
+        }
+        if (dst != NULL) {
+            memcpy(dst + offset, bytes + done, chunk);
+            m->page_write_gen[page]++;
+            apple2_note_ram_store(m, dst);
+        } else {
+            uint32_t i;
+            for (i = 0; i < chunk; i++) {
+                apple2_write_in_view(m, vf, (uint16_t)(at + i), bytes[done + i]);
+            }
+        }
+        done += chunk;
+    }
+}
+
+void apple2_note_memory_replaced(apple2_t *machine)
+{
+    if (machine != NULL) {
+        machine->memory_epoch++;
+    }
+}
+
+void apple2_note_ram_store(apple2_t *machine, const uint8_t *at)
+{
+    uintptr_t host = (uintptr_t)at;
+    uintptr_t main_base = (uintptr_t)machine->ram_main;
+    uintptr_t lc_base = (uintptr_t)machine->ram_lc;
+    uint32_t page;
+
+    if (host - main_base < APPLE2_RAM_MAIN_SIZE) {
+        page = (uint32_t)((host - main_base) / APPLE2_PAGE_SIZE);
+    } else if (machine->ram_lc != NULL && host - lc_base < APPLE2_RAM_LC_SIZE) {
+        page = (uint32_t)(APPLE2_RAM_MAIN_SIZE / APPLE2_PAGE_SIZE +
+                          (host - lc_base) / APPLE2_PAGE_SIZE);
+    } else {
+        return;
+    }
+    machine->ram_dirty[page / 32u] |= 1u << (page % 32u);
 }
 
 void apple2_load(apple2_t *machine, uint16_t address, const uint8_t *bytes, size_t length)
@@ -906,6 +1133,8 @@ void apple2_set_key(apple2_t *machine, uint8_t key_with_strobe)
         return;
     }
     machine->ram_main[SS_KBD] = key_with_strobe;
+    machine->page_write_gen[SS_KBD / APPLE2_PAGE_SIZE]++;
+    apple2_note_ram_store(machine, &machine->ram_main[SS_KBD]);
     machine->key_held = key_with_strobe;
     machine->state_flags |= A2S_KEY_HELD;
 }
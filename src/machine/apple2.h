@@ -22,6 +22,9 @@
 #define APPLE2_RAM_MAIN_SIZE (128u * 1024u)
 /* 16K LC × 2 (main/aux) = 32K as in a2m. */
 #define APPLE2_RAM_LC_SIZE (32u * 1024u)
+/* Physical RAM pages: ram_main then ram_lc, as indexed by ram_dirty. */
+#define APPLE2_RAM_PAGES ((APPLE2_RAM_MAIN_SIZE + APPLE2_RAM_LC_SIZE) / APPLE2_PAGE_SIZE)
+#define APPLE2_RAM_DIRTY_WORDS (APPLE2_RAM_PAGES / 32u)
 
 typedef enum {
     APPLE2_MODEL_II_PLUS = 0,
@@ -153,6 +156,15 @@ typedef struct apple2 {
     /* Last-writer PC pack per logical address (debugger annotation, not BP).
        Each write shifts prior PCs left 16 and ORs the current opcode_pc. */
     uint64_t *write_history; /* 65536 entries when allocated */
+
+    /* Change tracking for debug snapshots. page_write_gen[page] ticks on every
+       store through any write path; memory_epoch ticks when RAM or ROM images
+       change wholesale (cold reset, model change, snapshot load). */
+    uint32_t page_write_gen[APPLE2_NUM_PAGES];
+    uint32_t memory_epoch;
+    /* Physical RAM pages (APPLE2_RAM_PAGES bits) stored to since the
+       checkpoint chain last cleared them; see apple2_checkpoint_take. */
+    uint32_t ram_dirty[APPLE2_RAM_DIRTY_WORDS];
 } apple2_t;
 
 bool apple2_init(apple2_t *machine);
@@ -200,6 +212,34 @@ uint8_t apple2_debug_call_stack(
 /* Debug R/W with a2m VIEW_FLAGS banking (Map / Main / Aux / LC / ROM). */
 uint8_t apple2_read_in_view(const apple2_t *machine, view_flags_t vf, uint16_t address);
 void apple2_write_in_view(apple2_t *machine, view_flags_t vf, uint16_t address, uint8_t value);
+/* Copy one 256-byte page as seen through vf; byte-identical to calling
+   apple2_read_in_view for each address but resolved once per page. */
+void apple2_copy_page_in_view(
+    const apple2_t *machine,
+    view_flags_t vf,
+    uint8_t page,
+    uint8_t out[APPLE2_PAGE_SIZE]);
+/* Span forms of apple2_read_in_view / apple2_write_in_view: length bytes
+   (at most 65536, wrapping at $FFFF), resolved once per page and copied with
+   memcpy. Same bytes and I/O / ROM rules as the per-byte calls; a store ticks
+   the write generation of every page it touches. */
+void apple2_copy_in_view(
+    const apple2_t *machine,
+    view_flags_t vf,
+    uint16_t address,
+    uint8_t *out,
+    uint32_t length);
+void apple2_store_in_view(
+    apple2_t *machine,
+    view_flags_t vf,
+    uint16_t address,
+    const uint8_t *bytes,
+    uint32_t length);
+/* Bump memory_epoch after bulk RAM/ROM edits that bypass the write paths. */
+void apple2_note_memory_replaced(apple2_t *machine);
+/* Set the ram_dirty bit of the physical page holding host byte at; no-op when
+   at is not inside ram_main / ram_lc (ROM sink, slot ROM). */
+void apple2_note_ram_store(apple2_t *machine, const uint8_t *at);
 
 void apple2_load(apple2_t *machine, uint16_t address, const uint8_t *bytes, size_t length);
 
@@ -44,7 +44,10 @@ enum {
     TAG_SLOT = A2_SNAPSHOT_TAG('S', 'L', 'O', 'T'),
     TAG_DSKs = A2_SNAPSHOT_TAG('D', 'S', 'K', 's'),
     TAG_SPrt = A2_SNAPSHOT_TAG('S', 'P', 'r', 't'),
-    TAG_MBrd = A2_SNAPSHOT_TAG('M', 'B', 'r', 'd')
+    TAG_MBrd = A2_SNAPSHOT_TAG('M', 'B', 'r', 'd'),
+    /* Checkpoint-only chunks: device state without media paths. */
+    TAG_DSKm = A2_SNAPSHOT_TAG('D', 'S', 'K', 'm'),
+    TAG_SPst = A2_SNAPSHOT_TAG('S', 'P', 's', 't')
 };
 
 typedef struct snapshot_writer {
@@ -1055,6 +1058,35 @@ static void read_drive_mech(snapshot_reader *r, DISKII_DRIVE *dd)
     dd->image_index = r_i32(r);
 }
 
+/* Mechanical state onto a mounted drive (mount randomizes the head). */
+static void restore_drive_mech(DISKII_DRIVE *dd, const DISKII_DRIVE *mech)
+{
+    dd->motor_event_cycles = mech->motor_event_cycles;
+    dd->motor_off_delay_cycles = mech->motor_off_delay_cycles;
+    dd->motor_rpm = mech->motor_rpm;
+    dd->motor_on = mech->motor_on;
+    dd->head_event_cycles = mech->head_event_cycles;
+    dd->phase_mask = mech->phase_mask;
+    dd->last_on_phase_mask = mech->last_on_phase_mask;
+    dd->quarter_track_pos = mech->quarter_track_pos;
+    dd->head_settle_cycles = mech->head_settle_cycles;
+    dd->q6 = mech->q6;
+    dd->q7 = mech->q7;
+    dd->sensor_protect = mech->sensor_protect;
+    dd->q6_last_read_cycles = mech->q6_last_read_cycles;
+    dd->read_latch = mech->read_latch;
+    dd->write_latch = mech->write_latch;
+    dd->write_latch_valid = mech->write_latch_valid;
+    /* Do not resume an in-progress write from snapshot. */
+    dd->write_active = 0;
+    dd->write_track = 0;
+    dd->write_start_pos = 0;
+    dd->write_byte_count = 0;
+    if (dd->active_image != NULL) {
+        image_head_position(dd->active_image, (uint32_t)dd->quarter_track_pos);
+    }
+}
+
 static bool apply_dsks(apple2_t *m, const uint8_t *p, size_t len)
 {
     snapshot_reader r;
@@ -1140,30 +1172,7 @@ static bool apply_dsks(apple2_t *m, const uint8_t *p, size_t len)
                     }
                 }
             }
-            dd->motor_event_cycles = mech.motor_event_cycles;
-            dd->motor_off_delay_cycles = mech.motor_off_delay_cycles;
-            dd->motor_rpm = mech.motor_rpm;
-            dd->motor_on = mech.motor_on;
-            dd->head_event_cycles = mech.head_event_cycles;
-            dd->phase_mask = mech.phase_mask;
-            dd->last_on_phase_mask = mech.last_on_phase_mask;
-            dd->quarter_track_pos = mech.quarter_track_pos;
-            dd->head_settle_cycles = mech.head_settle_cycles;
-            dd->q6 = mech.q6;
-            dd->q7 = mech.q7;
-            dd->sensor_protect = mech.sensor_protect;
-            dd->q6_last_read_cycles = mech.q6_last_read_cycles;
-            dd->read_latch = mech.read_latch;
-            dd->write_latch = mech.write_latch;
-            dd->write_latch_valid = mech.write_latch_valid;
-            /* Do not resume an in-progress write from snapshot. */
-            dd->write_active = 0;
-            dd->write_track = 0;
-            dd->write_start_pos = 0;
-            dd->write_byte_count = 0;
-            if (dd->active_image != NULL) {
-                image_head_position(dd->active_image, (uint32_t)dd->quarter_track_pos);
-            }
+            restore_drive_mech(dd, &mech);
         }
     }
     return r.ok;
@@ -1393,8 +1402,590 @@ bool apple2_snapshot_load(apple2_t *m, const uint8_t *in, size_t in_len)
     }
 
     softswitch_apply_full_map(m);
+    apple2_note_memory_replaced(m);
     if (m->video.fb != NULL) {
         apple2_video_paint_full_frame(m);
     }
     return true;
 }
+
+/* ---- In-memory checkpoints ---------------------------------------------- */
+
+enum {
+    A2_CHECKPOINT_MAIN_PAGES = APPLE2_RAM_MAIN_SIZE / APPLE2_PAGE_SIZE,
+    /* Every so many checkpoints one stores all of RAM, so a restore walks
+       back at most this far. */
+    A2_CHECKPOINT_FULL_EVERY = 32
+};
+
+typedef struct apple2_checkpoint {
+    uint64_t cycle;
+    uint64_t frame_number;
+    uint32_t page_count;
+    bool input; /* apple2_checkpoint_note_input since this one */
+    uint64_t input_cycle;
+    size_t state_len;
+    size_t block_size;
+    uint16_t *pages;    /* physical page numbers, ascending */
+    uint8_t *page_data; /* page_count pages, same order */
+    uint8_t *state;     /* device chunks */
+} apple2_checkpoint;
+
+struct apple2_checkpoint_chain {
+    uint8_t *base; /* APPLE2_RAM_PAGES pages as they were before items[0] */
+    apple2_checkpoint **items;
+    size_t count;
+    size_t capacity;
+    size_t bytes;
+    uint32_t memory_epoch;
+    apple2_model model;
+    uint8_t slot_type[8];
+    uint8_t diskii_present[8];
+};
+
+static uint8_t *checkpoint_ram_page(apple2_t *m, uint32_t page)
+{
+    if (page < A2_CHECKPOINT_MAIN_PAGES) {
+        return m->ram_main + (size_t)page * APPLE2_PAGE_SIZE;
+    }
+    return m->ram_lc + (size_t)(page - A2_CHECKPOINT_MAIN_PAGES) * APPLE2_PAGE_SIZE;
+}
+
+static bool checkpoint_page_dirty(const apple2_t *m, uint32_t page)
+{
+    return (m->ram_dirty[page / 32u] & (1u << (page % 32u))) != 0u;
+}
+
+/* Checkpoint form of DSKs: drive mechanics only; mounts stay as they are. */
+static void write_dskm(snapshot_writer *w, const apple2_t *m)
+{
+    size_t chunk;
+    int slot;
+    int drive;
+
+    begin_chunk(w, TAG_DSKm, &chunk);
+    for (slot = 1; slot <= 7; ++slot) {
+        if (!m->diskii_present[slot] && m->slot_type[slot] != SLOT_TYPE_DISKII) {
+            continue;
+        }
+        w_u8(w, (uint8_t)slot);
+        w_u8(w, m->diskii_controller[slot].active);
+        w_u64(w, m->diskii_controller[slot].cycles_at_update);
+        for (drive = 0; drive < 2; ++drive) {
+            write_drive_mech(w, &m->diskii_controller[slot].diskii_drive[drive]);
+        }
+    }
+    w_u8(w, 0);
+    end_chunk(w, chunk);
+}
+
+/* Checkpoint form of SPrt: controller state without the unit paths. */
+static void write_spst(snapshot_writer *w, const apple2_t *m)
+{
+    size_t chunk;
+    int slot;
+
+    begin_chunk(w, TAG_SPst, &chunk);
+    for (slot = 1; slot <= 7; ++slot) {
+        if (m->slot_type[slot] != SLOT_TYPE_SMARTPORT) {
+            continue;
+        }
+        w_u8(w, (uint8_t)slot);
+        w_u8(w, m->sp_device[slot].sp_status);
+        w_u64(w, (uint64_t)m->sp_device[slot].sp_read_offset);
+        w_u64(w, (uint64_t)m->sp_device[slot].sp_write_offset);
+        w_bytes(w, m->sp_device[slot].sp_buffer, sizeof(m->sp_device[slot].sp_buffer));
+    }
+    w_u8(w, 0);
+    end_chunk(w, chunk);
+}
+
+static void write_checkpoint_state(snapshot_writer *w, const apple2_t *m)
+{
+    write_cpu(w, m);
+    write_soft(w, m);
+    write_vid(w, m);
+    write_dskm(w, m);
+    write_spst(w, m);
+    write_mbrd(w, m);
+}
+
+static bool apply_dskm(apple2_t *m, const uint8_t *p, size_t len)
+{
+    snapshot_reader r;
+
+    memset(&r, 0, sizeof(r));
+    r.data = p;
+    r.len = len;
+    r.ok = true;
+    for (;;) {
+        uint8_t slot = r_u8(&r);
+        int drive;
+
+        if (!r.ok || slot == 0) {
+            break;
+        }
+        if (slot > 7 || !m->diskii_present[slot]) {
+            return false;
+        }
+        m->diskii_controller[slot].active = r_u8(&r);
+        m->diskii_controller[slot].cycles_at_update = r_u64(&r);
+        for (drive = 0; drive < 2; ++drive) {
+            DISKII_DRIVE *dd = &m->diskii_controller[slot].diskii_drive[drive];
+            DISKII_DRIVE mech;
+
+            memset(&mech, 0, sizeof(mech));
+            read_drive_mech(&r, &mech);
+            if (!r.ok) {
+                return false;
+            }
+            /* Media is not rewound; close out a write begun after the
+               checkpoint instead of dropping it. */
+            if (dd->write_active) {
+                (void)image_finish_write(dd);
+                dd->write_active = 0;
+            }
+            /* Media is not rewound either: an image that will not mount
+               leaves the drive on the one it has. */
+            if (mech.image_index >= 0 && mech.image_index < (int)dd->images.items &&
+                mech.image_index != dd->image_index) {
+                (void)diskii_mount_image(m, slot, drive, mech.image_index);
+            }
+            restore_drive_mech(dd, &mech);
+        }
+    }
+    return r.ok;
+}
+
+static bool apply_spst(apple2_t *m, const uint8_t *p, size_t len)
+{
+    snapshot_reader r;
+
+    memset(&r, 0, sizeof(r));
+    r.data = p;
+    r.len = len;
+    r.ok = true;
+    for (;;) {
+        uint8_t slot = r_u8(&r);
+        SP_DEVICE *sp;
+
+        if (!r.ok || slot == 0) {
+            break;
+        }
+        if (slot > 7 || m->slot_type[slot] != SLOT_TYPE_SMARTPORT) {
+            return false;
+        }
+        sp = &m->sp_device[slot];
+        sp->sp_status = r_u8(&r);
+        sp->sp_read_offset = (size_t)r_u64(&r);
+        sp->sp_write_offset = (size_t)r_u64(&r);
+        r_bytes(&r, sp->sp_buffer, sizeof(sp->sp_buffer));
+    }
+    return r.ok;
+}
+
+static bool apply_checkpoint_state(apple2_t *m, const uint8_t *p, size_t len)
+{
+    snapshot_reader r;
+
+    memset(&r, 0, sizeof(r));
+    r.data = p;
+    r.len = len;
+    r.ok = true;
+    while (r.ok && r.pos + 8 <= r.len) {
+        uint32_t tag = r_u32(&r);
+        uint32_t clen = r_u32(&r);
+        const uint8_t *payload;
+        bool ok;
+
+        if (!r.ok || r.pos + clen > r.len) {
+            return false;
+        }
+        payload = r.data + r.pos;
+        r.pos += clen;
+        switch (tag) {
+        case TAG_CPU_:
+            ok = apply_cpu(m, payload, clen);
+            break;
+        case TAG_SOFT:
+            ok = apply_soft(m, payload, clen);
+            break;
+        case TAG_VID_:
+            ok = apply_vid(m, payload, clen);
+            break;
+        case TAG_DSKm:
+            ok = apply_dskm(m, payload, clen);
+            break;
+        case TAG_SPst:
+            ok = apply_spst(m, payload, clen);
+            break;
+        case TAG_MBrd:
+            ok = apply_mbrd(m, payload, clen);
+            break;
+        default:
+            ok = false;
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return r.ok && r.pos == r.len;
+}
+
+/* Whether a checkpoint's device chunks apply to m without failing part way:
+   the same chunks at the same sizes m writes now, so every field parses and
+   (with checkpoint_config_matches) every slot they name is there. */
+static bool checkpoint_state_applies(const apple2_t *m, const uint8_t *p, size_t len)
+{
+    snapshot_writer w;
+    snapshot_reader r;
+    snapshot_reader now;
+    uint8_t *expect = (uint8_t *)malloc(len > 0 ? len : 1u);
+    bool ok;
+
+    if (expect == NULL) {
+        return false;
+    }
+    memset(&w, 0, sizeof(w));
+    w.out = expect;
+    w.cap = len;
+    w.ok = true;
+    write_checkpoint_state(&w, m);
+    ok = w.ok && w.pos == len;
+
+    memset(&r, 0, sizeof(r));
+    r.data = p;
+    r.len = len;
+    r.ok = true;
+    now = r;
+    now.data = expect;
+    while (ok && r.pos + 8 <= r.len) {
+        uint32_t tag = r_u32(&r);
+        uint32_t clen = r_u32(&r);
+
+        ok = r.ok && tag == r_u32(&now) && clen == r_u32(&now) && r.pos + clen <= r.len;
+        r.pos += clen;
+        now.pos += clen;
+    }
+    free(expect);
+    return ok && r.pos == r.len;
+}
+
+static bool checkpoint_config_matches(const apple2_checkpoint_chain *chain, const apple2_t *m)
+{
+    int slot;
+
+    if (chain->model != m->model) {
+        return false;
+    }
+    for (slot = 0; slot < 8; ++slot) {
+        if (chain->slot_type[slot] != (uint8_t)m->slot_type[slot] ||
+            chain->diskii_present[slot] != m->diskii_present[slot]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void checkpoint_record_config(apple2_checkpoint_chain *chain, const apple2_t *m)
+{
+    int slot;
+
+    chain->model = m->model;
+    for (slot = 0; slot < 8; ++slot) {
+        chain->slot_type[slot] = (uint8_t)m->slot_type[slot];
+        chain->diskii_present[slot] = m->diskii_present[slot];
+    }
+}
+
+/* Whether none of the newest A2_CHECKPOINT_FULL_EVERY - 1 checkpoints holds
+   all of RAM (the base counts when it is that close). */
+static bool checkpoint_full_due(const apple2_checkpoint_chain *chain)
+{
+    size_t i;
+
+    if (chain->count < A2_CHECKPOINT_FULL_EVERY - 1u) {
+        return false;
+    }
+    for (i = 0; i < A2_CHECKPOINT_FULL_EVERY - 1u; i++) {
+        if (chain->items[chain->count - 1u - i]->page_count == APPLE2_RAM_PAGES) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void checkpoint_free_from(apple2_checkpoint_chain *chain, size_t first)
+{
+    while (chain->count > first) {
+        apple2_checkpoint *cp = chain->items[--chain->count];
+        chain->bytes -= cp->block_size;
+        free(cp);
+    }
+}
+
+apple2_checkpoint_chain *apple2_checkpoint_chain_create(void)
+{
+    apple2_checkpoint_chain *chain =
+        (apple2_checkpoint_chain *)calloc(1, sizeof(*chain));
+
+    if (chain == NULL) {
+        return NULL;
+    }
+    chain->base = (uint8_t *)malloc((size_t)APPLE2_RAM_PAGES * APPLE2_PAGE_SIZE);
+    if (chain->base == NULL) {
+        free(chain);
+        return NULL;
+    }
+    return chain;
+}
+
+void apple2_checkpoint_chain_destroy(apple2_checkpoint_chain *chain)
+{
+    if (chain == NULL) {
+        return;
+    }
+    checkpoint_free_from(chain, 0);
+    free(chain->items);
+    free(chain->base);
+    free(chain);
+}
+
+void apple2_checkpoint_clear(apple2_checkpoint_chain *chain)
+{
+    if (chain != NULL) {
+        checkpoint_free_from(chain, 0);
+    }
+}
+
+bool apple2_checkpoint_take(apple2_checkpoint_chain *chain, apple2_t *m)
+{
+    snapshot_writer w;
+    apple2_checkpoint *cp;
+    uint32_t page_count = 0;
+    uint32_t page;
+    size_t state_len;
+    size_t block_size;
+    bool all_pages;
+
+    if (chain == NULL || m == NULL || m->ram_main == NULL || m->ram_lc == NULL) {
+        return false;
+    }
+    if (chain->count > 0 && !checkpoint_config_matches(chain, m)) {
+        checkpoint_free_from(chain, 0);
+    }
+    /* A bulk edit (cold reset, snapshot load) bypassed the dirty bits. */
+    all_pages = chain->count > 0 &&
+        (chain->memory_epoch != m->memory_epoch || checkpoint_full_due(chain));
+    if (chain->count > 0) {
+        for (page = 0; page < APPLE2_RAM_PAGES; page++) {
+            if (all_pages || checkpoint_page_dirty(m, page)) {
+                page_count++;
+            }
+        }
+    }
+
+    memset(&w, 0, sizeof(w));
+    w.cap = (size_t)-1;
+    w.ok = true;
+    write_checkpoint_state(&w, m);
+    if (!w.ok) {
+        return false;
+    }
+    state_len = w.pos;
+
+    if (chain->count == chain->capacity) {
+        size_t capacity = chain->capacity ? chain->capacity * 2u : 64u;
+        apple2_checkpoint **items = (apple2_checkpoint **)realloc(
+            chain->items, capacity * sizeof(*items));
+        if (items == NULL) {
+            return false;
+        }
+        chain->items = items;
+        chain->capacity = capacity;
+    }
+    block_size = sizeof(*cp) + (size_t)page_count * sizeof(uint16_t) +
+        (size_t)page_count * APPLE2_PAGE_SIZE + state_len;
+    cp = (apple2_checkpoint *)malloc(block_size);
+    if (cp == NULL) {
+        return false;
+    }
+    cp->cycle = m->cpu.cpu.cycles;
+    cp->frame_number = m->video.frame_number;
+    cp->page_count = page_count;
+    cp->input = false;
+    cp->input_cycle = 0;
+    cp->state_len = state_len;
+    cp->block_size = block_size;
+    cp->pages = (uint16_t *)(cp + 1);
+    cp->page_data = (uint8_t *)(cp->pages + page_count);
+    cp->state = cp->page_data + (size_t)page_count * APPLE2_PAGE_SIZE;
+
+    if (chain->count == 0) {
+        memcpy(chain->base, m->ram_main, APPLE2_RAM_MAIN_SIZE);
+        memcpy(chain->base + APPLE2_RAM_MAIN_SIZE, m->ram_lc, APPLE2_RAM_LC_SIZE);
+        checkpoint_record_config(chain, m);
+    } else {
+        uint32_t n = 0;
+        for (page = 0; page < APPLE2_RAM_PAGES; page++) {
+            if (all_pages || checkpoint_page_dirty(m, page)) {
+                cp->pages[n] = (uint16_t)page;
+                memcpy(cp->page_data + (size_t)n * APPLE2_PAGE_SIZE,
+                       checkpoint_ram_page(m, page), APPLE2_PAGE_SIZE);
+                n++;
+            }
+        }
+    }
+
+    memset(&w, 0, sizeof(w));
+    w.out = cp->state;
+    w.cap = state_len;
+    w.ok = true;
+    write_checkpoint_state(&w, m);
+    if (!w.ok || w.pos != state_len) {
+        free(cp);
+        return false;
+    }
+
+    memset(m->ram_dirty, 0, sizeof(m->ram_dirty));
+    chain->memory_epoch = m->memory_epoch;
+    chain->items[chain->count++] = cp;
+    chain->bytes += block_size;
+    return true;
+}
+
+bool apple2_checkpoint_restore(apple2_checkpoint_chain *chain, apple2_t *m, size_t index)
+{
+    if (!apple2_checkpoint_restore_keep(chain, m, index)) {
+        return false;
+    }
+    /* Later checkpoints record pages relative to ones being replaced. */
+    checkpoint_free_from(chain, index + 1u);
+    chain->items[index]->input = false;
+    return true;
+}
+
+bool apple2_checkpoint_restore_keep(apple2_checkpoint_chain *chain, apple2_t *m, size_t index)
+{
+    uint32_t done[APPLE2_RAM_DIRTY_WORDS];
+    uint32_t left = APPLE2_RAM_PAGES;
+    uint32_t page;
+    size_t i;
+
+    if (chain == NULL || m == NULL || m->ram_main == NULL || m->ram_lc == NULL ||
+        index >= chain->count || !checkpoint_config_matches(chain, m) ||
+        !checkpoint_state_applies(m, chain->items[index]->state, chain->items[index]->state_len)) {
+        return false;
+    }
+
+    apple2_paste_cancel(m);
+    if (m->write_history != NULL) {
+        memset(m->write_history, 0, APPLE2_ADDR_SPACE * sizeof(uint64_t));
+    }
+    /* Newest first: each page comes from the latest checkpoint that stored
+       it, so the walk ends at the first full image and copies a page once. */
+    memset(done, 0, sizeof(done));
+    for (i = index + 1u; i > 0 && left > 0; i--) {
+        const apple2_checkpoint *cp = chain->items[i - 1u];
+        uint32_t n;
+        for (n = 0; n < cp->page_count; n++) {
+            const uint32_t page = cp->pages[n];
+            if ((done[page / 32u] & (1u << (page % 32u))) == 0u) {
+                done[page / 32u] |= 1u << (page % 32u);
+                memcpy(checkpoint_ram_page(m, page),
+                       cp->page_data + (size_t)n * APPLE2_PAGE_SIZE, APPLE2_PAGE_SIZE);
+                left--;
+            }
+        }
+    }
+    for (page = 0; page < APPLE2_RAM_PAGES && left > 0; page++) {
+        if ((done[page / 32u] & (1u << (page % 32u))) == 0u) {
+            memcpy(checkpoint_ram_page(m, page),
+                   chain->base + (size_t)page * APPLE2_PAGE_SIZE, APPLE2_PAGE_SIZE);
+            left--;
+        }
+    }
+    if (!apply_checkpoint_state(m, chain->items[index]->state, chain->items[index]->state_len)) {
+        return false;
+    }
+
+    softswitch_apply_full_map(m);
+    apple2_note_memory_replaced(m);
+    memset(m->ram_dirty, 0, sizeof(m->ram_dirty));
+    chain->memory_epoch = m->memory_epoch;
+    if (m->video.fb != NULL) {
+        apple2_video_paint_full_frame(m);
+    }
+    return true;
+}
+
+void apple2_checkpoint_note_input(apple2_checkpoint_chain *chain, uint64_t cycle)
+{
+    apple2_checkpoint *cp;
+
+    if (chain == NULL || chain->count == 0) {
+        return;
+    }
+    cp = chain->items[chain->count - 1u];
+    if (!cp->input) {
+        cp->input = true;
+        cp->input_cycle = cycle;
+    }
+}
+
+void apple2_checkpoint_truncate(apple2_checkpoint_chain *chain, size_t count)
+{
+    if (chain != NULL) {
+        checkpoint_free_from(chain, count);
+    }
+}
+
+void apple2_checkpoint_drop_oldest(apple2_checkpoint_chain *chain)
+{
+    apple2_checkpoint *cp;
+    uint32_t n;
+
+    if (chain == NULL || chain->count == 0) {
+        return;
+    }
+    cp = chain->items[0];
+    for (n = 0; n < cp->page_count; n++) {
+        memcpy(chain->base + (size_t)cp->pages[n] * APPLE2_PAGE_SIZE,
+               cp->page_data + (size_t)n * APPLE2_PAGE_SIZE, APPLE2_PAGE_SIZE);
+    }
+    chain->bytes -= cp->block_size;
+    free(cp);
+    chain->count--;
+    memmove(chain->items, chain->items + 1, chain->count * sizeof(*chain->items));
+}
+
+size_t apple2_checkpoint_count(const apple2_checkpoint_chain *chain)
+{
+    return chain != NULL ? chain->count : 0u;
+}
+
+size_t apple2_checkpoint_bytes(const apple2_checkpoint_chain *chain)
+{
+    return chain != NULL ? chain->bytes : 0u;
+}
+
+bool apple2_checkpoint_get_info(
+    const apple2_checkpoint_chain *chain,
+    size_t index,
+    apple2_checkpoint_info *out)
+{
+    const apple2_checkpoint *cp;
+
+    if (chain == NULL || out == NULL || index >= chain->count) {
+        return false;
+    }
+    cp = chain->items[index];
+    out->cycle = cp->cycle;
+    out->frame_number = cp->frame_number;
+    out->page_count = cp->page_count;
+    out->bytes = cp->block_size;
+    out->input = cp->input;
+    out->input_cycle = cp->input_cycle;
+    return true;
+}
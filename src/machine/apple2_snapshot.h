@@ -37,3 +37,63 @@ bool apple2_snapshot_load(apple2_t *m, const uint8_t *in, size_t in_len);
 /* Flush dirty file-backed Disk II images (call before save). Returns false if
    a dirty image could not be flushed. Mutates media only (not CPU/RAM). */
 bool apple2_snapshot_flush_media(apple2_t *m);
+
+/*
+ * In-memory checkpoint chain for rewind and retry loops. The chain keeps one
+ * base RAM image; each checkpoint records the 256-byte physical RAM pages
+ * stored to since the one before (apple2_t.ram_dirty) and the device chunks
+ * (CPU, soft switches, video, Disk II mechanics, SmartPort controller,
+ * Mockingboard). A per-frame checkpoint costs the pages the frame wrote plus
+ * about a kilobyte, not a full snapshot. Every 32nd stores all of RAM so a
+ * restore reads at most that many back, newest first.
+ *
+ * Media is not part of a checkpoint: mounts and disk contents stay as they
+ * are across a restore. A model or slot-card change starts the chain over
+ * on the next take, and restore refuses a machine configured differently.
+ * Neither is host input: the owner reports it (apple2_checkpoint_note_input)
+ * so a replay from a checkpoint can stop short of it.
+ * The chain clears ram_dirty, so use one chain per machine. Worker only.
+ */
+typedef struct apple2_checkpoint_chain apple2_checkpoint_chain;
+
+typedef struct apple2_checkpoint_info {
+    uint64_t cycle;
+    uint64_t frame_number;
+    uint32_t page_count; /* RAM pages stored in this checkpoint */
+    size_t bytes;        /* heap held by this checkpoint */
+    bool input;          /* host input noted since, first at input_cycle */
+    uint64_t input_cycle;
+} apple2_checkpoint_info;
+
+apple2_checkpoint_chain *apple2_checkpoint_chain_create(void);
+void apple2_checkpoint_chain_destroy(apple2_checkpoint_chain *chain);
+/* Drop every checkpoint; the next take re-bases the chain. */
+void apple2_checkpoint_clear(apple2_checkpoint_chain *chain);
+/* Append a checkpoint of m and clear its dirty bits. False when out of
+   memory (the chain is unchanged). */
+bool apple2_checkpoint_take(apple2_checkpoint_chain *chain, apple2_t *m);
+/* Put m back to checkpoint index (0 = oldest) and drop every newer one, with
+   the input noted since it (the machine goes on from there anew). Rebuilds
+   banking and repaints like apple2_snapshot_load; clears write_history and
+   any paste. The device record is checked before anything is written, so
+   false leaves m as it was. */
+bool apple2_checkpoint_restore(apple2_checkpoint_chain *chain, apple2_t *m, size_t index);
+/* Restore without dropping newer checkpoints, for searches that restore
+   several in turn. A take appends relative to the last restore: truncate to
+   index + 1 before taking. */
+bool apple2_checkpoint_restore_keep(apple2_checkpoint_chain *chain, apple2_t *m, size_t index);
+/* The machine was changed from outside at cycle (a key, a paste, a poke):
+   re-running from the newest checkpoint repeats it only up to there. The
+   first such cycle since each checkpoint is kept. */
+void apple2_checkpoint_note_input(apple2_checkpoint_chain *chain, uint64_t cycle);
+/* Keep the oldest count checkpoints. */
+void apple2_checkpoint_truncate(apple2_checkpoint_chain *chain, size_t count);
+/* Fold the oldest checkpoint into the base image (memory budget trimming). */
+void apple2_checkpoint_drop_oldest(apple2_checkpoint_chain *chain);
+size_t apple2_checkpoint_count(const apple2_checkpoint_chain *chain);
+/* Heap held by checkpoints, excluding the fixed base image. */
+size_t apple2_checkpoint_bytes(const apple2_checkpoint_chain *chain);
+bool apple2_checkpoint_get_info(
+    const apple2_checkpoint_chain *chain,
+    size_t index,
+    apple2_checkpoint_info *out);
@@ -17,6 +17,8 @@
 /* Preprocessor-visible so #if / static asserts can catch drift. */
 #define DISPLAY_FRAME_WIDTH  560
 #define DISPLAY_FRAME_HEIGHT 192
+/* Entries in the palette that travels with an indexed (8-bit) frame. */
+#define DISPLAY_FRAME_PALETTE_SIZE 16
 
 #if DISPLAY_FRAME_WIDTH != 560 || DISPLAY_FRAME_HEIGHT != 192
 #error "DISPLAY_FRAME_* macros must describe the Apple II active display"
@@ -26,16 +28,21 @@
 enum {
     DISPLAY_FRAME_WIDTH_CHECK = APPLE2_VIDEO_WIDTH,
     DISPLAY_FRAME_HEIGHT_CHECK = APPLE2_VIDEO_HEIGHT,
-    DISPLAY_FRAME_PIXEL_FORMAT_ARGB8888 = 1
+    DISPLAY_FRAME_PIXEL_FORMAT_ARGB8888 = 1,
+    /* One palette index per pixel + DISPLAY_FRAME_PALETTE_SIZE ARGB entries. */
+    DISPLAY_FRAME_PIXEL_FORMAT_INDEXED8 = 2
 };
 
 typedef char display_frame_width_matches_video_
     [(DISPLAY_FRAME_WIDTH == APPLE2_VIDEO_WIDTH) ? 1 : -1];
 typedef char display_frame_height_matches_video_
     [(DISPLAY_FRAME_HEIGHT == APPLE2_VIDEO_HEIGHT) ? 1 : -1];
+typedef char display_frame_palette_matches_video_
+    [(DISPLAY_FRAME_PALETTE_SIZE == APPLE2_VIDEO_PALETTE_SIZE) ? 1 : -1];
 
-/* Metadata for a submitted host frame. Pixels live in a separate ARGB buffer
-   (frontend_submit_argb_frame). */
+/* Metadata for a submitted host frame. Pixels live in a separate buffer:
+   ARGB for the UI (frontend_submit_argb_frame), indices + palette in the
+   runtime slot and frame ring. */
 typedef struct display_frame {
     uint32_t width;
     uint32_t height;
@@ -50,5 +57,19 @@ static inline bool display_frame_is_valid(const display_frame *frame)
     return frame != NULL
         && frame->width == (uint32_t)DISPLAY_FRAME_WIDTH
         && frame->height == (uint32_t)DISPLAY_FRAME_HEIGHT
-        && frame->pixel_format == DISPLAY_FRAME_PIXEL_FORMAT_ARGB8888;
+        && (frame->pixel_format == DISPLAY_FRAME_PIXEL_FORMAT_ARGB8888
+            || frame->pixel_format == DISPLAY_FRAME_PIXEL_FORMAT_INDEXED8);
+}
+
+/* Presentation-edge expansion of an indexed frame into ARGB8888. */
+static inline void display_frame_expand_indexed8(uint32_t *dst,
+                                                 const uint8_t *src,
+                                                 size_t count,
+                                                 const uint32_t *palette)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        dst[i] = palette[src[i] & (DISPLAY_FRAME_PALETTE_SIZE - 1)];
+    }
 }
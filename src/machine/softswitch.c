@@ -349,6 +349,7 @@ static void kbdstrb(apple2_t *m)
         return;
     }
     m->ram_main[SS_KBD] &= 0x7Fu;
+    apple2_note_ram_store(m, &m->ram_main[SS_KBD]);
 }
 
 uint8_t softswitch_c0_read(apple2_t *m, uint16_t address)
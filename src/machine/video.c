@@ -52,7 +52,7 @@ static uint32_t rgb(uint8_t r, uint8_t g, uint8_t b)
     return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 }
 
-/* a2m palette_16 — LORES (and text on/off). ARGB8888. */
+/* a2m palette_16 — LORES (and text on/off). ARGB8888; fb holds indices. */
 static const uint32_t LORES_PALETTE[16] = {
     0xFF000000u, /* 0  Black */
     0xFF9D0966u, /* 1  Magenta / deep red */
@@ -74,24 +74,44 @@ static const uint32_t LORES_PALETTE[16] = {
 
 /*
  * a2m HGR Holger-Picker 3-bit window palette (phase selects green/violet vs
- * orange/blue set). Indices 0..7 phase0, 8..15 phase1.
+ * orange/blue set). Indices 0..7 phase0, 8..15 phase1. Entries are LORES
+ * palette indices: black, violet (3), green (12), blue (6), orange (9), white.
  */
-static const uint32_t HGR_PALETTE[16] = {
-    0xFF000000u, 0xFF000000u, 0xFFC734FFu, 0xFFFFFFFFu, /* black, black, violet, white */
-    0xFF000000u, 0xFF38CB00u, 0xFFFFFFFFu, 0xFFFFFFFFu, /* black, green, white, white */
-    0xFF000000u, 0xFF000000u, 0xFF0DA1FFu, 0xFFFFFFFFu, /* black, black, blue, white */
-    0xFF000000u, 0xFFF25E00u, 0xFFFFFFFFu, 0xFFFFFFFFu  /* black, orange, white, white */
+static const uint8_t HGR_PALETTE[16] = {
+    0, 0, 3, 15, /* black, black, violet, white */
+    0, 12, 15, 15, /* black, green, white, white */
+    0, 0, 6, 15, /* black, black, blue, white */
+    0, 9, 15, 15  /* black, orange, white, white */
 };
 
-/* Precomputed 7-pixel ARGB run for one HGR byte + neighbour context (a2m). */
+/* Precomputed 7-pixel palette-index run for one HGR byte + neighbour context (a2m). */
 typedef struct {
-    uint32_t pixel[7];
+    uint8_t pixel[7];
 } hgr_lut_entry;
 
 /* [byte7][next_lsb][prev_bit][phase][start_bit] */
 static hgr_lut_entry hgr_lut[128][2][2][2][2];
 /* a2m DHGR 5-bit window → LORES palette index by NTSC phase. */
-static uint32_t dhgr_lut[32][4];
+static uint8_t dhgr_lut[32][4];
+
+/*
+ * Scanner address layouts. HGR_MIXED is HGR on lines 0..159 and text on the
+ * bottom four text rows; LORES and DHGR scan the text layout (as the beam did).
+ */
+enum {
+    SCAN_LAYOUT_TEXT = 0,
+    SCAN_LAYOUT_HGR,
+    SCAN_LAYOUT_HGR_MIXED,
+    SCAN_LAYOUT_COUNT
+};
+
+/*
+ * [layout][page2][line * 65 + cycle_in_line] → address within the 64K bank
+ * the scanner reads, 0 during blanking (no display page starts at $0000).
+ * 80STORE+PAGE2 scans the page-1 address in aux, so only two page sets exist;
+ * the bank is added by scan_host_addr.
+ */
+static uint16_t scan_addr_lut[SCAN_LAYOUT_COUNT][2][APPLE2_VIDEO_CYCLES_PER_FRAME];
 static int paint_luts_ready;
 
 /* a2m: map 4-bit pattern to LORES colour index for DHGR. */
@@ -106,7 +126,7 @@ static int rotate_right4(int nibble, int phase)
 
 static void paint_init_luts(void)
 {
-    uint32_t color_table[8][2][2];
+    uint8_t color_table[8][2][2];
     int bit_stream;
     int column;
     int phase;
@@ -116,6 +136,9 @@ static void paint_init_luts(void)
     int start_bit;
     int b;
     int pattern;
+    int page;
+    int line;
+    int h;
 
     if (paint_luts_ready) {
         return;
@@ -170,7 +193,29 @@ static void paint_init_luts(void)
                 int rotated = rotate_right4(nibble, phase);
                 color_idx = dhgr_pattern_to_color[rotated];
             }
-            dhgr_lut[pattern][phase] = LORES_PALETTE[color_idx & 15];
+            dhgr_lut[pattern][phase] = (uint8_t)(color_idx & 15);
+        }
+    }
+
+    for (page = 0; page < 2; page++) {
+        uint16_t text_page = page ? 0x0800u : 0x0400u;
+        uint16_t hgr_page = page ? 0x4000u : 0x2000u;
+        for (line = 0; line < APPLE2_VIDEO_LINES_PER_FRAME; line++) {
+            for (h = 0; h < APPLE2_VIDEO_CYCLES_PER_LINE; h++) {
+                size_t idx = (size_t)line * APPLE2_VIDEO_CYCLES_PER_LINE + (size_t)h;
+                uint16_t text_addr = 0;
+                uint16_t hgr_addr = 0;
+                if (line < APPLE2_VIDEO_VISIBLE_LINES &&
+                    h < APPLE2_VIDEO_H_VISIBLE_CYCLES) {
+                    text_addr = (uint16_t)(text_page +
+                        apple2_video_text_line_base((uint8_t)(line / 8)) + h);
+                    hgr_addr = (uint16_t)(hgr_page + hgr_row_start[line] + h);
+                }
+                scan_addr_lut[SCAN_LAYOUT_TEXT][page][idx] = text_addr;
+                scan_addr_lut[SCAN_LAYOUT_HGR][page][idx] = hgr_addr;
+                scan_addr_lut[SCAN_LAYOUT_HGR_MIXED][page][idx] =
+                    (line >= 160) ? text_addr : hgr_addr;
+            }
         }
     }
 
@@ -178,14 +223,34 @@ static void paint_init_luts(void)
     (void)rgb;
 }
 
-static uint8_t video_read_host(const apple2_t *m, uint32_t host_offset)
+/*
+ * Everything a painter reads: display RAM in host layout (main 0..$FFFF, aux
+ * $10000..), display flags, character ROM and the paint target. Built from the
+ * live machine for the beam / block paint, or from a capture for re-render.
+ */
+typedef struct video_paint_ctx {
+    uint8_t *fb;
+    const uint8_t *ram;
+    uint32_t ram_size;
+    const uint8_t *rom_char;
+    size_t rom_char_size;
+    bool ii_plus;
+    uint64_t frame_number; /* flash phase */
+    uint32_t flags;
+} video_paint_ctx;
+
+static uint8_t video_read_host(const video_paint_ctx *c, uint32_t host_offset)
 {
-    if (host_offset >= APPLE2_RAM_MAIN_SIZE) {
+    if (host_offset >= c->ram_size) {
         return 0;
     }
-    return m->ram_main[host_offset];
+    return c->ram[host_offset];
 }
 
+/* Soft switches that select what the painter shows (and where it reads). */
+static const uint32_t VIDEO_CAPTURE_FLAG_MASK = A2S_80STORE | A2S_COL80 |
+    A2S_ALTCHARSET | A2S_TEXT | A2S_MIXED | A2S_PAGE2 | A2S_HIRES | A2S_DHIRES;
+
 static uint32_t video_display_flags(const apple2_t *m)
 {
     const uint32_t mask = A2S_COL80 | A2S_ALTCHARSET | A2S_TEXT |
@@ -202,43 +267,30 @@ static uint32_t video_display_flags(const apple2_t *m)
  * Display page selection:
  * - 80STORE off: PAGE2 selects $800/$4000 vs $400/$2000 in main.
  * - 80STORE on: PAGE2 selects aux bank for text/HGR display pages (//e).
+ *   (Simplified: the aux page is always page 1, $400 / $2000.)
  */
-static uint32_t text_host_addr(
-    const apple2_t *m,
-    uint32_t flags,
-    uint16_t offset_in_page)
+static uint32_t scan_host_addr(uint32_t flags, int layout, uint16_t line, uint16_t h)
 {
-    uint16_t base = (flags & A2S_PAGE2) ? 0x0800u : 0x0400u;
-    uint32_t addr = (uint32_t)base + offset_in_page;
-    if ((flags & A2S_80STORE) && (flags & A2S_PAGE2)) {
-        addr += 0x10000u;
-        /* With 80STORE+PAGE2, base stays $400 in aux for text page 1 hardware;
-           simplified: use $400 aux when 80STORE. */
-        addr = 0x10000u + 0x0400u + offset_in_page;
-    }
-    return addr;
+    uint32_t sel = flags & (A2S_80STORE | A2S_PAGE2);
+    uint32_t bank = (sel == (A2S_80STORE | A2S_PAGE2)) ? 0x10000u : 0u;
+    return bank + scan_addr_lut[layout][sel == A2S_PAGE2]
+        [(size_t)line * APPLE2_VIDEO_CYCLES_PER_LINE + h];
 }
 
-static uint32_t hgr_host_addr(
-    const apple2_t *m,
-    uint32_t flags,
-    uint16_t offset_in_page)
-{
-    uint16_t base = (flags & A2S_PAGE2) ? 0x4000u : 0x2000u;
-    uint32_t addr = (uint32_t)base + offset_in_page;
-    if ((flags & A2S_80STORE) && (flags & A2S_PAGE2)) {
-        addr = 0x10000u + 0x2000u + offset_in_page;
-    } else if (!(flags & A2S_80STORE) && (flags & A2S_PAGE2)) {
-        addr = 0x4000u + offset_in_page;
-    } else {
-        addr = 0x2000u + offset_in_page;
-    }
-    return addr;
+static void video_paint_ctx_from_machine(const apple2_t *m, video_paint_ctx *c)
+{
+    c->fb = m->video.fb;
+    c->ram = m->ram_main;
+    c->ram_size = APPLE2_RAM_MAIN_SIZE;
+    c->rom_char = m->rom_char;
+    c->rom_char_size = m->rom_char_size;
+    c->ii_plus = m->model == APPLE2_MODEL_II_PLUS;
+    c->frame_number = m->video.frame_number;
+    c->flags = video_display_flags(m);
 }
 
-static bool line_is_text(const apple2_t *m, uint16_t line)
+static bool line_is_text(uint32_t flags, uint16_t line)
 {
-    uint32_t flags = video_display_flags(m);
     if (line >= APPLE2_VIDEO_VISIBLE_LINES) {
         return false;
     }
@@ -252,9 +304,8 @@ static bool line_is_text(const apple2_t *m, uint16_t line)
 }
 
 /* Single HGR (not double-res): HIRES without COL80. */
-static bool line_is_hgr(const apple2_t *m, uint16_t line)
+static bool line_is_hgr(uint32_t flags, uint16_t line)
 {
-    uint32_t flags = video_display_flags(m);
     if (line >= APPLE2_VIDEO_VISIBLE_LINES) {
         return false;
     }
@@ -276,9 +327,8 @@ static bool line_is_hgr(const apple2_t *m, uint16_t line)
 }
 
 /* DHGR: COL80 + HIRES (a2m mode table). */
-static bool line_is_dhgr(const apple2_t *m, uint16_t line)
+static bool line_is_dhgr(uint32_t flags, uint16_t line)
 {
-    uint32_t flags = video_display_flags(m);
     if (line >= APPLE2_VIDEO_VISIBLE_LINES) {
         return false;
     }
@@ -298,9 +348,8 @@ static bool line_is_dhgr(const apple2_t *m, uint16_t line)
 }
 
 /* Double LORES: COL80 + GR (not TEXT, not HIRES). a2m mode matrix. */
-static bool line_is_dlores(const apple2_t *m, uint16_t line)
+static bool line_is_dlores(uint32_t flags, uint16_t line)
 {
-    uint32_t flags = video_display_flags(m);
     if (line >= APPLE2_VIDEO_VISIBLE_LINES) {
         return false;
     }
@@ -320,9 +369,8 @@ static bool line_is_dlores(const apple2_t *m, uint16_t line)
 }
 
 /* GR (not TEXT, not HIRES, not 80-col); MIXED uses text on lines 160..191. */
-static bool line_is_lores(const apple2_t *m, uint16_t line)
+static bool line_is_lores(uint32_t flags, uint16_t line)
 {
-    uint32_t flags = video_display_flags(m);
     if (line >= APPLE2_VIDEO_VISIBLE_LINES) {
         return false;
     }
@@ -341,9 +389,9 @@ static bool line_is_lores(const apple2_t *m, uint16_t line)
     return true;
 }
 
-static bool display_is_80col(const apple2_t *m)
+static bool display_is_80col(uint32_t flags)
 {
-    return (video_display_flags(m) & A2S_COL80) != 0;
+    return (flags & A2S_COL80) != 0;
 }
 
 /* a2m: de-interleave aux dlores nibbles onto the standard LORES palette. */
@@ -358,11 +406,10 @@ static const uint8_t double_aux_map[16] = {
  * (a2m hard-coded page 1; PAGE2 matches the rest of the v2 painter.)
  */
 static void dlores_page_bases(
-    const apple2_t *m,
+    uint32_t flags,
     uint32_t *main_base,
     uint32_t *aux_base)
 {
-    uint32_t flags = video_display_flags(m);
     uint32_t page = 0x0400u;
     if ((flags & A2S_PAGE2) && !(flags & A2S_80STORE)) {
         page = 0x0800u;
@@ -374,51 +421,35 @@ static void dlores_page_bases(
 static uint8_t scanner_fetch(apple2_t *m)
 {
     apple2_video *v = &m->video;
-    uint16_t line = v->line;
-    uint16_t h = v->cycle_in_line;
-
-    if (line >= APPLE2_VIDEO_VISIBLE_LINES || h >= APPLE2_VIDEO_H_VISIBLE_CYCLES) {
-        return v->last_video_byte;
-    }
+    uint32_t flags = m->state_flags;
+    uint32_t sel = flags & (A2S_80STORE | A2S_PAGE2);
+    int layout = SCAN_LAYOUT_TEXT;
+    uint16_t addr;
 
-    if (m->state_flags & A2S_TEXT ||
-        ((m->state_flags & A2S_MIXED) && line >= 160u)) {
-        uint8_t trow = (uint8_t)(line / 8u);
-        uint32_t addr = text_host_addr(
-            m, m->state_flags,
-            (uint16_t)(apple2_video_text_line_base(trow) + h));
-        v->last_video_byte = video_read_host(m, addr);
-        return v->last_video_byte;
+    /* Text, LORES and (quirk kept) DHGR scan the text layout. */
+    if ((flags & (A2S_TEXT | A2S_HIRES | A2S_COL80)) == A2S_HIRES) {
+        layout = (flags & A2S_MIXED) ? SCAN_LAYOUT_HGR_MIXED : SCAN_LAYOUT_HGR;
     }
 
-    if (!(m->state_flags & A2S_TEXT) &&
-        (m->state_flags & A2S_HIRES) &&
-        !(m->state_flags & A2S_COL80) &&
-        !((m->state_flags & A2S_MIXED) && line >= 160u)) {
-        uint32_t addr = hgr_host_addr(
-            m, m->state_flags,
-            (uint16_t)(apple2_video_hgr_line_offset((uint8_t)line) + h));
-        v->last_video_byte = video_read_host(m, addr);
+    addr = scan_addr_lut[layout][sel == A2S_PAGE2]
+        [(size_t)v->line * APPLE2_VIDEO_CYCLES_PER_LINE + v->cycle_in_line];
+    if (addr == 0u) {
         return v->last_video_byte;
     }
-
-    /* Lores path: text-page layout, byte is color cell. */
-    {
-        uint8_t trow = (uint8_t)(line / 8u);
-        uint32_t addr = text_host_addr(
-            m, m->state_flags,
-            (uint16_t)(apple2_video_text_line_base(trow) + h));
-        v->last_video_byte = video_read_host(m, addr);
-        return v->last_video_byte;
+    if (sel == (A2S_80STORE | A2S_PAGE2)) {
+        v->last_video_byte = m->ram_main[0x10000u + addr];
+    } else {
+        v->last_video_byte = m->ram_main[addr];
     }
+    return v->last_video_byte;
 }
 
-/* Write one logical dot as two horizontal ARGB pixels (560-wide contract). */
-static void paint_dot_x2(apple2_video *v, uint16_t line, uint16_t x, uint32_t color)
+/* Write one logical dot as two horizontal pixels (560-wide contract). */
+static void paint_dot_x2(uint8_t *fb, uint16_t line, uint16_t x, uint8_t color)
 {
     size_t base = (size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x;
-    v->fb[base] = color;
-    v->fb[base + 1u] = color;
+    fb[base] = color;
+    fb[base + 1u] = color;
 }
 
 /*
@@ -430,23 +461,22 @@ static void paint_dot_x2(apple2_video *v, uint16_t line, uint16_t x, uint32_t co
  * Flash rate ≈ half period every ~15 frames (~4 Hz).
  * pixel_double: 40-col (7 logical → 14 host); false for 80-col (7 host px).
  */
-static void paint_text_glyph(apple2_t *m, uint16_t line, uint16_t x0, uint8_t ch,
-                             int pixel_double)
+static void paint_text_glyph(const video_paint_ctx *c, uint16_t line, uint16_t x0,
+                             uint8_t ch, int pixel_double)
 {
-    apple2_video *v = &m->video;
     uint8_t character = ch;
     uint8_t inv = 0x00;
     uint8_t row_in_char = (uint8_t)(line & 7u);
     uint8_t bits;
     int b;
-    const uint8_t *crom = m->rom_char;
-    size_t csz = m->rom_char_size;
-    int alt_charset = (video_display_flags(m) & A2S_ALTCHARSET) != 0;
+    const uint8_t *crom = c->rom_char;
+    size_t csz = c->rom_char_size;
+    int alt_charset = (c->flags & A2S_ALTCHARSET) != 0;
     uint8_t flash_phase =
-        ((m->video.frame_number / 15u) & 1u) ? 0xFFu : 0x00u;
+        ((c->frame_number / APPLE2_VIDEO_FLASH_FRAMES) & 1u) ? 0xFFu : 0x00u;
     uint16_t width = pixel_double ? 14u : 7u;
 
-    if (crom == NULL || csz < 64u * 8u || v->fb == NULL) {
+    if (crom == NULL || csz < 64u * 8u || c->fb == NULL) {
         return;
     }
     if (x0 + width > APPLE2_VIDEO_WIDTH || line >= APPLE2_VIDEO_HEIGHT) {
@@ -459,7 +489,7 @@ static void paint_text_glyph(apple2_t *m, uint16_t line, uint16_t x0, uint8_t ch
                 character = (uint8_t)(character & 0x3Fu);
                 inv = flash_phase;
             }
-        } else if (m->model == APPLE2_MODEL_II_PLUS) {
+        } else if (c->ii_plus) {
             inv = 0xFFu;
         }
     }
@@ -474,85 +504,154 @@ static void paint_text_glyph(apple2_t *m, uint16_t line, uint16_t x0, uint8_t ch
     /* a2m: leftmost host pixel is bit6 of the glyph row. */
     for (b = 0; b < 7; b++) {
         int on = (bits >> (6 - b)) & 1;
-        uint32_t color = on ? LORES_PALETTE[15] : LORES_PALETTE[0];
+        uint8_t color = on ? 15u : 0u;
         if (pixel_double) {
-            paint_dot_x2(v, line, (uint16_t)(x0 + (uint16_t)(b * 2)), color);
+            paint_dot_x2(c->fb, line, (uint16_t)(x0 + (uint16_t)(b * 2)), color);
         } else {
-            v->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x0 +
+            c->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x0 +
                   (size_t)b] = color;
         }
     }
 }
 
 /* 40-col: one scanner column → one glyph pixel-doubled. */
-static void paint_text40_column(apple2_t *m, uint16_t line, uint16_t col, uint8_t ch)
+static void paint_text40_column(const video_paint_ctx *c, uint16_t line, uint16_t col,
+                                uint8_t ch)
 {
     uint16_t x0 = (uint16_t)(col * (uint16_t)APPLE2_VIDEO_PIXELS_PER_COLUMN);
-    paint_text_glyph(m, line, x0, ch, 1);
+    paint_text_glyph(c, line, x0, ch, 1);
 }
 
 /*
  * 80-col: one scanner column = aux glyph then main glyph (7+7 host pixels).
  * Display page is always $400 main / $10400 aux (a2m txt80).
  */
-static void paint_text80_column(apple2_t *m, uint16_t line, uint16_t col)
+static void paint_text80_column(const video_paint_ctx *c, uint16_t line, uint16_t col)
 {
     uint8_t trow = (uint8_t)(line / 8u);
     uint16_t base = apple2_video_text_line_base(trow);
-    uint8_t aux_ch = video_read_host(m, 0x10000u + 0x0400u + base + col);
-    uint8_t man_ch = video_read_host(m, 0x0400u + base + col);
+    uint8_t aux_ch = video_read_host(c, 0x10000u + 0x0400u + base + col);
+    uint8_t man_ch = video_read_host(c, 0x0400u + base + col);
     uint16_t x0 = (uint16_t)(col * (uint16_t)APPLE2_VIDEO_PIXELS_PER_COLUMN);
-    paint_text_glyph(m, line, x0, aux_ch, 0);
-    paint_text_glyph(m, line, (uint16_t)(x0 + 7u), man_ch, 0);
+    paint_text_glyph(c, line, x0, aux_ch, 0);
+    paint_text_glyph(c, line, (uint16_t)(x0 + 7u), man_ch, 0);
+}
+
+/* ASCII for the glyph paint_text_glyph draws for ch, minus inverse/flash. */
+static char text_glyph_ascii(uint8_t ch, bool alt_charset, bool ii_plus)
+{
+    uint8_t c = ch;
+
+    if (c >= 0x80u) {
+        c = (uint8_t)(c & 0x7Fu);
+        if (ii_plus && c >= 0x60u) {
+            c = (uint8_t)(c - 0x40u); /* ][+ ROM: no lowercase */
+        }
+    } else if (c >= 0x40u && (!alt_charset || c < 0x60u)) {
+        c = (uint8_t)(c & 0x3Fu); /* flash, or MouseText */
+    }
+    if (c < 0x20u) {
+        c = (uint8_t)(c + 0x40u);
+    }
+    return (char)c;
+}
+
+void apple2_video_decode_text(
+    uint32_t flags,
+    bool ii_plus,
+    const uint8_t *text_ram,
+    apple2_video_text *out)
+{
+    const uint8_t *aux_page = text_ram + 0x800u;
+    const uint8_t *page = text_ram;
+    uint32_t sel = flags & (A2S_80STORE | A2S_PAGE2);
+    bool alt_charset = (flags & A2S_ALTCHARSET) != 0;
+    uint8_t row;
+
+    memset(out, 0, sizeof(*out));
+    out->columns = display_is_80col(flags) ? 80u : 40u;
+    if (flags & A2S_TEXT) {
+        out->first_row = 0u;
+    } else if (flags & A2S_MIXED) {
+        out->first_row = 20u;
+    } else {
+        out->first_row = APPLE2_VIDEO_TEXT_ROWS;
+    }
+    /* Same page choice as scan_host_addr; 80-col always shows page 1. */
+    if (!display_is_80col(flags)) {
+        if (sel == A2S_PAGE2) {
+            page = text_ram + 0x400u;
+        } else if (sel == (A2S_80STORE | A2S_PAGE2)) {
+            page = aux_page;
+        }
+    }
+    for (row = out->first_row; row < APPLE2_VIDEO_TEXT_ROWS; row++) {
+        uint16_t base = apple2_video_text_line_base(row);
+        char *text = out->rows[row];
+        int length = 0;
+        uint16_t col;
+
+        for (col = 0; col < 40u; col++) {
+            if (out->columns == 80u) {
+                text[length++] = text_glyph_ascii(aux_page[base + col], alt_charset, ii_plus);
+                text[length++] = text_glyph_ascii(text_ram[base + col], alt_charset, ii_plus);
+            } else {
+                text[length++] = text_glyph_ascii(page[base + col], alt_charset, ii_plus);
+            }
+        }
+        while (length > 0 && text[length - 1] == ' ') {
+            length--;
+        }
+        text[length] = '\0';
+    }
 }
 
 /* LORES cell: upper nibble = top 4 scanlines, lower = bottom 4 (a2m). */
-static void paint_lores_column(apple2_t *m, uint16_t line, uint16_t col, uint8_t byte)
+static void paint_lores_column(const video_paint_ctx *c, uint16_t line, uint16_t col,
+                               uint8_t byte)
 {
-    apple2_video *v = &m->video;
     uint8_t nibble =
         ((line & 7u) < 4u) ? (uint8_t)(byte & 0x0Fu) : (uint8_t)((byte >> 4) & 0x0Fu);
-    uint32_t color = LORES_PALETTE[nibble & 0x0Fu];
+    uint8_t color = (uint8_t)(nibble & 0x0Fu);
     uint16_t x0 = (uint16_t)(col * (uint16_t)APPLE2_VIDEO_PIXELS_PER_COLUMN);
     int b;
 
     if (x0 + (uint16_t)APPLE2_VIDEO_PIXELS_PER_COLUMN > APPLE2_VIDEO_WIDTH ||
-        line >= APPLE2_VIDEO_HEIGHT || v->fb == NULL) {
+        line >= APPLE2_VIDEO_HEIGHT || c->fb == NULL) {
         return;
     }
 
     for (b = 0; b < (int)APPLE2_VIDEO_PIXELS_PER_COLUMN; b++) {
-        v->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x0 + (size_t)b] =
+        c->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x0 + (size_t)b] =
             color;
     }
 }
 
 /* One 7-host-pixel DLORES half-column (a2m gr_line cell). */
 static void paint_dlores_half(
-    apple2_t *m,
+    const video_paint_ctx *c,
     uint16_t line,
     uint16_t x0,
     uint8_t character,
     int from_aux)
 {
-    apple2_video *v = &m->video;
     uint8_t nibble =
         ((line & 7u) < 4u) ? (uint8_t)(character & 0x0Fu)
                            : (uint8_t)((character >> 4) & 0x0Fu);
-    uint32_t color;
+    uint8_t color;
     int b;
 
     if (from_aux) {
         nibble = double_aux_map[nibble & 0x0Fu];
     }
-    if (v->fb == NULL || line >= APPLE2_VIDEO_HEIGHT ||
+    if (c->fb == NULL || line >= APPLE2_VIDEO_HEIGHT ||
         (uint32_t)x0 + 7u > (uint32_t)APPLE2_VIDEO_WIDTH) {
         return;
     }
 
-    color = LORES_PALETTE[nibble & 0x0Fu];
+    color = (uint8_t)(nibble & 0x0Fu);
     for (b = 0; b < 7; b++) {
-        v->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x0 + (size_t)b] =
+        c->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x0 + (size_t)b] =
             color;
     }
 }
@@ -562,7 +661,7 @@ static void paint_dlores_half(
  * aux half-column then main half-column (7+7 host pixels). Aux nibbles go
  * through double_aux_map. Display pages follow PAGE2 when 80STORE is off.
  */
-static void paint_dlores_column(apple2_t *m, uint16_t line, uint16_t col)
+static void paint_dlores_column(const video_paint_ctx *c, uint16_t line, uint16_t col)
 {
     uint8_t trow = (uint8_t)(line / 8u);
     uint16_t row = apple2_video_text_line_base(trow);
@@ -572,18 +671,18 @@ static void paint_dlores_column(apple2_t *m, uint16_t line, uint16_t col)
     uint8_t aux_ch;
     uint8_t man_ch;
 
-    dlores_page_bases(m, &main_base, &aux_base);
-    aux_ch = video_read_host(m, aux_base + row + col);
-    man_ch = video_read_host(m, main_base + row + col);
-    paint_dlores_half(m, line, x0, aux_ch, 1);
-    paint_dlores_half(m, line, (uint16_t)(x0 + 7u), man_ch, 0);
+    dlores_page_bases(c->flags, &main_base, &aux_base);
+    aux_ch = video_read_host(c, aux_base + row + col);
+    man_ch = video_read_host(c, main_base + row + col);
+    paint_dlores_half(c, line, x0, aux_ch, 1);
+    paint_dlores_half(c, line, (uint16_t)(x0 + 7u), man_ch, 0);
 }
 
-static void paint_dlores_line(apple2_t *m, uint16_t line)
+static void paint_dlores_line(const video_paint_ctx *c, uint16_t line)
 {
     uint16_t col;
     for (col = 0; col < APPLE2_VIDEO_H_VISIBLE_CYCLES; col++) {
-        paint_dlores_column(m, line, col);
+        paint_dlores_column(c, line, col);
     }
 }
 
@@ -591,11 +690,10 @@ static void paint_dlores_line(apple2_t *m, uint16_t line)
  * a2m HGR colour: Holger Picker 3-bit window with prev/next neighbour bits.
  * Each logical HGR dot is written as two host pixels (560-wide contract).
  */
-static void paint_hgr_column(apple2_t *m, uint16_t line, uint16_t col, uint8_t byte)
+static void paint_hgr_column(const video_paint_ctx *c, uint16_t line, uint16_t col,
+                             uint8_t byte)
 {
-    apple2_video *v = &m->video;
     uint16_t x0 = (uint16_t)(col * (uint16_t)APPLE2_VIDEO_PIXELS_PER_COLUMN);
-    uint16_t line_off;
     uint8_t prev_byte;
     uint8_t next_byte;
     int prev_bit;
@@ -604,23 +702,24 @@ static void paint_hgr_column(apple2_t *m, uint16_t line, uint16_t col, uint8_t b
     int start_bit;
     int b;
     const hgr_lut_entry *e;
-    uint32_t flags = video_display_flags(m);
+    uint32_t flags = c->flags;
 
     if (x0 + (uint16_t)APPLE2_VIDEO_PIXELS_PER_COLUMN > APPLE2_VIDEO_WIDTH ||
-        line >= APPLE2_VIDEO_HEIGHT || v->fb == NULL) {
+        line >= APPLE2_VIDEO_HEIGHT || c->fb == NULL) {
         return;
     }
 
     paint_init_luts();
 
-    line_off = apple2_video_hgr_line_offset((uint8_t)line);
     prev_byte = (col > 0u)
                     ? video_read_host(
-                        m, hgr_host_addr(m, flags, (uint16_t)(line_off + col - 1u)))
+                        c, scan_host_addr(flags, SCAN_LAYOUT_HGR, line,
+                                          (uint16_t)(col - 1u)))
                     : 0u;
     next_byte = (col + 1u < 40u)
                     ? video_read_host(
-                        m, hgr_host_addr(m, flags, (uint16_t)(line_off + col + 1u)))
+                        c, scan_host_addr(flags, SCAN_LAYOUT_HGR, line,
+                                          (uint16_t)(col + 1u)))
                     : 0u;
     prev_bit = (col > 0u) ? ((prev_byte >> 6) & 1) : 0;
     next_lsb = next_byte & 1;
@@ -629,7 +728,7 @@ static void paint_hgr_column(apple2_t *m, uint16_t line, uint16_t col, uint8_t b
 
     e = &hgr_lut[byte & 0x7Fu][next_lsb][prev_bit][phase][start_bit];
     for (b = 0; b < 7; b++) {
-        paint_dot_x2(v, line, (uint16_t)(x0 + (uint16_t)(b * 2)), e->pixel[b]);
+        paint_dot_x2(c->fb, line, (uint16_t)(x0 + (uint16_t)(b * 2)), e->pixel[b]);
     }
 }
 
@@ -637,17 +736,16 @@ static void paint_hgr_column(apple2_t *m, uint16_t line, uint16_t col, uint8_t b
  * DHGR full scanline (a2m unk_apl2_screen_dhgr colour path).
  * Built once at h=0: main/aux HGR bytes → 560 bits → 5-bit window + phase LUT.
  */
-static void paint_dhgr_line(apple2_t *m, uint16_t line)
+static void paint_dhgr_line(const video_paint_ctx *c, uint16_t line)
 {
-    apple2_video *v = &m->video;
-    uint16_t page = (video_display_flags(m) & A2S_PAGE2) ? 0x4000u : 0x2000u;
+    uint16_t page = (c->flags & A2S_PAGE2) ? 0x4000u : 0x2000u;
     uint16_t row_off;
     uint8_t row_bits[565];
     int index = 2;
     int col;
     int x;
 
-    if (v->fb == NULL || line >= APPLE2_VIDEO_HEIGHT) {
+    if (c->fb == NULL || line >= APPLE2_VIDEO_HEIGHT) {
         return;
     }
 
@@ -656,14 +754,14 @@ static void paint_dhgr_line(apple2_t *m, uint16_t line)
     memset(row_bits, 0, sizeof(row_bits));
 
     for (col = 0; col < 40; col += 2) {
-        uint8_t b0 = (uint8_t)(video_read_host(m, 0x10000u + page + row_off + (uint16_t)col) &
+        uint8_t b0 = (uint8_t)(video_read_host(c, 0x10000u + page + row_off + (uint16_t)col) &
                                0x7Fu);
-        uint8_t b1 = (uint8_t)(video_read_host(m, page + row_off + (uint16_t)col) & 0x7Fu);
+        uint8_t b1 = (uint8_t)(video_read_host(c, page + row_off + (uint16_t)col) & 0x7Fu);
         uint8_t b2 =
-            (uint8_t)(video_read_host(m, 0x10000u + page + row_off + (uint16_t)col + 1u) &
+            (uint8_t)(video_read_host(c, 0x10000u + page + row_off + (uint16_t)col + 1u) &
                       0x7Fu);
         uint8_t b3 =
-            (uint8_t)(video_read_host(m, page + row_off + (uint16_t)col + 1u) & 0x7Fu);
+            (uint8_t)(video_read_host(c, page + row_off + (uint16_t)col + 1u) & 0x7Fu);
         uint32_t stream = ((uint32_t)b3 << 21) | ((uint32_t)b2 << 14) |
                           ((uint32_t)b1 << 7) | (uint32_t)b0;
         int bit;
@@ -677,15 +775,46 @@ static void paint_dhgr_line(apple2_t *m, uint16_t line)
         uint8_t bits = (uint8_t)((row_bits[x] << 4) | (row_bits[x + 1] << 3) |
                                  (row_bits[x + 2] << 2) | (row_bits[x + 3] << 1) |
                                  row_bits[x + 4]);
-        v->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x] =
+        c->fb[(size_t)line * (size_t)APPLE2_VIDEO_WIDTH + (size_t)x] =
             dhgr_lut[bits & 31u][(x + 3) & 3];
     }
 }
 
+/* Paint one visible scanner position (line, col) in the mode c->flags selects. */
+static void paint_position(const video_paint_ctx *c, uint16_t line, uint16_t col)
+{
+    uint32_t flags = c->flags;
+
+    if (line_is_text(flags, line)) {
+        if (display_is_80col(flags)) {
+            paint_text80_column(c, line, col);
+        } else {
+            uint8_t data = video_read_host(
+                c, scan_host_addr(flags, SCAN_LAYOUT_TEXT, line, col));
+            paint_text40_column(c, line, col, data);
+        }
+    } else if (line_is_dhgr(flags, line)) {
+        /* Full-line paint once per scanline (a2m window needs neighbours). */
+        if (col == 0u) {
+            paint_dhgr_line(c, line);
+        }
+    } else if (line_is_hgr(flags, line)) {
+        uint8_t data = video_read_host(
+            c, scan_host_addr(flags, SCAN_LAYOUT_HGR, line, col));
+        paint_hgr_column(c, line, col, data);
+    } else if (line_is_dlores(flags, line)) {
+        paint_dlores_column(c, line, col);
+    } else if (line_is_lores(flags, line)) {
+        uint8_t data = video_read_host(
+            c, scan_host_addr(flags, SCAN_LAYOUT_TEXT, line, col));
+        paint_lores_column(c, line, col, data);
+    }
+}
+
 static void paint_at_beam(apple2_t *m)
 {
     apple2_video *v = &m->video;
-    uint32_t flags;
+    video_paint_ctx c;
 
     if (!v->paint_enabled || v->fb == NULL) {
         (void)scanner_fetch(m);
@@ -698,103 +827,215 @@ static void paint_at_beam(apple2_t *m)
     }
 
     (void)scanner_fetch(m);
-    flags = video_display_flags(m);
-
-    if (line_is_text(m, v->line)) {
-        if (display_is_80col(m)) {
-            paint_text80_column(m, v->line, v->cycle_in_line);
-        } else {
-            uint8_t trow = (uint8_t)(v->line / 8u);
-            uint8_t data = video_read_host(
-                m,
-                text_host_addr(
-                    m, flags,
-                    (uint16_t)(apple2_video_text_line_base(trow) +
-                               v->cycle_in_line)));
-            paint_text40_column(m, v->line, v->cycle_in_line, data);
-        }
-    } else if (line_is_dhgr(m, v->line)) {
-        /* Full-line paint once per scanline (a2m window needs neighbours). */
-        if (v->cycle_in_line == 0u) {
-            paint_dhgr_line(m, v->line);
-        }
-    } else if (line_is_hgr(m, v->line)) {
-        uint8_t data = video_read_host(
-            m,
-            hgr_host_addr(
-                m, flags,
-                (uint16_t)(apple2_video_hgr_line_offset((uint8_t)v->line) +
-                           v->cycle_in_line)));
-        paint_hgr_column(m, v->line, v->cycle_in_line, data);
-    } else if (line_is_dlores(m, v->line)) {
-        paint_dlores_column(m, v->line, v->cycle_in_line);
-    } else if (line_is_lores(m, v->line)) {
-        uint8_t trow = (uint8_t)(v->line / 8u);
-        uint8_t data = video_read_host(
-            m,
-            text_host_addr(
-                m, flags,
-                (uint16_t)(apple2_video_text_line_base(trow) +
-                           v->cycle_in_line)));
-        paint_lores_column(m, v->line, v->cycle_in_line, data);
-    }
+    video_paint_ctx_from_machine(m, &c);
+    paint_position(&c, v->line, v->cycle_in_line);
 }
 
-void apple2_video_paint_full_frame(apple2_t *m)
+static void paint_frame(const video_paint_ctx *c)
 {
-    apple2_video *v;
     uint16_t line;
     uint16_t col;
-    uint32_t flags;
-
-    if (m == NULL) {
-        return;
-    }
-    v = &m->video;
-    if (v->fb == NULL) {
-        return;
-    }
-
-    paint_init_luts();
-    flags = video_display_flags(m);
+    uint32_t flags = c->flags;
 
     for (line = 0; line < APPLE2_VIDEO_VISIBLE_LINES; line++) {
-        if (line_is_text(m, line)) {
-            if (display_is_80col(m)) {
+        if (line_is_text(flags, line)) {
+            if (display_is_80col(flags)) {
                 for (col = 0; col < APPLE2_VIDEO_H_VISIBLE_CYCLES; col++) {
-                    paint_text80_column(m, line, col);
+                    paint_text80_column(c, line, col);
                 }
             } else {
                 for (col = 0; col < APPLE2_VIDEO_H_VISIBLE_CYCLES; col++) {
-                    uint8_t trow = (uint8_t)(line / 8u);
-                    uint32_t addr = text_host_addr(
-                        m, flags,
-                        (uint16_t)(apple2_video_text_line_base(trow) + col));
-                    paint_text40_column(m, line, col, video_read_host(m, addr));
+                    uint32_t addr = scan_host_addr(flags, SCAN_LAYOUT_TEXT, line, col);
+                    paint_text40_column(c, line, col, video_read_host(c, addr));
                 }
             }
-        } else if (line_is_dhgr(m, line)) {
-            paint_dhgr_line(m, line);
-        } else if (line_is_hgr(m, line)) {
-            uint16_t line_off = apple2_video_hgr_line_offset((uint8_t)line);
+        } else if (line_is_dhgr(flags, line)) {
+            paint_dhgr_line(c, line);
+        } else if (line_is_hgr(flags, line)) {
             for (col = 0; col < APPLE2_VIDEO_H_VISIBLE_CYCLES; col++) {
                 uint8_t byte = video_read_host(
-                    m, hgr_host_addr(m, flags, (uint16_t)(line_off + col)));
-                paint_hgr_column(m, line, col, byte);
+                    c, scan_host_addr(flags, SCAN_LAYOUT_HGR, line, col));
+                paint_hgr_column(c, line, col, byte);
             }
-        } else if (line_is_dlores(m, line)) {
-            paint_dlores_line(m, line);
-        } else if (line_is_lores(m, line)) {
-            uint8_t trow = (uint8_t)(line / 8u);
-            uint16_t base = apple2_video_text_line_base(trow);
+        } else if (line_is_dlores(flags, line)) {
+            paint_dlores_line(c, line);
+        } else if (line_is_lores(flags, line)) {
             for (col = 0; col < APPLE2_VIDEO_H_VISIBLE_CYCLES; col++) {
-                uint8_t byte =
-                    video_read_host(
-                        m, text_host_addr(m, flags, (uint16_t)(base + col)));
-                paint_lores_column(m, line, col, byte);
+                uint8_t byte = video_read_host(
+                    c, scan_host_addr(flags, SCAN_LAYOUT_TEXT, line, col));
+                paint_lores_column(c, line, col, byte);
+            }
+        }
+    }
+}
+
+void apple2_video_paint_full_frame(apple2_t *m)
+{
+    video_paint_ctx c;
+
+    if (m == NULL || m->video.fb == NULL) {
+        return;
+    }
+
+    paint_init_luts();
+    video_paint_ctx_from_machine(m, &c);
+    paint_frame(&c);
+}
+
+static uint8_t capture_region_bit(int hgr, int page, int aux)
+{
+    return (uint8_t)(1u << ((hgr ? 4 : 0) + page * 2 + aux));
+}
+
+/* Regions painters may read under one set of display flags. */
+static uint8_t capture_regions_for(uint32_t flags)
+{
+    uint32_t sel = flags & (A2S_80STORE | A2S_PAGE2);
+    int page = (sel == A2S_PAGE2) ? 1 : 0;
+    uint8_t mask = 0;
+
+    if ((flags & A2S_TEXT) || !(flags & A2S_HIRES) || (flags & A2S_MIXED)) {
+        mask |= capture_region_bit(0, page, 0);
+        if (sel == (A2S_80STORE | A2S_PAGE2)) {
+            mask |= capture_region_bit(0, 0, 1);
+        }
+        if (flags & A2S_COL80) {
+            /* 80-col text is page 1; DLORES follows page. */
+            mask |= capture_region_bit(0, 0, 0) | capture_region_bit(0, 0, 1) |
+                    capture_region_bit(0, page, 1);
+        }
+    }
+    if (!(flags & A2S_TEXT) && (flags & A2S_HIRES)) {
+        mask |= capture_region_bit(1, page, 0);
+        if (sel == (A2S_80STORE | A2S_PAGE2)) {
+            mask |= capture_region_bit(1, 0, 1);
+        }
+        if (flags & A2S_COL80) {
+            int dhgr_page = (flags & A2S_PAGE2) ? 1 : 0;
+            mask |= capture_region_bit(1, dhgr_page, 0) | capture_region_bit(1, dhgr_page, 1);
+        }
+    }
+    return mask;
+}
+
+uint32_t apple2_video_capture_region_offset(int region)
+{
+    if (region < 4) {
+        return (uint32_t)region * APPLE2_VIDEO_CAPTURE_TEXT_BYTES;
+    }
+    return 4u * APPLE2_VIDEO_CAPTURE_TEXT_BYTES +
+           (uint32_t)(region - 4) * APPLE2_VIDEO_CAPTURE_HGR_BYTES;
+}
+
+uint32_t apple2_video_capture_region_size(int region)
+{
+    return region < 4 ? APPLE2_VIDEO_CAPTURE_TEXT_BYTES : APPLE2_VIDEO_CAPTURE_HGR_BYTES;
+}
+
+/* Host-layout address of a capture region (main 0..$FFFF, aux $10000..). */
+static uint32_t capture_region_host(int region)
+{
+    int page = (region & 3) >> 1;
+    uint32_t bank = (region & 1) ? 0x10000u : 0u;
+
+    if (region < 4) {
+        return bank + (page ? 0x0800u : 0x0400u);
+    }
+    return bank + (page ? 0x4000u : 0x2000u);
+}
+
+void apple2_video_capture_frame(
+    const apple2_t *m,
+    bool beam_splits,
+    apple2_video_capture *out)
+{
+    const apple2_video *v;
+    uint16_t i;
+    int r;
+
+    if (m == NULL || out == NULL) {
+        return;
+    }
+    v = &m->video;
+    out->frame_number = v->frame_number;
+    if (beam_splits && v->split_frame == v->frame_number && v->split_frame != 0u) {
+        /* The beam painted that frame before frame_number advanced. */
+        out->frame_number = v->frame_number - 1u;
+        out->start_flags = v->last_start_flags;
+        out->split_count = v->last_split_count;
+        memcpy(out->splits, v->last_splits,
+               (size_t)v->last_split_count * sizeof(v->last_splits[0]));
+    } else {
+        out->start_flags = video_display_flags(m) & VIDEO_CAPTURE_FLAG_MASK;
+        out->split_count = 0;
+    }
+
+    out->region_mask = capture_regions_for(out->start_flags);
+    for (i = 0; i < out->split_count; i++) {
+        out->region_mask |= capture_regions_for(out->splits[i].flags);
+    }
+    for (r = 0; r < APPLE2_VIDEO_CAPTURE_REGION_COUNT; r++) {
+        if (out->region_mask & (1u << r)) {
+            memcpy(out->ram + apple2_video_capture_region_offset(r),
+                   m->ram_main + capture_region_host(r),
+                   apple2_video_capture_region_size(r));
+        }
+    }
+}
+
+bool apple2_video_render_capture(
+    const apple2_video_capture *capture,
+    const uint8_t *rom_char,
+    size_t rom_char_size,
+    bool ii_plus,
+    uint8_t *scratch,
+    uint8_t *out_indices)
+{
+    video_paint_ctx c;
+    uint16_t line;
+    uint16_t col;
+    uint16_t next = 0;
+    int r;
+
+    if (capture == NULL || scratch == NULL || out_indices == NULL) {
+        return false;
+    }
+    /* Only the capture regions change between calls: copied when present,
+       cleared when not. */
+    for (r = 0; r < APPLE2_VIDEO_CAPTURE_REGION_COUNT; r++) {
+        if (capture->region_mask & (1u << r)) {
+            memcpy(scratch + capture_region_host(r),
+                   capture->ram + apple2_video_capture_region_offset(r),
+                   apple2_video_capture_region_size(r));
+        } else {
+            memset(scratch + capture_region_host(r), 0,
+                   apple2_video_capture_region_size(r));
+        }
+    }
+
+    paint_init_luts();
+    memset(out_indices, 0, (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT);
+    c.fb = out_indices;
+    c.ram = scratch;
+    c.ram_size = APPLE2_VIDEO_RENDER_SCRATCH_BYTES;
+    c.rom_char = rom_char;
+    c.rom_char_size = rom_char_size;
+    c.ii_plus = ii_plus;
+    c.frame_number = capture->frame_number;
+    c.flags = capture->start_flags;
+
+    for (line = 0; line < APPLE2_VIDEO_VISIBLE_LINES; line++) {
+        for (col = 0; col < APPLE2_VIDEO_H_VISIBLE_CYCLES; col++) {
+            uint16_t position = (uint16_t)(line * APPLE2_VIDEO_CYCLES_PER_LINE + col);
+            while (next < capture->split_count &&
+                   capture->splits[next].position <= position) {
+                c.flags = capture->splits[next].flags;
+                next++;
             }
+            paint_position(&c, line, col);
         }
     }
+    return true;
 }
 
 void apple2_video_set_display_override(
@@ -825,7 +1066,9 @@ void apple2_video_init(apple2_t *m)
     memset(&m->video, 0, sizeof(m->video));
     m->video.paint_enabled = true;
     pixels = (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT;
-    m->video.fb = (uint32_t *)calloc(pixels, sizeof(uint32_t));
+    m->video.fb_owned = (uint8_t *)calloc(pixels, sizeof(uint8_t));
+    m->video.fb = m->video.fb_owned;
+    m->video.argb = (uint32_t *)calloc(pixels, sizeof(uint32_t));
     m->video.last_video_byte = 0x00;
 }
 
@@ -834,8 +1077,11 @@ void apple2_video_shutdown(apple2_t *m)
     if (m == NULL) {
         return;
     }
-    free(m->video.fb);
+    free(m->video.fb_owned);
+    free(m->video.argb);
+    m->video.fb_owned = NULL;
     m->video.fb = NULL;
+    m->video.argb = NULL;
 }
 
 void apple2_video_reset(apple2_t *m)
@@ -847,21 +1093,50 @@ void apple2_video_reset(apple2_t *m)
     m->video.line = 0;
     m->video.frame_ready = false;
     m->video.last_video_byte = 0x00;
+    m->video.frame_start_flags = m->video.split_flags;
+    m->video.split_count = 0;
     if (m->video.fb != NULL) {
-        memset(m->video.fb, 0,
-               (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT * sizeof(uint32_t));
+        memset(m->video.fb, 0, (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT);
     }
 }
 
+static void video_record_split(apple2_video *v, uint32_t flags)
+{
+    uint16_t position = (uint16_t)(v->line * APPLE2_VIDEO_CYCLES_PER_LINE +
+                                   v->cycle_in_line);
+
+    v->split_flags = flags;
+    if (v->line == 0u && v->cycle_in_line == 0u) {
+        v->frame_start_flags = flags;
+        v->split_count = 0;
+        return;
+    }
+    if (v->split_count == APPLE2_VIDEO_CAPTURE_MAX_SPLITS) {
+        /* Out of room: keep the latest state in the final slot. */
+        v->split_count--;
+    }
+    v->splits[v->split_count].position = position;
+    v->splits[v->split_count].flags = flags;
+    v->split_count++;
+}
+
 void apple2_video_step(apple2_t *m)
 {
     apple2_video *v;
+    uint32_t display_flags;
 
     if (m == NULL) {
         return;
     }
     v = &m->video;
 
+    if (v->record_splits) {
+        display_flags = video_display_flags(m) & VIDEO_CAPTURE_FLAG_MASK;
+        if (display_flags != v->split_flags) {
+            video_record_split(v, display_flags);
+        }
+    }
+
     /* A-lite (max turbo): advance H/V only — no paint, no scanner RAM peeks.
        VBL soft-switch still tracks line. Floating-bus is stale until beam resumes. */
     if (v->paint_enabled) {
@@ -877,6 +1152,15 @@ void apple2_video_step(apple2_t *m)
             v->frame_number++;
             v->frame_gen++;
             v->frame_ready = true;
+            if (v->record_splits) {
+                v->last_start_flags = v->frame_start_flags;
+                v->last_split_count = v->split_count;
+                memcpy(v->last_splits, v->splits,
+                       (size_t)v->split_count * sizeof(v->splits[0]));
+                v->split_frame = v->frame_number;
+                v->frame_start_flags = v->split_flags;
+                v->split_count = 0;
+            }
         }
     }
 }
@@ -933,7 +1217,15 @@ uint8_t apple2_video_floating_bus(apple2_t *m)
     return scanner_fetch(m);
 }
 
-const uint32_t *apple2_video_framebuffer(const apple2_t *m)
+void apple2_video_set_paint_target(apple2_t *m, uint8_t *fb)
+{
+    if (m == NULL || m->video.fb_owned == NULL) {
+        return;
+    }
+    m->video.fb = fb != NULL ? fb : m->video.fb_owned;
+}
+
+const uint8_t *apple2_video_indexed_framebuffer(const apple2_t *m)
 {
     if (m == NULL) {
         return NULL;
@@ -941,6 +1233,25 @@ const uint32_t *apple2_video_framebuffer(const apple2_t *m)
     return m->video.fb;
 }
 
+const uint32_t *apple2_video_palette(void)
+{
+    return LORES_PALETTE;
+}
+
+const uint32_t *apple2_video_framebuffer(apple2_t *m)
+{
+    size_t i;
+    size_t pixels = (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT;
+
+    if (m == NULL || m->video.fb == NULL || m->video.argb == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < pixels; i++) {
+        m->video.argb[i] = LORES_PALETTE[m->video.fb[i] & 0x0Fu];
+    }
+    return m->video.argb;
+}
+
 uint32_t apple2_video_frame_gen(const apple2_t *m)
 {
     if (m == NULL) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 struct apple2;
@@ -25,9 +26,46 @@ enum {
        width (DLORES = two 7-px half-columns per scanner column). */
     APPLE2_VIDEO_WIDTH = 560,
     APPLE2_VIDEO_HEIGHT = 192,
-    APPLE2_VIDEO_PIXELS_PER_COLUMN = 14
+    APPLE2_VIDEO_PIXELS_PER_COLUMN = 14,
+    /* Every mode paints from the a2m 16-colour (LORES) palette. */
+    APPLE2_VIDEO_PALETTE_SIZE = 16,
+    /* Frames per flashing-text phase. */
+    APPLE2_VIDEO_FLASH_FRAMES = 15
 };
 
+/*
+ * Frame capture: the display RAM a frame can show plus the display soft
+ * switches at frame start and every mid-frame change (beam split), enough to
+ * re-render the frame later with apple2_video_render_capture.
+ *
+ * Regions: text page 1/2 ($400/$800, 1K) and HGR page 1/2 ($2000/$4000, 8K),
+ * each main and aux. Index = page * 2 + aux (text 0..3, HGR 4..7).
+ */
+enum {
+    APPLE2_VIDEO_CAPTURE_MAX_SPLITS = 64,
+    APPLE2_VIDEO_CAPTURE_REGION_COUNT = 8,
+    APPLE2_VIDEO_CAPTURE_TEXT_BYTES = 0x400,
+    APPLE2_VIDEO_CAPTURE_HGR_BYTES = 0x2000,
+    APPLE2_VIDEO_CAPTURE_RAM_BYTES =
+        4 * APPLE2_VIDEO_CAPTURE_TEXT_BYTES + 4 * APPLE2_VIDEO_CAPTURE_HGR_BYTES,
+    /* Host-layout scratch a re-render paints from: up to HGR page 2 aux. */
+    APPLE2_VIDEO_RENDER_SCRATCH_BYTES = 0x16000
+};
+
+typedef struct apple2_video_split {
+    uint16_t position; /* line * APPLE2_VIDEO_CYCLES_PER_LINE + h */
+    uint32_t flags;    /* display A2S_* bits from this position on */
+} apple2_video_split;
+
+typedef struct apple2_video_capture {
+    uint64_t frame_number; /* flash phase */
+    uint32_t start_flags;
+    uint16_t split_count;
+    uint8_t region_mask;   /* bit per region present in ram */
+    apple2_video_split splits[APPLE2_VIDEO_CAPTURE_MAX_SPLITS];
+    uint8_t ram[APPLE2_VIDEO_CAPTURE_RAM_BYTES];
+} apple2_video_capture;
+
 typedef struct apple2_video {
     uint16_t cycle_in_line; /* 0..64 */
     uint16_t line;          /* 0..261 */
@@ -39,8 +77,27 @@ typedef struct apple2_video {
     bool display_override_enabled;
     uint32_t display_override_flags;
 
-    /* ARGB8888, row-major APPLE2_VIDEO_WIDTH × APPLE2_VIDEO_HEIGHT */
-    uint32_t *fb;
+    /* Beam splits: display flags at frame start + changes during the frame in
+       progress, and the same for the last completed frame (split_frame).
+       Recorded only while record_splits is set (a host that captures frames
+       with beam splits); off, the beam skips the per-cycle flag compare. */
+    bool record_splits;
+    uint32_t split_flags;
+    uint32_t frame_start_flags;
+    uint16_t split_count;
+    apple2_video_split splits[APPLE2_VIDEO_CAPTURE_MAX_SPLITS];
+    uint32_t last_start_flags;
+    uint16_t last_split_count;
+    apple2_video_split last_splits[APPLE2_VIDEO_CAPTURE_MAX_SPLITS];
+    uint64_t split_frame;
+
+    /* Palette indices (apple2_video_palette), row-major
+       APPLE2_VIDEO_WIDTH × APPLE2_VIDEO_HEIGHT. Points at fb_owned unless a
+       host supplied its own target (apple2_video_set_paint_target). */
+    uint8_t *fb;
+    uint8_t *fb_owned;
+    /* ARGB8888 expansion of fb, rebuilt by apple2_video_framebuffer(). */
+    uint32_t *argb;
     bool frame_ready; /* set when a frame just completed; cleared by consumer */
 } apple2_video;
 
@@ -60,7 +117,16 @@ bool apple2_video_in_hblank(const struct apple2 *m);
 /* Scanner data for floating bus / RDVBL helpers. */
 uint8_t apple2_video_floating_bus(struct apple2 *m);
 
-const uint32_t *apple2_video_framebuffer(const struct apple2 *m);
+/* Repoint the painters at a host-owned WIDTH×HEIGHT index buffer, e.g. the
+   back buffer of a triple-buffer handoff; NULL restores the built-in one.
+   Nothing is copied: unpainted pixels keep whatever the target held. */
+void apple2_video_set_paint_target(struct apple2 *m, uint8_t *fb);
+/* Indexed framebuffer the beam / block painters write (1 byte per pixel). */
+const uint8_t *apple2_video_indexed_framebuffer(const struct apple2 *m);
+/* APPLE2_VIDEO_PALETTE_SIZE ARGB8888 entries for the indexed framebuffer. */
+const uint32_t *apple2_video_palette(void);
+/* ARGB8888 expansion of the indexed framebuffer (tests / presentation). */
+const uint32_t *apple2_video_framebuffer(struct apple2 *m);
 uint32_t apple2_video_frame_gen(const struct apple2 *m);
 bool apple2_video_take_frame_ready(struct apple2 *m);
 
@@ -71,6 +137,38 @@ bool apple2_video_take_frame_ready(struct apple2 *m);
  */
 void apple2_video_paint_full_frame(struct apple2 *m);
 
+/*
+ * Capture the current frame: display RAM regions its flags can show. With
+ * beam_splits (call right after a beam frame completes) the completed frame's
+ * start flags + splits are kept; otherwise the current display flags apply to
+ * the whole frame. RAM is read at call time, as the block painter does.
+ */
+void apple2_video_capture_frame(
+    const struct apple2 *m,
+    bool beam_splits,
+    apple2_video_capture *out);
+
+/* Byte offset / size of capture region (0..APPLE2_VIDEO_CAPTURE_REGION_COUNT-1)
+   inside apple2_video_capture.ram. */
+uint32_t apple2_video_capture_region_offset(int region);
+uint32_t apple2_video_capture_region_size(int region);
+
+/*
+ * Re-render a capture into out_indices (APPLE2_VIDEO_WIDTH × HEIGHT palette
+ * indices), applying each split at its beam position. rom_char / ii_plus
+ * describe the machine the capture came from. scratch is caller-owned,
+ * APPLE2_VIDEO_RENDER_SCRATCH_BYTES zeroed once at allocation, and reusable
+ * across calls (only the capture regions are rewritten); nothing is
+ * allocated. False on a NULL argument.
+ */
+bool apple2_video_render_capture(
+    const apple2_video_capture *capture,
+    const uint8_t *rom_char,
+    size_t rom_char_size,
+    bool ii_plus,
+    uint8_t *scratch,
+    uint8_t *out_indices);
+
 /*
  * Debugger presentation override. This changes only which display mode/page
  * the painter shows; hardware soft switches and floating-bus scans remain
@@ -87,6 +185,34 @@ void apple2_video_set_display_override(
  */
 void apple2_video_reseed_from_cycles(struct apple2 *m);
 
+/* Text screen as the painter shows it (get-text / wait-text). */
+enum {
+    APPLE2_VIDEO_TEXT_ROWS = 24,
+    APPLE2_VIDEO_TEXT_COLUMNS_MAX = 80,
+    /* apple2_video_decode_text input: main $400..$BFF, then aux $400..$7FF. */
+    APPLE2_VIDEO_TEXT_RAM_BYTES = 0xC00
+};
+
+typedef struct apple2_video_text {
+    uint8_t columns;   /* 40 or 80 */
+    uint8_t first_row; /* rows above show graphics: 0, 20 (MIXED) or 24 */
+    char rows[APPLE2_VIDEO_TEXT_ROWS][APPLE2_VIDEO_TEXT_COLUMNS_MAX + 1];
+} apple2_video_text;
+
+/*
+ * Decode the text the painter shows for display flags (A2S_*) from text_ram
+ * (APPLE2_VIDEO_TEXT_RAM_BYTES, layout above). Each row is NUL-terminated
+ * ASCII without trailing blanks; graphics rows are empty. PAGE2 / 80STORE
+ * pick the page as the painter does. Inverse and flashing characters read as
+ * their normal form, MouseText as the uppercase letters it replaces, and ][+
+ * codes $E0..$FF as $A0..$BF (no lowercase ROM).
+ */
+void apple2_video_decode_text(
+    uint32_t flags,
+    bool ii_plus,
+    const uint8_t *text_ram,
+    apple2_video_text *out);
+
 /* Text-line base (0..23) within page $400 or $800. */
 uint16_t apple2_video_text_line_base(uint8_t text_row);
 /* HGR line base offset within $2000/$4000 page (0..191). */
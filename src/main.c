@@ -16,11 +16,15 @@
 #include "frontend_joystick_input.h"
 #include "platform.h"
 #include "platform_audio.h"
+#include "platform_shm.h"
 #include "runtime.h"
 #include "runtime_client.h"
+#include "runtime_shm.h"
+#include "runtime_snapshot_store.h"
 #include "runtime_slot_resolve.h"
 #include "version.h"
 #include "video.h"
+#include "wake_event.h"
 #include "window_title.h"
 
 #include <SDL.h>
@@ -52,7 +56,11 @@ enum {
     /* HOST payload: version + port + layout + swap + pad. */
     A2M_STATE_HOST_V1_SIZE = 8,
     /* Matches apple2_snapshot private header size (magic..pad). */
-    A2M_STATE_FILE_HEADER_MIN = 32
+    A2M_STATE_FILE_HEADER_MIN = 32,
+    /* Headless control loop: longest sleep with no event or request. */
+    A2M_HOST_IDLE_WAIT_MS = 250,
+    /* Opt+R steps back this many frames per press (and per key repeat). */
+    A2M_REWIND_KEY_FRAMES = 10
 };
 
 #define A2M_STATE_TAG(a, b, c, d) \
@@ -1246,7 +1254,7 @@ static void handle_drop_file(
             } else {
                 drop_smartport_image(client, options, debug, path);
             }
-        } else if (path_has_extension(path, "a2state")) {
+        } else if (path_has_extension(path, "a2state") || path_has_extension(path, "a2sm")) {
             (void)runtime_client_load_state(client, path);
         } else if (path_has_extension(path, "hdv") || path_has_extension(path, "2mg")) {
             drop_smartport_image(client, options, debug, path);
@@ -1323,6 +1331,12 @@ static bool append_host_state_chunk(
     if (path == NULL || path[0] == '\0') {
         return false;
     }
+    /* A store manifest is written whole by the state writer (temp, then
+       rename); appending would reopen it behind a later save of the same
+       path. Store states carry no host settings. */
+    if (runtime_snapshot_store_is_ref(path)) {
+        return true;
+    }
     port = kbd_joystick != NULL ? (uint8_t)kbd_joystick->port :
         (uint8_t)(options != NULL ? options->keyboard_joystick_port : 0);
     if (port > 2u) {
@@ -2099,6 +2113,17 @@ static bool apply_options_to_runtime_config(const app_options *options, runtime_
         rt_config->frame_ring_memory_mb = 0u;
         rt_config->frame_ring_memory_mb_configured = true;
     }
+    rt_config->frame_ring_mode = options->frame_ring_mode;
+
+    /* Rewind buffer (0 = off). Default from app_options is 64 MiB. */
+    rt_config->rewind_memory_mb =
+        options->rewind_memory_mb > 0 ? (uint32_t)options->rewind_memory_mb : 0u;
+    rt_config->rewind_interval_frames = (uint32_t)options->rewind_interval_frames;
+
+    /* Post-boot snapshot cache (--boot-cache). Runtime copies the strings. */
+    rt_config->boot_cache_dir = options->boot_cache_dir;
+    rt_config->boot_cache_until_text = options->boot_cache_text;
+    rt_config->boot_cache_until_pc = options->boot_cache_pc;
 
     /* CPU history budget (0 = off). Default from app_options is 256 MiB. */
     if (options->history_memory_mb > 0) {
@@ -2135,6 +2160,17 @@ static bool apply_options_to_runtime_config(const app_options *options, runtime_
     return true;
 }
 
+/* Block until the runtime posts an event or a control request arrives.
+   Without a wake event fall back to the old 1 ms nap. */
+static void host_wait(wake_event *wake, uint32_t timeout_ms)
+{
+    if (wake != NULL) {
+        (void)wake_event_wait(wake, timeout_ms);
+    } else if (timeout_ms > 0u) {
+        SDL_Delay(1);
+    }
+}
+
 int main(int argc, char **argv)
 {
     app_options options;
@@ -2152,6 +2188,10 @@ int main(int argc, char **argv)
     platform_audio *host_audio = NULL;
     control_server_t *control = NULL;
     control_dispatch_t control_disp;
+    /* --control-shm region; outlives the runtime that publishes into it. */
+    platform_shm *control_shm = NULL;
+    /* Shared by the runtime event queue and the control request queue. */
+    wake_event *host_wake = NULL;
     bool control_active = false;
     int exit_code = EXIT_FAILURE;
     bool running = true;
@@ -2242,16 +2282,34 @@ int main(int argc, char **argv)
         }
     }
 
+    /* Frames and RAM in shared memory for same-host control clients. */
+    if (options.control_port > 0 && options.control_shm) {
+        control_shm = platform_shm_create("a2m", runtime_shm_region_size());
+        if (control_shm == NULL) {
+            fprintf(stderr, "a2m: control shared memory unavailable; socket only\n");
+        } else {
+            rt_config.shm_region = platform_shm_data(control_shm);
+            rt_config.shm_region_size = platform_shm_size(control_shm);
+        }
+    }
+
     rt = runtime_create(&rt_config);
     if (rt == NULL || !runtime_start(rt)) {
         fprintf(stderr, "a2m: runtime start failed\n");
         goto done;
     }
     client = runtime_get_client(rt);
+    host_wake = wake_event_create();
+    runtime_client_set_event_wake(client, host_wake);
 
     /* Optional control port (A2M/2): windowed or headless coop/automation. */
     if (options.control_port > 0) {
         control = control_server_create((uint16_t)options.control_port);
+        control_server_set_wake_event(control, host_wake);
+        if (control_shm != NULL) {
+            control_server_set_shm(
+                control, platform_shm_name(control_shm), platform_shm_size(control_shm));
+        }
         if (control == NULL || !control_server_start(control)) {
             fprintf(
                 stderr,
@@ -2263,6 +2321,8 @@ int main(int argc, char **argv)
             }
         } else {
             control_dispatch_init(&control_disp, control, client);
+            control_dispatch_set_pipeline_limit(
+                &control_disp, (uint32_t)options.control_pipeline);
             control_active = true;
             /* Seed slot map for mount-disk / select-disk resolve defaults. */
             (void)runtime_client_request_machine_state(client);
@@ -2325,7 +2385,7 @@ int main(int argc, char **argv)
                         fprintf(stderr, "a2m: runtime: %s\n", revent.data.error.message);
                     }
                 }
-                SDL_Delay(1);
+                host_wait(host_wake, 1u);
             }
             exit_code = EXIT_SUCCESS;
             goto done;
@@ -2366,10 +2426,11 @@ int main(int argc, char **argv)
             }
             control_dispatch_poll(&control_disp);
             control_dispatch_check_session(&control_disp);
-            if (control_deferred_active(&control_disp.deferred) == NULL) {
-                control_dispatch_poll(&control_disp);
-            }
-            SDL_Delay(control_deferred_active(&control_disp.deferred) != NULL ? 0 : 1);
+            /* Idle instances sleep here until an event or request arrives;
+               the timeout only bounds deferred-response deadlines. */
+            host_wait(
+                host_wake,
+                control_dispatch_wait_timeout_ms(&control_disp, A2M_HOST_IDLE_WAIT_MS));
         }
         exit_code = EXIT_SUCCESS;
         goto done;
@@ -2642,6 +2703,12 @@ int main(int argc, char **argv)
                     (void)runtime_client_cycle_turbo_speed(client);
                     (void)runtime_client_request_machine_state(client);
                     send_event_to_frontend = false;
+                } else if (sym == SDLK_r &&
+                           frontend_input_has_option_modifier(&event.key)) {
+                    /* Holding the key keeps rewinding: SDL repeats arrive
+                       as further key-downs. */
+                    (void)runtime_client_rewind(client, A2M_REWIND_KEY_FRAMES, 0u);
+                    send_event_to_frontend = false;
                 } else if (ui_visible && frontend_handle_view_cycle_key(ui, &event.key)) {
                     send_event_to_frontend = false;
                 } else if (!ui_visible || frontend_routes_keyboard_to_machine(ui)) {
@@ -2835,9 +2902,6 @@ int main(int argc, char **argv)
         if (control_active) {
             control_dispatch_poll(&control_disp);
             control_dispatch_check_session(&control_disp);
-            if (control_deferred_active(&control_disp.deferred) == NULL) {
-                control_dispatch_poll(&control_disp);
-            }
         }
 
         if (runtime_client_poll_argb_frame(
@@ -2928,7 +2992,9 @@ int main(int argc, char **argv)
         }
 
         platform_window_present(window);
-        SDL_Delay(1);
+        /* SDL input is polled, so cap the wait at 1 ms; control requests and
+           runtime events still cut it short. */
+        host_wait(host_wake, 1u);
     }
 
     if ((options.save_ini || options.remember) && !options.no_save_ini) {
@@ -2986,6 +3052,10 @@ done:
         runtime_destroy(rt);
         rt = NULL;
     }
+    platform_shm_destroy(control_shm);
+    control_shm = NULL;
+    wake_event_destroy(host_wake);
+    host_wake = NULL;
     if ((options.save_ini || options.remember) && !options.no_save_ini) {
         (void)app_options_save_shutdown(&options);
     }
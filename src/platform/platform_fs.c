@@ -40,6 +40,32 @@ bool platform_fs_is_dir(const char *path)
     return path != NULL && path[0] != '\0' && stat(path, &st) == 0 && A2M_STAT_ISDIR(st.st_mode);
 }
 
+bool platform_fs_make_dir(const char *path)
+{
+    if (path == NULL || path[0] == '\0') {
+        return false;
+    }
+#if defined(_WIN32)
+    (void)_mkdir(path);
+#else
+    (void)mkdir(path, 0777);
+#endif
+    /* Lost a race with another creator, or it was already there. */
+    return platform_fs_is_dir(path);
+}
+
+bool platform_fs_replace_file(const char *from, const char *to)
+{
+    if (from == NULL || to == NULL || from[0] == '\0' || to[0] == '\0') {
+        return false;
+    }
+#if defined(_WIN32)
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
 void platform_fs_path_join(char *out, size_t out_size, const char *dir, const char *name)
 {
     size_t dir_len;
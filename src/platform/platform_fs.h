@@ -31,5 +31,14 @@ bool platform_fs_list_dir(const char *dir_path, platform_fs_listing *out);
 /* Returns true if path exists and is a directory. */
 bool platform_fs_is_dir(const char *path);
 
+/* Creates directory path (one level). True when it exists as a directory
+   afterwards, including when it already did. */
+bool platform_fs_make_dir(const char *path);
+
+/* Renames from over to, replacing an existing to in one step (rename(2);
+   MoveFileEx with REPLACE_EXISTING on Windows). Both paths should be on the
+   same volume. */
+bool platform_fs_replace_file(const char *from, const char *to);
+
 /* Joins dir and name with the platform path separator into out. */
 void platform_fs_path_join(char *out, size_t out_size, const char *dir, const char *name);
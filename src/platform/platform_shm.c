@@ -0,0 +1,137 @@
+#include "platform_shm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+enum { PLATFORM_SHM_NAME_MAX = 64 };
+
+struct platform_shm {
+    void *data;
+    size_t size;
+    char name[PLATFORM_SHM_NAME_MAX];
+#if defined(_WIN32)
+    HANDLE mapping;
+#endif
+};
+
+#if defined(_WIN32)
+
+platform_shm *platform_shm_create(const char *prefix, size_t size)
+{
+    platform_shm *shm;
+    unsigned long long size64 = (unsigned long long)size;
+
+    if (prefix == NULL || size == 0u) {
+        return NULL;
+    }
+    shm = (platform_shm *)calloc(1, sizeof(*shm));
+    if (shm == NULL) {
+        return NULL;
+    }
+    (void)snprintf(
+        shm->name, sizeof(shm->name), "Local\\%s-%lu", prefix,
+        (unsigned long)GetCurrentProcessId());
+    shm->mapping = CreateFileMappingA(
+        INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+        (DWORD)(size64 >> 32), (DWORD)(size64 & 0xFFFFFFFFu), shm->name);
+    if (shm->mapping == NULL || GetLastError() == ERROR_ALREADY_EXISTS) {
+        if (shm->mapping != NULL) {
+            CloseHandle(shm->mapping);
+        }
+        free(shm);
+        return NULL;
+    }
+    shm->data = MapViewOfFile(shm->mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (shm->data == NULL) {
+        CloseHandle(shm->mapping);
+        free(shm);
+        return NULL;
+    }
+    shm->size = size;
+    return shm;
+}
+
+void platform_shm_destroy(platform_shm *shm)
+{
+    if (shm == NULL) {
+        return;
+    }
+    UnmapViewOfFile(shm->data);
+    CloseHandle(shm->mapping);
+    free(shm);
+}
+
+#else
+
+platform_shm *platform_shm_create(const char *prefix, size_t size)
+{
+    platform_shm *shm;
+    int fd;
+
+    if (prefix == NULL || size == 0u) {
+        return NULL;
+    }
+    shm = (platform_shm *)calloc(1, sizeof(*shm));
+    if (shm == NULL) {
+        return NULL;
+    }
+    (void)snprintf(shm->name, sizeof(shm->name), "/%s-%ld", prefix, (long)getpid());
+    fd = shm_open(shm->name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        free(shm);
+        return NULL;
+    }
+    /* A fresh object reads as zeros once sized. */
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        shm_unlink(shm->name);
+        free(shm);
+        return NULL;
+    }
+    shm->data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm->data == MAP_FAILED) {
+        shm_unlink(shm->name);
+        free(shm);
+        return NULL;
+    }
+    shm->size = size;
+    return shm;
+}
+
+void platform_shm_destroy(platform_shm *shm)
+{
+    if (shm == NULL) {
+        return;
+    }
+    munmap(shm->data, shm->size);
+    shm_unlink(shm->name);
+    free(shm);
+}
+
+#endif
+
+void *platform_shm_data(const platform_shm *shm)
+{
+    return shm != NULL ? shm->data : NULL;
+}
+
+size_t platform_shm_size(const platform_shm *shm)
+{
+    return shm != NULL ? shm->size : 0u;
+}
+
+const char *platform_shm_name(const platform_shm *shm)
+{
+    return shm != NULL ? shm->name : "";
+}
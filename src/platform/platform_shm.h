@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Named shared-memory region other processes of the same user can map
+   (POSIX shm_open + mmap; a named file mapping on Windows). */
+typedef struct platform_shm platform_shm;
+
+/* Create a zeroed region of size bytes named "<prefix>-<pid>" (POSIX:
+   "/<prefix>-<pid>", mode 0600; Windows: "Local\\<prefix>-<pid>").
+   NULL when shared memory is unavailable or the name is taken. */
+platform_shm *platform_shm_create(const char *prefix, size_t size);
+/* Unmap and remove the name; mappings other processes hold stay valid. */
+void platform_shm_destroy(platform_shm *shm);
+
+void *platform_shm_data(const platform_shm *shm);
+size_t platform_shm_size(const platform_shm *shm);
+/* Name to open the region with (shm_open / OpenFileMapping). */
+const char *platform_shm_name(const platform_shm *shm);
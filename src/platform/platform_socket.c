@@ -13,6 +13,7 @@ typedef SOCKET a2m_socket_handle;
 #include <errno.h>
 #include <fcntl.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -116,6 +117,12 @@ platform_socket_connection *platform_socket_accept(platform_socket_listener *lis
     if (handle == A2M_INVALID_SOCKET) {
         return NULL;
     }
+    /* Replies are written as header, payload and terminator; without this
+       Nagle holds the tail for the peer's delayed ACK (~40 ms per reply). */
+    {
+        int one = 1;
+        setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, sizeof(one));
+    }
 
     connection = (platform_socket_connection *)calloc(1, sizeof(*connection));
     if (connection == NULL) {
@@ -266,6 +273,71 @@ bool platform_socket_set_nonblocking(platform_socket_connection *connection, boo
 #endif
 }
 
+bool platform_socket_listener_set_nonblocking(platform_socket_listener *listener, bool enabled)
+{
+    if (listener == NULL || listener->handle == A2M_INVALID_SOCKET) {
+        return false;
+    }
+#if defined(_WIN32)
+    u_long mode = enabled ? 1ul : 0ul;
+    return ioctlsocket(listener->handle, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(listener->handle, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    if (enabled) {
+        flags |= O_NONBLOCK;
+    } else {
+        flags &= ~O_NONBLOCK;
+    }
+    return fcntl(listener->handle, F_SETFL, flags) == 0;
+#endif
+}
+
+int platform_socket_write_some(
+    platform_socket_connection *connection,
+    const void *buffer,
+    size_t size)
+{
+    int sent;
+
+    if (connection == NULL || connection->handle == A2M_INVALID_SOCKET ||
+        (buffer == NULL && size > 0)) {
+        return -1;
+    }
+    if (size == 0) {
+        return 0;
+    }
+    if (size > (size_t)0x40000000) {
+        size = (size_t)0x40000000; /* send() takes an int length */
+    }
+    for (;;) {
+#if defined(_WIN32)
+        sent = send(connection->handle, (const char *)buffer, (int)size, 0);
+        if (sent >= 0) {
+            return sent;
+        }
+        {
+            int err = WSAGetLastError();
+            if (err == WSAEINTR) {
+                continue;
+            }
+            return err == WSAEWOULDBLOCK ? -2 : -1;
+        }
+#else
+        sent = (int)send(connection->handle, buffer, size, 0);
+        if (sent >= 0) {
+            return sent;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? -2 : -1;
+#endif
+    }
+}
+
 int platform_socket_wait_readable(
     platform_socket_connection *connection,
     uint32_t timeout_ms)
@@ -313,3 +385,163 @@ int platform_socket_wait_readable(
     return 0;
 #endif
 }
+
+int platform_socket_wait_readable_or(
+    platform_socket_connection *connection,
+    int extra_fd,
+    uint32_t timeout_ms)
+{
+#if defined(_WIN32)
+    (void)extra_fd;
+    return platform_socket_wait_readable(connection, timeout_ms);
+#else
+    struct pollfd pfd[2];
+    int result;
+
+    if (extra_fd < 0) {
+        return platform_socket_wait_readable(connection, timeout_ms);
+    }
+    if (connection == NULL || connection->handle == A2M_INVALID_SOCKET) {
+        return -1;
+    }
+    pfd[0].fd = connection->handle;
+    pfd[0].events = POLLIN | POLLERR | POLLHUP;
+    pfd[0].revents = 0;
+    pfd[1].fd = extra_fd;
+    pfd[1].events = POLLIN;
+    pfd[1].revents = 0;
+    result = poll(pfd, 2, (int)timeout_ms);
+    if (result < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (result == 0) {
+        return 0;
+    }
+    if (pfd[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+        return -1;
+    }
+    if (pfd[0].revents & POLLIN) {
+        return 1;
+    }
+    return (pfd[1].revents & POLLIN) ? 2 : 0;
+#endif
+}
+
+static a2m_socket_handle platform_socket_poll_handle(const platform_socket_poll_entry *entry)
+{
+    if (entry->listener != NULL) {
+        return entry->listener->handle;
+    }
+    return entry->connection != NULL ? entry->connection->handle : A2M_INVALID_SOCKET;
+}
+
+int platform_socket_poll(
+    platform_socket_poll_entry *entries,
+    size_t count,
+    int extra_fd,
+    uint32_t timeout_ms)
+{
+    size_t i;
+    int ready = 0;
+
+    if (entries == NULL || count > PLATFORM_SOCKET_POLL_MAX) {
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        entries[i].readable = false;
+        entries[i].writable = false;
+        entries[i].failed = platform_socket_poll_handle(&entries[i]) == A2M_INVALID_SOCKET;
+        if (entries[i].failed) {
+            ready++;
+        }
+    }
+    if (ready > 0) {
+        return ready;
+    }
+#if defined(_WIN32)
+    {
+        fd_set read_fds;
+        fd_set write_fds;
+        fd_set error_fds;
+        struct timeval tv;
+        int result;
+
+        (void)extra_fd;
+        if (count == 0) {
+            Sleep(timeout_ms); /* select() rejects empty sets */
+            return 0;
+        }
+        FD_ZERO(&read_fds);
+        FD_ZERO(&write_fds);
+        FD_ZERO(&error_fds);
+        for (i = 0; i < count; i++) {
+            a2m_socket_handle handle = platform_socket_poll_handle(&entries[i]);
+            if (entries[i].want_read) {
+                FD_SET(handle, &read_fds);
+            }
+            if (entries[i].want_write) {
+                FD_SET(handle, &write_fds);
+            }
+            FD_SET(handle, &error_fds);
+        }
+        tv.tv_sec = (long)(timeout_ms / 1000u);
+        tv.tv_usec = (long)((timeout_ms % 1000u) * 1000u);
+        result = select(0, &read_fds, &write_fds, &error_fds, &tv);
+        if (result <= 0) {
+            return result < 0 ? -1 : 0;
+        }
+        for (i = 0; i < count; i++) {
+            a2m_socket_handle handle = platform_socket_poll_handle(&entries[i]);
+            entries[i].readable = FD_ISSET(handle, &read_fds) != 0;
+            entries[i].writable = FD_ISSET(handle, &write_fds) != 0;
+            entries[i].failed = FD_ISSET(handle, &error_fds) != 0;
+            if (entries[i].readable || entries[i].writable || entries[i].failed) {
+                ready++;
+            }
+        }
+        return ready;
+    }
+#else
+    {
+        struct pollfd pfd[PLATFORM_SOCKET_POLL_MAX + 1];
+        size_t total = count;
+        int result;
+
+        for (i = 0; i < count; i++) {
+            pfd[i].fd = platform_socket_poll_handle(&entries[i]);
+            pfd[i].events = (short)((entries[i].want_read ? POLLIN : 0) |
+                (entries[i].want_write ? POLLOUT : 0));
+            pfd[i].revents = 0;
+        }
+        if (extra_fd >= 0) {
+            pfd[total].fd = extra_fd;
+            pfd[total].events = POLLIN;
+            pfd[total].revents = 0;
+            total++;
+        }
+        result = poll(pfd, (nfds_t)total, (int)timeout_ms);
+        if (result < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
+        if (result == 0) {
+            return 0;
+        }
+        for (i = 0; i < count; i++) {
+            short revents = pfd[i].revents;
+
+            entries[i].readable = (revents & POLLIN) != 0;
+            entries[i].writable = (revents & POLLOUT) != 0;
+            /* A hang-up with bytes still queued reads them first. */
+            entries[i].failed = (revents & (POLLERR | POLLNVAL)) != 0 ||
+                ((revents & POLLHUP) != 0 && !entries[i].readable);
+            if (entries[i].readable || entries[i].writable || entries[i].failed) {
+                ready++;
+            }
+        }
+        if (extra_fd >= 0 && (pfd[count].revents & POLLIN) != 0) {
+            ready++;
+        }
+        return ready;
+    }
+#endif
+}
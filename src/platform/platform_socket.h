@@ -25,8 +25,45 @@ void platform_socket_connection_destroy(platform_socket_connection *connection);
 
 /* Nonblocking I/O helpers for control-port pipelining (Phase 2b). */
 bool platform_socket_set_nonblocking(platform_socket_connection *connection, bool enabled);
+/* A nonblocking listener's accept() returns NULL instead of waiting. */
+bool platform_socket_listener_set_nonblocking(platform_socket_listener *listener, bool enabled);
+/* Send what fits without blocking. Returns bytes sent (may be short), -2 when
+   nothing fits right now, -1 on error. */
+int platform_socket_write_some(
+    platform_socket_connection *connection,
+    const void *buffer,
+    size_t size);
 /* Wait until readable, or timeout. Returns 1=readable, 0=timeout, -1=error/closed. */
 int platform_socket_wait_readable(
     platform_socket_connection *connection,
     uint32_t timeout_ms);
+/* Same, but also return 2 when extra_fd (e.g. a wake_event_fd) turns readable
+   first. extra_fd < 0, or Windows, waits on the socket alone. */
+int platform_socket_wait_readable_or(
+    platform_socket_connection *connection,
+    int extra_fd,
+    uint32_t timeout_ms);
+
+/* One socket for platform_socket_poll: set listener or connection. */
+enum { PLATFORM_SOCKET_POLL_MAX = 16 };
+
+typedef struct platform_socket_poll_entry {
+    platform_socket_listener *listener;
+    platform_socket_connection *connection;
+    bool want_read;
+    bool want_write;
+    /* Results. failed = error or hang-up with nothing left to read. */
+    bool readable;
+    bool writable;
+    bool failed;
+} platform_socket_poll_entry;
+
+/* Wait on up to PLATFORM_SOCKET_POLL_MAX sockets and extra_fd at once.
+   Returns how many are ready (extra_fd counts), 0 on timeout, -1 on error.
+   extra_fd < 0, or Windows, waits on the sockets alone. */
+int platform_socket_poll(
+    platform_socket_poll_entry *entries,
+    size_t count,
+    int extra_fd,
+    uint32_t timeout_ms);
 
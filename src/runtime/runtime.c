@@ -1,7 +1,7 @@
 #include "runtime.h"
 
 #include "apple2.h"
-#include "message_queue.h"
+#include "lockfree_queue.h"
 #include "mutex.h"
 #include "runtime_breakpoint_ini.h"
 #include "runtime_command.h"
@@ -45,6 +45,10 @@ void runtime_config_init(runtime_config *config)
     config->slot_cards[7] = RUNTIME_SLOT_CARD_SMARTPORT;
     config->start_running = true;
     config->frame_ring_memory_mb = 0;
+    config->frame_ring_mode = RUNTIME_FRAME_RING_MODE_PIXELS;
+    config->rewind_memory_mb = 0;
+    config->rewind_interval_frames = RUNTIME_REWIND_DEFAULT_INTERVAL_FRAMES;
+    config->boot_cache_until_pc = -1;
     config->diskii_mount_count = 0;
     config->smartport_mount_count = 0;
     config->smartport_boot_slot = 0;
@@ -274,19 +278,21 @@ runtime *runtime_create(const runtime_config *config)
     }
 
     rt->command_queue =
-        message_queue_create(sizeof(runtime_command), RUNTIME_COMMAND_QUEUE_CAPACITY);
+        mpsc_queue_create(sizeof(runtime_command), RUNTIME_COMMAND_QUEUE_CAPACITY);
     rt->event_queue =
-        message_queue_create(sizeof(runtime_event), RUNTIME_EVENT_QUEUE_CAPACITY);
-    rt->frame_slot.mutex = mutex_create();
+        spsc_queue_create(sizeof(runtime_event), RUNTIME_EVENT_QUEUE_CAPACITY);
+    rt->frame_slot.handoff =
+        runtime_frame_handoff_create(DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT);
     rt->debug_memory_slot.mutex = mutex_create();
     rt->breakpoint_slot.mutex = mutex_create();
     rt->symbol_slot.mutex = mutex_create();
     rt->rpc_payload_pool.mutex = mutex_create();
+    rt->ram_mirror = runtime_ram_mirror_create();
 
     if (rt->command_queue == NULL || rt->event_queue == NULL ||
-        rt->frame_slot.mutex == NULL || rt->debug_memory_slot.mutex == NULL ||
+        rt->frame_slot.handoff == NULL || rt->debug_memory_slot.mutex == NULL ||
         rt->breakpoint_slot.mutex == NULL || rt->symbol_slot.mutex == NULL ||
-        rt->rpc_payload_pool.mutex == NULL) {
+        rt->rpc_payload_pool.mutex == NULL || rt->ram_mirror == NULL) {
         runtime_destroy(rt);
         return NULL;
     }
@@ -299,6 +305,7 @@ runtime *runtime_create(const runtime_config *config)
     rt->client.symbol_slot = &rt->symbol_slot;
     rt->client.rpc_payload_pool = &rt->rpc_payload_pool;
     rt->client.frame_ring = &rt->frame_ring;
+    rt->client.ram_mirror = rt->ram_mirror;
     rt->client.next_request_token = 0;
     rt->next_breakpoint_id = 1;
 
@@ -327,11 +334,39 @@ runtime *runtime_create(const runtime_config *config)
         if (rt->frame_ring_memory_mb > 0u) {
             uint64_t budget =
                 (uint64_t)rt->frame_ring_memory_mb * 1024ull * 1024ull;
-            if (!runtime_frame_ring_init(&rt->frame_ring, budget)) {
+            runtime_frame_ring_mode mode =
+                config->frame_ring_mode == RUNTIME_FRAME_RING_MODE_VIDEO ?
+                    RUNTIME_FRAME_RING_MODE_VIDEO : RUNTIME_FRAME_RING_MODE_PIXELS;
+            if (!runtime_frame_ring_init(&rt->frame_ring, budget, mode)) {
                 /* leave zeroed / disabled */
             }
         }
 
+        /* Rewind buffer: allocation failure is nonfatal like the ring. */
+        if (config->rewind_memory_mb > 0u) {
+            rt->rewind = apple2_checkpoint_chain_create();
+            rt->rewind_budget_bytes = (uint64_t)config->rewind_memory_mb * 1024ull * 1024ull;
+            rt->rewind_interval_frames = config->rewind_interval_frames > 0u ?
+                config->rewind_interval_frames : RUNTIME_REWIND_DEFAULT_INTERVAL_FRAMES;
+        }
+
+        /* No writer thread: saves fall back to writing on the worker. */
+        rt->state_writer = runtime_state_writer_create();
+
+        /* Boot cache: a directory without a condition would never fill. */
+        rt->boot_cache_until_pc = config->boot_cache_until_pc;
+        if (config->boot_cache_until_text != NULL) {
+            snprintf(
+                rt->boot_cache_until_text,
+                sizeof(rt->boot_cache_until_text),
+                "%s",
+                config->boot_cache_until_text);
+        }
+        if (config->boot_cache_dir != NULL && config->boot_cache_dir[0] != '\0' &&
+            (rt->boot_cache_until_text[0] != '\0' || rt->boot_cache_until_pc >= 0)) {
+            rt->boot_cache_dir = runtime_copy_string(config->boot_cache_dir);
+        }
+
         /* CPU flight recorder (C3): default 256 MiB when configured; 0 = off. */
         rt->history_memory_mb = config->history_memory_mb;
         rt->history_off_on_max = config->history_off_on_max;
@@ -343,6 +378,11 @@ runtime *runtime_create(const runtime_config *config)
             /* NULL history is nonfatal (allocation failure). */
         }
 
+        /* Shared-memory publish: a region too small is nonfatal (off). */
+        if (config->shm_region != NULL) {
+            rt->shm = runtime_shm_writer_create(config->shm_region, config->shm_region_size);
+        }
+
         /* Breakpoint INI ownership is on runtime (path copied). */
         rt->use_ini = config->use_ini;
         rt->save_ini = config->save_ini;
@@ -431,9 +471,16 @@ void runtime_destroy(runtime *rt)
         rt->trace_file = NULL;
     }
     runtime_frame_ring_destroy(&rt->frame_ring);
+    free(rt->frame_capture);
+    rt->frame_capture = NULL;
+    apple2_checkpoint_chain_destroy(rt->rewind);
+    rt->rewind = NULL;
+    runtime_state_writer_destroy(rt->state_writer);
+    rt->state_writer = NULL;
+    free(rt->boot_cache_dir);
+    rt->boot_cache_dir = NULL;
     runtime_history_destroy(rt->history);
     rt->history = NULL;
-    free(rt->frame_slot.argb);
     free(rt->ini_path);
     rt->ini_path = NULL;
     for (j = 0; j < rt->diskii_mount_count; j++) {
@@ -451,13 +498,15 @@ void runtime_destroy(runtime *rt)
         }
         mutex_unlock(rt->rpc_payload_pool.mutex);
     }
-    mutex_destroy(rt->frame_slot.mutex);
+    runtime_frame_handoff_destroy(rt->frame_slot.handoff);
     mutex_destroy(rt->debug_memory_slot.mutex);
     mutex_destroy(rt->breakpoint_slot.mutex);
     mutex_destroy(rt->symbol_slot.mutex);
     mutex_destroy(rt->rpc_payload_pool.mutex);
-    message_queue_destroy(rt->event_queue);
-    message_queue_destroy(rt->command_queue);
+    runtime_ram_mirror_destroy(rt->ram_mirror);
+    runtime_shm_writer_destroy(rt->shm);
+    spsc_queue_destroy(rt->event_queue);
+    mpsc_queue_destroy(rt->command_queue);
     free(rt);
 }
 
@@ -485,7 +534,7 @@ void runtime_stop(runtime *rt)
     }
     memset(&command, 0, sizeof(command));
     command.type = RUNTIME_COMMAND_QUIT;
-    (void)message_queue_push(rt->command_queue, &command);
+    (void)mpsc_queue_push(rt->command_queue, &command);
     thread_join(rt->thread);
     thread_destroy(rt->thread);
     rt->thread = NULL;
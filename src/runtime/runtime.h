@@ -24,6 +24,9 @@ typedef struct runtime_client runtime_client;
 #define RUNTIME_TURBO_MAX 0u
 #define RUNTIME_TURBO_MHZ_1 1000u
 
+/* Frames between rewind checkpoints unless configured. */
+#define RUNTIME_REWIND_DEFAULT_INTERVAL_FRAMES 6u
+
 typedef struct runtime_config {
     const char *ini_path;
     const char *symbol_files;
@@ -48,6 +51,27 @@ typedef struct runtime_config {
     bool history_off_on_max;
     uint32_t frame_ring_memory_mb;
     bool frame_ring_memory_mb_configured;
+    /* Frame ring contents: 0 = painted pixels, 1 = video-memory captures
+       (runtime_frame_ring_mode). */
+    int frame_ring_mode;
+    /* Rewind buffer: in-memory checkpoints (apple2_checkpoint_chain) every
+       rewind_interval_frames frames, oldest dropped past the budget.
+       0 MiB = off (the default). */
+    uint32_t rewind_memory_mb;
+    uint32_t rewind_interval_frames;
+    /* Optional region (runtime_shm layout) the worker publishes the frame,
+       frame-ring window and RAM into; not owned, must outlive the runtime.
+       NULL = off. */
+    void *shm_region;
+    size_t shm_region_size;
+    /* Post-boot snapshot cache (runtime_boot_cache.h): at start, load the
+       cached state for this machine and media when there is one; otherwise
+       save it the first time the condition holds. NULL = off; needs
+       boot_cache_until_text (substring of a visible text row) or
+       boot_cache_until_pc >= 0. */
+    const char *boot_cache_dir;
+    const char *boot_cache_until_text;
+    int32_t boot_cache_until_pc;
 
     /* Apple-specific */
     int apple_model; /* 0=//e enh, 1=][+ */
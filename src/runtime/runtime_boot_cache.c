@@ -0,0 +1,158 @@
+#include "runtime_boot_cache.h"
+
+#include "apple2_snapshot.h"
+#include "platform_fs.h"
+#include "sha256.h"
+#include "video.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef A2M_VERSION
+#define A2M_VERSION ""
+#endif
+
+/* Length-prefixed, so neighbouring fields cannot run into each other. */
+static void boot_cache_hash_field(sha256_ctx *ctx, const void *data, size_t size)
+{
+    uint8_t length[4];
+
+    length[0] = (uint8_t)(size & 0xffu);
+    length[1] = (uint8_t)((size >> 8) & 0xffu);
+    length[2] = (uint8_t)((size >> 16) & 0xffu);
+    length[3] = (uint8_t)((size >> 24) & 0xffu);
+    sha256_update(ctx, length, sizeof(length));
+    if (size > 0) {
+        sha256_update(ctx, data, size);
+    }
+}
+
+static void boot_cache_hash_string(sha256_ctx *ctx, const char *text)
+{
+    boot_cache_hash_field(ctx, text != NULL ? text : "", text != NULL ? strlen(text) : 0u);
+}
+
+static void boot_cache_hash_int(sha256_ctx *ctx, int64_t value)
+{
+    uint8_t bytes[8];
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t)((uint64_t)value >> (i * 8));
+    }
+    boot_cache_hash_field(ctx, bytes, sizeof(bytes));
+}
+
+/* Path, then the digest of the image's bytes. */
+static bool boot_cache_hash_image(sha256_ctx *ctx, const char *path)
+{
+    uint8_t buffer[65536];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_ctx file_ctx;
+    FILE *file;
+    size_t n;
+    bool ok;
+
+    boot_cache_hash_string(ctx, path);
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    sha256_init(&file_ctx);
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        sha256_update(&file_ctx, buffer, n);
+    }
+    ok = ferror(file) == 0;
+    fclose(file);
+    sha256_final(&file_ctx, digest);
+    boot_cache_hash_field(ctx, digest, sizeof(digest));
+    return ok;
+}
+
+bool runtime_boot_cache_path(const runtime *rt, char *out, size_t out_size)
+{
+    const apple2_t *m = &rt->machine;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    char name[SHA256_HEX_SIZE + 5];
+    sha256_ctx ctx;
+    size_t i;
+    int slot;
+
+    sha256_init(&ctx);
+    boot_cache_hash_string(&ctx, "a2m-boot-cache/1");
+    boot_cache_hash_string(&ctx, A2M_VERSION);
+    boot_cache_hash_int(&ctx, A2_SNAPSHOT_VERSION);
+    boot_cache_hash_int(&ctx, (int64_t)m->model);
+    boot_cache_hash_int(&ctx, m->mb_slot);
+    boot_cache_hash_field(&ctx, m->rom_d000, m->rom_d000 != NULL ? m->rom_d000_size : 0u);
+    boot_cache_hash_field(&ctx, m->rom_c000, m->rom_c000 != NULL ? m->rom_c000_size : 0u);
+    boot_cache_hash_field(&ctx, m->rom_char, m->rom_char != NULL ? m->rom_char_size : 0u);
+    for (slot = 1; slot <= 7; slot++) {
+        boot_cache_hash_int(&ctx, (int64_t)m->slot_type[slot]);
+        if (m->slot_type[slot] == SLOT_TYPE_DISKII) {
+            boot_cache_hash_field(&ctx, m->diskii_rom_bytes[slot], sizeof(m->diskii_rom_bytes[slot]));
+        } else if (m->slot_type[slot] == SLOT_TYPE_SMARTPORT) {
+            boot_cache_hash_field(
+                &ctx, m->smartport_rom_bytes[slot], sizeof(m->smartport_rom_bytes[slot]));
+        }
+    }
+    for (i = 0; i < (size_t)rt->diskii_mount_count; i++) {
+        boot_cache_hash_int(&ctx, rt->diskii_slots[i] * 2 + rt->diskii_drives[i]);
+        if (rt->diskii_paths[i] != NULL && rt->diskii_paths[i][0] != '\0' &&
+            !boot_cache_hash_image(&ctx, rt->diskii_paths[i])) {
+            return false;
+        }
+    }
+    for (i = 0; i < (size_t)rt->smartport_mount_count; i++) {
+        boot_cache_hash_int(&ctx, rt->smartport_slots[i] * 2 + rt->smartport_units[i]);
+        if (rt->smartport_paths[i] != NULL && rt->smartport_paths[i][0] != '\0' &&
+            !boot_cache_hash_image(&ctx, rt->smartport_paths[i])) {
+            return false;
+        }
+    }
+    boot_cache_hash_int(&ctx, rt->config.smartport_boot_slot);
+    for (i = 0; i < rt->breakpoint_count; i++) {
+        const runtime_breakpoint *bp = &rt->breakpoints[i];
+
+        boot_cache_hash_int(&ctx, bp->enabled);
+        boot_cache_hash_int(&ctx, bp->start_address);
+        boot_cache_hash_int(&ctx, bp->has_end_address ? bp->end_address : -1);
+        boot_cache_hash_int(&ctx, bp->access_mask);
+        boot_cache_hash_int(&ctx, bp->action_mask);
+        boot_cache_hash_int(&ctx, bp->swap_slot);
+        boot_cache_hash_int(&ctx, bp->swap_param);
+        boot_cache_hash_int(&ctx, bp->swap_relative);
+        boot_cache_hash_string(&ctx, bp->type_text);
+    }
+    boot_cache_hash_string(&ctx, rt->boot_cache_until_text);
+    boot_cache_hash_int(&ctx, rt->boot_cache_until_pc);
+    sha256_final(&ctx, digest);
+
+    sha256_hex(digest, name);
+    strcat(name, ".a2sm");
+    platform_fs_path_join(out, out_size, rt->boot_cache_dir, name);
+    return strlen(out) + 1u < out_size;
+}
+
+bool runtime_boot_cache_text_visible(const runtime *rt)
+{
+    const apple2_t *m = &rt->machine;
+    uint8_t ram[APPLE2_VIDEO_TEXT_RAM_BYTES];
+    apple2_video_text text;
+    uint32_t row;
+
+    if (rt->boot_cache_until_text[0] == '\0') {
+        return false;
+    }
+    /* Layout of apple2_video_decode_text: main $400..$BFF, aux $400..$7FF. */
+    memcpy(ram, m->ram_main + 0x0400u, 0x0800u);
+    memcpy(ram + 0x0800u, m->ram_main + 0x10000u + 0x0400u, 0x0400u);
+    apple2_video_decode_text(
+        apple2_state_flags(m), m->model == APPLE2_MODEL_II_PLUS, ram, &text);
+    for (row = text.first_row; row < APPLE2_VIDEO_TEXT_ROWS; row++) {
+        if (strstr(text.rows[row], rt->boot_cache_until_text) != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
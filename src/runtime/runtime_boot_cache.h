@@ -0,0 +1,24 @@
+#pragma once
+
+/* Post-boot snapshot cache (runtime_config.boot_cache_*). Worker only.
+ *
+ * The key is a SHA-256 over everything that decides what a cold boot
+ * reaches: a2m and snapshot versions, model, slot cards, ROM images, each
+ * mounted image's slot, path and contents, the INI breakpoints (their TYPE
+ * and swap actions run during boot) and the capture condition. The cached
+ * state is "<dir>/<key>.a2sm" in a snapshot store, so entries share pages.
+ */
+
+#include "runtime_internal.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Cache path for the machine as mounted now; false when a mounted image
+   cannot be read or the path does not fit. */
+bool runtime_boot_cache_path(const runtime *rt, char *out, size_t out_size);
+
+/* True when a visible text row contains boot_cache_until_text (decoded as
+   get-text shows it). Decodes the screen: call once per frame, not per
+   cycle. */
+bool runtime_boot_cache_text_visible(const runtime *rt);
@@ -2,7 +2,7 @@
 
 #include "runtime_command.h"
 #include "runtime_internal.h"
-#include "message_queue.h"
+#include "lockfree_queue.h"
 #include "mutex.h"
 
 #include <stdio.h>
@@ -15,7 +15,16 @@ static bool runtime_client_push(runtime_client *client, runtime_command *command
         return false;
     }
     command->session_id = client->command_session_id;
-    return message_queue_push(client->command_queue, command);
+    if (!runtime_command_changes_memory(command->type)) {
+        return mpsc_queue_push(client->command_queue, command);
+    }
+    /* Count before queueing so a read issued after this push waits for it. */
+    runtime_ram_mirror_note_queued(client->ram_mirror);
+    if (!mpsc_queue_push(client->command_queue, command)) {
+        runtime_ram_mirror_note_dropped(client->ram_mirror);
+        return false;
+    }
+    return true;
 }
 
 static bool runtime_client_send_command_token(
@@ -207,6 +216,108 @@ bool runtime_client_request_memory_token(
     return runtime_client_push(client, &command);
 }
 
+/* Shared span checks: 1..RUNTIME_MEMORY_SPANS_MAX spans, each 1..65536
+   bytes, RUNTIME_MEMORY_SPANS_MAX_LENGTH in all. */
+static bool runtime_client_spans_total(
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint32_t *out_total)
+{
+    uint32_t total = 0;
+    uint32_t k;
+
+    if (spans == NULL || count == 0u || count > (uint32_t)RUNTIME_MEMORY_SPANS_MAX) {
+        return false;
+    }
+    for (k = 0; k < count; k++) {
+        if (spans[k].length == 0u ||
+            spans[k].length > (uint32_t)RUNTIME_MEMORY_RPC_MAX_LENGTH ||
+            spans[k].mode > (uint8_t)RUNTIME_MEMORY_MODE_LC2) {
+            return false;
+        }
+        total += spans[k].length;
+    }
+    if (total > (uint32_t)RUNTIME_MEMORY_SPANS_MAX_LENGTH) {
+        return false;
+    }
+    *out_total = total;
+    return true;
+}
+
+static void runtime_client_fill_spans(
+    runtime_command *command,
+    const runtime_memory_span *spans,
+    uint32_t count)
+{
+    command->data.memory_spans.count = count;
+    memcpy(command->data.memory_spans.spans, spans, count * sizeof(spans[0]));
+}
+
+bool runtime_client_request_memory_spans(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint64_t request_token) {
+    runtime_command command = {
+        .type = RUNTIME_COMMAND_REQUEST_MEMORY_SPANS,
+        .request_token = request_token,
+    };
+    uint32_t total;
+
+    if (!client || request_token == 0u || !runtime_client_spans_total(spans, count, &total)) {
+        return false;
+    }
+    runtime_client_fill_spans(&command, spans, count);
+    return runtime_client_push(client, &command);
+}
+
+bool runtime_client_write_memory_spans(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *bytes,
+    uint32_t length) {
+    runtime_command command = {
+        .type = RUNTIME_COMMAND_WRITE_MEMORY_SPANS,
+    };
+    runtime_rpc_payload_pool *pool;
+    uint32_t total;
+    bool parked = false;
+    size_t i;
+
+    if (!client || bytes == NULL || client->rpc_payload_pool == NULL ||
+        client->rpc_payload_pool->mutex == NULL ||
+        !runtime_client_spans_total(spans, count, &total) || total != length) {
+        free(bytes);
+        return false;
+    }
+    pool = client->rpc_payload_pool;
+    command.request_token = runtime_client_alloc_request_token(client);
+    mutex_lock(pool->mutex);
+    for (i = 0; i < RUNTIME_RPC_PAYLOAD_POOL_CAPACITY; ++i) {
+        if (!pool->slots[i].in_use) {
+            pool->slots[i].in_use = 1u;
+            pool->slots[i].kind = RUNTIME_RPC_PAYLOAD_MEMORY_WRITE;
+            pool->slots[i].request_token = command.request_token;
+            pool->slots[i].length = length;
+            pool->slots[i].bytes = bytes;
+            parked = true;
+            break;
+        }
+    }
+    mutex_unlock(pool->mutex);
+    if (!parked) {
+        free(bytes);
+        return false;
+    }
+    runtime_client_fill_spans(&command, spans, count);
+    if (!runtime_client_push(client, &command)) {
+        runtime_rpc_pool_release_token(pool, command.request_token);
+        return false;
+    }
+    return true;
+}
+
 bool runtime_client_claim_memory_rpc(
     runtime_client *client,
     uint64_t request_token,
@@ -598,6 +709,51 @@ bool runtime_client_load_state(runtime_client *client, const char *path) {
     return runtime_client_push(client, &command);
 }
 
+bool runtime_client_rewind(runtime_client *client, uint32_t frames, uint64_t request_token) {
+    runtime_command command = {
+        .type = RUNTIME_COMMAND_REWIND,
+        .request_token = request_token,
+    };
+
+    if (!client || frames == 0u) {
+        return false;
+    }
+
+    command.data.rewind.frames = frames;
+    return runtime_client_push(client, &command);
+}
+
+static bool runtime_client_seek(
+    runtime_client *client,
+    runtime_seek_kind kind,
+    uint64_t cycle,
+    uint64_t request_token) {
+    runtime_command command = {
+        .type = RUNTIME_COMMAND_SEEK,
+        .request_token = request_token,
+    };
+
+    if (!client) {
+        return false;
+    }
+
+    command.data.seek.kind = (uint8_t)kind;
+    command.data.seek.cycle = cycle;
+    return runtime_client_push(client, &command);
+}
+
+bool runtime_client_step_back(runtime_client *client, uint64_t request_token) {
+    return runtime_client_seek(client, RUNTIME_SEEK_STEP_BACK, 0u, request_token);
+}
+
+bool runtime_client_reverse_continue(runtime_client *client, uint64_t request_token) {
+    return runtime_client_seek(client, RUNTIME_SEEK_REVERSE_CONTINUE, 0u, request_token);
+}
+
+bool runtime_client_run_to_cycle(runtime_client *client, uint64_t cycle, uint64_t request_token) {
+    return runtime_client_seek(client, RUNTIME_SEEK_CYCLE, cycle, request_token);
+}
+
 bool runtime_client_set_disk_writable(
     runtime_client *client,
     uint8_t slot,
@@ -687,6 +843,14 @@ bool runtime_client_set_display_override(
     return runtime_client_push(client, &command);
 }
 
+bool runtime_client_batch_begin(runtime_client *client) {
+    return runtime_client_send_command(client, RUNTIME_COMMAND_BATCH_BEGIN);
+}
+
+bool runtime_client_batch_end(runtime_client *client) {
+    return runtime_client_send_command(client, RUNTIME_COMMAND_BATCH_END);
+}
+
 bool runtime_client_assemble_file(runtime_client *client, const char *path, uint16_t address) {
     runtime_command command = {
         .type = RUNTIME_COMMAND_ASSEMBLE_FILE,
@@ -810,47 +974,110 @@ bool runtime_client_apply_machine_config(
     return runtime_client_push(client, &command);
 }
 
-bool runtime_client_poll_argb_frame(
+const runtime_frame_buffer *runtime_client_acquire_frame_since(
     runtime_client *client,
-    uint32_t *out_pixels,
+    uint64_t *seen)
+{
+    const runtime_frame_buffer *fresh;
+
+    if (client == NULL || seen == NULL || client->frame_slot == NULL ||
+        client->frame_slot->handoff == NULL) {
+        return NULL;
+    }
+    fresh = runtime_frame_handoff_acquire(client->frame_slot->handoff);
+    if (fresh != NULL) {
+        client->frame_front = fresh;
+        client->frame_serial++;
+    }
+    if (client->frame_front == NULL || *seen == client->frame_serial) {
+        return NULL;
+    }
+    *seen = client->frame_serial;
+    return client->frame_front;
+}
+
+const runtime_frame_buffer *runtime_client_acquire_frame(runtime_client *client)
+{
+    if (client == NULL) {
+        return NULL;
+    }
+    return runtime_client_acquire_frame_since(client, &client->frame_seen);
+}
+
+static bool runtime_client_poll_frame(
+    runtime_client *client,
+    uint32_t *out_argb,
+    uint8_t *out_indexed,
     uint32_t max_pixels,
+    uint32_t *out_palette,
     uint32_t *out_width,
     uint32_t *out_height,
     uint64_t *out_frame_number)
 {
-    runtime_frame_slot *slot;
+    const runtime_frame_buffer *frame = runtime_client_acquire_frame(client);
     size_t n;
 
-    if (client == NULL || out_pixels == NULL || client->frame_slot == NULL) {
-        return false;
-    }
-    slot = client->frame_slot;
-    mutex_lock(slot->mutex);
-    if (!slot->has_frame || slot->argb == NULL) {
-        mutex_unlock(slot->mutex);
+    if (frame == NULL) {
         return false;
     }
-    n = (size_t)slot->width * (size_t)slot->height;
+    n = (size_t)frame->width * (size_t)frame->height;
     if (n > max_pixels) {
-        mutex_unlock(slot->mutex);
         return false;
     }
-    memcpy(out_pixels, slot->argb, n * sizeof(uint32_t));
+    if (out_argb != NULL) {
+        display_frame_expand_indexed8(out_argb, frame->pixels, n, frame->palette);
+    }
+    if (out_indexed != NULL) {
+        memcpy(out_indexed, frame->pixels, n);
+    }
+    if (out_palette != NULL) {
+        memcpy(out_palette, frame->palette, sizeof(frame->palette));
+    }
     if (out_width != NULL) {
-        *out_width = slot->width;
+        *out_width = frame->width;
     }
     if (out_height != NULL) {
-        *out_height = slot->height;
+        *out_height = frame->height;
     }
     if (out_frame_number != NULL) {
-        *out_frame_number = slot->frame_number;
+        *out_frame_number = frame->frame_number;
     }
-    slot->has_frame = false;
-    slot->consumed_frames++;
-    mutex_unlock(slot->mutex);
     return true;
 }
 
+bool runtime_client_poll_argb_frame(
+    runtime_client *client,
+    uint32_t *out_pixels,
+    uint32_t max_pixels,
+    uint32_t *out_width,
+    uint32_t *out_height,
+    uint64_t *out_frame_number)
+{
+    if (out_pixels == NULL) {
+        return false;
+    }
+    return runtime_client_poll_frame(
+        client, out_pixels, NULL, max_pixels, NULL,
+        out_width, out_height, out_frame_number);
+}
+
+bool runtime_client_poll_indexed_frame(
+    runtime_client *client,
+    uint8_t *out_pixels,
+    uint32_t max_pixels,
+    uint32_t *out_palette,
+    uint32_t *out_width,
+    uint32_t *out_height,
+    uint64_t *out_frame_number)
+{
+    if (out_pixels == NULL) {
+        return false;
+    }
+    return runtime_client_poll_frame(
+        client, NULL, out_pixels, max_pixels, out_palette,
+        out_width, out_height, out_frame_number);
+}
+
 bool runtime_client_poll_debug_memory(runtime_client *client, runtime_debug_memory_snapshot *out_snapshot) {
     runtime_debug_memory_slot *slot;
 
@@ -871,6 +1098,61 @@ bool runtime_client_poll_debug_memory(runtime_client *client, runtime_debug_memo
     return true;
 }
 
+bool runtime_client_read_memory_mirror(
+    runtime_client *client,
+    uint16_t address,
+    uint32_t length,
+    runtime_memory_mode mode,
+    uint8_t *out_bytes) {
+    if (!client || !out_bytes) {
+        return false;
+    }
+    return runtime_ram_mirror_read(client->ram_mirror, mode, address, length, out_bytes, NULL);
+}
+
+bool runtime_client_read_memory_mirror_spans(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out_bytes) {
+    return runtime_client_read_memory_mirror_spans_info(client, spans, count, out_bytes, NULL);
+}
+
+bool runtime_client_read_memory_mirror_spans_info(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out_bytes,
+    runtime_ram_mirror_info *out_info) {
+    if (!client || !out_bytes) {
+        return false;
+    }
+    return runtime_ram_mirror_read_spans(client->ram_mirror, spans, count, out_bytes, out_info);
+}
+
+bool runtime_client_read_machine_mirror(
+    runtime_client *client,
+    runtime_machine_snapshot *out_state) {
+    if (!client || !out_state) {
+        return false;
+    }
+    return runtime_ram_mirror_read_machine(client->ram_mirror, out_state, NULL);
+}
+
+bool runtime_client_read_memory_mirror_spans_machine(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out_bytes,
+    runtime_machine_snapshot *out_state,
+    runtime_ram_mirror_info *out_info) {
+    if (!client || !out_bytes || !out_state) {
+        return false;
+    }
+    return runtime_ram_mirror_read_spans_machine(
+        client->ram_mirror, spans, count, out_bytes, out_state, out_info);
+}
+
 bool runtime_client_poll_breakpoints(
     runtime_client *client,
     runtime_breakpoint_snapshot *out_snapshot) {
@@ -901,7 +1183,28 @@ bool runtime_client_poll_event(
         return false;
     }
 
-    return message_queue_try_pop(client->event_queue, out_event);
+    return spsc_queue_try_pop(client->event_queue, out_event);
+}
+
+bool runtime_client_wait_event(
+    runtime_client *client,
+    runtime_event *out_event,
+    uint32_t timeout_ms) {
+    if (!client || !out_event) {
+        return false;
+    }
+
+    return spsc_queue_wait_pop_timeout(client->event_queue, out_event, timeout_ms);
+}
+
+void runtime_client_set_event_wake(
+    runtime_client *client,
+    wake_event *wake) {
+    if (!client) {
+        return;
+    }
+
+    spsc_queue_set_wake_event(client->event_queue, wake);
 }
 
 bool runtime_client_step_out(runtime_client *client) {
@@ -1190,6 +1493,25 @@ bool runtime_client_copy_frame_at(
         runtime_frame_ring_copy_by_frame(client->frame_ring, target, out_frame);
 }
 
+bool runtime_client_copy_frame_strip(
+    runtime_client *client,
+    uint64_t first,
+    uint64_t last,
+    bool by_cycle,
+    uint32_t scale,
+    uint32_t count,
+    runtime_ring_thumbnail *out_thumbs,
+    uint32_t *out_count) {
+    if (client == NULL || client->frame_ring == NULL) {
+        if (out_count != NULL) {
+            *out_count = 0;
+        }
+        return false;
+    }
+    return runtime_frame_ring_copy_strip(
+        client->frame_ring, first, last, by_cycle, scale, count, out_thumbs, out_count);
+}
+
 void runtime_client_set_frame_ring_recording(runtime_client *client, bool recording) {
     if (client == NULL || client->frame_ring == NULL) {
         return;
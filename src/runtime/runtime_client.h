@@ -2,11 +2,14 @@
 
 #include "runtime_event.h"
 #include "runtime.h"
+#include "runtime_frame_handoff.h"
 #include "runtime_frame_ring.h"
+#include "runtime_ram_mirror.h"
 #include "apple2_file.h"
 
 #include "display_frame.h"
 #include "keyboard.h"
+#include "wake_event.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -91,6 +94,22 @@ bool runtime_client_claim_history_rpc(
 bool runtime_client_cancel_rpc(
     runtime_client *client,
     uint64_t request_token);
+/* Scatter-gather get-memory: one RPC whose bytes are every span's, back to
+   back; completes like runtime_client_request_memory_token. */
+bool runtime_client_request_memory_spans(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint64_t request_token);
+/* Scatter-gather write of length bytes (every span's, back to back). Takes
+   ownership of bytes, also on failure. Like write_memory, the worker skips
+   it while running. */
+bool runtime_client_write_memory_spans(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *bytes,
+    uint32_t length);
 bool runtime_client_request_memory_view(
     runtime_client *client,
     uint16_t address,
@@ -137,6 +156,16 @@ bool runtime_client_rearm_oneshot_breakpoints(runtime_client *client);
 bool runtime_client_request_breakpoints(runtime_client *client);
 bool runtime_client_save_state(runtime_client *client, const char *path);
 bool runtime_client_load_state(runtime_client *client, const char *path);
+/* Step back about frames frames through the rewind buffer (runtime_config
+   rewind_memory_mb); REWIND_COMPLETE echoes request_token. */
+bool runtime_client_rewind(runtime_client *client, uint32_t frames, uint64_t request_token);
+/* Reverse debugging over the rewind buffer; each pauses the machine and
+   answers SEEK_COMPLETE with request_token. step_back lands on the previous
+   instruction boundary, reverse_continue on the previous breakpoint stop,
+   run_to_cycle on the first boundary at or after cycle (either direction). */
+bool runtime_client_step_back(runtime_client *client, uint64_t request_token);
+bool runtime_client_reverse_continue(runtime_client *client, uint64_t request_token);
+bool runtime_client_run_to_cycle(runtime_client *client, uint64_t cycle, uint64_t request_token);
 /* Disk II write-protect notch (slot 1–7, drive 0/1). */
 bool runtime_client_set_disk_writable(
     runtime_client *client,
@@ -162,6 +191,10 @@ bool runtime_client_set_display_override(
     runtime_client *client,
     bool enabled,
     uint32_t flags);
+/* Commands pushed between begin and end are applied back-to-back: the worker
+   does not free-run until end (or RUNTIME_BATCH_HOLD_MS passes). */
+bool runtime_client_batch_begin(runtime_client *client);
+bool runtime_client_batch_end(runtime_client *client);
 bool runtime_client_assemble_file(runtime_client *client, const char *path, uint16_t address);
 bool runtime_client_assemble_file_full(
     runtime_client *client,
@@ -186,7 +219,18 @@ bool runtime_client_apply_machine_config(
     bool reset,
     bool save_ini,
     bool resume_running);
-/* Apple ARGB frame handoff. Caller provides buffer large enough for w*h. */
+/* Zero-copy frame handoff: newest published frame, or NULL when none is new.
+   The buffer stays valid until the next acquire/poll. Frames are handed to
+   one consumer thread (the UI loop, which also runs control dispatch). */
+const runtime_frame_buffer *runtime_client_acquire_frame(runtime_client *client);
+/* Same, for another consumer on that thread (control get-frame, frame
+   subscriptions): *seen (start at 0) is the consumer's own mark, so each one
+   sees every new frame instead of taking it from the others. */
+const runtime_frame_buffer *runtime_client_acquire_frame_since(
+    runtime_client *client,
+    uint64_t *seen);
+/* Apple ARGB frame handoff. Caller provides buffer large enough for w*h.
+   The slot holds palette indices; expansion happens here, at the UI edge. */
 bool runtime_client_poll_argb_frame(
     runtime_client *client,
     uint32_t *out_pixels,
@@ -194,7 +238,50 @@ bool runtime_client_poll_argb_frame(
     uint32_t *out_width,
     uint32_t *out_height,
     uint64_t *out_frame_number);
+/* Indexed frame handoff: w*h palette indices + DISPLAY_FRAME_PALETTE_SIZE
+   ARGB palette entries (out_palette may be NULL). */
+bool runtime_client_poll_indexed_frame(
+    runtime_client *client,
+    uint8_t *out_pixels,
+    uint32_t max_pixels,
+    uint32_t *out_palette,
+    uint32_t *out_width,
+    uint32_t *out_height,
+    uint64_t *out_frame_number);
 bool runtime_client_poll_debug_memory(runtime_client *client, runtime_debug_memory_snapshot *out_snapshot);
+/* Lock-free reads from the worker's RAM mirror (any thread, no command).
+   False when the mirror is not yet published or is behind a queued write;
+   fall back to runtime_client_request_memory_token / request_machine_state. */
+bool runtime_client_read_memory_mirror(
+    runtime_client *client,
+    uint16_t address,
+    uint32_t length,
+    runtime_memory_mode mode,
+    uint8_t *out_bytes);
+bool runtime_client_read_memory_mirror_spans(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out_bytes);
+/* Same, plus which publish the bytes came from (out_info may be NULL). */
+bool runtime_client_read_memory_mirror_spans_info(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out_bytes,
+    runtime_ram_mirror_info *out_info);
+bool runtime_client_read_machine_mirror(
+    runtime_client *client,
+    runtime_machine_snapshot *out_state);
+/* Spans plus the soft switches they were published with (out_info may be
+   NULL). */
+bool runtime_client_read_memory_mirror_spans_machine(
+    runtime_client *client,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out_bytes,
+    runtime_machine_snapshot *out_state,
+    runtime_ram_mirror_info *out_info);
 bool runtime_client_poll_breakpoints(
     runtime_client *client,
     runtime_breakpoint_snapshot *out_snapshot);
@@ -275,6 +362,17 @@ bool runtime_client_poll_event(
     runtime_client *client,
     runtime_event *out_event);
 
+/* Block up to timeout_ms for the next event. */
+bool runtime_client_wait_event(
+    runtime_client *client,
+    runtime_event *out_event,
+    uint32_t timeout_ms);
+
+/* Signal wake whenever the worker posts an event (NULL detaches). */
+void runtime_client_set_event_wake(
+    runtime_client *client,
+    wake_event *wake);
+
 /* Frame ring (rolling framebuffer black box). These read the runtime's ring
    directly; it carries its own mutex, so they are safe to call from the main
    thread while the runtime thread keeps pushing frames. */
@@ -288,6 +386,18 @@ bool runtime_client_copy_frame_at(
     bool by_cycle,
     runtime_ring_frame *out_frame);
 
+/* Up to count thumbnails sampled evenly over [first, last]
+   (runtime_frame_ring_copy_strip). */
+bool runtime_client_copy_frame_strip(
+    runtime_client *client,
+    uint64_t first,
+    uint64_t last,
+    bool by_cycle,
+    uint32_t scale,
+    uint32_t count,
+    runtime_ring_thumbnail *out_thumbs,
+    uint32_t *out_count);
+
 void runtime_client_set_frame_ring_recording(runtime_client *client, bool recording);
 
 void runtime_client_clear_frame_ring(runtime_client *client);
@@ -1 +1,36 @@
 #include "runtime_command.h"
+
+bool runtime_command_changes_memory(runtime_command_type type)
+{
+    switch (type) {
+    case RUNTIME_COMMAND_RESET:
+    case RUNTIME_COMMAND_RUN:
+    case RUNTIME_COMMAND_PAUSE:
+    case RUNTIME_COMMAND_STEP_CYCLE:
+    case RUNTIME_COMMAND_STEP_INSTRUCTION:
+    case RUNTIME_COMMAND_STEP_OVER:
+    case RUNTIME_COMMAND_STEP_OUT:
+    case RUNTIME_COMMAND_RUN_CYCLES:
+    case RUNTIME_COMMAND_RUN_INSTRUCTIONS:
+    case RUNTIME_COMMAND_RUN_TO_CURSOR:
+    case RUNTIME_COMMAND_KEYBOARD_KEY:
+    case RUNTIME_COMMAND_PASTE_TEXT:
+    case RUNTIME_COMMAND_WRITE_MEMORY_BYTE:
+    case RUNTIME_COMMAND_WRITE_MEMORY:
+    case RUNTIME_COMMAND_WRITE_MEMORY_SPANS:
+    case RUNTIME_COMMAND_SET_CPU_REGISTER:
+    case RUNTIME_COMMAND_LOAD_STATE:
+    case RUNTIME_COMMAND_REWIND:
+    case RUNTIME_COMMAND_SEEK:
+    case RUNTIME_COMMAND_LOAD_BIN:
+    case RUNTIME_COMMAND_ASSEMBLE_FILE:
+    case RUNTIME_COMMAND_MEDIA_INSERT:
+    case RUNTIME_COMMAND_MEDIA_EJECT:
+    case RUNTIME_COMMAND_MEDIA_SWAP:
+    case RUNTIME_COMMAND_BOOT_SLOT:
+    case RUNTIME_COMMAND_APPLY_MACHINE_CONFIG:
+        return true;
+    default:
+        return false;
+    }
+}
@@ -4,6 +4,7 @@
 #include "apple2_file.h"
 #include "keyboard.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -66,7 +67,18 @@ typedef enum runtime_command_type {
     RUNTIME_COMMAND_MEDIA_EJECT,
     RUNTIME_COMMAND_MEDIA_SWAP,
     RUNTIME_COMMAND_BOOT_SLOT,
-    RUNTIME_COMMAND_SET_DISPLAY_OVERRIDE
+    RUNTIME_COMMAND_SET_DISPLAY_OVERRIDE,
+    /* Bracket a run of commands the worker applies without free-running
+       in between (control `batch`). */
+    RUNTIME_COMMAND_BATCH_BEGIN,
+    RUNTIME_COMMAND_BATCH_END,
+    RUNTIME_COMMAND_REQUEST_MEMORY_SPANS,
+    RUNTIME_COMMAND_WRITE_MEMORY_SPANS,
+    /* Step back through the rewind buffer; answers REWIND_COMPLETE. */
+    RUNTIME_COMMAND_REWIND,
+    /* Step back / reverse-continue / run to a cycle using the rewind
+       buffer; pauses and answers SEEK_COMPLETE. */
+    RUNTIME_COMMAND_SEEK
 } runtime_command_type;
 
 enum {
@@ -141,6 +153,13 @@ typedef struct runtime_command {
             uint8_t bytes[RUNTIME_MEMORY_SNAPSHOT_MAX];
         } write_memory;
 
+        /* Scatter-gather memory. A write's bytes (every span's, back to
+           back) are parked in the RPC payload pool under request_token. */
+        struct {
+            uint32_t count;
+            runtime_memory_span spans[RUNTIME_MEMORY_SPANS_MAX];
+        } memory_spans;
+
         struct {
             uint16_t address;
             uint8_t enabled;
@@ -172,6 +191,15 @@ typedef struct runtime_command {
             char path[RUNTIME_COMMAND_PATH_MAX];
         } state_file;
 
+        struct {
+            uint32_t frames;
+        } rewind;
+
+        struct {
+            uint8_t kind;   /* runtime_seek_kind */
+            uint64_t cycle; /* RUNTIME_SEEK_CYCLE target */
+        } seek;
+
         struct {
             char path[RUNTIME_COMMAND_PATH_MAX];
             uint8_t slot;
@@ -315,3 +343,8 @@ typedef struct runtime_command {
         } set_history_off_on_max;
     } data;
 } runtime_command;
+
+/* True for commands that can change memory, soft switches or run state. The
+   RAM mirror counts these so readers never see bytes older than their own
+   writes (runtime_ram_mirror.h). */
+bool runtime_command_changes_memory(runtime_command_type type);
@@ -83,7 +83,9 @@ typedef enum runtime_event_type {
     RUNTIME_EVENT_HISTORY_RESULT_RESPONSE,
     RUNTIME_EVENT_SESSION_RESPONSE,
     RUNTIME_EVENT_STATE_CHANGED,
-    RUNTIME_EVENT_MEDIA_CHANGED
+    RUNTIME_EVENT_MEDIA_CHANGED,
+    RUNTIME_EVENT_REWIND_COMPLETE,
+    RUNTIME_EVENT_SEEK_COMPLETE
 } runtime_event_type;
 
 typedef enum runtime_state_changed_reason {
@@ -153,6 +155,10 @@ enum {
     RUNTIME_MEMORY_SNAPSHOT_MAX = 1024,
     /* Full 16-bit address space dump in one get-memory RPC. */
     RUNTIME_MEMORY_RPC_MAX_LENGTH = 65536,
+    /* Scatter-gather memory: spans per request, and total bytes (every
+       memory view in full). */
+    RUNTIME_MEMORY_SPANS_MAX = 64,
+    RUNTIME_MEMORY_SPANS_MAX_LENGTH = 6 * RUNTIME_MEMORY_RPC_MAX_LENGTH,
     RUNTIME_RPC_PAYLOAD_POOL_CAPACITY = 16,
     RUNTIME_RPC_MEMORY_POOL_CAPACITY =
         RUNTIME_RPC_PAYLOAD_POOL_CAPACITY,
@@ -162,6 +168,27 @@ enum {
     RUNTIME_BREAKPOINT_TYPE_TEXT_MAX = 256
 };
 
+/* Reverse debugging over the rewind buffer (RUNTIME_COMMAND_SEEK). */
+typedef enum runtime_seek_kind {
+    RUNTIME_SEEK_STEP_BACK = 0,
+    RUNTIME_SEEK_REVERSE_CONTINUE,
+    RUNTIME_SEEK_CYCLE
+} runtime_seek_kind;
+
+typedef enum runtime_seek_result {
+    RUNTIME_SEEK_OK = 0,
+    /* Rewind buffer off, empty, or the target is older than its oldest
+       checkpoint; nothing moved. */
+    RUNTIME_SEEK_NO_CHECKPOINT,
+    /* reverse-continue found no earlier hit; the machine is back where it
+       started. */
+    RUNTIME_SEEK_NO_BREAKPOINT,
+    /* Getting there means replaying across host input (keys, paste,
+       gameport, pokes, a reset or disk swap) the checkpoints do not record;
+       the machine is where it started. */
+    RUNTIME_SEEK_INPUT
+} runtime_seek_result;
+
 typedef enum runtime_memory_rpc_status {
     RUNTIME_MEMORY_RPC_OK = 0,
     RUNTIME_MEMORY_RPC_BUSY = 1,
@@ -288,6 +315,13 @@ typedef struct runtime_memory_rpc_meta {
     runtime_memory_rpc_status status;
 } runtime_memory_rpc_meta;
 
+/* One piece of a scatter-gather memory request; a span wraps at $FFFF. */
+typedef struct runtime_memory_span {
+    uint16_t address;
+    uint8_t mode;    /* runtime_memory_mode */
+    uint32_t length; /* 1..RUNTIME_MEMORY_RPC_MAX_LENGTH */
+} runtime_memory_span;
+
 typedef struct runtime_debug_memory_snapshot {
     uint64_t generation;
     uint8_t has_write_history;
@@ -301,6 +335,9 @@ typedef struct runtime_debug_memory_snapshot {
     uint8_t lc1_valid[MACHINE_ADDRESS_SPACE];
     uint8_t lc2_valid[MACHINE_ADDRESS_SPACE];
     uint64_t write_history[MACHINE_ADDRESS_SPACE];
+    /* Pages re-copied by this generation (all of them after a full rebuild). */
+    uint32_t dirty_page_count;
+    uint8_t dirty_pages[MACHINE_ADDRESS_SPACE / 256];
 } runtime_debug_memory_snapshot;
 
 typedef struct runtime_breakpoint_snapshot_entry {
@@ -414,6 +451,24 @@ typedef struct runtime_event {
             char path[1024];
         } state_file;
 
+        /* ok = 0: the rewind buffer is off or empty; nothing moved. */
+        struct {
+            uint8_t ok;
+            uint32_t frames; /* frames actually stepped back */
+            uint64_t frame_number;
+            uint64_t cycles;
+            uint32_t checkpoints; /* left in the buffer */
+        } rewind;
+
+        struct {
+            uint8_t kind;   /* runtime_seek_kind */
+            uint8_t result; /* runtime_seek_result */
+            uint8_t stop;   /* runtime_stop_reason the machine paused with */
+            uint16_t pc;
+            uint64_t cycles;
+            uint64_t frame_number;
+        } seek;
+
         struct {
             uint8_t slot;
             int32_t swap_param;
@@ -0,0 +1,84 @@
+/* runtime_frame_handoff.c — compiled at C11 (see CMakeLists.txt per-file property).
+   Uses C11 atomics for the ready index; the public header is C99-compatible. */
+
+#include "runtime_frame_handoff.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+enum {
+    RUNTIME_FRAME_HANDOFF_INDEX_MASK = 0x3u,
+    RUNTIME_FRAME_HANDOFF_FRESH = 0x4u
+};
+
+struct runtime_frame_handoff {
+    runtime_frame_buffer buffers[3];
+    /* Ready buffer index | FRESH when published and not yet acquired. */
+    _Atomic uint32_t ready;
+    uint32_t back;  /* producer only */
+    uint32_t front; /* consumer only */
+};
+
+runtime_frame_handoff *runtime_frame_handoff_create(uint32_t width, uint32_t height)
+{
+    runtime_frame_handoff *handoff;
+    size_t pixels = (size_t)width * (size_t)height;
+    int i;
+
+    handoff = (runtime_frame_handoff *)calloc(1, sizeof(*handoff));
+    if (handoff == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < 3; i++) {
+        handoff->buffers[i].pixels = (uint8_t *)calloc(pixels, 1);
+        handoff->buffers[i].width = width;
+        handoff->buffers[i].height = height;
+        if (handoff->buffers[i].pixels == NULL) {
+            runtime_frame_handoff_destroy(handoff);
+            return NULL;
+        }
+    }
+    handoff->back = 0u;
+    atomic_init(&handoff->ready, 1u);
+    handoff->front = 2u;
+    return handoff;
+}
+
+void runtime_frame_handoff_destroy(runtime_frame_handoff *handoff)
+{
+    int i;
+
+    if (handoff == NULL) {
+        return;
+    }
+    for (i = 0; i < 3; i++) {
+        free(handoff->buffers[i].pixels);
+    }
+    free(handoff);
+}
+
+runtime_frame_buffer *runtime_frame_handoff_back(runtime_frame_handoff *handoff)
+{
+    return &handoff->buffers[handoff->back];
+}
+
+bool runtime_frame_handoff_publish(runtime_frame_handoff *handoff)
+{
+    uint32_t previous = atomic_exchange_explicit(
+        &handoff->ready, handoff->back | RUNTIME_FRAME_HANDOFF_FRESH, memory_order_acq_rel);
+    handoff->back = previous & RUNTIME_FRAME_HANDOFF_INDEX_MASK;
+    return (previous & RUNTIME_FRAME_HANDOFF_FRESH) != 0u;
+}
+
+const runtime_frame_buffer *runtime_frame_handoff_acquire(runtime_frame_handoff *handoff)
+{
+    uint32_t previous;
+
+    if ((atomic_load_explicit(&handoff->ready, memory_order_acquire) &
+         RUNTIME_FRAME_HANDOFF_FRESH) == 0u) {
+        return NULL;
+    }
+    previous = atomic_exchange_explicit(&handoff->ready, handoff->front, memory_order_acq_rel);
+    handoff->front = previous & RUNTIME_FRAME_HANDOFF_INDEX_MASK;
+    return &handoff->buffers[handoff->front];
+}
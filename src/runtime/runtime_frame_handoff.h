@@ -0,0 +1,42 @@
+#pragma once
+
+/* Triple-buffered frame handoff between the worker (producer) and one
+ * consumer thread (the UI loop, which also drives control dispatch).
+ *
+ * Three buffers rotate between three roles: back (the machine paints into
+ * it), ready (newest published frame) and front (what the consumer last
+ * acquired). Publish swaps back and ready with one atomic exchange and tags
+ * ready as fresh; acquire swaps a fresh ready with front. The worker never
+ * touches front and the consumer never touches back, so neither side copies
+ * pixels or takes a lock. A publish that finds ready still fresh counts as a
+ * dropped frame.
+ */
+
+#include "display_frame.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct runtime_frame_buffer {
+    uint8_t *pixels; /* width × height palette indices */
+    uint32_t palette[DISPLAY_FRAME_PALETTE_SIZE];
+    uint32_t width;
+    uint32_t height;
+    uint64_t frame_number;
+    uint64_t machine_cycle;
+} runtime_frame_buffer;
+
+typedef struct runtime_frame_handoff runtime_frame_handoff;
+
+runtime_frame_handoff *runtime_frame_handoff_create(uint32_t width, uint32_t height);
+void runtime_frame_handoff_destroy(runtime_frame_handoff *handoff);
+
+/* Producer: buffer the machine should paint into. */
+runtime_frame_buffer *runtime_frame_handoff_back(runtime_frame_handoff *handoff);
+/* Producer: publish back (metadata filled in) and rotate to a new back.
+   Returns true when the previous ready frame was never acquired. */
+bool runtime_frame_handoff_publish(runtime_frame_handoff *handoff);
+
+/* Consumer: newest published frame, or NULL when nothing new was published
+   since the last acquire. Valid until the consumer's next acquire. */
+const runtime_frame_buffer *runtime_frame_handoff_acquire(runtime_frame_handoff *handoff);
@@ -3,21 +3,50 @@
 #include <stdlib.h>
 #include <string.h>
 
+enum {
+    /* Shortest repeat worth a run token (run header + value = 2 bytes). */
+    RING_RLE_RUN_MIN = 4,
+    RING_PALETTE_BYTES = DISPLAY_FRAME_PALETTE_SIZE * 4,
+    /* Video keyframe header: serialized capture length. */
+    RING_VIDEO_LENGTH_BYTES = 4,
+    RING_THUMB_SMALL_PIXELS = RUNTIME_FRAME_RING_THUMB_MAX_PIXELS,
+    RING_THUMB_TINY_PIXELS =
+        RUNTIME_FRAME_RING_PIXELS /
+        (RUNTIME_FRAME_RING_THUMB_SCALE_TINY * RUNTIME_FRAME_RING_THUMB_SCALE_TINY),
+    /* Both thumbnails (+ literal headers) ahead of the frame payload. */
+    RING_THUMB_SCRATCH_BYTES = RING_THUMB_SMALL_PIXELS + RING_THUMB_TINY_PIXELS + 16,
+    /* Keyframe worst case: thumbnails + palette + literal header + every index. */
+    RING_SCRATCH_BYTES =
+        RING_THUMB_SCRATCH_BYTES + RING_PALETTE_BYTES + RUNTIME_FRAME_RING_PIXELS + 64,
+    /* Serialized capture: frame u64, start flags u32, split count u16,
+       region mask u8, splits (u16 position + u32 flags), present regions. */
+    RING_VIDEO_HEADER_BYTES = 8 + 4 + 2 + 1,
+    RING_VIDEO_SPLIT_BYTES = 2 + 4,
+    RING_VIDEO_MAX_BYTES = RING_VIDEO_HEADER_BYTES +
+                           APPLE2_VIDEO_CAPTURE_MAX_SPLITS * RING_VIDEO_SPLIT_BYTES +
+                           APPLE2_VIDEO_CAPTURE_RAM_BYTES
+};
+
 static uint32_t runtime_frame_ring_tail(const runtime_frame_ring *ring)
 {
     return (ring->head + ring->capacity - ring->count) % ring->capacity;
 }
 
-static const runtime_ring_frame *runtime_frame_ring_at(
+static uint32_t runtime_frame_ring_slot(const runtime_frame_ring *ring, uint32_t index)
+{
+    return (runtime_frame_ring_tail(ring) + index) % ring->capacity;
+}
+
+static const runtime_ring_entry *runtime_frame_ring_at(
     const runtime_frame_ring *ring,
     uint32_t index)
 {
-    return &ring->slots[(runtime_frame_ring_tail(ring) + index) % ring->capacity];
+    return &ring->entries[runtime_frame_ring_slot(ring, index)];
 }
 
 static bool runtime_frame_ring_usable(const runtime_frame_ring *ring)
 {
-    return ring != NULL && ring->slots != NULL && ring->capacity > 0u;
+    return ring != NULL && ring->entries != NULL && ring->capacity > 0u;
 }
 
 static void runtime_frame_ring_lock(runtime_frame_ring *ring)
@@ -34,34 +63,374 @@ static void runtime_frame_ring_unlock(runtime_frame_ring *ring)
     }
 }
 
-bool runtime_frame_ring_init(runtime_frame_ring *ring, uint64_t budget_bytes)
+/*
+ * RLE token stream shared by keyframes and deltas. Each token is a LEB128
+ * header h with count = (h >> 1) + 1: odd h repeats the next byte count
+ * times, even h copies count literal bytes. Deltas encode indices XOR the
+ * previous frame, so unchanged spans become long zero runs.
+ */
+static size_t ring_rle_put_varint(uint8_t *out, size_t pos, size_t cap, uint32_t v)
+{
+    do {
+        uint8_t b = (uint8_t)(v & 0x7Fu);
+        v >>= 7;
+        if (v != 0u) {
+            b |= 0x80u;
+        }
+        if (pos >= cap) {
+            return 0;
+        }
+        out[pos++] = b;
+    } while (v != 0u);
+    return pos;
+}
+
+static uint8_t ring_rle_src(const uint8_t *src, const uint8_t *base, size_t i)
+{
+    return base != NULL ? (uint8_t)(src[i] ^ base[i]) : src[i];
+}
+
+static size_t ring_rle_put_literal(
+    const uint8_t *src,
+    const uint8_t *base,
+    size_t start,
+    size_t end,
+    uint8_t *out,
+    size_t pos,
+    size_t cap)
+{
+    size_t i;
+
+    if (end <= start) {
+        return pos;
+    }
+    pos = ring_rle_put_varint(out, pos, cap, (uint32_t)(end - start - 1u) << 1);
+    if (pos == 0u || pos + (end - start) > cap) {
+        return 0;
+    }
+    for (i = start; i < end; i++) {
+        out[pos++] = ring_rle_src(src, base, i);
+    }
+    return pos;
+}
+
+/* Encode n bytes of src (XOR base when non-NULL). Returns bytes written, 0 on overflow. */
+static size_t ring_rle_encode(
+    const uint8_t *src,
+    const uint8_t *base,
+    size_t n,
+    uint8_t *out,
+    size_t cap)
+{
+    size_t pos = 0;
+    size_t literal = 0;
+    size_t i = 0;
+
+    while (i < n) {
+        uint8_t b = ring_rle_src(src, base, i);
+        size_t j = i + 1u;
+
+        while (j < n && ring_rle_src(src, base, j) == b) {
+            j++;
+        }
+        if (j - i >= RING_RLE_RUN_MIN) {
+            if (literal < i) {
+                pos = ring_rle_put_literal(src, base, literal, i, out, pos, cap);
+                if (pos == 0u) {
+                    return 0;
+                }
+            }
+            pos = ring_rle_put_varint(out, pos, cap, ((uint32_t)(j - i - 1u) << 1) | 1u);
+            if (pos == 0u || pos >= cap) {
+                return 0;
+            }
+            out[pos++] = b;
+            literal = j;
+        }
+        i = j;
+    }
+    if (literal < n) {
+        pos = ring_rle_put_literal(src, base, literal, n, out, pos, cap);
+    }
+    return pos;
+}
+
+/* Decode into dst (n bytes). xor applies tokens on top of dst instead of storing. */
+static bool ring_rle_decode(
+    const uint8_t *in,
+    size_t in_size,
+    uint8_t *dst,
+    size_t n,
+    bool xor)
+{
+    size_t pos = 0;
+    size_t o = 0;
+
+    while (pos < in_size) {
+        uint32_t h = 0;
+        unsigned shift = 0;
+        size_t count;
+        size_t k;
+
+        for (;;) {
+            uint8_t b;
+            if (pos >= in_size || shift > 28u) {
+                return false;
+            }
+            b = in[pos++];
+            h |= (uint32_t)(b & 0x7Fu) << shift;
+            if ((b & 0x80u) == 0u) {
+                break;
+            }
+            shift += 7u;
+        }
+        count = (size_t)(h >> 1) + 1u;
+        if (o + count > n) {
+            return false;
+        }
+        if ((h & 1u) != 0u) {
+            uint8_t v;
+            if (pos >= in_size) {
+                return false;
+            }
+            v = in[pos++];
+            if (!xor) {
+                memset(dst + o, v, count);
+            } else if (v != 0u) {
+                for (k = 0; k < count; k++) {
+                    dst[o + k] ^= v;
+                }
+            }
+        } else {
+            if (pos + count > in_size) {
+                return false;
+            }
+            if (xor) {
+                for (k = 0; k < count; k++) {
+                    dst[o + k] ^= in[pos + k];
+                }
+            } else {
+                memcpy(dst + o, in + pos, count);
+            }
+            pos += count;
+        }
+        o += count;
+    }
+    return o == n;
+}
+
+static void ring_put_le(uint8_t *out, uint64_t v, int bytes)
+{
+    int i;
+    for (i = 0; i < bytes; i++) {
+        out[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint64_t ring_get_le(const uint8_t *in, int bytes)
+{
+    uint64_t v = 0;
+    int i;
+    for (i = 0; i < bytes; i++) {
+        v |= (uint64_t)in[i] << (8 * i);
+    }
+    return v;
+}
+
+/* Flatten a capture (only the regions it holds) into out; returns its size. */
+static size_t ring_video_serialize(const apple2_video_capture *capture, uint8_t *out)
+{
+    size_t pos = 0;
+    uint16_t splits = capture->split_count;
+    uint16_t i;
+    int r;
+
+    if (splits > APPLE2_VIDEO_CAPTURE_MAX_SPLITS) {
+        splits = APPLE2_VIDEO_CAPTURE_MAX_SPLITS;
+    }
+    /* Only the flash phase of the frame number affects the picture; keep
+       just that so an unchanged screen serializes identically (repeat). */
+    ring_put_le(out + pos,
+                ((capture->frame_number / APPLE2_VIDEO_FLASH_FRAMES) & 1u) *
+                    APPLE2_VIDEO_FLASH_FRAMES,
+                8);
+    pos += 8u;
+    ring_put_le(out + pos, capture->start_flags, 4);
+    pos += 4u;
+    ring_put_le(out + pos, splits, 2);
+    pos += 2u;
+    out[pos++] = capture->region_mask;
+    for (i = 0; i < splits; i++) {
+        ring_put_le(out + pos, capture->splits[i].position, 2);
+        ring_put_le(out + pos + 2u, capture->splits[i].flags, 4);
+        pos += RING_VIDEO_SPLIT_BYTES;
+    }
+    for (r = 0; r < APPLE2_VIDEO_CAPTURE_REGION_COUNT; r++) {
+        if (capture->region_mask & (1u << r)) {
+            uint32_t size = apple2_video_capture_region_size(r);
+            memcpy(out + pos, capture->ram + apple2_video_capture_region_offset(r), size);
+            pos += size;
+        }
+    }
+    return pos;
+}
+
+static bool ring_video_deserialize(
+    const uint8_t *in,
+    size_t size,
+    apple2_video_capture *capture)
+{
+    size_t pos = RING_VIDEO_HEADER_BYTES;
+    uint16_t i;
+    int r;
+
+    if (size < RING_VIDEO_HEADER_BYTES) {
+        return false;
+    }
+    capture->frame_number = ring_get_le(in, 8);
+    capture->start_flags = (uint32_t)ring_get_le(in + 8, 4);
+    capture->split_count = (uint16_t)ring_get_le(in + 12, 2);
+    capture->region_mask = in[14];
+    if (capture->split_count > APPLE2_VIDEO_CAPTURE_MAX_SPLITS ||
+        size - pos < (size_t)capture->split_count * RING_VIDEO_SPLIT_BYTES) {
+        return false;
+    }
+    for (i = 0; i < capture->split_count; i++) {
+        capture->splits[i].position = (uint16_t)ring_get_le(in + pos, 2);
+        capture->splits[i].flags = (uint32_t)ring_get_le(in + pos + 2u, 4);
+        pos += RING_VIDEO_SPLIT_BYTES;
+    }
+    for (r = 0; r < APPLE2_VIDEO_CAPTURE_REGION_COUNT; r++) {
+        if (capture->region_mask & (1u << r)) {
+            uint32_t region = apple2_video_capture_region_size(r);
+            if (size - pos < region) {
+                return false;
+            }
+            memcpy(capture->ram + apple2_video_capture_region_offset(r), in + pos, region);
+            pos += region;
+        }
+    }
+    return pos == size;
+}
+
+/*
+ * Reduce indices by scale per axis: each output pixel is the most common
+ * non-black index in its block when at least a quarter of the block is lit,
+ * so thin text and HGR lines survive the shrink.
+ */
+static void ring_thumbnail(const uint8_t *src, uint32_t scale, uint8_t *dst)
+{
+    const uint32_t width = (uint32_t)DISPLAY_FRAME_WIDTH / scale;
+    const uint32_t height = (uint32_t)DISPLAY_FRAME_HEIGHT / scale;
+    uint32_t tx;
+    uint32_t ty;
+
+    for (ty = 0; ty < height; ty++) {
+        for (tx = 0; tx < width; tx++) {
+            uint32_t counts[DISPLAY_FRAME_PALETTE_SIZE];
+            uint32_t lit = 0;
+            uint32_t best = 0;
+            uint32_t best_count = 0;
+            uint32_t x;
+            uint32_t y;
+            uint32_t c;
+
+            memset(counts, 0, sizeof(counts));
+            for (y = 0; y < scale; y++) {
+                const uint8_t *row =
+                    src + (size_t)(ty * scale + y) * DISPLAY_FRAME_WIDTH + tx * scale;
+                for (x = 0; x < scale; x++) {
+                    counts[row[x] & 0x0Fu]++;
+                }
+            }
+            for (c = 1; c < DISPLAY_FRAME_PALETTE_SIZE; c++) {
+                lit += counts[c];
+                if (counts[c] > best_count) {
+                    best = c;
+                    best_count = counts[c];
+                }
+            }
+            dst[ty * width + tx] = (uint8_t)(lit * 4u >= scale * scale ? best : 0u);
+        }
+    }
+}
+
+const char *runtime_frame_ring_mode_name(runtime_frame_ring_mode mode)
+{
+    return mode == RUNTIME_FRAME_RING_MODE_VIDEO ? "video" : "pixels";
+}
+
+static void runtime_frame_ring_free_buffers(runtime_frame_ring *ring)
+{
+    mutex_destroy(ring->mutex);
+    free(ring->entries);
+    free(ring->arena);
+    free(ring->previous);
+    free(ring->scratch);
+    free(ring->thumbs);
+    free(ring->strip_frame);
+    free(ring->video_bytes);
+    free(ring->capture);
+    free(ring->render_scratch);
+    free(ring->rom_char);
+    memset(ring, 0, sizeof(*ring));
+}
+
+bool runtime_frame_ring_init(
+    runtime_frame_ring *ring,
+    uint64_t budget_bytes,
+    runtime_frame_ring_mode mode)
 {
     uint64_t capacity;
+    uint64_t fixed;
 
     if (ring == NULL) {
         return false;
     }
     memset(ring, 0, sizeof(*ring));
 
-    capacity = budget_bytes / (uint64_t)sizeof(runtime_ring_frame);
+    capacity = budget_bytes / (uint64_t)RUNTIME_FRAME_RING_BYTES_PER_ENTRY;
     if (capacity == 0u) {
         return false;
     }
     if (capacity > 0xffffffffu) {
         capacity = 0xffffffffu;
     }
-
-    ring->slots = calloc((size_t)capacity, sizeof(runtime_ring_frame));
-    if (ring->slots == NULL) {
+    /* Index + encoder buffers come out of the budget; the rest is arena. */
+    fixed = capacity * (uint64_t)sizeof(runtime_ring_entry) +
+            (uint64_t)RUNTIME_FRAME_RING_PIXELS + (uint64_t)RING_SCRATCH_BYTES +
+            (uint64_t)RING_THUMB_SMALL_PIXELS + (uint64_t)RING_THUMB_TINY_PIXELS +
+            (uint64_t)sizeof(runtime_ring_frame);
+    if (budget_bytes < fixed + (uint64_t)RING_SCRATCH_BYTES ||
+        budget_bytes - fixed > (uint64_t)SIZE_MAX) {
         return false;
     }
+
+    ring->entries = calloc((size_t)capacity, sizeof(runtime_ring_entry));
+    ring->arena_size = (size_t)(budget_bytes - fixed);
+    ring->arena = malloc(ring->arena_size);
+    ring->previous = malloc((size_t)RUNTIME_FRAME_RING_PIXELS);
+    ring->scratch = malloc((size_t)RING_SCRATCH_BYTES);
+    ring->thumbs = malloc((size_t)RING_THUMB_SMALL_PIXELS + RING_THUMB_TINY_PIXELS);
+    ring->strip_frame = malloc(sizeof(*ring->strip_frame));
     ring->mutex = mutex_create();
-    if (ring->mutex == NULL) {
-        free(ring->slots);
-        memset(ring, 0, sizeof(*ring));
+    if (mode == RUNTIME_FRAME_RING_MODE_VIDEO) {
+        ring->video_bytes = malloc((size_t)RING_VIDEO_MAX_BYTES);
+        ring->capture = malloc(sizeof(*ring->capture));
+        ring->render_scratch = calloc((size_t)APPLE2_VIDEO_RENDER_SCRATCH_BYTES, 1u);
+    }
+    if (ring->entries == NULL || ring->arena == NULL || ring->previous == NULL ||
+        ring->scratch == NULL || ring->thumbs == NULL || ring->strip_frame == NULL ||
+        ring->mutex == NULL ||
+        (mode == RUNTIME_FRAME_RING_MODE_VIDEO &&
+         (ring->video_bytes == NULL || ring->capture == NULL ||
+          ring->render_scratch == NULL))) {
+        runtime_frame_ring_free_buffers(ring);
         return false;
     }
+    ring->mode = mode;
     ring->capacity = (uint32_t)capacity;
+    ring->budget_bytes = budget_bytes;
     ring->recording = true;
     return true;
 }
@@ -71,9 +440,17 @@ void runtime_frame_ring_destroy(runtime_frame_ring *ring)
     if (ring == NULL) {
         return;
     }
-    mutex_destroy(ring->mutex);
-    free(ring->slots);
-    memset(ring, 0, sizeof(*ring));
+    runtime_frame_ring_free_buffers(ring);
+}
+
+static void runtime_frame_ring_reset_locked(runtime_frame_ring *ring)
+{
+    ring->count = 0u;
+    ring->head = 0u;
+    ring->arena_head = 0u;
+    ring->arena_used = 0u;
+    ring->has_previous = false;
+    ring->since_keyframe = 0u;
 }
 
 void runtime_frame_ring_clear(runtime_frame_ring *ring)
@@ -82,9 +459,10 @@ void runtime_frame_ring_clear(runtime_frame_ring *ring)
         return;
     }
     runtime_frame_ring_lock(ring);
-    ring->count = 0u;
-    ring->head = 0u;
+    runtime_frame_ring_reset_locked(ring);
     ring->dropped = 0u;
+    ring->keyframes = 0u;
+    ring->repeats = 0u;
     runtime_frame_ring_unlock(ring);
 }
 
@@ -98,18 +476,289 @@ void runtime_frame_ring_set_recording(runtime_frame_ring *ring, bool recording)
     runtime_frame_ring_unlock(ring);
 }
 
+void runtime_frame_ring_truncate(runtime_frame_ring *ring, uint64_t frame_number)
+{
+    const runtime_ring_entry *newest;
+
+    if (!runtime_frame_ring_usable(ring)) {
+        return;
+    }
+    runtime_frame_ring_lock(ring);
+    while (ring->count > 0u) {
+        newest = runtime_frame_ring_at(ring, ring->count - 1u);
+        if (newest->frame_number < frame_number) {
+            break;
+        }
+        ring->arena_used -= newest->size;
+        ring->head = (ring->head + ring->capacity - 1u) % ring->capacity;
+        ring->count--;
+    }
+    if (ring->count > 0u) {
+        newest = runtime_frame_ring_at(ring, ring->count - 1u);
+        ring->arena_head = newest->offset + newest->size;
+    } else {
+        ring->arena_head = 0u;
+    }
+    /* The encoder's previous frame is gone: start over with a keyframe. */
+    ring->has_previous = false;
+    ring->since_keyframe = 0u;
+    runtime_frame_ring_unlock(ring);
+}
+
+/* Drop the oldest keyframe and the deltas / repeats that depend on it. */
+static void runtime_frame_ring_evict_group_locked(runtime_frame_ring *ring)
+{
+    do {
+        const runtime_ring_entry *oldest = runtime_frame_ring_at(ring, 0u);
+        ring->arena_used -= oldest->size;
+        ring->count--;
+        ring->dropped++;
+    } while (ring->count > 0u &&
+             runtime_frame_ring_at(ring, 0u)->kind != RUNTIME_RING_ENTRY_KEY);
+    if (ring->count == 0u) {
+        ring->arena_head = 0u;
+        ring->since_keyframe = 0u;
+    }
+}
+
+/* Contiguous arena placement after the newest payload; false if it would
+   overwrite the oldest retained payload. */
+static bool runtime_frame_ring_place_locked(
+    const runtime_frame_ring *ring,
+    size_t size,
+    size_t *out_offset)
+{
+    size_t tail;
+    size_t head = ring->arena_head;
+
+    if (ring->count == 0u) {
+        *out_offset = 0u;
+        return size <= ring->arena_size;
+    }
+    tail = runtime_frame_ring_at(ring, 0u)->offset;
+    if (head >= tail) {
+        if (size <= ring->arena_size - head) {
+            *out_offset = head;
+            return true;
+        }
+        if (size < tail) {
+            *out_offset = 0u;
+            return true;
+        }
+        return false;
+    }
+    if (size < tail - head) {
+        *out_offset = head;
+        return true;
+    }
+    return false;
+}
+
+/* Keyframe header: the palette (pixels mode) or the serialized capture
+   length (video mode; the palette is the machine's). */
+static size_t runtime_frame_ring_key_header_bytes(const runtime_frame_ring *ring)
+{
+    return ring->mode == RUNTIME_FRAME_RING_MODE_VIDEO ?
+        (size_t)RING_VIDEO_LENGTH_BYTES : (size_t)RING_PALETTE_BYTES;
+}
+
+/* Keyframe payload into out (cap bytes): header + RLE. 0 on overflow. */
+static size_t runtime_frame_ring_encode_key(
+    const runtime_frame_ring *ring,
+    const uint8_t *bytes,
+    const uint32_t *palette,
+    size_t n,
+    uint8_t *out,
+    size_t cap)
+{
+    size_t header = runtime_frame_ring_key_header_bytes(ring);
+    size_t size;
+
+    if (ring->mode == RUNTIME_FRAME_RING_MODE_VIDEO) {
+        ring_put_le(out, (uint64_t)n, RING_VIDEO_LENGTH_BYTES);
+    } else {
+        memcpy(out, palette, RING_PALETTE_BYTES);
+    }
+    size = ring_rle_encode(bytes, NULL, n, out + header, cap - header);
+    return size == 0u ? 0u : size + header;
+}
+
+/* Shrink pixels to both thumbnail scales and RLE them into scratch. */
+static bool runtime_frame_ring_encode_thumbs(
+    runtime_frame_ring *ring,
+    const uint8_t *pixels,
+    uint16_t *out_small,
+    uint16_t *out_tiny)
+{
+    uint8_t *tiny = ring->thumbs + RING_THUMB_SMALL_PIXELS;
+    size_t small_size;
+    size_t tiny_size;
+
+    ring_thumbnail(pixels, RUNTIME_FRAME_RING_THUMB_SCALE_SMALL, ring->thumbs);
+    ring_thumbnail(pixels, RUNTIME_FRAME_RING_THUMB_SCALE_TINY, tiny);
+    small_size = ring_rle_encode(
+        ring->thumbs, NULL, RING_THUMB_SMALL_PIXELS, ring->scratch, RING_THUMB_SCRATCH_BYTES);
+    if (small_size == 0u) {
+        return false;
+    }
+    tiny_size = ring_rle_encode(
+        tiny, NULL, RING_THUMB_TINY_PIXELS, ring->scratch + small_size,
+        RING_THUMB_SCRATCH_BYTES - small_size);
+    if (tiny_size == 0u) {
+        return false;
+    }
+    *out_small = (uint16_t)small_size;
+    *out_tiny = (uint16_t)tiny_size;
+    return true;
+}
+
+/* Key: thumbnails + payload into scratch. Delta: payload only (strips
+   derive its thumbnails by decoding). Returns total size, 0 on overflow. */
+static size_t runtime_frame_ring_encode_body_locked(
+    runtime_frame_ring *ring,
+    uint8_t kind,
+    const uint8_t *bytes,
+    size_t n,
+    const uint32_t *palette,
+    const uint8_t *pixels,
+    uint16_t *out_small,
+    uint16_t *out_tiny)
+{
+    size_t thumbs = 0;
+    size_t size;
+
+    *out_small = 0;
+    *out_tiny = 0;
+    if (kind == RUNTIME_RING_ENTRY_KEY) {
+        if (!runtime_frame_ring_encode_thumbs(ring, pixels, out_small, out_tiny)) {
+            return 0;
+        }
+        thumbs = (size_t)*out_small + *out_tiny;
+    }
+    if (kind == RUNTIME_RING_ENTRY_KEY) {
+        size = runtime_frame_ring_encode_key(
+            ring, bytes, palette, n, ring->scratch + thumbs,
+            (size_t)RING_SCRATCH_BYTES - thumbs);
+    } else {
+        size = ring_rle_encode(
+            bytes, ring->previous, n, ring->scratch + thumbs,
+            (size_t)RING_SCRATCH_BYTES - thumbs);
+    }
+    return size == 0u ? 0u : size + thumbs;
+}
+
+/* Append one frame's bytes (indices, or a serialized capture) as a key,
+   delta or repeat entry; pixels feeds the thumbnails. Called with the ring
+   locked and recording. */
+static bool runtime_frame_ring_append_locked(
+    runtime_frame_ring *ring,
+    uint64_t frame_number,
+    uint64_t machine_cycle,
+    const uint8_t *bytes,
+    size_t n,
+    const uint32_t *palette,
+    const uint8_t *pixels)
+{
+    runtime_ring_entry *slot;
+    uint8_t kind;
+    size_t size = 0;
+    size_t offset = 0;
+    uint16_t thumb_small = 0;
+    uint16_t thumb_tiny = 0;
+    bool needs_key;
+
+    if (ring->count > 0u) {
+        const runtime_ring_entry *newest = runtime_frame_ring_at(ring, ring->count - 1u);
+        if (frame_number < newest->frame_number || machine_cycle < newest->machine_cycle) {
+            /* Keep the index sorted for binary search: time went backwards. */
+            runtime_frame_ring_reset_locked(ring);
+        }
+    }
+
+    needs_key = ring->count == 0u || !ring->has_previous ||
+                ring->since_keyframe + 1u >= (uint32_t)RUNTIME_FRAME_RING_KEYFRAME_INTERVAL ||
+                n != ring->previous_size ||
+                (palette != NULL &&
+                 memcmp(palette, ring->previous_palette, RING_PALETTE_BYTES) != 0);
+    kind = RUNTIME_RING_ENTRY_REPEAT;
+    if (needs_key || memcmp(bytes, ring->previous, n) != 0) {
+        kind = needs_key ? RUNTIME_RING_ENTRY_KEY : RUNTIME_RING_ENTRY_DELTA;
+        size = runtime_frame_ring_encode_body_locked(
+            ring, kind, bytes, n, palette, pixels, &thumb_small, &thumb_tiny);
+        if (size == 0u) {
+            return false;
+        }
+    }
+
+    for (;;) {
+        if (ring->count < ring->capacity &&
+            runtime_frame_ring_place_locked(ring, size, &offset)) {
+            break;
+        }
+        if (ring->count == 0u) {
+            return false;
+        }
+        runtime_frame_ring_evict_group_locked(ring);
+        if (ring->count == 0u && kind != RUNTIME_RING_ENTRY_KEY) {
+            /* The base this entry referred to is gone. */
+            kind = RUNTIME_RING_ENTRY_KEY;
+            size = runtime_frame_ring_encode_body_locked(
+                ring, kind, bytes, n, palette, pixels, &thumb_small, &thumb_tiny);
+            if (size == 0u) {
+                return false;
+            }
+        }
+    }
+
+    slot = &ring->entries[ring->head];
+    slot->frame_number = frame_number;
+    slot->machine_cycle = machine_cycle;
+    slot->offset = offset;
+    slot->size = (uint32_t)size;
+    slot->thumb_small_size = thumb_small;
+    slot->thumb_tiny_size = thumb_tiny;
+    slot->kind = kind;
+    if (size > 0u) {
+        memcpy(ring->arena + offset, ring->scratch, size);
+    }
+    ring->arena_head = offset + size;
+    ring->arena_used += size;
+
+    if (kind == RUNTIME_RING_ENTRY_KEY) {
+        ring->since_keyframe = 0u;
+        ring->keyframes++;
+        if (palette != NULL) {
+            memcpy(ring->previous_palette, palette, RING_PALETTE_BYTES);
+        }
+    } else {
+        ring->since_keyframe++;
+    }
+    if (kind == RUNTIME_RING_ENTRY_REPEAT) {
+        ring->repeats++;
+    } else {
+        memcpy(ring->previous, bytes, n);
+        ring->previous_size = n;
+    }
+    ring->has_previous = true;
+
+    ring->head = (ring->head + 1u) % ring->capacity;
+    ring->count++;
+    return true;
+}
+
 bool runtime_frame_ring_push(
     runtime_frame_ring *ring,
     uint64_t frame_number,
     uint64_t machine_cycle,
     uint32_t width,
     uint32_t height,
-    const uint32_t *pixels)
+    const uint8_t *pixels,
+    const uint32_t *palette)
 {
-    runtime_ring_frame *slot;
-    size_t n;
+    bool ok = false;
 
-    if (!runtime_frame_ring_usable(ring) || pixels == NULL) {
+    if (!runtime_frame_ring_usable(ring) || pixels == NULL || palette == NULL ||
+        ring->mode != RUNTIME_FRAME_RING_MODE_PIXELS) {
         return false;
     }
     if (width != (uint32_t)DISPLAY_FRAME_WIDTH ||
@@ -117,30 +766,62 @@ bool runtime_frame_ring_push(
         return false;
     }
 
+    runtime_frame_ring_lock(ring);
+    if (ring->recording) {
+        ok = runtime_frame_ring_append_locked(
+            ring, frame_number, machine_cycle, pixels,
+            (size_t)width * (size_t)height, palette, pixels);
+    }
+    runtime_frame_ring_unlock(ring);
+    return ok;
+}
+
+bool runtime_frame_ring_push_video(
+    runtime_frame_ring *ring,
+    uint64_t frame_number,
+    uint64_t machine_cycle,
+    const uint8_t *pixels,
+    const apple2_video_capture *capture,
+    const uint8_t *rom_char,
+    size_t rom_char_size,
+    bool ii_plus)
+{
+    bool ok = false;
+
+    if (!runtime_frame_ring_usable(ring) || pixels == NULL || capture == NULL ||
+        ring->mode != RUNTIME_FRAME_RING_MODE_VIDEO) {
+        return false;
+    }
+
     runtime_frame_ring_lock(ring);
     if (!ring->recording) {
         runtime_frame_ring_unlock(ring);
         return false;
     }
-
-    slot = &ring->slots[ring->head];
-    slot->width = width;
-    slot->height = height;
-    slot->stride_bytes = width * 4u;
-    slot->pixel_format = DISPLAY_FRAME_PIXEL_FORMAT_ARGB8888;
-    slot->frame_number = frame_number;
-    slot->machine_cycle = machine_cycle;
-    n = (size_t)width * (size_t)height;
-    memcpy(slot->pixels, pixels, n * sizeof(uint32_t));
-
-    ring->head = (ring->head + 1u) % ring->capacity;
-    if (ring->count < ring->capacity) {
-        ring->count++;
-    } else {
-        ring->dropped++;
+    if (ring->ii_plus != ii_plus || ring->rom_char_size != rom_char_size ||
+        (rom_char_size > 0u && memcmp(ring->rom_char, rom_char, rom_char_size) != 0)) {
+        /* Retained captures would re-render with the wrong glyphs. */
+        uint8_t *copy = NULL;
+        if (rom_char_size > 0u) {
+            copy = malloc(rom_char_size);
+            if (copy == NULL || rom_char == NULL) {
+                free(copy);
+                runtime_frame_ring_unlock(ring);
+                return false;
+            }
+            memcpy(copy, rom_char, rom_char_size);
+        }
+        free(ring->rom_char);
+        ring->rom_char = copy;
+        ring->rom_char_size = rom_char_size;
+        ring->ii_plus = ii_plus;
+        runtime_frame_ring_reset_locked(ring);
     }
+    ok = runtime_frame_ring_append_locked(
+        ring, frame_number, machine_cycle, ring->video_bytes,
+        ring_video_serialize(capture, ring->video_bytes), NULL, pixels);
     runtime_frame_ring_unlock(ring);
-    return true;
+    return ok;
 }
 
 void runtime_frame_ring_get_info(
@@ -162,11 +843,15 @@ void runtime_frame_ring_get_info(
     out_info->count = ring->count;
     out_info->dropped = ring->dropped;
     out_info->recording = ring->recording;
-    out_info->bytes = (uint64_t)ring->capacity * (uint64_t)sizeof(runtime_ring_frame);
+    out_info->bytes = ring->budget_bytes;
+    out_info->used_bytes = (uint64_t)ring->arena_used;
+    out_info->keyframes = ring->keyframes;
+    out_info->repeats = ring->repeats;
+    out_info->mode = ring->mode;
 
     if (runtime_frame_ring_usable(ring) && ring->count > 0u) {
-        const runtime_ring_frame *oldest = runtime_frame_ring_at(ring, 0u);
-        const runtime_ring_frame *newest = runtime_frame_ring_at(ring, ring->count - 1u);
+        const runtime_ring_entry *oldest = runtime_frame_ring_at(ring, 0u);
+        const runtime_ring_entry *newest = runtime_frame_ring_at(ring, ring->count - 1u);
         out_info->oldest_frame = oldest->frame_number;
         out_info->newest_frame = newest->frame_number;
         out_info->oldest_cycle = oldest->machine_cycle;
@@ -175,27 +860,30 @@ void runtime_frame_ring_get_info(
     runtime_frame_ring_unlock(mutable_ring);
 }
 
-static const runtime_ring_frame *runtime_frame_ring_find_locked(
+/* Index (0 = oldest) of the nearest entry at or before target. */
+static bool runtime_frame_ring_find_locked(
     const runtime_frame_ring *ring,
     uint64_t target,
-    bool by_cycle)
+    bool by_cycle,
+    uint32_t *out_index)
 {
     uint32_t low = 0u;
     uint32_t high;
-    const runtime_ring_frame *best = NULL;
+    bool found = false;
 
     if (!runtime_frame_ring_usable(ring) || ring->count == 0u) {
-        return NULL;
+        return false;
     }
 
     high = ring->count - 1u;
     for (;;) {
         uint32_t mid = low + (high - low) / 2u;
-        const runtime_ring_frame *entry = runtime_frame_ring_at(ring, mid);
+        const runtime_ring_entry *entry = runtime_frame_ring_at(ring, mid);
         uint64_t key = by_cycle ? entry->machine_cycle : entry->frame_number;
 
         if (key <= target) {
-            best = entry;
+            *out_index = mid;
+            found = true;
             if (mid == high) {
                 break;
             }
@@ -208,7 +896,98 @@ static const runtime_ring_frame *runtime_frame_ring_find_locked(
         }
     }
 
-    return best;
+    return found;
+}
+
+/* Frame payload of an entry: after its thumbnails. */
+static const uint8_t *runtime_frame_ring_body(
+    const runtime_frame_ring *ring,
+    const runtime_ring_entry *entry,
+    uint32_t *out_size)
+{
+    uint32_t thumbs = (uint32_t)entry->thumb_small_size + entry->thumb_tiny_size;
+
+    *out_size = entry->size - thumbs;
+    return ring->arena + entry->offset + thumbs;
+}
+
+/* Index of the keyframe entry index decodes from. */
+static bool runtime_frame_ring_key_for_locked(
+    const runtime_frame_ring *ring,
+    uint32_t index,
+    uint32_t *out_key)
+{
+    while (runtime_frame_ring_at(ring, index)->kind != RUNTIME_RING_ENTRY_KEY) {
+        if (index == 0u) {
+            return false;
+        }
+        index--;
+    }
+    *out_key = index;
+    return true;
+}
+
+/* Rebuild entry index from its keyframe forward. */
+static bool runtime_frame_ring_decode_locked(
+    const runtime_frame_ring *ring,
+    uint32_t index,
+    runtime_ring_frame *out_frame)
+{
+    const runtime_ring_entry *entry;
+    const uint8_t *body;
+    uint32_t body_size;
+    size_t header = runtime_frame_ring_key_header_bytes(ring);
+    size_t n = (size_t)RUNTIME_FRAME_RING_PIXELS;
+    uint8_t *dst = out_frame->pixels;
+    uint32_t key;
+    uint32_t i;
+
+    if (!runtime_frame_ring_key_for_locked(ring, index, &key)) {
+        return false;
+    }
+    body = runtime_frame_ring_body(ring, runtime_frame_ring_at(ring, key), &body_size);
+    if (body_size < (uint32_t)header) {
+        return false;
+    }
+    if (ring->mode == RUNTIME_FRAME_RING_MODE_VIDEO) {
+        n = (size_t)ring_get_le(body, RING_VIDEO_LENGTH_BYTES);
+        if (n > (size_t)RING_VIDEO_MAX_BYTES) {
+            return false;
+        }
+        dst = ring->video_bytes;
+        memcpy(out_frame->palette, apple2_video_palette(), RING_PALETTE_BYTES);
+    } else {
+        memcpy(out_frame->palette, body, RING_PALETTE_BYTES);
+    }
+    if (!ring_rle_decode(body + header, body_size - (uint32_t)header, dst, n, false)) {
+        return false;
+    }
+    for (i = key + 1u; i <= index; i++) {
+        entry = runtime_frame_ring_at(ring, i);
+        if (entry->kind != RUNTIME_RING_ENTRY_DELTA) {
+            continue;
+        }
+        body = runtime_frame_ring_body(ring, entry, &body_size);
+        if (!ring_rle_decode(body, body_size, dst, n, true)) {
+            return false;
+        }
+    }
+    if (ring->mode == RUNTIME_FRAME_RING_MODE_VIDEO &&
+        (!ring_video_deserialize(dst, n, ring->capture) ||
+         !apple2_video_render_capture(
+             ring->capture, ring->rom_char, ring->rom_char_size, ring->ii_plus,
+             ring->render_scratch, out_frame->pixels))) {
+        return false;
+    }
+
+    entry = runtime_frame_ring_at(ring, index);
+    out_frame->width = (uint32_t)DISPLAY_FRAME_WIDTH;
+    out_frame->height = (uint32_t)DISPLAY_FRAME_HEIGHT;
+    out_frame->stride_bytes = (uint32_t)DISPLAY_FRAME_WIDTH;
+    out_frame->pixel_format = DISPLAY_FRAME_PIXEL_FORMAT_INDEXED8;
+    out_frame->frame_number = entry->frame_number;
+    out_frame->machine_cycle = entry->machine_cycle;
+    return true;
 }
 
 static bool runtime_frame_ring_copy(
@@ -217,7 +996,7 @@ static bool runtime_frame_ring_copy(
     bool by_cycle,
     runtime_ring_frame *out_frame)
 {
-    const runtime_ring_frame *found;
+    uint32_t index;
     bool ok = false;
 
     if (ring == NULL || out_frame == NULL) {
@@ -225,10 +1004,8 @@ static bool runtime_frame_ring_copy(
     }
 
     runtime_frame_ring_lock(ring);
-    found = runtime_frame_ring_find_locked(ring, target, by_cycle);
-    if (found != NULL) {
-        *out_frame = *found;
-        ok = true;
+    if (runtime_frame_ring_find_locked(ring, target, by_cycle, &index)) {
+        ok = runtime_frame_ring_decode_locked(ring, index, out_frame);
     }
     runtime_frame_ring_unlock(ring);
     return ok;
@@ -249,3 +1026,113 @@ bool runtime_frame_ring_copy_by_cycle(
 {
     return runtime_frame_ring_copy(ring, machine_cycle, true, out_frame);
 }
+
+/* Decode the thumbnail at scale for entry index (repeats share the
+   thumbnails of the entry they repeat). Only keyframes store thumbnails;
+   a delta's is derived from its decoded frame. */
+static bool runtime_frame_ring_thumbnail_locked(
+    const runtime_frame_ring *ring,
+    uint32_t index,
+    uint32_t scale,
+    runtime_ring_thumbnail *out_thumb)
+{
+    const runtime_ring_entry *entry = runtime_frame_ring_at(ring, index);
+    const runtime_ring_entry *source;
+    uint32_t width = (uint32_t)DISPLAY_FRAME_WIDTH / scale;
+    uint32_t height = (uint32_t)DISPLAY_FRAME_HEIGHT / scale;
+    uint32_t at = index;
+    uint32_t key;
+    const uint8_t *data;
+    uint32_t size;
+
+    while (runtime_frame_ring_at(ring, at)->kind == RUNTIME_RING_ENTRY_REPEAT) {
+        if (at == 0u) {
+            return false;
+        }
+        at--;
+    }
+    source = runtime_frame_ring_at(ring, at);
+    if (source->kind == RUNTIME_RING_ENTRY_DELTA) {
+        if (!runtime_frame_ring_decode_locked(ring, at, ring->strip_frame)) {
+            return false;
+        }
+        ring_thumbnail(ring->strip_frame->pixels, scale, out_thumb->pixels);
+        memcpy(out_thumb->palette, ring->strip_frame->palette, RING_PALETTE_BYTES);
+        out_thumb->width = width;
+        out_thumb->height = height;
+        out_thumb->scale = scale;
+        out_thumb->frame_number = entry->frame_number;
+        out_thumb->machine_cycle = entry->machine_cycle;
+        return true;
+    }
+    data = ring->arena + source->offset;
+    size = source->thumb_small_size;
+    if (scale == (uint32_t)RUNTIME_FRAME_RING_THUMB_SCALE_TINY) {
+        data += source->thumb_small_size;
+        size = source->thumb_tiny_size;
+    }
+    if (!ring_rle_decode(data, size, out_thumb->pixels, (size_t)width * height, false)) {
+        return false;
+    }
+    if (ring->mode == RUNTIME_FRAME_RING_MODE_VIDEO) {
+        memcpy(out_thumb->palette, apple2_video_palette(), RING_PALETTE_BYTES);
+    } else {
+        if (!runtime_frame_ring_key_for_locked(ring, at, &key)) {
+            return false;
+        }
+        memcpy(out_thumb->palette,
+               runtime_frame_ring_body(ring, runtime_frame_ring_at(ring, key), &size),
+               RING_PALETTE_BYTES);
+    }
+    out_thumb->width = width;
+    out_thumb->height = height;
+    out_thumb->scale = scale;
+    out_thumb->frame_number = entry->frame_number;
+    out_thumb->machine_cycle = entry->machine_cycle;
+    return true;
+}
+
+bool runtime_frame_ring_copy_strip(
+    runtime_frame_ring *ring,
+    uint64_t first,
+    uint64_t last,
+    bool by_cycle,
+    uint32_t scale,
+    uint32_t count,
+    runtime_ring_thumbnail *out_thumbs,
+    uint32_t *out_count)
+{
+    uint64_t span;
+    uint32_t produced = 0;
+    uint32_t i;
+
+    if (out_count != NULL) {
+        *out_count = 0;
+    }
+    if (ring == NULL || out_thumbs == NULL || out_count == NULL || count == 0u ||
+        last < first ||
+        (scale != (uint32_t)RUNTIME_FRAME_RING_THUMB_SCALE_SMALL &&
+         scale != (uint32_t)RUNTIME_FRAME_RING_THUMB_SCALE_TINY)) {
+        return false;
+    }
+    span = last - first;
+
+    runtime_frame_ring_lock(ring);
+    for (i = 0; i < count; i++) {
+        uint64_t target = first;
+        uint32_t index;
+
+        if (count > 1u) {
+            /* first + span * i / (count - 1) without overflowing span * i. */
+            uint64_t steps = (uint64_t)(count - 1u);
+            target = first + (span / steps) * i + ((span % steps) * i) / steps;
+        }
+        if (runtime_frame_ring_find_locked(ring, target, by_cycle, &index) &&
+            runtime_frame_ring_thumbnail_locked(ring, index, scale, &out_thumbs[produced])) {
+            produced++;
+        }
+    }
+    runtime_frame_ring_unlock(ring);
+    *out_count = produced;
+    return produced > 0u;
+}
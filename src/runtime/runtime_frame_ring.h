@@ -1,15 +1,37 @@
 #pragma once
 
-/* Rolling ARGB framebuffer ring — black box for late-pause screen recovery.
+/* Rolling framebuffer ring — black box for late-pause screen recovery.
  *
- * Apple product frames are 560×192 ARGB8888. Entries carry frame number and
- * machine cycle so a recovered frame can seed history search (once C3/C4 land).
+ * Apple product frames are 560×192 palette indices (INDEXED8) with the
+ * 16-entry ARGB palette alongside. Entries carry frame number and machine
+ * cycle so a recovered frame can seed history search (once C3/C4 land).
+ *
+ * Storage is compressed: every RUNTIME_FRAME_RING_KEYFRAME_INTERVAL entries a
+ * keyframe (palette + RLE of the indices), otherwise an RLE of the indices
+ * XOR the previous frame; a frame identical to the previous one is a
+ * zero-byte repeat entry. Payloads live in one circular byte arena; eviction
+ * drops a whole keyframe group so every retained entry stays decodable.
+ * copy_by_frame / copy_by_cycle decode into a full runtime_ring_frame.
+ *
+ * Every keyframe also carries 1/4 and 1/16 scale thumbnails (RLE, built at
+ * push time) so copy_strip can sample a range for scrubbing without decoding
+ * full frames. Deltas store none: copy_strip decodes a delta and shrinks it,
+ * so the per-frame push cost is paid only once per keyframe interval. Entries stay sorted by frame number and cycle (a push
+ * that goes backwards restarts the ring), so lookups are binary searches.
+ *
+ * Video mode stores apple2_video_capture snapshots (display RAM, soft
+ * switches at frame start, beam-split events) through the same key / delta /
+ * repeat scheme instead of pixels, and re-renders them with the machine
+ * painter on lookup. A text or idle screen costs a few hundred bytes and a
+ * delta only the bytes the program wrote. The ring keeps its own copy of the
+ * character ROM the captures were painted with.
  *
  * Worker thread pushes; main/control read under the ring mutex.
  */
 
 #include "display_frame.h"
 #include "mutex.h"
+#include "video.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -19,10 +41,27 @@ enum {
     RUNTIME_FRAME_RING_DEFAULT_MEMORY_MB = 128,
     RUNTIME_FRAME_RING_MAX_MEMORY_MB = 4096,
     RUNTIME_FRAME_RING_PIXELS =
-        (int)DISPLAY_FRAME_WIDTH * (int)DISPLAY_FRAME_HEIGHT
+        (int)DISPLAY_FRAME_WIDTH * (int)DISPLAY_FRAME_HEIGHT,
+    /* Longest delta chain a lookup decodes. */
+    RUNTIME_FRAME_RING_KEYFRAME_INTERVAL = 60,
+    /* Budget bytes per entry-index slot (bounds retained count for idle screens). */
+    RUNTIME_FRAME_RING_BYTES_PER_ENTRY = 2048,
+    /* Thumbnail scales (per axis) and the largest thumbnail. */
+    RUNTIME_FRAME_RING_THUMB_SCALE_SMALL = 4,
+    RUNTIME_FRAME_RING_THUMB_SCALE_TINY = 16,
+    RUNTIME_FRAME_RING_THUMB_MAX_PIXELS =
+        RUNTIME_FRAME_RING_PIXELS /
+        (RUNTIME_FRAME_RING_THUMB_SCALE_SMALL * RUNTIME_FRAME_RING_THUMB_SCALE_SMALL),
+    /* Most thumbnails one copy_strip returns. */
+    RUNTIME_FRAME_RING_STRIP_MAX = 64
 };
 
-/* One retained completed frame (metadata + full pixel slab). */
+typedef enum runtime_frame_ring_mode {
+    RUNTIME_FRAME_RING_MODE_PIXELS = 0, /* painted palette indices */
+    RUNTIME_FRAME_RING_MODE_VIDEO       /* video-memory captures */
+} runtime_frame_ring_mode;
+
+/* One decoded frame (metadata + full pixel slab). */
 typedef struct runtime_ring_frame {
     uint32_t width;
     uint32_t height;
@@ -30,16 +69,68 @@ typedef struct runtime_ring_frame {
     uint32_t pixel_format;
     uint64_t frame_number;
     uint64_t machine_cycle;
-    uint32_t pixels[RUNTIME_FRAME_RING_PIXELS];
+    uint32_t palette[DISPLAY_FRAME_PALETTE_SIZE];
+    uint8_t pixels[RUNTIME_FRAME_RING_PIXELS];
 } runtime_ring_frame;
 
+/* One decoded thumbnail (palette indices, width × height). */
+typedef struct runtime_ring_thumbnail {
+    uint32_t width;
+    uint32_t height;
+    uint32_t scale;
+    uint64_t frame_number;
+    uint64_t machine_cycle;
+    uint32_t palette[DISPLAY_FRAME_PALETTE_SIZE];
+    uint8_t pixels[RUNTIME_FRAME_RING_THUMB_MAX_PIXELS];
+} runtime_ring_thumbnail;
+
+typedef enum runtime_ring_entry_kind {
+    RUNTIME_RING_ENTRY_KEY = 0, /* palette + RLE(indices) */
+    RUNTIME_RING_ENTRY_DELTA,   /* RLE(indices XOR previous) */
+    RUNTIME_RING_ENTRY_REPEAT   /* identical to previous; no payload */
+} runtime_ring_entry_kind;
+
+typedef struct runtime_ring_entry {
+    uint64_t frame_number;
+    uint64_t machine_cycle;
+    size_t offset; /* arena byte offset */
+    uint32_t size; /* payload bytes (0 for repeat) */
+    uint16_t thumb_small_size; /* RLE 1/4 thumbnail at payload start (keys) */
+    uint16_t thumb_tiny_size;  /* RLE 1/16 thumbnail after it (keys) */
+    uint8_t kind;  /* runtime_ring_entry_kind */
+} runtime_ring_entry;
+
 typedef struct runtime_frame_ring {
     mutex *mutex;
-    runtime_ring_frame *slots;
+    runtime_frame_ring_mode mode;
+    runtime_ring_entry *entries;
     uint32_t capacity;
     uint32_t count;
     uint32_t head;
+    uint8_t *arena;
+    size_t arena_size;
+    size_t arena_head;
+    size_t arena_used;
+    /* Encoder state: last pushed frame, entries since the last keyframe. */
+    uint8_t *previous;
+    size_t previous_size;
+    uint32_t previous_palette[DISPLAY_FRAME_PALETTE_SIZE];
+    bool has_previous;
+    uint32_t since_keyframe;
+    uint8_t *scratch;
+    uint8_t *thumbs; /* push-time thumbnail build buffer */
+    runtime_ring_frame *strip_frame; /* copy_strip decode of a delta */
+    /* Video mode: serialized capture + decoded capture + render inputs. */
+    uint8_t *video_bytes;
+    apple2_video_capture *capture;
+    uint8_t *render_scratch; /* apple2_video_render_capture RAM, reused */
+    uint8_t *rom_char;
+    size_t rom_char_size;
+    bool ii_plus;
+    uint64_t budget_bytes;
     uint64_t dropped;
+    uint64_t keyframes;
+    uint64_t repeats;
     bool recording;
 } runtime_frame_ring;
 
@@ -52,22 +143,49 @@ typedef struct runtime_frame_ring_info {
     uint64_t oldest_cycle;
     uint64_t newest_cycle;
     uint64_t bytes;
+    uint64_t used_bytes; /* compressed payload currently retained */
+    uint64_t keyframes;  /* pushed since init/clear */
+    uint64_t repeats;
+    runtime_frame_ring_mode mode;
     bool recording;
 } runtime_frame_ring_info;
 
-bool runtime_frame_ring_init(runtime_frame_ring *ring, uint64_t budget_bytes);
+bool runtime_frame_ring_init(
+    runtime_frame_ring *ring,
+    uint64_t budget_bytes,
+    runtime_frame_ring_mode mode);
 void runtime_frame_ring_destroy(runtime_frame_ring *ring);
 void runtime_frame_ring_clear(runtime_frame_ring *ring);
 void runtime_frame_ring_set_recording(runtime_frame_ring *ring, bool recording);
+/* Drop entries from frame_number on (the machine was rewound); older frames
+   stay decodable and the next push starts a keyframe group. */
+void runtime_frame_ring_truncate(runtime_frame_ring *ring, uint64_t frame_number);
 
-/* Push one completed live frame. pixels must be width*height ARGB. */
+/* Push one completed live frame. pixels must be width*height palette indices;
+   palette holds DISPLAY_FRAME_PALETTE_SIZE ARGB entries. Pixels mode only. */
 bool runtime_frame_ring_push(
     runtime_frame_ring *ring,
     uint64_t frame_number,
     uint64_t machine_cycle,
     uint32_t width,
     uint32_t height,
-    const uint32_t *pixels);
+    const uint8_t *pixels,
+    const uint32_t *palette);
+
+/* Push one completed frame as a video-memory capture. rom_char / ii_plus are
+   the painter inputs it is re-rendered with; a change clears the ring.
+   pixels is the painted frame (thumbnails). Video mode only. */
+bool runtime_frame_ring_push_video(
+    runtime_frame_ring *ring,
+    uint64_t frame_number,
+    uint64_t machine_cycle,
+    const uint8_t *pixels,
+    const apple2_video_capture *capture,
+    const uint8_t *rom_char,
+    size_t rom_char_size,
+    bool ii_plus);
+
+const char *runtime_frame_ring_mode_name(runtime_frame_ring_mode mode);
 
 void runtime_frame_ring_get_info(
     const runtime_frame_ring *ring,
@@ -83,3 +201,19 @@ bool runtime_frame_ring_copy_by_cycle(
     runtime_frame_ring *ring,
     uint64_t machine_cycle,
     runtime_ring_frame *out_frame);
+
+/*
+ * Thumbnails for count targets spread evenly over [first, last] (frame
+ * numbers or cycles), each resolved at or before its target like the copy
+ * calls. scale is RUNTIME_FRAME_RING_THUMB_SCALE_SMALL or _TINY. Targets
+ * older than the window are skipped; false when none resolve.
+ */
+bool runtime_frame_ring_copy_strip(
+    runtime_frame_ring *ring,
+    uint64_t first,
+    uint64_t last,
+    bool by_cycle,
+    uint32_t scale,
+    uint32_t count,
+    runtime_ring_thumbnail *out_thumbs,
+    uint32_t *out_count);
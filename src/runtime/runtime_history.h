@@ -55,7 +55,11 @@ typedef enum runtime_history_marker_kind {
     RUNTIME_HISTORY_MARKER_DIRECT_MEMORY_WRITE = 9,
     RUNTIME_HISTORY_MARKER_KERNAL_LOAD_TRAP = 10,
     RUNTIME_HISTORY_MARKER_KERNAL_SAVE_TRAP = 11,
-    RUNTIME_HISTORY_MARKER_CLOCK_DISCONTINUITY = 12
+    RUNTIME_HISTORY_MARKER_CLOCK_DISCONTINUITY = 12,
+    /* arg0 = frames asked for, arg1 = frame landed on (low 32 bits). */
+    RUNTIME_HISTORY_MARKER_REWIND = 13,
+    /* arg0 = runtime_seek_kind, arg1 = target cycle (low 32 bits). */
+    RUNTIME_HISTORY_MARKER_SEEK = 14
 } runtime_history_marker_kind;
 
 typedef enum runtime_history_reset_kind {
@@ -1,17 +1,23 @@
 #pragma once
 
 #include "apple2.h"
+#include "apple2_snapshot.h"
 #include "audio_buffer.h"
 #include "display_frame.h"
 #include "keyboard.h"
+#include "lockfree_queue.h"
 #include "memview.h"
 #include "mutex.h"
 #include "runtime.h"
 #include "runtime_client.h"
 #include "runtime_command.h"
 #include "runtime_event.h"
+#include "runtime_frame_handoff.h"
 #include "runtime_frame_ring.h"
 #include "runtime_history.h"
+#include "runtime_ram_mirror.h"
+#include "runtime_shm.h"
+#include "runtime_state_writer.h"
 #include "symbol_table.h"
 #include "apple_type_script.h"
 
@@ -19,7 +25,6 @@
 #include <stdint.h>
 #include <stdio.h>
 
-typedef struct message_queue message_queue;
 typedef struct thread thread;
 
 enum {
@@ -27,6 +32,8 @@ enum {
     RUNTIME_EVENT_QUEUE_CAPACITY = 256,
     RUNTIME_BREAKPOINT_CAPACITY = 64,
     RUNTIME_RUN_BATCH_CYCLES = 1024,
+    /* Longest the worker waits for BATCH_END before resuming on its own. */
+    RUNTIME_BATCH_HOLD_MS = 1000,
     RUNTIME_MAX_DISKII_MOUNTS = 16,
     RUNTIME_MAX_SMARTPORT_MOUNTS = 16
 };
@@ -38,15 +45,13 @@ typedef enum runtime_exec_state {
 } runtime_exec_state;
 
 typedef struct runtime_frame_slot {
-    mutex *mutex;
-    /* Latest ARGB frame for UI (Apple size). Also mirrored as display_frame meta. */
-    uint32_t *argb;
-    uint32_t width;
-    uint32_t height;
+    /* Indexed frames (Apple size) + palette, triple-buffered: the machine
+       paints straight into the handoff's back buffer and the consumer reads
+       its front buffer; expanded to ARGB at the UI edge. */
+    runtime_frame_handoff *handoff;
+    /* Worker-side counters. */
     uint64_t frame_number;
-    bool has_frame;
     uint64_t published_frames;
-    uint64_t consumed_frames;
     uint64_t dropped_frames;
 } runtime_frame_slot;
 
@@ -55,6 +60,10 @@ typedef struct runtime_debug_memory_slot {
     runtime_debug_memory_snapshot snapshot;
     bool has_snapshot;
     uint64_t generation;
+    /* Machine change state seen by the last fill; only pages whose write
+       generation or read mapping moved since then are copied again. */
+    runtime_page_tracker tracker;
+    bool history_primed;
 } runtime_debug_memory_slot;
 
 typedef struct runtime_breakpoint_slot {
@@ -72,7 +81,9 @@ typedef struct runtime_symbol_slot {
 typedef enum runtime_rpc_payload_kind {
     RUNTIME_RPC_PAYLOAD_NONE = 0,
     RUNTIME_RPC_PAYLOAD_MEMORY,
-    RUNTIME_RPC_PAYLOAD_HISTORY
+    RUNTIME_RPC_PAYLOAD_HISTORY,
+    /* Client to worker: bytes for RUNTIME_COMMAND_WRITE_MEMORY_SPANS. */
+    RUNTIME_RPC_PAYLOAD_MEMORY_WRITE
 } runtime_rpc_payload_kind;
 
 typedef struct runtime_rpc_payload_slot {
@@ -119,14 +130,20 @@ typedef struct runtime_session {
 } runtime_session;
 
 struct runtime_client {
-    message_queue *command_queue;
-    message_queue *event_queue;
+    mpsc_queue *command_queue;
+    spsc_queue *event_queue;
     runtime_frame_slot *frame_slot;
     runtime_debug_memory_slot *debug_memory_slot;
     runtime_symbol_slot *symbol_slot;
     runtime_breakpoint_slot *breakpoint_slot;
     runtime_rpc_payload_pool *rpc_payload_pool;
     runtime_frame_ring *frame_ring;
+    runtime_ram_mirror *ram_mirror;
+    /* Handoff front buffer, shared by the host-thread frame consumers: each
+       remembers the serial it last took (runtime_client_acquire_frame_since). */
+    const runtime_frame_buffer *frame_front;
+    uint64_t frame_serial;
+    uint64_t frame_seen; /* runtime_client_acquire_frame / poll_*_frame */
     uint64_t next_request_token;
     /* Stamped onto outgoing commands as source session (0 = unknown). */
     uint32_t command_session_id;
@@ -156,8 +173,8 @@ typedef struct runtime_breakpoint {
 
 struct runtime {
     thread *thread;
-    message_queue *command_queue;
-    message_queue *event_queue;
+    mpsc_queue *command_queue;
+    spsc_queue *event_queue;
     runtime_client client;
     runtime_frame_slot frame_slot;
     runtime_debug_memory_slot debug_memory_slot;
@@ -182,6 +199,27 @@ struct runtime {
 
     runtime_frame_ring frame_ring;
     uint32_t frame_ring_memory_mb;
+    apple2_video_capture *frame_capture; /* video-mode ring push scratch */
+
+    /* Rewind buffer: a checkpoint at the first instruction boundary once the
+       video frame reaches rewind_next_frame. NULL = off. */
+    apple2_checkpoint_chain *rewind;
+    uint64_t rewind_budget_bytes;
+    uint32_t rewind_interval_frames;
+    uint64_t rewind_next_frame;
+
+    /* Save-state files are written off the worker; NULL = synchronous. */
+    runtime_state_writer *state_writer;
+
+    /* Post-boot cache (runtime_boot_cache.h); NULL dir = off. Armed after a
+       miss until the condition first holds; the capture's write result is
+       not published as SAVE_STATE_COMPLETE. */
+    char *boot_cache_dir;
+    char boot_cache_until_text[APPLE2_VIDEO_TEXT_COLUMNS_MAX + 1];
+    int32_t boot_cache_until_pc;
+    bool boot_cache_armed;
+    uint64_t boot_cache_text_frame; /* last frame the text was checked on */
+    char boot_cache_path[RUNTIME_COMMAND_PATH_MAX];
 
     runtime_history *history;
     uint32_t history_memory_mb;
@@ -206,8 +244,21 @@ struct runtime {
 
     runtime_exec_state exec_state;
     runtime_stop_reason last_stop_reason;
+    /* Between BATCH_BEGIN and BATCH_END: SDL_GetTicks deadline, 0 = no hold. */
+    uint64_t batch_hold_until_ms;
     uint64_t runtime_seq;
 
+    /* Lock-free RAM mirror: mutations applied vs. covered by the last publish. */
+    runtime_ram_mirror *ram_mirror;
+    uint64_t ram_mirror_applied;
+    uint64_t ram_mirror_published_applied;
+    uint64_t ram_mirror_published_cycle;
+    bool ram_mirror_was_running;
+    /* The command being processed changes memory and is not yet counted. */
+    bool ram_mirror_pending;
+    /* Shared-memory publish for local control clients; NULL = off. */
+    runtime_shm_writer *shm;
+
     runtime_breakpoint breakpoints[RUNTIME_BREAKPOINT_CAPACITY];
     size_t breakpoint_count;
     uint32_t next_breakpoint_id;
@@ -219,6 +270,9 @@ struct runtime {
     bool breakpoint_hit_pending;
     /* Cached: any enabled BP has READ or WRITE access (bus callback fast path). */
     bool has_rw_breakpoints;
+    /* Reverse-continue search: matches report a BREAK stop without touching
+       counters or running actions. */
+    bool seek_probe;
 
     bool pace_initialized;
     uint64_t frame_counter_step;
@@ -0,0 +1,277 @@
+/* runtime_ram_mirror.c — compiled at C11 (see CMakeLists.txt per-file property).
+   Uses C11 atomics for the seqlock; the public header is C99-compatible. */
+
+#include "runtime_ram_mirror.h"
+
+#include "runtime_internal.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum { RUNTIME_RAM_MIRROR_NONE = 0xFFFFFFFFu };
+
+typedef struct runtime_ram_mirror_buffer {
+    /* Odd while the worker fills this buffer. */
+    _Atomic uint64_t seq;
+    uint64_t applied;
+    runtime_ram_mirror_info info;
+    runtime_machine_snapshot machine;
+    runtime_page_tracker tracker; /* worker only */
+    uint8_t views[RUNTIME_RAM_MIRROR_VIEWS][MACHINE_ADDRESS_SPACE];
+} runtime_ram_mirror_buffer;
+
+struct runtime_ram_mirror {
+    _Atomic uint32_t published; /* newest complete buffer, or NONE */
+    _Atomic uint64_t queued;
+    uint64_t generation; /* worker only */
+    runtime_ram_mirror_buffer buffers[2];
+};
+
+bool runtime_page_tracker_needs_full(const runtime_page_tracker *tracker, const apple2_t *machine)
+{
+    return !tracker->primed || tracker->memory_epoch != machine->memory_epoch;
+}
+
+bool runtime_page_tracker_page_stale(
+    const runtime_page_tracker *tracker,
+    const apple2_t *machine,
+    uint32_t page)
+{
+    return tracker->page_write_gen[page] != machine->page_write_gen[page] ||
+        tracker->read_pages[page] != machine->pages.read_pages[page] ||
+        page == 0xC0u; /* keyboard latch changes on reads */
+}
+
+void runtime_page_tracker_mark_page(
+    runtime_page_tracker *tracker,
+    const apple2_t *machine,
+    uint32_t page)
+{
+    tracker->page_write_gen[page] = machine->page_write_gen[page];
+    tracker->read_pages[page] = machine->pages.read_pages[page];
+}
+
+void runtime_page_tracker_finish(runtime_page_tracker *tracker, const apple2_t *machine)
+{
+    tracker->primed = true;
+    tracker->memory_epoch = machine->memory_epoch;
+}
+
+void runtime_copy_view_page(
+    const apple2_t *machine,
+    uint32_t page,
+    uint8_t *const views[RUNTIME_RAM_MIRROR_VIEWS])
+{
+    uint32_t mode;
+    uint32_t base = page * APPLE2_PAGE_SIZE;
+
+    for (mode = 0; mode < RUNTIME_RAM_MIRROR_VIEWS; mode++) {
+        apple2_copy_page_in_view(
+            machine,
+            runtime_mode_to_view_flags((runtime_memory_mode)mode),
+            (uint8_t)page,
+            views[mode] + base);
+    }
+}
+
+runtime_ram_mirror *runtime_ram_mirror_create(void)
+{
+    runtime_ram_mirror *mirror = (runtime_ram_mirror *)calloc(1, sizeof(*mirror));
+    if (mirror == NULL) {
+        return NULL;
+    }
+    atomic_init(&mirror->published, RUNTIME_RAM_MIRROR_NONE);
+    atomic_init(&mirror->queued, 0u);
+    atomic_init(&mirror->buffers[0].seq, 0u);
+    atomic_init(&mirror->buffers[1].seq, 0u);
+    return mirror;
+}
+
+void runtime_ram_mirror_destroy(runtime_ram_mirror *mirror)
+{
+    free(mirror);
+}
+
+void runtime_ram_mirror_note_queued(runtime_ram_mirror *mirror)
+{
+    if (mirror != NULL) {
+        atomic_fetch_add_explicit(&mirror->queued, 1u, memory_order_acq_rel);
+    }
+}
+
+void runtime_ram_mirror_note_dropped(runtime_ram_mirror *mirror)
+{
+    if (mirror != NULL) {
+        atomic_fetch_sub_explicit(&mirror->queued, 1u, memory_order_acq_rel);
+    }
+}
+
+void runtime_ram_mirror_publish(
+    runtime_ram_mirror *mirror,
+    const apple2_t *machine,
+    const runtime_machine_snapshot *state,
+    uint64_t applied)
+{
+    uint32_t published;
+    uint32_t index;
+    uint32_t page;
+    uint32_t mode;
+    uint64_t seq;
+    bool full;
+    runtime_ram_mirror_buffer *buffer;
+    uint8_t *views[RUNTIME_RAM_MIRROR_VIEWS];
+
+    if (mirror == NULL || machine == NULL || state == NULL) {
+        return;
+    }
+    published = atomic_load_explicit(&mirror->published, memory_order_relaxed);
+    index = published == RUNTIME_RAM_MIRROR_NONE ? 0u : (published ^ 1u);
+    buffer = &mirror->buffers[index];
+
+    seq = atomic_load_explicit(&buffer->seq, memory_order_relaxed);
+    atomic_store_explicit(&buffer->seq, seq + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (mode = 0; mode < RUNTIME_RAM_MIRROR_VIEWS; mode++) {
+        views[mode] = buffer->views[mode];
+    }
+    full = runtime_page_tracker_needs_full(&buffer->tracker, machine);
+    for (page = 0; page < APPLE2_NUM_PAGES; page++) {
+        if (full || runtime_page_tracker_page_stale(&buffer->tracker, machine, page)) {
+            runtime_copy_view_page(machine, page, views);
+            runtime_page_tracker_mark_page(&buffer->tracker, machine, page);
+        }
+    }
+    runtime_page_tracker_finish(&buffer->tracker, machine);
+    buffer->machine = *state;
+    buffer->applied = applied;
+    buffer->info.generation = ++mirror->generation;
+    buffer->info.frame_number = state->frame_number;
+    buffer->info.cycle = state->cycle;
+
+    atomic_store_explicit(&buffer->seq, seq + 2u, memory_order_release);
+    atomic_store_explicit(&mirror->published, index, memory_order_release);
+}
+
+/* Seqlock read: copy under a stable even sequence, then confirm it held.
+   Every span comes from the same publish. */
+static bool runtime_ram_mirror_read_buffer(
+    runtime_ram_mirror *mirror,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out,
+    runtime_machine_snapshot *out_machine,
+    runtime_ram_mirror_info *out_info)
+{
+    uint64_t queued;
+    int attempt;
+
+    queued = atomic_load_explicit(&mirror->queued, memory_order_acquire);
+    for (attempt = 0; attempt < RUNTIME_RAM_MIRROR_READ_RETRIES; attempt++) {
+        uint32_t index = atomic_load_explicit(&mirror->published, memory_order_acquire);
+        runtime_ram_mirror_buffer *buffer;
+        runtime_ram_mirror_info info;
+        uint64_t before;
+        uint64_t applied;
+
+        if (index == RUNTIME_RAM_MIRROR_NONE) {
+            return false;
+        }
+        buffer = &mirror->buffers[index];
+        before = atomic_load_explicit(&buffer->seq, memory_order_acquire);
+        if ((before & 1u) != 0u) {
+            continue;
+        }
+        applied = buffer->applied;
+        info = buffer->info;
+        if (out != NULL) {
+            uint8_t *at = out;
+            uint32_t k;
+            for (k = 0; k < count; k++) {
+                const uint8_t *view = buffer->views[spans[k].mode];
+                uint32_t first = MACHINE_ADDRESS_SPACE - (uint32_t)spans[k].address;
+                if (first > spans[k].length) {
+                    first = spans[k].length;
+                }
+                memcpy(at, view + spans[k].address, first);
+                memcpy(at + first, view, spans[k].length - first);
+                at += spans[k].length;
+            }
+        }
+        if (out_machine != NULL) {
+            *out_machine = buffer->machine;
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&buffer->seq, memory_order_relaxed) != before) {
+            continue;
+        }
+        if (applied < queued) {
+            return false;
+        }
+        if (out_info != NULL) {
+            *out_info = info;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool runtime_ram_mirror_read(
+    runtime_ram_mirror *mirror,
+    runtime_memory_mode mode,
+    uint16_t address,
+    uint32_t length,
+    uint8_t *out,
+    runtime_ram_mirror_info *out_info)
+{
+    runtime_memory_span span;
+
+    span.address = address;
+    span.mode = (uint8_t)mode;
+    span.length = length;
+    return runtime_ram_mirror_read_spans(mirror, &span, 1u, out, out_info);
+}
+
+bool runtime_ram_mirror_read_spans(
+    runtime_ram_mirror *mirror,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out,
+    runtime_ram_mirror_info *out_info)
+{
+    return runtime_ram_mirror_read_spans_machine(mirror, spans, count, out, NULL, out_info);
+}
+
+bool runtime_ram_mirror_read_spans_machine(
+    runtime_ram_mirror *mirror,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out,
+    runtime_machine_snapshot *out_machine,
+    runtime_ram_mirror_info *out_info)
+{
+    uint32_t k;
+
+    if (mirror == NULL || spans == NULL || out == NULL || count == 0u) {
+        return false;
+    }
+    for (k = 0; k < count; k++) {
+        if (spans[k].length == 0u || spans[k].length > MACHINE_ADDRESS_SPACE ||
+            spans[k].mode >= RUNTIME_RAM_MIRROR_VIEWS) {
+            return false;
+        }
+    }
+    return runtime_ram_mirror_read_buffer(mirror, spans, count, out, out_machine, out_info);
+}
+
+bool runtime_ram_mirror_read_machine(
+    runtime_ram_mirror *mirror,
+    runtime_machine_snapshot *out,
+    runtime_ram_mirror_info *out_info)
+{
+    if (mirror == NULL || out == NULL) {
+        return false;
+    }
+    return runtime_ram_mirror_read_buffer(mirror, NULL, 0u, NULL, out, out_info);
+}
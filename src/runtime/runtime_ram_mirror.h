@@ -0,0 +1,118 @@
+#pragma once
+
+/* Seqlock-published copy of machine memory for readers off the worker thread.
+ *
+ * The worker publishes every memory view (indexed by runtime_memory_mode:
+ * Map, Main, ROM, Aux, LC1, LC2) plus a machine snapshot (soft switches, beam,
+ * registers) once per frame, before each stop event is posted, and after
+ * each command that can change memory. Two buffers alternate: the worker fills the one
+ * readers were not pointed at, holding its sequence odd while it writes, then
+ * flips `published`. Readers copy without locks and retry when the sequence
+ * moved under them, so neither side waits on the other.
+ *
+ * Commands that can change memory are counted when queued
+ * (runtime_ram_mirror_note_queued) and when applied by the worker. The queued
+ * count is one counter for all clients, not one per caller. A buffer records
+ * the applied count it was filled at, and a read is served only when that
+ * covers every such command queued before the read, by any client: a write
+ * followed by a read never sees the old bytes, and another client's pending
+ * write makes the read fall back too. Otherwise the read reports false and
+ * the caller falls back to a worker round-trip.
+ *
+ * Pages are copied with the debug-memory page tracker, so a publish only
+ * touches pages written or remapped since that buffer was last filled.
+ */
+
+#include "apple2.h"
+#include "runtime_event.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum {
+    RUNTIME_RAM_MIRROR_VIEWS = 6, /* runtime_memory_mode MAP..LC2 */
+    /* Reader attempts before giving up on a buffer the worker keeps refilling. */
+    RUNTIME_RAM_MIRROR_READ_RETRIES = 8
+};
+
+/* What a consumer last copied out of the machine. A page is stale when its
+   write generation ticked or its read mapping moved; a memory_epoch change
+   makes every page stale. Zero-initialize before first use. */
+typedef struct runtime_page_tracker {
+    bool primed;
+    uint32_t memory_epoch;
+    uint32_t page_write_gen[APPLE2_NUM_PAGES];
+    const uint8_t *read_pages[APPLE2_NUM_PAGES];
+} runtime_page_tracker;
+
+/* True when nothing carried over from the previous copy can be trusted. */
+bool runtime_page_tracker_needs_full(const runtime_page_tracker *tracker, const apple2_t *machine);
+bool runtime_page_tracker_page_stale(
+    const runtime_page_tracker *tracker,
+    const apple2_t *machine,
+    uint32_t page);
+void runtime_page_tracker_mark_page(
+    runtime_page_tracker *tracker,
+    const apple2_t *machine,
+    uint32_t page);
+void runtime_page_tracker_finish(runtime_page_tracker *tracker, const apple2_t *machine);
+
+/* Copy one page of every view into views[mode] + page * APPLE2_PAGE_SIZE. */
+void runtime_copy_view_page(
+    const apple2_t *machine,
+    uint32_t page,
+    uint8_t *const views[RUNTIME_RAM_MIRROR_VIEWS]);
+
+typedef struct runtime_ram_mirror runtime_ram_mirror;
+
+typedef struct runtime_ram_mirror_info {
+    uint64_t generation;   /* publish count */
+    uint64_t frame_number;
+    uint64_t cycle;
+} runtime_ram_mirror_info;
+
+runtime_ram_mirror *runtime_ram_mirror_create(void);
+void runtime_ram_mirror_destroy(runtime_ram_mirror *mirror);
+
+/* Any thread, before queueing a command that can change memory. */
+void runtime_ram_mirror_note_queued(runtime_ram_mirror *mirror);
+/* Undo note_queued when the command could not be queued. */
+void runtime_ram_mirror_note_dropped(runtime_ram_mirror *mirror);
+
+/* Worker only. applied = commands counted by note_queued that it has run. */
+void runtime_ram_mirror_publish(
+    runtime_ram_mirror *mirror,
+    const apple2_t *machine,
+    const runtime_machine_snapshot *state,
+    uint64_t applied);
+
+/* Any thread. Copies length bytes (1..65536, wrapping at $FFFF) of one view.
+   False when nothing is published yet, the mirror is behind queued writes,
+   or the worker kept refilling the buffer for every retry. */
+bool runtime_ram_mirror_read(
+    runtime_ram_mirror *mirror,
+    runtime_memory_mode mode,
+    uint16_t address,
+    uint32_t length,
+    uint8_t *out,
+    runtime_ram_mirror_info *out_info);
+/* Any thread. Several spans (mode, address, length) copied back to back into
+   out from one consistent publish; same failure cases as read. */
+bool runtime_ram_mirror_read_spans(
+    runtime_ram_mirror *mirror,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out,
+    runtime_ram_mirror_info *out_info);
+bool runtime_ram_mirror_read_machine(
+    runtime_ram_mirror *mirror,
+    runtime_machine_snapshot *out,
+    runtime_ram_mirror_info *out_info);
+/* Spans and the machine snapshot (soft switches) from the same publish. */
+bool runtime_ram_mirror_read_spans_machine(
+    runtime_ram_mirror *mirror,
+    const runtime_memory_span *spans,
+    uint32_t count,
+    uint8_t *out,
+    runtime_machine_snapshot *out_machine,
+    runtime_ram_mirror_info *out_info);
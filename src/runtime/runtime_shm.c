@@ -0,0 +1,306 @@
+/* runtime_shm.c — compiled at C11 (see CMakeLists.txt per-file property).
+   Uses C11 atomics for the per-slot seqlock; the public header is C99-compatible. */
+
+#include "runtime_shm.h"
+
+#include "runtime_ram_mirror.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    RUNTIME_SHM_NONE = 0xFFFFFFFFu,
+    RUNTIME_SHM_ALIGN = 64,
+    /* Reader attempts before giving up on a slot the worker keeps refilling. */
+    RUNTIME_SHM_READ_RETRIES = 8
+};
+
+/* Region layout; see runtime_shm.h for the byte offsets readers rely on. */
+typedef struct runtime_shm_slot {
+    _Atomic uint64_t seq;
+    uint64_t generation;
+    uint64_t frame_number;
+    uint64_t cycle;
+    uint64_t offset;
+    uint64_t size;
+} runtime_shm_slot;
+
+typedef struct runtime_shm_section_header {
+    _Atomic uint32_t published;
+    uint32_t reserved;
+    runtime_shm_slot slots[2];
+} runtime_shm_section_header;
+
+typedef struct runtime_shm_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t region_size;
+    uint32_t frame_width;
+    uint32_t frame_height;
+    uint32_t ram_views;
+    uint32_t ram_view_size;
+    runtime_shm_section_header sections[RUNTIME_SHM_SECTION_COUNT];
+} runtime_shm_header;
+
+_Static_assert(sizeof(runtime_shm_slot) == 48, "runtime_shm slot layout");
+_Static_assert(sizeof(runtime_shm_section_header) == 104, "runtime_shm section layout");
+_Static_assert(offsetof(runtime_shm_header, sections) == 40, "runtime_shm header layout");
+_Static_assert(sizeof(runtime_shm_header) == 352, "runtime_shm header size");
+
+struct runtime_shm_writer {
+    uint8_t *base;
+    runtime_shm_header *header;
+    uint64_t generation[RUNTIME_SHM_SECTION_COUNT];
+    runtime_page_tracker trackers[2]; /* what each RAM slot holds */
+};
+
+static size_t runtime_shm_align(size_t n)
+{
+    return (n + (RUNTIME_SHM_ALIGN - 1u)) & ~(size_t)(RUNTIME_SHM_ALIGN - 1u);
+}
+
+static size_t runtime_shm_slot_bytes(runtime_shm_section section)
+{
+    switch (section) {
+    case RUNTIME_SHM_SECTION_FRAME:
+        return sizeof(uint32_t) * DISPLAY_FRAME_PALETTE_SIZE +
+            (size_t)DISPLAY_FRAME_WIDTH * (size_t)DISPLAY_FRAME_HEIGHT;
+    case RUNTIME_SHM_SECTION_RAM:
+        return (size_t)RUNTIME_RAM_MIRROR_VIEWS * MACHINE_ADDRESS_SPACE;
+    case RUNTIME_SHM_SECTION_RING:
+    default:
+        return sizeof(uint64_t) * RUNTIME_SHM_RING_WORDS;
+    }
+}
+
+size_t runtime_shm_region_size(void)
+{
+    size_t size = runtime_shm_align(sizeof(runtime_shm_header));
+    int section;
+
+    for (section = 0; section < RUNTIME_SHM_SECTION_COUNT; section++) {
+        size += 2u * runtime_shm_align(runtime_shm_slot_bytes((runtime_shm_section)section));
+    }
+    return size;
+}
+
+runtime_shm_writer *runtime_shm_writer_create(void *region, size_t size)
+{
+    runtime_shm_writer *writer;
+    runtime_shm_header *header;
+    size_t offset;
+    int section;
+
+    if (region == NULL || size < runtime_shm_region_size()) {
+        return NULL;
+    }
+    header = (runtime_shm_header *)region;
+    /* Readers in other processes need the counters to be plain memory. */
+    if (!atomic_is_lock_free(&header->sections[0].published) ||
+        !atomic_is_lock_free(&header->sections[0].slots[0].seq)) {
+        return NULL;
+    }
+    writer = (runtime_shm_writer *)calloc(1, sizeof(*writer));
+    if (writer == NULL) {
+        return NULL;
+    }
+    writer->base = (uint8_t *)region;
+    writer->header = header;
+
+    memset(region, 0, runtime_shm_region_size());
+    header->version = RUNTIME_SHM_VERSION;
+    header->header_size = (uint32_t)sizeof(*header);
+    header->region_size = (uint64_t)runtime_shm_region_size();
+    header->frame_width = DISPLAY_FRAME_WIDTH;
+    header->frame_height = DISPLAY_FRAME_HEIGHT;
+    header->ram_views = RUNTIME_RAM_MIRROR_VIEWS;
+    header->ram_view_size = MACHINE_ADDRESS_SPACE;
+    offset = runtime_shm_align(sizeof(*header));
+    for (section = 0; section < RUNTIME_SHM_SECTION_COUNT; section++) {
+        runtime_shm_section_header *sh = &header->sections[section];
+        size_t bytes = runtime_shm_slot_bytes((runtime_shm_section)section);
+        int slot;
+
+        atomic_init(&sh->published, RUNTIME_SHM_NONE);
+        for (slot = 0; slot < 2; slot++) {
+            atomic_init(&sh->slots[slot].seq, 0u);
+            sh->slots[slot].offset = offset;
+            sh->slots[slot].size = bytes;
+            offset += runtime_shm_align(bytes);
+        }
+    }
+    /* Magic last: a reader that sees it sees a formatted header. */
+    atomic_thread_fence(memory_order_release);
+    memcpy(header->magic, RUNTIME_SHM_MAGIC, sizeof(RUNTIME_SHM_MAGIC));
+    return writer;
+}
+
+void runtime_shm_writer_destroy(runtime_shm_writer *writer)
+{
+    free(writer);
+}
+
+/* Claim the slot readers are not pointed at; its seq stays odd until end. */
+static uint8_t *runtime_shm_begin(
+    runtime_shm_writer *writer,
+    runtime_shm_section section,
+    uint32_t *out_index)
+{
+    runtime_shm_section_header *sh = &writer->header->sections[section];
+    uint32_t published = atomic_load_explicit(&sh->published, memory_order_relaxed);
+    uint32_t index = published == RUNTIME_SHM_NONE ? 0u : (published ^ 1u);
+    runtime_shm_slot *slot = &sh->slots[index];
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->seq, seq + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    *out_index = index;
+    return writer->base + slot->offset;
+}
+
+static void runtime_shm_end(
+    runtime_shm_writer *writer,
+    runtime_shm_section section,
+    uint32_t index,
+    uint64_t frame_number,
+    uint64_t cycle)
+{
+    runtime_shm_section_header *sh = &writer->header->sections[section];
+    runtime_shm_slot *slot = &sh->slots[index];
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+
+    slot->generation = ++writer->generation[section];
+    slot->frame_number = frame_number;
+    slot->cycle = cycle;
+    atomic_store_explicit(&slot->seq, seq + 1u, memory_order_release);
+    atomic_store_explicit(&sh->published, index, memory_order_release);
+}
+
+void runtime_shm_publish_frame(runtime_shm_writer *writer, const runtime_frame_buffer *frame)
+{
+    uint8_t *data;
+    uint32_t index;
+    size_t pixels;
+
+    if (writer == NULL || frame == NULL || frame->width != DISPLAY_FRAME_WIDTH ||
+        frame->height != DISPLAY_FRAME_HEIGHT) {
+        return;
+    }
+    pixels = (size_t)frame->width * (size_t)frame->height;
+    data = runtime_shm_begin(writer, RUNTIME_SHM_SECTION_FRAME, &index);
+    memcpy(data, frame->palette, sizeof(frame->palette));
+    memcpy(data + sizeof(frame->palette), frame->pixels, pixels);
+    runtime_shm_end(
+        writer, RUNTIME_SHM_SECTION_FRAME, index, frame->frame_number, frame->machine_cycle);
+}
+
+void runtime_shm_publish_ring(runtime_shm_writer *writer, const runtime_frame_ring_info *info)
+{
+    uint64_t words[RUNTIME_SHM_RING_WORDS];
+    uint8_t *data;
+    uint32_t index;
+
+    if (writer == NULL || info == NULL) {
+        return;
+    }
+    words[0] = info->count;
+    words[1] = info->capacity;
+    words[2] = info->oldest_frame;
+    words[3] = info->newest_frame;
+    words[4] = info->oldest_cycle;
+    words[5] = info->newest_cycle;
+    words[6] = info->dropped;
+    words[7] = info->recording ? 1u : 0u;
+    data = runtime_shm_begin(writer, RUNTIME_SHM_SECTION_RING, &index);
+    memcpy(data, words, sizeof(words));
+    runtime_shm_end(
+        writer, RUNTIME_SHM_SECTION_RING, index, info->newest_frame, info->newest_cycle);
+}
+
+void runtime_shm_publish_ram(
+    runtime_shm_writer *writer,
+    const apple2_t *machine,
+    const runtime_machine_snapshot *state)
+{
+    uint8_t *views[RUNTIME_RAM_MIRROR_VIEWS];
+    runtime_page_tracker *tracker;
+    uint8_t *data;
+    uint32_t index;
+    uint32_t page;
+    uint32_t mode;
+    bool full;
+
+    if (writer == NULL || machine == NULL || state == NULL) {
+        return;
+    }
+    data = runtime_shm_begin(writer, RUNTIME_SHM_SECTION_RAM, &index);
+    tracker = &writer->trackers[index];
+    for (mode = 0; mode < RUNTIME_RAM_MIRROR_VIEWS; mode++) {
+        views[mode] = data + (size_t)mode * MACHINE_ADDRESS_SPACE;
+    }
+    full = runtime_page_tracker_needs_full(tracker, machine);
+    for (page = 0; page < APPLE2_NUM_PAGES; page++) {
+        if (full || runtime_page_tracker_page_stale(tracker, machine, page)) {
+            runtime_copy_view_page(machine, page, views);
+            runtime_page_tracker_mark_page(tracker, machine, page);
+        }
+    }
+    runtime_page_tracker_finish(tracker, machine);
+    runtime_shm_end(
+        writer, RUNTIME_SHM_SECTION_RAM, index, state->frame_number, state->cycle);
+}
+
+bool runtime_shm_read(
+    const void *region,
+    runtime_shm_section section,
+    void *out,
+    size_t out_size,
+    runtime_shm_info *out_info)
+{
+    runtime_shm_header *header = (runtime_shm_header *)region;
+    runtime_shm_section_header *sh;
+    int attempt;
+
+    if (header == NULL || out == NULL || (int)section < 0 ||
+        section >= RUNTIME_SHM_SECTION_COUNT ||
+        memcmp(header->magic, RUNTIME_SHM_MAGIC, sizeof(RUNTIME_SHM_MAGIC)) != 0 ||
+        header->version != RUNTIME_SHM_VERSION) {
+        return false;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    sh = &header->sections[section];
+    for (attempt = 0; attempt < RUNTIME_SHM_READ_RETRIES; attempt++) {
+        uint32_t index = atomic_load_explicit(&sh->published, memory_order_acquire);
+        runtime_shm_slot *slot;
+        runtime_shm_info info;
+        uint64_t before;
+        size_t size;
+
+        if (index == RUNTIME_SHM_NONE) {
+            return false;
+        }
+        slot = &sh->slots[index & 1u];
+        before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if ((before & 1u) != 0u) {
+            continue;
+        }
+        info.generation = slot->generation;
+        info.frame_number = slot->frame_number;
+        info.cycle = slot->cycle;
+        info.size = slot->size;
+        size = slot->size < out_size ? (size_t)slot->size : out_size;
+        memcpy(out, (const uint8_t *)region + slot->offset, size);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != before) {
+            continue;
+        }
+        if (out_info != NULL) {
+            *out_info = info;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+/* Latest frame, frame-ring window and RAM published into a caller-supplied
+ * region (a shared-memory mapping from platform_shm), so same-host control
+ * clients can copy them instead of pulling them through the socket.
+ *
+ * Readers live in other processes, so the region is a fixed layout of
+ * host-order (little-endian) fields rather than C structs:
+ *
+ *   0    char[8]  magic "A2MSHM1"
+ *   8    u32      version (RUNTIME_SHM_VERSION)
+ *   12   u32      header_size
+ *   16   u64      region_size
+ *   24   u32      frame_width
+ *   28   u32      frame_height
+ *   32   u32      ram_views (runtime_memory_mode order: map main rom aux lc1 lc2)
+ *   36   u32      ram_view_size (65536)
+ *   40   section  frame
+ *   144  section  ram
+ *   248  section  ring
+ *
+ * A section is u32 published (slot index, 0xFFFFFFFF until the first
+ * publish), u32 reserved, then two 48-byte slots of u64 fields: seq (odd
+ * while the worker fills the slot), generation (section publish count),
+ * frame_number, cycle, offset (slot data from the region start) and size.
+ * The worker fills the slot readers are not pointed at and then flips
+ * published, the same seqlock as runtime_ram_mirror. A reader copies the
+ * slot under an even seq and retries when seq moved.
+ *
+ * Slot data: frame = 16 u32 ARGB palette entries then width x height palette
+ * indices; ram = every view back to back; ring = u64 count, capacity,
+ * oldest_frame, newest_frame, oldest_cycle, newest_cycle, dropped and
+ * recording (get-frame-at serves the frames themselves).
+ *
+ * The worker publishes the frame and ring with each frame and the RAM
+ * whenever it refreshes the RAM mirror. RAM slots copy only the pages
+ * written or remapped since that slot was last filled.
+ */
+
+#include "apple2.h"
+#include "runtime_event.h"
+#include "runtime_frame_handoff.h"
+#include "runtime_frame_ring.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RUNTIME_SHM_MAGIC "A2MSHM1"
+
+enum {
+    RUNTIME_SHM_VERSION = 1,
+    RUNTIME_SHM_RING_WORDS = 8
+};
+
+typedef enum runtime_shm_section {
+    RUNTIME_SHM_SECTION_FRAME = 0,
+    RUNTIME_SHM_SECTION_RAM,
+    RUNTIME_SHM_SECTION_RING,
+    RUNTIME_SHM_SECTION_COUNT
+} runtime_shm_section;
+
+typedef struct runtime_shm_info {
+    uint64_t generation;
+    uint64_t frame_number;
+    uint64_t cycle;
+    uint64_t size; /* slot data bytes */
+} runtime_shm_info;
+
+typedef struct runtime_shm_writer runtime_shm_writer;
+
+/* Bytes a region needs for the layout above. */
+size_t runtime_shm_region_size(void);
+
+/* Format region (size >= runtime_shm_region_size()) and return the worker's
+   writer for it; NULL when too small or out of memory. region stays owned by
+   the caller and must outlive the writer. */
+runtime_shm_writer *runtime_shm_writer_create(void *region, size_t size);
+void runtime_shm_writer_destroy(runtime_shm_writer *writer);
+
+/* Worker only. NULL writer is a no-op. */
+void runtime_shm_publish_frame(runtime_shm_writer *writer, const runtime_frame_buffer *frame);
+void runtime_shm_publish_ring(runtime_shm_writer *writer, const runtime_frame_ring_info *info);
+void runtime_shm_publish_ram(
+    runtime_shm_writer *writer,
+    const apple2_t *machine,
+    const runtime_machine_snapshot *state);
+
+/* Reader side, any thread or process mapping the region. Copies up to
+   out_size bytes of the newest slot of section; false when nothing is
+   published yet, the region is not a runtime_shm layout, or the worker kept
+   refilling the slot for every retry. */
+bool runtime_shm_read(
+    const void *region,
+    runtime_shm_section section,
+    void *out,
+    size_t out_size,
+    runtime_shm_info *out_info);
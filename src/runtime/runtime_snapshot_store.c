@@ -0,0 +1,408 @@
+#include "runtime_snapshot_store.h"
+
+#include "apple2_snapshot.h"
+#include "platform_fs.h"
+#include "runtime_state_writer.h"
+#include "sha256.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RUNTIME_SNAPSHOT_STORE_TAG_BLKS 0x736B6C42u /* 'Blks' */
+
+enum {
+    RUNTIME_SNAPSHOT_STORE_PATH_MAX = 1024,
+    /* Blks payload: original tag, original size, block size, block count. */
+    RUNTIME_SNAPSHOT_STORE_BLKS_HEADER = 16,
+    /* The .a2state container: magic, version, header size, then chunks of
+       tag + payload length + payload. */
+    RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER = 8,
+    RUNTIME_SNAPSHOT_STORE_HEADER_MIN = 12,
+    RUNTIME_SNAPSHOT_STORE_CHUNK_MAX = 32 * 1024 * 1024
+};
+
+static uint32_t store_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+        ((uint32_t)p[3] << 24);
+}
+
+static void store_put_le32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value & 0xffu);
+    p[1] = (uint8_t)((value >> 8) & 0xffu);
+    p[2] = (uint8_t)((value >> 16) & 0xffu);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static size_t store_block_count(uint32_t size)
+{
+    return ((size_t)size + RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE - 1u) /
+        RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE;
+}
+
+bool runtime_snapshot_store_is_ref(const char *path)
+{
+    const char *dot;
+
+    if (path == NULL) {
+        return false;
+    }
+    dot = strrchr(path, '.');
+    return dot != NULL && (dot[1] == 'a' || dot[1] == 'A') && dot[2] == '2' &&
+        (dot[3] == 's' || dot[3] == 'S') && (dot[4] == 'm' || dot[4] == 'M') &&
+        dot[5] == '\0';
+}
+
+/* Directory holding the manifest; "" for the current one. */
+static bool store_root(const char *path, char *out, size_t out_size)
+{
+    const char *slash = strrchr(path, '/');
+    const char *back = strrchr(path, '\\');
+    size_t len;
+
+    if (back != NULL && (slash == NULL || back > slash)) {
+        slash = back;
+    }
+    len = slash != NULL ? (size_t)(slash - path) + 1u : 0u;
+    if (len >= out_size) {
+        return false;
+    }
+    memcpy(out, path, len);
+    out[len] = '\0';
+    return true;
+}
+
+/* "<root>objects/<2 hex>/<62 hex>"; with make_dirs, the two directories
+   are created on the way. */
+static bool store_object_path(
+    const char *root,
+    const uint8_t digest[SHA256_DIGEST_SIZE],
+    bool make_dirs,
+    char *out,
+    size_t out_size)
+{
+    char hex[SHA256_HEX_SIZE];
+    char objects[RUNTIME_SNAPSHOT_STORE_PATH_MAX];
+    char fan[RUNTIME_SNAPSHOT_STORE_PATH_MAX];
+    char prefix[3];
+
+    sha256_hex(digest, hex);
+    prefix[0] = hex[0];
+    prefix[1] = hex[1];
+    prefix[2] = '\0';
+    platform_fs_path_join(objects, sizeof(objects), root, "objects");
+    platform_fs_path_join(fan, sizeof(fan), objects, prefix);
+    platform_fs_path_join(out, out_size, fan, hex + 2);
+    if (strlen(out) + 1u >= out_size) {
+        return false; /* truncated */
+    }
+    if (make_dirs && (!platform_fs_make_dir(objects) || !platform_fs_make_dir(fan))) {
+        return false;
+    }
+    return true;
+}
+
+static bool store_read_file(const char *path, uint8_t **out_bytes, size_t *out_size)
+{
+    FILE *file = fopen(path, "rb");
+    long size;
+    uint8_t *bytes;
+
+    if (file == NULL) {
+        return false;
+    }
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 ||
+        fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return false;
+    }
+    bytes = (uint8_t *)malloc(size > 0 ? (size_t)size : 1u);
+    if (bytes == NULL) {
+        fclose(file);
+        return false;
+    }
+    if (size > 0 && fread(bytes, 1, (size_t)size, file) != (size_t)size) {
+        free(bytes);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+    *out_bytes = bytes;
+    *out_size = (size_t)size;
+    return true;
+}
+
+/* Object present with the right length: content addressing makes the bytes
+   the same, and objects only ever appear by rename. */
+static bool store_object_exists(const char *path, size_t size)
+{
+    FILE *file = fopen(path, "rb");
+    long length;
+
+    if (file == NULL) {
+        return false;
+    }
+    length = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    fclose(file);
+    return length >= 0 && (size_t)length == size;
+}
+
+/* Container header size, once magic and bounds check out. */
+static bool store_header_size(const uint8_t *bytes, size_t size, uint32_t magic, size_t *out)
+{
+    uint32_t header_size;
+
+    if (bytes == NULL || size < RUNTIME_SNAPSHOT_STORE_HEADER_MIN || store_le32(bytes) != magic) {
+        return false;
+    }
+    header_size = store_le32(bytes + 8);
+    if (header_size < RUNTIME_SNAPSHOT_STORE_HEADER_MIN || header_size > size) {
+        return false;
+    }
+    *out = header_size;
+    return true;
+}
+
+static bool store_next_chunk(
+    const uint8_t *bytes,
+    size_t size,
+    size_t pos,
+    uint32_t *tag,
+    uint32_t *len)
+{
+    if (size - pos < RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER) {
+        return false;
+    }
+    *tag = store_le32(bytes + pos);
+    *len = store_le32(bytes + pos + 4);
+    return *len <= RUNTIME_SNAPSHOT_STORE_CHUNK_MAX &&
+        *len <= size - pos - RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER;
+}
+
+bool runtime_snapshot_store_save(
+    const char *path,
+    const uint8_t *bytes,
+    size_t size,
+    size_t *out_new_blocks)
+{
+    char root[RUNTIME_SNAPSHOT_STORE_PATH_MAX];
+    char object[RUNTIME_SNAPSHOT_STORE_PATH_MAX];
+    size_t header_size;
+    size_t manifest_cap;
+    size_t manifest_size;
+    size_t new_blocks = 0;
+    size_t pos;
+    uint8_t *manifest;
+    uint32_t tag;
+    uint32_t len;
+    bool ok = true;
+
+    if (out_new_blocks != NULL) {
+        *out_new_blocks = 0;
+    }
+    if (!runtime_snapshot_store_is_ref(path) || !store_root(path, root, sizeof(root)) ||
+        !store_header_size(bytes, size, A2_SNAPSHOT_MAGIC, &header_size)) {
+        return false;
+    }
+
+    /* The store directory itself, one level like the objects below it. */
+    if (root[0] != '\0' && !platform_fs_make_dir(root)) {
+        return false;
+    }
+    /* A Blks chunk is never larger than the chunk it replaces. */
+    manifest_cap = size;
+    for (pos = header_size; pos < size; pos += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + len) {
+        if (!store_next_chunk(bytes, size, pos, &tag, &len)) {
+            return false;
+        }
+    }
+    manifest = (uint8_t *)malloc(manifest_cap);
+    if (manifest == NULL) {
+        return false;
+    }
+    memcpy(manifest, bytes, header_size);
+    store_put_le32(manifest, RUNTIME_SNAPSHOT_STORE_MAGIC);
+    manifest_size = header_size;
+
+    for (pos = header_size; ok && pos < size; pos += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + len) {
+        const uint8_t *payload;
+        uint8_t *out;
+        size_t count;
+        size_t i;
+
+        (void)store_next_chunk(bytes, size, pos, &tag, &len);
+        payload = bytes + pos + RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER;
+        out = manifest + manifest_size;
+        if (len < RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE) {
+            memcpy(out, bytes + pos, RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + (size_t)len);
+            manifest_size += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + (size_t)len;
+            continue;
+        }
+        count = store_block_count(len);
+        store_put_le32(out, RUNTIME_SNAPSHOT_STORE_TAG_BLKS);
+        store_put_le32(
+            out + 4, (uint32_t)(RUNTIME_SNAPSHOT_STORE_BLKS_HEADER + count * SHA256_DIGEST_SIZE));
+        store_put_le32(out + 8, tag);
+        store_put_le32(out + 12, len);
+        store_put_le32(out + 16, RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE);
+        store_put_le32(out + 20, (uint32_t)count);
+        out += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + RUNTIME_SNAPSHOT_STORE_BLKS_HEADER;
+        for (i = 0; ok && i < count; i++) {
+            size_t offset = i * RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE;
+            size_t block = len - offset < RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE ?
+                len - offset : RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE;
+
+            sha256(payload + offset, block, out + i * SHA256_DIGEST_SIZE);
+            ok = store_object_path(root, out + i * SHA256_DIGEST_SIZE, true, object, sizeof(object));
+            if (ok && !store_object_exists(object, block)) {
+                ok = runtime_state_writer_write_file(object, payload + offset, block);
+                new_blocks++;
+            }
+        }
+        manifest_size += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + RUNTIME_SNAPSHOT_STORE_BLKS_HEADER +
+            count * SHA256_DIGEST_SIZE;
+    }
+
+    /* Objects first, manifest last: a manifest on disk never names a block
+       that is not there. */
+    ok = ok && runtime_state_writer_write_file(path, manifest, manifest_size);
+    free(manifest);
+    if (ok && out_new_blocks != NULL) {
+        *out_new_blocks = new_blocks;
+    }
+    return ok;
+}
+
+/* Expand one Blks payload into out (exactly original size bytes). */
+static bool store_read_blocks(
+    const char *root,
+    const uint8_t *digests,
+    size_t count,
+    uint32_t original,
+    uint8_t *out)
+{
+    char object[RUNTIME_SNAPSHOT_STORE_PATH_MAX];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        size_t offset = i * RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE;
+        size_t block = original - offset < RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE ?
+            original - offset : RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE;
+        FILE *file;
+        bool read_ok;
+
+        if (!store_object_path(
+                root, digests + i * SHA256_DIGEST_SIZE, false, object, sizeof(object))) {
+            return false;
+        }
+        file = fopen(object, "rb");
+        if (file == NULL) {
+            return false;
+        }
+        read_ok = fread(out + offset, 1, block, file) == block && fgetc(file) == EOF;
+        fclose(file);
+        if (!read_ok) {
+            return false;
+        }
+        sha256(out + offset, block, digest);
+        if (memcmp(digest, digests + i * SHA256_DIGEST_SIZE, SHA256_DIGEST_SIZE) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool runtime_snapshot_store_load(const char *path, uint8_t **out_bytes, size_t *out_size)
+{
+    char root[RUNTIME_SNAPSHOT_STORE_PATH_MAX];
+    uint8_t *manifest = NULL;
+    uint8_t *bytes = NULL;
+    size_t manifest_size = 0;
+    size_t header_size;
+    size_t total;
+    size_t pos;
+    size_t out_pos;
+    uint32_t tag;
+    uint32_t len;
+    bool ok = true;
+
+    if (out_bytes == NULL || out_size == NULL || !runtime_snapshot_store_is_ref(path) ||
+        !store_root(path, root, sizeof(root)) ||
+        !store_read_file(path, &manifest, &manifest_size)) {
+        return false;
+    }
+    if (!store_header_size(manifest, manifest_size, RUNTIME_SNAPSHOT_STORE_MAGIC, &header_size)) {
+        free(manifest);
+        return false;
+    }
+
+    /* Size pass: validate every Blks chunk against its own fields. */
+    total = header_size;
+    for (pos = header_size; ok && pos < manifest_size;
+         pos += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + len) {
+        const uint8_t *payload;
+
+        ok = store_next_chunk(manifest, manifest_size, pos, &tag, &len);
+        if (!ok) {
+            break;
+        }
+        payload = manifest + pos + RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER;
+        if (tag != RUNTIME_SNAPSHOT_STORE_TAG_BLKS) {
+            total += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + (size_t)len;
+            continue;
+        }
+        ok = len >= RUNTIME_SNAPSHOT_STORE_BLKS_HEADER &&
+            store_le32(payload + 4) <= RUNTIME_SNAPSHOT_STORE_CHUNK_MAX &&
+            store_le32(payload + 8) == RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE &&
+            store_le32(payload + 12) == store_block_count(store_le32(payload + 4)) &&
+            len == RUNTIME_SNAPSHOT_STORE_BLKS_HEADER +
+                (size_t)store_le32(payload + 12) * SHA256_DIGEST_SIZE;
+        total += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + (size_t)store_le32(payload + 4);
+    }
+    if (ok) {
+        bytes = (uint8_t *)malloc(total);
+        ok = bytes != NULL;
+    }
+    if (!ok) {
+        free(manifest);
+        return false;
+    }
+
+    memcpy(bytes, manifest, header_size);
+    store_put_le32(bytes, A2_SNAPSHOT_MAGIC);
+    out_pos = header_size;
+    for (pos = header_size; ok && pos < manifest_size;
+         pos += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + len) {
+        const uint8_t *payload;
+        uint32_t original;
+
+        (void)store_next_chunk(manifest, manifest_size, pos, &tag, &len);
+        payload = manifest + pos + RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER;
+        if (tag != RUNTIME_SNAPSHOT_STORE_TAG_BLKS) {
+            memcpy(bytes + out_pos, manifest + pos, RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + (size_t)len);
+            out_pos += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + (size_t)len;
+            continue;
+        }
+        original = store_le32(payload + 4);
+        store_put_le32(bytes + out_pos, store_le32(payload));
+        store_put_le32(bytes + out_pos + 4, original);
+        ok = store_read_blocks(
+            root,
+            payload + RUNTIME_SNAPSHOT_STORE_BLKS_HEADER,
+            store_le32(payload + 12),
+            original,
+            bytes + out_pos + RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER);
+        out_pos += RUNTIME_SNAPSHOT_STORE_CHUNK_HEADER + (size_t)original;
+    }
+    free(manifest);
+    if (!ok) {
+        free(bytes);
+        return false;
+    }
+    *out_bytes = bytes;
+    *out_size = total;
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+/* Content-addressed snapshot store.
+ *
+ * A state saved to a path ending in ".a2sm" becomes a manifest: the .a2state
+ * bytes with magic 'A2SM' and every chunk of RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE
+ * bytes or more (RAM today; self-contained media when it exists) replaced by
+ * a 'Blks' chunk listing the SHA-256 of each block. Blocks are kept once,
+ * under "<manifest dir>/objects/<2 hex>/<62 hex>", so states that share
+ * pages share files. Every store file is written to a temp name and renamed
+ * into place; load verifies each block against its digest.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* LE fourcc 'A2SM', same convention as A2_SNAPSHOT_MAGIC. */
+#define RUNTIME_SNAPSHOT_STORE_MAGIC 0x4132534Du
+
+enum {
+    /* Sixteen Apple pages per object: one file per 256 bytes would cost
+       more in directory entries than it saves. */
+    RUNTIME_SNAPSHOT_STORE_BLOCK_SIZE = 4096
+};
+
+/* True for a path naming a store manifest (".a2sm", any case). */
+bool runtime_snapshot_store_is_ref(const char *path);
+
+/* Store .a2state bytes under path. out_new_blocks (nullable) counts the
+   objects that were not in the store yet. */
+bool runtime_snapshot_store_save(
+    const char *path,
+    const uint8_t *bytes,
+    size_t size,
+    size_t *out_new_blocks);
+
+/* Rebuild the .a2state bytes for the manifest at path (malloc'd, caller
+   frees). False when the manifest is malformed or a block is missing or
+   does not match its digest. */
+bool runtime_snapshot_store_load(const char *path, uint8_t **out_bytes, size_t *out_size);
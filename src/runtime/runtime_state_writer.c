@@ -0,0 +1,201 @@
+#include "runtime_state_writer.h"
+
+#include "cond.h"
+#include "message_queue.h"
+#include "mutex.h"
+#include "platform_fs.h"
+#include "runtime_snapshot_store.h"
+#include "thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct runtime_state_writer_job {
+    char path[RUNTIME_STATE_WRITER_PATH_MAX];
+    uint8_t *bytes; /* NULL with quit */
+    size_t size;
+    bool quit;
+} runtime_state_writer_job;
+
+struct runtime_state_writer {
+    thread *thread;
+    message_queue *jobs;
+    message_queue *results;
+    mutex *lock;
+    cond *idle;
+    size_t in_flight;   /* submitted, not yet written */
+    size_t outstanding; /* submitted, result not yet polled */
+};
+
+bool runtime_state_writer_write_file(const char *path, const uint8_t *bytes, size_t size)
+{
+    char temp[RUNTIME_STATE_WRITER_PATH_MAX + 8];
+    FILE *file;
+    bool ok;
+
+    if (path == NULL || path[0] == '\0' || (size > 0 && bytes == NULL)) {
+        return false;
+    }
+    /* Same directory as path, so the replace stays on one volume. */
+    if ((size_t)snprintf(temp, sizeof(temp), "%s.tmp", path) >= sizeof(temp)) {
+        return false;
+    }
+    file = fopen(temp, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    ok = size == 0 || fwrite(bytes, 1, size, file) == size;
+    ok = fflush(file) == 0 && ok;
+    ok = fclose(file) == 0 && ok;
+    if (!ok || !platform_fs_replace_file(temp, path)) {
+        (void)remove(temp);
+        return false;
+    }
+    return true;
+}
+
+bool runtime_state_writer_save(const char *path, const uint8_t *bytes, size_t size)
+{
+    if (runtime_snapshot_store_is_ref(path)) {
+        return runtime_snapshot_store_save(path, bytes, size, NULL);
+    }
+    return runtime_state_writer_write_file(path, bytes, size);
+}
+
+static int runtime_state_writer_main(void *userdata)
+{
+    runtime_state_writer *writer = (runtime_state_writer *)userdata;
+    runtime_state_writer_job job;
+    runtime_state_writer_result result;
+
+    for (;;) {
+        if (!message_queue_wait_pop(writer->jobs, &job)) {
+            continue;
+        }
+        if (job.quit) {
+            return 0;
+        }
+        memset(&result, 0, sizeof(result));
+        snprintf(result.path, sizeof(result.path), "%s", job.path);
+        result.ok = runtime_state_writer_save(job.path, job.bytes, job.size);
+        free(job.bytes);
+        /* Room is guaranteed: submit caps outstanding at the capacity. */
+        (void)message_queue_push(writer->results, &result);
+
+        mutex_lock(writer->lock);
+        writer->in_flight--;
+        if (writer->in_flight == 0u) {
+            cond_broadcast(writer->idle);
+        }
+        mutex_unlock(writer->lock);
+    }
+}
+
+runtime_state_writer *runtime_state_writer_create(void)
+{
+    runtime_state_writer *writer =
+        (runtime_state_writer *)calloc(1, sizeof(*writer));
+
+    if (writer == NULL) {
+        return NULL;
+    }
+    writer->jobs = message_queue_create(
+        sizeof(runtime_state_writer_job), RUNTIME_STATE_WRITER_QUEUE_CAPACITY + 1u);
+    writer->results = message_queue_create(
+        sizeof(runtime_state_writer_result), RUNTIME_STATE_WRITER_QUEUE_CAPACITY);
+    writer->lock = mutex_create();
+    writer->idle = cond_create();
+    if (writer->jobs == NULL || writer->results == NULL || writer->lock == NULL ||
+        writer->idle == NULL) {
+        runtime_state_writer_destroy(writer);
+        return NULL;
+    }
+    writer->thread = thread_create("a2m-state-io", runtime_state_writer_main, writer);
+    if (writer->thread == NULL) {
+        runtime_state_writer_destroy(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+void runtime_state_writer_destroy(runtime_state_writer *writer)
+{
+    runtime_state_writer_job job;
+
+    if (writer == NULL) {
+        return;
+    }
+    if (writer->thread != NULL) {
+        /* Jobs run in order, so quit lands after every queued write; the
+           spare slot keeps room for it. */
+        memset(&job, 0, sizeof(job));
+        job.quit = true;
+        (void)message_queue_push(writer->jobs, &job);
+        thread_join(writer->thread);
+        thread_destroy(writer->thread);
+    }
+    cond_destroy(writer->idle);
+    mutex_destroy(writer->lock);
+    message_queue_destroy(writer->results);
+    message_queue_destroy(writer->jobs);
+    free(writer);
+}
+
+bool runtime_state_writer_submit(
+    runtime_state_writer *writer,
+    const char *path,
+    uint8_t *bytes,
+    size_t size)
+{
+    runtime_state_writer_job job;
+
+    if (writer == NULL || path == NULL || path[0] == '\0' ||
+        strlen(path) >= sizeof(job.path) || (size > 0 && bytes == NULL)) {
+        return false;
+    }
+    mutex_lock(writer->lock);
+    if (writer->outstanding >= RUNTIME_STATE_WRITER_QUEUE_CAPACITY) {
+        mutex_unlock(writer->lock);
+        return false;
+    }
+    writer->outstanding++;
+    writer->in_flight++;
+    mutex_unlock(writer->lock);
+
+    memset(&job, 0, sizeof(job));
+    snprintf(job.path, sizeof(job.path), "%s", path);
+    job.bytes = bytes;
+    job.size = size;
+    if (!message_queue_push(writer->jobs, &job)) {
+        mutex_lock(writer->lock);
+        writer->outstanding--;
+        writer->in_flight--;
+        mutex_unlock(writer->lock);
+        return false;
+    }
+    return true;
+}
+
+bool runtime_state_writer_poll(runtime_state_writer *writer, runtime_state_writer_result *out)
+{
+    if (writer == NULL || out == NULL || !message_queue_try_pop(writer->results, out)) {
+        return false;
+    }
+    mutex_lock(writer->lock);
+    writer->outstanding--;
+    mutex_unlock(writer->lock);
+    return true;
+}
+
+void runtime_state_writer_flush(runtime_state_writer *writer)
+{
+    if (writer == NULL) {
+        return;
+    }
+    mutex_lock(writer->lock);
+    while (writer->in_flight > 0u) {
+        cond_wait(writer->idle, writer->lock);
+    }
+    mutex_unlock(writer->lock);
+}
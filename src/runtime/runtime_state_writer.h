@@ -0,0 +1,54 @@
+#pragma once
+
+/* Background writer for machine-state files.
+ *
+ * The worker serializes a snapshot in memory and hands the buffer over; the
+ * writer thread writes "<path>.tmp" and replaces path with it (or fills a
+ * snapshot store, runtime_snapshot_store.h), so emulation
+ * never waits on storage and a reader never sees a half-written file. Writes
+ * run in submit order and their results come back, in the same order,
+ * through runtime_state_writer_poll on the worker.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum {
+    RUNTIME_STATE_WRITER_PATH_MAX = 1024,
+    /* Writes submitted but not yet polled. */
+    RUNTIME_STATE_WRITER_QUEUE_CAPACITY = 8
+};
+
+typedef struct runtime_state_writer runtime_state_writer;
+
+typedef struct runtime_state_writer_result {
+    char path[RUNTIME_STATE_WRITER_PATH_MAX];
+    bool ok;
+} runtime_state_writer_result;
+
+/* Starts the writer thread; NULL when the thread or queues cannot be made. */
+runtime_state_writer *runtime_state_writer_create(void);
+/* Finishes queued writes, then joins the thread. Unpolled results are
+   dropped. */
+void runtime_state_writer_destroy(runtime_state_writer *writer);
+
+/* Queue bytes (malloc'd) for path and take ownership of them. False when
+   RUNTIME_STATE_WRITER_QUEUE_CAPACITY writes are outstanding or path is too
+   long; the caller then still owns bytes. */
+bool runtime_state_writer_submit(
+    runtime_state_writer *writer,
+    const char *path,
+    uint8_t *bytes,
+    size_t size);
+/* Next finished write; false when none is ready. */
+bool runtime_state_writer_poll(runtime_state_writer *writer, runtime_state_writer_result *out);
+/* Block until every submitted write has reached the disk or failed. */
+void runtime_state_writer_flush(runtime_state_writer *writer);
+
+/* The write itself, synchronous: "<path>.tmp", then replace path. */
+bool runtime_state_writer_write_file(const char *path, const uint8_t *bytes, size_t size);
+/* What a submitted job does: a store manifest and its objects for a
+   runtime_snapshot_store_is_ref path, runtime_state_writer_write_file
+   otherwise. */
+bool runtime_state_writer_save(const char *path, const uint8_t *bytes, size_t size);
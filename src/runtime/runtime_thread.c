@@ -5,11 +5,14 @@
 #include "apple2_snapshot.h"
 #include "apple_type_script.h"
 #include "audio_buffer.h"
+#include "lockfree_queue.h"
 #include "mboard.h"
-#include "message_queue.h"
+#include "runtime_boot_cache.h"
 #include "runtime_breakpoint_ini.h"
 #include "runtime_assembler.h"
 #include "runtime_history_wire.h"
+#include "runtime_snapshot_store.h"
+#include "runtime_state_writer.h"
 #include "softswitch.h"
 #include "video.h"
 
@@ -18,12 +21,16 @@
 #include <stdlib.h>
 #include <string.h>
 
-static void runtime_publish_argb_frame(runtime *rt);
+static void runtime_publish_frame(runtime *rt);
 static void runtime_set_active_turbo(runtime *rt, uint32_t milli_mhz);
 
 /* One TYPE wait unit ≈ 10 ms at ~1 MHz (product pacing, not cycle-perfect). */
 enum { RUNTIME_TYPE_WAIT_CYCLES_PER_UNIT = 10000u };
 
+/* step-back trusts the recorder's last instruction only this close to the
+   current cycle (longest 65C02 instruction plus an interrupt entry). */
+enum { RUNTIME_SEEK_INSTRUCTION_CYCLES_MAX = 16u };
+
 /* History record kinds must match machine observer kinds. */
 typedef char runtime_history_observer_kind_values_must_match[
     (int)APPLE2_CPU_OBSERVER_INSTRUCTION ==
@@ -46,6 +53,10 @@ static void runtime_publish_event(runtime *rt, const runtime_event *event);
 static void runtime_type_script_tick(runtime *rt, uint32_t cycles_elapsed);
 static void runtime_history_sync_observer(runtime *rt);
 static void runtime_reset_pacer(runtime *rt);
+static void runtime_produce_audio(runtime *rt, uint32_t cpu_cycles);
+static void runtime_maybe_frame(runtime *rt);
+static void runtime_finish_state_writes(runtime *rt);
+static void runtime_rewind_note_input(runtime *rt);
 
 static void runtime_history_observer_begin(
     void *user,
@@ -202,12 +213,15 @@ static runtime_state_changed_reason runtime_state_changed_reason_for_command(
         return RUNTIME_STATE_CHANGED_PAUSE;
     case RUNTIME_COMMAND_WRITE_MEMORY_BYTE:
     case RUNTIME_COMMAND_WRITE_MEMORY:
+    case RUNTIME_COMMAND_WRITE_MEMORY_SPANS:
     case RUNTIME_COMMAND_SET_CPU_REGISTER:
         return RUNTIME_STATE_CHANGED_POKE;
     case RUNTIME_COMMAND_RESET:
         return RUNTIME_STATE_CHANGED_RESET;
     case RUNTIME_COMMAND_LOAD_STATE:
     case RUNTIME_COMMAND_LOAD_BIN:
+    case RUNTIME_COMMAND_REWIND:
+    case RUNTIME_COMMAND_SEEK:
         return RUNTIME_STATE_CHANGED_LOAD_STATE;
     case RUNTIME_COMMAND_HISTORY_CLEAR:
     case RUNTIME_COMMAND_HISTORY_RECORD:
@@ -446,7 +460,7 @@ static bool runtime_publish_history_payload(
 
     event.data.history_rpc = *meta;
     if (rt->event_queue == NULL ||
-        !message_queue_push(rt->event_queue, &event)) {
+        !spsc_queue_push(rt->event_queue, &event)) {
         mutex_lock(pool->mutex);
         if (pool->slots[slot_index].in_use &&
             pool->slots[slot_index].request_token == request_token &&
@@ -849,12 +863,15 @@ static bool runtime_history_command_invalidates_cursor(runtime_command_type type
     case RUNTIME_COMMAND_RUN_TO_CURSOR:
     case RUNTIME_COMMAND_WRITE_MEMORY_BYTE:
     case RUNTIME_COMMAND_WRITE_MEMORY:
+    case RUNTIME_COMMAND_WRITE_MEMORY_SPANS:
     case RUNTIME_COMMAND_SET_CPU_REGISTER:
     case RUNTIME_COMMAND_HISTORY_RECORD:
     case RUNTIME_COMMAND_HISTORY_CLEAR:
     case RUNTIME_COMMAND_SAVE_STATE:
     case RUNTIME_COMMAND_LOAD_STATE:
     case RUNTIME_COMMAND_LOAD_BIN:
+    case RUNTIME_COMMAND_REWIND:
+    case RUNTIME_COMMAND_SEEK:
     case RUNTIME_COMMAND_ASSEMBLE_FILE:
     case RUNTIME_COMMAND_MEDIA_INSERT:
     case RUNTIME_COMMAND_MEDIA_EJECT:
@@ -867,6 +884,30 @@ static bool runtime_history_command_invalidates_cursor(runtime_command_type type
     }
 }
 
+/* Commands that change the machine from outside, which a replay from an
+   earlier checkpoint would not repeat. SET_GAMEPORT counts only when the
+   paddles or buttons actually move (hosts send it every frame). */
+static bool runtime_command_is_host_input(runtime_command_type type)
+{
+    switch (type) {
+    case RUNTIME_COMMAND_KEYBOARD_KEY:
+    case RUNTIME_COMMAND_PASTE_TEXT:
+    case RUNTIME_COMMAND_RESET:
+    case RUNTIME_COMMAND_WRITE_MEMORY_BYTE:
+    case RUNTIME_COMMAND_WRITE_MEMORY:
+    case RUNTIME_COMMAND_WRITE_MEMORY_SPANS:
+    case RUNTIME_COMMAND_SET_CPU_REGISTER:
+    case RUNTIME_COMMAND_LOAD_BIN:
+    case RUNTIME_COMMAND_ASSEMBLE_FILE:
+    case RUNTIME_COMMAND_MEDIA_SWAP:
+    case RUNTIME_COMMAND_SET_DISK_WRITABLE:
+    case RUNTIME_COMMAND_BOOT_SLOT:
+        return true;
+    default:
+        return false;
+    }
+}
+
 static void runtime_type_script_stop(runtime *rt)
 {
     if (rt == NULL) {
@@ -902,6 +943,7 @@ static void runtime_type_script_start(runtime *rt, const char *text)
     }
 
     apple2_paste_cancel(&rt->machine);
+    runtime_rewind_note_input(rt);
     rt->type_script_active = true;
     rt->type_script_await_paste = false;
     rt->type_script_index = 0;
@@ -1063,12 +1105,33 @@ view_flags_t runtime_mode_to_view_flags(runtime_memory_mode mode)
     }
 }
 
+static void runtime_settle_ram_mirror(runtime *rt);
+
+/* A stop settles the mirror first, so a client reacting to the event
+   reads the stopped machine rather than a frame-old copy. */
+static bool runtime_event_is_stop(runtime_event_type type)
+{
+    switch (type) {
+    case RUNTIME_EVENT_PAUSED:
+    case RUNTIME_EVENT_STEP_COMPLETE:
+    case RUNTIME_EVENT_RUN_COMPLETE:
+    case RUNTIME_EVENT_SEEK_COMPLETE:
+    case RUNTIME_EVENT_REWIND_COMPLETE:
+        return true;
+    default:
+        return false;
+    }
+}
+
 static void runtime_publish_event(runtime *rt, const runtime_event *event)
 {
     if (rt == NULL || event == NULL || rt->event_queue == NULL) {
         return;
     }
-    (void)message_queue_push(rt->event_queue, event);
+    if (runtime_event_is_stop(event->type)) {
+        runtime_settle_ram_mirror(rt);
+    }
+    (void)spsc_queue_push(rt->event_queue, event);
 }
 
 static void runtime_publish_simple(runtime *rt, runtime_event_type type)
@@ -1251,7 +1314,21 @@ static void runtime_save_state(runtime *rt, const runtime_command *command)
         runtime_publish_error(rt, "failed to serialize machine state snapshot");
         return;
     }
-    if (!runtime_write_file_bytes(path, bytes, written)) {
+    /* The writer owns bytes from here; SAVE_STATE_COMPLETE follows from
+       runtime_poll_state_writes once the file is on disk. A full queue
+       waits for the queued writes rather than writing beside them: they
+       may target the same path, and completions stay in save order. */
+    if (rt->state_writer != NULL) {
+        if (!runtime_state_writer_submit(rt->state_writer, path, bytes, written)) {
+            runtime_finish_state_writes(rt);
+            if (!runtime_state_writer_submit(rt->state_writer, path, bytes, written)) {
+                free(bytes);
+                runtime_publish_error(rt, "failed to queue machine state snapshot");
+            }
+        }
+        return;
+    }
+    if (!runtime_state_writer_save(path, bytes, written)) {
         free(bytes);
         runtime_publish_error(rt, "failed to write machine state snapshot");
         return;
@@ -1260,7 +1337,93 @@ static void runtime_save_state(runtime *rt, const runtime_command *command)
     runtime_publish_state_file_complete(rt, RUNTIME_EVENT_SAVE_STATE_COMPLETE, path);
 }
 
-static void runtime_load_state(runtime *rt, const runtime_command *command)
+/* Completions from the state writer, in save order. */
+static void runtime_poll_state_writes(runtime *rt)
+{
+    runtime_state_writer_result result;
+
+    while (runtime_state_writer_poll(rt->state_writer, &result)) {
+        if (rt->boot_cache_dir != NULL && strcmp(result.path, rt->boot_cache_path) == 0) {
+            /* Nobody asked for this save: only a failure is news. */
+            if (!result.ok) {
+                runtime_publish_error(rt, "failed to write boot cache snapshot");
+            }
+            continue;
+        }
+        if (!result.ok) {
+            runtime_publish_error(rt, "failed to write machine state snapshot");
+            continue;
+        }
+        runtime_publish_state_file_complete(rt, RUNTIME_EVENT_SAVE_STATE_COMPLETE, result.path);
+    }
+}
+
+static void runtime_finish_state_writes(runtime *rt)
+{
+    runtime_state_writer_flush(rt->state_writer);
+    runtime_poll_state_writes(rt);
+}
+
+/* Rewind buffer: drop every checkpoint (media or a state file changed the
+   machine under them); the next boundary re-bases the chain. */
+static void runtime_rewind_clear(runtime *rt)
+{
+    apple2_checkpoint_clear(rt->rewind);
+    rt->rewind_next_frame = 0u;
+}
+
+/* Host input (keys, gameport, paste, pokes, resets, disk swaps) landed
+   now; a replay from the newest checkpoint would run without it. */
+static void runtime_rewind_note_input(runtime *rt)
+{
+    apple2_checkpoint_note_input(rt->rewind, apple2_cycles(&rt->machine));
+}
+
+/* Whether re-running from checkpoint index up to cycle repeats what
+   happened: no host input since the checkpoint at or before cycle. */
+static bool runtime_rewind_replayable(const runtime *rt, size_t index, uint64_t cycle)
+{
+    apple2_checkpoint_info info;
+
+    return apple2_checkpoint_get_info(rt->rewind, index, &info) &&
+           (!info.input || info.input_cycle > cycle);
+}
+
+/* Whether a checkpoint is due. A frame number that went backwards (cold
+   reset) is due too. Two compares, so the beam path can ask before it
+   looks for an instruction boundary. */
+static bool runtime_rewind_due(const runtime *rt)
+{
+    const uint64_t frame = rt->machine.video.frame_number;
+
+    return rt->rewind != NULL &&
+           (frame >= rt->rewind_next_frame ||
+            frame + rt->rewind_interval_frames < rt->rewind_next_frame);
+}
+
+/* Take a checkpoint when one is due; the caller is at an instruction
+   boundary. */
+static void runtime_rewind_poll(runtime *rt)
+{
+    if (!runtime_rewind_due(rt)) {
+        return;
+    }
+    rt->rewind_next_frame = rt->machine.video.frame_number + rt->rewind_interval_frames;
+    if (!apple2_checkpoint_take(rt->rewind, &rt->machine)) {
+        return; /* out of memory: the dirty pages carry to the next take */
+    }
+    /* A paste or TYPE script still feeding keys is input a restore drops
+       (apple2_checkpoint_restore cancels a paste). */
+    if (apple2_paste_active(&rt->machine) || rt->type_script_active) {
+        runtime_rewind_note_input(rt);
+    }
+    while (apple2_checkpoint_count(rt->rewind) > 1u &&
+           (uint64_t)apple2_checkpoint_bytes(rt->rewind) > rt->rewind_budget_bytes) {
+        apple2_checkpoint_drop_oldest(rt->rewind);
+    }
+}
+
+static bool runtime_load_state(runtime *rt, const runtime_command *command)
 {
     const char *path = command->data.state_file.path;
     uint8_t *bytes = NULL;
@@ -1268,14 +1431,18 @@ static void runtime_load_state(runtime *rt, const runtime_command *command)
     bool was_running = rt->exec_state == RUNTIME_EXEC_RUNNING;
     runtime_stop_reason previous_stop_reason = rt->last_stop_reason;
 
-    if (!runtime_read_file_bytes(path, &bytes, &size)) {
+    /* A save still in flight may be the very file asked for. */
+    runtime_finish_state_writes(rt);
+    if (runtime_snapshot_store_is_ref(path) ?
+            !runtime_snapshot_store_load(path, &bytes, &size) :
+            !runtime_read_file_bytes(path, &bytes, &size)) {
         runtime_publish_error(rt, "failed to read machine state snapshot");
-        return;
+        return false;
     }
     if (!apple2_snapshot_load(&rt->machine, bytes, size)) {
         free(bytes);
         runtime_publish_error(rt, "failed to load machine state snapshot");
-        return;
+        return false;
     }
     free(bytes);
 
@@ -1284,6 +1451,7 @@ static void runtime_load_state(runtime *rt, const runtime_command *command)
             rt->history, apple2_cycles(&rt->machine));
     }
     runtime_frame_ring_clear(&rt->frame_ring);
+    runtime_rewind_clear(rt);
     runtime_history_sync_observer(rt);
     apple2_paste_cancel(&rt->machine);
 
@@ -1301,7 +1469,168 @@ static void runtime_load_state(runtime *rt, const runtime_command *command)
     runtime_publish_machine(rt);
     if (rt->machine.video.fb != NULL) {
         apple2_video_paint_full_frame(&rt->machine);
-        runtime_publish_argb_frame(rt);
+        runtime_publish_frame(rt);
+    }
+    return true;
+}
+
+/* Boot cache at startup: a hit loads like load-state (LOAD_STATE_COMPLETE
+   names the cache file); a miss arms the capture. */
+static void runtime_boot_cache_start(runtime *rt)
+{
+    runtime_command command;
+    FILE *file;
+
+    if (rt->boot_cache_dir == NULL) {
+        return;
+    }
+    if (!runtime_boot_cache_path(rt, rt->boot_cache_path, sizeof(rt->boot_cache_path))) {
+        runtime_publish_error(rt, "boot cache off: cannot key the mounted media");
+        return;
+    }
+    file = fopen(rt->boot_cache_path, "rb");
+    if (file != NULL) {
+        fclose(file);
+        memset(&command, 0, sizeof(command));
+        command.type = RUNTIME_COMMAND_LOAD_STATE;
+        snprintf(command.data.state_file.path, sizeof(command.data.state_file.path), "%s",
+                 rt->boot_cache_path);
+        if (runtime_load_state(rt, &command)) {
+            return;
+        }
+        /* Damaged entry: boot and write it again. */
+    }
+    rt->boot_cache_armed = true;
+    rt->boot_cache_text_frame = UINT64_MAX;
+}
+
+/* Cache miss: save once the condition holds at an instruction boundary.
+   The text is decoded once per video frame. */
+static void runtime_boot_cache_poll(runtime *rt)
+{
+    runtime_command command;
+    uint64_t frame = rt->machine.video.frame_number;
+    bool met = false;
+
+    if (!runtime_at_instruction_boundary(rt)) {
+        return;
+    }
+    if (rt->boot_cache_until_pc >= 0 &&
+        rt->machine.cpu.cpu.pc == (uint16_t)rt->boot_cache_until_pc) {
+        met = true;
+    } else if (rt->boot_cache_until_text[0] != '\0' && frame != rt->boot_cache_text_frame) {
+        rt->boot_cache_text_frame = frame;
+        met = runtime_boot_cache_text_visible(rt);
+    }
+    if (!met) {
+        return;
+    }
+    rt->boot_cache_armed = false;
+    memset(&command, 0, sizeof(command));
+    command.type = RUNTIME_COMMAND_SAVE_STATE;
+    snprintf(command.data.state_file.path, sizeof(command.data.state_file.path), "%s",
+             rt->boot_cache_path);
+    runtime_save_state(rt, &command);
+}
+
+/* Step back about frames frames: restore the newest checkpoint at or before
+   the target and re-run to it, so the landing frame is exact while the
+   checkpoints stay interval frames apart. The re-run stops short of host
+   input noted after the checkpoint, which it cannot repeat, so such a
+   rewind lands earlier than asked. History keeps its records and the
+   machine continues on a new timeline. */
+static void runtime_rewind(runtime *rt, const runtime_command *command)
+{
+    const uint32_t frames = command->data.rewind.frames;
+    const uint64_t from_frame = rt->machine.video.frame_number;
+    const size_t count = apple2_checkpoint_count(rt->rewind);
+    const bool rw_breakpoints = rt->has_rw_breakpoints;
+    apple2_checkpoint_info info;
+    runtime_event event;
+    uint64_t target;
+    uint64_t start_cycle;
+    uint64_t cycle_limit;
+    size_t index = 0u;
+    size_t i;
+
+    memset(&event, 0, sizeof(event));
+    event.type = RUNTIME_EVENT_REWIND_COMPLETE;
+    event.request_token = command->request_token;
+    if (count == 0u) {
+        event.data.rewind.frame_number = from_frame;
+        event.data.rewind.cycles = apple2_cycles(&rt->machine);
+        runtime_publish_event(rt, &event);
+        return;
+    }
+
+    target = frames < from_frame ? from_frame - frames : 0u;
+    for (i = 1u; i < count; i++) {
+        if (!apple2_checkpoint_get_info(rt->rewind, i, &info) || info.frame_number > target) {
+            break;
+        }
+        index = i;
+    }
+    (void)apple2_checkpoint_get_info(rt->rewind, index, &info);
+    if (info.frame_number > target) {
+        target = info.frame_number; /* older than the buffer: its oldest */
+    }
+
+    runtime_finish_to_instruction_boundary(rt);
+    runtime_history_prepare_discontinuity(rt);
+    if (!apple2_checkpoint_restore(rt->rewind, &rt->machine, index)) {
+        runtime_rewind_clear(rt);
+        event.data.rewind.frame_number = from_frame;
+        event.data.rewind.cycles = apple2_cycles(&rt->machine);
+        runtime_publish_event(rt, &event);
+        return;
+    }
+    if (rt->history != NULL) {
+        runtime_history_status status;
+        (void)runtime_history_transition_timeline(rt->history);
+        runtime_history_get_status(rt->history, &status);
+        if (status.available && status.recording) {
+            (void)runtime_history_append_marker(
+                rt->history,
+                RUNTIME_HISTORY_MARKER_REWIND,
+                frames,
+                (uint32_t)target,
+                apple2_cycles(&rt->machine));
+        }
+    }
+
+    /* Re-run from the checkpoint without R/W breakpoints, audio or paint;
+       the recorder (if on) sees the replay on the new timeline. */
+    rt->has_rw_breakpoints = false;
+    start_cycle = apple2_cycles(&rt->machine);
+    cycle_limit = (target - info.frame_number + 1u) * (uint64_t)APPLE2_VIDEO_CYCLES_PER_FRAME;
+    while (rt->machine.video.frame_number < target &&
+           apple2_cycles(&rt->machine) - start_cycle < cycle_limit &&
+           (!info.input || apple2_cycles(&rt->machine) < info.input_cycle)) {
+        if (apple2_step_instruction(&rt->machine) == 0u) {
+            break;
+        }
+    }
+    rt->has_rw_breakpoints = rw_breakpoints;
+    (void)apple2_video_take_frame_ready(&rt->machine);
+    rt->breakpoint_hit_pending = false;
+    rt->rewind_next_frame = rt->machine.video.frame_number + rt->rewind_interval_frames;
+    runtime_frame_ring_truncate(&rt->frame_ring, rt->machine.video.frame_number);
+    if (rt->exec_state == RUNTIME_EXEC_RUNNING) {
+        runtime_reset_pacer(rt);
+    }
+
+    event.data.rewind.ok = 1u;
+    event.data.rewind.frame_number = rt->machine.video.frame_number;
+    event.data.rewind.frames = from_frame > event.data.rewind.frame_number ?
+        (uint32_t)(from_frame - event.data.rewind.frame_number) : 0u;
+    event.data.rewind.cycles = apple2_cycles(&rt->machine);
+    event.data.rewind.checkpoints = (uint32_t)apple2_checkpoint_count(rt->rewind);
+    runtime_publish_event(rt, &event);
+    runtime_publish_cpu(rt, 0u);
+    runtime_publish_machine(rt);
+    if (rt->machine.video.fb != NULL) {
+        apple2_video_paint_full_frame(&rt->machine);
+        runtime_publish_frame(rt);
     }
 }
 
@@ -1560,35 +1889,32 @@ static void runtime_publish_call_stack(runtime *rt, uint64_t token)
     runtime_publish_event(rt, &event);
 }
 
-static void runtime_publish_machine(runtime *rt)
+static void runtime_fill_machine_snapshot(runtime *rt, runtime_machine_snapshot *state)
 {
-    runtime_event event;
     int slot;
-    memset(&event, 0, sizeof(event));
-    event.type = RUNTIME_EVENT_MACHINE_STATE_RESPONSE;
-    event.data.machine_state.runtime_seq = ++rt->runtime_seq;
-    event.data.machine_state.cycle = apple2_cycles(&rt->machine);
-    event.data.machine_state.cpu_cycles = apple2_cycles(&rt->machine);
-    event.data.machine_state.pc = rt->machine.cpu.cpu.pc;
-    event.data.machine_state.a = rt->machine.cpu.cpu.A;
-    event.data.machine_state.x = rt->machine.cpu.cpu.X;
-    event.data.machine_state.y = rt->machine.cpu.cpu.Y;
-    event.data.machine_state.sp = (uint8_t)(rt->machine.cpu.cpu.sp & 0xFFu);
-    event.data.machine_state.p = rt->machine.cpu.cpu.flags;
-    event.data.machine_state.ready = rt->machine.ready ? 1u : 0u;
-    event.data.machine_state.running = rt->exec_state == RUNTIME_EXEC_RUNNING ? 1u : 0u;
-    event.data.machine_state.stop_reason = rt->last_stop_reason;
-    event.data.machine_state.frame_number = rt->machine.video.frame_number;
-    event.data.machine_state.dropped_frames = rt->frame_slot.dropped_frames;
-    event.data.machine_state.active_turbo_multiplier = rt->active_turbo_multiplier;
-    event.data.machine_state.turbo_speed_count = rt->turbo_speed_count;
-    event.data.machine_state.apple_state_flags = rt->machine.state_flags;
-    event.data.machine_state.apple_model =
-        rt->machine.model == APPLE2_MODEL_II_PLUS ? 1u : 0u;
-    event.data.machine_state.video_line = rt->machine.video.line;
-    event.data.machine_state.video_cycle_in_line = rt->machine.video.cycle_in_line;
+    memset(state, 0, sizeof(*state));
+    state->runtime_seq = rt->runtime_seq;
+    state->cycle = apple2_cycles(&rt->machine);
+    state->cpu_cycles = apple2_cycles(&rt->machine);
+    state->pc = rt->machine.cpu.cpu.pc;
+    state->a = rt->machine.cpu.cpu.A;
+    state->x = rt->machine.cpu.cpu.X;
+    state->y = rt->machine.cpu.cpu.Y;
+    state->sp = (uint8_t)(rt->machine.cpu.cpu.sp & 0xFFu);
+    state->p = rt->machine.cpu.cpu.flags;
+    state->ready = rt->machine.ready ? 1u : 0u;
+    state->running = rt->exec_state == RUNTIME_EXEC_RUNNING ? 1u : 0u;
+    state->stop_reason = rt->last_stop_reason;
+    state->frame_number = rt->machine.video.frame_number;
+    state->dropped_frames = rt->frame_slot.dropped_frames;
+    state->active_turbo_multiplier = rt->active_turbo_multiplier;
+    state->turbo_speed_count = rt->turbo_speed_count;
+    state->apple_state_flags = rt->machine.state_flags;
+    state->apple_model = rt->machine.model == APPLE2_MODEL_II_PLUS ? 1u : 0u;
+    state->video_line = rt->machine.video.line;
+    state->video_cycle_in_line = rt->machine.video.cycle_in_line;
     for (slot = 1; slot <= 7; ++slot) {
-        runtime_slot_snapshot *out = &event.data.machine_state.slots[slot];
+        runtime_slot_snapshot *out = &state->slots[slot];
         int device;
         switch (rt->machine.slot_type[slot]) {
         case SLOT_TYPE_DISKII:
@@ -1646,11 +1972,70 @@ static void runtime_publish_machine(runtime *rt)
                 mask = (uint8_t)(mask | (1u << s));
             }
         }
-        event.data.machine_state.disk_motor_mask = mask;
+        state->disk_motor_mask = mask;
     }
+}
+
+static void runtime_publish_machine(runtime *rt)
+{
+    runtime_event event;
+    memset(&event, 0, sizeof(event));
+    event.type = RUNTIME_EVENT_MACHINE_STATE_RESPONSE;
+    ++rt->runtime_seq;
+    runtime_fill_machine_snapshot(rt, &event.data.machine_state);
     runtime_publish_event(rt, &event);
 }
 
+/* Refresh the lock-free RAM mirror (frame, stop, or applied mutation). */
+static void runtime_publish_ram_mirror(runtime *rt)
+{
+    runtime_machine_snapshot state;
+
+    if (rt->ram_mirror == NULL || !rt->machine_ready) {
+        return;
+    }
+    runtime_fill_machine_snapshot(rt, &state);
+    runtime_ram_mirror_publish(
+        rt->ram_mirror, &rt->machine, &state, rt->ram_mirror_applied);
+    runtime_shm_publish_ram(rt->shm, &rt->machine, &state);
+    rt->ram_mirror_published_applied = rt->ram_mirror_applied;
+    rt->ram_mirror_published_cycle = state.cycle;
+    rt->ram_mirror_was_running = rt->exec_state == RUNTIME_EXEC_RUNNING;
+}
+
+static void runtime_note_command_applied(runtime *rt)
+{
+    if (rt->ram_mirror_pending) {
+        rt->ram_mirror_pending = false;
+        rt->ram_mirror_applied++;
+    }
+}
+
+/* Frames publish while running; this covers stops and paused-time edits. */
+static void runtime_sync_ram_mirror(runtime *rt)
+{
+    bool running = rt->exec_state == RUNTIME_EXEC_RUNNING;
+
+    if (rt->ram_mirror_applied != rt->ram_mirror_published_applied ||
+        (rt->ram_mirror_was_running && !running)) {
+        runtime_publish_ram_mirror(rt);
+    }
+}
+
+/* Before a stop event: the command that stopped counts as applied, and a
+   stop reached mid-run (breakpoint, watchpoint) republishes on the moved
+   cycle even before exec_state leaves RUNNING. */
+static void runtime_settle_ram_mirror(runtime *rt)
+{
+    runtime_note_command_applied(rt);
+    if (rt->machine_ready &&
+        apple2_cycles(&rt->machine) != rt->ram_mirror_published_cycle) {
+        runtime_publish_ram_mirror(rt);
+        return;
+    }
+    runtime_sync_ram_mirror(rt);
+}
+
 static void runtime_refresh_rw_breakpoint_flag(runtime *rt);
 
 static void runtime_publish_breakpoints(runtime *rt)
@@ -2149,12 +2534,21 @@ static bool runtime_breakpoint_matches_access(
     for (i = 0; i < rt->breakpoint_count; ++i) {
         runtime_breakpoint *breakpoint = &rt->breakpoints[i];
 
-        if (breakpoint->enabled &&
-            (breakpoint->access_mask & access) != 0 &&
-            runtime_breakpoint_address_matches(breakpoint, address) &&
-            runtime_breakpoint_mapping_matches(rt, breakpoint, access, address) &&
-            runtime_breakpoint_condition_matches(rt, breakpoint, has_value, value) &&
-            runtime_breakpoint_record_match(rt, breakpoint)) {
+        if (!breakpoint->enabled ||
+            (breakpoint->access_mask & access) == 0 ||
+            !runtime_breakpoint_address_matches(breakpoint, address) ||
+            !runtime_breakpoint_mapping_matches(rt, breakpoint, access, address) ||
+            !runtime_breakpoint_condition_matches(rt, breakpoint, has_value, value)) {
+            continue;
+        }
+        /* Reverse-continue search: only where a stop would land. */
+        if (rt->seek_probe) {
+            if ((breakpoint->action_mask & RUNTIME_BREAKPOINT_ACTION_BREAK) != 0) {
+                return true;
+            }
+            continue;
+        }
+        if (runtime_breakpoint_record_match(rt, breakpoint)) {
             return runtime_execute_breakpoint_actions(rt, breakpoint);
         }
     }
@@ -2389,6 +2783,306 @@ static void runtime_pause_for_step(runtime *rt)
     runtime_publish_cpu(rt, 0u);
 }
 
+/* Newest rewind checkpoint at or before cycle (strictly before when
+   strict); false when every checkpoint is newer or there are none. */
+static bool runtime_seek_find_checkpoint(
+    runtime *rt,
+    uint64_t cycle,
+    bool strict,
+    size_t *out_index)
+{
+    size_t index = apple2_checkpoint_count(rt->rewind);
+    apple2_checkpoint_info info;
+
+    while (index > 0u) {
+        index--;
+        if (apple2_checkpoint_get_info(rt->rewind, index, &info) &&
+            (strict ? info.cycle < cycle : info.cycle <= cycle)) {
+            *out_index = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Run to the first instruction boundary at or after cycle with breakpoints
+   quiet. Execution from a checkpoint repeats itself only up to the first
+   host input after it (runtime_rewind_replayable, which every caller
+   checks); short of that a boundary seen on an earlier pass is landed on
+   exactly. */
+static void runtime_seek_replay(runtime *rt, uint64_t cycle)
+{
+    const bool rw_breakpoints = rt->has_rw_breakpoints;
+
+    rt->has_rw_breakpoints = false;
+    while (apple2_cycles(&rt->machine) < cycle) {
+        if (apple2_step_instruction(&rt->machine) == 0u) {
+            break;
+        }
+    }
+    rt->has_rw_breakpoints = rw_breakpoints;
+}
+
+/* Reverse-continue search pass: run to end and report the last boundary
+   before origin where a breakpoint would have stopped the machine (at an
+   execute match, or after the instruction that tripped a watchpoint). */
+static bool runtime_seek_probe(runtime *rt, uint64_t end, uint64_t origin, uint64_t *out_cycle)
+{
+    bool found = false;
+
+    rt->breakpoint_hit_pending = false;
+    while (apple2_cycles(&rt->machine) < end) {
+        uint64_t at = apple2_cycles(&rt->machine);
+
+        if (runtime_breakpoint_matches_access(
+                rt, RUNTIME_BREAKPOINT_ACCESS_EXECUTE, rt->machine.cpu.cpu.pc, false, 0u)) {
+            *out_cycle = at;
+            found = true;
+        }
+        if (apple2_step_instruction(&rt->machine) == 0u) {
+            break;
+        }
+        if (rt->breakpoint_hit_pending) {
+            rt->breakpoint_hit_pending = false;
+            if (apple2_cycles(&rt->machine) < origin) {
+                *out_cycle = apple2_cycles(&rt->machine);
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+/* Restore checkpoint index (dropping newer ones) and re-run to cycle. The
+   recorder sees the re-run on a new timeline after a SEEK marker. */
+static bool runtime_seek_land(runtime *rt, size_t index, uint64_t cycle, runtime_seek_kind kind)
+{
+    if (!apple2_checkpoint_restore(rt->rewind, &rt->machine, index)) {
+        runtime_rewind_clear(rt);
+        return false;
+    }
+    if (rt->history != NULL) {
+        runtime_history_status status;
+        (void)runtime_history_transition_timeline(rt->history);
+        runtime_history_get_status(rt->history, &status);
+        if (status.available && status.recording) {
+            (void)runtime_history_append_marker(
+                rt->history,
+                RUNTIME_HISTORY_MARKER_SEEK,
+                (uint32_t)kind,
+                (uint32_t)cycle,
+                apple2_cycles(&rt->machine));
+        }
+    }
+    runtime_seek_replay(rt, cycle);
+    (void)apple2_video_take_frame_ready(&rt->machine);
+    rt->breakpoint_hit_pending = false;
+    rt->rewind_next_frame = rt->machine.video.frame_number + rt->rewind_interval_frames;
+    runtime_frame_ring_truncate(&rt->frame_ring, rt->machine.video.frame_number);
+    return true;
+}
+
+/* The previous instruction boundary: the recorder's last instruction when
+   it holds one, otherwise found by a silent pass from the checkpoint. */
+static bool runtime_seek_previous_boundary(
+    runtime *rt,
+    uint64_t origin,
+    size_t *out_index,
+    uint64_t *out_cycle)
+{
+    const bool rw_breakpoints = rt->has_rw_breakpoints;
+    runtime_history_status status;
+    runtime_history_record record;
+    uint64_t boundary;
+
+    /* Only an unbroken recording's last instruction is the one just run. */
+    if (rt->history != NULL) {
+        runtime_history_get_status(rt->history, &status);
+    }
+    if (rt->history != NULL && status.available && status.recording &&
+        runtime_history_last(rt->history, &record) &&
+        record.kind == RUNTIME_HISTORY_RECORD_INSTRUCTION && !record.partial &&
+        record.machine_cycle < origin &&
+        origin - record.machine_cycle <= RUNTIME_SEEK_INSTRUCTION_CYCLES_MAX &&
+        runtime_seek_find_checkpoint(rt, record.machine_cycle, false, out_index) &&
+        runtime_rewind_replayable(rt, *out_index, record.machine_cycle)) {
+        *out_cycle = record.machine_cycle;
+        return true;
+    }
+    if (!runtime_seek_find_checkpoint(rt, origin, true, out_index) ||
+        !runtime_rewind_replayable(rt, *out_index, origin) ||
+        !apple2_checkpoint_restore_keep(rt->rewind, &rt->machine, *out_index)) {
+        return false;
+    }
+    boundary = apple2_cycles(&rt->machine);
+    apple2_set_cpu_observer(&rt->machine, NULL, NULL);
+    rt->has_rw_breakpoints = false;
+    while (apple2_cycles(&rt->machine) < origin) {
+        boundary = apple2_cycles(&rt->machine);
+        if (apple2_step_instruction(&rt->machine) == 0u) {
+            break;
+        }
+    }
+    rt->has_rw_breakpoints = rw_breakpoints;
+    runtime_history_sync_observer(rt);
+    *out_cycle = boundary;
+    return true;
+}
+
+/* Search the rewind buffer backwards, one checkpoint interval at a time,
+   for the last breakpoint stop before origin. An interval with host input
+   in it cannot be searched past the input, so the search ends there
+   (*out_blocked). */
+static bool runtime_seek_previous_breakpoint(
+    runtime *rt,
+    uint64_t origin,
+    size_t *out_index,
+    uint64_t *out_cycle,
+    bool *out_blocked)
+{
+    apple2_checkpoint_info info;
+    uint64_t end = origin;
+    size_t index;
+    bool found = false;
+
+    if (!runtime_seek_find_checkpoint(rt, origin, true, &index)) {
+        return false;
+    }
+    apple2_set_cpu_observer(&rt->machine, NULL, NULL);
+    rt->seek_probe = true;
+    for (;;) {
+        if (!runtime_rewind_replayable(rt, index, end)) {
+            *out_blocked = true;
+            break;
+        }
+        if (!apple2_checkpoint_restore_keep(rt->rewind, &rt->machine, index)) {
+            break;
+        }
+        if (runtime_seek_probe(rt, end, origin, out_cycle)) {
+            found = true;
+            break;
+        }
+        if (index == 0u || !apple2_checkpoint_get_info(rt->rewind, index, &info)) {
+            break;
+        }
+        end = info.cycle;
+        index--;
+    }
+    rt->seek_probe = false;
+    rt->breakpoint_hit_pending = false;
+    runtime_history_sync_observer(rt);
+    *out_index = index;
+    return found;
+}
+
+/* Step back, reverse-continue or run to a cycle. Backwards moves restore a
+   rewind checkpoint and re-run to the target; forward run-to-cycle runs
+   like run-instructions and stops early at a breakpoint. Always pauses. */
+static void runtime_seek(runtime *rt, const runtime_command *command)
+{
+    const runtime_seek_kind kind = (runtime_seek_kind)command->data.seek.kind;
+    runtime_seek_result result = RUNTIME_SEEK_OK;
+    runtime_stop_reason stop = RUNTIME_STOP_REASON_STEP;
+    runtime_event event;
+    uint64_t origin;
+    uint64_t target = command->data.seek.cycle;
+    size_t index = 0u;
+    bool blocked = false;
+
+    runtime_finish_to_instruction_boundary(rt);
+    origin = apple2_cycles(&rt->machine);
+    rt->temp_bp_active = false;
+
+    if (kind == RUNTIME_SEEK_CYCLE && target >= origin) {
+        while (apple2_cycles(&rt->machine) < target) {
+            uint64_t c0 = apple2_cycles(&rt->machine);
+
+            if (!rt->suppress_execute_bp && runtime_breakpoint_matches_pc(rt)) {
+                stop = RUNTIME_STOP_REASON_BREAKPOINT;
+                break;
+            }
+            if (!apple2_step_instruction(&rt->machine)) {
+                break;
+            }
+            if (apple2_cycles(&rt->machine) > c0) {
+                runtime_produce_audio(rt, (uint32_t)(apple2_cycles(&rt->machine) - c0));
+            }
+            runtime_maybe_frame(rt);
+            rt->suppress_execute_bp = false;
+            if (rt->breakpoint_hit_pending) {
+                stop = RUNTIME_STOP_REASON_BREAKPOINT;
+                break;
+            }
+        }
+    } else {
+        bool have_target;
+
+        runtime_history_prepare_discontinuity(rt);
+        switch (kind) {
+        case RUNTIME_SEEK_STEP_BACK:
+            have_target = runtime_seek_previous_boundary(rt, origin, &index, &target);
+            break;
+        case RUNTIME_SEEK_REVERSE_CONTINUE:
+            have_target = runtime_seek_previous_breakpoint(
+                rt, origin, &index, &target, &blocked);
+            if (have_target) {
+                stop = RUNTIME_STOP_REASON_BREAKPOINT;
+            } else if (runtime_seek_find_checkpoint(rt, origin, true, &index) &&
+                       runtime_rewind_replayable(rt, index, origin)) {
+                /* Nothing earlier, or nothing after the last input: go back
+                   to where the search started. */
+                result = blocked ? RUNTIME_SEEK_INPUT : RUNTIME_SEEK_NO_BREAKPOINT;
+                target = origin;
+                have_target = true;
+            }
+            break;
+        case RUNTIME_SEEK_CYCLE:
+        default:
+            have_target = runtime_seek_find_checkpoint(rt, target, false, &index) &&
+                          runtime_rewind_replayable(rt, index, target);
+            break;
+        }
+        if (!have_target) {
+            /* No checkpoint old enough, or replaying from it crosses input. */
+            const uint64_t until = kind == RUNTIME_SEEK_CYCLE ? target : origin;
+
+            blocked = blocked ||
+                      (runtime_seek_find_checkpoint(
+                           rt, until, kind != RUNTIME_SEEK_CYCLE, &index) &&
+                       !runtime_rewind_replayable(rt, index, until));
+            result = blocked ? RUNTIME_SEEK_INPUT : RUNTIME_SEEK_NO_CHECKPOINT;
+            stop = RUNTIME_STOP_REASON_STEP;
+        } else if (!runtime_seek_land(rt, index, target, kind)) {
+            result = RUNTIME_SEEK_NO_CHECKPOINT;
+            stop = RUNTIME_STOP_REASON_STEP;
+        }
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.type = RUNTIME_EVENT_SEEK_COMPLETE;
+    event.request_token = command->request_token;
+    event.data.seek.kind = (uint8_t)kind;
+    event.data.seek.result = (uint8_t)result;
+    event.data.seek.stop = (uint8_t)stop;
+    event.data.seek.pc = rt->machine.cpu.cpu.pc;
+    event.data.seek.cycles = apple2_cycles(&rt->machine);
+    event.data.seek.frame_number = rt->machine.video.frame_number;
+    runtime_publish_event(rt, &event);
+    if (stop == RUNTIME_STOP_REASON_BREAKPOINT) {
+        runtime_pause_for_breakpoint(rt);
+    } else {
+        rt->exec_state = RUNTIME_EXEC_PAUSED;
+        rt->last_stop_reason = stop;
+        runtime_publish_machine(rt);
+        runtime_publish_simple(rt, RUNTIME_EVENT_PAUSED);
+        runtime_publish_cpu(rt, 0u);
+    }
+    if (rt->machine.video.fb != NULL) {
+        apple2_video_paint_full_frame(&rt->machine);
+        runtime_publish_frame(rt);
+    }
+}
+
 static bool runtime_turbo_is_free_run(const runtime *rt)
 {
     /* Max (0) free-runs; finite milli-MHz values are paced. */
@@ -2410,6 +3104,9 @@ static void runtime_apply_turbo_video_policy(runtime *rt, bool leaving_max)
     } else {
         if (leaving_max) {
             apple2_video_reseed_from_cycles(&rt->machine);
+            /* The handoff back buffer is a few presentations old; repaint it
+               so the beam's first partial frame lands on current content. */
+            apple2_video_paint_full_frame(&rt->machine);
         }
         rt->machine.video.paint_enabled = true;
     }
@@ -2463,7 +3160,7 @@ static void runtime_set_active_turbo(runtime *rt, uint32_t milli_mhz)
     if (now_max && rt->machine_ready) {
         /* Immediate presentation frame so max is never blank. */
         apple2_video_paint_full_frame(&rt->machine);
-        runtime_publish_argb_frame(rt);
+        runtime_publish_frame(rt);
     }
 }
 
@@ -2528,6 +3225,9 @@ static void runtime_free_run_max_quantum(runtime *rt)
             if (type_active) {
                 runtime_type_script_tick(rt, (uint32_t)ran);
             }
+            if (rt->boot_cache_armed) {
+                runtime_boot_cache_poll(rt);
+            }
             if (runtime_pause_if_breakpoint_pending(rt)) {
                 return;
             }
@@ -2544,8 +3244,9 @@ static void runtime_free_run_max_quantum(runtime *rt)
     }
 
     /* Presentation paint ~60 Hz wall — not blank warp. */
+    runtime_rewind_poll(rt);
     apple2_video_paint_full_frame(&rt->machine);
-    runtime_publish_argb_frame(rt);
+    runtime_publish_frame(rt);
 }
 
 /* Speaker soft-square amplitude (pre-AC-couple). Modest so MB can share headroom. */
@@ -2798,12 +3499,45 @@ static void runtime_pace_after_frame(runtime *rt)
     }
 }
 
-static void runtime_publish_argb_frame(runtime *rt)
+/* Rolling screen log (C2): live frames (max uses presentation paint later).
+   Video mode keeps the beam splits only for a frame the beam just finished. */
+static void runtime_push_frame_ring(
+    runtime *rt,
+    bool beam,
+    uint64_t frame_number,
+    uint64_t machine_cycle,
+    const uint8_t *fb,
+    const uint32_t *palette)
+{
+    if (rt->frame_ring.mode != RUNTIME_FRAME_RING_MODE_VIDEO) {
+        (void)runtime_frame_ring_push(
+            &rt->frame_ring, frame_number, machine_cycle,
+            APPLE2_VIDEO_WIDTH, APPLE2_VIDEO_HEIGHT, fb, palette);
+        return;
+    }
+    if (rt->frame_capture == NULL) {
+        rt->frame_capture = (apple2_video_capture *)malloc(sizeof(*rt->frame_capture));
+        if (rt->frame_capture == NULL) {
+            return;
+        }
+    }
+    apple2_video_capture_frame(&rt->machine, beam, rt->frame_capture);
+    (void)runtime_frame_ring_push_video(
+        &rt->frame_ring, frame_number, machine_cycle, fb, rt->frame_capture,
+        rt->machine.rom_char, rt->machine.rom_char_size,
+        rt->machine.model == APPLE2_MODEL_II_PLUS);
+}
+
+/* Hand the painted back buffer to the consumer and paint into the next one.
+   complete=false (a mid-frame request) carries the painted part over so the
+   beam keeps drawing on top of it; complete frames rotate without a copy. */
+static void runtime_publish_frame_from(runtime *rt, bool beam, bool complete)
 {
-    const uint32_t *fb = apple2_video_framebuffer(&rt->machine);
-    uint32_t w = APPLE2_VIDEO_WIDTH;
-    uint32_t h = APPLE2_VIDEO_HEIGHT;
-    size_t nbytes = (size_t)w * (size_t)h * sizeof(uint32_t);
+    const uint8_t *fb = apple2_video_indexed_framebuffer(&rt->machine);
+    const uint32_t *palette = apple2_video_palette();
+    size_t nbytes = (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT;
+    runtime_frame_buffer *back;
+    runtime_frame_buffer *next;
     runtime_event event;
     uint64_t frame_number;
     uint64_t machine_cycle;
@@ -2815,26 +3549,35 @@ static void runtime_publish_argb_frame(runtime *rt)
     frame_number = rt->machine.video.frame_number;
     machine_cycle = apple2_cycles(&rt->machine);
 
-    mutex_lock(rt->frame_slot.mutex);
-    if (rt->frame_slot.argb == NULL) {
-        rt->frame_slot.argb = (uint32_t *)malloc(nbytes);
-    }
-    if (rt->frame_slot.argb != NULL) {
-        if (rt->frame_slot.has_frame) {
-            rt->frame_slot.dropped_frames++;
-        }
-        memcpy(rt->frame_slot.argb, fb, nbytes);
-        rt->frame_slot.width = w;
-        rt->frame_slot.height = h;
-        rt->frame_slot.frame_number = frame_number;
-        rt->frame_slot.has_frame = true;
-        rt->frame_slot.published_frames++;
+    /* Ring first: fb is still worker-owned until the handoff publish. */
+    runtime_push_frame_ring(rt, beam, frame_number, machine_cycle, fb, palette);
+
+    back = runtime_frame_handoff_back(rt->frame_slot.handoff);
+    if (back->pixels != fb) {
+        memcpy(back->pixels, fb, nbytes);
     }
-    mutex_unlock(rt->frame_slot.mutex);
+    memcpy(back->palette, palette, sizeof(back->palette));
+    back->width = APPLE2_VIDEO_WIDTH;
+    back->height = APPLE2_VIDEO_HEIGHT;
+    back->frame_number = frame_number;
+    back->machine_cycle = machine_cycle;
+    if (rt->shm != NULL) {
+        runtime_frame_ring_info ring_info;
 
-    /* Rolling screen log (C2): live frames (max uses presentation paint later). */
-    (void)runtime_frame_ring_push(
-        &rt->frame_ring, frame_number, machine_cycle, w, h, fb);
+        runtime_shm_publish_frame(rt->shm, back);
+        runtime_frame_ring_get_info(&rt->frame_ring, &ring_info);
+        runtime_shm_publish_ring(rt->shm, &ring_info);
+    }
+    if (runtime_frame_handoff_publish(rt->frame_slot.handoff)) {
+        rt->frame_slot.dropped_frames++;
+    }
+    rt->frame_slot.frame_number = frame_number;
+    rt->frame_slot.published_frames++;
+    next = runtime_frame_handoff_back(rt->frame_slot.handoff);
+    if (!complete) {
+        memcpy(next->pixels, back->pixels, nbytes);
+    }
+    apple2_video_set_paint_target(&rt->machine, next->pixels);
 
     memset(&event, 0, sizeof(event));
     event.type = RUNTIME_EVENT_FRAME_READY;
@@ -2853,11 +3596,24 @@ static void runtime_publish_argb_frame(runtime *rt)
         }
         event.data.frame_ready.disk_motor_mask = mask;
     }
+    runtime_publish_ram_mirror(rt);
     runtime_publish_event(rt, &event);
 }
 
+/* Publish after a block paint (state load, display override, requests). */
+static void runtime_publish_frame(runtime *rt)
+{
+    runtime_publish_frame_from(rt, false, true);
+}
+
 static void runtime_maybe_frame(runtime *rt)
 {
+    if (rt->boot_cache_armed) {
+        runtime_boot_cache_poll(rt);
+    }
+    if (runtime_rewind_due(rt) && runtime_at_instruction_boundary(rt)) {
+        runtime_rewind_poll(rt);
+    }
     if (!apple2_video_take_frame_ready(&rt->machine)) {
         return;
     }
@@ -2865,18 +3621,64 @@ static void runtime_maybe_frame(runtime *rt)
         /* Max: live path is wall-paced block paint, not beam frame_ready. */
         return;
     }
-    runtime_publish_argb_frame(rt);
+    runtime_publish_frame_from(rt, true, true);
     runtime_pace_after_frame(rt);
 }
 
-static uint8_t runtime_read_byte(runtime *rt, uint16_t addr, runtime_memory_mode mode)
+static void runtime_write_byte(runtime *rt, uint16_t addr, uint8_t value, runtime_memory_mode mode)
 {
-    return apple2_read_in_view(&rt->machine, runtime_mode_to_view_flags(mode), addr);
+    apple2_write_in_view(&rt->machine, runtime_mode_to_view_flags(mode), addr, value);
 }
 
-static void runtime_write_byte(runtime *rt, uint16_t addr, uint8_t value, runtime_memory_mode mode)
+/* Hand bytes to the token-keyed pool and announce them (or BUSY when the
+   pool is full). Takes ownership of bytes; NULL reports an error. */
+static void runtime_publish_memory_rpc(
+    runtime *rt,
+    uint64_t token,
+    uint16_t address,
+    runtime_memory_mode mode,
+    uint8_t *bytes,
+    uint32_t length)
 {
-    apple2_write_in_view(&rt->machine, runtime_mode_to_view_flags(mode), addr, value);
+    runtime_event event;
+    bool parked = false;
+    size_t j;
+
+    memset(&event, 0, sizeof(event));
+    event.type = RUNTIME_EVENT_MEMORY_RPC_COMPLETE;
+    event.request_token = token;
+    event.data.memory_rpc.address = address;
+    event.data.memory_rpc.length = length;
+    event.data.memory_rpc.mode = mode;
+
+    if (bytes == NULL) {
+        event.data.memory_rpc.status = RUNTIME_MEMORY_RPC_ERROR;
+        runtime_publish_event(rt, &event);
+        return;
+    }
+    mutex_lock(rt->rpc_payload_pool.mutex);
+    for (j = 0; j < RUNTIME_RPC_PAYLOAD_POOL_CAPACITY; j++) {
+        runtime_rpc_payload_slot *slot = &rt->rpc_payload_pool.slots[j];
+        if (!slot->in_use) {
+            slot->in_use = 1;
+            slot->kind = RUNTIME_RPC_PAYLOAD_MEMORY;
+            slot->request_token = token;
+            slot->meta.memory.address = address;
+            slot->meta.memory.mode = mode;
+            slot->length = length;
+            slot->bytes = bytes;
+            parked = true;
+            break;
+        }
+    }
+    mutex_unlock(rt->rpc_payload_pool.mutex);
+    if (!parked) {
+        free(bytes);
+        event.data.memory_rpc.status = RUNTIME_MEMORY_RPC_BUSY;
+    } else {
+        event.data.memory_rpc.status = RUNTIME_MEMORY_RPC_OK;
+    }
+    runtime_publish_event(rt, &event);
 }
 
 static void runtime_handle_request_memory(runtime *rt, const runtime_command *cmd)
@@ -2885,7 +3687,7 @@ static void runtime_handle_request_memory(runtime *rt, const runtime_command *cm
     uint16_t address = cmd->data.request_memory.address;
     uint32_t length = cmd->data.request_memory.length;
     uint64_t token = cmd->request_token;
-    uint32_t i;
+    view_flags_t vf = runtime_mode_to_view_flags(mode);
 
     if (length == 0u || length > RUNTIME_MEMORY_RPC_MAX_LENGTH) {
         return;
@@ -2902,93 +3704,163 @@ static void runtime_handle_request_memory(runtime *rt, const runtime_command *cm
         event.data.memory.address = address;
         event.data.memory.length = (uint16_t)copy_len;
         event.data.memory.mode = mode;
-        for (i = 0; i < copy_len; i++) {
-            event.data.memory.bytes[i] =
-                runtime_read_byte(rt, (uint16_t)(address + i), mode);
-        }
+        apple2_copy_in_view(&rt->machine, vf, address, event.data.memory.bytes, copy_len);
         runtime_publish_event(rt, &event);
         return;
     }
 
     {
         uint8_t *bytes = (uint8_t *)malloc(length);
-        runtime_event event;
-        bool parked = false;
-        size_t j;
+        if (bytes != NULL) {
+            apple2_copy_in_view(&rt->machine, vf, address, bytes, length);
+        }
+        runtime_publish_memory_rpc(rt, token, address, mode, bytes, length);
+    }
+}
 
-        memset(&event, 0, sizeof(event));
-        event.type = RUNTIME_EVENT_MEMORY_RPC_COMPLETE;
-        event.request_token = token;
-        event.data.memory_rpc.address = address;
-        event.data.memory_rpc.length = length;
-        event.data.memory_rpc.mode = mode;
-
-        if (bytes == NULL) {
-            event.data.memory_rpc.status = RUNTIME_MEMORY_RPC_ERROR;
-            runtime_publish_event(rt, &event);
-            return;
+/* Total bytes of a span command, or 0 when it is malformed. */
+static uint32_t runtime_memory_spans_total(const runtime_command *cmd)
+{
+    uint32_t total = 0;
+    uint32_t k;
+
+    if (cmd->data.memory_spans.count == 0u ||
+        cmd->data.memory_spans.count > RUNTIME_MEMORY_SPANS_MAX) {
+        return 0u;
+    }
+    for (k = 0; k < cmd->data.memory_spans.count; k++) {
+        const runtime_memory_span *span = &cmd->data.memory_spans.spans[k];
+        if (span->length == 0u || span->length > RUNTIME_MEMORY_RPC_MAX_LENGTH ||
+            span->mode > RUNTIME_MEMORY_MODE_LC2) {
+            return 0u;
         }
-        for (i = 0; i < length; i++) {
-            bytes[i] = runtime_read_byte(rt, (uint16_t)(address + i), mode);
-        }
-        mutex_lock(rt->rpc_payload_pool.mutex);
-        for (j = 0; j < RUNTIME_RPC_PAYLOAD_POOL_CAPACITY; j++) {
-            runtime_rpc_payload_slot *slot = &rt->rpc_payload_pool.slots[j];
-            if (!slot->in_use) {
-                slot->in_use = 1;
-                slot->kind = RUNTIME_RPC_PAYLOAD_MEMORY;
-                slot->request_token = token;
-                slot->meta.memory.address = address;
-                slot->meta.memory.mode = mode;
-                slot->length = length;
-                slot->bytes = bytes;
-                parked = true;
-                break;
-            }
+        total += span->length;
+    }
+    return total <= RUNTIME_MEMORY_SPANS_MAX_LENGTH ? total : 0u;
+}
+
+static void runtime_handle_request_memory_spans(runtime *rt, const runtime_command *cmd)
+{
+    const runtime_memory_span *spans = cmd->data.memory_spans.spans;
+    uint32_t total = runtime_memory_spans_total(cmd);
+    uint8_t *bytes;
+    uint32_t used = 0;
+    uint32_t k;
+
+    if (total == 0u || cmd->request_token == 0u) {
+        return;
+    }
+    bytes = (uint8_t *)malloc(total);
+    if (bytes != NULL) {
+        for (k = 0; k < cmd->data.memory_spans.count; k++) {
+            apple2_copy_in_view(
+                &rt->machine,
+                runtime_mode_to_view_flags((runtime_memory_mode)spans[k].mode),
+                spans[k].address,
+                bytes + used,
+                spans[k].length);
+            used += spans[k].length;
         }
-        mutex_unlock(rt->rpc_payload_pool.mutex);
-        if (!parked) {
-            free(bytes);
-            event.data.memory_rpc.status = RUNTIME_MEMORY_RPC_BUSY;
-        } else {
-            event.data.memory_rpc.status = RUNTIME_MEMORY_RPC_OK;
+    }
+    runtime_publish_memory_rpc(
+        rt,
+        cmd->request_token,
+        spans[0].address,
+        (runtime_memory_mode)spans[0].mode,
+        bytes,
+        total);
+}
+
+static void runtime_handle_write_memory_spans(runtime *rt, const runtime_command *cmd)
+{
+    const runtime_memory_span *spans = cmd->data.memory_spans.spans;
+    uint32_t total = runtime_memory_spans_total(cmd);
+    uint8_t *bytes = NULL;
+    uint32_t length = 0;
+    uint32_t used = 0;
+    uint32_t k;
+    size_t j;
+
+    mutex_lock(rt->rpc_payload_pool.mutex);
+    for (j = 0; j < RUNTIME_RPC_PAYLOAD_POOL_CAPACITY; j++) {
+        runtime_rpc_payload_slot *slot = &rt->rpc_payload_pool.slots[j];
+        if (slot->in_use && slot->kind == RUNTIME_RPC_PAYLOAD_MEMORY_WRITE &&
+            slot->request_token == cmd->request_token) {
+            bytes = slot->bytes;
+            length = slot->length;
+            memset(slot, 0, sizeof(*slot));
+            break;
+        }
+    }
+    mutex_unlock(rt->rpc_payload_pool.mutex);
+
+    if (bytes != NULL && total != 0u && total == length &&
+        rt->exec_state != RUNTIME_EXEC_RUNNING) {
+        for (k = 0; k < cmd->data.memory_spans.count; k++) {
+            apple2_store_in_view(
+                &rt->machine,
+                runtime_mode_to_view_flags((runtime_memory_mode)spans[k].mode),
+                spans[k].address,
+                bytes + used,
+                spans[k].length);
+            used += spans[k].length;
         }
-        runtime_publish_event(rt, &event);
     }
+    free(bytes);
 }
 
 static void runtime_fill_debug_memory(runtime *rt, bool include_write_history)
 {
-    uint32_t a;
+    uint32_t page;
+    bool full;
+    bool full_history;
+    runtime_debug_memory_slot *slot = &rt->debug_memory_slot;
     runtime_debug_memory_snapshot *snap;
+    const apple2_t *m = &rt->machine;
+    uint8_t *views[RUNTIME_RAM_MIRROR_VIEWS];
 
-    mutex_lock(rt->debug_memory_slot.mutex);
-    snap = &rt->debug_memory_slot.snapshot;
-    memset(snap, 0, sizeof(*snap));
-    snap->generation = ++rt->debug_memory_slot.generation;
+    mutex_lock(slot->mutex);
+    snap = &slot->snapshot;
+    /* The snapshot persists between fills: only pages written, remapped or
+       wiped since the previous fill are copied, each as one span per view. */
+    full = runtime_page_tracker_needs_full(&slot->tracker, m);
+    full_history = full || !slot->history_primed;
+    if (!slot->tracker.primed) {
+        memset(snap, 0, sizeof(*snap));
+        memset(snap->aux_valid, 1, sizeof(snap->aux_valid));
+        memset(snap->lc1_valid, 1, sizeof(snap->lc1_valid));
+        memset(snap->lc2_valid, 1, sizeof(snap->lc2_valid));
+    }
+    views[RUNTIME_MEMORY_MODE_MAP] = snap->map;
+    views[RUNTIME_MEMORY_MODE_MAIN] = snap->ram;
+    views[RUNTIME_MEMORY_MODE_ROM] = snap->rom;
+    views[RUNTIME_MEMORY_MODE_AUX] = snap->aux;
+    views[RUNTIME_MEMORY_MODE_LC1] = snap->lc1;
+    views[RUNTIME_MEMORY_MODE_LC2] = snap->lc2;
+    snap->generation = ++slot->generation;
     snap->has_write_history = include_write_history ? 1u : 0u;
-    for (a = 0; a < 65536u; a++) {
-        uint16_t addr = (uint16_t)a;
-        snap->map[a] = apple2_read_in_view(
-            &rt->machine, view_flags_from_area(RUNTIME_VIEW_AREA_MAP), addr);
-        snap->ram[a] = apple2_read_in_view(
-            &rt->machine, view_flags_from_area(RUNTIME_VIEW_AREA_MAIN), addr);
-        snap->rom[a] = apple2_read_in_view(
-            &rt->machine, view_flags_from_area(RUNTIME_VIEW_AREA_ROM), addr);
-        snap->aux[a] = apple2_read_in_view(
-            &rt->machine, view_flags_from_area(RUNTIME_VIEW_AREA_AUX), addr);
-        snap->lc1[a] = apple2_read_in_view(
-            &rt->machine, view_flags_from_area(RUNTIME_VIEW_AREA_LC1), addr);
-        snap->lc2[a] = apple2_read_in_view(
-            &rt->machine, view_flags_from_area(RUNTIME_VIEW_AREA_LC2), addr);
-        snap->aux_valid[a] = 1;
-        snap->lc1_valid[a] = 1;
-        snap->lc2_valid[a] = 1;
-        if (include_write_history) {
-            snap->write_history[a] =
-                apple2_debug_read_write_history(&rt->machine, addr);
+    snap->dirty_page_count = 0u;
+    for (page = 0; page < APPLE2_NUM_PAGES; page++) {
+        uint32_t base = page * APPLE2_PAGE_SIZE;
+        bool dirty = full || runtime_page_tracker_page_stale(&slot->tracker, m, page);
+
+        snap->dirty_pages[page] = dirty ? 1u : 0u;
+        if (include_write_history && (dirty || full_history)) {
+            uint32_t i;
+            for (i = 0; i < APPLE2_PAGE_SIZE; i++) {
+                snap->write_history[base + i] =
+                    apple2_debug_read_write_history(m, (uint16_t)(base + i));
+            }
         }
+        if (!dirty) {
+            continue;
+        }
+        snap->dirty_page_count++;
+        runtime_copy_view_page(m, page, views);
+        runtime_page_tracker_mark_page(&slot->tracker, m, page);
     }
+    runtime_page_tracker_finish(&slot->tracker, m);
+    slot->history_primed = include_write_history;
     rt->debug_memory_slot.has_snapshot = true;
     mutex_unlock(rt->debug_memory_slot.mutex);
     runtime_publish_simple(rt, RUNTIME_EVENT_DEBUG_MEMORY_READY);
@@ -3388,6 +4260,9 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
             runtime_state_changed_reason_for_command(cmd->type),
             cmd->session_id);
     }
+    if (runtime_command_is_host_input(cmd->type)) {
+        runtime_rewind_note_input(rt);
+    }
     switch (cmd->type) {
     case RUNTIME_COMMAND_PING: {
         runtime_event event;
@@ -3708,8 +4583,11 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
     case RUNTIME_COMMAND_REQUEST_FRAME:
         if (runtime_turbo_is_free_run(rt)) {
             apple2_video_paint_full_frame(&rt->machine);
+            runtime_publish_frame(rt);
+        } else {
+            /* Beam may be mid-frame: publish what is painted so far. */
+            runtime_publish_frame_from(rt, false, false);
         }
-        runtime_publish_argb_frame(rt);
         break;
     case RUNTIME_COMMAND_SET_CPU_REGISTER:
         runtime_set_register(
@@ -3741,16 +4619,20 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
         break;
     case RUNTIME_COMMAND_WRITE_MEMORY:
         if (rt->exec_state != RUNTIME_EXEC_RUNNING) {
-            uint16_t i;
-            for (i = 0; i < cmd->data.write_memory.length; i++) {
-                runtime_write_byte(
-                    rt,
-                    (uint16_t)(cmd->data.write_memory.address + i),
-                    cmd->data.write_memory.bytes[i],
-                    (runtime_memory_mode)cmd->data.write_memory.mode);
-            }
+            apple2_store_in_view(
+                &rt->machine,
+                runtime_mode_to_view_flags((runtime_memory_mode)cmd->data.write_memory.mode),
+                cmd->data.write_memory.address,
+                cmd->data.write_memory.bytes,
+                cmd->data.write_memory.length);
         }
         break;
+    case RUNTIME_COMMAND_REQUEST_MEMORY_SPANS:
+        runtime_handle_request_memory_spans(rt, cmd);
+        break;
+    case RUNTIME_COMMAND_WRITE_MEMORY_SPANS:
+        runtime_handle_write_memory_spans(rt, cmd);
+        break;
     case RUNTIME_COMMAND_SET_EXECUTE_BREAKPOINT:
         runtime_set_execute_breakpoint(rt, cmd);
         break;
@@ -3784,10 +4666,19 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
             cmd->data.keyboard_key.key,
             cmd->data.keyboard_key.pressed != 0);
         break;
-    case RUNTIME_COMMAND_SET_GAMEPORT:
+    case RUNTIME_COMMAND_SET_GAMEPORT: {
+        uint8_t axis[4];
+        const uint8_t buttons = rt->machine.gameport_buttons;
+
+        memcpy(axis, rt->machine.gameport_axis, sizeof(axis));
         apple2_gameport_set_axes(&rt->machine, cmd->data.set_gameport.axis);
         apple2_gameport_set_buttons(&rt->machine, cmd->data.set_gameport.buttons);
+        if (memcmp(axis, rt->machine.gameport_axis, sizeof(axis)) != 0 ||
+            buttons != rt->machine.gameport_buttons) {
+            runtime_rewind_note_input(rt);
+        }
         break;
+    }
     case RUNTIME_COMMAND_PASTE_TEXT: {
         const char *text = cmd->data.paste_text.text;
         size_t length = cmd->data.paste_text.length;
@@ -3848,6 +4739,8 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
         }
         if (result != 0) {
             runtime_publish_error(rt, "media insert failed");
+        } else {
+            runtime_rewind_clear(rt);
         }
         runtime_publish_media_changed(
             rt, RUNTIME_MEDIA_CHANGE_INSERT, slot, device, card_type,
@@ -3869,6 +4762,8 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
         }
         if (result != 0) {
             runtime_publish_error(rt, "media eject failed");
+        } else {
+            runtime_rewind_clear(rt);
         }
         runtime_publish_media_changed(
             rt,
@@ -3973,7 +4868,18 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
             cmd->data.set_display_override.enabled != 0u,
             cmd->data.set_display_override.flags);
         apple2_video_paint_full_frame(&rt->machine);
-        runtime_publish_argb_frame(rt);
+        runtime_publish_frame(rt);
+        break;
+
+    case RUNTIME_COMMAND_BATCH_BEGIN:
+        rt->batch_hold_until_ms = (uint64_t)SDL_GetTicks() + RUNTIME_BATCH_HOLD_MS;
+        break;
+
+    case RUNTIME_COMMAND_BATCH_END:
+        rt->batch_hold_until_ms = 0u;
+        if (rt->exec_state == RUNTIME_EXEC_RUNNING) {
+            runtime_reset_pacer(rt);
+        }
         break;
 
     /* ---- History C4a: info / record on|off / clear ---- */
@@ -4111,7 +5017,13 @@ static void runtime_process_command(runtime *rt, const runtime_command *cmd, boo
         runtime_save_state(rt, cmd);
         break;
     case RUNTIME_COMMAND_LOAD_STATE:
-        runtime_load_state(rt, cmd);
+        (void)runtime_load_state(rt, cmd);
+        break;
+    case RUNTIME_COMMAND_REWIND:
+        runtime_rewind(rt, cmd);
+        break;
+    case RUNTIME_COMMAND_SEEK:
+        runtime_seek(rt, cmd);
         break;
     case RUNTIME_COMMAND_LOAD_BIN:
         runtime_load_bin(rt, cmd);
@@ -4173,6 +5085,15 @@ static void runtime_free_run_batch(runtime *rt)
     }
 }
 
+/* Count a memory-changing command once processed; a stop event it posts
+   counts it early (runtime_settle_ram_mirror). */
+static void runtime_apply_command(runtime *rt, const runtime_command *cmd, bool *alive)
+{
+    rt->ram_mirror_pending = runtime_command_changes_memory(cmd->type);
+    runtime_process_command(rt, cmd, alive);
+    runtime_note_command_applied(rt);
+}
+
 int runtime_thread_main(void *userdata)
 {
     runtime *rt = (runtime *)userdata;
@@ -4198,6 +5119,11 @@ int runtime_thread_main(void *userdata)
         return 1;
     }
     apple2_set_memory_access_callback(&rt->machine, runtime_on_memory_access, rt);
+    /* Only the video-mode frame ring re-renders beam splits. */
+    rt->machine.video.record_splits =
+        rt->frame_ring.capacity != 0u && rt->frame_ring.mode == RUNTIME_FRAME_RING_MODE_VIDEO;
+    apple2_video_set_paint_target(
+        &rt->machine, runtime_frame_handoff_back(rt->frame_slot.handoff)->pixels);
     apple2_set_model(
         &rt->machine,
         rt->config.apple_model == 1 ? APPLE2_MODEL_II_PLUS : APPLE2_MODEL_IIE_ENHANCED);
@@ -4312,6 +5238,7 @@ int runtime_thread_main(void *userdata)
     runtime_publish_simple(rt, RUNTIME_EVENT_PAUSED);
     runtime_publish_cpu(rt, 0u);
     runtime_publish_machine(rt);
+    runtime_boot_cache_start(rt);
 
     if (rt->config.start_running) {
         rt->exec_state = RUNTIME_EXEC_RUNNING;
@@ -4319,9 +5246,12 @@ int runtime_thread_main(void *userdata)
         runtime_publish_simple(rt, RUNTIME_EVENT_RUNNING);
     }
 
+    runtime_publish_ram_mirror(rt);
+
     while (alive) {
-        while (message_queue_try_pop(rt->command_queue, &command)) {
-            runtime_process_command(rt, &command, &alive);
+        runtime_poll_state_writes(rt);
+        while (mpsc_queue_try_pop(rt->command_queue, &command)) {
+            runtime_apply_command(rt, &command, &alive);
             if (!alive) {
                 break;
             }
@@ -4329,16 +5259,26 @@ int runtime_thread_main(void *userdata)
         if (!alive) {
             break;
         }
-        if (rt->exec_state == RUNTIME_EXEC_RUNNING) {
+        if (rt->batch_hold_until_ms != 0u) {
+            /* Inside a batch: apply commands only, never free-run. */
+            if (mpsc_queue_wait_pop_timeout(rt->command_queue, &command, 1u)) {
+                runtime_apply_command(rt, &command, &alive);
+            } else if ((uint64_t)SDL_GetTicks() >= rt->batch_hold_until_ms) {
+                rt->batch_hold_until_ms = 0u;
+            }
+        } else if (rt->exec_state == RUNTIME_EXEC_RUNNING) {
             runtime_free_run_batch(rt);
         } else {
-            if (!message_queue_wait_pop_timeout(rt->command_queue, &command, 10u)) {
-                continue;
+            if (mpsc_queue_wait_pop_timeout(rt->command_queue, &command, 10u)) {
+                runtime_apply_command(rt, &command, &alive);
             }
-            runtime_process_command(rt, &command, &alive);
         }
+        /* Every pass ends published, a paused wait that timed out included:
+           edits drained at the top of the pass are otherwise never seen. */
+        runtime_sync_ram_mirror(rt);
     }
 
+    runtime_finish_state_writes(rt);
     runtime_publish_simple(rt, RUNTIME_EVENT_STOPPED);
     if (!apple2_flush_media(&rt->machine)) {
         runtime_publish_error(rt, "failed to flush media during shutdown");
@@ -0,0 +1,309 @@
+/* lockfree_queue.c — compiled at C11 (see CMakeLists.txt per-file property).
+   Uses C11 _Atomic for the MPSC/SPSC rings.
+   The public header (lockfree_queue.h) is C99-compatible. */
+
+#include "lockfree_queue.h"
+
+#include <SDL.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Consumer parking shared by both queues. The consumer raises `parked`
+   and re-checks the queue before sleeping; a producer checks `parked` after
+   publishing. The seq_cst fences on both sides mean at least one of them
+   sees the other, so a push never slips past a sleeping consumer. */
+typedef struct queue_parking {
+    _Atomic int parked;
+    wake_event *consumer;
+    _Atomic(wake_event *) listener;
+} queue_parking;
+
+static bool queue_parking_init(queue_parking *parking) {
+    atomic_init(&parking->parked, 0);
+    atomic_init(&parking->listener, NULL);
+    parking->consumer = wake_event_create();
+    return parking->consumer != NULL;
+}
+
+static void queue_parking_destroy(queue_parking *parking) {
+    wake_event_destroy(parking->consumer);
+    parking->consumer = NULL;
+}
+
+static void queue_parking_notify(queue_parking *parking) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&parking->parked, memory_order_relaxed) != 0) {
+        wake_event_signal(parking->consumer);
+    }
+    wake_event_signal(atomic_load_explicit(&parking->listener, memory_order_acquire));
+}
+
+/* Milliseconds of timeout_ms left since start (SDL_GetTicks). A wake can
+   be stale or come from a cell behind the head that is still being filled,
+   so waiters loop on this rather than on one wake_event_wait. */
+static uint32_t queue_wait_remaining(uint32_t start, uint32_t timeout_ms) {
+    uint32_t elapsed = SDL_GetTicks() - start;
+    return elapsed < timeout_ms ? timeout_ms - elapsed : 0u;
+}
+
+static size_t queue_round_capacity(size_t capacity) {
+    size_t cap = 1u;
+    while (cap < capacity) {
+        cap <<= 1u;
+    }
+    return cap;
+}
+
+/* ---- MPSC --------------------------------------------------------------- */
+
+typedef struct mpsc_cell {
+    /* pos when free for the producer claiming pos; pos + 1 once filled. */
+    _Atomic size_t seq;
+} mpsc_cell;
+
+struct mpsc_queue {
+    size_t item_size;
+    size_t mask;
+    mpsc_cell *cells;
+    unsigned char *items;
+    _Atomic size_t enqueue_pos;
+    size_t dequeue_pos; /* consumer only */
+    queue_parking parking;
+};
+
+mpsc_queue *mpsc_queue_create(size_t item_size, size_t capacity) {
+    mpsc_queue *queue;
+    size_t cap;
+    size_t i;
+
+    if (item_size == 0u || capacity == 0u) {
+        return NULL;
+    }
+    queue = calloc(1, sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    cap = queue_round_capacity(capacity);
+    queue->item_size = item_size;
+    queue->mask = cap - 1u;
+    queue->cells = malloc(cap * sizeof(*queue->cells));
+    queue->items = malloc(cap * item_size);
+    if (!queue_parking_init(&queue->parking) ||
+        queue->cells == NULL || queue->items == NULL) {
+        mpsc_queue_destroy(queue);
+        return NULL;
+    }
+    for (i = 0; i < cap; i++) {
+        atomic_init(&queue->cells[i].seq, i);
+    }
+    atomic_init(&queue->enqueue_pos, 0u);
+    return queue;
+}
+
+void mpsc_queue_destroy(mpsc_queue *queue) {
+    if (queue == NULL) {
+        return;
+    }
+    queue_parking_destroy(&queue->parking);
+    free(queue->items);
+    free(queue->cells);
+    free(queue);
+}
+
+bool mpsc_queue_push(mpsc_queue *queue, const void *item) {
+    size_t pos;
+    mpsc_cell *cell;
+
+    if (queue == NULL || item == NULL) {
+        return false;
+    }
+    pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        size_t seq;
+        intptr_t diff;
+
+        cell = &queue->cells[pos & queue->mask];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->enqueue_pos, &pos, pos + 1u,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; /* full: the consumer has not freed this cell */
+        } else {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+    memcpy(queue->items + (pos & queue->mask) * queue->item_size, item, queue->item_size);
+    atomic_store_explicit(&cell->seq, pos + 1u, memory_order_release);
+    queue_parking_notify(&queue->parking);
+    return true;
+}
+
+bool mpsc_queue_try_pop(mpsc_queue *queue, void *out_item) {
+    size_t pos;
+    mpsc_cell *cell;
+
+    if (queue == NULL || out_item == NULL) {
+        return false;
+    }
+    pos = queue->dequeue_pos;
+    cell = &queue->cells[pos & queue->mask];
+    /* Empty, or the producer that claimed this cell is still copying. */
+    if (atomic_load_explicit(&cell->seq, memory_order_acquire) != pos + 1u) {
+        return false;
+    }
+    memcpy(out_item, queue->items + (pos & queue->mask) * queue->item_size, queue->item_size);
+    atomic_store_explicit(&cell->seq, pos + queue->mask + 1u, memory_order_release);
+    queue->dequeue_pos = pos + 1u;
+    return true;
+}
+
+bool mpsc_queue_wait_pop_timeout(mpsc_queue *queue, void *out_item, uint32_t timeout_ms) {
+    uint32_t start;
+    uint32_t remaining;
+    bool popped;
+
+    if (mpsc_queue_try_pop(queue, out_item)) {
+        return true;
+    }
+    if (queue == NULL || out_item == NULL || timeout_ms == 0u) {
+        return false;
+    }
+    start = SDL_GetTicks();
+    atomic_store_explicit(&queue->parking.parked, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    for (;;) {
+        popped = mpsc_queue_try_pop(queue, out_item);
+        if (popped) {
+            break;
+        }
+        remaining = queue_wait_remaining(start, timeout_ms);
+        if (remaining == 0u) {
+            break;
+        }
+        (void)wake_event_wait(queue->parking.consumer, remaining);
+    }
+    atomic_store_explicit(&queue->parking.parked, 0, memory_order_relaxed);
+    return popped;
+}
+
+void mpsc_queue_set_wake_event(mpsc_queue *queue, wake_event *wake) {
+    if (queue != NULL) {
+        atomic_store_explicit(&queue->parking.listener, wake, memory_order_release);
+    }
+}
+
+/* ---- SPSC --------------------------------------------------------------- */
+
+struct spsc_queue {
+    size_t item_size;
+    size_t mask;
+    unsigned char *items;
+    _Atomic size_t head; /* next pop; written by the consumer */
+    _Atomic size_t tail; /* next push; written by the producer */
+    queue_parking parking;
+};
+
+spsc_queue *spsc_queue_create(size_t item_size, size_t capacity) {
+    spsc_queue *queue;
+    size_t cap;
+
+    if (item_size == 0u || capacity == 0u) {
+        return NULL;
+    }
+    queue = calloc(1, sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    cap = queue_round_capacity(capacity);
+    queue->item_size = item_size;
+    queue->mask = cap - 1u;
+    queue->items = malloc(cap * item_size);
+    if (!queue_parking_init(&queue->parking) || queue->items == NULL) {
+        spsc_queue_destroy(queue);
+        return NULL;
+    }
+    atomic_init(&queue->head, 0u);
+    atomic_init(&queue->tail, 0u);
+    return queue;
+}
+
+void spsc_queue_destroy(spsc_queue *queue) {
+    if (queue == NULL) {
+        return;
+    }
+    queue_parking_destroy(&queue->parking);
+    free(queue->items);
+    free(queue);
+}
+
+bool spsc_queue_push(spsc_queue *queue, const void *item) {
+    size_t tail;
+
+    if (queue == NULL || item == NULL) {
+        return false;
+    }
+    tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    if (tail - atomic_load_explicit(&queue->head, memory_order_acquire) > queue->mask) {
+        return false;
+    }
+    memcpy(queue->items + (tail & queue->mask) * queue->item_size, item, queue->item_size);
+    atomic_store_explicit(&queue->tail, tail + 1u, memory_order_release);
+    queue_parking_notify(&queue->parking);
+    return true;
+}
+
+bool spsc_queue_try_pop(spsc_queue *queue, void *out_item) {
+    size_t head;
+
+    if (queue == NULL || out_item == NULL) {
+        return false;
+    }
+    head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (head == atomic_load_explicit(&queue->tail, memory_order_acquire)) {
+        return false;
+    }
+    memcpy(out_item, queue->items + (head & queue->mask) * queue->item_size, queue->item_size);
+    atomic_store_explicit(&queue->head, head + 1u, memory_order_release);
+    return true;
+}
+
+bool spsc_queue_wait_pop_timeout(spsc_queue *queue, void *out_item, uint32_t timeout_ms) {
+    uint32_t start;
+    uint32_t remaining;
+    bool popped;
+
+    if (spsc_queue_try_pop(queue, out_item)) {
+        return true;
+    }
+    if (queue == NULL || out_item == NULL || timeout_ms == 0u) {
+        return false;
+    }
+    start = SDL_GetTicks();
+    atomic_store_explicit(&queue->parking.parked, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    for (;;) {
+        popped = spsc_queue_try_pop(queue, out_item);
+        if (popped) {
+            break;
+        }
+        remaining = queue_wait_remaining(start, timeout_ms);
+        if (remaining == 0u) {
+            break;
+        }
+        (void)wake_event_wait(queue->parking.consumer, remaining);
+    }
+    atomic_store_explicit(&queue->parking.parked, 0, memory_order_relaxed);
+    return popped;
+}
+
+void spsc_queue_set_wake_event(spsc_queue *queue, wake_event *wake) {
+    if (queue != NULL) {
+        atomic_store_explicit(&queue->parking.listener, wake, memory_order_release);
+    }
+}
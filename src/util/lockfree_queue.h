@@ -0,0 +1,43 @@
+#pragma once
+
+/* C99-compatible header. The structs are defined only in lockfree_queue.c
+   (C11 atomics); callers hold pointers.
+
+   Bounded lock-free queues of fixed-size items, the same shape as
+   message_queue but without its mutex:
+
+   - mpsc_queue: any number of producer threads, one consumer thread
+     (per-cell sequence numbers; a push claims a cell with one CAS).
+   - spsc_queue: one producer thread, one consumer thread (head/tail ring).
+
+   Capacity is rounded up to a power of two. Push never blocks and returns
+   false when full. Only the consumer may pop; wait_pop_timeout parks it on a
+   wake_event that producers signal only while the consumer is parked, so a
+   busy consumer costs producers no system call. It returns false only once
+   timeout_ms has passed with nothing to pop. A listener (set_wake_event) is
+   signalled on every push, but the wake_event coalesces: only the first push
+   after the listener last waited reaches the kernel. */
+
+#include "wake_event.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct mpsc_queue mpsc_queue;
+typedef struct spsc_queue spsc_queue;
+
+mpsc_queue *mpsc_queue_create(size_t item_size, size_t capacity);
+void mpsc_queue_destroy(mpsc_queue *queue);
+bool mpsc_queue_push(mpsc_queue *queue, const void *item);
+bool mpsc_queue_try_pop(mpsc_queue *queue, void *out_item);
+bool mpsc_queue_wait_pop_timeout(mpsc_queue *queue, void *out_item, uint32_t timeout_ms);
+/* Also signal wake after every successful push (NULL detaches). */
+void mpsc_queue_set_wake_event(mpsc_queue *queue, wake_event *wake);
+
+spsc_queue *spsc_queue_create(size_t item_size, size_t capacity);
+void spsc_queue_destroy(spsc_queue *queue);
+bool spsc_queue_push(spsc_queue *queue, const void *item);
+bool spsc_queue_try_pop(spsc_queue *queue, void *out_item);
+bool spsc_queue_wait_pop_timeout(spsc_queue *queue, void *out_item, uint32_t timeout_ms);
+void spsc_queue_set_wake_event(spsc_queue *queue, wake_event *wake);
@@ -16,6 +16,7 @@ struct message_queue {
     unsigned char *items;
     mutex *lock;
     cond *not_empty;
+    wake_event *wake;
 };
 
 static void message_queue_copy_out(message_queue *queue, void *out_item) {
@@ -64,6 +65,8 @@ void message_queue_destroy(message_queue *queue) {
 bool message_queue_push(
     message_queue *queue,
     const void *item) {
+    wake_event *wake;
+
     if (!queue || !item) {
         return false;
     }
@@ -79,7 +82,9 @@ bool message_queue_push(
     queue->count++;
     queue->woken = false;
     cond_signal(queue->not_empty);
+    wake = queue->wake;
     mutex_unlock(queue->lock);
+    wake_event_signal(wake);
     return true;
 }
 
@@ -160,3 +165,13 @@ void message_queue_wake_all(message_queue *queue) {
     cond_broadcast(queue->not_empty);
     mutex_unlock(queue->lock);
 }
+
+void message_queue_set_wake_event(message_queue *queue, wake_event *wake) {
+    if (!queue) {
+        return;
+    }
+
+    mutex_lock(queue->lock);
+    queue->wake = wake;
+    mutex_unlock(queue->lock);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "wake_event.h"
+
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -30,3 +32,7 @@ bool message_queue_wait_pop_timeout(
     uint32_t timeout_ms);
 
 void message_queue_wake_all(message_queue *queue);
+
+/* Signal wake after every successful push (NULL detaches). Lets one thread
+   block on several queues and other sources at once. */
+void message_queue_set_wake_event(message_queue *queue, wake_event *wake);
@@ -0,0 +1,27 @@
+#pragma once
+
+/* SHA-256 (FIPS 180-4) for content addressing: snapshot store objects and
+ * cache keys. Not constant-time; nothing here is secret. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum {
+    SHA256_DIGEST_SIZE = 32,
+    SHA256_HEX_SIZE = 65 /* 64 lowercase hex digits + NUL */
+};
+
+typedef struct sha256_ctx {
+    uint32_t state[8];
+    uint64_t length; /* bytes hashed so far */
+    uint8_t block[64];
+    size_t block_used;
+} sha256_ctx;
+
+void sha256_init(sha256_ctx *ctx);
+void sha256_update(sha256_ctx *ctx, const void *data, size_t size);
+void sha256_final(sha256_ctx *ctx, uint8_t out[SHA256_DIGEST_SIZE]);
+
+/* One-shot digest of data. */
+void sha256(const void *data, size_t size, uint8_t out[SHA256_DIGEST_SIZE]);
+void sha256_hex(const uint8_t digest[SHA256_DIGEST_SIZE], char out[SHA256_HEX_SIZE]);
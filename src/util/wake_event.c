@@ -0,0 +1,166 @@
+/* wake_event.c — compiled at C11 (see CMakeLists.txt per-file property).
+   The Linux path keeps an _Atomic pending flag next to the eventfd. */
+
+#include "wake_event.h"
+
+#include <stdlib.h>
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/* `pending` mirrors the eventfd counter: only the signal that raises it
+   writes, so producers hitting a waiter that has not drained yet (a busy
+   host loop, a queue listener) cost no system call. */
+struct wake_event {
+    int fd;
+    atomic_int pending;
+};
+
+wake_event *wake_event_create(void) {
+    wake_event *wake = calloc(1, sizeof(*wake));
+    if (!wake) {
+        return NULL;
+    }
+
+    wake->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake->fd < 0) {
+        free(wake);
+        return NULL;
+    }
+    atomic_init(&wake->pending, 0);
+
+    return wake;
+}
+
+void wake_event_destroy(wake_event *wake) {
+    if (!wake) {
+        return;
+    }
+
+    close(wake->fd);
+    free(wake);
+}
+
+void wake_event_signal(wake_event *wake) {
+    uint64_t one = 1u;
+    ssize_t wrote;
+
+    if (!wake) {
+        return;
+    }
+    if (atomic_exchange(&wake->pending, 1) != 0) {
+        return; /* already pending: the waiter has yet to drain */
+    }
+
+    /* EAGAIN means the counter is saturated, which is still pending. */
+    wrote = write(wake->fd, &one, sizeof(one));
+    (void)wrote;
+}
+
+bool wake_event_wait(wake_event *wake, uint32_t timeout_ms) {
+    struct pollfd pfd;
+    uint64_t count;
+    int ready;
+
+    if (!wake) {
+        return false;
+    }
+
+    pfd.fd = wake->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    do {
+        ready = poll(&pfd, 1, (int)(timeout_ms > 0x7FFFFFFFu ? 0x7FFFFFFFu : timeout_ms));
+    } while (ready < 0 && errno == EINTR);
+
+    if (ready <= 0) {
+        return false;
+    }
+
+    /* Clear before the read: a signal from here on writes again, and one
+       that saw pending set came before this wake, so the drain that follows
+       covers it. Reading resets the counter. */
+    atomic_store(&wake->pending, 0);
+    return read(wake->fd, &count, sizeof(count)) == (ssize_t)sizeof(count);
+}
+
+int wake_event_fd(const wake_event *wake) {
+    return wake != NULL ? wake->fd : -1;
+}
+
+#else
+
+#include "cond.h"
+#include "mutex.h"
+
+struct wake_event {
+    mutex *lock;
+    cond *signaled;
+    bool pending;
+};
+
+wake_event *wake_event_create(void) {
+    wake_event *wake = calloc(1, sizeof(*wake));
+    if (!wake) {
+        return NULL;
+    }
+
+    wake->lock = mutex_create();
+    wake->signaled = cond_create();
+    if (!wake->lock || !wake->signaled) {
+        wake_event_destroy(wake);
+        return NULL;
+    }
+
+    return wake;
+}
+
+void wake_event_destroy(wake_event *wake) {
+    if (!wake) {
+        return;
+    }
+
+    cond_destroy(wake->signaled);
+    mutex_destroy(wake->lock);
+    free(wake);
+}
+
+void wake_event_signal(wake_event *wake) {
+    if (!wake) {
+        return;
+    }
+
+    mutex_lock(wake->lock);
+    wake->pending = true;
+    cond_signal(wake->signaled);
+    mutex_unlock(wake->lock);
+}
+
+bool wake_event_wait(wake_event *wake, uint32_t timeout_ms) {
+    bool woken;
+
+    if (!wake) {
+        return false;
+    }
+
+    mutex_lock(wake->lock);
+    if (!wake->pending && timeout_ms > 0u) {
+        (void)cond_wait_timeout(wake->signaled, wake->lock, timeout_ms);
+    }
+    woken = wake->pending;
+    wake->pending = false;
+    mutex_unlock(wake->lock);
+    return woken;
+}
+
+int wake_event_fd(const wake_event *wake) {
+    (void)wake;
+    return -1;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Wakeup shared by any number of producers and one waiting thread.
+ *
+ * signal() marks the event pending from any thread; wait() blocks until it is
+ * pending (or the timeout passes) and clears it. Signals coalesce, so a waiter
+ * must drain every source it watches after waking. On Linux this is an
+ * eventfd polled with poll(); only the signal that makes it pending writes
+ * the fd, so repeated signals before the next wait() cost no system call.
+ * Elsewhere it is a mutex/cond pair. A caller that polls wake_event_fd must
+ * clear it with wait(wake, 0), never by reading the fd itself.
+ */
+
+typedef struct wake_event wake_event;
+
+wake_event *wake_event_create(void);
+void wake_event_destroy(wake_event *wake);
+
+void wake_event_signal(wake_event *wake);
+
+/* True when woken by a signal, false on timeout. timeout_ms 0 only polls. */
+bool wake_event_wait(wake_event *wake, uint32_t timeout_ms);
+
+/* Descriptor that polls readable while the event is pending, so it can be
+   waited on next to a socket; -1 where the fallback has none. */
+int wake_event_fd(const wake_event *wake);
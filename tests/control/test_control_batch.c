@@ -0,0 +1,108 @@
+#include "control_batch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        exit(1);
+    }
+}
+
+/* Parse "<id> batch <count> <bytes>" and attach body as its payload. */
+static bool parse_batch(
+    const char *body,
+    uint32_t count,
+    control_request *subs,
+    size_t *out_count,
+    control_response *error)
+{
+    control_request batch;
+    char line[64];
+    bool ok;
+
+    snprintf(line, sizeof(line), "9 batch %u %zu", count, strlen(body));
+    expect_true("batch header", control_protocol_parse_request(line, &batch, NULL));
+    expect_true("batch payload size", batch.payload_size == strlen(body));
+    batch.payload = (uint8_t *)malloc(batch.payload_size);
+    memcpy(batch.payload, body, batch.payload_size);
+    memset(error, 0, sizeof(*error));
+    ok = control_batch_parse(&batch, subs, CONTROL_BATCH_MAX, out_count, error);
+    control_request_release(&batch);
+    return ok;
+}
+
+int main(void)
+{
+    static control_request subs[CONTROL_BATCH_MAX];
+    control_request header;
+    control_response error;
+    control_response reply;
+    control_response combined;
+    control_batch *batch;
+    size_t count = 0;
+    size_t i;
+    const char *expected;
+
+    expect_true("count 0 rejected", !control_protocol_parse_request("1 batch 0 10", &header, NULL));
+    expect_true("count max rejected", !control_protocol_parse_request("1 batch 65 10", &header, NULL));
+    expect_true("bytes rejected", !control_protocol_parse_request("1 batch 2 0", &header, NULL));
+
+    /* set-memory carries its payload inline, as on the socket. */
+    expect_true(
+        "parse",
+        parse_batch("1 set-memory $300 2\n\xA9\x01\n2 set-reg pc $300\n3 get-cpu\n", 3u,
+                    subs, &count, &error));
+    expect_true("count", count == 3u);
+    expect_true("sub 1", subs[0].type == CONTROL_COMMAND_SET_MEMORY && subs[0].id == 1u);
+    expect_true("sub 1 payload", subs[0].payload_size == 2u && subs[0].payload[0] == 0xA9u &&
+                                 subs[0].payload[1] == 0x01u);
+    expect_true("sub 2", subs[1].type == CONTROL_COMMAND_SET_REG && subs[1].args.reg_value == 0x300u);
+    expect_true("sub 3", subs[2].type == CONTROL_COMMAND_GET_CPU && subs[2].id == 3u);
+    /* Only get-cpu can wait on the worker; pokes and set-reg answer at once. */
+    expect_true("deferrable", control_batch_deferrable_count(subs, count) == 1u);
+    for (i = 0; i < count; i++) {
+        control_request_release(&subs[i]);
+    }
+
+    expect_true("count mismatch", !parse_batch("1 get-cpu\n", 2u, subs, &count, &error));
+    expect_true("count mismatch code", strncmp(error.text, "bad-batch sub 2", 15) == 0);
+    expect_true("trailing", !parse_batch("1 get-cpu\n2 get-cpu\n", 1u, subs, &count, &error));
+    expect_true("bad sub", !parse_batch("1 get-cpu\n2 frob\n", 2u, subs, &count, &error));
+    expect_true("bad sub message", strstr(error.text, "unknown-command frob") != NULL);
+    expect_true("wait", !parse_batch("1 wait-paused\n", 1u, subs, &count, &error));
+    expect_true("nested", !parse_batch("1 batch 1 10\n", 1u, subs, &count, &error));
+    expect_true("duplicate", !parse_batch("1 get-cpu\n1 get-state\n", 2u, subs, &count, &error));
+    expect_true("short payload", !parse_batch("1 set-memory $300 4\nAB\n", 1u, subs, &count, &error));
+    expect_true("error id", error.id == 9u && error.type == CONTROL_RESPONSE_ERROR);
+
+    /* Replies land out of order; the combined payload keeps request order. */
+    batch = control_batch_create(9u, 1u, 3u);
+    expect_true("create", batch != NULL);
+    reply.payload = NULL;
+    control_protocol_format_data(&reply, 3u, "memory", "address=$0300", (uint8_t *)malloc(2), 2u);
+    reply.payload[0] = 'h';
+    reply.payload[1] = 'i';
+    expect_true("store 3", !control_batch_store(batch, 2u, &reply));
+    expect_true("payload moved", reply.payload == NULL);
+    control_protocol_format_error(&reply, 2u, "bad-args", "register", false);
+    expect_true("store 2", !control_batch_store(batch, 1u, &reply));
+    expect_true("not finished", !control_batch_finish(batch, &combined));
+    control_protocol_format_ok(&reply, 1u, "bytes=2");
+    expect_true("store 1 completes", control_batch_store(batch, 0u, &reply));
+    expect_true("finish", control_batch_finish(batch, &combined));
+    expected = "1 ok bytes=2\n2 error bad-args register\n3 data memory 2 address=$0300\nhi\n";
+    expect_true("combined id", combined.id == 9u && combined.type == CONTROL_RESPONSE_DATA);
+    expect_true("combined type", strcmp(combined.data_type, "batch") == 0);
+    expect_true("combined meta", strcmp(combined.metadata, "count=3") == 0);
+    expect_true("combined size", combined.payload_size == strlen(expected));
+    expect_true("combined bytes", memcmp(combined.payload, expected, strlen(expected)) == 0);
+    control_response_release(&combined);
+    control_batch_destroy(batch);
+
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "control_deferred.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        exit(1);
+    }
+}
+
+static deferred_control_response *reserve_for(
+    deferred_control_table *table,
+    uint32_t client,
+    uint32_t id,
+    control_deferred_kind kind)
+{
+    deferred_control_response *d = control_deferred_reserve(table, client, NULL);
+    if (d != NULL) {
+        d->active = true;
+        d->request_id = id;
+        d->kind = kind;
+    }
+    return d;
+}
+
+static deferred_control_response *reserve(
+    deferred_control_table *table,
+    uint32_t id,
+    control_deferred_kind kind)
+{
+    return reserve_for(table, 0u, id, kind);
+}
+
+int main(void)
+{
+    deferred_control_table table;
+    deferred_control_response *pending[CONTROL_DEFERRED_TABLE_SIZE];
+    deferred_control_response *a;
+    deferred_control_response *b;
+    deferred_control_response *c;
+    const char *busy = NULL;
+    uint32_t i;
+    size_t n;
+
+    memset(&table, 0, sizeof(table));
+    expect_true("empty", control_deferred_active(&table) == NULL);
+
+    /* Default limit applies to a zeroed table. */
+    for (i = 0; i < CONTROL_DEFERRED_DEFAULT_LIMIT; i++) {
+        expect_true("reserve to default", reserve(&table, i + 1u, CONTROL_DEFERRED_GET_CPU) != NULL);
+    }
+    expect_true("default limit", control_deferred_reserve(&table, 0u, &busy) == NULL);
+    expect_true("busy message", busy != NULL && strcmp(busy, "deferred-table-full") == 0);
+    expect_true("count", control_deferred_count(&table) == CONTROL_DEFERRED_DEFAULT_LIMIT);
+    for (i = 0; i < CONTROL_DEFERRED_TABLE_SIZE; i++) {
+        control_deferred_clear(&table.entries[i]);
+    }
+
+    /* Slots free out of order; collect still walks oldest first. */
+    control_deferred_set_limit(&table, 3u);
+    a = reserve(&table, 10u, CONTROL_DEFERRED_WAIT_FRAME);
+    b = reserve(&table, 11u, CONTROL_DEFERRED_GET_MEMORY);
+    c = reserve(&table, 12u, CONTROL_DEFERRED_GET_SOFTSWITCHES);
+    expect_true("three", a != NULL && b != NULL && c != NULL);
+    expect_true("limit 3", control_deferred_reserve(&table, 0u, NULL) == NULL);
+    control_deferred_clear(a);
+    a = reserve(&table, 13u, CONTROL_DEFERRED_WAIT_PAUSED);
+    expect_true("reuse freed slot", a != NULL);
+    n = control_deferred_collect(&table, pending, CONTROL_DEFERRED_CAPACITY);
+    expect_true("collect count", n == 3u);
+    expect_true("order 0", pending[0]->request_id == 11u);
+    expect_true("order 1", pending[1]->request_id == 12u);
+    expect_true("order 2", pending[2]->request_id == 13u);
+    expect_true("active is oldest", control_deferred_active(&table)->request_id == 11u);
+    expect_true("collect max", control_deferred_collect(&table, pending, 1u) == 1u);
+
+    /* The limit is per client; collect interleaves clients by age. */
+    b = reserve_for(&table, 1u, 20u, CONTROL_DEFERRED_GET_CPU);
+    c = reserve_for(&table, 2u, 30u, CONTROL_DEFERRED_GET_CPU);
+    expect_true("other clients", b != NULL && c != NULL && b->client == 1u && c->client == 2u);
+    expect_true("client count", control_deferred_client_count(&table, 0u) == 3u);
+    expect_true("client 0 still full", control_deferred_reserve(&table, 0u, NULL) == NULL);
+    n = control_deferred_collect(&table, pending, CONTROL_DEFERRED_TABLE_SIZE);
+    expect_true("collect all clients", n == 5u);
+    expect_true("order by age", pending[2]->request_id == 13u && pending[3]->request_id == 20u &&
+        pending[4]->request_id == 30u);
+
+    expect_true("wait kind", control_deferred_kind_is_wait(CONTROL_DEFERRED_WAIT_FRAME));
+    expect_true("response kind", !control_deferred_kind_is_wait(CONTROL_DEFERRED_GET_MEMORY));
+
+    control_deferred_set_limit(&table, 1000u);
+    expect_true("clamped limit", table.limit == CONTROL_DEFERRED_CAPACITY);
+
+    printf("ok\n");
+    return 0;
+}
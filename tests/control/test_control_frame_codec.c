@@ -0,0 +1,187 @@
+#include "control_frame_codec.h"
+#include "display_frame.h"
+#include "stb_image.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        exit(1);
+    }
+}
+
+enum { PIXELS = DISPLAY_FRAME_WIDTH * DISPLAY_FRAME_HEIGHT };
+
+/* Text-screen-like frame: black with a few glyph-ish stripes. */
+static void fill_frame(uint8_t *indices, uint32_t seed)
+{
+    size_t i;
+
+    memset(indices, 0, PIXELS);
+    for (i = 0; i < PIXELS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if ((i / DISPLAY_FRAME_WIDTH) % 8u < 7u && (seed >> 28) == 0u) {
+            indices[i] = (uint8_t)(15u - (i % 3u));
+        }
+    }
+}
+
+static void roundtrip(const char *name, const uint8_t *src, const uint8_t *base, size_t size, size_t unit)
+{
+    size_t cap = control_frame_rle_bound(size, unit);
+    uint8_t *encoded = (uint8_t *)malloc(cap);
+    uint8_t *decoded = (uint8_t *)malloc(size);
+    size_t n;
+
+    expect_true(name, encoded != NULL && decoded != NULL);
+    n = control_frame_rle_encode(src, base, size, unit, encoded, cap);
+    expect_true(name, n > 0u && n <= cap);
+    if (base != NULL) {
+        memcpy(decoded, base, size);
+    }
+    expect_true(name, control_frame_rle_decode(encoded, n, unit, decoded, size, base != NULL));
+    expect_true(name, memcmp(decoded, src, size) == 0);
+    free(encoded);
+    free(decoded);
+}
+
+int main(void)
+{
+    static uint8_t frame[PIXELS];
+    static uint8_t next[PIXELS];
+    static uint32_t argb[PIXELS];
+    static uint32_t argb_next[PIXELS];
+    uint32_t palette[DISPLAY_FRAME_PALETTE_SIZE];
+    uint8_t scratch[64];
+    size_t i;
+
+    for (i = 0; i < DISPLAY_FRAME_PALETTE_SIZE; i++) {
+        palette[i] = 0xFF000000u | (uint32_t)(i * 0x110F07u);
+    }
+    fill_frame(frame, 1u);
+    memcpy(next, frame, PIXELS);
+    memset(next + DISPLAY_FRAME_WIDTH * 40u, 9, 300u); /* one changed stripe */
+    for (i = 0; i < PIXELS; i++) {
+        argb[i] = palette[frame[i]];
+        argb_next[i] = palette[next[i]];
+    }
+
+    /* rle / delta, one byte and one ARGB pixel per unit. */
+    roundtrip("rle indexed", frame, NULL, PIXELS, 1u);
+    roundtrip("rle argb", (const uint8_t *)argb, NULL, sizeof(argb), 4u);
+    roundtrip("delta indexed", next, frame, PIXELS, 1u);
+    roundtrip("delta argb", (const uint8_t *)argb_next, (const uint8_t *)argb, sizeof(argb), 4u);
+    {
+        uint8_t odd[7] = { 1, 2, 3, 3, 3, 3, 3 };
+        roundtrip("rle short", odd, NULL, sizeof(odd), 1u);
+        roundtrip("rle single", odd, NULL, 1u, 1u);
+    }
+    {
+        size_t cap = control_frame_rle_bound(sizeof(argb), 4u);
+        uint8_t *encoded = (uint8_t *)malloc(cap);
+        size_t n = control_frame_rle_encode(
+            (const uint8_t *)argb_next, (const uint8_t *)argb, sizeof(argb), 4u, encoded, cap);
+        expect_true("delta is small", n > 0u && n < sizeof(argb) / 50u);
+        expect_true("rle overflow reports 0",
+                    control_frame_rle_encode(frame, NULL, PIXELS, 1u, scratch, sizeof(scratch)) == 0u);
+        expect_true("unit must divide size",
+                    control_frame_rle_encode(frame, NULL, 7u, 4u, encoded, cap) == 0u);
+        expect_true("truncated stream rejected",
+                    !control_frame_rle_decode(encoded, n - 1u, 4u, (uint8_t *)argb_next,
+                                              sizeof(argb), true));
+        free(encoded);
+    }
+    {
+        /* Stream longer than the destination. */
+        uint8_t run[2] = { (uint8_t)(((10u - 1u) << 1) | 1u), 7u };
+        expect_true("overlong run rejected", !control_frame_rle_decode(run, 2u, 1u, scratch, 4u, false));
+        expect_true("short stream rejected", !control_frame_rle_decode(run, 2u, 1u, scratch, 16u, false));
+        expect_true("exact run", control_frame_rle_decode(run, 2u, 1u, scratch, 10u, false) &&
+                                 scratch[0] == 7u && scratch[9] == 7u);
+    }
+
+    /* png decodes (stb_image) to the palette colours of every pixel. */
+    {
+        uint8_t *png = NULL;
+        size_t png_size = 0;
+        int w = 0;
+        int h = 0;
+        int comp = 0;
+        unsigned char *rgb;
+
+        expect_true("png encode",
+                    control_frame_png_encode(frame, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT,
+                                             palette, DISPLAY_FRAME_PALETTE_SIZE, &png, &png_size));
+        expect_true("png much smaller", png_size < PIXELS / 4u);
+        rgb = stbi_load_from_memory(png, (int)png_size, &w, &h, &comp, 3);
+        expect_true("png decodes", rgb != NULL);
+        expect_true("png size", w == DISPLAY_FRAME_WIDTH && h == DISPLAY_FRAME_HEIGHT);
+        for (i = 0; i < PIXELS; i++) {
+            uint32_t c = palette[frame[i]];
+            if (rgb[i * 3u] != (uint8_t)(c >> 16) || rgb[i * 3u + 1u] != (uint8_t)(c >> 8) ||
+                rgb[i * 3u + 2u] != (uint8_t)c) {
+                expect_true("png pixel", 0);
+            }
+        }
+        stbi_image_free(rgb);
+        free(png);
+
+        /* 8-bit depth path (palette over 16 entries), odd width. */
+        {
+            static uint32_t big_palette[256];
+            uint8_t tiny[5 * 3] = { 0, 17, 200, 255, 3, 4, 4, 4, 4, 4, 99, 1, 2, 3, 250 };
+            for (i = 0; i < 256u; i++) {
+                big_palette[i] = 0xFF000000u | (uint32_t)(i * 0x010203u);
+            }
+            expect_true("png 8-bit encode",
+                        control_frame_png_encode(tiny, 5u, 3u, big_palette, 256u, &png, &png_size));
+            rgb = stbi_load_from_memory(png, (int)png_size, &w, &h, &comp, 3);
+            expect_true("png 8-bit decodes", rgb != NULL && w == 5 && h == 3);
+            for (i = 0; i < sizeof(tiny); i++) {
+                expect_true("png 8-bit pixel", rgb[i * 3u + 2u] == (uint8_t)big_palette[tiny[i]]);
+            }
+            stbi_image_free(rgb);
+            free(png);
+        }
+        expect_true("png rejects empty palette",
+                    !control_frame_png_encode(frame, 4u, 4u, palette, 0u, &png, &png_size));
+    }
+
+    /* cache: keeps the newest CONTROL_FRAME_CACHE_ENTRIES frames by number. */
+    {
+        control_frame_cache *cache = control_frame_cache_create();
+        const uint8_t *found = NULL;
+        const uint32_t *found_palette = NULL;
+        uint64_t n;
+
+        expect_true("cache create", cache != NULL);
+        expect_true("cache empty", !control_frame_cache_find(cache, 1u, PIXELS, &found, &found_palette));
+        for (n = 1; n <= CONTROL_FRAME_CACHE_ENTRIES + 1u; n++) {
+            frame[0] = (uint8_t)n;
+            control_frame_cache_store(cache, n, frame, palette, PIXELS);
+        }
+        expect_true("cache evicts oldest", !control_frame_cache_find(cache, 1u, PIXELS, &found, &found_palette));
+        expect_true("cache finds newest",
+                    control_frame_cache_find(cache, CONTROL_FRAME_CACHE_ENTRIES + 1u, PIXELS,
+                                             &found, &found_palette) &&
+                    found[0] == (uint8_t)(CONTROL_FRAME_CACHE_ENTRIES + 1u) &&
+                    found_palette[15] == palette[15]);
+        expect_true("cache size must match",
+                    !control_frame_cache_find(cache, 2u, PIXELS - 1u, &found, &found_palette));
+        frame[0] = 0xEEu;
+        control_frame_cache_store(cache, 3u, frame, palette, PIXELS);
+        expect_true("cache replaces same number",
+                    control_frame_cache_find(cache, 3u, PIXELS, &found, &found_palette) &&
+                    found[0] == 0xEEu);
+        expect_true("cache keeps others after replace",
+                    control_frame_cache_find(cache, 2u, PIXELS, &found, &found_palette));
+        control_frame_cache_destroy(cache);
+    }
+
+    printf("ok\n");
+    return 0;
+}
@@ -119,6 +119,42 @@ int main(void)
         "get-frame",
         control_protocol_parse_request("19 get-frame", &request, &error));
     expect_int("get-frame type", CONTROL_COMMAND_GET_FRAME, (int)request.type);
+    expect_int("get-frame default format", CONTROL_FRAME_FORMAT_ARGB8888,
+               (int)request.args.frame_format);
+
+    expect_true(
+        "get-frame indexed",
+        control_protocol_parse_request("19 get-frame format=indexed8", &request, &error));
+    expect_int("get-frame indexed format", CONTROL_FRAME_FORMAT_INDEXED8,
+               (int)request.args.frame_format);
+    expect_true(
+        "get-frame bad format",
+        !control_protocol_parse_request("19 get-frame format=rgb565", &request, &error));
+    expect_true(
+        "get-frame rle",
+        control_protocol_parse_request("19 get-frame encoding=rle format=indexed8", &request, &error));
+    expect_int("get-frame rle encoding", CONTROL_FRAME_ENCODING_RLE,
+               (int)request.args.frame_encoding);
+    expect_int("get-frame rle format", CONTROL_FRAME_FORMAT_INDEXED8,
+               (int)request.args.frame_format);
+    expect_true(
+        "get-frame delta",
+        control_protocol_parse_request("19 get-frame encoding=delta base=1234", &request, &error));
+    expect_int("get-frame delta encoding", CONTROL_FRAME_ENCODING_DELTA,
+               (int)request.args.frame_encoding);
+    expect_true("get-frame delta base", request.args.frame_delta_base == 1234ull);
+    expect_true(
+        "get-frame delta needs base",
+        !control_protocol_parse_request("19 get-frame encoding=delta", &request, &error));
+    expect_true(
+        "get-frame base needs delta",
+        !control_protocol_parse_request("19 get-frame encoding=png base=3", &request, &error));
+    expect_true(
+        "get-frame bad encoding",
+        !control_protocol_parse_request("19 get-frame encoding=zip", &request, &error));
+    expect_true(
+        "get-frame bad base",
+        !control_protocol_parse_request("19 get-frame encoding=delta base=x", &request, &error));
 
     expect_true(
         "step-over",
@@ -165,6 +201,13 @@ int main(void)
         strcmp(
             line,
             "0 event state-changed reason=step session=2 cycles=12345 frame=1 epoch=1\n") == 0);
+    expect_true("plain event no payload", !control_response_has_payload(&response));
+    control_protocol_format_event_data(&response, "memory", "sub=2 mask=5", NULL, 7u);
+    expect_true("push payload", control_response_has_payload(&response));
+    expect_true(
+        "fmt push",
+        control_protocol_write_response_line(line, sizeof(line), &response));
+    expect_true("push line", strcmp(line, "0 event memory 7 sub=2 mask=5\n") == 0);
     expect_true(
         "break-create",
         control_protocol_parse_request(
@@ -187,6 +230,59 @@ int main(void)
     expect_true("target frame", request.args.frame_ring_target == 42ull);
     expect_true("by frame", !request.args.frame_ring_by_cycle);
 
+    expect_true(
+        "get-frame-at indexed",
+        control_protocol_parse_request(
+            "23 get-frame-at format=indexed8 cycle=$1F00", &request, &error));
+    expect_true("target cycle", request.args.frame_ring_target == 0x1F00ull);
+    expect_true("by cycle", request.args.frame_ring_by_cycle);
+    expect_int("get-frame-at format", CONTROL_FRAME_FORMAT_INDEXED8,
+               (int)request.args.frame_format);
+    expect_true(
+        "get-frame-at needs target",
+        !control_protocol_parse_request("23 get-frame-at format=indexed8", &request, &error));
+    expect_true(
+        "get-frame-at delta",
+        control_protocol_parse_request(
+            "23 get-frame-at frame=42 encoding=delta base=41", &request, &error));
+    expect_true("get-frame-at delta target", request.args.frame_ring_target == 42ull);
+    expect_true("get-frame-at delta base", request.args.frame_delta_base == 41ull);
+    expect_true(
+        "get-frame-at png",
+        control_protocol_parse_request("23 get-frame-at encoding=png cycle=9", &request, &error));
+    expect_int("get-frame-at png encoding", CONTROL_FRAME_ENCODING_PNG,
+               (int)request.args.frame_encoding);
+
+    expect_true(
+        "get-frame-strip",
+        control_protocol_parse_request(
+            "23 get-frame-strip cycle=100 to=900 count=8 scale=16 format=indexed8",
+            &request, &error));
+    expect_int("get-frame-strip type", CONTROL_COMMAND_GET_FRAME_STRIP, (int)request.type);
+    expect_true("strip first", request.args.frame_ring_target == 100ull);
+    expect_true("strip last", request.args.frame_ring_target_end == 900ull);
+    expect_true("strip by cycle", request.args.frame_ring_by_cycle);
+    expect_u32("strip count", 8, request.args.frame_strip_count);
+    expect_u32("strip scale", 16, request.args.frame_strip_scale);
+    expect_int("strip format", CONTROL_FRAME_FORMAT_INDEXED8, (int)request.args.frame_format);
+    expect_true(
+        "get-frame-strip default scale",
+        control_protocol_parse_request(
+            "23 get-frame-strip frame=1 to=2 count=2", &request, &error));
+    expect_u32("strip default scale", 4, request.args.frame_strip_scale);
+    expect_true(
+        "get-frame-strip bad scale",
+        !control_protocol_parse_request(
+            "23 get-frame-strip frame=1 to=2 count=2 scale=8", &request, &error));
+    expect_true(
+        "get-frame-strip count range",
+        !control_protocol_parse_request(
+            "23 get-frame-strip frame=1 to=2 count=65", &request, &error));
+    expect_true(
+        "get-frame-strip reversed",
+        !control_protocol_parse_request(
+            "23 get-frame-strip frame=9 to=2 count=2", &request, &error));
+
     expect_true(
         "frame-ring-record",
         control_protocol_parse_request("24 frame-ring-record off", &request, &error));
@@ -393,6 +489,300 @@ int main(void)
         control_protocol_write_response_line(line, sizeof(line), &response));
     expect_true("err busy", strstr(line, "error busy") != NULL);
 
+    expect_true(
+        "hello binary",
+        control_protocol_parse_request("80 hello binary=1", &request, &error));
+    expect_true("hello framing set", request.args.framing_set);
+    expect_true("hello framing binary", request.args.framing_binary);
+    expect_true(
+        "hello binary bad",
+        !control_protocol_parse_request("81 hello binary=2", &request, &error));
+
+    expect_true(
+        "get-memory-multi",
+        control_protocol_parse_request(
+            "82 get-memory-multi $0:256 $400:1024:aux $FFF0:32:rom", &request, &error));
+    expect_u32("multi spans", 3, request.args.span_count);
+    expect_u32("multi total", 256 + 1024 + 32, request.args.length);
+    expect_u32("multi span1 addr", 0x400, request.args.spans[1].address);
+    expect_u32("multi span1 mode", CONTROL_MEMORY_MODE_AUX, request.args.spans[1].mode);
+    expect_u32("multi span2 mode", CONTROL_MEMORY_MODE_ROM, request.args.spans[2].mode);
+    expect_u32("multi get no payload", 0, (uint32_t)request.payload_size);
+    expect_true(
+        "set-memory-multi",
+        control_protocol_parse_request("83 set-memory-multi $300:2000 $0:2:main", &request, &error));
+    expect_u32("multi set payload", 2002, (uint32_t)request.payload_size);
+    expect_true(
+        "multi empty",
+        !control_protocol_parse_request("84 get-memory-multi", &request, &error));
+    expect_true(
+        "multi zero length",
+        !control_protocol_parse_request("85 get-memory-multi $300:0", &request, &error));
+    expect_true(
+        "multi bad mode",
+        !control_protocol_parse_request("86 get-memory-multi $300:4:ram2", &request, &error));
+    expect_true(
+        "multi missing length",
+        !control_protocol_parse_request("87 get-memory-multi $300", &request, &error));
+
+    expect_true(
+        "subscribe frames",
+        control_protocol_parse_request(
+            "88 subscribe frames every=2 encoding=png", &request, &error));
+    expect_int("subscribe type", CONTROL_COMMAND_SUBSCRIBE, (int)request.type);
+    expect_u32("subscribe kind", CONTROL_SUBSCRIPTION_FRAMES, request.args.subscription_kind);
+    expect_u32("subscribe every", 2, request.args.subscription_every);
+    expect_u32("subscribe encoding", CONTROL_FRAME_ENCODING_PNG, request.args.frame_encoding);
+    expect_true(
+        "subscribe memory",
+        control_protocol_parse_request(
+            "89 subscribe memory ranges=$400:40,$800:40:aux on=change", &request, &error));
+    expect_u32("subscribe memory kind", CONTROL_SUBSCRIPTION_MEMORY, request.args.subscription_kind);
+    expect_u32("subscribe memory spans", 2, request.args.span_count);
+    expect_u32("subscribe memory mode", CONTROL_MEMORY_MODE_AUX, request.args.spans[1].mode);
+    expect_true("subscribe on change", !request.args.subscription_on_frame);
+    expect_true(
+        "subscribe delta base",
+        !control_protocol_parse_request(
+            "90 subscribe frames encoding=delta base=3", &request, &error));
+    expect_true(
+        "subscribe every zero",
+        !control_protocol_parse_request("90 subscribe frames every=0", &request, &error));
+    expect_true(
+        "subscribe no ranges",
+        !control_protocol_parse_request("90 subscribe memory on=frame", &request, &error));
+    expect_true(
+        "subscribe bad on",
+        !control_protocol_parse_request(
+            "90 subscribe memory ranges=$0:1 on=fr", &request, &error));
+    expect_true(
+        "subscribe kind",
+        !control_protocol_parse_request("90 subscribe screen", &request, &error));
+    expect_true(
+        "unsubscribe all",
+        control_protocol_parse_request("91 unsubscribe all", &request, &error));
+    expect_u32("unsubscribe all id", 0, request.args.subscription_id);
+    expect_true(
+        "unsubscribe id",
+        control_protocol_parse_request("92 unsubscribe 3", &request, &error) &&
+            request.args.subscription_id == 3u);
+    expect_true(
+        "unsubscribe zero",
+        !control_protocol_parse_request("93 unsubscribe 0", &request, &error));
+    expect_true(
+        "shm-info",
+        control_protocol_parse_request("94 shm-info", &request, &error) &&
+            request.type == CONTROL_COMMAND_SHM_INFO);
+    expect_true(
+        "get-text",
+        control_protocol_parse_request("95 get-text", &request, &error) &&
+            request.type == CONTROL_COMMAND_GET_TEXT);
+    expect_true(
+        "wait-text pattern keeps spaces",
+        control_protocol_parse_request("96 wait-text pattern=^PRESS [A-Z]+ KEY", &request, &error) &&
+            request.type == CONTROL_COMMAND_WAIT_TEXT &&
+            strcmp(request.args.text_pattern, "^PRESS [A-Z]+ KEY") == 0 &&
+            request.args.timeout_ms == 2000u);
+    expect_true(
+        "wait-text timeout",
+        control_protocol_parse_request("97 wait-text timeout=30000 pattern=READY", &request, &error) &&
+            request.args.timeout_ms == 30000u &&
+            strcmp(request.args.text_pattern, "READY") == 0);
+    expect_true(
+        "wait-text needs pattern",
+        !control_protocol_parse_request("98 wait-text timeout=500", &request, &error) &&
+            strstr(error.text, "bad-args") != NULL);
+    expect_true(
+        "wait-text empty pattern",
+        !control_protocol_parse_request("99 wait-text pattern=", &request, &error));
+    expect_true(
+        "text pattern valid",
+        control_protocol_text_pattern_valid("^PRESS [A-Z]+ KEY") &&
+            control_protocol_text_pattern_valid("^\\]$") &&
+            control_protocol_text_pattern_valid("[^\\]]x.*"));
+    expect_true(
+        "text pattern malformed",
+        !control_protocol_text_pattern_valid("[abc") &&
+            !control_protocol_text_pattern_valid("READY\\") &&
+            !control_protocol_text_pattern_valid("*READY") &&
+            !control_protocol_text_pattern_valid("^+x") &&
+            !control_protocol_text_pattern_valid("a**") &&
+            !control_protocol_text_pattern_valid(
+                "[0123456789012345678901234567890123456789012345678901234567890123]"));
+    {
+        char many[80];
+        memset(many, 'x', 64u);
+        many[64] = '\0';
+        expect_true("text pattern atoms", !control_protocol_text_pattern_valid(many));
+        many[63] = '\0';
+        expect_true("text pattern atoms max", control_protocol_text_pattern_valid(many));
+    }
+    expect_true(
+        "rewind default",
+        control_protocol_parse_request("100 rewind", &request, &error) &&
+            request.type == CONTROL_COMMAND_REWIND && request.args.rewind_frames == 60u);
+    expect_true(
+        "rewind frames",
+        control_protocol_parse_request("101 rewind frames=180", &request, &error) &&
+            request.args.rewind_frames == 180u);
+    expect_true(
+        "rewind zero",
+        !control_protocol_parse_request("102 rewind frames=0", &request, &error) &&
+            strstr(error.text, "bad-args") != NULL);
+    expect_true(
+        "rewind junk",
+        !control_protocol_parse_request("103 rewind 5", &request, &error));
+    expect_true(
+        "step-back",
+        control_protocol_parse_request("104 step-back", &request, &error) &&
+            request.type == CONTROL_COMMAND_STEP_BACK);
+    expect_true(
+        "reverse-continue",
+        control_protocol_parse_request("105 reverse-continue", &request, &error) &&
+            request.type == CONTROL_COMMAND_REVERSE_CONTINUE);
+    expect_true(
+        "run-to-cycle",
+        control_protocol_parse_request("106 run-to-cycle cycle=0x12345", &request, &error) &&
+            request.type == CONTROL_COMMAND_RUN_TO_CYCLE &&
+            request.args.seek_cycle == 0x12345ull);
+    expect_true(
+        "run-to-cycle missing",
+        !control_protocol_parse_request("107 run-to-cycle", &request, &error) &&
+            strstr(error.text, "cycle=<n>") != NULL);
+
+    {
+        static const uint8_t header_bytes[CONTROL_BINARY_REQUEST_HEADER_SIZE] = {
+            0x78, 0x56, 0x34, 0x12, CONTROL_COMMAND_GET_MEMORY, 0, 0, 0,
+            8, 0, 0, 0, 0, 0, 0, 0
+        };
+        static const uint8_t memory_args[CONTROL_BINARY_MEMORY_ARGS_SIZE] = {
+            0x00, 0x03, CONTROL_MEMORY_MODE_AUX, 0, 16, 0, 0, 0
+        };
+        static const uint8_t text_args[] = { '$', '3', '0', '0', ' ', '4' };
+        control_binary_header header;
+        uint8_t reply[CONTROL_BINARY_REPLY_MAX];
+        uint8_t bytes[4] = { 1, 2, 3, 4 };
+        size_t used = 0;
+
+        control_protocol_decode_binary_header(header_bytes, &header);
+        expect_u32("bin id", 0x12345678u, header.id);
+        expect_u32("bin opcode", CONTROL_COMMAND_GET_MEMORY, header.opcode);
+        expect_u32("bin args size", 8, header.args_size);
+        expect_u32("bin payload size", 0, header.payload_size);
+
+        expect_true(
+            "bin get-memory",
+            control_protocol_parse_binary_request(&header, memory_args, &request, &error));
+        expect_u32("bin addr", 0x300, request.args.address);
+        expect_u32("bin len", 16, request.args.length);
+        expect_u32("bin mode", CONTROL_MEMORY_MODE_AUX, request.args.memory_mode);
+
+        header.args_size = 4;
+        expect_true(
+            "bin get-memory short args",
+            !control_protocol_parse_binary_request(&header, memory_args, &request, &error));
+        expect_true("bin short args error", strstr(error.text, "memory args") != NULL);
+
+        header.opcode = CONTROL_COMMAND_SET_MEMORY;
+        header.args_size = CONTROL_BINARY_MEMORY_ARGS_SIZE;
+        header.payload_size = 8;
+        expect_true(
+            "bin set-memory size mismatch",
+            !control_protocol_parse_binary_request(&header, memory_args, &request, &error));
+        expect_true("bin mismatch error", strstr(error.text, "bad-payload") != NULL);
+        header.payload_size = 16;
+        expect_true(
+            "bin set-memory",
+            control_protocol_parse_binary_request(&header, memory_args, &request, &error));
+        expect_u32("bin set payload", 16, (uint32_t)request.payload_size);
+
+        header.opcode = CONTROL_COMMAND_GET_MEMORY;
+        header.flags = CONTROL_BINARY_FLAG_TEXT_ARGS;
+        header.args_size = sizeof(text_args);
+        header.payload_size = 0;
+        expect_true(
+            "bin text args",
+            control_protocol_parse_binary_request(&header, text_args, &request, &error));
+        expect_u32("bin text addr", 0x300, request.args.address);
+        expect_u32("bin text len", 4, request.args.length);
+
+        {
+            static const uint8_t span_args[2 * CONTROL_BINARY_MEMORY_ARGS_SIZE] = {
+                0x00, 0x00, CONTROL_MEMORY_MODE_MAIN, 0, 0x00, 0x01, 0, 0,
+                0x00, 0x04, CONTROL_MEMORY_MODE_AUX, 0, 0x10, 0, 0, 0
+            };
+            header.opcode = CONTROL_COMMAND_SET_MEMORY_MULTI;
+            header.flags = 0;
+            header.args_size = sizeof(span_args);
+            header.payload_size = 0x110;
+            expect_true(
+                "bin set-memory-multi",
+                control_protocol_parse_binary_request(&header, span_args, &request, &error));
+            expect_u32("bin multi spans", 2, request.args.span_count);
+            expect_u32("bin multi span0 len", 0x100, request.args.spans[0].length);
+            expect_u32("bin multi span1 addr", 0x400, request.args.spans[1].address);
+            header.args_size = 12;
+            expect_true(
+                "bin multi ragged args",
+                !control_protocol_parse_binary_request(&header, span_args, &request, &error));
+            header.payload_size = 0;
+        }
+
+        {
+            static const uint8_t frame_args[10] = {
+                CONTROL_FRAME_FORMAT_INDEXED8, CONTROL_FRAME_ENCODING_DELTA,
+                0x10, 0x27, 0, 0, 1, 0, 0, 0
+            };
+            header.opcode = CONTROL_COMMAND_GET_FRAME;
+            header.flags = 0;
+            header.args_size = sizeof(frame_args);
+            expect_true(
+                "bin get-frame delta",
+                control_protocol_parse_binary_request(&header, frame_args, &request, &error));
+            expect_int("bin frame encoding", CONTROL_FRAME_ENCODING_DELTA,
+                       (int)request.args.frame_encoding);
+            expect_true("bin frame base", request.args.frame_delta_base == 0x100002710ull);
+            header.args_size = 2;
+            expect_true(
+                "bin delta needs base",
+                !control_protocol_parse_binary_request(&header, frame_args, &request, &error));
+        }
+
+        header.opcode = CONTROL_COMMAND_GET_CPU;
+        header.flags = 0;
+        header.args_size = 0;
+        expect_true(
+            "bin get-cpu",
+            control_protocol_parse_binary_request(&header, NULL, &request, &error));
+        expect_int("bin get-cpu type", CONTROL_COMMAND_GET_CPU, (int)request.type);
+
+        header.opcode = 0xFFFFu;
+        expect_true(
+            "bin unknown opcode",
+            !control_protocol_parse_binary_request(&header, NULL, &request, &error));
+        expect_true("bin unknown error", strstr(error.text, "unknown-command") != NULL);
+
+        control_protocol_format_data(&response, 7, "memory", "address=$0300", bytes, 4);
+        expect_true(
+            "bin write data",
+            control_protocol_write_binary_response(reply, sizeof(reply), &response, &used));
+        expect_u32("bin reply used", CONTROL_BINARY_REPLY_HEADER_SIZE + 20u, (uint32_t)used);
+        expect_u32("bin reply id", 7, reply[0]);
+        expect_u32("bin reply kind", CONTROL_RESPONSE_DATA, reply[4]);
+        expect_u32("bin reply text size", 20, reply[6]);
+        expect_u32("bin reply payload size", 4, reply[8]);
+        expect_true(
+            "bin reply text",
+            memcmp(reply + CONTROL_BINARY_REPLY_HEADER_SIZE, "memory address=$0300", 20) == 0);
+
+        control_protocol_format_error(&response, 9, "busy", "deferred", true);
+        expect_true(
+            "bin write error",
+            control_protocol_write_binary_response(reply, sizeof(reply), &response, &used));
+        expect_u32("bin error kind", CONTROL_RESPONSE_ERROR, reply[4]);
+        expect_u32("bin error close", CONTROL_BINARY_FLAG_CLOSE, reply[5]);
+    }
+
     printf("ok\n");
     return 0;
 }
@@ -0,0 +1,91 @@
+#include "control_subscription.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        exit(1);
+    }
+}
+
+static control_subscription *subscribe(control_subscription_table *table, const char *line)
+{
+    control_request request;
+
+    expect_true(line, control_protocol_parse_request(line, &request, NULL));
+    expect_true("subscribe verb", request.type == CONTROL_COMMAND_SUBSCRIBE);
+    return control_subscription_add(table, &request.args);
+}
+
+int main(void)
+{
+    control_subscription_table table;
+    control_subscription *frames;
+    control_subscription *watch;
+    uint8_t current[6] = { 1, 2, 3, 4, 5, 6 };
+    uint8_t *payload = NULL;
+    size_t size = 0;
+    uint64_t mask = 0;
+    int i;
+
+    memset(&table, 0, sizeof(table));
+
+    /* Frames: every Nth frame from the first one sent. */
+    frames = subscribe(&table, "1 subscribe frames every=3 encoding=delta format=indexed8");
+    expect_true("frames add", frames != NULL && frames->id == 1u);
+    expect_true("frames every", frames->every == 3u);
+    expect_true("frames format", frames->format == CONTROL_FRAME_FORMAT_INDEXED8);
+    expect_true("frames encoding", frames->encoding == CONTROL_FRAME_ENCODING_DELTA);
+    expect_true("first frame due", control_subscription_frame_due(frames, 10u));
+    control_subscription_frame_sent(frames, 10u);
+    expect_true("not yet due", !control_subscription_frame_due(frames, 12u));
+    expect_true("due again", control_subscription_frame_due(frames, 13u));
+    expect_true("frame number went back", control_subscription_frame_due(frames, 2u));
+
+    /* Memory: first diff is every range; then only ranges that changed. */
+    watch = subscribe(&table, "2 subscribe memory on=frame ranges=$300:2,$400:3:aux,$C000:1 mode=main");
+    expect_true("memory add", watch != NULL && watch->id == 2u);
+    expect_true("memory spans", watch->span_count == 3u && watch->total == 6u);
+    expect_true("memory default mode", watch->spans[0].mode == CONTROL_MEMORY_MODE_MAIN);
+    expect_true("memory span mode", watch->spans[1].mode == CONTROL_MEMORY_MODE_AUX);
+    expect_true("memory on", watch->on_frame);
+    expect_true(
+        "first diff",
+        control_subscription_memory_diff(watch, current, &mask, &payload, &size));
+    expect_true("first diff all", mask == 7u && size == 6u && memcmp(payload, current, 6) == 0);
+    free(payload);
+    control_subscription_memory_sent(watch, current);
+    expect_true(
+        "no change",
+        !control_subscription_memory_diff(watch, current, &mask, &payload, &size));
+    current[3] = 0x44;
+    expect_true(
+        "one range changed",
+        control_subscription_memory_diff(watch, current, &mask, &payload, &size));
+    expect_true("changed range only", mask == 2u && size == 3u);
+    expect_true("changed bytes", payload[0] == 3 && payload[1] == 0x44 && payload[2] == 5);
+    free(payload);
+    /* Not marked sent (push refused): the next diff still reports it. */
+    expect_true(
+        "unsent change kept",
+        control_subscription_memory_diff(watch, current, &mask, &payload, &size) && mask == 2u);
+    free(payload);
+
+    /* Table limits and removal. */
+    for (i = 2; i < CONTROL_SUBSCRIPTIONS_MAX; i++) {
+        expect_true("fill", subscribe(&table, "3 subscribe frames") != NULL);
+    }
+    expect_true("full", subscribe(&table, "4 subscribe frames") == NULL);
+    expect_true("remove one", control_subscription_remove(&table, 2u));
+    expect_true("remove unknown", !control_subscription_remove(&table, 2u));
+    expect_true("slot reused", subscribe(&table, "5 subscribe frames") != NULL);
+    control_subscription_clear(&table);
+    expect_true("cleared", !control_subscription_any(&table));
+
+    printf("ok\n");
+    return 0;
+}
@@ -19,6 +19,113 @@ static void expect_true(const char *name, int v)
     }
 }
 
+/* Dirty-page checkpoints: small deltas, exact restore, trimming. */
+static void test_checkpoints(void)
+{
+    apple2_t m;
+    apple2_checkpoint_chain *chain;
+    apple2_checkpoint_info info;
+    uint16_t pc_at_1;
+    uint64_t cycles_at_1;
+    uint16_t pc_after;
+    uint64_t cycles_after;
+    uint8_t before_2000;
+    int i;
+
+    expect_true("cp init", apple2_init(&m));
+    chain = apple2_checkpoint_chain_create();
+    expect_true("cp create", chain != NULL);
+    for (i = 0; i < 2000; i++) {
+        (void)apple2_step_instruction(&m);
+    }
+    expect_true("cp take 0", apple2_checkpoint_take(chain, &m));
+    expect_true("cp0 info", apple2_checkpoint_get_info(chain, 0, &info));
+    expect_true("cp0 no pages", info.page_count == 0u);
+
+    apple2_debug_write(&m, 0x0400, 0xC1);
+    for (i = 0; i < 200; i++) {
+        (void)apple2_step_instruction(&m);
+    }
+    expect_true("cp take 1", apple2_checkpoint_take(chain, &m));
+    expect_true("cp1 info", apple2_checkpoint_get_info(chain, 1, &info));
+    expect_true("cp1 few pages", info.page_count >= 1u && info.page_count < 16u);
+    expect_true("cp1 small", info.bytes < 16u * 1024u);
+    pc_at_1 = m.cpu.cpu.pc;
+    cycles_at_1 = m.cpu.cpu.cycles;
+    for (i = 0; i < 500; i++) {
+        (void)apple2_step_instruction(&m);
+    }
+    pc_after = m.cpu.cpu.pc;
+    cycles_after = m.cpu.cpu.cycles;
+
+    /* Scribble, then restore: RAM, CPU and the run that follows match. */
+    before_2000 = apple2_debug_read(&m, 0x2000);
+    apple2_debug_write(&m, 0x0400, 0x11);
+    apple2_debug_write(&m, 0x2000, (uint8_t)(before_2000 ^ 0xFFu));
+    expect_true("cp take 2", apple2_checkpoint_take(chain, &m));
+    /* restore_keep leaves the newer checkpoints restorable. */
+    expect_true("cp keep 1", apple2_checkpoint_restore_keep(chain, &m, 1));
+    expect_true("cp keep count", apple2_checkpoint_count(chain) == 3u);
+    expect_true("cp keep ram", apple2_debug_read(&m, 0x0400) == 0xC1);
+    expect_true("cp keep 2", apple2_checkpoint_restore_keep(chain, &m, 2));
+    expect_true("cp keep 2 ram", apple2_debug_read(&m, 0x0400) == 0x11);
+    expect_true("cp restore 1", apple2_checkpoint_restore(chain, &m, 1));
+    expect_true("cp restore drops newer", apple2_checkpoint_count(chain) == 2u);
+    expect_true("cp ram", apple2_debug_read(&m, 0x0400) == 0xC1);
+    expect_true("cp ram 2000", apple2_debug_read(&m, 0x2000) == before_2000);
+    expect_true("cp pc", m.cpu.cpu.pc == pc_at_1 && m.cpu.cpu.cycles == cycles_at_1);
+    for (i = 0; i < 500; i++) {
+        (void)apple2_step_instruction(&m);
+    }
+    expect_true("cp replay", m.cpu.cpu.pc == pc_after && m.cpu.cpu.cycles == cycles_after);
+
+    /* Trimming folds the oldest into the base; restore still exact. */
+    apple2_checkpoint_drop_oldest(chain);
+    expect_true("cp drop", apple2_checkpoint_count(chain) == 1u);
+    apple2_debug_write(&m, 0x0400, 0x22);
+    expect_true("cp restore after drop", apple2_checkpoint_restore(chain, &m, 0));
+    expect_true("cp ram after drop", apple2_debug_read(&m, 0x0400) == 0xC1);
+    expect_true("cp pc after drop", m.cpu.cpu.cycles == cycles_at_1);
+
+    /* Bulk edits bypass the dirty bits: the next take stores every page. */
+    apple2_cold_reset(&m);
+    expect_true("cp take after cold", apple2_checkpoint_take(chain, &m));
+    expect_true("cp full info", apple2_checkpoint_get_info(chain, 1, &info));
+    expect_true("cp full pages", info.page_count == APPLE2_RAM_PAGES);
+    expect_true("cp bytes", apple2_checkpoint_bytes(chain) >= APPLE2_RAM_PAGES * APPLE2_PAGE_SIZE);
+
+    /* A long chain stores all of RAM every 32nd take; restores still see
+       each page as its latest checkpoint left it. */
+    for (i = 2; i < 40; i++) {
+        apple2_debug_write(&m, 0x0400, (uint8_t)i);
+        apple2_debug_write(&m, (uint16_t)(0x3000 + i * 0x100), (uint8_t)i);
+        expect_true("cp take long", apple2_checkpoint_take(chain, &m));
+    }
+    for (i = 2; i < 40; i++) {
+        expect_true("cp long info", apple2_checkpoint_get_info(chain, (size_t)i, &info));
+        expect_true("cp long full every 32",
+                    (info.page_count == APPLE2_RAM_PAGES) == (i == 33));
+    }
+    expect_true("cp keep 38", apple2_checkpoint_restore_keep(chain, &m, 38));
+    expect_true("cp 38 latest", apple2_debug_read(&m, 0x0400) == 38u);
+    expect_true("cp 38 old page", apple2_debug_read(&m, 0x3500) == 5u);
+    expect_true("cp 38 new page", apple2_debug_read(&m, 0x3000 + 38 * 0x100) == 38u);
+    expect_true("cp keep 20", apple2_checkpoint_restore_keep(chain, &m, 20));
+    expect_true("cp 20 latest", apple2_debug_read(&m, 0x0400) == 20u);
+    expect_true("cp 20 later page", apple2_debug_read(&m, 0x3000 + 30 * 0x100) == 0u);
+
+    /* A refused restore leaves the machine as it was. */
+    expect_true("cp attach", apple2_attach_mockingboard(&m, 5));
+    apple2_debug_write(&m, 0x0400, 0x77);
+    cycles_after = m.cpu.cpu.cycles;
+    expect_true("cp refuse", !apple2_checkpoint_restore_keep(chain, &m, 20));
+    expect_true("cp refuse ram", apple2_debug_read(&m, 0x0400) == 0x77);
+    expect_true("cp refuse cpu", m.cpu.cpu.cycles == cycles_after);
+
+    apple2_checkpoint_chain_destroy(chain);
+    apple2_shutdown(&m);
+}
+
 int main(void)
 {
     apple2_t m;
@@ -96,6 +203,7 @@ int main(void)
     free(buf);
     apple2_shutdown(&m);
     apple2_shutdown(&m2);
+    test_checkpoints();
     printf("ok\n");
     return 0;
 }
@@ -79,6 +79,106 @@ int main(void)
         apple2_read_in_view(&m, vf, 0xC600),
         m.rom_c000[0x0600]);
 
+    /* Page spans match per-byte view reads for every area and page. */
+    {
+        static const runtime_view_area areas[] = {
+            RUNTIME_VIEW_AREA_MAP, RUNTIME_VIEW_AREA_MAIN, RUNTIME_VIEW_AREA_AUX,
+            RUNTIME_VIEW_AREA_LC1, RUNTIME_VIEW_AREA_LC2, RUNTIME_VIEW_AREA_ROM
+        };
+        uint8_t span[APPLE2_PAGE_SIZE];
+        size_t k;
+        uint32_t page;
+        uint32_t i;
+
+        for (k = 0; k < sizeof(areas) / sizeof(areas[0]); k++) {
+            vf = view_flags_from_area(areas[k]);
+            for (page = 0; page < APPLE2_NUM_PAGES; page++) {
+                apple2_copy_page_in_view(&m, vf, (uint8_t)page, span);
+                for (i = 0; i < APPLE2_PAGE_SIZE; i++) {
+                    uint16_t addr = (uint16_t)(page * APPLE2_PAGE_SIZE + i);
+                    if (span[i] != apple2_read_in_view(&m, vf, addr)) {
+                        fprintf(stderr, "FAIL: span area %d addr %04X\n", (int)areas[k], addr);
+                        exit(1);
+                    }
+                }
+            }
+        }
+    }
+
+    /* Unaligned spans (one wraps at $FFFF) match per-byte reads and writes. */
+    {
+        static const runtime_view_area areas[] = {
+            RUNTIME_VIEW_AREA_MAP, RUNTIME_VIEW_AREA_MAIN, RUNTIME_VIEW_AREA_AUX,
+            RUNTIME_VIEW_AREA_LC1, RUNTIME_VIEW_AREA_LC2, RUNTIME_VIEW_AREA_ROM
+        };
+        static const uint16_t starts[] = { 0x0000, 0x03F7, 0xBFF0, 0xCFF8, 0xFFF0 };
+        static uint8_t span[0x1200];
+        static uint8_t pattern[0x1200];
+        size_t k;
+        size_t s;
+        uint32_t i;
+
+        for (i = 0; i < sizeof(pattern); i++) {
+            pattern[i] = (uint8_t)(i * 7u + 3u);
+        }
+        for (k = 0; k < sizeof(areas) / sizeof(areas[0]); k++) {
+            vf = view_flags_from_area(areas[k]);
+            for (s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+                uint16_t start = starts[s];
+                uint32_t gen = m.page_write_gen[(uint8_t)((start + 0x100u) >> 8)];
+
+                apple2_copy_in_view(&m, vf, start, span, sizeof(span));
+                for (i = 0; i < sizeof(span); i++) {
+                    uint16_t addr = (uint16_t)(start + i);
+                    if (span[i] != apple2_read_in_view(&m, vf, addr)) {
+                        fprintf(stderr, "FAIL: copy area %d addr %04X\n", (int)areas[k], addr);
+                        exit(1);
+                    }
+                }
+                if (start == 0xBFF0 || start == 0xCFF8) {
+                    continue; /* leave I/O and slot pages alone */
+                }
+                apple2_store_in_view(&m, vf, start, pattern, 0x300u);
+                for (i = 0; i < 0x300u; i++) {
+                    uint16_t addr = (uint16_t)(start + i);
+                    uint8_t got = apple2_read_in_view(&m, vf, addr);
+                    if (areas[k] == RUNTIME_VIEW_AREA_ROM && addr >= 0xD000u) {
+                        if (got == pattern[i] && got != span[i]) {
+                            fprintf(stderr, "FAIL: store hit ROM %04X\n", addr);
+                            exit(1);
+                        }
+                    } else if (areas[k] != RUNTIME_VIEW_AREA_MAP &&
+                               (addr < 0xC000u || areas[k] == RUNTIME_VIEW_AREA_LC1 ||
+                                areas[k] == RUNTIME_VIEW_AREA_LC2) &&
+                               got != pattern[i]) {
+                        fprintf(stderr, "FAIL: store area %d addr %04X\n", (int)areas[k], addr);
+                        exit(1);
+                    }
+                }
+                if (m.page_write_gen[(uint8_t)((start + 0x100u) >> 8)] == gen) {
+                    fail("store page generation");
+                }
+            }
+        }
+    }
+
+    /* Write paths tick the page generation; bulk replacement ticks the epoch. */
+    {
+        uint32_t gen = m.page_write_gen[0x09];
+        uint32_t other = m.page_write_gen[0x0A];
+        uint32_t epoch = m.memory_epoch;
+
+        apple2_write_in_view(&m, view_flags_from_area(RUNTIME_VIEW_AREA_AUX), 0x0901, 0x55);
+        apple2_debug_write(&m, 0x0902, 0x66);
+        if (m.page_write_gen[0x09] != gen + 2u || m.page_write_gen[0x0A] != other) {
+            fail("page write generation");
+        }
+        apple2_cold_reset(&m);
+        if (m.memory_epoch == epoch) {
+            fail("cold reset epoch");
+        }
+    }
+
     /* Area cycle //e includes Aux. */
     {
         runtime_view_area a = RUNTIME_VIEW_AREA_MAP;
@@ -124,6 +124,70 @@ static void test_floating_bus_varies(void)
     apple2_shutdown(&m);
 }
 
+/* Scanner address table: every visible cell of each layout/page reads the
+   interleaved address; blanking keeps the latch. */
+static void expect_scan(apple2_t *m, const char *name, uint32_t flags,
+                        uint32_t bank, uint16_t page_base, int hgr, int mixed)
+{
+    uint16_t line;
+    uint16_t h;
+
+    m->state_flags = (m->state_flags &
+                      ~(A2S_TEXT | A2S_MIXED | A2S_HIRES | A2S_COL80 |
+                        A2S_PAGE2 | A2S_80STORE)) | flags;
+    for (line = 0; line < APPLE2_VIDEO_VISIBLE_LINES; line++) {
+        for (h = 0; h < APPLE2_VIDEO_H_VISIBLE_CYCLES; h++) {
+            uint32_t addr;
+            if (hgr && !(mixed && line >= 160u)) {
+                addr = bank + page_base * 8u +
+                       apple2_video_hgr_line_offset((uint8_t)line) + h;
+            } else {
+                addr = bank + page_base +
+                       apple2_video_text_line_base((uint8_t)(line / 8u)) + h;
+            }
+            m->ram_main[addr] = (uint8_t)(line ^ (h * 7u) ^ 0x5Au);
+            m->video.line = line;
+            m->video.cycle_in_line = h;
+            if (apple2_video_floating_bus(m) != m->ram_main[addr]) {
+                fprintf(stderr, "FAIL: %s: line %u h %u\n", name,
+                        (unsigned)line, (unsigned)h);
+                exit(1);
+            }
+        }
+    }
+    m->video.line = 0;
+    m->video.cycle_in_line = 39;
+    (void)apple2_video_floating_bus(m);
+    m->video.line = 230;
+    m->video.cycle_in_line = 10;
+    expect_u32(name, m->video.last_video_byte, apple2_video_floating_bus(m));
+}
+
+static void test_scanner_address_layouts(void)
+{
+    apple2_t m;
+
+    if (!apple2_init(&m)) {
+        fail("init");
+    }
+
+    expect_scan(&m, "scan text p1", A2S_TEXT, 0u, 0x0400u, 0, 0);
+    expect_scan(&m, "scan text p2", A2S_TEXT | A2S_PAGE2, 0u, 0x0800u, 0, 0);
+    expect_scan(&m, "scan text 80store aux", A2S_TEXT | A2S_PAGE2 | A2S_80STORE,
+                0x10000u, 0x0400u, 0, 0);
+    expect_scan(&m, "scan lores mixed", A2S_MIXED, 0u, 0x0400u, 0, 0);
+    expect_scan(&m, "scan hgr p1", A2S_HIRES, 0u, 0x0400u, 1, 0);
+    expect_scan(&m, "scan hgr p2", A2S_HIRES | A2S_PAGE2, 0u, 0x0800u, 1, 0);
+    expect_scan(&m, "scan hgr mixed p2", A2S_HIRES | A2S_MIXED | A2S_PAGE2,
+                0u, 0x0800u, 1, 1);
+    expect_scan(&m, "scan hgr 80store aux", A2S_HIRES | A2S_PAGE2 | A2S_80STORE,
+                0x10000u, 0x0400u, 1, 0);
+    expect_scan(&m, "scan dhgr text layout", A2S_HIRES | A2S_COL80,
+                0u, 0x0400u, 0, 0);
+
+    apple2_shutdown(&m);
+}
+
 static void test_midframe_page_flip(void)
 {
     apple2_t m;
@@ -431,10 +495,9 @@ static void test_dlores_page2_and_block_parity(void)
     expect_u32("dlores page2 main", EXPECT_LORES[15], fb[7]);
     beam_pix = fb[0];
 
-    memset(m.video.fb, 0,
-           (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT *
-               sizeof(uint32_t));
+    memset(m.video.fb, 0, (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT);
     apple2_video_paint_full_frame(&m);
+    fb = apple2_video_framebuffer(&m);
     expect_u32("dlores block matches beam", beam_pix, fb[0]);
     expect_u32("dlores block page2 main", EXPECT_LORES[15], fb[7]);
 
@@ -654,11 +717,81 @@ static void test_dhgr_nonblack(void)
     apple2_shutdown(&m);
 }
 
+static void test_capture_beam_splits(void)
+{
+    apple2_t m;
+    apple2_video_capture *cap;
+    uint8_t *render;
+    uint8_t *scratch;
+    size_t pixels = (size_t)APPLE2_VIDEO_WIDTH * (size_t)APPLE2_VIDEO_HEIGHT;
+    uint32_t i;
+
+    if (!apple2_init(&m)) {
+        fail("init");
+    }
+    cap = (apple2_video_capture *)malloc(sizeof(*cap));
+    render = (uint8_t *)malloc(pixels);
+    scratch = (uint8_t *)calloc(APPLE2_VIDEO_RENDER_SCRATCH_BYTES, 1u);
+    if (cap == NULL || render == NULL || scratch == NULL) {
+        fail("alloc");
+    }
+    /* Off by default: the beam keeps no splits. */
+    softswitch_c0_write(&m, 0xC050, 0);
+    for (i = 0; i < 2u * APPLE2_VIDEO_CYCLES_PER_LINE * APPLE2_VIDEO_LINES_PER_FRAME; i++) {
+        apple2_video_step(&m);
+        if (i == 1000u) {
+            softswitch_c0_write(&m, 0xC051, 0);
+        }
+    }
+    expect_u32("no splits recorded", 0u, m.video.split_count);
+    m.video.record_splits = true;
+    for (i = 0; i < 0x400u; i++) {
+        m.ram_main[0x400u + i] = (uint8_t)(0xC1u + (i % 26u));
+    }
+    softswitch_c0_write(&m, 0xC051, 0); /* text */
+    softswitch_c0_write(&m, 0xC054, 0); /* page 1 */
+    apple2_video_reset(&m);
+
+    /* Text to line 70 col 20, then GR mid-line, back to text at line 150. */
+    while (!(m.video.line == 70u && m.video.cycle_in_line == 20u)) {
+        apple2_video_step(&m);
+    }
+    softswitch_c0_write(&m, 0xC050, 0);
+    while (m.video.line != 150u) {
+        apple2_video_step(&m);
+    }
+    softswitch_c0_write(&m, 0xC051, 0);
+    while (m.video.line != 0u) {
+        apple2_video_step(&m);
+    }
+
+    apple2_video_capture_frame(&m, true, cap);
+    expect_u32("split count", 2u, cap->split_count);
+    expect_u32("split position", 70u * APPLE2_VIDEO_CYCLES_PER_LINE + 20u,
+               cap->splits[0].position);
+    expect_true("start flags text", (cap->start_flags & A2S_TEXT) != 0u);
+    expect_true("render ok", apple2_video_render_capture(
+                                 cap, m.rom_char, m.rom_char_size,
+                                 m.model == APPLE2_MODEL_II_PLUS, scratch, render));
+    expect_true("render matches beam",
+                memcmp(render, apple2_video_indexed_framebuffer(&m), pixels) == 0);
+
+    /* Without splits the whole frame uses the current (text) flags. */
+    apple2_video_capture_frame(&m, false, cap);
+    expect_u32("no splits", 0u, cap->split_count);
+
+    free(scratch);
+    free(render);
+    free(cap);
+    apple2_shutdown(&m);
+}
+
 int main(void)
 {
     test_timing_constants();
     test_vbl_window();
     test_floating_bus_varies();
+    test_scanner_address_layouts();
     test_midframe_page_flip();
     test_frame_paint_boot();
     test_lores_palette_cells();
@@ -669,6 +802,7 @@ int main(void)
     test_hgr_color_bits();
     test_text80_interleave();
     test_dhgr_nonblack();
+    test_capture_beam_splits();
     printf("video_beam: all tests passed\n");
     return 0;
 }
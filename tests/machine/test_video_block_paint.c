@@ -53,6 +53,7 @@ int main(void)
         m.ram_main[0x0400u + apple2_video_text_line_base(0) + 0] = 0xC1u;
     }
     apple2_video_paint_full_frame(&m);
+    fb = apple2_video_framebuffer(&m);
     nonblack = count_nonblack(fb, pixels);
     expect_true("text40 nonblack", nonblack > 0);
 
@@ -73,12 +74,14 @@ int main(void)
         m.ram_main[0x0800u] = 0xA0u;
         apple2_video_set_display_override(&m, true, A2S_TEXT | A2S_PAGE2);
         apple2_video_paint_full_frame(&m);
+        fb = apple2_video_framebuffer(&m);
         expect_true("override page2 blank", count_nonblack(fb, pixels) == 0);
         expect_true("override preserves actual flags", m.state_flags == actual_flags);
         actual_bus = apple2_video_floating_bus(&m);
         expect_true("override preserves actual scanner", actual_bus == 0xC1u);
         apple2_video_set_display_override(&m, false, 0u);
         apple2_video_paint_full_frame(&m);
+        fb = apple2_video_framebuffer(&m);
         expect_true("override off restores actual page", count_nonblack(fb, pixels) > 0);
     }
 
@@ -90,6 +93,7 @@ int main(void)
         m.ram_main[0x2000u + line_off + (uint16_t)col] = 0x7Fu; /* all dots on */
     }
     apple2_video_paint_full_frame(&m);
+    fb = apple2_video_framebuffer(&m);
     nonblack = count_nonblack(fb, pixels);
     expect_true("hgr nonblack", nonblack > 100);
 
@@ -98,6 +102,7 @@ int main(void)
     m.state_flags = 0; /* GR */
     m.ram_main[0x0400u + apple2_video_text_line_base(0) + 0] = 0xFFu; /* white cell */
     apple2_video_paint_full_frame(&m);
+    fb = apple2_video_framebuffer(&m);
     nonblack = count_nonblack(fb, pixels);
     expect_true("lores nonblack", nonblack > 0);
     /* Top of cell (line 0) should be white (nibble 0xF). */
@@ -113,11 +118,51 @@ int main(void)
     m.ram_main[0x10400u + apple2_video_text_line_base(0) + 0] = 0x01u;
     m.ram_main[0x0400u + apple2_video_text_line_base(0) + 0] = 0x0Fu;
     apple2_video_paint_full_frame(&m);
+    fb = apple2_video_framebuffer(&m);
     nonblack = count_nonblack(fb, pixels);
     expect_true("dlores nonblack", nonblack > 0);
     expect_true("dlores aux mapped", fb[0] == 0xFF2A2AE5u);
     expect_true("dlores aux 7px", fb[6] == 0xFF2A2AE5u);
     expect_true("dlores main white", fb[7] == 0xFFFFFFFFu);
+    /* Painters write palette indices; ARGB is a palette expansion. */
+    expect_true("indexed main white", apple2_video_indexed_framebuffer(&m)[7] == 15u);
+    expect_true("indexed aux dark blue", apple2_video_indexed_framebuffer(&m)[0] == 2u);
+    expect_true("palette white", apple2_video_palette()[15] == 0xFFFFFFFFu);
+
+    /* Capture + re-render reproduces the block paint in every mode. */
+    {
+        static const uint32_t modes[] = {
+            A2S_TEXT, A2S_TEXT | A2S_COL80 | A2S_80STORE, 0u, A2S_MIXED | A2S_PAGE2,
+            A2S_COL80, A2S_HIRES, A2S_HIRES | A2S_MIXED, A2S_HIRES | A2S_PAGE2,
+            A2S_HIRES | A2S_DHIRES | A2S_COL80, A2S_TEXT | A2S_ALTCHARSET
+        };
+        apple2_video_capture *cap = (apple2_video_capture *)malloc(sizeof(*cap));
+        uint8_t *render = (uint8_t *)malloc(pixels);
+        uint8_t *scratch = (uint8_t *)calloc(APPLE2_VIDEO_RENDER_SCRATCH_BYTES, 1u);
+        size_t k;
+        uint32_t seed = 0x1234567u;
+        expect_true("capture alloc", cap != NULL && render != NULL && scratch != NULL);
+        for (k = 0x400u; k < 0x6000u; k++) {
+            seed = seed * 1103515245u + 12345u;
+            m.ram_main[k] = (uint8_t)(seed >> 16);
+            m.ram_main[0x10000u + k] = (uint8_t)(seed >> 24);
+        }
+        for (k = 0; k < sizeof(modes) / sizeof(modes[0]); k++) {
+            m.state_flags = modes[k];
+            apple2_video_paint_full_frame(&m);
+            apple2_video_capture_frame(&m, false, cap);
+            expect_true("capture no splits", cap->split_count == 0u);
+            expect_true("capture render ok",
+                        apple2_video_render_capture(cap, m.rom_char, m.rom_char_size,
+                                                    m.model == APPLE2_MODEL_II_PLUS,
+                                                    scratch, render));
+            expect_true("capture render matches paint",
+                        memcmp(render, apple2_video_indexed_framebuffer(&m), pixels) == 0);
+        }
+        free(scratch);
+        free(render);
+        free(cap);
+    }
 
     /* Beam position unchanged by block paint. */
     m.video.line = 50;
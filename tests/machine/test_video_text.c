@@ -0,0 +1,109 @@
+#include "apple2.h"
+#include "video.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        exit(1);
+    }
+}
+
+static void expect_row(const char *name, const apple2_video_text *text, int row, const char *want)
+{
+    if (strcmp(text->rows[row], want) != 0) {
+        fprintf(stderr, "FAIL: %s: row %d is \"%s\", want \"%s\"\n",
+                name, row, text->rows[row], want);
+        exit(1);
+    }
+}
+
+/* text_ram offsets: main page 1 at 0, main page 2 at $400, aux page 1 at $800. */
+static void put(uint8_t *ram, uint32_t page, int row, int col, const uint8_t *codes, int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        ram[page + apple2_video_text_line_base((uint8_t)row) + (uint32_t)col + (uint32_t)i] =
+            codes[i];
+    }
+}
+
+static void blank(uint8_t *ram)
+{
+    memset(ram, 0xA0, APPLE2_VIDEO_TEXT_RAM_BYTES);
+}
+
+int main(void)
+{
+    static const uint8_t ready[] = { 0xD2, 0xC5, 0xC1, 0xC4, 0xD9 };     /* READY */
+    static const uint8_t lower[] = { 0xE1, 0xE2, 0xA1 };                 /* ab! */
+    static const uint8_t inverse[] = { 0x01, 0x02, 0x20, 0x31 };         /* AB 1 */
+    static const uint8_t flash[] = { 0x41, 0x42, 0x60 };                 /* AB  */
+    static const uint8_t page2[] = { 0xD0, 0xB2 };                       /* P2 */
+    static const uint8_t aux[] = { 0xC1, 0xD8 };                         /* AX */
+    uint8_t ram[APPLE2_VIDEO_TEXT_RAM_BYTES];
+    apple2_video_text text;
+
+    /* 40 columns, page 1; rows are trimmed, the interleave is undone. */
+    blank(ram);
+    put(ram, 0x000u, 0, 0, ready, 5);
+    put(ram, 0x000u, 9, 3, lower, 3);
+    put(ram, 0x000u, 23, 39, ready, 1);
+    apple2_video_decode_text(A2S_TEXT, false, ram, &text);
+    expect_true("text40 columns", text.columns == 40u);
+    expect_true("text40 first row", text.first_row == 0u);
+    expect_row("text40", &text, 0, "READY");
+    expect_row("text40 lower", &text, 9, "   ab!");
+    expect_row("text40 blank", &text, 1, "");
+    expect_true("text40 last column", strlen(text.rows[23]) == 40u && text.rows[23][39] == 'R');
+
+    /* ][+ has no lowercase glyphs: $E0..$FF show as $A0..$BF. */
+    apple2_video_decode_text(A2S_TEXT, true, ram, &text);
+    expect_row("ii+ lower", &text, 9, "   !\"!");
+
+    /* Inverse and flashing characters read as their normal form; with
+       ALTCHARSET $60..$7F are inverse lowercase instead of flashing. */
+    blank(ram);
+    put(ram, 0x000u, 2, 0, inverse, 4);
+    put(ram, 0x000u, 3, 0, flash, 3);
+    apple2_video_decode_text(A2S_TEXT, false, ram, &text);
+    expect_row("inverse", &text, 2, "AB 1");
+    expect_row("flash", &text, 3, "AB");
+    apple2_video_decode_text(A2S_TEXT | A2S_ALTCHARSET, false, ram, &text);
+    expect_row("altchar", &text, 3, "AB`");
+
+    /* PAGE2 shows $800 unless 80STORE redirects it to aux $400. */
+    blank(ram);
+    put(ram, 0x400u, 0, 0, page2, 2);
+    put(ram, 0x800u, 0, 0, aux, 2);
+    apple2_video_decode_text(A2S_TEXT | A2S_PAGE2, false, ram, &text);
+    expect_row("page2", &text, 0, "P2");
+    apple2_video_decode_text(A2S_TEXT | A2S_PAGE2 | A2S_80STORE, false, ram, &text);
+    expect_row("80store page2", &text, 0, "AX");
+
+    /* 80 columns: aux then main per scanner column, always page 1. */
+    blank(ram);
+    put(ram, 0x800u, 0, 0, ready, 3);      /* R E A into even columns */
+    put(ram, 0x000u, 0, 0, ready + 3, 2);  /* D Y into odd columns */
+    apple2_video_decode_text(A2S_TEXT | A2S_COL80 | A2S_PAGE2, false, ram, &text);
+    expect_true("text80 columns", text.columns == 80u);
+    expect_row("text80", &text, 0, "RDEYA");
+
+    /* Graphics rows are empty: all of them, or rows 0..19 in MIXED. */
+    put(ram, 0x000u, 21, 0, ready, 5);
+    apple2_video_decode_text(A2S_MIXED, false, ram, &text);
+    expect_true("mixed first row", text.first_row == 20u);
+    expect_row("mixed graphics", &text, 0, "");
+    expect_row("mixed text", &text, 21, "READY");
+    apple2_video_decode_text(A2S_HIRES, false, ram, &text);
+    expect_true("graphics first row", text.first_row == APPLE2_VIDEO_TEXT_ROWS);
+    expect_row("graphics", &text, 21, "");
+
+    printf("ok\n");
+    return 0;
+}
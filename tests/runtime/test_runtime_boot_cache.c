@@ -0,0 +1,168 @@
+#include "platform_fs.h"
+#include "runtime.h"
+#include "runtime_client.h"
+#include "runtime_event.h"
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CACHE_DIR "test_runtime_boot_cache.d"
+
+static void fail(const char *msg)
+{
+    fprintf(stderr, "FAIL: %s\n", msg);
+    exit(1);
+}
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s: expected true\n", name);
+        exit(1);
+    }
+}
+
+/* Wait for type; note a LOAD_STATE_COMPLETE passed on the way. */
+static int poll_event(
+    runtime_client *client,
+    runtime_event *event,
+    runtime_event_type type,
+    double timeout_s,
+    int *loaded)
+{
+    clock_t start = clock();
+    while ((double)(clock() - start) / (double)CLOCKS_PER_SEC < timeout_s) {
+        while (runtime_client_poll_event(client, event)) {
+            if (event->type == RUNTIME_EVENT_ERROR) {
+                fprintf(stderr, "runtime error: %s\n", event->data.error.message);
+                exit(1);
+            }
+            if (event->type == RUNTIME_EVENT_LOAD_STATE_COMPLETE && loaded != NULL) {
+                *loaded = strncmp(event->data.state_file.path, CACHE_DIR, strlen(CACHE_DIR)) == 0;
+            }
+            if (event->type == type) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int count_manifests(void)
+{
+    platform_fs_listing *listing = (platform_fs_listing *)malloc(sizeof(*listing));
+    int count = 0;
+    int i;
+
+    if (listing == NULL) {
+        fail("malloc");
+    }
+    if (platform_fs_list_dir(CACHE_DIR, listing)) {
+        for (i = 0; i < listing->count; i++) {
+            const char *dot = strrchr(listing->entries[i].name, '.');
+            count += !listing->entries[i].is_dir && dot != NULL && strcmp(dot, ".a2sm") == 0;
+        }
+    }
+    free(listing);
+    return count;
+}
+
+static void remove_tree(const char *dir)
+{
+    platform_fs_listing *listing = (platform_fs_listing *)malloc(sizeof(*listing));
+    char child[1024];
+    int i;
+
+    if (listing == NULL || !platform_fs_list_dir(dir, listing)) {
+        free(listing);
+        return;
+    }
+    for (i = 0; i < listing->count; i++) {
+        if (strcmp(listing->entries[i].name, "..") == 0) {
+            continue;
+        }
+        platform_fs_path_join(child, sizeof(child), dir, listing->entries[i].name);
+        if (listing->entries[i].is_dir) {
+            remove_tree(child);
+        } else {
+            remove(child);
+        }
+    }
+    free(listing);
+    remove(dir);
+}
+
+/* One launch: no cards, so the //e ROM comes up in BASIC. Returns whether
+   startup loaded from the cache and the cycle count it started at. */
+static int launch(const char *until_text, int32_t until_pc, uint64_t *start_cycles)
+{
+    runtime_config config;
+    runtime *rt;
+    runtime_client *client;
+    runtime_event event;
+    int loaded = 0;
+    int slot;
+
+    runtime_config_init(&config);
+    config.start_running = false;
+    config.active_turbo_multiplier = RUNTIME_TURBO_MAX;
+    config.mb_slot = 0;
+    for (slot = 0; slot < RUNTIME_APPLE_SLOT_COUNT; slot++) {
+        config.slot_cards[slot] = RUNTIME_SLOT_CARD_EMPTY;
+    }
+    config.boot_cache_dir = CACHE_DIR;
+    config.boot_cache_until_text = until_text;
+    config.boot_cache_until_pc = until_pc;
+    rt = runtime_create(&config);
+    expect_true("create", rt != NULL && runtime_start(rt));
+    client = runtime_get_client(rt);
+    expect_true("STARTED", poll_event(client, &event, RUNTIME_EVENT_STARTED, 2.0, &loaded));
+    /* Startup publishes the reset CPU before the cache is consulted. */
+    expect_true("reset CPU", poll_event(client, &event, RUNTIME_EVENT_CPU_STATE_RESPONSE, 2.0, &loaded));
+
+    expect_true("cpu", runtime_client_request_cpu_state(client));
+    expect_true("CPU", poll_event(client, &event, RUNTIME_EVENT_CPU_STATE_RESPONSE, 2.0, &loaded));
+    *start_cycles = event.data.cpu_state.cycles;
+
+    /* Enough for the banner and the prompt; a miss saves on the way. */
+    expect_true("run", runtime_client_run_cycles(client, 3000000u));
+    expect_true("RUN_COMPLETE", poll_event(client, &event, RUNTIME_EVENT_RUN_COMPLETE, 20.0, &loaded));
+
+    expect_true("quit", runtime_client_quit(client));
+    (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0, &loaded);
+    runtime_destroy(rt);
+    return loaded;
+}
+
+int main(void)
+{
+    uint64_t cycles = 0;
+
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+        fail("SDL_Init failed");
+    }
+    remove_tree(CACHE_DIR);
+
+    /* Miss: cold boot, saved when the banner shows (writes finish by exit). */
+    expect_true("cold", !launch("Apple", -1, &cycles));
+    expect_true("cold start", cycles < 100u);
+    expect_true("saved", count_manifests() == 1);
+
+    /* Hit: starts from the saved state. */
+    expect_true("hit", launch("Apple", -1, &cycles));
+    expect_true("warm start", cycles > 1000u);
+    expect_true("no new entry", count_manifests() == 1);
+
+    /* Another condition is another key: a miss, captured at the PC. */
+    expect_true("pc miss", !launch(NULL, 0xFB2F, &cycles));
+    expect_true("pc saved", count_manifests() == 2);
+    expect_true("pc hit", launch(NULL, 0xFB2F, &cycles));
+
+    remove_tree(CACHE_DIR);
+    SDL_Quit();
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "runtime_frame_handoff.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        exit(1);
+    }
+}
+
+static void paint(runtime_frame_handoff *h, uint64_t frame_number)
+{
+    runtime_frame_buffer *back = runtime_frame_handoff_back(h);
+    memset(back->pixels, (int)(frame_number & 0xFFu), (size_t)back->width * back->height);
+    back->frame_number = frame_number;
+}
+
+int main(void)
+{
+    runtime_frame_handoff *h = runtime_frame_handoff_create(8u, 4u);
+    const runtime_frame_buffer *front;
+    runtime_frame_buffer *back;
+    uint64_t i;
+
+    expect_true("create", h != NULL);
+    expect_true("nothing published", runtime_frame_handoff_acquire(h) == NULL);
+
+    paint(h, 1u);
+    expect_true("first publish not dropped", !runtime_frame_handoff_publish(h));
+    front = runtime_frame_handoff_acquire(h);
+    expect_true("acquire first", front != NULL && front->frame_number == 1u);
+    expect_true("front pixels", front->pixels[31] == 1u);
+    expect_true("no second acquire", runtime_frame_handoff_acquire(h) == NULL);
+
+    /* Producer keeps painting: never into the buffer the consumer holds. */
+    for (i = 2u; i < 10u; i++) {
+        back = runtime_frame_handoff_back(h);
+        expect_true("back is not front", back->pixels != front->pixels);
+        paint(h, i);
+        expect_true("drop after first unconsumed", runtime_frame_handoff_publish(h) == (i > 2u));
+    }
+    expect_true("front untouched", front->pixels[0] == 1u && front->frame_number == 1u);
+
+    /* Latest wins. */
+    front = runtime_frame_handoff_acquire(h);
+    expect_true("latest", front != NULL && front->frame_number == 9u && front->pixels[5] == 9u);
+    back = runtime_frame_handoff_back(h);
+    expect_true("rotated back distinct", back->pixels != front->pixels);
+
+    runtime_frame_handoff_destroy(h);
+    printf("ok\n");
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include "runtime_frame_ring.h"
 
+#include "apple2.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,35 +14,62 @@ static void expect_true(const char *name, int v)
     }
 }
 
+/* Deterministic frame i: a few changed lines over a text-like base, plus a
+   noisy band every fourth frame so deltas vary in size. */
+static void fill_frame(uint8_t *pixels, uint32_t i)
+{
+    uint32_t x;
+    uint32_t state = 0x12345u + i * 977u;
+
+    memset(pixels, 0, RUNTIME_FRAME_RING_PIXELS);
+    for (x = 0; x < (uint32_t)DISPLAY_FRAME_WIDTH * 8u; x++) {
+        pixels[((i * 8u) % 192u) * DISPLAY_FRAME_WIDTH + x] = (uint8_t)((x / 14u) & 15u);
+    }
+    if ((i % 4u) == 3u) {
+        for (x = 0; x < RUNTIME_FRAME_RING_PIXELS / 2u; x++) {
+            state = state * 1103515245u + 12345u;
+            pixels[x] = (uint8_t)((state >> 16) & 15u);
+        }
+    }
+}
+
 int main(void)
 {
     runtime_frame_ring ring;
     runtime_ring_frame out;
     runtime_frame_ring_info info;
-    uint32_t pixels[RUNTIME_FRAME_RING_PIXELS];
+    static uint8_t pixels[RUNTIME_FRAME_RING_PIXELS];
+    uint32_t palette[DISPLAY_FRAME_PALETTE_SIZE];
     uint32_t i;
 
     memset(pixels, 0, sizeof(pixels));
-    pixels[0] = 0xFF00FF00u;
-    pixels[1] = 0xFFFF0000u;
+    for (i = 0; i < DISPLAY_FRAME_PALETTE_SIZE; i++) {
+        palette[i] = 0xFF000000u | (i * 0x111111u);
+    }
+    pixels[0] = 12u;
+    pixels[1] = 9u;
 
     expect_true(
         "init",
-        runtime_frame_ring_init(&ring, 4ull * sizeof(runtime_ring_frame)));
+        runtime_frame_ring_init(
+            &ring, 5ull * sizeof(runtime_ring_frame), RUNTIME_FRAME_RING_MODE_PIXELS));
 
     expect_true(
         "push10",
         runtime_frame_ring_push(
-            &ring, 10, 1000, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels));
-    pixels[0] = 0xFF0000FFu;
+            &ring, 10, 1000, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels, palette));
+    pixels[0] = 6u;
     expect_true(
         "push11",
         runtime_frame_ring_push(
-            &ring, 11, 2000, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels));
+            &ring, 11, 2000, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels, palette));
 
     expect_true("copy by frame 11", runtime_frame_ring_copy_by_frame(&ring, 11, &out));
     expect_true("frame num", out.frame_number == 11);
-    expect_true("pix", out.pixels[0] == 0xFF0000FFu);
+    expect_true("pix", out.pixels[0] == 6u);
+    expect_true("indexed format", out.pixel_format == DISPLAY_FRAME_PIXEL_FORMAT_INDEXED8);
+    expect_true("indexed stride", out.stride_bytes == DISPLAY_FRAME_WIDTH);
+    expect_true("palette kept", out.palette[6] == palette[6]);
 
     expect_true("copy by cycle", runtime_frame_ring_copy_by_cycle(&ring, 1500, &out));
     expect_true("at-or-before", out.frame_number == 10);
@@ -52,33 +81,199 @@ int main(void)
     expect_true("recording", info.recording);
 
     runtime_frame_ring_set_recording(&ring, false);
-    pixels[0] = 0xFFFFFFFFu;
+    pixels[0] = 15u;
     expect_true(
         "no push when off",
         !runtime_frame_ring_push(
-            &ring, 12, 3000, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels));
+            &ring, 12, 3000, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels, palette));
 
     runtime_frame_ring_clear(&ring);
     runtime_frame_ring_get_info(&ring, &info);
     expect_true("cleared", info.count == 0);
 
-    /* Fill past capacity to exercise drop counter. */
+    /* Slow-changing screen: small deltas and zero-byte repeats. */
     runtime_frame_ring_set_recording(&ring, true);
     for (i = 0; i < 8u; i++) {
-        pixels[0] = i;
+        pixels[0] = (uint8_t)(i / 4u);
         (void)runtime_frame_ring_push(
             &ring,
             100u + i,
             10000u + i,
             DISPLAY_FRAME_WIDTH,
             DISPLAY_FRAME_HEIGHT,
-            pixels);
+            pixels,
+            palette);
+    }
+    runtime_frame_ring_get_info(&ring, &info);
+    expect_true("idle frames repeat", info.repeats > 0);
+    expect_true("repeats cost nothing", info.used_bytes < 4096u);
+    expect_true("repeat decodes", runtime_frame_ring_copy_by_frame(&ring, 106u, &out));
+    expect_true("repeat pixel", out.pixels[0] == 1u && out.frame_number == 106u);
+    expect_true("delta base decodes", runtime_frame_ring_copy_by_frame(&ring, 102u, &out));
+    expect_true("delta base pixel", out.pixels[0] == 0u);
+
+    /* Rewind: frames from 105 on go, the rest still decode, and the next
+       push of 105 starts a fresh keyframe group. */
+    runtime_frame_ring_truncate(&ring, 105u);
+    runtime_frame_ring_get_info(&ring, &info);
+    expect_true("truncated", info.count == 5u && info.newest_frame == 104u);
+    expect_true("gone after truncate", runtime_frame_ring_copy_by_frame(&ring, 107u, &out) &&
+                                           out.frame_number == 104u);
+    pixels[0] = 7u;
+    expect_true(
+        "push after truncate",
+        runtime_frame_ring_push(
+            &ring, 105u, 10005u, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels, palette));
+    expect_true("replayed decodes", runtime_frame_ring_copy_by_frame(&ring, 105u, &out));
+    expect_true("replayed pixel", out.pixels[0] == 7u);
+    expect_true("kept decodes", runtime_frame_ring_copy_by_frame(&ring, 103u, &out));
+    expect_true("kept pixel", out.pixels[0] == 0u);
+
+    /* Noisy frames exhaust the arena: whole keyframe groups are dropped and
+       every retained frame still decodes exactly. */
+    runtime_frame_ring_clear(&ring);
+    for (i = 0; i < 40u; i++) {
+        fill_frame(pixels, i);
+        expect_true(
+            "push noisy",
+            runtime_frame_ring_push(
+                &ring, 200u + i, 20000u + i, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT,
+                pixels, palette));
     }
     runtime_frame_ring_get_info(&ring, &info);
-    expect_true("capacity full", info.count == info.capacity);
     expect_true("dropped some", info.dropped > 0);
+    expect_true("retained some", info.count > 0 && info.count < 40u);
+    expect_true("oldest is newest - count + 1", info.oldest_frame == 240u - info.count);
+    for (i = 40u - info.count; i < 40u; i++) {
+        fill_frame(pixels, i);
+        expect_true("decode retained", runtime_frame_ring_copy_by_frame(&ring, 200u + i, &out));
+        expect_true("decoded frame num", out.frame_number == 200u + i);
+        expect_true("decoded exact", memcmp(out.pixels, pixels, sizeof(pixels)) == 0);
+    }
+    expect_true(
+        "evicted not found",
+        !runtime_frame_ring_copy_by_frame(&ring, 240u - info.count - 1u, &out));
+
+    /* Thumbnail strip: solid frames shrink to solid thumbnails; repeats
+       share their source's thumbnails; deltas store none and derive theirs;
+       pre-window targets are skipped. */
+    {
+        runtime_ring_thumbnail *thumbs =
+            (runtime_ring_thumbnail *)malloc(8u * sizeof(runtime_ring_thumbnail));
+        uint32_t got = 0;
+
+        expect_true("thumb alloc", thumbs != NULL);
+        runtime_frame_ring_clear(&ring);
+        for (i = 0; i < 8u; i++) {
+            memset(pixels, (int)(1u + i / 2u), sizeof(pixels));
+            expect_true(
+                "push solid",
+                runtime_frame_ring_push(
+                    &ring, 400u + i, 40000u + i * 100u, DISPLAY_FRAME_WIDTH,
+                    DISPLAY_FRAME_HEIGHT, pixels, palette));
+        }
+        {
+            uint32_t deltas = 0;
+            for (i = 0; i < ring.count; i++) {
+                const runtime_ring_entry *e =
+                    &ring.entries[(ring.head + ring.capacity - ring.count + i) % ring.capacity];
+                expect_true(
+                    "thumbs on keys only",
+                    (e->kind == RUNTIME_RING_ENTRY_KEY) == (e->thumb_small_size != 0u));
+                deltas += e->kind == RUNTIME_RING_ENTRY_DELTA;
+            }
+            expect_true("deltas present", deltas == 3u);
+        }
+        expect_true(
+            "strip small",
+            runtime_frame_ring_copy_strip(
+                &ring, 400u, 407u, false, RUNTIME_FRAME_RING_THUMB_SCALE_SMALL, 8u, thumbs, &got));
+        expect_true("strip count", got == 8u);
+        expect_true("strip dims", thumbs[0].width == 140u && thumbs[0].height == 48u);
+        for (i = 0; i < 8u; i++) {
+            expect_true("strip frame", thumbs[i].frame_number == 400u + i);
+            expect_true("strip solid", thumbs[i].pixels[0] == 1u + i / 2u &&
+                                           thumbs[i].pixels[140u * 48u - 1u] == 1u + i / 2u);
+        }
+        expect_true("strip palette", thumbs[3].palette[5] == palette[5]);
+        expect_true(
+            "strip tiny by cycle",
+            runtime_frame_ring_copy_strip(
+                &ring, 39300u, 40700u, true, RUNTIME_FRAME_RING_THUMB_SCALE_TINY, 3u, thumbs, &got));
+        expect_true("pre-window skipped", got == 2u);
+        expect_true("tiny dims", thumbs[0].width == 35u && thumbs[0].height == 12u);
+        expect_true("tiny resolve", thumbs[0].frame_number == 400u && thumbs[1].frame_number == 407u);
+        expect_true("tiny solid", thumbs[1].pixels[0] == 4u);
+        expect_true(
+            "bad scale",
+            !runtime_frame_ring_copy_strip(&ring, 400u, 407u, false, 8u, 2u, thumbs, &got));
+
+        /* Time going backwards restarts the ring so the index stays sorted. */
+        expect_true(
+            "push backwards",
+            runtime_frame_ring_push(
+                &ring, 10u, 10u, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels, palette));
+        runtime_frame_ring_get_info(&ring, &info);
+        expect_true("backwards restarts", info.count == 1u && info.oldest_frame == 10u);
+        free(thumbs);
+    }
 
     runtime_frame_ring_destroy(&ring);
+
+    /* Video mode: captures of a text screen re-render to the painted frame. */
+    {
+        apple2_t m;
+        apple2_video_capture *cap = (apple2_video_capture *)malloc(sizeof(*cap));
+        uint64_t text_bytes;
+
+        expect_true("capture alloc", cap != NULL);
+        expect_true("machine init", apple2_init(&m));
+        expect_true(
+            "video init",
+            runtime_frame_ring_init(
+                &ring, 5ull * sizeof(runtime_ring_frame), RUNTIME_FRAME_RING_MODE_VIDEO));
+        expect_true(
+            "pixel push rejected",
+            !runtime_frame_ring_push(
+                &ring, 1, 1, DISPLAY_FRAME_WIDTH, DISPLAY_FRAME_HEIGHT, pixels, palette));
+        m.state_flags = A2S_TEXT;
+        memset(m.ram_main + 0x400, 0xA0, 0x400);
+        for (i = 0; i < 6u; i++) {
+            m.ram_main[0x400] = (uint8_t)(0xC1u + (i / 2u));
+            apple2_video_capture_frame(&m, false, cap);
+            expect_true(
+                "push video",
+                runtime_frame_ring_push_video(
+                    &ring, 300u + i, 30000u + i, apple2_video_indexed_framebuffer(&m), cap, m.rom_char, m.rom_char_size,
+                    m.model == APPLE2_MODEL_II_PLUS));
+        }
+        runtime_frame_ring_get_info(&ring, &info);
+        expect_true("video mode", info.mode == RUNTIME_FRAME_RING_MODE_VIDEO);
+        expect_true("video count", info.count == 6u);
+        expect_true("video repeats", info.repeats == 3u);
+        text_bytes = info.used_bytes;
+        expect_true("text capture small", text_bytes < 1024u);
+
+        m.ram_main[0x404] = 0xC8u;
+        apple2_video_paint_full_frame(&m);
+        apple2_video_capture_frame(&m, false, cap);
+        expect_true(
+            "push video last",
+            runtime_frame_ring_push_video(
+                &ring, 306u, 30006u, apple2_video_indexed_framebuffer(&m), cap, m.rom_char, m.rom_char_size,
+                m.model == APPLE2_MODEL_II_PLUS));
+        expect_true("video decode", runtime_frame_ring_copy_by_frame(&ring, 306u, &out));
+        expect_true("video frame num", out.frame_number == 306u);
+        expect_true("video palette", out.palette[15] == apple2_video_palette()[15]);
+        expect_true(
+            "video render matches paint",
+            memcmp(out.pixels, apple2_video_indexed_framebuffer(&m), sizeof(out.pixels)) == 0);
+        expect_true("older video decodes", runtime_frame_ring_copy_by_frame(&ring, 301u, &out));
+
+        runtime_frame_ring_destroy(&ring);
+        apple2_shutdown(&m);
+        free(cap);
+    }
     printf("ok\n");
     return 0;
 }
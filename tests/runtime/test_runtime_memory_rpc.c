@@ -139,6 +139,118 @@ int main(void)
         fail("main memory mismatch");
     }
 
+    /* RAM mirror: a read after a queued write is refused or already current,
+       never the old bytes; once the worker catches up it serves lock-free. */
+    {
+        static const uint8_t repoke[4] = { 0x12, 0x34, 0x56, 0x78 };
+        runtime_machine_snapshot state;
+        clock_t start;
+        bool served = false;
+
+        expect_true(
+            "write_memory again",
+            runtime_client_write_memory(client, 0x0300, 4, RUNTIME_MEMORY_MODE_MAP, repoke));
+        start = clock();
+        while ((double)(clock() - start) / (double)CLOCKS_PER_SEC < 2.0) {
+            if (runtime_client_read_memory_mirror(
+                    client, 0x0300, 4, RUNTIME_MEMORY_MODE_MAP, verify)) {
+                served = true;
+                break;
+            }
+        }
+        expect_true("mirror served", served);
+        if (memcmp(verify, repoke, 4) != 0) {
+            fail("mirror memory mismatch");
+        }
+        expect_true(
+            "mirror main",
+            runtime_client_read_memory_mirror(
+                client, 0x0300, 4, RUNTIME_MEMORY_MODE_MAIN, verify) &&
+                memcmp(verify, repoke, 4) == 0);
+        expect_true(
+            "mirror machine",
+            runtime_client_read_machine_mirror(client, &state) &&
+                state.ready == 1u && state.running == 0u);
+
+        /* A stop event is posted after the mirror caught up: the first read
+           once STEP_COMPLETE arrives already shows the stepped CPU. */
+        expect_true("step", runtime_client_step_instruction(client));
+        expect_true("STEP_COMPLETE", poll_event(client, &event, RUNTIME_EVENT_STEP_COMPLETE, 2.0));
+        expect_true(
+            "mirror after step",
+            runtime_client_read_machine_mirror(client, &state) &&
+                state.pc == event.data.step_complete.cpu.pc &&
+                state.cpu_cycles == event.data.step_complete.cpu.cycles);
+    }
+
+    /* Scatter-gather: one write and one RPC / mirror read over several spans
+       in different views; a span may wrap at $FFFF. */
+    {
+        static const uint8_t main_bytes[3] = { 0x01, 0x02, 0x03 };
+        static const uint8_t aux_bytes[2] = { 0xA5, 0x5A };
+        runtime_memory_span spans[3];
+        uint8_t *upload = (uint8_t *)malloc(5);
+        uint8_t gathered[7];
+        clock_t start;
+        bool served = false;
+
+        expect_true("upload alloc", upload != NULL);
+        memcpy(upload, main_bytes, 3);
+        memcpy(upload + 3, aux_bytes, 2);
+        spans[0].address = 0x0400;
+        spans[0].mode = RUNTIME_MEMORY_MODE_MAIN;
+        spans[0].length = 3;
+        spans[1].address = 0x0400;
+        spans[1].mode = RUNTIME_MEMORY_MODE_AUX;
+        spans[1].length = 2;
+        expect_true(
+            "write_memory_spans",
+            runtime_client_write_memory_spans(client, spans, 2u, upload, 5u));
+
+        spans[2].address = 0xFFFF;
+        spans[2].mode = RUNTIME_MEMORY_MODE_MAIN;
+        spans[2].length = 2;
+        token = runtime_client_alloc_request_token(client);
+        expect_true(
+            "request_memory_spans",
+            runtime_client_request_memory_spans(client, spans, 3u, token));
+        expect_true(
+            "MEMORY_RPC spans",
+            poll_event(client, &event, RUNTIME_EVENT_MEMORY_RPC_COMPLETE, 2.0));
+        expect_true("spans token echo", event.request_token == token);
+        expect_true(
+            "spans claim",
+            runtime_client_claim_memory_rpc(client, token, &bytes, &length, NULL, NULL));
+        expect_true("spans length", length == 7u && bytes != NULL);
+        if (memcmp(bytes, main_bytes, 3) != 0 || memcmp(bytes + 3, aux_bytes, 2) != 0) {
+            free(bytes);
+            fail("spans rpc mismatch");
+        }
+
+        start = clock();
+        while ((double)(clock() - start) / (double)CLOCKS_PER_SEC < 2.0) {
+            if (runtime_client_read_memory_mirror_spans(client, spans, 3u, gathered)) {
+                served = true;
+                break;
+            }
+        }
+        expect_true("spans mirror served", served);
+        if (memcmp(gathered, bytes, 7) != 0) {
+            free(bytes);
+            fail("spans mirror mismatch");
+        }
+        free(bytes);
+
+        spans[0].length = 0;
+        expect_true(
+            "spans reject empty",
+            !runtime_client_request_memory_spans(client, spans, 1u, token));
+        expect_true(
+            "spans reject size mismatch",
+            !runtime_client_write_memory_spans(
+                client, spans + 1, 1u, (uint8_t *)malloc(3), 3u));
+    }
+
     expect_true("quit", runtime_client_quit(client));
     (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0);
     runtime_stop(rt);
@@ -0,0 +1,158 @@
+#include "runtime.h"
+#include "runtime_client.h"
+#include "runtime_event.h"
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum { FRAME_CYCLES = 17030 };
+
+static void fail(const char *msg)
+{
+    fprintf(stderr, "FAIL: %s\n", msg);
+    exit(1);
+}
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s: expected true\n", name);
+        exit(1);
+    }
+}
+
+static int poll_event(
+    runtime_client *client,
+    runtime_event *event,
+    runtime_event_type type,
+    double timeout_s)
+{
+    clock_t start = clock();
+    while ((double)(clock() - start) / (double)CLOCKS_PER_SEC < timeout_s) {
+        while (runtime_client_poll_event(client, event)) {
+            if (event->type == RUNTIME_EVENT_ERROR) {
+                fprintf(stderr, "runtime error: %s\n", event->data.error.message);
+                exit(1);
+            }
+            if (event->type == type) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void run_frames(runtime_client *client, uint32_t frames)
+{
+    runtime_event event;
+
+    expect_true("run", runtime_client_run_cycles(client, (size_t)frames * FRAME_CYCLES));
+    expect_true("RUN_COMPLETE", poll_event(client, &event, RUNTIME_EVENT_RUN_COMPLETE, 5.0));
+}
+
+static void poke(runtime_client *client, uint8_t value)
+{
+    expect_true(
+        "write", runtime_client_write_memory(client, 0x6000u, 1, RUNTIME_MEMORY_MODE_MAIN, &value));
+}
+
+static uint8_t peek(runtime_client *client)
+{
+    runtime_event event;
+
+    expect_true(
+        "read", runtime_client_request_memory(client, 0x6000u, 1, RUNTIME_MEMORY_MODE_MAIN));
+    expect_true("MEM", poll_event(client, &event, RUNTIME_EVENT_MEMORY_RESPONSE, 2.0));
+    return event.data.memory.bytes[0];
+}
+
+static void rewind_frames(runtime_client *client, uint32_t frames, runtime_event *event)
+{
+    expect_true("rewind", runtime_client_rewind(client, frames, 7u));
+    expect_true("REWIND_COMPLETE", poll_event(client, event, RUNTIME_EVENT_REWIND_COMPLETE, 5.0));
+    expect_true("token echoed", event->request_token == 7u);
+}
+
+int main(void)
+{
+    runtime_config config;
+    runtime *rt;
+    runtime_client *client;
+    runtime_event event;
+    uint64_t frame;
+
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+        fail("SDL_Init failed");
+    }
+
+    /* Off: nothing to rewind to. */
+    runtime_config_init(&config);
+    config.start_running = false;
+    rt = runtime_create(&config);
+    expect_true("create off", rt != NULL && runtime_start(rt));
+    client = runtime_get_client(rt);
+    expect_true("STARTED off", poll_event(client, &event, RUNTIME_EVENT_STARTED, 2.0));
+    run_frames(client, 4u);
+    rewind_frames(client, 2u, &event);
+    expect_true("off fails", event.data.rewind.ok == 0u);
+    expect_true("quit off", runtime_client_quit(client));
+    (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0);
+    runtime_destroy(rt);
+
+    runtime_config_init(&config);
+    config.start_running = false;
+    config.rewind_memory_mb = 8u;
+    config.rewind_interval_frames = 4u;
+    rt = runtime_create(&config);
+    expect_true("create", rt != NULL && runtime_start(rt));
+    client = runtime_get_client(rt);
+    expect_true("STARTED", poll_event(client, &event, RUNTIME_EVENT_STARTED, 2.0));
+
+    /* Marker 1 for ten frames, then marker 2 for ten more. */
+    poke(client, 1u);
+    run_frames(client, 10u);
+    poke(client, 2u);
+    run_frames(client, 10u);
+    expect_true("marker 2", peek(client) == 2u);
+
+    /* Lands on the exact frame between checkpoints (interval 4). */
+    rewind_frames(client, 7u, &event);
+    expect_true("rewound", event.data.rewind.ok == 1u);
+    expect_true("exact frames", event.data.rewind.frames == 7u);
+    expect_true("checkpoints kept", event.data.rewind.checkpoints > 0u);
+    frame = event.data.rewind.frame_number;
+    expect_true("still marker 2", peek(client) == 2u);
+
+    rewind_frames(client, 6u, &event);
+    expect_true("rewound again", event.data.rewind.ok == 1u);
+    expect_true("again exact", event.data.rewind.frame_number == frame - 6u);
+    expect_true("marker 1 back", peek(client) == 1u);
+
+    /* Forward again from the rewound point; a request older than the
+       buffer lands on its oldest checkpoint. */
+    run_frames(client, 3u);
+    rewind_frames(client, 1000u, &event);
+    expect_true("clamped", event.data.rewind.ok == 1u && event.data.rewind.frames < 1000u);
+    expect_true("oldest marker", peek(client) == 1u);
+
+    /* A re-run cannot repeat a poke: it stops short of it, earlier than
+       asked (no checkpoint falls in the two frames). */
+    frame = event.data.rewind.frame_number;
+    poke(client, 3u);
+    run_frames(client, 2u);
+    rewind_frames(client, 1u, &event);
+    expect_true("short of input", event.data.rewind.ok == 1u &&
+                event.data.rewind.frame_number == frame && event.data.rewind.frames == 2u);
+    expect_true("before the poke", peek(client) == 1u);
+
+    expect_true("quit", runtime_client_quit(client));
+    (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0);
+    runtime_stop(rt);
+    runtime_destroy(rt);
+    SDL_Quit();
+    printf("ok\n");
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "runtime.h"
 #include "runtime_client.h"
 #include "runtime_event.h"
+#include "runtime_state_writer.h"
 
 #include <SDL.h>
 #include <stdio.h>
@@ -107,6 +108,8 @@ int main(void)
     expect_true(
         "SAVE_COMPLETE",
         poll_event(client, &event, RUNTIME_EVENT_SAVE_STATE_COMPLETE, 5.0));
+    expect_true("saved path", strcmp(event.data.state_file.path, path) == 0);
+    expect_true("temp replaced", fopen("test_runtime_savestate.a2state.tmp", "rb") == NULL);
     drain_events(client);
 
     /* Mutate state then reload. */
@@ -157,6 +160,41 @@ int main(void)
         fail("RAM marker not restored");
     }
 
+    /* More saves of one path than the writer queues: the last one wins and
+       completions come back in save order. */
+    {
+        enum { SAVES = RUNTIME_STATE_WRITER_QUEUE_CAPACITY + 4 };
+        uint8_t value;
+        int i;
+
+        for (i = 0; i < SAVES; i++) {
+            value = (uint8_t)i;
+            expect_true(
+                "burst write",
+                runtime_client_write_memory(
+                    client, marker_addr, 1, RUNTIME_MEMORY_MODE_MAIN, &value));
+            expect_true("burst save", runtime_client_save_state(client, path));
+        }
+        for (i = 0; i < SAVES; i++) {
+            expect_true(
+                "burst SAVE_COMPLETE",
+                poll_event(client, &event, RUNTIME_EVENT_SAVE_STATE_COMPLETE, 5.0));
+        }
+        expect_true("burst temp replaced", fopen("test_runtime_savestate.a2state.tmp", "rb") == NULL);
+        drain_events(client);
+
+        expect_true("burst load", runtime_client_load_state(client, path));
+        expect_true(
+            "burst LOAD_COMPLETE",
+            poll_event(client, &event, RUNTIME_EVENT_LOAD_STATE_COMPLETE, 5.0));
+        drain_events(client);
+        expect_true(
+            "burst mem",
+            runtime_client_request_memory(client, marker_addr, 1, RUNTIME_MEMORY_MODE_MAIN));
+        expect_true("burst MEM", poll_event(client, &event, RUNTIME_EVENT_MEMORY_RESPONSE, 2.0));
+        expect_true("last save wins", event.data.memory.bytes[0] == (uint8_t)(SAVES - 1));
+    }
+
     remove(path);
     expect_true("quit", runtime_client_quit(client));
     (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0);
@@ -0,0 +1,212 @@
+#include "runtime.h"
+#include "runtime_client.h"
+#include "runtime_event.h"
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum { FRAME_CYCLES = 17030, LOOP_CYCLES = 9 };
+
+static void fail(const char *msg)
+{
+    fprintf(stderr, "FAIL: %s\n", msg);
+    exit(1);
+}
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s: expected true\n", name);
+        exit(1);
+    }
+}
+
+static int poll_event(
+    runtime_client *client,
+    runtime_event *event,
+    runtime_event_type type,
+    double timeout_s)
+{
+    clock_t start = clock();
+    while ((double)(clock() - start) / (double)CLOCKS_PER_SEC < timeout_s) {
+        while (runtime_client_poll_event(client, event)) {
+            if (event->type == RUNTIME_EVENT_ERROR) {
+                fprintf(stderr, "runtime error: %s\n", event->data.error.message);
+                exit(1);
+            }
+            if (event->type == type) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void run_frames(runtime_client *client, uint32_t frames)
+{
+    runtime_event event;
+
+    expect_true("run", runtime_client_run_cycles(client, (size_t)frames * FRAME_CYCLES));
+    expect_true("RUN_COMPLETE", poll_event(client, &event, RUNTIME_EVENT_RUN_COMPLETE, 5.0));
+}
+
+static uint8_t peek(runtime_client *client)
+{
+    runtime_event event;
+
+    expect_true(
+        "read", runtime_client_request_memory(client, 0x6000u, 1, RUNTIME_MEMORY_MODE_MAIN));
+    expect_true("MEM", poll_event(client, &event, RUNTIME_EVENT_MEMORY_RESPONSE, 2.0));
+    return event.data.memory.bytes[0];
+}
+
+static void wait_seek(runtime_client *client, runtime_event *event)
+{
+    expect_true("SEEK_COMPLETE", poll_event(client, event, RUNTIME_EVENT_SEEK_COMPLETE, 5.0));
+    expect_true("token echoed", event->request_token == 9u);
+}
+
+int main(void)
+{
+    /* $0300: INC $6000 / JMP $0300, nine cycles a lap. */
+    static const uint8_t loop[] = { 0xEE, 0x00, 0x60, 0x4C, 0x00, 0x03 };
+    runtime_config config;
+    runtime *rt;
+    runtime_client *client;
+    runtime_event event;
+    uint64_t origin;
+    uint64_t hit;
+    uint8_t counter;
+
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+        fail("SDL_Init failed");
+    }
+
+    /* Off: nothing to go back to. */
+    runtime_config_init(&config);
+    config.start_running = false;
+    rt = runtime_create(&config);
+    expect_true("create off", rt != NULL && runtime_start(rt));
+    client = runtime_get_client(rt);
+    expect_true("STARTED off", poll_event(client, &event, RUNTIME_EVENT_STARTED, 2.0));
+    run_frames(client, 2u);
+    expect_true("step-back off", runtime_client_step_back(client, 9u));
+    wait_seek(client, &event);
+    expect_true("off fails", event.data.seek.result == RUNTIME_SEEK_NO_CHECKPOINT);
+    expect_true("quit off", runtime_client_quit(client));
+    (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0);
+    runtime_destroy(rt);
+
+    runtime_config_init(&config);
+    config.start_running = false;
+    config.rewind_memory_mb = 8u;
+    config.rewind_interval_frames = 2u;
+    /* step-back reads the previous instruction from the recorder. */
+    config.history_memory_mb = 16u;
+    rt = runtime_create(&config);
+    expect_true("create", rt != NULL && runtime_start(rt));
+    client = runtime_get_client(rt);
+    expect_true("STARTED", poll_event(client, &event, RUNTIME_EVENT_STARTED, 2.0));
+
+    expect_true("program", runtime_client_write_memory(
+        client, 0x0300u, sizeof(loop), RUNTIME_MEMORY_MODE_MAIN, loop));
+    expect_true("pc", runtime_client_set_pc(client, 0x0300u));
+    run_frames(client, 9u);
+
+    /* Step back one instruction, then forward again to the same place. */
+    expect_true("cpu", runtime_client_request_cpu_state(client));
+    expect_true("CPU", poll_event(client, &event, RUNTIME_EVENT_CPU_STATE_RESPONSE, 2.0));
+    origin = event.data.cpu_state.cycles;
+    counter = peek(client);
+    expect_true("step-back", runtime_client_step_back(client, 9u));
+    wait_seek(client, &event);
+    expect_true("stepped back", event.data.seek.result == RUNTIME_SEEK_OK);
+    expect_true("one instruction", origin - event.data.seek.cycles <= 6u &&
+                event.data.seek.cycles < origin);
+    expect_true("step paused", event.data.seek.stop == RUNTIME_STOP_REASON_STEP);
+    expect_true("step", runtime_client_step_instruction(client));
+    expect_true("STEP", poll_event(client, &event, RUNTIME_EVENT_STEP_COMPLETE, 2.0));
+    expect_true("forward again", event.data.step_complete.cpu.cycles == origin);
+    expect_true("same counter", peek(client) == counter);
+
+    /* Recorder off: the previous boundary comes from a pass over the
+       checkpoint interval instead. */
+    expect_true("history off", runtime_client_history_record(client, false, 1u));
+    expect_true("HISTORY", poll_event(client, &event, RUNTIME_EVENT_HISTORY_STATUS_RESPONSE, 2.0));
+    expect_true("step-back unrecorded", runtime_client_step_back(client, 9u));
+    wait_seek(client, &event);
+    expect_true("unrecorded", event.data.seek.result == RUNTIME_SEEK_OK &&
+                event.data.seek.cycles < origin && origin - event.data.seek.cycles <= 6u);
+    expect_true("step 2", runtime_client_step_instruction(client));
+    expect_true("STEP 2", poll_event(client, &event, RUNTIME_EVENT_STEP_COMPLETE, 2.0));
+    expect_true("forward again 2", event.data.step_complete.cpu.cycles == origin);
+
+    /* Run-to-cycle goes back across checkpoints and forward again. */
+    expect_true(
+        "run-to back", runtime_client_run_to_cycle(client, origin - 3u * FRAME_CYCLES, 9u));
+    wait_seek(client, &event);
+    expect_true("back ok", event.data.seek.result == RUNTIME_SEEK_OK);
+    expect_true("back boundary", event.data.seek.cycles >= origin - 3u * FRAME_CYCLES &&
+                event.data.seek.cycles < origin - 3u * FRAME_CYCLES + LOOP_CYCLES);
+    expect_true("run-to forward", runtime_client_run_to_cycle(client, origin, 9u));
+    wait_seek(client, &event);
+    expect_true("forward ok", event.data.seek.result == RUNTIME_SEEK_OK &&
+                event.data.seek.cycles == origin);
+    expect_true("replayed counter", peek(client) == counter);
+
+    /* Reverse-continue: the previous stop at the JMP, then the one before. */
+    expect_true("break", runtime_client_set_execute_breakpoint(client, 0x0303u));
+    expect_true("reverse", runtime_client_reverse_continue(client, 9u));
+    wait_seek(client, &event);
+    expect_true("hit", event.data.seek.result == RUNTIME_SEEK_OK &&
+                event.data.seek.stop == RUNTIME_STOP_REASON_BREAKPOINT &&
+                event.data.seek.pc == 0x0303u && event.data.seek.cycles < origin);
+    hit = event.data.seek.cycles;
+    expect_true("reverse again", runtime_client_reverse_continue(client, 9u));
+    wait_seek(client, &event);
+    expect_true("previous lap", event.data.seek.cycles + LOOP_CYCLES == hit);
+
+    /* Forward run-to-cycle stops at a breakpoint on the way. */
+    expect_true("run-to stops", runtime_client_run_to_cycle(client, hit + 100u, 9u));
+    wait_seek(client, &event);
+    expect_true("stopped at break", event.data.seek.stop == RUNTIME_STOP_REASON_BREAKPOINT &&
+                event.data.seek.cycles == hit);
+
+    /* No breakpoint earlier: back where the search started. */
+    expect_true("clear", runtime_client_clear_all_breakpoints(client));
+    expect_true("reverse none", runtime_client_reverse_continue(client, 9u));
+    wait_seek(client, &event);
+    expect_true("none", event.data.seek.result == RUNTIME_SEEK_NO_BREAKPOINT &&
+                event.data.seek.cycles == hit);
+
+    /* A key press is input no checkpoint holds: replays stop short of it. */
+    expect_true("key", runtime_client_keyboard_key(client, HOST_KEY_A, true));
+    expect_true("step 3", runtime_client_step_instruction(client));
+    expect_true("STEP 3", poll_event(client, &event, RUNTIME_EVENT_STEP_COMPLETE, 2.0));
+    expect_true("step-back past input", runtime_client_step_back(client, 9u));
+    wait_seek(client, &event);
+    expect_true("input refused", event.data.seek.result == RUNTIME_SEEK_INPUT &&
+                event.data.seek.cycles > hit);
+    expect_true("run-to before input", runtime_client_run_to_cycle(client, hit - LOOP_CYCLES, 9u));
+    wait_seek(client, &event);
+    expect_true("before input ok", event.data.seek.result == RUNTIME_SEEK_OK &&
+                event.data.seek.cycles < hit);
+
+    /* Pressed again; once a checkpoint follows, stepping back works. */
+    expect_true("key again", runtime_client_keyboard_key(client, HOST_KEY_A, true));
+    run_frames(client, 3u);
+    expect_true("step-back after", runtime_client_step_back(client, 9u));
+    wait_seek(client, &event);
+    expect_true("after input", event.data.seek.result == RUNTIME_SEEK_OK);
+
+    expect_true("quit", runtime_client_quit(client));
+    (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0);
+    runtime_stop(rt);
+    runtime_destroy(rt);
+    SDL_Quit();
+    printf("ok\n");
+    return 0;
+}
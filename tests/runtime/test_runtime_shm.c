@@ -0,0 +1,131 @@
+#include "runtime_shm.h"
+
+#include "runtime_ram_mirror.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void fail(const char *msg)
+{
+    fprintf(stderr, "FAIL: %s\n", msg);
+    exit(1);
+}
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s: expected true\n", name);
+        exit(1);
+    }
+}
+
+int main(void)
+{
+    size_t size = runtime_shm_region_size();
+    size_t frame_bytes =
+        sizeof(uint32_t) * DISPLAY_FRAME_PALETTE_SIZE +
+        (size_t)DISPLAY_FRAME_WIDTH * DISPLAY_FRAME_HEIGHT;
+    size_t ram_bytes = (size_t)RUNTIME_RAM_MIRROR_VIEWS * MACHINE_ADDRESS_SPACE;
+    uint8_t *region = (uint8_t *)malloc(size);
+    uint8_t *pixels = (uint8_t *)malloc((size_t)DISPLAY_FRAME_WIDTH * DISPLAY_FRAME_HEIGHT);
+    uint8_t *out = (uint8_t *)malloc(ram_bytes);
+    runtime_shm_writer *writer;
+    runtime_frame_buffer frame;
+    runtime_frame_ring_info ring;
+    runtime_machine_snapshot state;
+    runtime_shm_info info;
+    uint64_t words[RUNTIME_SHM_RING_WORDS];
+    apple2_t *m = (apple2_t *)calloc(1, sizeof(*m));
+    uint32_t u32;
+    uint64_t u64;
+
+    if (region == NULL || pixels == NULL || out == NULL || m == NULL) {
+        fail("alloc");
+    }
+    expect_true("too small", runtime_shm_writer_create(region, size - 1u) == NULL);
+    writer = runtime_shm_writer_create(region, size);
+    expect_true("create", writer != NULL);
+
+    /* Header fields at the documented offsets. */
+    expect_true("magic", memcmp(region, RUNTIME_SHM_MAGIC, 8) == 0);
+    memcpy(&u32, region + 8, 4);
+    expect_true("version", u32 == RUNTIME_SHM_VERSION);
+    memcpy(&u64, region + 16, 8);
+    expect_true("region size", u64 == size);
+    memcpy(&u32, region + 24, 4);
+    expect_true("frame width", u32 == DISPLAY_FRAME_WIDTH);
+    memcpy(&u32, region + 36, 4);
+    expect_true("view size", u32 == MACHINE_ADDRESS_SPACE);
+    memcpy(&u32, region + 40, 4);
+    expect_true("frame unpublished", u32 == 0xFFFFFFFFu);
+    expect_true("nothing to read", !runtime_shm_read(region, RUNTIME_SHM_SECTION_FRAME, out, ram_bytes, &info));
+
+    /* Frames: newest wins, generation counts publishes. */
+    memset(&frame, 0, sizeof(frame));
+    frame.pixels = pixels;
+    frame.width = DISPLAY_FRAME_WIDTH;
+    frame.height = DISPLAY_FRAME_HEIGHT;
+    frame.palette[3] = 0xFF112233u;
+    memset(pixels, 3, (size_t)DISPLAY_FRAME_WIDTH * DISPLAY_FRAME_HEIGHT);
+    frame.frame_number = 10u;
+    frame.machine_cycle = 17030u;
+    runtime_shm_publish_frame(writer, &frame);
+    pixels[100] = 7u;
+    frame.frame_number = 11u;
+    runtime_shm_publish_frame(writer, &frame);
+    expect_true("frame read", runtime_shm_read(region, RUNTIME_SHM_SECTION_FRAME, out, ram_bytes, &info));
+    expect_true("frame info", info.generation == 2u && info.frame_number == 11u &&
+        info.cycle == 17030u && info.size == frame_bytes);
+    memcpy(&u32, out + 3 * 4, 4);
+    expect_true("palette", u32 == 0xFF112233u);
+    expect_true("pixels", out[64 + 99] == 3u && out[64 + 100] == 7u);
+
+    /* Ring window. */
+    memset(&ring, 0, sizeof(ring));
+    ring.count = 5u;
+    ring.capacity = 64u;
+    ring.oldest_frame = 7u;
+    ring.newest_frame = 11u;
+    ring.recording = true;
+    runtime_shm_publish_ring(writer, &ring);
+    expect_true("ring read", runtime_shm_read(region, RUNTIME_SHM_SECTION_RING, words, sizeof(words), &info));
+    expect_true("ring words", words[0] == 5u && words[1] == 64u && words[2] == 7u &&
+        words[3] == 11u && words[7] == 1u && info.frame_number == 11u);
+
+    /* RAM: every view; a later write shows up in the next publish even
+       though that slot was filled before (page tracking per slot). */
+    if (!apple2_init(m)) {
+        fail("apple2_init");
+    }
+    apple2_set_model(m, APPLE2_MODEL_IIE_ENHANCED);
+    apple2_reset(m);
+    memset(&state, 0, sizeof(state));
+    state.frame_number = 12u;
+    state.cycle = 20000u;
+    m->ram_main[0x0800] = 0x11;
+    m->ram_main[0x10000 + 0x0800] = 0x22;
+    runtime_shm_publish_ram(writer, m, &state);
+    expect_true("ram read", runtime_shm_read(region, RUNTIME_SHM_SECTION_RAM, out, ram_bytes, &info));
+    expect_true("ram info", info.generation == 1u && info.frame_number == 12u && info.size == ram_bytes);
+    expect_true("map view", out[RUNTIME_MEMORY_MODE_MAP * MACHINE_ADDRESS_SPACE + 0x0800] == 0x11);
+    expect_true("aux view", out[RUNTIME_MEMORY_MODE_AUX * MACHINE_ADDRESS_SPACE + 0x0800] == 0x22);
+    runtime_shm_publish_ram(writer, m, &state);
+    apple2_debug_write(m, 0x0800, 0x33);
+    runtime_shm_publish_ram(writer, m, &state);
+    expect_true("ram reread", runtime_shm_read(region, RUNTIME_SHM_SECTION_RAM, out, ram_bytes, &info));
+    expect_true("ram write seen", info.generation == 3u &&
+        out[RUNTIME_MEMORY_MODE_MAIN * MACHINE_ADDRESS_SPACE + 0x0800] == 0x33);
+
+    /* A short out buffer takes a prefix. */
+    expect_true("prefix", runtime_shm_read(region, RUNTIME_SHM_SECTION_RAM, out, 16u, NULL));
+
+    runtime_shm_writer_destroy(writer);
+    apple2_shutdown(m);
+    free(m);
+    free(region);
+    free(pixels);
+    free(out);
+    printf("ok\n");
+    return 0;
+}
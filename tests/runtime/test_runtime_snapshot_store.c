@@ -0,0 +1,219 @@
+#include "apple2_snapshot.h"
+#include "platform_fs.h"
+#include "runtime.h"
+#include "runtime_client.h"
+#include "runtime_event.h"
+#include "runtime_snapshot_store.h"
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STORE_DIR "test_runtime_snapshot_store.d"
+
+enum {
+    SMALL_CHUNK = 40,
+    LARGE_CHUNK = 160 * 1024 + 8,
+    IMAGE_SIZE = 32 + 8 + SMALL_CHUNK + 8 + LARGE_CHUNK + 8 + SMALL_CHUNK
+};
+
+static void fail(const char *msg)
+{
+    fprintf(stderr, "FAIL: %s\n", msg);
+    exit(1);
+}
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s: expected true\n", name);
+        exit(1);
+    }
+}
+
+static int poll_event(
+    runtime_client *client,
+    runtime_event *event,
+    runtime_event_type type,
+    double timeout_s)
+{
+    clock_t start = clock();
+    while ((double)(clock() - start) / (double)CLOCKS_PER_SEC < timeout_s) {
+        while (runtime_client_poll_event(client, event)) {
+            if (event->type == RUNTIME_EVENT_ERROR) {
+                fprintf(stderr, "runtime error: %s\n", event->data.error.message);
+                exit(1);
+            }
+            if (event->type == type) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void put_le32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+/* Header, small chunk, RAM-sized chunk (zeros but for marker), small chunk. */
+static void make_image(uint8_t *image, uint8_t marker)
+{
+    uint8_t *p = image;
+
+    memset(image, 0, IMAGE_SIZE);
+    put_le32(p, A2_SNAPSHOT_MAGIC);
+    put_le32(p + 4, A2_SNAPSHOT_VERSION);
+    put_le32(p + 8, 32u);
+    p += 32;
+    put_le32(p, 0x41544D45u);
+    put_le32(p + 4, SMALL_CHUNK);
+    memset(p + 8, 0x5A, SMALL_CHUNK);
+    p += 8 + SMALL_CHUNK;
+    put_le32(p, 0x5F4D4152u);
+    put_le32(p + 4, LARGE_CHUNK);
+    p[8 + 0x6000] = marker;
+    p += 8 + LARGE_CHUNK;
+    put_le32(p, 0x5F555043u);
+    put_le32(p + 4, SMALL_CHUNK);
+    memset(p + 8, marker, SMALL_CHUNK);
+}
+
+static long file_size(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    long size;
+
+    if (file == NULL) {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static void remove_tree(const char *dir)
+{
+    platform_fs_listing *listing = (platform_fs_listing *)malloc(sizeof(*listing));
+    char child[1024];
+    int i;
+
+    if (listing == NULL || !platform_fs_list_dir(dir, listing)) {
+        free(listing);
+        return;
+    }
+    for (i = 0; i < listing->count; i++) {
+        if (strcmp(listing->entries[i].name, "..") == 0) {
+            continue;
+        }
+        platform_fs_path_join(child, sizeof(child), dir, listing->entries[i].name);
+        if (listing->entries[i].is_dir) {
+            remove_tree(child);
+        } else {
+            remove(child);
+        }
+    }
+    free(listing);
+    remove(dir);
+}
+
+static void test_store(void)
+{
+    static uint8_t one[IMAGE_SIZE];
+    static uint8_t two[IMAGE_SIZE];
+    uint8_t *loaded = NULL;
+    size_t loaded_size = 0;
+    size_t fresh = 0;
+    FILE *file;
+
+    expect_true("ref", runtime_snapshot_store_is_ref(STORE_DIR "/a.A2SM"));
+    expect_true("not ref", !runtime_snapshot_store_is_ref("a.a2state") &&
+                !runtime_snapshot_store_is_ref("a.a2sm.bak"));
+
+    make_image(one, 1u);
+    make_image(two, 2u);
+    expect_true("save one", runtime_snapshot_store_save(STORE_DIR "/one.a2sm", one, IMAGE_SIZE, &fresh));
+    /* 41 blocks of the large chunk, but every all-zero block is one object. */
+    expect_true("one objects", fresh == 3u);
+    expect_true("small manifest", file_size(STORE_DIR "/one.a2sm") < 2048);
+    expect_true("save two", runtime_snapshot_store_save(STORE_DIR "/two.a2sm", two, IMAGE_SIZE, &fresh));
+    expect_true("one new page", fresh == 1u);
+    expect_true("resave", runtime_snapshot_store_save(STORE_DIR "/one.a2sm", one, IMAGE_SIZE, &fresh));
+    expect_true("nothing new", fresh == 0u);
+    expect_true("not a snapshot", !runtime_snapshot_store_save(STORE_DIR "/x.a2sm", one + 4, 64u, NULL));
+
+    expect_true("load one", runtime_snapshot_store_load(STORE_DIR "/one.a2sm", &loaded, &loaded_size));
+    expect_true("one exact", loaded_size == IMAGE_SIZE && memcmp(loaded, one, IMAGE_SIZE) == 0);
+    free(loaded);
+    expect_true("load two", runtime_snapshot_store_load(STORE_DIR "/two.a2sm", &loaded, &loaded_size));
+    expect_true("two exact", loaded_size == IMAGE_SIZE && memcmp(loaded, two, IMAGE_SIZE) == 0);
+    free(loaded);
+
+    /* A damaged object fails the digest check instead of loading. */
+    file = fopen(STORE_DIR "/objects/ad/7facb2586fc6e966c004d7d1d16b024f5805ff7cb47c7a85dabd8b48892ca7", "r+b");
+    expect_true("zero block object", file != NULL);
+    fputc(0xFF, file);
+    fclose(file);
+    expect_true("corrupt", !runtime_snapshot_store_load(STORE_DIR "/two.a2sm", &loaded, &loaded_size));
+    expect_true("missing", !runtime_snapshot_store_load(STORE_DIR "/none.a2sm", &loaded, &loaded_size));
+}
+
+/* save-state / load-state take a store reference like a file. */
+static void test_runtime_round_trip(void)
+{
+    static const uint8_t marker[4] = { 0xCA, 0xFE, 0xBA, 0xBE };
+    runtime_config config;
+    runtime *rt;
+    runtime_client *client;
+    runtime_event event;
+
+    runtime_config_init(&config);
+    config.start_running = false;
+    rt = runtime_create(&config);
+    expect_true("create", rt != NULL && runtime_start(rt));
+    client = runtime_get_client(rt);
+    expect_true("STARTED", poll_event(client, &event, RUNTIME_EVENT_STARTED, 2.0));
+
+    expect_true("mark", runtime_client_write_memory(
+        client, 0x6000u, sizeof(marker), RUNTIME_MEMORY_MODE_MAIN, marker));
+    expect_true("save", runtime_client_save_state(client, STORE_DIR "/machine.a2sm"));
+    expect_true("SAVE", poll_event(client, &event, RUNTIME_EVENT_SAVE_STATE_COMPLETE, 5.0));
+    /* The host appends no HOST trailer to a completed store path. */
+    expect_true("completed ref", runtime_snapshot_store_is_ref(event.data.state_file.path));
+    expect_true("clobber", runtime_client_write_memory(
+        client, 0x6000u, 4u, RUNTIME_MEMORY_MODE_MAIN, (const uint8_t *)"xxxx"));
+    expect_true("load", runtime_client_load_state(client, STORE_DIR "/machine.a2sm"));
+    expect_true("LOAD", poll_event(client, &event, RUNTIME_EVENT_LOAD_STATE_COMPLETE, 5.0));
+    expect_true(
+        "read", runtime_client_request_memory(client, 0x6000u, 4u, RUNTIME_MEMORY_MODE_MAIN));
+    expect_true("MEM", poll_event(client, &event, RUNTIME_EVENT_MEMORY_RESPONSE, 2.0));
+    expect_true("restored", memcmp(event.data.memory.bytes, marker, sizeof(marker)) == 0);
+
+    expect_true("quit", runtime_client_quit(client));
+    (void)poll_event(client, &event, RUNTIME_EVENT_STOPPED, 2.0);
+    runtime_destroy(rt);
+}
+
+int main(void)
+{
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+        fail("SDL_Init failed");
+    }
+    remove_tree(STORE_DIR);
+    test_store();
+    /* Fresh store: the damaged object would be shared by the machine's
+       zero pages. */
+    remove_tree(STORE_DIR);
+    test_runtime_round_trip();
+    remove_tree(STORE_DIR);
+    SDL_Quit();
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "runtime_state_writer.h"
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void fail(const char *msg)
+{
+    fprintf(stderr, "FAIL: %s\n", msg);
+    exit(1);
+}
+
+static void expect_true(const char *name, int v)
+{
+    if (!v) {
+        fprintf(stderr, "FAIL: %s: expected true\n", name);
+        exit(1);
+    }
+}
+
+static uint8_t *filled(size_t size, uint8_t value)
+{
+    uint8_t *bytes = (uint8_t *)malloc(size);
+
+    if (bytes == NULL) {
+        fail("malloc");
+    }
+    memset(bytes, value, size);
+    return bytes;
+}
+
+/* 1 when path holds exactly size copies of value. */
+static int file_is(const char *path, size_t size, uint8_t value)
+{
+    FILE *file = fopen(path, "rb");
+    size_t n = 0;
+    int c;
+
+    if (file == NULL) {
+        return 0;
+    }
+    while ((c = fgetc(file)) != EOF) {
+        if ((uint8_t)c != value) {
+            fclose(file);
+            return 0;
+        }
+        n++;
+    }
+    fclose(file);
+    return n == size;
+}
+
+static int exists(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL) {
+        return 0;
+    }
+    fclose(file);
+    return 1;
+}
+
+int main(void)
+{
+    const char *path = "test_runtime_state_writer.a2state";
+    const char *temp = "test_runtime_state_writer.a2state.tmp";
+    const char *bad = "test_runtime_state_writer_missing_dir/x.a2state";
+    runtime_state_writer *writer;
+    runtime_state_writer_result result;
+    uint8_t *bytes;
+    int i;
+
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+        fail("SDL_Init failed");
+    }
+
+    /* Synchronous write replaces an existing file and leaves no temp. */
+    bytes = filled(300u, 0x11u);
+    expect_true("write", runtime_state_writer_write_file(path, bytes, 300u));
+    free(bytes);
+    bytes = filled(100u, 0x22u);
+    expect_true("rewrite", runtime_state_writer_write_file(path, bytes, 100u));
+    free(bytes);
+    expect_true("replaced", file_is(path, 100u, 0x22u));
+    expect_true("no temp", !exists(temp));
+    expect_true("bad dir", !runtime_state_writer_write_file(bad, NULL, 0u));
+
+    writer = runtime_state_writer_create();
+    expect_true("create", writer != NULL);
+    expect_true("nothing yet", !runtime_state_writer_poll(writer, &result));
+
+    /* Results come back in submit order; the last write wins. */
+    expect_true("submit 1", runtime_state_writer_submit(writer, path, filled(64u, 1u), 64u));
+    expect_true("submit bad", runtime_state_writer_submit(writer, bad, filled(8u, 0u), 8u));
+    expect_true("submit 2", runtime_state_writer_submit(writer, path, filled(4096u, 2u), 4096u));
+    runtime_state_writer_flush(writer);
+    expect_true("poll 1", runtime_state_writer_poll(writer, &result));
+    expect_true("first ok", result.ok && strcmp(result.path, path) == 0);
+    expect_true("poll bad", runtime_state_writer_poll(writer, &result));
+    expect_true("bad fails", !result.ok && strcmp(result.path, bad) == 0);
+    expect_true("poll 2", runtime_state_writer_poll(writer, &result));
+    expect_true("second ok", result.ok);
+    expect_true("drained", !runtime_state_writer_poll(writer, &result));
+    expect_true("last wins", file_is(path, 4096u, 2u));
+    expect_true("no temp after", !exists(temp));
+
+    /* Unpolled results hold their slot: a full writer refuses and the
+       caller keeps the buffer. */
+    for (i = 0; i < RUNTIME_STATE_WRITER_QUEUE_CAPACITY; i++) {
+        expect_true("fill", runtime_state_writer_submit(writer, path, filled(16u, 3u), 16u));
+    }
+    bytes = filled(16u, 4u);
+    expect_true("full", !runtime_state_writer_submit(writer, path, bytes, 16u));
+    free(bytes);
+    runtime_state_writer_flush(writer);
+    expect_true("room again", runtime_state_writer_poll(writer, &result));
+    expect_true("accepts", runtime_state_writer_submit(writer, path, filled(16u, 5u), 16u));
+
+    /* Destroy finishes queued writes. */
+    runtime_state_writer_destroy(writer);
+    expect_true("written on destroy", file_is(path, 16u, 5u));
+
+    remove(path);
+    SDL_Quit();
+    printf("ok\n");
+    return 0;
+}
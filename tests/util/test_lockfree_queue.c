@@ -0,0 +1,216 @@
+#include "lockfree_queue.h"
+#include "thread.h"
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    PRODUCERS = 4,
+    ITEMS_PER_PRODUCER = 20000
+};
+
+typedef struct item {
+    uint32_t producer;
+    uint32_t sequence;
+} item;
+
+static void fail(const char *msg)
+{
+    fprintf(stderr, "FAIL: %s\n", msg);
+    exit(1);
+}
+
+static void test_mpsc_basics(void)
+{
+    mpsc_queue *q = mpsc_queue_create(sizeof(int), 3); /* rounds to 4 */
+    int v;
+    int out = 0;
+
+    if (q == NULL) {
+        fail("mpsc create returned NULL");
+    }
+    if (mpsc_queue_try_pop(q, &out)) {
+        fail("mpsc fresh queue not empty");
+    }
+    for (v = 0; v < 4; v++) {
+        if (!mpsc_queue_push(q, &v)) {
+            fail("mpsc push failed");
+        }
+    }
+    if (mpsc_queue_push(q, &v)) {
+        fail("mpsc full queue accepted push");
+    }
+    for (v = 0; v < 4; v++) {
+        if (!mpsc_queue_try_pop(q, &out) || out != v) {
+            fail("mpsc order");
+        }
+    }
+    if (mpsc_queue_wait_pop_timeout(q, &out, 5u)) {
+        fail("mpsc empty wait did not time out");
+    }
+    mpsc_queue_destroy(q);
+}
+
+static void test_spsc_basics(void)
+{
+    spsc_queue *q = spsc_queue_create(sizeof(int), 4);
+    wake_event *wake = wake_event_create();
+    int v;
+    int out = 0;
+
+    if (q == NULL || wake == NULL) {
+        fail("spsc create returned NULL");
+    }
+    spsc_queue_set_wake_event(q, wake);
+    for (v = 0; v < 4; v++) {
+        if (!spsc_queue_push(q, &v)) {
+            fail("spsc push failed");
+        }
+    }
+    if (spsc_queue_push(q, &v)) {
+        fail("spsc full queue accepted push");
+    }
+    if (!wake_event_wait(wake, 0u)) {
+        fail("spsc push did not signal listener");
+    }
+    for (v = 0; v < 4; v++) {
+        if (!spsc_queue_try_pop(q, &out) || out != v) {
+            fail("spsc order");
+        }
+    }
+    if (spsc_queue_wait_pop_timeout(q, &out, 5u)) {
+        fail("spsc empty wait did not time out");
+    }
+    /* Coalesced signals re-arm once the listener waited. */
+    if (wake_event_wait(wake, 0u)) {
+        fail("spsc listener still pending after wait");
+    }
+    v = 7;
+    if (!spsc_queue_push(q, &v) || !wake_event_wait(wake, 0u)) {
+        fail("spsc push after wait did not signal listener");
+    }
+    spsc_queue_destroy(q);
+    wake_event_destroy(wake);
+}
+
+typedef struct producer_arg {
+    mpsc_queue *mpsc;
+    spsc_queue *spsc;
+    uint32_t producer;
+} producer_arg;
+
+static int mpsc_producer_main(void *userdata)
+{
+    producer_arg *arg = (producer_arg *)userdata;
+    item it;
+
+    it.producer = arg->producer;
+    for (it.sequence = 0; it.sequence < ITEMS_PER_PRODUCER; it.sequence++) {
+        while (!mpsc_queue_push(arg->mpsc, &it)) {
+            SDL_Delay(0); /* full: yield to the consumer */
+        }
+    }
+    return 0;
+}
+
+static int spsc_producer_main(void *userdata)
+{
+    producer_arg *arg = (producer_arg *)userdata;
+    item it;
+
+    it.producer = 0u;
+    for (it.sequence = 0; it.sequence < ITEMS_PER_PRODUCER; it.sequence++) {
+        while (!spsc_queue_push(arg->spsc, &it)) {
+            SDL_Delay(0); /* full: yield to the consumer */
+        }
+    }
+    return 0;
+}
+
+/* Every item arrives once, in per-producer order, with the consumer
+   parking on the queue whenever it runs dry. */
+static void test_mpsc_threads(void)
+{
+    mpsc_queue *q = mpsc_queue_create(sizeof(item), 64);
+    producer_arg args[PRODUCERS];
+    thread *threads[PRODUCERS];
+    uint32_t next[PRODUCERS];
+    uint32_t received = 0u;
+    uint32_t p;
+    item it;
+
+    if (q == NULL) {
+        fail("mpsc create returned NULL");
+    }
+    memset(next, 0, sizeof(next));
+    for (p = 0; p < PRODUCERS; p++) {
+        args[p].mpsc = q;
+        args[p].spsc = NULL;
+        args[p].producer = p;
+        threads[p] = thread_create("mpsc-producer", mpsc_producer_main, &args[p]);
+        if (threads[p] == NULL) {
+            fail("thread create failed");
+        }
+    }
+    while (received < PRODUCERS * ITEMS_PER_PRODUCER) {
+        if (!mpsc_queue_wait_pop_timeout(q, &it, 1000u)) {
+            fail("mpsc consumer starved");
+        }
+        if (it.producer >= PRODUCERS || it.sequence != next[it.producer]) {
+            fail("mpsc per-producer order");
+        }
+        next[it.producer]++;
+        received++;
+    }
+    for (p = 0; p < PRODUCERS; p++) {
+        thread_join(threads[p]);
+        thread_destroy(threads[p]);
+    }
+    if (mpsc_queue_try_pop(q, &it)) {
+        fail("mpsc extra item");
+    }
+    mpsc_queue_destroy(q);
+}
+
+static void test_spsc_thread(void)
+{
+    spsc_queue *q = spsc_queue_create(sizeof(item), 16);
+    producer_arg arg;
+    thread *t;
+    uint32_t expected;
+    item it;
+
+    if (q == NULL) {
+        fail("spsc create returned NULL");
+    }
+    arg.mpsc = NULL;
+    arg.spsc = q;
+    arg.producer = 0u;
+    t = thread_create("spsc-producer", spsc_producer_main, &arg);
+    if (t == NULL) {
+        fail("thread create failed");
+    }
+    for (expected = 0; expected < ITEMS_PER_PRODUCER; expected++) {
+        if (!spsc_queue_wait_pop_timeout(q, &it, 1000u)) {
+            fail("spsc consumer starved");
+        }
+        if (it.sequence != expected) {
+            fail("spsc order");
+        }
+    }
+    thread_join(t);
+    thread_destroy(t);
+    spsc_queue_destroy(q);
+}
+
+int main(void)
+{
+    test_mpsc_basics();
+    test_spsc_basics();
+    test_mpsc_threads();
+    test_spsc_thread();
+    printf("lockfree_queue: all tests passed\n");
+    return 0;
+}
@@ -1,4 +1,6 @@
 #include "message_queue.h"
+#include "thread.h"
+#include "wake_event.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -64,10 +66,101 @@ static void test_full_rejects(void)
     message_queue_destroy(q);
 }
 
+static void test_wake_event_basics(void)
+{
+    wake_event *wake = wake_event_create();
+
+    if (wake == NULL) {
+        fail("wake create returned NULL");
+    }
+    if (wake_event_wait(wake, 0u)) {
+        fail("fresh wake event reported pending");
+    }
+    if (wake_event_wait(wake, 5u)) {
+        fail("unsignaled wait did not time out");
+    }
+
+    /* Signals coalesce: one wait consumes all of them. */
+    wake_event_signal(wake);
+    wake_event_signal(wake);
+    if (!wake_event_wait(wake, 0u)) {
+        fail("signal not observed");
+    }
+    if (wake_event_wait(wake, 0u)) {
+        fail("coalesced signals woke twice");
+    }
+
+    wake_event_destroy(wake);
+}
+
+typedef struct wake_producer {
+    message_queue *queue;
+    int value;
+} wake_producer;
+
+static int wake_producer_main(void *userdata)
+{
+    wake_producer *producer = (wake_producer *)userdata;
+    return message_queue_push(producer->queue, &producer->value) ? 0 : 1;
+}
+
+static void test_queue_signals_wake(void)
+{
+    wake_event *wake = wake_event_create();
+    message_queue *a = message_queue_create(sizeof(int), 4);
+    message_queue *b = message_queue_create(sizeof(int), 4);
+    wake_producer producer;
+    thread *t;
+    int out = 0;
+    int i;
+
+    if (wake == NULL || a == NULL || b == NULL) {
+        fail("create returned NULL");
+    }
+    message_queue_set_wake_event(a, wake);
+    message_queue_set_wake_event(b, wake);
+
+    producer.queue = b;
+    producer.value = 42;
+    t = thread_create("wake-producer", wake_producer_main, &producer);
+    if (t == NULL) {
+        fail("thread create failed");
+    }
+    /* One waiter covers both queues; the push from the thread wakes it. */
+    for (i = 0; i < 100 && !message_queue_try_pop(b, &out); i++) {
+        (void)wake_event_wait(wake, 50u);
+    }
+    thread_join(t);
+    thread_destroy(t);
+    if (out != 42) {
+        fail("woken waiter did not find the pushed item");
+    }
+    if (message_queue_try_pop(a, &out)) {
+        fail("unexpected item on the idle queue");
+    }
+
+    /* Detached queues stop signaling. */
+    (void)wake_event_wait(wake, 0u);
+    message_queue_set_wake_event(a, NULL);
+    out = 7;
+    if (!message_queue_push(a, &out)) {
+        fail("push failed");
+    }
+    if (wake_event_wait(wake, 0u)) {
+        fail("detached queue still signals");
+    }
+
+    message_queue_destroy(a);
+    message_queue_destroy(b);
+    wake_event_destroy(wake);
+}
+
 int main(void)
 {
     test_push_pop();
     test_full_rejects();
+    test_wake_event_basics();
+    test_queue_signals_wake();
     printf("message_queue: all tests passed\n");
     return 0;
 }
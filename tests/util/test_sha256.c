@@ -0,0 +1,47 @@
+#include "sha256.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void expect_hex(const char *name, const uint8_t digest[SHA256_DIGEST_SIZE], const char *want)
+{
+    char hex[SHA256_HEX_SIZE];
+
+    sha256_hex(digest, hex);
+    if (strcmp(hex, want) != 0) {
+        fprintf(stderr, "FAIL: %s: got %s want %s\n", name, hex, want);
+        exit(1);
+    }
+}
+
+int main(void)
+{
+    static const char two_block[] =
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint8_t million[1000];
+    sha256_ctx ctx;
+    size_t i;
+
+    sha256("", 0, digest);
+    expect_hex("empty", digest, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    sha256("abc", 3, digest);
+    expect_hex("abc", digest, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    sha256(two_block, strlen(two_block), digest);
+    expect_hex("two block", digest, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    /* One million 'a' in uneven pieces: exercises the partial-block path. */
+    memset(million, 'a', sizeof(million));
+    sha256_init(&ctx);
+    for (i = 0; i < 1000u; i++) {
+        size_t piece = 1u + i % 7u;
+        sha256_update(&ctx, million, piece);
+        sha256_update(&ctx, million, sizeof(million) - piece);
+    }
+    sha256_final(&ctx, digest);
+    expect_hex("million", digest, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    printf("ok\n");
+    return 0;
+}
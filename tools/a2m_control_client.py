@@ -1,5 +1,5 @@
 #!/usr/bin/env python3
-"""A2M/11 control-port client for a2m.
+"""A2M/23 control-port client for a2m.
 
 Debug/introspection helper for driving headless or windowed a2m over its
 localhost control port. Structure lifted from c64m's c64_control_client.py;
@@ -22,14 +22,26 @@ Then:
     c.mount("disks/hd.hdv", kind="smartport")      # or omit kind for .hdv
     c.unmount(kind="diskii", drive=0)
 
-GOTCHAS (Apple A2M/11):
-  * Identity: hello -> name=a2m protocol=A2M/11
+GOTCHAS (Apple A2M/23):
+  * Identity: hello -> name=a2m protocol=A2M/23
   * Unsolicited events use request id 0: `0 event state-changed …`.
     cmd()/pipeline() skip them (see drain_events / events list).
   * Assembler: assemble [address=] [run-address=] [auto-run=] [mli-launch=]
     [reset=] [auto-adjust-segments=] <path> (deferred); find-symbol <name>
   * Memory modes: map / main / aux / lc1 / lc2 / rom (not C64 ram/drive8/9)
   * Frames: ARGB 560x192, stride = width*4, format=argb8888 (not Pepto/indexed)
+  * Frame encoding=rle|delta|png (get_frame / get_frame_at decode rle/delta;
+    delta falls back to rle when the server no longer holds base=)
+  * subscribe frames|memory pushes `0 event frame|memory <bytes> sub=N …`
+    with a payload; subscribe_frames() / subscribe_memory() and pushes()
+    decode them. Pushes to a slow reader are dropped, never queued forever
+  * get-text -> `data text` (24 decoded rows); wait-text [timeout=] pattern=<re>
+    (pattern runs to end of line) -> ok row= column= length= frame=
+  * Up to 3 clients at once, each with its own session, latches and
+    subscriptions; a 4th connection gets `0 error busy clients-full`
+  * --control-shm: capabilities lists `shm`; shm() maps the region named by
+    shm-info and reads the latest frame (indexed8), RAM views and frame-ring
+    window straight from memory (same host only; read-only)
   * Softswitches: get-softswitches (Apple get-vic analogue). get-memory of $C0xx
     peeks RAM only — never the softswitch handler; do not infer video from it
   * No VIC/CIA/drive-cpu product surface
@@ -41,6 +53,8 @@ GOTCHAS (Apple A2M/11):
     prefer 6, SmartPort prefer 7). mount-disk is Disk II alias. See mount()/unmount().
   * Addresses parse base-0: prefix hex with '$' (mem() does this for you)
   * get-memory length is DECIMAL (mem() handles it)
+  * get-memory-multi / set-memory-multi take <addr>:<length>[:<mode>] spans
+    (up to 64; mem_multi() / set_mem_multi()); all spans read one state
   * quit-client closes the control socket, not the emulator process
   * Breakpoints: access exec|read|write|read-write; optional independent
     ram=map|main|aux, c100=map|rom, d000=map|lc1|lc2|rom; actions=break|none|…
@@ -56,13 +70,24 @@ Wire format:
   ok      : "<id> ok [text]\\n"
   error   : "<id> error <code> <message>\\n"
   data    : "<id> data <type> <byte_count> [metadata]\\n" + <bytes> + "\\n"
+  push    : "0 event <type> <byte_count> [metadata]\\n" + <bytes> + "\\n"
+
+Binary framing (after `hello binary=1`; see set_binary()), little-endian:
+  request : u32 id, u16 opcode, u16 flags, u32 args_size, u32 payload_size,
+            then args, then payload (no trailing newline)
+  reply   : u32 id, u8 kind, u8 flags, u16 text_size, u32 payload_size,
+            then text, then payload
 """
 from __future__ import annotations
 
 import argparse
+import mmap
+import os
+import select
 import socket
 import struct
 import sys
+import time
 import zlib
 from typing import Any, Dict, List, Optional, Sequence, Tuple
 
@@ -94,6 +119,49 @@ HST1_RECORD_KINDS = {
 # Data-write kind used when filtering "writes" in snaps / hist.
 HST1_KIND_DATA_WRITE = 1
 
+# Shared-memory region (runtime_shm.h): header, then frame / ram / ring
+# sections of u32 published + u32 reserved + two 48-byte slots.
+SHM_MAGIC = b"A2MSHM1\0"
+SHM_SECTIONS = {"frame": 0, "ram": 1, "ring": 2}
+SHM_SECTION_BASE = 40
+SHM_SECTION_SIZE = 104
+SHM_SLOT_SIZE = 48
+# RAM views in runtime_memory_mode order.
+SHM_VIEWS = {"map": 0, "main": 1, "rom": 2, "aux": 3, "lc1": 4, "lc2": 5}
+SHM_RING_FIELDS = (
+    "count", "capacity", "oldest_frame", "newest_frame",
+    "oldest_cycle", "newest_cycle", "dropped", "recording",
+)
+
+# Binary-framing opcodes: index = control_command_type (append only).
+OPCODES = {
+    name: index
+    for index, name in enumerate(
+        (
+            None, "hello", "version", "capabilities", "ping", "quit-client",
+            "reset", "run", "pause", "step-cycle", "step-instruction",
+            "step-over", "step-out", "get-state", "get-cpu", "get-softswitches",
+            "get-memory", "set-memory", "get-frame", "frame-ring-info",
+            "frame-ring-record", "frame-ring-clear", "get-frame-at",
+            "get-frame-strip", "set-reg", "set-turbo", "break-exec",
+            "break-clear", "break-clear-all", "break-enable", "break-list",
+            "break-create", "break-update", "rearm-oneshots", "wait-paused",
+            "wait-running", "wait-frame", "wait-event", "save-state",
+            "load-state", "key", "mount-disk", "mount", "unmount",
+            "select-disk", "set-disk-writable", "history-info",
+            "history-record", "history-clear", "history-find", "history-next",
+            "history-read", "history-close", "assemble", "find-symbol", "batch",
+            "get-memory-multi", "set-memory-multi", "subscribe", "unsubscribe",
+            "shm-info", "get-text", "wait-text", "rewind", "step-back",
+            "reverse-continue", "run-to-cycle",
+        )
+    )
+    if name is not None
+}
+OPCODES["get-breakpoints"] = OPCODES["break-list"]
+BINARY_FLAG_TEXT_ARGS = 1
+BINARY_REPLY_KINDS = {0: "ok", 1: "error", 2: "data", 3: "event"}
+
 
 class Ctl:
     def __init__(
@@ -106,8 +174,16 @@ class Ctl:
         self.s.settimeout(timeout)
         self.buf = b""
         self.id = 0
+        # True after set_binary(True): requests and replies use binary frames.
+        self.binary = False
         # Unsolicited `0 event …` lines collected here (newest last).
         self.events: List[str] = []
+        # Decoded subscription pushes (see pushes()), newest last.
+        self.push_queue: List[Dict[str, Any]] = []
+        # subscribe memory span lengths by subscription id.
+        self._watch_spans: Dict[int, List[int]] = {}
+        # Recent decoded frame payloads by (frame, format), for delta bases.
+        self._frame_payloads: Dict[Tuple[int, str], bytes] = {}
 
     def _readline(self) -> str:
         while b"\n" not in self.buf:
@@ -118,18 +194,86 @@ class Ctl:
         line, self.buf = self.buf.split(b"\n", 1)
         return line.decode("latin1")
 
-    def _readbytes(self, n: int) -> bytes:
-        while len(self.buf) < n + 1:  # +1 for trailing newline
+    def _fill(self, n: int) -> None:
+        while len(self.buf) < n:
             chunk = self.s.recv(65536)
             if not chunk:
                 raise EOFError("connection closed")
             self.buf += chunk
+
+    def _readbytes(self, n: int) -> bytes:
+        self._fill(n + 1)  # +1 for trailing newline
         data = self.buf[:n]
         if self.buf[n : n + 1] != b"\n":
             raise ValueError("binary response missing trailing newline")
         self.buf = self.buf[n + 1 :]
         return data
 
+    def _send(
+        self,
+        rid: int,
+        text: str,
+        payload: Optional[bytes] = None,
+        args: Optional[bytes] = None,
+    ) -> None:
+        """Send one request in the current framing.
+
+        In binary mode `args` (if given) is a fixed-layout args block sent
+        without CONTROL_BINARY_FLAG_TEXT_ARGS; otherwise the text after the
+        verb goes as text args.
+        """
+        if not self.binary:
+            msg = f"{rid} {text}\n".encode("latin1")
+            if payload is not None:
+                msg += bytes(payload) + b"\n"
+            self.s.sendall(msg)
+            return
+        verb, _, rest = text.partition(" ")
+        if verb not in OPCODES:
+            raise ValueError(f"no binary opcode for {verb!r}")
+        flags = 0
+        if args is None:
+            args = rest.encode("latin1")
+            flags = BINARY_FLAG_TEXT_ARGS
+        body = bytes(payload) if payload is not None else b""
+        self.s.sendall(
+            struct.pack("<IHHII", rid, OPCODES[verb], flags, len(args), len(body))
+            + args
+            + body
+        )
+
+    def _read_response(self) -> Tuple[int, tuple]:
+        """Next reply or event in the current framing: (id, result)."""
+        if not self.binary:
+            return self._parse_response_header(self._readline())
+        self._fill(12)
+        rid, kind, _flags, text_size, payload_size = struct.unpack_from(
+            "<IBBHI", self.buf
+        )
+        self._fill(12 + text_size + payload_size)
+        text = self.buf[12 : 12 + text_size].decode("latin1")
+        payload = self.buf[12 + text_size : 12 + text_size + payload_size]
+        self.buf = self.buf[12 + text_size + payload_size :]
+        kind_name = BINARY_REPLY_KINDS.get(kind)
+        if kind_name is None:
+            raise ValueError(f"unknown binary reply kind {kind}")
+        if kind_name == "data":
+            # "<type> [metadata]": drop the type, like the text header.
+            return rid, ("data", text.partition(" ")[2], payload)
+        if kind_name == "event" and payload_size > 0:
+            return rid, ("event", text, payload)
+        return rid, (kind_name, text)
+
+    def set_binary(self, enabled: bool = True) -> str:
+        """Switch this connection's framing with `hello binary=0|1`.
+
+        The reply arrives in the old framing; later traffic uses the new one.
+        Refused while other requests are in flight.
+        """
+        text = self.ok(f"hello binary={1 if enabled else 0}")
+        self.binary = enabled
+        return text
+
     def _parse_response_header(
         self, line: str, expect_id: Optional[int] = None
     ) -> Tuple[int, tuple]:
@@ -137,7 +281,11 @@ class Ctl:
         rid = int(parts[0])
         kind = parts[1]
         if kind == "event":
-            # Unsolicited / out-of-band (normally id 0).
+            # Unsolicited / out-of-band (normally id 0). A subscription push
+            # carries a byte count and payload like data.
+            if len(parts) > 3 and parts[3].isdigit():
+                payload = self._readbytes(int(parts[3]))
+                return rid, ("event", " ".join(parts[2:3] + parts[4:]), payload)
             return rid, ("event", " ".join(parts[2:]))
         if expect_id is not None:
             assert rid == expect_id, f"id mismatch: {line!r}"
@@ -153,29 +301,62 @@ class Ctl:
             return rid, ("data", meta, payload)
         raise ValueError(f"unknown response: {line!r}")
 
-    def _note_event(self, text: str) -> None:
-        self.events.append(text)
+    def _note_event(self, result: tuple) -> None:
+        if len(result) > 2:
+            self.push_queue.append(self._decode_push(result[1], result[2]))
+            return
+        self.events.append(result[1])
+
+    def _decode_push(self, text: str, payload: bytes) -> Dict[str, Any]:
+        kind, _, rest = text.partition(" ")
+        meta = self._metadata(rest)
+        sub = int(meta.get("sub", "0"), 0)
+        if kind == "frame":
+            out = self._frame_from_data(rest, payload)
+        elif kind == "memory":
+            mask = int(meta.get("mask", "0"), 16)
+            ranges: Dict[int, bytes] = {}
+            pos = 0
+            for index, length in enumerate(self._watch_spans.get(sub, [])):
+                if mask & (1 << index):
+                    ranges[index] = payload[pos : pos + length]
+                    pos += length
+            out = {
+                "frame": int(meta.get("frame", "0"), 0),
+                "cycle": int(meta.get("cycle", "0"), 0),
+                "ranges": ranges,
+                "meta": meta,
+            }
+        else:
+            out = {"payload": payload, "meta": meta}
+        out["kind"] = kind
+        out["sub"] = sub
+        return out
+
+    def _read_events(self, wait: float) -> None:
+        """Collect events and pushes for `wait` seconds.
+
+        Only the start of a message is waited for with the deadline; one that
+        has begun is read in full, so framing survives a steady push stream.
+        """
+        deadline = time.monotonic() + wait
+        while True:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                break
+            if not self.buf:
+                ready, _, _ = select.select([self.s], [], [], remaining)
+                if not ready:
+                    break
+            rid, result = self._read_response()
+            if result[0] != "event":
+                raise RuntimeError(f"unexpected non-event while draining: id={rid} {result!r}")
+            self._note_event(result)
 
     def drain_events(self, wait: float = 0.0) -> List[str]:
         """Return and clear queued events; optionally wait briefly for more."""
         if wait > 0:
-            old = self.s.gettimeout()
-            try:
-                self.s.settimeout(wait)
-                while True:
-                    try:
-                        line = self._readline()
-                    except (socket.timeout, TimeoutError):
-                        break
-                    rid, result = self._parse_response_header(line)
-                    if result[0] == "event":
-                        self._note_event(result[1])
-                        continue
-                    raise RuntimeError(
-                        f"unexpected non-event while draining: id={rid} {result!r}"
-                    )
-            finally:
-                self.s.settimeout(old)
+            self._read_events(wait)
         out = list(self.events)
         self.events.clear()
         return out
@@ -185,19 +366,23 @@ class Ctl:
 
         Skips intervening `event` lines (stores them on self.events).
         """
+        return self._call(text, payload)
+
+    def _call(
+        self,
+        text: str,
+        payload: Optional[bytes] = None,
+        args: Optional[bytes] = None,
+    ) -> tuple:
         self.id += 1
         rid = self.id
-        self.s.sendall(f"{rid} {text}\n".encode("latin1"))
-        if payload is not None:
-            self.s.sendall(payload)
-            self.s.sendall(b"\n")
+        self._send(rid, text, payload, args)
         while True:
-            line = self._readline()
-            got_id, result = self._parse_response_header(line)
+            got_id, result = self._read_response()
             if result[0] == "event":
-                self._note_event(result[1])
+                self._note_event(result)
                 continue
-            assert got_id == rid, f"id mismatch: {line!r}"
+            assert got_id == rid, f"id mismatch: {got_id} {result!r}"
             return result
 
     def pipeline(self, commands: Sequence[str]) -> List[tuple]:
@@ -211,21 +396,51 @@ class Ctl:
             self.id += 1
             rid = self.id
             ids.append(rid)
-            self.s.sendall(f"{rid} {text}\n".encode("latin1"))
+            self._send(rid, text)
         by_id: Dict[int, tuple] = {}
         pending = set(ids)
         while pending:
-            line = self._readline()
-            rid, result = self._parse_response_header(line)
+            rid, result = self._read_response()
             if result[0] == "event":
-                self._note_event(result[1])
+                self._note_event(result)
                 continue
             if rid not in pending:
-                raise RuntimeError(f"unexpected response id {rid}: {line!r}")
+                raise RuntimeError(f"unexpected response id {rid}: {result!r}")
             by_id[rid] = result
             pending.remove(rid)
         return [by_id[i] for i in ids]
 
+    def batch(self, commands: Sequence[Any]) -> List[tuple]:
+        """Run commands back-to-back with no free-run between them.
+
+        Each item is a command string or (command, payload) for set-memory.
+        Sends one `batch` request and returns one result per command, in order,
+        shaped like cmd(). Raises if the batch itself is rejected.
+        """
+        body = bytearray()
+        for i, item in enumerate(commands, start=1):
+            text, payload = (item, None) if isinstance(item, str) else item
+            body += f"{i} {text}\n".encode("latin1")
+            if payload is not None:
+                body += bytes(payload) + b"\n"
+        r = self.cmd(f"batch {len(commands)} {len(body)}", payload=bytes(body))
+        if r[0] != "data":
+            raise RuntimeError(f"batch -> {r}")
+        out: List[tuple] = []
+        data = r[2]
+        pos = 0
+        while pos < len(data):
+            end = data.index(b"\n", pos)
+            parts = data[pos:end].decode("latin1").split(" ")
+            pos = end + 1
+            if parts[1] == "data":
+                n = int(parts[3])
+                out.append(("data", " ".join(parts[4:]), data[pos : pos + n]))
+                pos += n + 1
+            else:
+                out.append((parts[1], " ".join(parts[2:])))
+        return out
+
     def ok(self, text: str, payload: Optional[bytes] = None) -> str:
         """Require an `ok` response; raise on error or unexpected data."""
         r = self.cmd(text, payload=payload)
@@ -247,7 +462,10 @@ class Ctl:
         if mode not in MEMORY_MODES:
             raise ValueError(f"memory mode must be one of {MEMORY_MODES}, got {mode!r}")
         # address: parse_u16 base-0, '$' forces hex. length: decimal.
-        r = self.cmd(f"get-memory ${addr:04X} {length:d} {mode}")
+        r = self._call(
+            f"get-memory ${addr:04X} {length:d} {mode}",
+            args=self._memory_args(addr, length, mode),
+        )
         if r[0] != "data":
             raise RuntimeError(f"get-memory -> {r}")
         return r[2]
@@ -298,10 +516,66 @@ class Ctl:
     def set_mem(self, addr: int, data: bytes, mode: str = "map") -> str:
         if mode not in MEMORY_MODES:
             raise ValueError(f"memory mode must be one of {MEMORY_MODES}, got {mode!r}")
-        return self.ok(
+        r = self._call(
             f"set-memory ${addr:04X} {len(data):d} {mode}",
             payload=data,
+            args=self._memory_args(addr, len(data), mode),
+        )
+        if r[0] != "ok":
+            raise RuntimeError(f"set-memory -> {r}")
+        return r[1]
+
+    def mem_multi(self, spans: Sequence[Tuple[Any, ...]]) -> List[bytes]:
+        """Read several (addr, length[, mode]) spans in one request.
+
+        Every span comes from the same machine state; returns one bytes
+        object per span.
+        """
+        spans = [(s[0], s[1], s[2] if len(s) > 2 else "map") for s in spans]
+        for _, _, mode in spans:
+            if mode not in MEMORY_MODES:
+                raise ValueError(f"memory mode must be one of {MEMORY_MODES}, got {mode!r}")
+        r = self._call(
+            "get-memory-multi "
+            + " ".join(f"${a:04X}:{n:d}:{m}" for a, n, m in spans),
+            args=self._span_args(spans),
         )
+        if r[0] != "data":
+            raise RuntimeError(f"get-memory-multi -> {r}")
+        out: List[bytes] = []
+        pos = 0
+        for _, n, _ in spans:
+            out.append(r[2][pos : pos + n])
+            pos += n
+        return out
+
+    def set_mem_multi(self, spans: Sequence[Tuple[Any, ...]]) -> str:
+        """Write several (addr, data[, mode]) spans in one request."""
+        spans = [(s[0], bytes(s[1]), s[2] if len(s) > 2 else "map") for s in spans]
+        for _, _, mode in spans:
+            if mode not in MEMORY_MODES:
+                raise ValueError(f"memory mode must be one of {MEMORY_MODES}, got {mode!r}")
+        r = self._call(
+            "set-memory-multi "
+            + " ".join(f"${a:04X}:{len(d):d}:{m}" for a, d, m in spans),
+            payload=b"".join(d for _, d, _ in spans),
+            args=self._span_args([(a, len(d), m) for a, d, m in spans]),
+        )
+        if r[0] != "ok":
+            raise RuntimeError(f"set-memory-multi -> {r}")
+        return r[1]
+
+    def _span_args(self, spans: Sequence[Tuple[int, int, str]]) -> Optional[bytes]:
+        """Fixed binary span records, or None on the text wire."""
+        if not self.binary:
+            return None
+        return b"".join(self._memory_args(a, n, m) or b"" for a, n, m in spans)
+
+    def _memory_args(self, addr: int, length: int, mode: str) -> Optional[bytes]:
+        """Fixed binary get/set-memory args, or None on the text wire."""
+        if not self.binary:
+            return None
+        return struct.pack("<HBBI", addr & 0xFFFF, MEMORY_MODES.index(mode), 0, length)
 
     # --------------------------------------------------------------- media
     def mount(
@@ -522,23 +796,137 @@ class Ctl:
         return r[1], r[2]
 
     # --------------------------------------------------------------- frames
-    def get_frame(self) -> Dict[str, Any]:
-        """Live ARGB frame: {width, height, stride, format, frame, pixels}."""
-        r = self.cmd("get-frame")
+    def get_frame(
+        self,
+        format: str = "argb8888",
+        encoding: str = "raw",
+        base: Optional[int] = None,
+    ) -> Dict[str, Any]:
+        """Live frame: {width, height, stride, format, frame, pixels}.
+
+        format="indexed8" returns the raw wire payload in ``pixels`` plus
+        ``palette`` (16 ARGB ints) and ``indices``; use expand_indexed8 for ARGB.
+        encoding="rle"/"delta" are decoded here (delta defaults base to the
+        newest frame this client fetched in that format); encoding="png"
+        returns the PNG file bytes in ``pixels`` with format "png".
+        """
+        cmd = "get-frame" + self._frame_options(format, encoding, base)
+        r = self.cmd(cmd)
         if r[0] != "data":
             raise RuntimeError(f"get-frame -> {r}")
-        meta = self._metadata(r[1])
+        return self._frame_from_data(r[1], r[2])
+
+    def _frame_options(self, format: str, encoding: str, base: Optional[int]) -> str:
+        opts = ""
+        if format != "argb8888":
+            opts += f" format={format}"
+        if encoding == "delta" and base is None:
+            known = [n for (n, f) in self._frame_payloads if f == format]
+            if not known:
+                encoding = "rle"
+            else:
+                base = max(known)
+        if encoding != "raw":
+            opts += f" encoding={encoding}"
+        if encoding == "delta":
+            opts += f" base={int(base)}"
+        return opts
+
+    def _decode_frame_payload(self, meta: Dict[str, str], payload: bytes) -> bytes:
+        encoding = meta.get("encoding", "raw")
+        fmt = meta.get("format", "argb8888")
+        if encoding in ("rle", "delta"):
+            unit = 1 if fmt == "indexed8" else 4
+            base = None
+            if encoding == "delta":
+                key = (int(meta["base"], 0), fmt)
+                if key not in self._frame_payloads:
+                    raise RuntimeError(f"delta base frame {key[0]} not held by client")
+                base = self._frame_payloads[key]
+            payload = decode_frame_rle(payload, unit, int(meta["raw_size"], 0), base)
+        if encoding != "png" and "frame" in meta:
+            self._frame_payloads[(int(meta["frame"], 0), fmt)] = payload
+            while len(self._frame_payloads) > 8:
+                del self._frame_payloads[min(self._frame_payloads)]
+        return payload
+
+    def _frame_from_data(self, text: str, payload: bytes) -> Dict[str, Any]:
+        meta = self._metadata(text)
+        if meta.get("encoding") == "png":
+            meta.setdefault("format", "png")
+        payload = self._decode_frame_payload(meta, payload)
         out = {
             "width": int(meta.get("width", "0"), 0),
             "height": int(meta.get("height", "0"), 0),
             "stride": int(meta.get("stride", "0"), 0),
             "format": meta.get("format", "argb8888"),
             "frame": int(meta.get("frame", "0"), 0),
-            "pixels": r[2],
+            "pixels": payload,
             "meta": meta,
         }
+        if out["format"] == "indexed8":
+            entries = int(meta.get("palette", "16"), 0)
+            out["palette"] = list(struct.unpack_from(f"<{entries}I", payload, 0))
+            out["indices"] = payload[entries * 4 :]
+        return out
+
+    # -------------------------------------------------------- subscriptions
+    def subscribe_frames(
+        self, every: int = 1, format: str = "argb8888", encoding: str = "raw"
+    ) -> int:
+        """Push every Nth frame; returns the subscription id.
+
+        Pushes arrive as pushes() entries shaped like get_frame() results
+        (plus kind/sub). encoding="delta" is against the previous push.
+        """
+        opts = f" every={int(every)}"
+        if format != "argb8888":
+            opts += f" format={format}"
+        if encoding != "raw":
+            opts += f" encoding={encoding}"
+        meta = self._metadata(self.ok("subscribe frames" + opts))
+        return int(meta["sub"], 0)
+
+    def subscribe_memory(self, spans: Sequence[Tuple[Any, ...]], on: str = "change") -> int:
+        """Watch (addr, length[, mode]) spans; returns the subscription id.
+
+        Each push has ``ranges``: {span index: bytes} for the spans that
+        changed since the previous push (all of them on the first).
+        """
+        spans = [(s[0], s[1], s[2] if len(s) > 2 else "map") for s in spans]
+        for _, _, mode in spans:
+            if mode not in MEMORY_MODES:
+                raise ValueError(f"memory mode must be one of {MEMORY_MODES}, got {mode!r}")
+        ranges = ",".join(f"${a:04X}:{n:d}:{m}" for a, n, m in spans)
+        meta = self._metadata(self.ok(f"subscribe memory ranges={ranges} on={on}"))
+        sub = int(meta["sub"], 0)
+        self._watch_spans[sub] = [n for _, n, _ in spans]
+        return sub
+
+    def unsubscribe(self, sub: Optional[int] = None) -> str:
+        """Stop one subscription, or all of them when sub is None."""
+        if sub is None:
+            self._watch_spans.clear()
+        else:
+            self._watch_spans.pop(sub, None)
+        return self.ok("unsubscribe " + ("all" if sub is None else str(int(sub))))
+
+    def pushes(self, wait: float = 0.0) -> List[Dict[str, Any]]:
+        """Return and clear decoded subscription pushes; optionally wait for more."""
+        if wait > 0:
+            self._read_events(wait)
+        out = list(self.push_queue)
+        self.push_queue.clear()
         return out
 
+    def shm(self) -> "ShmView":
+        """Map the --control-shm region (same host only)."""
+        r = self.cmd("shm-info")
+        if r[0] != "ok":
+            raise RuntimeError(f"shm-info -> {r}")
+        meta = self._metadata(r[1])
+        return ShmView(meta["name"], int(meta["size"], 0))
+
     def frame_ring_info(self) -> Dict[str, Any]:
         text = self.ok("frame-ring-info")
         meta = self._metadata(text)
@@ -560,6 +948,9 @@ class Ctl:
         *,
         frame: Optional[int] = None,
         cycle: Optional[int] = None,
+        format: str = "argb8888",
+        encoding: str = "raw",
+        base: Optional[int] = None,
     ) -> Dict[str, Any]:
         if (frame is None) == (cycle is None):
             raise ValueError("pass exactly one of frame= or cycle=")
@@ -567,20 +958,51 @@ class Ctl:
             cmd = f"get-frame-at frame={int(frame)}"
         else:
             cmd = f"get-frame-at cycle={int(cycle)}"
+        cmd += self._frame_options(format, encoding, base)
+        r = self.cmd(cmd)
+        if r[0] != "data":
+            raise RuntimeError(f"{cmd!r} -> {r}")
+        out = self._frame_from_data(r[1], r[2])
+        meta = out["meta"]
+        out["cycle"] = int(meta.get("cycle", "0"), 0) if "cycle" in meta else None
+        return out
+
+    def get_frame_strip(
+        self,
+        first: int,
+        last: int,
+        count: int,
+        *,
+        by_cycle: bool = False,
+        scale: int = 4,
+        format: str = "argb8888",
+    ) -> List[Dict[str, Any]]:
+        """Thumbnails sampled evenly over [first, last] (frames or cycles).
+
+        Each item: {width, height, format, frame, cycle, pixels} (+ palette /
+        indices for indexed8), like get_frame_at at 1/scale size.
+        """
+        kind = "cycle" if by_cycle else "frame"
+        cmd = (
+            f"get-frame-strip {kind}={int(first)} to={int(last)} "
+            f"count={int(count)} scale={int(scale)}"
+        )
+        if format != "argb8888":
+            cmd += f" format={format}"
         r = self.cmd(cmd)
         if r[0] != "data":
             raise RuntimeError(f"{cmd!r} -> {r}")
         meta = self._metadata(r[1])
-        return {
-            "width": int(meta.get("width", "0"), 0),
-            "height": int(meta.get("height", "0"), 0),
-            "stride": int(meta.get("stride", "0"), 0),
-            "format": meta.get("format", "argb8888"),
-            "frame": int(meta.get("frame", "0"), 0),
-            "cycle": int(meta.get("cycle", "0"), 0) if "cycle" in meta else None,
-            "pixels": r[2],
-            "meta": meta,
-        }
+        record = int(meta.get("record", "0"), 0)
+        out: List[Dict[str, Any]] = []
+        for i in range(int(meta.get("count", "0"), 0)):
+            chunk = r[2][i * record : (i + 1) * record]
+            frame, cycle = struct.unpack_from("<QQ", chunk, 0)
+            item = self._frame_from_data(r[1], chunk[16:])
+            item["frame"] = frame
+            item["cycle"] = cycle
+            out.append(item)
+        return out
 
     # ---------------------------------------------------------------- waits
     def wait_paused(self, timeout_ms: int = 60000) -> Dict[str, Any]:
@@ -610,6 +1032,60 @@ class Ctl:
         text = self.ok(f"wait-event {name} {int(timeout_ms)}")
         return self._metadata(text)
 
+    def wait_text(self, pattern: str, timeout_ms: int = 60000) -> Dict[str, Any]:
+        """Block until a text row matches pattern (tiny-regex: . ^ $ * + ?
+        [..] \\d \\w \\s). Returns row / column / length / frame of the match.
+        """
+        text = self.ok(f"wait-text timeout={int(timeout_ms)} pattern={pattern}")
+        return {key: int(value, 0) for key, value in self._metadata(text).items()}
+
+    def rewind(self, frames: int = 60) -> Dict[str, int]:
+        """Step back frames frames through the rewind buffer
+        ([debug] rewind_memory_mb). Returns frame / cycles / frames (actually
+        stepped back) / checkpoints.
+        """
+        text = self.ok(f"rewind frames={int(frames)}")
+        return {key: int(value, 0) for key, value in self._metadata(text).items()}
+
+    def _seek(self, line: str) -> Dict[str, Any]:
+        meta = self._metadata(self.ok(line))
+        return {
+            "pc": int(meta["pc"], 16),
+            "cycles": int(meta["cycles"]),
+            "frame": int(meta["frame"]),
+            "stop": meta["stop"],
+        }
+
+    def step_back(self) -> Dict[str, Any]:
+        """Back one instruction through the rewind buffer (pauses).
+        Returns pc / cycles / frame / stop.
+        """
+        return self._seek("step-back")
+
+    def reverse_continue(self) -> Dict[str, Any]:
+        """Back to the previous breakpoint stop (stop="breakpoint"); raises
+        on not-found with the machine left where it was.
+        """
+        return self._seek("reverse-continue")
+
+    def run_to_cycle(self, cycle: int) -> Dict[str, Any]:
+        """Pause on the first instruction boundary at or after cycle, going
+        back through the rewind buffer or forward (stopping at breakpoints).
+        """
+        return self._seek(f"run-to-cycle cycle={int(cycle)}")
+
+    def get_text(self) -> Dict[str, Any]:
+        """Decoded text screen: 24 rows (graphics rows empty), trailing blanks
+        dropped, inverse / flashing characters in their normal form.
+        """
+        r = self.cmd("get-text")
+        if r[0] != "data":
+            raise RuntimeError(f"get-text -> {r}")
+        meta = self._metadata(r[1])
+        out: Dict[str, Any] = {key: int(value, 0) for key, value in meta.items()}
+        out["rows"] = r[2].decode("ascii", "replace").split("\n")[:24]
+        return out
+
     # -------------------------------------------------------------- history
     @staticmethod
     def _metadata(text: str) -> Dict[str, str]:
@@ -857,6 +1333,139 @@ class Ctl:
             pass
 
 
+class ShmView:
+    """Read-only view of the region the worker publishes into.
+
+    Each section is a seqlock over two slots: copy under an even seq and
+    retry when it moved. frame() / mem() / ring() return the newest publish.
+    """
+
+    def __init__(self, name: str, size: int) -> None:
+        self.name = name
+        self._shm = None
+        if sys.platform == "win32":
+            self.m = mmap.mmap(-1, size, tagname=name, access=mmap.ACCESS_READ)
+        elif os.path.exists("/dev/shm/" + name.lstrip("/")):
+            with open("/dev/shm/" + name.lstrip("/"), "rb") as f:
+                self.m = mmap.mmap(f.fileno(), size, access=mmap.ACCESS_READ)
+        else:
+            from multiprocessing import resource_tracker, shared_memory
+
+            self._shm = shared_memory.SharedMemory(name=name.lstrip("/"))
+            # The emulator owns the name; do not unlink it when we exit.
+            resource_tracker.unregister(self._shm._name, "shared_memory")
+            self.m = self._shm.buf
+        if bytes(self.m[0:8]) != SHM_MAGIC:
+            raise RuntimeError(f"{name}: not an a2m shared-memory region")
+        self.frame_width, self.frame_height = struct.unpack_from("<II", self.m, 24)
+
+    def _read(
+        self, section: str, start: int = 0, length: Optional[int] = None
+    ) -> Tuple[Dict[str, int], bytes]:
+        base = SHM_SECTION_BASE + SHM_SECTION_SIZE * SHM_SECTIONS[section]
+        for _ in range(64):
+            (published,) = struct.unpack_from("<I", self.m, base)
+            if published == 0xFFFFFFFF:
+                raise RuntimeError(f"shm {section}: nothing published yet")
+            slot = base + 8 + SHM_SLOT_SIZE * (published & 1)
+            seq, gen, frame, cycle, offset, size = struct.unpack_from("<6Q", self.m, slot)
+            if seq & 1:
+                continue
+            n = size - start if length is None else length
+            data = bytes(self.m[offset + start : offset + start + n])
+            if struct.unpack_from("<Q", self.m, slot)[0] == seq:
+                return {"generation": gen, "frame": frame, "cycle": cycle}, data
+        raise RuntimeError(f"shm {section}: slot kept changing")
+
+    def generation(self, section: str = "frame") -> int:
+        """Publish count of a section, to poll for something new cheaply."""
+        return self._read(section, 0, 0)[0]["generation"]
+
+    def frame(self) -> Dict[str, Any]:
+        """Newest frame in get_frame(format="indexed8") shape plus cycle."""
+        info, data = self._read("frame")
+        out: Dict[str, Any] = {
+            "width": self.frame_width,
+            "height": self.frame_height,
+            "stride": self.frame_width,
+            "format": "indexed8",
+            "pixels": data,
+            "palette": list(struct.unpack_from("<16I", data, 0)),
+            "indices": data[64:],
+        }
+        out.update(info)
+        return out
+
+    def mem(self, addr: int, length: int, mode: str = "map") -> bytes:
+        """length bytes of one view from the newest RAM publish ($FFFF wraps)."""
+        if mode not in SHM_VIEWS:
+            raise ValueError(f"memory mode must be one of {tuple(SHM_VIEWS)}, got {mode!r}")
+        view = SHM_VIEWS[mode] * 0x10000
+        addr &= 0xFFFF
+        if addr + length <= 0x10000:
+            return self._read("ram", view + addr, length)[1]
+        data = self._read("ram", view, 0x10000)[1]
+        return (data[addr:] + data)[:length]
+
+    def ring(self) -> Dict[str, int]:
+        info, data = self._read("ring")
+        out = dict(zip(SHM_RING_FIELDS, struct.unpack_from("<8Q", data, 0)))
+        out["generation"] = info["generation"]
+        return out
+
+    def close(self) -> None:
+        if self._shm is not None:
+            self.m = None
+            self._shm.close()
+        else:
+            self.m.close()
+
+
+def decode_frame_rle(
+    data: bytes, unit: int, size: int, base: Optional[bytes] = None
+) -> bytes:
+    """Decode an encoding=rle payload (or delta, given the base payload).
+
+    Tokens: LEB128 header h, count = (h >> 1) + 1 units (pixels); odd h
+    repeats the next unit, even h copies count literal units.
+    """
+    out = bytearray()
+    pos = 0
+    n = len(data)
+    while pos < n:
+        h = 0
+        shift = 0
+        while True:
+            b = data[pos]
+            pos += 1
+            h |= (b & 0x7F) << shift
+            if not b & 0x80:
+                break
+            shift += 7
+        count = (h >> 1) + 1
+        if h & 1:
+            out += data[pos : pos + unit] * count
+            pos += unit
+        else:
+            out += data[pos : pos + count * unit]
+            pos += count * unit
+    if len(out) != size:
+        raise ValueError(f"rle payload decodes to {len(out)} bytes, expected {size}")
+    if base is not None:
+        if len(base) != size:
+            raise ValueError("delta base size mismatch")
+        xored = int.from_bytes(out, "little") ^ int.from_bytes(base, "little")
+        return xored.to_bytes(size, "little")
+    return bytes(out)
+
+
+def expand_indexed8(palette: List[int], indices: bytes) -> bytes:
+    """Expand an indexed8 frame to packed little-endian ARGB8888 (PNG-ready)."""
+    lut = [struct.pack("<I", entry & 0xFFFFFFFF) for entry in palette]
+    mask = len(lut) - 1
+    return b"".join(lut[i & mask] for i in indices)
+
+
 def write_argb_png(
     path: str,
     width: int,
@@ -915,7 +1524,7 @@ def write_argb_png(
 
 
 def main(argv: Optional[Sequence[str]] = None) -> int:
-    ap = argparse.ArgumentParser(description="a2m control client (A2M/11)")
+    ap = argparse.ArgumentParser(description="a2m control client (A2M/23)")
     ap.add_argument("--host", default="127.0.0.1")
     ap.add_argument("--port", type=int, default=6510)
     ap.add_argument("--timeout", type=float, default=30.0)
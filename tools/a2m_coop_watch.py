@@ -41,6 +41,7 @@ INBOX PROTOCOL (append one command per line to build/debug/coop_inbox)
     dump <addr> <len> [mode]       get-memory (mode: map|main|aux|lc1|lc2|rom)
     hist <addr> [access] [limit]   history-find -> text into snap
     scrub [count]                  last N ring frames as ARGB PNGs
+    strip [count]                  N 1/4-scale thumbnails across the whole ring
     frame <n>                      one ring frame + cycle metadata
     note <text...>                 append a line into the snap file
     ss / softswitches / vic        get-softswitches (latched flags; not $C0xx mem)
@@ -86,6 +87,8 @@ CONFIG = {
         # ("score", 0x0300),
     ],
     "trace_limit": 48,
+    # Binary framing (hello binary=1): cheaper region dumps on every freeze.
+    "binary": False,
 }
 
 
@@ -108,6 +111,8 @@ class CoopWatch:
         # Socket must outlast a full server-side wait, plus margin.
         sock_timeout = cfg["wait_ms"] / 1000.0 + 30.0
         self.c = Ctl(port=cfg["port"], timeout=sock_timeout)
+        if cfg["binary"]:
+            self.c.set_binary(True)
         self.snap_no = self._next_snap_no()
         self.cur_snap = None  # path of the snap file for the current freeze
 
@@ -300,7 +305,7 @@ class CoopWatch:
     def paused_command_loop(self):
         self._log(
             f"paused -- append commands to {self.inbox} "
-            f"(arm/count/clear/dump/hist/scrub/frame/note/resume/quit)"
+            f"(arm/count/clear/dump/hist/scrub/strip/frame/note/resume/quit)"
         )
         while True:
             for cmd in self._drain_inbox():
@@ -389,6 +394,9 @@ class CoopWatch:
             elif cmd == "scrub":
                 count = int(parts[1]) if len(parts) > 1 else 50
                 self._scrub_frames(count)
+            elif cmd == "strip":
+                count = int(parts[1]) if len(parts) > 1 else 32
+                self._strip_frames(count)
             elif cmd == "frame":
                 self._pull_frame(int(parts[1]))
             elif cmd in ("vic", "ss", "softswitches"):
@@ -448,6 +456,39 @@ class CoopWatch:
         )
         self._log(f"scrub: wrote {written} frames to {out_dir}")
 
+    def _strip_frames(self, count):
+        """Thumbnails across the retained window in one request; pick a frame
+        number from the file names, then `frame N` for the full picture."""
+        info = self._ring_info()
+        if not info or int(info.get("count", 0)) == 0:
+            self._log("strip: frame ring is empty")
+            return
+        newest = int(info["newest_frame"])
+        oldest = int(info["oldest_frame"])
+        count = max(1, min(64, count))
+        try:
+            thumbs = self.c.get_frame_strip(oldest, newest, count)
+        except Exception as exc:
+            self._log(f"strip failed: {exc}")
+            return
+        out_dir = os.path.splitext(self.cur_snap or "frames")[0] + "-strip"
+        os.makedirs(out_dir, exist_ok=True)
+        written = 0
+        for th in thumbs:
+            path = os.path.join(out_dir, f"thumb-{int(th['frame']):06d}.png")
+            if write_argb_png(
+                path,
+                int(th["width"]),
+                int(th["height"]),
+                th["pixels"],
+                stride=th.get("stride") or None,
+            ):
+                written += 1
+        self._append_snap(
+            f"--- strip frames {oldest}..{newest} -> {out_dir} ({written} thumbnails)"
+        )
+        self._log(f"strip: wrote {written} thumbnails to {out_dir}")
+
     def _pull_frame(self, number):
         fr, pixels = self._frame_at(number)
         if fr is None:
@@ -483,13 +524,25 @@ class CoopWatch:
 
 def main(argv=None):
     ap = argparse.ArgumentParser(
-        description="a2m cooperative live-debug watcher (A2M/11)"
+        description="a2m cooperative live-debug watcher (A2M/23)"
     )
     ap.add_argument("--port", type=int, default=CONFIG["port"])
     ap.add_argument("--out-dir", default=CONFIG["out_dir"])
     ap.add_argument("--wait-ms", type=int, default=CONFIG["wait_ms"])
+    ap.add_argument(
+        "--binary",
+        action="store_true",
+        default=CONFIG["binary"],
+        help="use binary framing on the control socket",
+    )
     args = ap.parse_args(argv)
-    cfg = dict(CONFIG, port=args.port, out_dir=args.out_dir, wait_ms=args.wait_ms)
+    cfg = dict(
+        CONFIG,
+        port=args.port,
+        out_dir=args.out_dir,
+        wait_ms=args.wait_ms,
+        binary=args.binary,
+    )
 
     watcher = CoopWatch(cfg)
     watcher.setup()